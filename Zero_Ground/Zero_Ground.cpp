@@ -2,6 +2,7 @@
 #include <SFML/Graphics.hpp>
 #include <iostream>
 #include <sstream>
+#include <fstream>
 #include <iomanip>
 #include <thread>
 #include <mutex>
@@ -15,13 +16,42 @@
 #include <queue>
 #include <cmath>
 #include <ctime>
+#include <cstdlib>
+#include <limits>
 #include <atomic>
+#include <functional>
+
+// SIMD kernels for the bullet pool: AVX when the compiler targets it (/arch:AVX),
+// otherwise SSE2 (always available on x64), otherwise plain scalar code
+#if defined(__AVX__)
+#include <immintrin.h>
+#define ZG_BULLETS_AVX 1
+#define ZG_BULLETS_SSE 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ZG_BULLETS_SSE 1
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>  // _BitScanForward64, __popcnt64
+#endif
 
 enum class ServerState { MenuScreen, StartScreen, MainScreen };
 
 // Global server state (atomic for thread safety)
 std::atomic<ServerState> serverState(ServerState::MenuScreen);
 
+// Dedicated server mode (--headless): no window, no host player
+bool headlessMode = false;
+
+// Authoritative simulation tick rate in Hz (--tick-rate=N, 10..240)
+// Snapshots are sent at serverSnapshotRate regardless of the tick rate
+int serverTickRate = 60;
+
+// Snapshot send rate in Hz (--snapshot-rate=N, 5..60); clients interpolate
+// with a delay adapted to it, so lower rates trade latency for bandwidth
+int serverSnapshotRate = 20;
+
 // Global icon image (needs to persist for window lifetime)
 sf::Image g_serverWindowIcon;
 
@@ -58,6 +88,10 @@ struct Player {
     bool isReady = false;
     sf::Color color = sf::Color::Blue;
     
+    // Authoritative simulation state (server player table)
+    bool waitingRespawn = false;   // Dead and waiting for respawnCountdown to expire
+    float respawnCountdown = 0.0f; // Seconds of simulation time until respawn
+    
     // Weapon system fields
     std::array<Weapon*, 4> inventory = {nullptr, nullptr, nullptr, nullptr};
     int activeSlot = -1;  // -1 means no weapon active
@@ -428,14 +462,129 @@ enum class WallType : uint8_t {
     Wood = 2       // Wooden wall (brown)
 };
 
-// Cell structure for grid-based map
-// Each cell can have walls on its four sides
-// Walls are centered on cell boundaries (WALL_WIDTH/2 on each side)
-struct Cell {
-    WallType topWall = WallType::None;
-    WallType rightWall = WallType::None;
-    WallType bottomWall = WallType::None;
-    WallType leftWall = WallType::None;
+// Number of set bits
+inline int popCount(uint64_t mask) {
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(mask));
+#else
+    return __builtin_popcountll(mask);
+#endif
+}
+
+// Map walls stored on the cell edges they occupy
+//
+// A wall lies on the boundary between two cells, so it is stored once per edge
+// rather than once per cell side: the right wall of (i, j) and the left wall of
+// (i + 1, j) are the same edge and can no longer disagree. Two bit-planes hold
+// the horizontal edges (top of cell (i, j), lines j = 0..GRID_SIZE) and the
+// vertical edges (left of cell (i, j), lines i = 0..GRID_SIZE), 2 bits per edge
+// holding the WallType value, 32 edges per 64-bit word. Queries outside the map
+// return WallType::None. Walls are centered on their edge (WALL_WIDTH/2 on each side).
+//
+// PERFORMANCE: 2 x 83 words = 1,328 bytes for the whole map instead of 10 KB of
+// per-cell sides, so it stays in L1 and is sent to clients as one span; wall
+// counts take one popcount per 32 edges.
+class CellGrid {
+public:
+    static constexpr int EDGES_PER_PLANE = (GRID_SIZE + 1) * GRID_SIZE;
+    static constexpr int EDGES_PER_WORD = 32;
+    static constexpr int WORDS_PER_PLANE = (EDGES_PER_PLANE + EDGES_PER_WORD - 1) / EDGES_PER_WORD;
+    static constexpr int WORD_COUNT = 2 * WORDS_PER_PLANE;
+    static constexpr size_t BYTE_SIZE = WORD_COUNT * sizeof(uint64_t);  // Serialized map size
+    
+    CellGrid() { clear(); }
+    
+    // Wall on the horizontal edge along the top of cell (i, j), j in [0, GRID_SIZE]
+    WallType horizontal(int i, int j) const {
+        if (i < 0 || i >= GRID_SIZE || j < 0 || j > GRID_SIZE) return WallType::None;
+        return get(HORIZONTAL, j * GRID_SIZE + i);
+    }
+    
+    // Wall on the vertical edge along the left of cell (i, j), i in [0, GRID_SIZE]
+    WallType vertical(int i, int j) const {
+        if (i < 0 || i > GRID_SIZE || j < 0 || j >= GRID_SIZE) return WallType::None;
+        return get(VERTICAL, i * GRID_SIZE + j);
+    }
+    
+    void setHorizontal(int i, int j, WallType type) {
+        if (i < 0 || i >= GRID_SIZE || j < 0 || j > GRID_SIZE) return;
+        set(HORIZONTAL, j * GRID_SIZE + i, type);
+    }
+    
+    void setVertical(int i, int j, WallType type) {
+        if (i < 0 || i > GRID_SIZE || j < 0 || j >= GRID_SIZE) return;
+        set(VERTICAL, i * GRID_SIZE + j, type);
+    }
+    
+    // Wall on one side of cell (i, j): 0 = top, 1 = right, 2 = bottom, 3 = left
+    WallType wall(int i, int j, int side) const {
+        switch (side) {
+            case 0: return horizontal(i, j);
+            case 1: return vertical(i + 1, j);
+            case 2: return horizontal(i, j + 1);
+            default: return vertical(i, j);
+        }
+    }
+    
+    void setWall(int i, int j, int side, WallType type) {
+        switch (side) {
+            case 0: setHorizontal(i, j, type); break;
+            case 1: setVertical(i + 1, j, type); break;
+            case 2: setHorizontal(i, j + 1, type); break;
+            default: setVertical(i, j, type); break;
+        }
+    }
+    
+    // Number of walls, a word (32 edges) at a time
+    size_t countWalls() const {
+        size_t count = 0;
+        for (uint64_t word : words_) {
+            count += popCount((word | (word >> 1)) & LOW_BITS);
+        }
+        return count;
+    }
+    
+    // Number of walls of one type (Concrete or Wood)
+    size_t countWalls(WallType type) const {
+        size_t count = 0;
+        for (uint64_t word : words_) {
+            uint64_t low = word & LOW_BITS;
+            uint64_t high = (word >> 1) & LOW_BITS;
+            count += popCount(type == WallType::Wood ? (high & ~low) : (low & ~high));
+        }
+        return count;
+    }
+    
+    // Remove every wall
+    void clear() { words_.fill(0); }
+    
+    // Raw storage, WORD_COUNT words: the horizontal plane, then the vertical plane
+    const uint64_t* data() const { return words_.data(); }
+    uint64_t* data() { return words_.data(); }
+    
+private:
+    static constexpr int HORIZONTAL = 0;
+    static constexpr int VERTICAL = 1;
+    static constexpr uint64_t LOW_BITS = 0x5555555555555555ULL;  // Low bit of every edge
+    
+    WallType get(int plane, int edge) const {
+        uint64_t word = words_[plane * WORDS_PER_PLANE + edge / EDGES_PER_WORD];
+        return static_cast<WallType>((word >> (edge % EDGES_PER_WORD * 2)) & 3);
+    }
+    
+    void set(int plane, int edge, WallType type) {
+        uint64_t& word = words_[plane * WORDS_PER_PLANE + edge / EDGES_PER_WORD];
+        const int shift = edge % EDGES_PER_WORD * 2;
+        word = (word & ~(3ULL << shift)) | (static_cast<uint64_t>(type) << shift);
+    }
+    
+    std::array<uint64_t, WORD_COUNT> words_;
+};
+
+// First wall entered by a segment, see Bullet::traceCellWallsDDA
+struct WallHit {
+    WallType type = WallType::None;  // None if the segment reaches its end unobstructed
+    float t = 1.0f;                  // Entry parameter along the segment (0 = start, 1 = end)
 };
 
 struct Shop {
@@ -500,8 +649,8 @@ struct Bullet {
     }
     
     // Helper function to check if a line segment intersects with a rectangle
-    bool lineIntersectsRect(float x1, float y1, float x2, float y2, 
-                           float rectX, float rectY, float rectW, float rectH) const {
+    static bool lineIntersectsRect(float x1, float y1, float x2, float y2, 
+                                   float rectX, float rectY, float rectW, float rectH) {
         // Check if either endpoint is inside the rectangle
         if ((x1 >= rectX && x1 <= rectX + rectW && y1 >= rectY && y1 <= rectY + rectH) ||
             (x2 >= rectX && x2 <= rectX + rectW && y2 >= rectY && y2 <= rectY + rectH)) {
@@ -536,65 +685,137 @@ struct Bullet {
     
     // Check collision with cell-based walls using ray casting (returns wall type if collision, None otherwise)
     // This method checks the trajectory from previous position to current position
-    WallType checkCellWallCollision(const std::vector<std::vector<Cell>>& grid, 
+    WallType checkCellWallCollision(const CellGrid& grid, 
                                     float prevX, float prevY) const {
-        // Calculate which cells the bullet trajectory passes through
-        int cellX1 = static_cast<int>(prevX / CELL_SIZE);
-        int cellY1 = static_cast<int>(prevY / CELL_SIZE);
-        int cellX2 = static_cast<int>(x / CELL_SIZE);
-        int cellY2 = static_cast<int>(y / CELL_SIZE);
-        
-        // Determine the range of cells to check
-        int minCellX = std::max(0, std::min(cellX1, cellX2) - 1);
-        int maxCellX = std::min(GRID_SIZE - 1, std::max(cellX1, cellX2) + 1);
-        int minCellY = std::max(0, std::min(cellY1, cellY2) - 1);
-        int maxCellY = std::min(GRID_SIZE - 1, std::max(cellY1, cellY2) + 1);
-        
-        // Check all cells along the trajectory
-        for (int i = minCellX; i <= maxCellX; i++) {
-            for (int j = minCellY; j <= maxCellY; j++) {
-                float cellWorldX = i * CELL_SIZE;
-                float cellWorldY = j * CELL_SIZE;
-                
-                // Check top wall
-                if (grid[i][j].topWall != WallType::None) {
-                    float wallX = cellWorldX;
-                    float wallY = cellWorldY - WALL_WIDTH / 2.0f;
-                    if (lineIntersectsRect(prevX, prevY, x, y, wallX, wallY, WALL_LENGTH, WALL_WIDTH)) {
-                        return grid[i][j].topWall;
-                    }
-                }
-                
-                // Check right wall
-                if (grid[i][j].rightWall != WallType::None) {
-                    float wallX = cellWorldX + CELL_SIZE - WALL_WIDTH / 2.0f;
-                    float wallY = cellWorldY;
-                    if (lineIntersectsRect(prevX, prevY, x, y, wallX, wallY, WALL_WIDTH, WALL_LENGTH)) {
-                        return grid[i][j].rightWall;
-                    }
-                }
-                
-                // Check bottom wall
-                if (grid[i][j].bottomWall != WallType::None) {
-                    float wallX = cellWorldX;
-                    float wallY = cellWorldY + CELL_SIZE - WALL_WIDTH / 2.0f;
-                    if (lineIntersectsRect(prevX, prevY, x, y, wallX, wallY, WALL_LENGTH, WALL_WIDTH)) {
-                        return grid[i][j].bottomWall;
-                    }
-                }
-                
-                // Check left wall
-                if (grid[i][j].leftWall != WallType::None) {
-                    float wallX = cellWorldX - WALL_WIDTH / 2.0f;
-                    float wallY = cellWorldY;
-                    if (lineIntersectsRect(prevX, prevY, x, y, wallX, wallY, WALL_WIDTH, WALL_LENGTH)) {
-                        return grid[i][j].leftWall;
-                    }
-                }
+        return traceCellWalls(grid, prevX, prevY, x, y);
+    }
+    
+    // Find the first wall crossed by the segment (prevX, prevY) -> (x, y)
+    // Shared by Bullet and BulletPool, which stores positions in separate arrays
+    static WallType traceCellWalls(const CellGrid& grid,
+                                   float prevX, float prevY, float x, float y) {
+        return traceCellWallsDDA(grid, prevX, prevY, x, y).type;
+    }
+    
+    // Slab test: does the segment (x1, y1) + t * (dx, dy), t in [0, 1], touch the rectangle?
+    // On success tEntry is the first t inside the rectangle (0 if the segment starts inside)
+    static bool segmentEntersRect(float x1, float y1, float dx, float dy,
+                                  float rectX, float rectY, float rectW, float rectH,
+                                  float& tEntry) {
+        float tMin = 0.0f;
+        float tMax = 1.0f;
+        
+        const float origin[2] = { x1, y1 };
+        const float dir[2] = { dx, dy };
+        const float lo[2] = { rectX, rectY };
+        const float hi[2] = { rectX + rectW, rectY + rectH };
+        
+        for (int axis = 0; axis < 2; ++axis) {
+            if (dir[axis] == 0.0f) {
+                // Parallel to this slab: must already be inside it
+                if (origin[axis] < lo[axis] || origin[axis] > hi[axis]) return false;
+                continue;
+            }
+            float t1 = (lo[axis] - origin[axis]) / dir[axis];
+            float t2 = (hi[axis] - origin[axis]) / dir[axis];
+            if (t1 > t2) std::swap(t1, t2);
+            tMin = std::max(tMin, t1);
+            tMax = std::min(tMax, t2);
+            if (tMin > tMax) return false;
+        }
+        
+        tEntry = tMin;
+        return true;
+    }
+    
+    // Amanda-Woo grid traversal: walk only the cells the segment (x1, y1) -> (x2, y2)
+    // actually crosses and return the wall it enters first, with its entry parameter t.
+    //
+    // ALGORITHM:
+    // - Start in the cell containing (x1, y1); tMaxX/tMaxY are the t values at which
+    //   the segment crosses the next vertical/horizontal cell boundary, tDeltaX/tDeltaY
+    //   the t needed to cross a whole cell. Always step across the nearer boundary.
+    // - Walls are centered on cell boundaries and stick WALL_WIDTH/2 into both cells,
+    //   so each visited cell tests the four edges around it.
+    // - Every wall touching a later cell is entered at t >= the current cell's exit t,
+    //   so the walk stops as soon as the best hit lies inside the current cell.
+    //
+    // PERFORMANCE: visits |dCellX| + |dCellY| + 1 cells (usually 1-2 per tick at
+    // bullet speeds) instead of the (dCellX + 3) * (dCellY + 3) bounding box scanned
+    // before, and only runs the slab test on walls that exist.
+    //
+    // concreteOnly ignores wood walls (line-of-sight checks, see LineOfSightRelevancy)
+    static WallHit traceCellWallsDDA(const CellGrid& grid,
+                                     float x1, float y1, float x2, float y2, bool concreteOnly = false) {
+        WallHit best;
+        const float dx = x2 - x1;
+        const float dy = y2 - y1;
+        
+        auto testWall = [&](WallType type, float rectX, float rectY, float rectW, float rectH) {
+            if (type == WallType::None || (concreteOnly && type != WallType::Concrete)) return;
+            float t;
+            if (segmentEntersRect(x1, y1, dx, dy, rectX, rectY, rectW, rectH, t) &&
+                (best.type == WallType::None || t < best.t)) {
+                best.type = type;
+                best.t = t;
+            }
+        };
+        
+        // Test the walls on all four boundaries of cell (i, j)
+        auto testCellBoundaries = [&](int i, int j) {
+            const float cellWorldX = i * CELL_SIZE;
+            const float cellWorldY = j * CELL_SIZE;
+            const float half = WALL_WIDTH / 2.0f;
+            
+            // One edge per boundary, shared with the neighbour cell
+            testWall(grid.horizontal(i, j), cellWorldX, cellWorldY - half, WALL_LENGTH, WALL_WIDTH);
+            testWall(grid.vertical(i + 1, j), cellWorldX + CELL_SIZE - half, cellWorldY, WALL_WIDTH, WALL_LENGTH);
+            testWall(grid.horizontal(i, j + 1), cellWorldX, cellWorldY + CELL_SIZE - half, WALL_LENGTH, WALL_WIDTH);
+            testWall(grid.vertical(i, j), cellWorldX - half, cellWorldY, WALL_WIDTH, WALL_LENGTH);
+        };
+        
+        int cellX = static_cast<int>(std::floor(x1 / CELL_SIZE));
+        int cellY = static_cast<int>(std::floor(y1 / CELL_SIZE));
+        const int endCellX = static_cast<int>(std::floor(x2 / CELL_SIZE));
+        const int endCellY = static_cast<int>(std::floor(y2 / CELL_SIZE));
+        
+        const int stepX = (dx > 0.0f) ? 1 : (dx < 0.0f ? -1 : 0);
+        const int stepY = (dy > 0.0f) ? 1 : (dy < 0.0f ? -1 : 0);
+        const float inf = std::numeric_limits<float>::infinity();
+        
+        float tMaxX = inf, tDeltaX = inf;
+        if (stepX != 0) {
+            float boundaryX = (cellX + (stepX > 0 ? 1 : 0)) * CELL_SIZE;
+            tMaxX = (boundaryX - x1) / dx;
+            tDeltaX = CELL_SIZE / std::abs(dx);
+        }
+        float tMaxY = inf, tDeltaY = inf;
+        if (stepY != 0) {
+            float boundaryY = (cellY + (stepY > 0 ? 1 : 0)) * CELL_SIZE;
+            tMaxY = (boundaryY - y1) / dy;
+            tDeltaY = CELL_SIZE / std::abs(dy);
+        }
+        
+        // Exact number of boundary crossings; also bounds the loop against rounding
+        int remainingSteps = std::abs(endCellX - cellX) + std::abs(endCellY - cellY);
+        
+        while (true) {
+            testCellBoundaries(cellX, cellY);
+            
+            const float tExit = std::min(tMaxX, tMaxY);
+            if (best.type != WallType::None && best.t <= tExit) break;
+            if (remainingSteps-- <= 0) break;
+            
+            if (tMaxX < tMaxY) {
+                cellX += stepX;
+                tMaxX += tDeltaX;
+            } else {
+                cellY += stepY;
+                tMaxY += tDeltaY;
             }
         }
         
-        return WallType::None;
+        return best;
     }
     
     // Requirement 7.4: Check collision with player (circle collision)
@@ -604,6 +825,248 @@ struct Bullet {
         float distanceSquared = dx * dx + dy * dy;
         return distanceSquared <= (playerRadius * playerRadius);
     }
+    
+    // Continuous bullet-vs-player test over one simulation step.
+    // The bullet moves (bx0, by0) -> (bx1, by1) while the player's center moves
+    // (cx0, cy0) -> (cx1, cy1) over the same step. Returns true if the bullet comes
+    // within radius of the center, with toi the time of impact in [0, 1].
+    //
+    // ALGORITHM:
+    // Work in the player's frame: the relative position is d + t * m with
+    // d = bullet0 - center0 and m = bulletMotion - playerMotion. Solve
+    // |d + t * m|^2 = radius^2 for the smaller root; starting inside gives toi = 0.
+    //
+    // Unlike checkPlayerCollision (end position only) this cannot tunnel: a
+    // 900 px/s bullet moves 90 px per tick at 10 Hz, six times the 15 px radius.
+    static bool sweptCircleHit(float bx0, float by0, float bx1, float by1,
+                               float cx0, float cy0, float cx1, float cy1,
+                               float radius, float& toi) {
+        const float dx = bx0 - cx0;
+        const float dy = by0 - cy0;
+        const float c = dx * dx + dy * dy - radius * radius;
+        if (c <= 0.0f) {
+            toi = 0.0f;  // Already overlapping at the start of the step
+            return true;
+        }
+        
+        const float mx = (bx1 - bx0) - (cx1 - cx0);
+        const float my = (by1 - by0) - (cy1 - cy0);
+        const float a = mx * mx + my * my;
+        const float b = mx * dx + my * dy;  // Half of the usual b
+        if (a <= 0.0f || b >= 0.0f) return false;  // Not moving closer
+        
+        const float discriminant = b * b - a * c;
+        if (discriminant < 0.0f) return false;  // Closest approach stays outside
+        
+        const float t = (-b - std::sqrt(discriminant)) / a;
+        if (t > 1.0f) return false;  // Reaches the player after this step
+        
+        toi = t;
+        return true;
+    }
+};
+
+// ========================
+// Bullet Pool (Structure of Arrays)
+// ========================
+
+// Fixed-capacity bullet storage for the authoritative simulation
+//
+// LAYOUT:
+// Each field lives in its own array (x[], y[], vx[], ...) so the integrate and
+// cull kernels stream through contiguous floats and process 4 (SSE) or 8 (AVX)
+// bullets per instruction. Bullet (with its sf::Clock) is only used to build
+// new bullets and on the client.
+//
+// ALGORITHM:
+// - spawn(): append at index size(); fails when the pool is full
+// - integrateAndCull(): prev = pos; pos += vel * dt; range -= speed * dt,
+//   then cull() - speed is cached at spawn, so there is no sqrt per tick
+// - cull(): drop bullets with range <= 0 or outside the map by swapping the
+//   last live bullet into the hole (O(1) per removal, order not preserved).
+//   Blocks of 4 that are all alive are skipped with one SIMD compare.
+//
+// Arrays are padded to a multiple of 8 so the SIMD loops never need masking.
+class BulletPool {
+public:
+    explicit BulletPool(size_t capacity) : capacity_(capacity), count_(0) {
+        size_t padded = (capacity + 7) & ~static_cast<size_t>(7);
+        for (std::vector<float>* field : { &x_, &y_, &prevX_, &prevY_, &vx_, &vy_, &speed_, &range_, &maxRange_, &damage_ }) {
+            field->assign(padded, 0.0f);
+        }
+        ownerId_.assign(padded, 0);
+        weaponType_.assign(padded, 0);
+        rewindTicks_.assign(padded, 0);
+    }
+    
+    // Add a bullet; returns false if the pool is full
+    // rewindTicks: how many ticks behind the server the shooter saw the world
+    // (targets are tested at their past positions, see PositionHistory)
+    bool spawn(const Bullet& bullet, uint16_t rewindTicks = 0) {
+        if (count_ >= capacity_) {
+            return false;
+        }
+        size_t i = count_++;
+        x_[i] = bullet.x;
+        y_[i] = bullet.y;
+        prevX_[i] = bullet.prevX;
+        prevY_[i] = bullet.prevY;
+        vx_[i] = bullet.vx;
+        vy_[i] = bullet.vy;
+        speed_[i] = std::sqrt(bullet.vx * bullet.vx + bullet.vy * bullet.vy);
+        range_[i] = bullet.range;
+        maxRange_[i] = bullet.maxRange;
+        damage_[i] = bullet.damage;
+        ownerId_[i] = bullet.ownerId;
+        weaponType_[i] = static_cast<uint8_t>(bullet.weaponType);
+        rewindTicks_[i] = rewindTicks;
+        return true;
+    }
+    
+    size_t size() const { return count_; }
+    size_t capacity() const { return capacity_; }
+    bool empty() const { return count_ == 0; }
+    void clear() { count_ = 0; }
+    
+    // Count live bullets fired by one player (per-player bullet limit)
+    int countOwnedBy(uint8_t ownerId) const {
+        int count = 0;
+        for (size_t i = 0; i < count_; ++i) {
+            if (ownerId_[i] == ownerId) count++;
+        }
+        return count;
+    }
+    
+    float x(size_t i) const { return x_[i]; }
+    float y(size_t i) const { return y_[i]; }
+    float prevX(size_t i) const { return prevX_[i]; }
+    float prevY(size_t i) const { return prevY_[i]; }
+    float vx(size_t i) const { return vx_[i]; }
+    float vy(size_t i) const { return vy_[i]; }
+    float range(size_t i) const { return range_[i]; }
+    float damage(size_t i) const { return damage_[i]; }
+    uint8_t ownerId(size_t i) const { return ownerId_[i]; }
+    uint16_t rewindTicks(size_t i) const { return rewindTicks_[i]; }
+    
+    // Mark a bullet for removal by the next cull()
+    void kill(size_t i) { range_[i] = 0.0f; }
+    
+    // Scale velocity and remaining range (wooden walls)
+    void slowDown(size_t i, float factor) {
+        vx_[i] *= factor;
+        vy_[i] *= factor;
+        speed_[i] *= factor;
+        range_[i] *= factor;
+    }
+    
+    // Requirement 7.2: Advance every bullet by deltaTime, then drop expired ones
+    void integrateAndCull(float deltaTime) {
+        size_t i = 0;
+        const size_t n = count_;
+        
+#ifdef ZG_BULLETS_AVX
+        const __m256 dt8 = _mm256_set1_ps(deltaTime);
+        for (; i + 8 <= n; i += 8) {
+            __m256 px = _mm256_loadu_ps(&x_[i]);
+            __m256 py = _mm256_loadu_ps(&y_[i]);
+            _mm256_storeu_ps(&prevX_[i], px);
+            _mm256_storeu_ps(&prevY_[i], py);
+            _mm256_storeu_ps(&x_[i], _mm256_add_ps(px, _mm256_mul_ps(_mm256_loadu_ps(&vx_[i]), dt8)));
+            _mm256_storeu_ps(&y_[i], _mm256_add_ps(py, _mm256_mul_ps(_mm256_loadu_ps(&vy_[i]), dt8)));
+            _mm256_storeu_ps(&range_[i], _mm256_sub_ps(_mm256_loadu_ps(&range_[i]),
+                                                       _mm256_mul_ps(_mm256_loadu_ps(&speed_[i]), dt8)));
+        }
+#endif
+#ifdef ZG_BULLETS_SSE
+        const __m128 dt4 = _mm_set1_ps(deltaTime);
+        for (; i + 4 <= n; i += 4) {
+            __m128 px = _mm_loadu_ps(&x_[i]);
+            __m128 py = _mm_loadu_ps(&y_[i]);
+            _mm_storeu_ps(&prevX_[i], px);
+            _mm_storeu_ps(&prevY_[i], py);
+            _mm_storeu_ps(&x_[i], _mm_add_ps(px, _mm_mul_ps(_mm_loadu_ps(&vx_[i]), dt4)));
+            _mm_storeu_ps(&y_[i], _mm_add_ps(py, _mm_mul_ps(_mm_loadu_ps(&vy_[i]), dt4)));
+            _mm_storeu_ps(&range_[i], _mm_sub_ps(_mm_loadu_ps(&range_[i]),
+                                                 _mm_mul_ps(_mm_loadu_ps(&speed_[i]), dt4)));
+        }
+#endif
+        // Scalar tail (and the whole pool without SIMD)
+        for (; i < n; ++i) {
+            prevX_[i] = x_[i];
+            prevY_[i] = y_[i];
+            x_[i] += vx_[i] * deltaTime;
+            y_[i] += vy_[i] * deltaTime;
+            range_[i] -= speed_[i] * deltaTime;
+        }
+        
+        cull();
+    }
+    
+    // Requirement 7.5, 10.2: Remove bullets out of range or outside the map
+    void cull() {
+        size_t i = 0;
+        while (i < count_) {
+#ifdef ZG_BULLETS_SSE
+            if (i + 4 <= count_) {
+                const __m128 zero = _mm_setzero_ps();
+                const __m128 mapSize = _mm_set1_ps(MAP_SIZE);
+                __m128 bx = _mm_loadu_ps(&x_[i]);
+                __m128 by = _mm_loadu_ps(&y_[i]);
+                __m128 dead = _mm_cmple_ps(_mm_loadu_ps(&range_[i]), zero);
+                dead = _mm_or_ps(dead, _mm_or_ps(_mm_cmplt_ps(bx, zero), _mm_cmpgt_ps(bx, mapSize)));
+                dead = _mm_or_ps(dead, _mm_or_ps(_mm_cmplt_ps(by, zero), _mm_cmpgt_ps(by, mapSize)));
+                if (_mm_movemask_ps(dead) == 0) {
+                    i += 4; // Whole block alive
+                    continue;
+                }
+            }
+#endif
+            if (isDead(i)) {
+                removeAt(i); // Re-check index i: it now holds the former last bullet
+            } else {
+                ++i;
+            }
+        }
+    }
+    
+private:
+    bool isDead(size_t i) const {
+        return range_[i] <= 0.0f || x_[i] < 0.0f || x_[i] > MAP_SIZE || y_[i] < 0.0f || y_[i] > MAP_SIZE;
+    }
+    
+    // Swap-remove: move the last bullet into slot i
+    void removeAt(size_t i) {
+        size_t last = --count_;
+        if (i == last) {
+            return;
+        }
+        x_[i] = x_[last];
+        y_[i] = y_[last];
+        prevX_[i] = prevX_[last];
+        prevY_[i] = prevY_[last];
+        vx_[i] = vx_[last];
+        vy_[i] = vy_[last];
+        speed_[i] = speed_[last];
+        range_[i] = range_[last];
+        maxRange_[i] = maxRange_[last];
+        damage_[i] = damage_[last];
+        ownerId_[i] = ownerId_[last];
+        weaponType_[i] = weaponType_[last];
+        rewindTicks_[i] = rewindTicks_[last];
+    }
+    
+    size_t capacity_;
+    size_t count_;
+    std::vector<float> x_, y_;
+    std::vector<float> prevX_, prevY_;
+    std::vector<float> vx_, vy_;
+    std::vector<float> speed_;      // |v|, cached at spawn
+    std::vector<float> range_;      // Remaining range
+    std::vector<float> maxRange_;   // Initial range
+    std::vector<float> damage_;
+    std::vector<uint8_t> ownerId_;
+    std::vector<uint8_t> weaponType_;
+    std::vector<uint16_t> rewindTicks_;  // Lag compensation, 0 = test against current positions
 };
 
 // Requirement 8.2: Damage text visualization
@@ -810,23 +1273,12 @@ public:
 // NEW: Cell-Based Map Generation Functions
 // ========================
 
-// Set a wall on a specific side of a cell
-// side: 0=top, 1=right, 2=bottom, 3=left
-// type: WallType to set (Concrete or Wood)
-void setWall(Cell& cell, int side, WallType type) {
-    switch (side) {
-        case 0: cell.topWall = type; break;
-        case 1: cell.rightWall = type; break;
-        case 2: cell.bottomWall = type; break;
-        case 3: cell.leftWall = type; break;
-    }
-}
-
 // Generate map using probabilistic algorithm
 // Only cells where (i+j)%2==1 can have walls
 // Probabilities: 60% - 1 wall, 25% - 2 walls, 15% - 0 walls
 // Wall types: 70% concrete, 30% wood
-void generateMap(std::vector<std::vector<Cell>>& grid) {
+// A wall on a side shared with a neighbour that already has one there replaces it
+void generateMap(CellGrid& grid) {
     std::random_device rd;
     std::mt19937 gen(rd());
     std::uniform_int_distribution<int> probDist(0, 99);  // 0-99 for percentages
@@ -844,7 +1296,7 @@ void generateMap(std::vector<std::vector<Cell>>& grid) {
                     int side = sideDist(gen);
                     // Determine wall type: 70% concrete, 30% wood
                     WallType type = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
-                    setWall(grid[i][j], side, type);
+                    grid.setWall(i, j, side, type);
                 }
                 else if (probability < 85) {
                     // 25% probability (60-84) - create two walls on different sides
@@ -859,8 +1311,8 @@ void generateMap(std::vector<std::vector<Cell>>& grid) {
                     // Each wall gets its own type
                     WallType type1 = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
                     WallType type2 = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
-                    setWall(grid[i][j], side1, type1);
-                    setWall(grid[i][j], side2, type2);
+                    grid.setWall(i, j, side1, type1);
+                    grid.setWall(i, j, side2, type2);
                 }
                 // 15% probability (85-99) - no walls (do nothing)
             }
@@ -878,27 +1330,27 @@ void generateMap(std::vector<std::vector<Cell>>& grid) {
 //   to - Destination cell coordinates
 //   grid - The map grid containing wall information
 // Returns: true if movement is possible (no wall blocking), false otherwise
-bool canMove(sf::Vector2i from, sf::Vector2i to, const std::vector<std::vector<Cell>>& grid) {
+bool canMove(sf::Vector2i from, sf::Vector2i to, const CellGrid& grid) {
     // Calculate direction of movement
     int dx = to.x - from.x;
     int dy = to.y - from.y;
     
     // Check walls based on direction
     if (dx == 1) {
-        // Moving right: check if there's a right wall in the 'from' cell
-        return grid[from.x][from.y].rightWall == WallType::None;
+        // Moving right: check the edge between the two cells
+        return grid.vertical(from.x + 1, from.y) == WallType::None;
     }
     else if (dx == -1) {
-        // Moving left: check if there's a left wall in the 'from' cell
-        return grid[from.x][from.y].leftWall == WallType::None;
+        // Moving left: check the edge between the two cells
+        return grid.vertical(from.x, from.y) == WallType::None;
     }
     else if (dy == 1) {
-        // Moving down: check if there's a bottom wall in the 'from' cell
-        return grid[from.x][from.y].bottomWall == WallType::None;
+        // Moving down: check the edge between the two cells
+        return grid.horizontal(from.x, from.y + 1) == WallType::None;
     }
     else if (dy == -1) {
-        // Moving up: check if there's a top wall in the 'from' cell
-        return grid[from.x][from.y].topWall == WallType::None;
+        // Moving up: check the edge between the two cells
+        return grid.horizontal(from.x, from.y) == WallType::None;
     }
     
     // No movement or invalid movement
@@ -926,9 +1378,18 @@ bool canMove(sf::Vector2i from, sf::Vector2i to, const std::vector<std::vector<C
 //
 // Performance: O(n) where n = number of grid cells (167x167 = 27,889 cells max)
 // Typical runtime: < 10ms for most maps
-bool isPathExists(sf::Vector2i start, sf::Vector2i end, const std::vector<std::vector<Cell>>& grid) {
-    // Create visited array to track explored cells
-    std::vector<std::vector<bool>> visited(GRID_SIZE, std::vector<bool>(GRID_SIZE, false));
+bool isPathExists(sf::Vector2i start, sf::Vector2i end, const CellGrid& grid) {
+    // Visited flags with a border of cells around the map that start out visited,
+    // so neighbours never need a bounds check
+    const int stride = GRID_SIZE + 2;
+    std::vector<uint8_t> visited(stride * stride, 0);
+    auto visitedIndex = [stride](int x, int y) { return (x + 1) * stride + (y + 1); };
+    for (int k = -1; k <= GRID_SIZE; k++) {
+        visited[visitedIndex(-1, k)] = 1;
+        visited[visitedIndex(GRID_SIZE, k)] = 1;
+        visited[visitedIndex(k, -1)] = 1;
+        visited[visitedIndex(k, GRID_SIZE)] = 1;
+    }
     
     // Queue for BFS traversal
     std::queue<sf::Vector2i> queue;
@@ -945,7 +1406,7 @@ bool isPathExists(sf::Vector2i start, sf::Vector2i end, const std::vector<std::v
     
     // Initialize BFS: add start cell to queue and mark as visited
     queue.push(startCell);
-    visited[startCell.x][startCell.y] = true;
+    visited[visitedIndex(startCell.x, startCell.y)] = 1;
     
     // Direction vectors for 4-directional movement (up, right, down, left)
     const int dx[] = {0, 1, 0, -1};
@@ -966,12 +1427,12 @@ bool isPathExists(sf::Vector2i start, sf::Vector2i end, const std::vector<std::v
             int nx = current.x + dx[i];
             int ny = current.y + dy[i];
             
-            // Check if neighbor is valid: within bounds and not visited
-            if (nx >= 0 && nx < GRID_SIZE && ny >= 0 && ny < GRID_SIZE && !visited[nx][ny]) {
+            // Check if neighbor is not visited (border cells count as visited)
+            if (!visited[visitedIndex(nx, ny)]) {
                 // Check if we can move from current cell to neighbor cell (no wall blocking)
                 sf::Vector2i neighbor(nx, ny);
                 if (canMove(current, neighbor, grid)) {
-                    visited[nx][ny] = true;
+                    visited[visitedIndex(nx, ny)] = 1;
                     queue.push(neighbor);
                 }
             }
@@ -1004,7 +1465,7 @@ bool isPathExists(sf::Vector2i start, sf::Vector2i end, const std::vector<std::v
 // - Server spawn: (250, 4750) - bottom-left area of 5000x5000 map
 // - Client spawn: (4750, 250) - top-right area of 5000x5000 map
 // These are far apart to ensure interesting gameplay
-bool generateValidMap(std::vector<std::vector<Cell>>& grid) {
+bool generateValidMap(CellGrid& grid) {
     const int MAX_ATTEMPTS = 10;
     
     std::cout << "\n=== Starting Map Generation ===" << std::endl;
@@ -1018,44 +1479,16 @@ bool generateValidMap(std::vector<std::vector<Cell>>& grid) {
         
         // Step 1: Clear the grid before each attempt
         std::cout << "Clearing grid..." << std::endl;
-        for (int i = 0; i < GRID_SIZE; i++) {
-            for (int j = 0; j < GRID_SIZE; j++) {
-                grid[i][j] = Cell(); // Reset to default (all walls false)
-            }
-        }
+        grid.clear(); // Reset to default (all walls None)
         
         // Step 2: Generate walls using probabilistic algorithm
         std::cout << "Generating walls..." << std::endl;
         generateMap(grid);
         
         // Count generated walls for logging
-        int wallCount = 0;
-        int concreteCount = 0;
-        int woodCount = 0;
-        for (int i = 0; i < GRID_SIZE; i++) {
-            for (int j = 0; j < GRID_SIZE; j++) {
-                if (grid[i][j].topWall != WallType::None) {
-                    wallCount++;
-                    if (grid[i][j].topWall == WallType::Concrete) concreteCount++;
-                    else woodCount++;
-                }
-                if (grid[i][j].rightWall != WallType::None) {
-                    wallCount++;
-                    if (grid[i][j].rightWall == WallType::Concrete) concreteCount++;
-                    else woodCount++;
-                }
-                if (grid[i][j].bottomWall != WallType::None) {
-                    wallCount++;
-                    if (grid[i][j].bottomWall == WallType::Concrete) concreteCount++;
-                    else woodCount++;
-                }
-                if (grid[i][j].leftWall != WallType::None) {
-                    wallCount++;
-                    if (grid[i][j].leftWall == WallType::Concrete) concreteCount++;
-                    else woodCount++;
-                }
-            }
-        }
+        size_t wallCount = grid.countWalls();
+        size_t concreteCount = grid.countWalls(WallType::Concrete);
+        size_t woodCount = grid.countWalls(WallType::Wood);
         std::cout << "Generated " << wallCount << " walls (Concrete: " << concreteCount 
                   << ", Wood: " << woodCount << ")" << std::endl;
         std::cout << "Generated " << wallCount << " walls" << std::endl;
@@ -1120,7 +1553,7 @@ bool generateValidMap(std::vector<std::vector<Cell>>& grid) {
 // FALLBACK PATTERN:
 // If random generation fails after 100 attempts, shops are placed in a
 // predetermined grid pattern that guarantees valid placement.
-bool generateShops(std::vector<Shop>& shops, const std::vector<sf::Vector2i>& spawnPoints, const std::vector<std::vector<Cell>>& grid) {
+bool generateShops(std::vector<Shop>& shops, const std::vector<sf::Vector2i>& spawnPoints, const CellGrid& grid) {
     const int NUM_SHOPS = 26;
     const int MAX_ATTEMPTS = 100;
     const int MIN_SPAWN_DISTANCE = 5;  // Minimum distance from spawn points in grid cells
@@ -1458,6 +1891,7 @@ struct ReadyPacket {
 struct StartPacket {
     MessageType type = MessageType::SERVER_START;
     uint32_t timestamp = 0;
+    uint16_t tickRate = 0;  // Server simulation ticks per second (snapshot ticks -> time)
 };
 
 struct MapDataPacket {
@@ -1484,15 +1918,17 @@ struct PositionPacket {
 // Requirement 4.1-4.5: Purchase validation and transaction
 struct PurchasePacket {
     uint8_t playerId;
-    uint8_t weaponType;  // Weapon::Type enum value
+    uint8_t weaponType;        // Weapon::Type enum value, 255 = buying ammo
+    uint8_t ammoType = 255;    // AmmoType enum value, 255 = buying a weapon
 };
 
-// Inventory update packet (server → all clients)
-// Sent after successful purchase to synchronize inventory
+// Inventory update packet (server → buyer)
+// Sent in answer to every purchase to confirm or undo it and synchronize the balance
 struct InventoryPacket {
     uint8_t playerId;
-    uint8_t slot;        // Which slot changed (0-3)
+    uint8_t slot;        // Which slot changed (0-3), 255 = none
     uint8_t weaponType;  // Weapon::Type enum value, 255 = empty slot
+    bool accepted;       // False if the server refused the purchase
     int newMoneyBalance;
 };
 
@@ -1506,6 +1942,7 @@ struct ShotPacket {
     float bulletSpeed;   // Bullet speed for this weapon
     float damage;        // Damage for this weapon
     float range;         // Range for this weapon
+    uint32_t viewTick;   // Tick of the latest server snapshot the shooter had (lag compensation)
 };
 
 // Requirement 10.4: Hit packet (server → all clients)
@@ -1529,13 +1966,13 @@ struct ShopPositionsPacket {
 // Packet Validation Functions
 // ========================
 
-bool validatePosition(const PositionPacket& packet) {
-    bool valid = packet.x >= 0.0f && packet.x <= MAP_SIZE &&
-                 packet.y >= 0.0f && packet.y <= MAP_SIZE;
+bool validatePosition(float x, float y) {
+    bool valid = x >= 0.0f && x <= MAP_SIZE &&
+                 y >= 0.0f && y <= MAP_SIZE;
     
     if (!valid) {
         std::ostringstream oss;
-        oss << "Position out of bounds: (" << packet.x << ", " << packet.y << ")";
+        oss << "Position out of bounds: (" << x << ", " << y << ")";
         ErrorHandler::handleInvalidPacket(oss.str());
     }
     
@@ -1569,2706 +2006,5907 @@ bool validateConnect(const ConnectPacket& packet) {
 }
 
 // ========================
-// Map Generation Functions
+// Snapshot Compression
 // ========================
 
-bool overlapsSpawnPoint(const Wall& wall) {
-    sf::FloatRect wallBounds(wall.x, wall.y, wall.width, wall.height);
-    sf::FloatRect serverSpawn(0.0f, 450.0f, 50.0f, 50.0f);   // Bottom-left corner
-    sf::FloatRect clientSpawn(450.0f, 0.0f, 50.0f, 50.0f);   // Top-right corner
-    
-    return wallBounds.intersects(serverSpawn) || wallBounds.intersects(clientSpawn);
+// Player state as carried in snapshots, quantized to the map and byte ranges
+struct QuantizedPlayerState {
+    uint8_t id = 0;
+    uint16_t x = 0;         // 0..65535 over 0..MAP_SIZE (~0.08 px)
+    uint16_t y = 0;
+    uint16_t rotation = 0;  // 0..511 over 0..360 degrees (~0.7 degrees)
+    uint8_t health = 0;     // Whole hit points, clamped to 0..255
+    bool isAlive = false;
+};
+
+const uint8_t SNAPSHOT_MARKER = 0xD5;           // First byte of a snapshot payload
+const int SNAPSHOT_ID_BITS = 6;                 // MAX_PLAYERS = 64
+const int SNAPSHOT_COUNT_BITS = 7;              // 0..64 players
+const int SNAPSHOT_POSITION_BITS = 16;
+const int SNAPSHOT_SMALL_DELTA_BITS = 10;       // Signed, +-511 units (~40 px) covers normal movement
+const int SNAPSHOT_ROTATION_BITS = 9;
+const int SNAPSHOT_HEALTH_BITS = 8;
+const int SNAPSHOT_BASELINE_BITS = 16;          // Baseline is sent as a tick offset
+const uint32_t SNAPSHOT_HISTORY_SIZE = 32;      // Snapshots kept as delta baselines (1.6 s at 20 Hz)
+const size_t MAX_SNAPSHOT_BYTES = 1192;         // Leaves room for the wire headers in one datagram
+const uint32_t NO_SNAPSHOT_ACK = 0xFFFFFFFF;    // Input message ackTick before the first snapshot
+
+uint16_t quantizePosition(float value) {
+    float clamped = std::max(0.0f, std::min(MAP_SIZE, value));
+    return static_cast<uint16_t>(std::lround(clamped / MAP_SIZE * 65535.0f));
 }
 
-bool cellHasWall(int cellX, int cellY, const GameMap& map) {
-    sf::FloatRect cellBounds(cellX * 10.0f, cellY * 10.0f, 10.0f, 10.0f);
-    for (const auto& wall : map.walls) {
-        sf::FloatRect wallBounds(wall.x, wall.y, wall.width, wall.height);
-        if (cellBounds.intersects(wallBounds)) return true;
-    }
-    return false;
+float dequantizePosition(uint16_t value) {
+    return value * (MAP_SIZE / 65535.0f);
 }
 
-// BREADTH-FIRST SEARCH (BFS) ALGORITHM EXPLANATION:
-// BFS is a graph traversal algorithm that explores all neighbors at the current depth
-// before moving to nodes at the next depth level. It guarantees finding the shortest path.
-//
-// How it works for map validation:
-// 1. Divide the 500x500 map into a 50x50 grid (10 units per cell)
-// 2. Start from server spawn point (bottom-left corner)
-// 3. Explore all adjacent cells (up, down, left, right) that don't contain walls
-// 4. Mark each visited cell to avoid revisiting
-// 5. Continue until we reach client spawn point (top-right corner) or exhaust all paths
-// 6. If we reach the end, the map is valid (players can reach each other)
-//
-// Why BFS instead of DFS?
-// - BFS guarantees finding a path if one exists
-// - BFS finds the shortest path (though we only care about existence)
-// - BFS is more predictable for this use case
-//
-// Performance: O(n) where n = number of grid cells (50x50 = 2500 cells max)
-// Typical runtime: < 1ms for most maps
-bool bfsPathExists(sf::Vector2f start, sf::Vector2f end, const GameMap& map) {
-    // BFS on a grid with 10x10 unit cells
-    const int gridSize = 50; // 500/10 = 50
-    std::vector<std::vector<bool>> visited(gridSize, std::vector<bool>(gridSize, false));
-    std::queue<sf::Vector2i> queue;
+uint16_t quantizeRotation(float degrees) {
+    float wrapped = std::fmod(degrees, 360.0f);
+    if (wrapped < 0.0f) wrapped += 360.0f;
+    const uint32_t steps = 1u << SNAPSHOT_ROTATION_BITS;
+    return static_cast<uint16_t>(static_cast<uint32_t>(std::lround(wrapped / 360.0f * steps)) & (steps - 1));
+}
+
+float dequantizeRotation(uint16_t value) {
+    return value * (360.0f / (1u << SNAPSHOT_ROTATION_BITS));
+}
+
+QuantizedPlayerState quantizePlayerState(uint32_t id, float x, float y, float rotation, float health, bool isAlive) {
+    QuantizedPlayerState state;
+    state.id = static_cast<uint8_t>(id);
+    state.x = quantizePosition(x);
+    state.y = quantizePosition(y);
+    state.rotation = quantizeRotation(rotation);
+    state.health = static_cast<uint8_t>(std::max(0L, std::min(255L, std::lround(health))));
+    state.isAlive = isAlive;
+    return state;
+}
+
+// Appends values of 1-32 bits to a fixed buffer, least significant bit first
+// Writing past the end sets overflowed() instead of growing the buffer
+class BitWriter {
+public:
+    BitWriter(uint8_t* buffer, size_t capacity) : buffer_(buffer), capacity_(capacity), bitPos_(0), overflowed_(false) {
+        std::memset(buffer_, 0, capacity_);
+    }
     
-    // Convert world coordinates to grid coordinates
-    sf::Vector2i startCell(static_cast<int>(start.x / 10), static_cast<int>(start.y / 10));
-    sf::Vector2i endCell(static_cast<int>(end.x / 10), static_cast<int>(end.y / 10));
+    void write(uint32_t value, int bits) {
+        if (bitPos_ + bits > capacity_ * 8) {
+            overflowed_ = true;
+            return;
+        }
+        for (int i = 0; i < bits; ++i) {
+            if (value & (1u << i)) {
+                buffer_[bitPos_ >> 3] |= static_cast<uint8_t>(1u << (bitPos_ & 7));
+            }
+            bitPos_++;
+        }
+    }
     
-    // Clamp to valid grid bounds to prevent out-of-bounds access
-    startCell.x = std::max(0, std::min(gridSize - 1, startCell.x));
-    startCell.y = std::max(0, std::min(gridSize - 1, startCell.y));
-    endCell.x = std::max(0, std::min(gridSize - 1, endCell.x));
-    endCell.y = std::max(0, std::min(gridSize - 1, endCell.y));
+    void writeBool(bool value) { write(value ? 1u : 0u, 1); }
     
-    // Initialize BFS: add start cell to queue and mark as visited
-    queue.push(startCell);
-    visited[startCell.x][startCell.y] = true;
+    size_t bytesWritten() const { return (bitPos_ + 7) / 8; }
+    bool overflowed() const { return overflowed_; }
     
-    // Direction vectors for 4-directional movement (right, down, left, up)
-    const int dx[] = {0, 1, 0, -1};
-    const int dy[] = {1, 0, -1, 0};
+private:
+    uint8_t* buffer_;
+    size_t capacity_;
+    size_t bitPos_;
+    bool overflowed_;
+};
+
+// Reads values written by BitWriter straight from the receive buffer
+// Reading past the end returns 0 and sets failed(); callers check once at the end
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size) : data_(data), size_(size), bitPos_(0), failed_(false) {}
     
-    // BFS main loop: explore all reachable cells
-    while (!queue.empty()) {
-        sf::Vector2i current = queue.front();
-        queue.pop();
-        
-        // Success: we reached the destination
-        if (current == endCell) return true;
-        
-        // Explore all 4 adjacent cells
-        for (int i = 0; i < 4; ++i) {
-            int nx = current.x + dx[i];
-            int ny = current.y + dy[i];
-            
-            // Check if neighbor is valid: within bounds, not visited, and no wall
-            if (nx >= 0 && nx < gridSize && ny >= 0 && ny < gridSize &&
-                !visited[nx][ny] && !cellHasWall(nx, ny, map)) {
-                visited[nx][ny] = true;
-                queue.push(sf::Vector2i(nx, ny));
+    uint32_t read(int bits) {
+        if (bitPos_ + bits > size_ * 8) {
+            failed_ = true;
+            return 0;
+        }
+        uint32_t value = 0;
+        for (int i = 0; i < bits; ++i) {
+            if (data_[bitPos_ >> 3] & (1u << (bitPos_ & 7))) {
+                value |= (1u << i);
             }
+            bitPos_++;
         }
+        return value;
     }
     
-    // Failed: no path exists between start and end
-    return false;
-}
+    bool readBool() { return read(1) != 0; }
+    
+    bool failed() const { return failed_; }
+    
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t bitPos_;
+    bool failed_;
+};
 
-bool validateConnectivity(const GameMap& map) {
-    // BFS from bottom-left to top-right
-    sf::Vector2f start(25.0f, 475.0f);  // Server spawn
-    sf::Vector2f end(475.0f, 25.0f);    // Client spawn
+// Recently sent (server, per client) or received (client) snapshots, usable as delta baselines
+// Slots are reused round-robin so the tick spacing between snapshots does not matter
+class SnapshotHistory {
+public:
+    void store(uint32_t tick, const std::vector<QuantizedPlayerState>& players) {
+        Entry& entry = entries_[next_];
+        entry.tick = tick;
+        entry.valid = true;
+        entry.players = players;  // Reuses the slot's capacity
+        next_ = (next_ + 1) % SNAPSHOT_HISTORY_SIZE;
+    }
+    
+    const std::vector<QuantizedPlayerState>* find(uint32_t tick) const {
+        for (const Entry& entry : entries_) {
+            if (entry.valid && entry.tick == tick) {
+                return &entry.players;
+            }
+        }
+        return nullptr;
+    }
     
-    return bfsPathExists(start, end, map);
+private:
+    struct Entry {
+        uint32_t tick = 0;
+        bool valid = false;
+        std::vector<QuantizedPlayerState> players;  // Sorted by id
+    };
+    std::array<Entry, SNAPSHOT_HISTORY_SIZE> entries_;
+    uint32_t next_ = 0;
+};
+
+// Position field: unchanged (1 bit), small signed delta (12 bits) or full value (18 bits)
+inline void writePositionDelta(BitWriter& writer, uint16_t value, uint16_t base) {
+    int delta = static_cast<int>(value) - static_cast<int>(base);
+    const int smallLimit = 1 << (SNAPSHOT_SMALL_DELTA_BITS - 1);
+    writer.writeBool(delta != 0);
+    if (delta == 0) return;
+    bool small = delta >= -smallLimit && delta < smallLimit;
+    writer.writeBool(small);
+    if (small) {
+        writer.write(static_cast<uint32_t>(delta) & ((1u << SNAPSHOT_SMALL_DELTA_BITS) - 1), SNAPSHOT_SMALL_DELTA_BITS);
+    } else {
+        writer.write(value, SNAPSHOT_POSITION_BITS);
+    }
 }
 
-void generateWalls(GameMap& map) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> posDist(50.0f, 450.0f); // Avoid edges
-    std::uniform_real_distribution<float> lengthDist(8.0f, 60.0f); // Wall length 8-60 pixels
-    std::uniform_real_distribution<float> thicknessDist(8.0f, 12.0f); // Wall thickness 8-12 pixels
-    std::uniform_int_distribution<int> orientationDist(0, 1); // 0=horizontal, 1=vertical
-    
-    // Generate 15-25 random walls
-    std::uniform_int_distribution<int> wallCountDist(15, 25);
-    int numWalls = wallCountDist(gen);
-    
-    for (int i = 0; i < numWalls; ++i) {
-        Wall wall;
-        float length = lengthDist(gen);
-        float thickness = thicknessDist(gen);
-        int orientation = orientationDist(gen);
-        
-        wall.x = posDist(gen);
-        wall.y = posDist(gen);
-        
-        if (orientation == 0) {
-            // Horizontal wall
-            wall.width = length;
-            wall.height = thickness;
-        } else {
-            // Vertical wall
-            wall.width = thickness;
-            wall.height = length;
-        }
+inline uint16_t readPositionDelta(BitReader& reader, uint16_t base) {
+    if (!reader.readBool()) return base;
+    if (!reader.readBool()) return static_cast<uint16_t>(reader.read(SNAPSHOT_POSITION_BITS));
+    uint32_t raw = reader.read(SNAPSHOT_SMALL_DELTA_BITS);
+    int delta = static_cast<int>(raw);
+    if (raw & (1u << (SNAPSHOT_SMALL_DELTA_BITS - 1))) {
+        delta -= (1 << SNAPSHOT_SMALL_DELTA_BITS);  // Sign-extend
+    }
+    return static_cast<uint16_t>(static_cast<int>(base) + delta);
+}
+
+// Encode one snapshot
+// Parameters:
+//   writer - Output buffer
+//   tick - Server tick of this snapshot
+//   players - States to send, sorted by id
+//   baseline - Snapshot the client acknowledged (nullptr = full snapshot)
+//   baselineTick - Tick of baseline, at most 65535 ticks old
+//
+// FORMAT (bit-packed, LSB first):
+//   marker:8  tick:32  hasBaseline:1  [tick - baselineTick:16]  count:7
+//   per player: id:6, then
+//     not in baseline: x:16 y:16 rotation:9 health:8 alive:1
+//     in baseline:     x:delta y:delta [changed:1 rotation:9] [changed:1 health:8] alive:1
+//   Players missing from a snapshot are not visible to the client (culled or gone).
+//
+// PERFORMANCE: a PositionPacket per player costs 32 bytes; a full entry is
+// 56 bits and an idle player in a delta snapshot is 11 bits (~23x smaller).
+void writeSnapshot(BitWriter& writer, uint32_t tick, const std::vector<QuantizedPlayerState>& players,
+                   const std::vector<QuantizedPlayerState>* baseline, uint32_t baselineTick) {
+    writer.write(SNAPSHOT_MARKER, 8);
+    writer.write(tick, 32);
+    writer.writeBool(baseline != nullptr);
+    if (baseline) {
+        writer.write(tick - baselineTick, SNAPSHOT_BASELINE_BITS);
+    }
+    writer.write(static_cast<uint32_t>(players.size()), SNAPSHOT_COUNT_BITS);
+    
+    size_t b = 0;  // Both lists are sorted by id: merge instead of searching
+    for (const QuantizedPlayerState& state : players) {
+        writer.write(state.id, SNAPSHOT_ID_BITS);
         
-        // Ensure wall stays within bounds
-        if (wall.x + wall.width > 500.0f) {
-            wall.x = 500.0f - wall.width;
-        }
-        if (wall.y + wall.height > 500.0f) {
-            wall.y = 500.0f - wall.height;
+        const QuantizedPlayerState* base = nullptr;
+        if (baseline) {
+            while (b < baseline->size() && (*baseline)[b].id < state.id) b++;
+            if (b < baseline->size() && (*baseline)[b].id == state.id) base = &(*baseline)[b];
         }
         
-        // Ensure wall doesn't overlap spawn points
-        if (!overlapsSpawnPoint(wall)) {
-            map.walls.push_back(wall);
+        if (base) {
+            writePositionDelta(writer, state.x, base->x);
+            writePositionDelta(writer, state.y, base->y);
+            writer.writeBool(state.rotation != base->rotation);
+            if (state.rotation != base->rotation) writer.write(state.rotation, SNAPSHOT_ROTATION_BITS);
+            writer.writeBool(state.health != base->health);
+            if (state.health != base->health) writer.write(state.health, SNAPSHOT_HEALTH_BITS);
+        } else {
+            writer.write(state.x, SNAPSHOT_POSITION_BITS);
+            writer.write(state.y, SNAPSHOT_POSITION_BITS);
+            writer.write(state.rotation, SNAPSHOT_ROTATION_BITS);
+            writer.write(state.health, SNAPSHOT_HEALTH_BITS);
         }
+        writer.writeBool(state.isAlive);
     }
 }
 
-std::unique_ptr<Quadtree> buildQuadtree(std::vector<Wall>& walls, float mapWidth, float mapHeight) {
-    // Create root quadtree node covering entire map
-    auto quadtree = std::make_unique<Quadtree>(sf::FloatRect(0.0f, 0.0f, mapWidth, mapHeight));
-    
-    // Insert all walls into the quadtree
-    for (auto& wall : walls) {
-        quadtree->insert(&wall);
-    }
-    
-    std::cout << "[INFO] Quadtree built successfully" << std::endl;
-    return quadtree;
-}
-
-GameMap generateMap() {
-    sf::Clock mapGenClock;
-    
-    for (int attempt = 0; attempt < 10; ++attempt) {
-        GameMap map;
-        generateWalls(map);
+// Decode one snapshot in place from the receive buffer
+// Parameters:
+//   data, size - Received datagram
+//   history - Previously decoded snapshots (delta baselines)
+//   tick - Out: server tick of the snapshot
+//   players - Out: decoded states, sorted by id
+// Returns: false if the datagram is malformed/truncated or its baseline is unknown
+bool readSnapshot(const uint8_t* data, size_t size, const SnapshotHistory& history,
+                  uint32_t& tick, std::vector<QuantizedPlayerState>& players) {
+    BitReader reader(data, size);
+    if (reader.read(8) != SNAPSHOT_MARKER) return false;
+    tick = reader.read(32);
+    
+    const std::vector<QuantizedPlayerState>* baseline = nullptr;
+    if (reader.readBool()) {
+        uint32_t baselineTick = tick - reader.read(SNAPSHOT_BASELINE_BITS);
+        baseline = history.find(baselineTick);
+        if (!baseline) return false;  // Baseline already evicted (or never received)
+    }
+    
+    uint32_t count = reader.read(SNAPSHOT_COUNT_BITS);
+    if (reader.failed() || count > (1u << SNAPSHOT_ID_BITS)) return false;
+    
+    players.clear();
+    size_t b = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        QuantizedPlayerState state;
+        state.id = static_cast<uint8_t>(reader.read(SNAPSHOT_ID_BITS));
+        if (!players.empty() && state.id <= players.back().id) return false;  // Must be strictly sorted
         
-        if (validateConnectivity(map)) {
-            float mapGenTime = mapGenClock.getElapsedTime().asMilliseconds();
-            
-            ErrorHandler::logInfo("Map generated successfully on attempt " + std::to_string(attempt + 1));
-            ErrorHandler::logInfo("Total walls: " + std::to_string(map.walls.size()));
-            
-            // Calculate actual coverage
-            float totalCoverage = 0.0f;
-            for (const auto& wall : map.walls) {
-                totalCoverage += wall.width * wall.height;
-            }
-            float coveragePercent = (totalCoverage / (500.0f * 500.0f)) * 100.0f;
-            
-            std::ostringstream oss;
-            oss << "Map coverage: " << coveragePercent << "%";
-            ErrorHandler::logInfo(oss.str());
-            
-            // Build quadtree for spatial partitioning
-            map.spatialIndex = buildQuadtree(map.walls, map.width, map.height);
-            
-            // Log map generation performance
-            std::cout << "\n=== MAP GENERATION PERFORMANCE ===" << std::endl;
-            std::cout << "Total Time: " << mapGenTime << "ms (target: <100ms)" << std::endl;
-            std::cout << "Attempts: " << (attempt + 1) << std::endl;
-            std::cout << "Walls Generated: " << map.walls.size() << std::endl;
-            std::cout << "Coverage: " << coveragePercent << "%" << std::endl;
-            
-            if (mapGenTime > 100.0f) {
-                std::cerr << "[WARNING] Map generation exceeded 100ms target!" << std::endl;
-            } else {
-                std::cout << "[SUCCESS] Map generation within target time" << std::endl;
-            }
-            std::cout << "===================================\n" << std::endl;
-            
-            return map;
+        const QuantizedPlayerState* base = nullptr;
+        if (baseline) {
+            while (b < baseline->size() && (*baseline)[b].id < state.id) b++;
+            if (b < baseline->size() && (*baseline)[b].id == state.id) base = &(*baseline)[b];
         }
         
-        ErrorHandler::logWarning("Map generation attempt " + std::to_string(attempt + 1) + " failed connectivity check");
+        if (base) {
+            state.x = readPositionDelta(reader, base->x);
+            state.y = readPositionDelta(reader, base->y);
+            state.rotation = reader.readBool() ? static_cast<uint16_t>(reader.read(SNAPSHOT_ROTATION_BITS)) : base->rotation;
+            state.health = reader.readBool() ? static_cast<uint8_t>(reader.read(SNAPSHOT_HEALTH_BITS)) : base->health;
+        } else {
+            state.x = static_cast<uint16_t>(reader.read(SNAPSHOT_POSITION_BITS));
+            state.y = static_cast<uint16_t>(reader.read(SNAPSHOT_POSITION_BITS));
+            state.rotation = static_cast<uint16_t>(reader.read(SNAPSHOT_ROTATION_BITS));
+            state.health = static_cast<uint8_t>(reader.read(SNAPSHOT_HEALTH_BITS));
+        }
+        state.isAlive = reader.readBool();
+        players.push_back(state);
     }
     
-    ErrorHandler::handleMapGenerationFailure();
-    throw std::runtime_error("Failed to generate valid map after 10 attempts");
+    return !reader.failed();
 }
 
 // ========================
-// Performance Monitoring System (moved here for use in collision detection)
+// Wire Protocol
 // ========================
 
-class PerformanceMonitor {
+// Every UDP datagram, in both directions, is a versioned header followed by
+// one or more length-prefixed messages:
+//
+//   header:       version:8, sequence:32
+//   per message:  type:8, length:16, payload[length]
+//
+// All integers are little-endian and every payload has an explicit byte layout
+// (see the *Message sections below), so struct padding and compiler ABI never
+// reach the wire and two messages of equal size can't be confused.
+// The sequence counts datagrams per sender and direction (loss detection).
+// Messages never span datagrams; a message that does not fit starts a new one.
+
+const uint8_t WIRE_VERSION = 5;                 // Version 4 input messages had no link report
+const size_t WIRE_HEADER_BYTES = 5;
+const size_t WIRE_MESSAGE_HEADER_BYTES = 3;
+const size_t MAX_DATAGRAM_BYTES = 1200;         // Stays below a typical 1500 byte MTU
+static_assert(MAX_SNAPSHOT_BYTES + WIRE_HEADER_BYTES + WIRE_MESSAGE_HEADER_BYTES <= MAX_DATAGRAM_BYTES,
+              "A full snapshot must fit in one datagram");
+
+enum class WireMessageType : uint8_t {
+    Input = 1,     // Client -> server: sequenced InputCommands and snapshot ack
+    Shot = 2,      // Both directions: ShotPacket
+    Hit = 3,          // Server -> client, reliable only: HitPacket
+    Snapshot = 4,     // Server -> client: writeSnapshot() payload
+    InputAck = 5,     // Server -> client: last simulated input and resulting position
+    Purchase = 6,     // Client -> server, reliable only: PurchasePacket
+    Inventory = 7,    // Server -> client, reliable only: InventoryPacket
+    Reliable = 8,     // Both directions: one of the above, sequenced (see ReliableChannel)
+    ReliableAck = 9   // Both directions: which Reliable messages arrived
+};
+const size_t WIRE_MESSAGE_TYPE_COUNT = 10;      // Type 0 is never valid
+
+// Little-endian field access; payloads are unaligned, so go through bytes
+inline void storeU16(uint8_t* p, uint16_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+}
+
+inline void storeU32(uint8_t* p, uint32_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+    p[2] = static_cast<uint8_t>(value >> 16);
+    p[3] = static_cast<uint8_t>(value >> 24);
+}
+
+inline void storeF32(uint8_t* p, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    storeU32(p, bits);
+}
+
+inline uint16_t loadU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t loadU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline float loadF32(const uint8_t* p) {
+    uint32_t bits = loadU32(p);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// ------------------------
+// Input Message
+// ------------------------
+// playerId:8, ackTick:32, ackDelay:16, lostDatagrams:16, firstSequence:32, count:8,
+// then count * (buttons:8, aim:16) with sequences firstSequence, firstSequence + 1, ...
+//
+// The client samples its controls INPUT_RATE times per second into sequenced
+// commands and sends the newest MAX_INPUT_COMMANDS with every datagram, so a lost
+// datagram is covered by the next one. The server simulates the movement itself
+// (see InputQueue) and never takes a position from the client.
+// ackDelay (ms the client held the ackTick snapshot before this send) and
+// lostDatagrams (running count of missing server sequence numbers, mod 65536)
+// are the client's link report: the server derives RTT and downstream loss from them.
+
+const float INPUT_RATE = 60.0f;                  // Commands per second (movement speeds are per 1/60 s)
+const float INPUT_STEP = 1.0f / INPUT_RATE;      // Simulated time per command
+const size_t MAX_INPUT_COMMANDS = 8;             // Newest commands repeated in every datagram
+const size_t INPUT_MESSAGE_HEADER_BYTES = 14;
+const size_t INPUT_COMMAND_BYTES = 3;
+const size_t MAX_INPUT_MESSAGE_BYTES = INPUT_MESSAGE_HEADER_BYTES + MAX_INPUT_COMMANDS * INPUT_COMMAND_BYTES;
+
+// Low nibble of InputCommand::buttons; the high nibble is the active weapon
+// (Weapon::Type + 1, 0 = no weapon), which decides the movement speed
+const uint16_t NO_ACK_DELAY = 0xFFFF;            // ackDelay before the first snapshot
+
+const uint8_t INPUT_UP = 0x01;
+const uint8_t INPUT_DOWN = 0x02;
+const uint8_t INPUT_LEFT = 0x04;
+const uint8_t INPUT_RIGHT = 0x08;
+
+// One sampled frame of client controls
+struct InputCommand {
+    uint32_t sequence = 0;  // Client input tick, +1 per command
+    uint8_t buttons = 0;    // INPUT_* bits | weapon code << 4
+    uint16_t aim = 0;       // Rotation, 1/65536 of a turn
+};
+
+// Client's view of the server -> client link, sent with every input message
+struct InputLinkReport {
+    uint16_t ackDelay = NO_ACK_DELAY;  // ms, see above
+    uint16_t lostDatagrams = 0;
+};
+
+inline uint8_t inputWeaponCode(uint8_t buttons) {
+    return static_cast<uint8_t>(buttons >> 4);
+}
+
+inline uint16_t quantizeAim(float degrees) {
+    float turns = degrees / 360.0f;
+    turns -= std::floor(turns);
+    return static_cast<uint16_t>(static_cast<uint32_t>(std::lround(turns * 65536.0f)) & 0xFFFF);
+}
+
+inline float dequantizeAim(uint16_t aim) {
+    return aim * (360.0f / 65536.0f);
+}
+
+// Write the input payload; count must be 1..MAX_INPUT_COMMANDS with consecutive sequences
+// Returns: payload length in bytes
+size_t writeInputMessage(uint8_t* out, uint8_t playerId, uint32_t ackTick, const InputLinkReport& link,
+                         const InputCommand* commands, size_t count) {
+    out[0] = playerId;
+    storeU32(out + 1, ackTick);
+    storeU16(out + 5, link.ackDelay);
+    storeU16(out + 7, link.lostDatagrams);
+    storeU32(out + 9, commands[0].sequence);
+    out[13] = static_cast<uint8_t>(count);
+    uint8_t* p = out + INPUT_MESSAGE_HEADER_BYTES;
+    for (size_t i = 0; i < count; ++i, p += INPUT_COMMAND_BYTES) {
+        p[0] = commands[i].buttons;
+        storeU16(p + 1, commands[i].aim);
+    }
+    return INPUT_MESSAGE_HEADER_BYTES + count * INPUT_COMMAND_BYTES;
+}
+
+// Reads a validated input payload in place (no copy)
+class InputMessageView {
 public:
-    PerformanceMonitor() : frameCount_(0), elapsedTime_(0.0f), currentFPS_(0.0f),
-                          totalCollisionTime_(0.0f), collisionSamples_(0),
-                          totalNetworkBytesSent_(0), totalNetworkBytesReceived_(0),
-                          networkSampleTime_(0.0f) {}
-    
-    // Update performance metrics each frame
-    void update(float deltaTime, size_t playerCount, size_t wallCount) {
-        frameCount_++;
-        elapsedTime_ += deltaTime;
-        networkSampleTime_ += deltaTime;
-        
-        // Calculate FPS every 1 second window
-        if (elapsedTime_ >= 1.0f) {
-            currentFPS_ = frameCount_ / elapsedTime_;
-            
-            // Calculate average collision detection time
-            float avgCollisionTime = (collisionSamples_ > 0) ? 
-                (totalCollisionTime_ / collisionSamples_) * 1000.0f : 0.0f; // Convert to ms
-            
-            // Calculate network bandwidth (bytes per second)
-            float networkBandwidthSent = totalNetworkBytesSent_ / networkSampleTime_;
-            float networkBandwidthReceived = totalNetworkBytesReceived_ / networkSampleTime_;
-            
-            // Log performance metrics
-            std::cout << "\n=== PERFORMANCE METRICS ===" << std::endl;
-            std::cout << "FPS: " << currentFPS_ << " (target: 55+)" << std::endl;
-            std::cout << "Frame Time: " << (elapsedTime_ / frameCount_) * 1000.0f << "ms" << std::endl;
-            std::cout << "Players: " << playerCount << std::endl;
-            std::cout << "Walls: " << wallCount << std::endl;
-            std::cout << "Avg Collision Detection: " << avgCollisionTime << "ms (target: <1ms)" << std::endl;
-            std::cout << "Network Bandwidth Sent: " << networkBandwidthSent << " bytes/sec" << std::endl;
-            std::cout << "Network Bandwidth Received: " << networkBandwidthReceived << " bytes/sec" << std::endl;
-            
-            // Calculate game thread load (more accurate than simple CPU usage)
-            float frameTime = (elapsedTime_ / frameCount_) * 1000.0f;
-            
-            // Game thread load: percentage of frame budget used
-            // At 60 FPS, we have 16.67ms per frame
-            // This shows how much of that budget we're using
-            float gameThreadLoad = (frameTime / 16.67f) * 100.0f;
-            
-            // Estimate actual CPU usage (more conservative)
-            // Assumes game uses ~40% CPU at full frame budget
-            float estimatedCPUUsage = (gameThreadLoad / 100.0f) * 40.0f;
-            
-            // Display both metrics for better understanding
-            std::cout << "Game Thread Load: " << gameThreadLoad << "% of frame budget" << std::endl;
-            std::cout << "Estimated CPU Usage: " << estimatedCPUUsage << "% (target: <40%)" << std::endl;
-            
-            // Add build type hint if performance is lower
-            if (gameThreadLoad > 100.0f) {
-                std::cout << "Note: Running Debug build? Release build typically 30-50% faster" << std::endl;
-            }
-            
-            std::cout << "==========================\n" << std::endl;
-            
-            // Log warning if FPS drops below 55
-            if (currentFPS_ < 55.0f) {
-                logPerformanceWarning(playerCount, wallCount, avgCollisionTime, gameThreadLoad);
-            }
-            
-            // Log warning if collision detection is too slow
-            if (avgCollisionTime > 1.0f) {
-                std::cerr << "[WARNING] Collision detection exceeds 1ms target: " 
-                         << avgCollisionTime << "ms" << std::endl;
-            }
-            
-            // Log warning if game thread load is too high (not CPU usage)
-            if (gameThreadLoad > 110.0f) {
-                std::cerr << "[WARNING] Game thread load exceeds frame budget: " 
-                         << gameThreadLoad << "%" << std::endl;
-                std::cerr << "  This means frames are taking longer than 16.67ms" << std::endl;
-                std::cerr << "  Consider optimizing or using Release build" << std::endl;
-            }
-            
-            // Reset counters for next window
-            frameCount_ = 0;
-            elapsedTime_ = 0.0f;
-            totalCollisionTime_ = 0.0f;
-            collisionSamples_ = 0;
-            totalNetworkBytesSent_ = 0;
-            totalNetworkBytesReceived_ = 0;
-            networkSampleTime_ = 0.0f;
-        }
-    }
+    InputMessageView(const uint8_t* payload, size_t length) : p_(payload), length_(length) {}
     
-    // Record collision detection time
-    void recordCollisionTime(float timeInSeconds) {
-        totalCollisionTime_ += timeInSeconds;
-        collisionSamples_++;
-    }
-    
-    // Record network traffic
-    void recordNetworkSent(size_t bytes) {
-        totalNetworkBytesSent_ += bytes;
-    }
+    uint8_t playerId() const { return p_[0]; }
+    uint32_t ackTick() const { return loadU32(p_ + 1); }
+    uint16_t ackDelay() const { return loadU16(p_ + 5); }
+    uint16_t lostDatagrams() const { return loadU16(p_ + 7); }
+    uint32_t firstSequence() const { return loadU32(p_ + 9); }
     
-    void recordNetworkReceived(size_t bytes) {
-        totalNetworkBytesReceived_ += bytes;
+    // Commands actually present (the count field is checked against the length)
+    size_t count() const {
+        return std::min<size_t>(p_[13], (length_ - INPUT_MESSAGE_HEADER_BYTES) / INPUT_COMMAND_BYTES);
     }
     
-    // Get current FPS
-    float getCurrentFPS() const {
-        return currentFPS_;
+    InputCommand command(size_t index) const {
+        const uint8_t* p = p_ + INPUT_MESSAGE_HEADER_BYTES + index * INPUT_COMMAND_BYTES;
+        InputCommand command;
+        command.sequence = firstSequence() + static_cast<uint32_t>(index);
+        command.buttons = p[0];
+        command.aim = loadU16(p + 1);
+        return command;
     }
     
 private:
-    void logPerformanceWarning(size_t playerCount, size_t wallCount, float avgCollisionTime, float gameThreadLoad) {
-        std::cerr << "[WARNING] Performance degradation detected!" << std::endl;
-        std::cerr << "  FPS: " << currentFPS_ << " (target: 55+)" << std::endl;
-        std::cerr << "  Players: " << playerCount << std::endl;
-        std::cerr << "  Walls: " << wallCount << std::endl;
-        std::cerr << "  Avg Collision Time: " << avgCollisionTime << "ms (target: <1ms)" << std::endl;
-        
-        float frameTime = (elapsedTime_ / frameCount_) * 1000.0f;
-        std::cerr << "  Avg Frame Time: " << frameTime << "ms (target: 16.67ms)" << std::endl;
-        std::cerr << "  Game Thread Load: " << gameThreadLoad << "% of frame budget" << std::endl;
-        
-        // Provide helpful suggestions
-        if (gameThreadLoad > 100.0f) {
-            std::cerr << "  Suggestion: Try Release build for better performance" << std::endl;
-        }
-        if (avgCollisionTime > 0.5f) {
-            std::cerr << "  Suggestion: Check Quadtree optimization" << std::endl;
-        }
-    }
+    const uint8_t* p_;
+    size_t length_;
+};
+
+// ------------------------
+// Shot Message
+// ------------------------
+// playerId:8, x:f32, y:f32, dirX:f32, dirY:f32, weaponType:8,
+// bulletSpeed:f32, damage:f32, range:f32, viewTick:32
+
+const size_t SHOT_MESSAGE_BYTES = 34;
+
+void writeShotMessage(uint8_t* out, const ShotPacket& packet) {
+    out[0] = packet.playerId;
+    storeF32(out + 1, packet.x);
+    storeF32(out + 5, packet.y);
+    storeF32(out + 9, packet.dirX);
+    storeF32(out + 13, packet.dirY);
+    out[17] = packet.weaponType;
+    storeF32(out + 18, packet.bulletSpeed);
+    storeF32(out + 22, packet.damage);
+    storeF32(out + 26, packet.range);
+    storeU32(out + 30, packet.viewTick);
+}
+
+// Reads a validated shot payload in place (no copy)
+class ShotMessageView {
+public:
+    explicit ShotMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint8_t playerId() const { return p_[0]; }
+    float x() const { return loadF32(p_ + 1); }
+    float y() const { return loadF32(p_ + 5); }
+    float dirX() const { return loadF32(p_ + 9); }
+    float dirY() const { return loadF32(p_ + 13); }
+    uint8_t weaponType() const { return p_[17]; }
+    float bulletSpeed() const { return loadF32(p_ + 18); }
+    float damage() const { return loadF32(p_ + 22); }
+    float range() const { return loadF32(p_ + 26); }
+    uint32_t viewTick() const { return loadU32(p_ + 30); }
     
-    int frameCount_;
-    float elapsedTime_;
-    float currentFPS_;
-    float totalCollisionTime_;
-    int collisionSamples_;
-    size_t totalNetworkBytesSent_;
-    size_t totalNetworkBytesReceived_;
-    float networkSampleTime_;
+private:
+    const uint8_t* p_;
 };
 
-// ========================
-// Collision Detection System
-// ========================
-//
-// CIRCLE-RECTANGLE COLLISION ALGORITHM:
-// Players are represented as circles (radius 30 units), walls as rectangles.
-// This algorithm efficiently detects if a circle intersects with a rectangle.
-//
-// How it works:
-// 1. Find the closest point on the rectangle to the circle's center
-//    - Clamp circle center X to rectangle's X range [wall.x, wall.x + width]
-//    - Clamp circle center Y to rectangle's Y range [wall.y, wall.y + height]
-// 2. Calculate distance from circle center to this closest point
-// 3. If distance < radius, there's a collision
+// ------------------------
+// Hit Message
+// ------------------------
+// shooterId:8, victimId:8, damage:f32, hitX:f32, hitY:f32, wasKill:8
+
+const size_t HIT_MESSAGE_BYTES = 15;
+
+void writeHitMessage(uint8_t* out, const HitPacket& packet) {
+    out[0] = packet.shooterId;
+    out[1] = packet.victimId;
+    storeF32(out + 2, packet.damage);
+    storeF32(out + 6, packet.hitX);
+    storeF32(out + 10, packet.hitY);
+    out[14] = packet.wasKill ? 1 : 0;
+}
+
+// Reads a validated hit payload in place (no copy)
+class HitMessageView {
+public:
+    explicit HitMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint8_t shooterId() const { return p_[0]; }
+    uint8_t victimId() const { return p_[1]; }
+    float damage() const { return loadF32(p_ + 2); }
+    float hitX() const { return loadF32(p_ + 6); }
+    float hitY() const { return loadF32(p_ + 10); }
+    bool wasKill() const { return p_[14] != 0; }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Input Ack Message
+// ------------------------
+// sequence:32, x:f32, y:f32
 //
-// Why this works:
-// - If circle center is inside rectangle, closest point = center (distance = 0)
-// - If circle center is outside, closest point is on rectangle edge or corner
-// - This handles all cases: side collisions, corner collisions, and containment
+// Sent to each client with its snapshot: the last input command the server
+// simulated for that client and the exact position it ended at. The client
+// rewinds its prediction to it and replays the newer commands (see InputPredictor).
+
+const size_t INPUT_ACK_MESSAGE_BYTES = 12;
+
+void writeInputAckMessage(uint8_t* out, uint32_t sequence, float x, float y) {
+    storeU32(out, sequence);
+    storeF32(out + 4, x);
+    storeF32(out + 8, y);
+}
+
+// Reads a validated input ack payload in place (no copy)
+class InputAckMessageView {
+public:
+    explicit InputAckMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint32_t sequence() const { return loadU32(p_); }
+    float x() const { return loadF32(p_ + 4); }
+    float y() const { return loadF32(p_ + 8); }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Purchase Message
+// ------------------------
+// playerId:8, weaponType:8, ammoType:8
 //
-// Performance: O(1) - constant time, very fast
+// One shop purchase (client -> server, reliable). Exactly one of weaponType and
+// ammoType names an item; the other is PURCHASE_NONE.
+
+const size_t PURCHASE_MESSAGE_BYTES = 3;
+const uint8_t PURCHASE_NONE = 255;
+
+void writePurchaseMessage(uint8_t* out, const PurchasePacket& packet) {
+    out[0] = packet.playerId;
+    out[1] = packet.weaponType;
+    out[2] = packet.ammoType;
+}
+
+// Reads a validated purchase payload in place (no copy)
+class PurchaseMessageView {
+public:
+    explicit PurchaseMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint8_t playerId() const { return p_[0]; }
+    uint8_t weaponType() const { return p_[1]; }
+    uint8_t ammoType() const { return p_[2]; }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Inventory Message
+// ------------------------
+// playerId:8, slot:8, weaponType:8, accepted:8, newMoneyBalance:32
 //
+// The server's answer to one purchase (server -> buyer, reliable, same order as
+// the purchases). slot and weaponType are PURCHASE_NONE unless a weapon was added.
 
-// Check if a circle collides with a rectangle
-bool circleRectCollision(sf::Vector2f center, float radius, const Wall& wall) {
-    // Find the closest point on the rectangle to the circle center
-    // std::max/min clamps the value to the rectangle's bounds
-    float closestX = std::max(wall.x, std::min(center.x, wall.x + wall.width));
-    float closestY = std::max(wall.y, std::min(center.y, wall.y + wall.height));
+const size_t INVENTORY_MESSAGE_BYTES = 8;
+
+void writeInventoryMessage(uint8_t* out, const InventoryPacket& packet) {
+    out[0] = packet.playerId;
+    out[1] = packet.slot;
+    out[2] = packet.weaponType;
+    out[3] = packet.accepted ? 1 : 0;
+    storeU32(out + 4, static_cast<uint32_t>(packet.newMoneyBalance));
+}
+
+// Reads a validated inventory payload in place (no copy)
+class InventoryMessageView {
+public:
+    explicit InventoryMessageView(const uint8_t* payload) : p_(payload) {}
     
-    // Calculate squared distance from circle center to closest point
-    float dx = center.x - closestX;
-    float dy = center.y - closestY;
+    uint8_t playerId() const { return p_[0]; }
+    uint8_t slot() const { return p_[1]; }
+    uint8_t weaponType() const { return p_[2]; }
+    bool accepted() const { return p_[3] != 0; }
+    int newMoneyBalance() const { return static_cast<int32_t>(loadU32(p_ + 4)); }
     
-    // Compare squared distances to avoid expensive sqrt() operation
-    return (dx * dx + dy * dy) < (radius * radius);
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Reliable Message
+// ------------------------
+// id:16, type:8, then the payload of the wrapped message
+//
+// Purchases, inventory updates and hits must arrive exactly once and in order.
+// Instead of a second (TCP) connection, which would stall behind every lost
+// segment, they are wrapped in Reliable messages and ride on the same datagrams
+// as snapshots and inputs; ReliableChannel numbers, acknowledges, resends and
+// reorders them, and nothing unreliable ever waits for them.
+
+const size_t RELIABLE_MESSAGE_HEADER_BYTES = 3;
+const size_t MAX_RELIABLE_BODY_BYTES = 32;
+
+void writeReliableMessage(uint8_t* out, uint16_t id, uint8_t type, const uint8_t* body, size_t length) {
+    storeU16(out, id);
+    out[2] = type;
+    std::memcpy(out + RELIABLE_MESSAGE_HEADER_BYTES, body, length);
 }
 
-// Resolve collision and return corrected position
-sf::Vector2f resolveCollision(sf::Vector2f oldPos, sf::Vector2f newPos, float radius, const GameMap& map, PerformanceMonitor* perfMonitor = nullptr) {
-    sf::Clock collisionClock;
+// Reads a validated reliable payload in place (no copy)
+class ReliableMessageView {
+public:
+    ReliableMessageView(const uint8_t* payload, size_t length) : p_(payload), length_(length) {}
     
-    // Query nearby walls using quadtree
-    sf::FloatRect queryArea(
-        newPos.x - radius - 1.0f,
-        newPos.y - radius - 1.0f,
-        radius * 2 + 2.0f,
-        radius * 2 + 2.0f
-    );
+    uint16_t id() const { return loadU16(p_); }
+    uint8_t type() const { return p_[2]; }
+    const uint8_t* body() const { return p_ + RELIABLE_MESSAGE_HEADER_BYTES; }
+    size_t bodyLength() const { return length_ - RELIABLE_MESSAGE_HEADER_BYTES; }
     
-    sf::Vector2f result = newPos;
+private:
+    const uint8_t* p_;
+    size_t length_;
+};
+
+// ------------------------
+// Reliable Ack Message
+// ------------------------
+// nextExpected:16, received:32
+//
+// nextExpected is the first reliable id not received yet (all older ones arrived);
+// bit i of received is set when id nextExpected + 1 + i is already buffered.
+
+const size_t RELIABLE_ACK_MESSAGE_BYTES = 6;
+
+void writeReliableAckMessage(uint8_t* out, uint16_t nextExpected, uint32_t received) {
+    storeU16(out, nextExpected);
+    storeU32(out + 2, received);
+}
+
+// Reads a validated reliable ack payload in place (no copy)
+class ReliableAckMessageView {
+public:
+    explicit ReliableAckMessageView(const uint8_t* payload) : p_(payload) {}
     
-    if (map.spatialIndex) {
-        auto nearbyWalls = map.spatialIndex->query(queryArea);
-        
-        for (const Wall* wall : nearbyWalls) {
-            if (circleRectCollision(newPos, radius, *wall)) {
-                // Calculate penetration depth and push back
-                float closestX = std::max(wall->x, std::min(newPos.x, wall->x + wall->width));
-                float closestY = std::max(wall->y, std::min(newPos.y, wall->y + wall->height));
-                
-                float dx = newPos.x - closestX;
-                float dy = newPos.y - closestY;
-                float distance = std::sqrt(dx * dx + dy * dy);
-                
-                if (distance < 0.001f) {
-                    // Player is exactly on the wall edge, use old position
-                    result = oldPos;
-                    break;
-                }
-                
-                // Calculate how much to push back (radius - distance)
-                float penetration = radius - distance;
-                float pushX = (dx / distance) * penetration;
-                float pushY = (dy / distance) * penetration;
-                
-                result = sf::Vector2f(newPos.x + pushX, newPos.y + pushY);
-                break;
-            }
+    uint16_t nextExpected() const { return loadU16(p_); }
+    uint32_t received() const { return loadU32(p_ + 2); }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Decoding
+// ------------------------
+
+// Allowed payload length per message type, indexed by WireMessageType
+struct WireMessageSpec {
+    const char* name;
+    size_t minLength;
+    size_t maxLength;
+};
+
+const WireMessageSpec WIRE_MESSAGE_SPECS[WIRE_MESSAGE_TYPE_COUNT] = {
+    { "invalid", 1, 0 },  // Empty range: never accepted
+    { "input", INPUT_MESSAGE_HEADER_BYTES + INPUT_COMMAND_BYTES, MAX_INPUT_MESSAGE_BYTES },
+    { "shot", SHOT_MESSAGE_BYTES, SHOT_MESSAGE_BYTES },
+    { "hit", HIT_MESSAGE_BYTES, HIT_MESSAGE_BYTES },
+    { "snapshot", 1, MAX_SNAPSHOT_BYTES },
+    { "input ack", INPUT_ACK_MESSAGE_BYTES, INPUT_ACK_MESSAGE_BYTES },
+    { "purchase", PURCHASE_MESSAGE_BYTES, PURCHASE_MESSAGE_BYTES },
+    { "inventory", INVENTORY_MESSAGE_BYTES, INVENTORY_MESSAGE_BYTES },
+    { "reliable", RELIABLE_MESSAGE_HEADER_BYTES, RELIABLE_MESSAGE_HEADER_BYTES + MAX_RELIABLE_BODY_BYTES },
+    { "reliable ack", RELIABLE_ACK_MESSAGE_BYTES, RELIABLE_ACK_MESSAGE_BYTES }
+};
+
+enum class WireStatus {
+    Ok,
+    Truncated,    // Header or message runs past the end of the datagram
+    BadVersion,   // Sender speaks another protocol version
+    UnknownType,  // Type not in the table or not accepted by this receiver
+    BadLength     // Payload length outside the type's allowed range
+};
+
+// Message handler: payload points into the receive buffer and has been bounds-checked
+template <typename Context>
+using WireHandler = void (*)(const uint8_t* payload, size_t length, Context& context);
+
+// Read the datagram header
+// Returns: Ok and the sequence, or why the datagram was rejected
+inline WireStatus readWireHeader(const uint8_t* data, size_t size, uint32_t& sequence) {
+    if (size < WIRE_HEADER_BYTES) {
+        return WireStatus::Truncated;
+    }
+    if (data[0] != WIRE_VERSION) {
+        return WireStatus::BadVersion;
+    }
+    sequence = loadU32(data + 1);
+    return WireStatus::Ok;
+}
+
+// Validate a whole datagram in place, then dispatch each message to handlers[type]
+// Parameters:
+//   data, size - The received datagram (never copied)
+//   handlers - Handler per WireMessageType; null rejects that type
+//   context - Passed through to the handlers
+//   sequence - Receives the datagram sequence number
+// Returns: Ok if every message was dispatched; otherwise nothing was dispatched
+//
+// PERFORMANCE:
+// Type lookup is an array index and each message is checked once against the
+// spec table, so decoding is O(1) per message with no allocation. Validating
+// the whole datagram before dispatching means a malformed tail can't leave a
+// half-applied datagram behind.
+template <typename Context>
+WireStatus decodeDatagram(const uint8_t* data, size_t size, const WireHandler<Context>* handlers,
+                          Context& context, uint32_t& sequence) {
+    WireStatus status = readWireHeader(data, size, sequence);
+    if (status != WireStatus::Ok) {
+        return status;
+    }
+    
+    // Pass 1: bounds and type checks
+    size_t pos = WIRE_HEADER_BYTES;
+    while (pos < size) {
+        if (size - pos < WIRE_MESSAGE_HEADER_BYTES) {
+            return WireStatus::Truncated;
+        }
+        uint8_t type = data[pos];
+        size_t length = loadU16(data + pos + 1);
+        if (type >= WIRE_MESSAGE_TYPE_COUNT || handlers[type] == nullptr) {
+            return WireStatus::UnknownType;
+        }
+        if (length < WIRE_MESSAGE_SPECS[type].minLength || length > WIRE_MESSAGE_SPECS[type].maxLength) {
+            return WireStatus::BadLength;
         }
+        pos += WIRE_MESSAGE_HEADER_BYTES;
+        if (size - pos < length) {
+            return WireStatus::Truncated;
+        }
+        pos += length;
     }
     
-    // Record collision detection time
-    if (perfMonitor) {
-        float collisionTime = collisionClock.getElapsedTime().asSeconds();
-        perfMonitor->recordCollisionTime(collisionTime);
+    // Pass 2: dispatch
+    pos = WIRE_HEADER_BYTES;
+    while (pos < size) {
+        uint8_t type = data[pos];
+        size_t length = loadU16(data + pos + 1);
+        pos += WIRE_MESSAGE_HEADER_BYTES;
+        handlers[type](data + pos, length, context);
+        pos += length;
     }
-    
-    return result;
+    return WireStatus::Ok;
 }
 
-// Clamp position to map boundaries [0, 500]
-sf::Vector2f clampToMapBounds(sf::Vector2f pos, float radius) {
-    pos.x = std::max(radius, std::min(500.0f - radius, pos.x));
-    pos.y = std::max(radius, std::min(500.0f - radius, pos.y));
-    return pos;
+// Validate and dispatch one message that did not come straight from decodeDatagram
+// (the payload of a Reliable message, delivered once it is in order)
+// Returns: Ok if the handler was called
+template <typename Context>
+WireStatus dispatchWireMessage(uint8_t type, const uint8_t* payload, size_t length,
+                               const WireHandler<Context>* handlers, Context& context) {
+    if (type >= WIRE_MESSAGE_TYPE_COUNT || handlers[type] == nullptr) {
+        return WireStatus::UnknownType;
+    }
+    if (length < WIRE_MESSAGE_SPECS[type].minLength || length > WIRE_MESSAGE_SPECS[type].maxLength) {
+        return WireStatus::BadLength;
+    }
+    handlers[type](payload, length, context);
+    return WireStatus::Ok;
 }
 
-// ========================
-// NEW: Dynamic Camera System
-// ========================
-
-// Update camera to follow player position
-// The camera keeps the player centered on screen while respecting map boundaries
-// Parameters:
-//   window - The render window to apply the view to
-//   playerPosition - Current position of the player in world coordinates
-//
-// ALGORITHM:
-// 1. Create a view with the same size as the window
-// 2. Set the view center to the player's position
-// 3. Clamp the camera to map boundaries to prevent showing areas outside the map
-// 4. Apply the view to the window
-//
-// BOUNDARY CLAMPING:
-// When the player is near the edge of the map, we need to prevent the camera
-// from showing areas outside the map (which would appear as black space).
-// We do this by clamping the camera center to stay within valid bounds:
-// - Minimum X: halfWidth (so left edge of view doesn't go below 0)
-// - Maximum X: MAP_SIZE - halfWidth (so right edge doesn't exceed MAP_SIZE)
-// - Same logic applies for Y axis
-//
-// This creates a smooth camera that follows the player everywhere except
-// at the map edges, where it stops to prevent showing out-of-bounds areas.
+inline const char* wireStatusName(WireStatus status) {
+    switch (status) {
+        case WireStatus::Ok: return "ok";
+        case WireStatus::Truncated: return "truncated";
+        case WireStatus::BadVersion: return "wrong protocol version";
+        case WireStatus::UnknownType: return "unexpected message type";
+        case WireStatus::BadLength: return "bad message length";
+    }
+    return "unknown";
+}
 
-// ========================
-// Rounded Rectangle Helper
-// ========================
+// ------------------------
+// Encoding
+// ------------------------
 
-// Create a rounded rectangle shape
-// Parameters:
-//   size - Size of the rectangle (width, height)
-//   radius - Radius of the rounded corners
-//   pointCount - Number of points per corner (higher = smoother, default = 8)
-// Returns: ConvexShape representing a rounded rectangle
-sf::ConvexShape createRoundedRectangle(sf::Vector2f size, float radius, unsigned int pointCount = 8) {
-    // Clamp radius to not exceed half of the smaller dimension
-    radius = std::min(radius, std::min(size.x, size.y) / 2.0f);
+// Builds the datagrams for one recipient
+// Completed datagrams are handed to the sink (data, size, message count);
+// call flush() once all messages have been appended.
+class DatagramBuilder {
+public:
+    using Sink = std::function<void(const uint8_t*, size_t, size_t)>;
     
-    // Total points: 4 corners * pointCount points per corner
-    sf::ConvexShape shape;
-    shape.setPointCount(pointCount * 4);
+    // firstSequence - Sequence number of the first datagram this builder sends
+    DatagramBuilder(Sink sink, uint32_t firstSequence)
+        : sink_(std::move(sink)), nextSequence_(firstSequence) {
+        buffer_[0] = WIRE_VERSION;
+    }
     
-    // Helper lambda to add corner points
-    auto addCorner = [&](unsigned int startIndex, sf::Vector2f center, float startAngle) {
-        for (unsigned int i = 0; i < pointCount; ++i) {
-            float angle = startAngle + (i * 90.0f / (pointCount - 1)) * 3.14159f / 180.0f;
-            float x = center.x + radius * std::cos(angle);
-            float y = center.y + radius * std::sin(angle);
-            shape.setPoint(startIndex + i, sf::Vector2f(x, y));
+    // Reserve room for one message, flushing the current datagram first if it would not fit
+    // Returns: where to write the payload (exactly length bytes), or null if the
+    // message is too large for any datagram
+    uint8_t* reserve(WireMessageType type, size_t length) {
+        const size_t needed = WIRE_MESSAGE_HEADER_BYTES + length;
+        if (WIRE_HEADER_BYTES + needed > MAX_DATAGRAM_BYTES) {
+            return nullptr;
         }
-    };
+        if (used_ + needed > MAX_DATAGRAM_BYTES) {
+            flush();
+        }
+        
+        buffer_[used_] = static_cast<uint8_t>(type);
+        storeU16(buffer_ + used_ + 1, static_cast<uint16_t>(length));
+        uint8_t* payload = buffer_ + used_ + WIRE_MESSAGE_HEADER_BYTES;
+        used_ += needed;
+        messageCount_++;
+        return payload;
+    }
+    
+    // Append a pre-encoded payload (e.g. a snapshot)
+    bool append(WireMessageType type, const uint8_t* payload, size_t length) {
+        uint8_t* out = reserve(type, length);
+        if (out == nullptr) {
+            return false;
+        }
+        std::memcpy(out, payload, length);
+        return true;
+    }
     
-    // Top-left corner (180° to 270°)
-    addCorner(0, sf::Vector2f(radius, radius), 180.0f);
+    // commands - Consecutive commands, oldest first (at most MAX_INPUT_COMMANDS are sent: the newest)
+    bool appendInput(uint8_t playerId, uint32_t ackTick, const InputLinkReport& link,
+                     const InputCommand* commands, size_t count) {
+        if (count == 0) {
+            return false;
+        }
+        if (count > MAX_INPUT_COMMANDS) {
+            commands += count - MAX_INPUT_COMMANDS;
+            count = MAX_INPUT_COMMANDS;
+        }
+        uint8_t* out = reserve(WireMessageType::Input, INPUT_MESSAGE_HEADER_BYTES + count * INPUT_COMMAND_BYTES);
+        if (out) writeInputMessage(out, playerId, ackTick, link, commands, count);
+        return out != nullptr;
+    }
     
-    // Top-right corner (270° to 360°)
-    addCorner(pointCount, sf::Vector2f(size.x - radius, radius), 270.0f);
+    bool appendShot(const ShotPacket& packet) {
+        uint8_t* out = reserve(WireMessageType::Shot, SHOT_MESSAGE_BYTES);
+        if (out) writeShotMessage(out, packet);
+        return out != nullptr;
+    }
     
-    // Bottom-right corner (0° to 90°)
-    addCorner(pointCount * 2, sf::Vector2f(size.x - radius, size.y - radius), 0.0f);
+    bool appendHit(const HitPacket& packet) {
+        uint8_t* out = reserve(WireMessageType::Hit, HIT_MESSAGE_BYTES);
+        if (out) writeHitMessage(out, packet);
+        return out != nullptr;
+    }
     
-    // Bottom-left corner (90° to 180°)
-    addCorner(pointCount * 3, sf::Vector2f(radius, size.y - radius), 90.0f);
+    bool appendInputAck(uint32_t sequence, float x, float y) {
+        uint8_t* out = reserve(WireMessageType::InputAck, INPUT_ACK_MESSAGE_BYTES);
+        if (out) writeInputAckMessage(out, sequence, x, y);
+        return out != nullptr;
+    }
     
-    return shape;
-}
-
-void updateCamera(sf::RenderWindow& window, sf::Vector2f playerPosition) {
-    // Create a view with the window's dimensions
-    sf::View view;
-    view.setSize(static_cast<float>(window.getSize().x), static_cast<float>(window.getSize().y));
+    // Hand the pending datagram to the sink (no-op when nothing is pending)
+    void flush() {
+        if (messageCount_ == 0) {
+            return;
+        }
+        storeU32(buffer_ + 1, nextSequence_++);
+        sink_(buffer_, used_, messageCount_);
+        datagramsSent_++;
+        used_ = WIRE_HEADER_BYTES;
+        messageCount_ = 0;
+    }
     
-    // Calculate half dimensions for boundary clamping
-    float halfWidth = window.getSize().x / 2.0f;
-    float halfHeight = window.getSize().y / 2.0f;
+    size_t datagramsSent() const { return datagramsSent_; }
     
-    // Start with player position as center
-    sf::Vector2f center = playerPosition;
+    // Sequence number the next datagram will carry
+    uint32_t nextSequence() const { return nextSequence_; }
     
-    // Clamp camera center to map boundaries
-    // This prevents the camera from showing areas outside the map
-    center.x = std::max(halfWidth, std::min(center.x, MAP_SIZE - halfWidth));
-    center.y = std::max(halfHeight, std::min(center.y, MAP_SIZE - halfHeight));
+private:
+    Sink sink_;
+    uint8_t buffer_[MAX_DATAGRAM_BYTES];
+    size_t used_ = WIRE_HEADER_BYTES;
+    size_t messageCount_ = 0;
+    size_t datagramsSent_ = 0;
+    uint32_t nextSequence_;
+};
+
+// ------------------------
+// Link Statistics
+// ------------------------
+
+// Smoothed round-trip time and its mean deviation (RFC 6298)
+// The deviation is the RTT jitter: how far single samples stray from the mean
+class RttEstimator {
+public:
+    void sample(float rtt) {
+        if (!hasSample_) {
+            smoothed_ = rtt;
+            variance_ = rtt * 0.5f;
+            hasSample_ = true;
+            return;
+        }
+        variance_ = 0.75f * variance_ + 0.25f * std::fabs(smoothed_ - rtt);
+        smoothed_ = 0.875f * smoothed_ + 0.125f * rtt;
+    }
     
-    // Set the clamped center
-    view.setCenter(center);
+    bool hasSample() const { return hasSample_; }
+    float smoothed() const { return smoothed_; }
+    float variance() const { return variance_; }
     
-    // Apply the view to the window
-    // All subsequent draw calls will use this view's coordinate system
-    window.setView(view);
-}
+private:
+    bool hasSample_ = false;
+    float smoothed_ = 0.0f;
+    float variance_ = 0.0f;
+};
 
-// ========================
-// NEW: Optimized Rendering System
-// ========================
-
-// Render only visible walls within camera's viewport
-// Uses camera-based visibility culling for accurate rendering
-// Parameters:
-//   window - The render window to draw walls to
-//   playerPosition - Current position of the player in world coordinates (unused but kept for compatibility)
-//   grid - The cell grid containing wall information
+// Loss and reordering of one incoming datagram stream, from its wire sequence numbers
 //
 // ALGORITHM:
-// 1. Get current camera view to determine visible area
-// 2. Calculate visible world bounds with padding
-// 3. Convert to cell coordinates
-// 4. Render walls only in the visible range
-// 5. Center walls on cell boundaries (position - WALL_WIDTH/2)
-//
-// CAMERA-BASED CULLING:
-// Instead of rendering based on player position, we render based on what the
-// camera can actually see. This fixes the issue where walls disappear when
-// the player is near map edges (camera stops but player position continues).
-//
-// ========================
-// NEW: Fog of War Background Rendering
-// ========================
-
-// ========================
-// Purchase Status System
-// ========================
-
-// Enum for purchase status
-// Requirement 3.5: Show purchase status
-enum class PurchaseStatus {
-    Purchasable,
-    InsufficientFunds,
-    InventoryFull
-};
-
-// Calculate purchase status for a player and weapon
-// Requirement 3.5: Purchase status calculation
-PurchaseStatus calculatePurchaseStatus(const Player& player, const Weapon* weapon) {
-    // Check if inventory is full
-    if (!player.hasInventorySpace()) {
-        return PurchaseStatus::InventoryFull;
+// A jump past the newest sequence counts the skipped ones as lost; a bit mask of
+// the last 64 sequences remembers which arrived, so a late datagram inside that
+// window is taken back from the loss count (out of order) and a repeated one is
+// a duplicate. Datagrams older than the window stay counted as lost - for a
+// real-time stream they are. Sequences before the first one received were never
+// counted as lost, so a late one only arrives out of order.
+class SequenceTracker {
+public:
+    // Take the sequence of one received datagram
+    // Returns: true if it is the newest so far
+    bool onDatagram(uint32_t sequence) {
+        if (!started_) {
+            started_ = true;
+            first_ = sequence;
+            newest_ = sequence;
+            seen_ = 1;
+            received_++;
+            return true;
+        }
+        if (sequence > newest_) {
+            const uint32_t skipped = sequence - newest_ - 1;
+            lost_ += skipped;
+            seen_ = (skipped >= 63) ? 1 : (seen_ << (skipped + 1)) | 1;
+            newest_ = sequence;
+            received_++;
+            return true;
+        }
+        
+        const uint32_t age = newest_ - sequence;
+        if (age < 64 && ((seen_ >> age) & 1)) {
+            duplicates_++;
+            return false;
+        }
+        if (age < 64) {
+            seen_ |= uint64_t(1) << age;
+            if (sequence > first_) {
+                lost_--;
+            }
+        }
+        outOfOrder_++;
+        received_++;
+        return false;
     }
     
-    // Check if player has sufficient funds
-    if (player.money < weapon->price) {
-        return PurchaseStatus::InsufficientFunds;
-    }
+    uint64_t received() const { return received_; }      // Distinct datagrams
+    uint64_t lost() const { return lost_; }              // Missing sequence numbers
+    uint64_t outOfOrder() const { return outOfOrder_; }  // Arrived after a newer one
+    uint64_t duplicates() const { return duplicates_; }
     
-    // Player can purchase
-    return PurchaseStatus::Purchasable;
-}
+private:
+    bool started_ = false;
+    uint32_t first_ = 0;   // Gaps are only counted after this one
+    uint32_t newest_ = 0;
+    uint64_t seen_ = 0;  // Bit i: newest_ - i arrived
+    uint64_t received_ = 0;
+    uint64_t lost_ = 0;
+    uint64_t outOfOrder_ = 0;
+    uint64_t duplicates_ = 0;
+};
 
-// Get purchase status text
-std::string getPurchaseStatusText(PurchaseStatus status, int weaponPrice) {
-    switch (status) {
-        case PurchaseStatus::Purchasable:
-            return "Can purchase";
-        case PurchaseStatus::InsufficientFunds:
-            return "Insufficient funds. Required: $" + std::to_string(weaponPrice);
-        case PurchaseStatus::InventoryFull:
-            return "Inventory full. Free a slot to purchase.";
-        default:
-            return "";
-    }
-}
+// ------------------------
+// Reliable Channel
+// ------------------------
 
-// Get purchase status color
-sf::Color getPurchaseStatusColor(PurchaseStatus status) {
-    switch (status) {
-        case PurchaseStatus::Purchasable:
-            return sf::Color::Green;
-        case PurchaseStatus::InsufficientFunds:
-            return sf::Color::Red;
-        case PurchaseStatus::InventoryFull:
-            return sf::Color::Yellow;
-        default:
-            return sf::Color::White;
+// Reliable, ordered message stream to one peer, carried on the unreliable datagrams
+//
+// ALGORITHM:
+// Sending: every message gets the next 16-bit id and stays queued until the peer
+// acknowledges it. write() appends the pending ack plus every message that was
+// never sent or whose resend timeout expired. Only WINDOW ids past the oldest
+// unacknowledged one are in flight, so everything the peer can have buffered
+// fits in the 32-bit ack mask. The timeout is smoothed RTT + 4 x RTT variance
+// (RFC 6298), sampled only from messages acknowledged after their first send
+// (Karn). A message that needs a second resend doubles it until the next
+// sample, so a sudden RTT rise can't cause endless spurious resends, while
+// single losses on a link that keeps answering are resent one timeout apart.
+// Receiving: messages ahead of the next expected id wait in WINDOW slots until
+// the gap is filled, then deliver() releases them in id order. Duplicates are
+// dropped but re-arm the ack, so a lost ack is repeated by the next datagram.
+//
+// PERFORMANCE:
+// Fixed rings indexed by id (both sizes divide 65536, so wraparound is free), no
+// allocation. The ack costs 9 bytes and only goes out after something arrived;
+// a lost message delays only the reliable messages behind it, never snapshots
+// or inputs.
+class ReliableChannel {
+public:
+    static const uint16_t WINDOW = 32;              // Ids in flight / buffered ahead of the gap
+    static const uint16_t QUEUE_CAPACITY = 128;     // Queued outgoing messages (in flight + waiting)
+    static constexpr float INITIAL_TIMEOUT = 0.2f;  // Resend timeout before the first RTT sample
+    static constexpr float MIN_TIMEOUT = 0.05f;     // Below this the peer's ack delay causes spurious resends
+    static constexpr float MAX_TIMEOUT = 1.0f;      // Cap for the backed-off timeout
+    static const int MAX_BACKOFF = 5;               // Doublings without an RTT sample
+    
+    // Queue a message for reliable delivery
+    // Returns: false if the body is too large or the queue is full (peer not acknowledging)
+    bool send(WireMessageType type, const uint8_t* body, size_t length) {
+        if (length > MAX_RELIABLE_BODY_BYTES || queued() == QUEUE_CAPACITY) {
+            return false;
+        }
+        Outgoing& message = outgoing_[nextSendId_ % QUEUE_CAPACITY];
+        message.type = static_cast<uint8_t>(type);
+        message.length = static_cast<uint8_t>(length);
+        std::memcpy(message.body, body, length);
+        message.sends = 0;
+        message.acked = false;
+        nextSendId_++;
+        return true;
     }
-}
-
-// ========================
-// Purchase Validation and Transaction Logic
-// ========================
-
-// Process weapon purchase request from client
-// Requirements: 4.1, 4.2, 4.3, 4.4, 4.5
-// Returns: true if purchase successful, false otherwise
-bool processPurchase(Player& player, Weapon::Type weaponType) {
-    // Create weapon to get price
-    Weapon* weapon = Weapon::create(weaponType);
     
-    // Requirement 4.1: Validate player has sufficient money
-    if (player.money < weapon->price) {
-        std::cout << "[PURCHASE] Player " << player.id << " has insufficient funds: " 
-                  << player.money << " < " << weapon->price << std::endl;
-        delete weapon;
+    // Returns: true if write() would append anything at this time
+    bool wantsToSend(float now) const {
+        if (ackPending_) {
+            return true;
+        }
+        const uint16_t end = inFlightEnd();
+        for (uint16_t id = oldestUnacked_; id != end; ++id) {
+            const Outgoing& message = outgoing_[id % QUEUE_CAPACITY];
+            if (!message.acked && (message.sends == 0 || now - message.sentAt >= resendTimeout())) {
+                return true;
+            }
+        }
         return false;
     }
     
-    // Requirement 4.2: Validate player has empty inventory slot
-    if (!player.hasInventorySpace()) {
-        std::cout << "[PURCHASE] Player " << player.id << " has full inventory" << std::endl;
-        delete weapon;
-        return false;
+    // Append the pending ack and every message due for (re)sending
+    void write(DatagramBuilder& builder, float now) {
+        if (ackPending_) {
+            uint8_t* out = builder.reserve(WireMessageType::ReliableAck, RELIABLE_ACK_MESSAGE_BYTES);
+            if (out) {
+                writeReliableAckMessage(out, nextReceiveId_, receivedMask());
+                ackPending_ = false;
+            }
+        }
+        
+        const uint16_t end = inFlightEnd();
+        const float timeout = resendTimeout();
+        bool resentAgain = false;
+        for (uint16_t id = oldestUnacked_; id != end; ++id) {
+            Outgoing& message = outgoing_[id % QUEUE_CAPACITY];
+            if (message.acked || (message.sends > 0 && now - message.sentAt < timeout)) {
+                continue;
+            }
+            uint8_t* out = builder.reserve(WireMessageType::Reliable, RELIABLE_MESSAGE_HEADER_BYTES + message.length);
+            if (!out) {
+                continue;
+            }
+            writeReliableMessage(out, id, message.type, message.body, message.length);
+            if (message.sends > 0) {
+                resends_++;
+                resentAgain = resentAgain || message.sends > 1;
+            }
+            if (message.sends < 255) {
+                message.sends++;
+            }
+            message.sentAt = now;
+        }
+        if (resentAgain && backoff_ < MAX_BACKOFF) {
+            backoff_++;
+        }
     }
     
-    // Get first empty slot
-    int emptySlot = player.getFirstEmptySlot();
-    if (emptySlot < 0) {
-        // This shouldn't happen if hasInventorySpace() returned true, but check anyway
-        std::cerr << "[ERROR] hasInventorySpace() returned true but getFirstEmptySlot() returned -1" << std::endl;
-        delete weapon;
-        return false;
+    // Take the peer's ack (see the Reliable Ack Message layout)
+    void onAck(uint16_t nextExpected, uint32_t received, float now) {
+        // An ack for ids we never sent is stale or forged
+        if (before(nextSendId_, nextExpected)) {
+            return;
+        }
+        
+        const uint16_t end = inFlightEnd();
+        for (uint16_t id = oldestUnacked_; id != end; ++id) {
+            Outgoing& message = outgoing_[id % QUEUE_CAPACITY];
+            if (message.acked || message.sends == 0) {
+                continue;
+            }
+            const uint16_t bit = static_cast<uint16_t>(id - nextExpected - 1);
+            if (!before(id, nextExpected) && !(bit < 32 && ((received >> bit) & 1))) {
+                continue;
+            }
+            message.acked = true;
+            // A resent message's ack may answer any of its copies: no sample
+            if (message.sends == 1) {
+                sampleRtt(now - message.sentAt);
+            }
+        }
+        
+        while (oldestUnacked_ != nextSendId_ && outgoing_[oldestUnacked_ % QUEUE_CAPACITY].acked) {
+            oldestUnacked_++;
+        }
     }
     
-    // Requirement 4.3: Deduct weapon price from player money
-    player.money -= weapon->price;
+    // Take one received message; call deliver() afterwards
+    // Returns: false for a duplicate or an id outside the receive window
+    bool receive(uint16_t id, uint8_t type, const uint8_t* body, size_t length) {
+        ackPending_ = true;
+        if (before(id, nextReceiveId_) || static_cast<uint16_t>(id - nextReceiveId_) >= WINDOW ||
+            length > MAX_RELIABLE_BODY_BYTES) {
+            duplicates_++;
+            return false;
+        }
+        Incoming& slot = incoming_[id % WINDOW];
+        if (slot.present) {
+            duplicates_++;
+            return false;
+        }
+        slot.present = true;
+        slot.type = type;
+        slot.length = static_cast<uint8_t>(length);
+        std::memcpy(slot.body, body, length);
+        return true;
+    }
     
-    // Requirement 4.4: Add weapon to first empty inventory slot
-    player.inventory[emptySlot] = weapon;
+    // Hand every message that is now in order to fn(type, body, length), oldest first
+    // fn may send() on this channel
+    template <typename Fn>
+    void deliver(Fn&& fn) {
+        while (incoming_[nextReceiveId_ % WINDOW].present) {
+            Incoming& slot = incoming_[nextReceiveId_ % WINDOW];
+            slot.present = false;
+            nextReceiveId_++;
+            fn(slot.type, static_cast<const uint8_t*>(slot.body), static_cast<size_t>(slot.length));
+        }
+    }
     
-    // Requirement 4.5: Weapon is already initialized with full magazine and reserve ammo
-    // (This is done in Weapon::create())
+    // Resend timeout from the RTT estimate, before backoff
+    float timeout() const {
+        if (!rtt_.hasSample()) {
+            return INITIAL_TIMEOUT;
+        }
+        return std::min(MAX_TIMEOUT, std::max(MIN_TIMEOUT, rtt_.smoothed() + 4.0f * rtt_.variance()));
+    }
     
-    std::cout << "[PURCHASE] Player " << player.id << " purchased " << weapon->name 
-              << " for $" << weapon->price << " in slot " << emptySlot 
-              << ". New balance: $" << player.money << std::endl;
+    bool hasRttSample() const { return rtt_.hasSample(); }
+    float smoothedRtt() const { return rtt_.smoothed(); }
+    float rttVariance() const { return rtt_.variance(); }
+    size_t resends() const { return resends_; }
+    size_t duplicates() const { return duplicates_; }
     
-    return true;
-}
-
-// Process ammo purchase request
-// Returns: true if purchase successful, false otherwise
-bool processAmmoPurchase(Player& player, AmmoType ammoType) {
-    // Create ammo item to get price and quantity
-    AmmoItem* ammo = AmmoItem::create(ammoType);
+    // Messages sent or waiting to be sent that the peer has not acknowledged
+    uint16_t queued() const { return static_cast<uint16_t>(nextSendId_ - oldestUnacked_); }
     
-    // Validate player has sufficient money
-    if (player.money < ammo->price) {
-        std::cout << "[AMMO PURCHASE] Player " << player.id << " has insufficient funds: " 
-                  << player.money << " < " << ammo->price << std::endl;
-        delete ammo;
-        return false;
-    }
+private:
+    struct Outgoing {
+        uint8_t type = 0;
+        uint8_t length = 0;
+        uint8_t sends = 0;     // 0 = never sent
+        bool acked = false;
+        float sentAt = 0.0f;   // Time of the latest send
+        uint8_t body[MAX_RELIABLE_BODY_BYTES];
+    };
     
-    // Find weapons that use this ammo type
-    bool hasCompatibleWeapon = false;
-    for (int i = 0; i < 4; i++) {
-        if (player.inventory[i] != nullptr) {
-            if (player.inventory[i]->getAmmoType() == ammoType) {
-                hasCompatibleWeapon = true;
-                break;
-            }
-        }
+    struct Incoming {
+        bool present = false;
+        uint8_t type = 0;
+        uint8_t length = 0;
+        uint8_t body[MAX_RELIABLE_BODY_BYTES];
+    };
+    
+    // Serial number order: a comes before b (valid while they are < 32768 apart)
+    static bool before(uint16_t a, uint16_t b) {
+        return static_cast<int16_t>(static_cast<uint16_t>(a - b)) < 0;
     }
     
-    if (!hasCompatibleWeapon) {
-        std::cout << "[AMMO PURCHASE] Player " << player.id << " has no weapon for " << ammo->name << std::endl;
-        delete ammo;
-        return false;
+    // One past the newest id that may be in flight
+    uint16_t inFlightEnd() const {
+        return queued() > WINDOW ? static_cast<uint16_t>(oldestUnacked_ + WINDOW) : nextSendId_;
     }
     
-    // Deduct ammo price from player money
-    player.money -= ammo->price;
+    float resendTimeout() const {
+        return std::min(MAX_TIMEOUT, timeout() * static_cast<float>(1u << backoff_));
+    }
     
-    // Add ammo to shared pool based on ammo type
-    switch (ammoType) {
-        case AmmoType::AMMO_9x18:
-            player.pistolAmmo += ammo->quantity;
-            break;
-        case AmmoType::AMMO_5_45x39:
-            player.rifleAmmo += ammo->quantity;
-            break;
-        case AmmoType::AMMO_7_62x54:
-            player.sniperAmmo += ammo->quantity;
-            break;
+    uint32_t receivedMask() const {
+        uint32_t mask = 0;
+        for (uint16_t i = 0; i + 1 < WINDOW; ++i) {
+            if (incoming_[static_cast<uint16_t>(nextReceiveId_ + 1 + i) % WINDOW].present) {
+                mask |= uint32_t(1) << i;
+            }
+        }
+        return mask;
     }
     
-    std::cout << "[AMMO PURCHASE] Player " << player.id << " purchased " << ammo->name 
-              << " (" << ammo->quantity << " rounds) for $" << ammo->price 
-              << ". New balance: $" << player.money << std::endl;
+    void sampleRtt(float rtt) {
+        backoff_ = 0;
+        rtt_.sample(rtt);
+    }
     
-    delete ammo;
-    return true;
-}
+    std::array<Outgoing, QUEUE_CAPACITY> outgoing_;
+    std::array<Incoming, WINDOW> incoming_;
+    uint16_t nextSendId_ = 0;
+    uint16_t oldestUnacked_ = 0;
+    uint16_t nextReceiveId_ = 0;
+    bool ackPending_ = false;
+    int backoff_ = 0;
+    RttEstimator rtt_;
+    size_t resends_ = 0;
+    size_t duplicates_ = 0;
+};
 
 // ========================
-// Shop UI Rendering System
+// Outgoing Broadcast Queue
 // ========================
 
-// Render weapon tooltip with full stats
-// Render ammo tooltip with full information
-void renderAmmoTooltip(sf::RenderWindow& window, const AmmoItem* ammo, float mouseX, float mouseY, const sf::Font& font) {
-    sf::Vector2u windowSize = window.getSize();
-    
-    // Tooltip dimensions
-    const float TOOLTIP_WIDTH = 320.0f;
-    const float TOOLTIP_HEIGHT = 220.0f;
-    const float PADDING = 15.0f;
-    
-    // Position tooltip near mouse, but keep it on screen
-    const float BOTTOM_UI_RESERVE = 150.0f;
-    
-    float tooltipX = mouseX + 20.0f;
-    float tooltipY = mouseY + 20.0f;
-    
-    // Adjust if tooltip goes off screen
-    if (tooltipX + TOOLTIP_WIDTH > windowSize.x - 10.0f) {
-        tooltipX = mouseX - TOOLTIP_WIDTH - 20.0f;
-    }
-    if (tooltipY + TOOLTIP_HEIGHT > windowSize.y - BOTTOM_UI_RESERVE) {
-        tooltipY = mouseY - TOOLTIP_HEIGHT - 20.0f;
-    }
-    if (tooltipX < 10.0f) tooltipX = 10.0f;
-    if (tooltipY < 10.0f) tooltipY = 10.0f;
-    
-    // Draw tooltip background
-    sf::RectangleShape tooltipBg(sf::Vector2f(TOOLTIP_WIDTH, TOOLTIP_HEIGHT));
-    tooltipBg.setPosition(tooltipX, tooltipY);
-    tooltipBg.setFillColor(sf::Color(20, 20, 20, 240));
-    tooltipBg.setOutlineColor(sf::Color(255, 215, 0));  // Gold border
-    tooltipBg.setOutlineThickness(2.0f);
-    window.draw(tooltipBg);
-    
-    float textY = tooltipY + PADDING;
-    
-    // Ammo name (title)
-    sf::Text nameText;
-    nameText.setFont(font);
-    nameText.setString(ammo->name);
-    nameText.setCharacterSize(24);
-    nameText.setFillColor(sf::Color(255, 215, 0));  // Gold
-    nameText.setStyle(sf::Text::Bold);
-    nameText.setPosition(tooltipX + PADDING, textY);
-    window.draw(nameText);
-    textY += 35.0f;
-    
-    // Price
-    sf::Text priceText;
-    priceText.setFont(font);
-    priceText.setString("Price: $" + std::to_string(ammo->price));
-    priceText.setCharacterSize(20);
-    priceText.setFillColor(sf::Color(100, 255, 100));  // Light green
-    priceText.setPosition(tooltipX + PADDING, textY);
-    window.draw(priceText);
-    textY += 30.0f;
-    
-    // Separator line
-    sf::RectangleShape separator(sf::Vector2f(TOOLTIP_WIDTH - 2 * PADDING, 1.0f));
-    separator.setPosition(tooltipX + PADDING, textY);
-    separator.setFillColor(sf::Color(100, 100, 100));
-    window.draw(separator);
-    textY += 10.0f;
-    
-    // Quantity per purchase
-    sf::Text quantityText;
-    quantityText.setFont(font);
-    quantityText.setString("Quantity: " + std::to_string(ammo->quantity) + " rounds");
-    quantityText.setCharacterSize(18);
-    quantityText.setFillColor(sf::Color::White);
-    quantityText.setPosition(tooltipX + PADDING, textY);
-    window.draw(quantityText);
-    textY += 30.0f;
-    
-    // Compatible weapons section
-    sf::Text compatibleLabel;
-    compatibleLabel.setFont(font);
-    compatibleLabel.setString("Compatible with:");
-    compatibleLabel.setCharacterSize(18);
-    compatibleLabel.setFillColor(sf::Color(200, 200, 200));
-    compatibleLabel.setPosition(tooltipX + PADDING, textY);
-    window.draw(compatibleLabel);
-    textY += 25.0f;
-    
-    // List compatible weapon types
-    std::string weaponList;
-    switch (ammo->type) {
-        case AmmoType::AMMO_9x18:
-            weaponList = "-> Pistols:\n  USP, Glock-18,\n  Five-SeveN, R8 Revolver";
-            break;
-        case AmmoType::AMMO_5_45x39:
-            weaponList = "-> Rifles:\n  Galil AR, M4, AK-47";
-            break;
-        case AmmoType::AMMO_7_62x54:
-            weaponList = "-> Sniper Rifles:\n  M10, AWP, M40";
-            break;
-    }
-    
-    sf::Text weaponListText;
-    weaponListText.setFont(font);
-    weaponListText.setString(weaponList);
-    weaponListText.setCharacterSize(16);
-    weaponListText.setFillColor(sf::Color(150, 200, 255));  // Light blue
-    weaponListText.setPosition(tooltipX + PADDING, textY);
-    window.draw(weaponListText);
+// Shots and hits to send to every ready client with the next tick's datagrams
+// Host shots are queued by the render thread, everything else by the simulation
+// thread; outgoingMutex is a leaf lock (nothing else is taken while holding it)
+struct OutgoingBroadcast {
+    std::vector<ShotPacket> shots;
+    std::vector<HitPacket> hits;
+};
+
+OutgoingBroadcast pendingBroadcast;
+std::mutex outgoingMutex;
+
+void queueBroadcast(const ShotPacket& shotPacket) {
+    std::lock_guard<std::mutex> lock(outgoingMutex);
+    pendingBroadcast.shots.push_back(shotPacket);
 }
 
-void renderWeaponTooltip(sf::RenderWindow& window, const Weapon* weapon, float mouseX, float mouseY, const sf::Font& font) {
-    sf::Vector2u windowSize = window.getSize();
-    
-    // Tooltip dimensions
-    const float TOOLTIP_WIDTH = 320.0f;  // Увеличено с 300 до 320 для лучшей читаемости
-    const float TOOLTIP_HEIGHT = 290.0f;  // Высота для всех характеристик
-    const float PADDING = 15.0f;
-    
-    // Position tooltip near mouse, but keep it on screen
-    // Reserve space for UI elements at bottom (150px for "Press B" and "E - inventory")
-    const float BOTTOM_UI_RESERVE = 150.0f;
-    
-    float tooltipX = mouseX + 20.0f;
-    float tooltipY = mouseY + 20.0f;
-    
-    // Adjust if tooltip goes off screen
-    if (tooltipX + TOOLTIP_WIDTH > windowSize.x - 10.0f) {
-        tooltipX = mouseX - TOOLTIP_WIDTH - 20.0f;
-    }
-    if (tooltipY + TOOLTIP_HEIGHT > windowSize.y - BOTTOM_UI_RESERVE) {
-        // Position above cursor if would overlap bottom UI
-        tooltipY = mouseY - TOOLTIP_HEIGHT - 20.0f;
-    }
-    if (tooltipX < 10.0f) tooltipX = 10.0f;
-    if (tooltipY < 10.0f) tooltipY = 10.0f;
-    
-    // Draw tooltip background
-    sf::RectangleShape tooltipBg(sf::Vector2f(TOOLTIP_WIDTH, TOOLTIP_HEIGHT));
-    tooltipBg.setPosition(tooltipX, tooltipY);
-    tooltipBg.setFillColor(sf::Color(20, 20, 20, 240));
-    tooltipBg.setOutlineColor(sf::Color(255, 215, 0));  // Gold border
-    tooltipBg.setOutlineThickness(2.0f);
-    window.draw(tooltipBg);
-    
-    float textY = tooltipY + PADDING;
-    
-    // Weapon name (title)
-    sf::Text nameText;
-    nameText.setFont(font);
-    nameText.setString(weapon->name);
-    nameText.setCharacterSize(24);
-    nameText.setFillColor(sf::Color(255, 215, 0));  // Gold
-    nameText.setStyle(sf::Text::Bold);
-    nameText.setPosition(tooltipX + PADDING, textY);
-    window.draw(nameText);
-    textY += 35.0f;
-    
-    // Price
-    sf::Text priceText;
-    priceText.setFont(font);
-    priceText.setString("Price: $" + std::to_string(weapon->price));
-    priceText.setCharacterSize(20);
-    priceText.setFillColor(sf::Color(100, 255, 100));  // Light green
-    priceText.setPosition(tooltipX + PADDING, textY);
-    window.draw(priceText);
-    textY += 30.0f;
-    
-    // Separator line
-    sf::RectangleShape separator(sf::Vector2f(TOOLTIP_WIDTH - 2 * PADDING, 1.0f));
-    separator.setPosition(tooltipX + PADDING, textY);
-    separator.setFillColor(sf::Color(100, 100, 100));
-    window.draw(separator);
-    textY += 10.0f;
-    
-    // Stats - format floats properly
-    std::ostringstream reloadStream, moveStream;
-    reloadStream << std::fixed << std::setprecision(1) << weapon->reloadTime;
-    moveStream << std::fixed << std::setprecision(1) << weapon->movementSpeed;
-    
-    std::vector<std::pair<std::string, std::string>> stats = {
-        {"Damage:", std::to_string(static_cast<int>(weapon->damage))},
-        {"Magazine:", std::to_string(weapon->magazineSize)},
-        {"Range:", std::to_string(static_cast<int>(weapon->range)) + " px"},
-        {"Bullet Speed:", std::to_string(static_cast<int>(weapon->bulletSpeed)) + " px/s"},
-        {"Reload Time:", reloadStream.str() + " s"},
-        {"Movement Speed:", moveStream.str()},
-        {"Fire Mode:", weapon->isAutomatic() ? "Automatic (" + std::to_string(static_cast<int>(weapon->fireRate)) + " rps)" : "Semi-Auto"}
-    };
-    
-    for (const auto& stat : stats) {
-        sf::Text statLabel;
-        statLabel.setFont(font);
-        statLabel.setString(stat.first);
-        statLabel.setCharacterSize(16);
-        statLabel.setFillColor(sf::Color(200, 200, 200));
-        statLabel.setPosition(tooltipX + PADDING, textY);
-        window.draw(statLabel);
-        
-        sf::Text statValue;
-        statValue.setFont(font);
-        statValue.setString(stat.second);
-        statValue.setCharacterSize(16);
-        statValue.setFillColor(sf::Color::White);
-        statValue.setStyle(sf::Text::Bold);
-        statValue.setPosition(tooltipX + PADDING + 150.0f, textY);
-        window.draw(statValue);
-        
-        textY += 22.0f;
-    }
+void queueBroadcast(const std::vector<HitPacket>& hitPackets) {
+    std::lock_guard<std::mutex> lock(outgoingMutex);
+    pendingBroadcast.hits.insert(pendingBroadcast.hits.end(), hitPackets.begin(), hitPackets.end());
 }
 
-// Render shop UI with four columns (three for weapons, one for ammo)
-// Requirements: 3.2, 3.3, 3.4, 3.5
-void renderShopUI(sf::RenderWindow& window, const Player& player, const sf::Font& font, float animationProgress) {
-    sf::Vector2u windowSize = window.getSize();
-    
-    // Shop UI dimensions - increased width for 4 columns
-    const float UI_WIDTH = 1300.0f;
-    const float UI_HEIGHT = 700.0f;
-    const float UI_X = (windowSize.x - UI_WIDTH) / 2.0f;
-    const float UI_Y = (windowSize.y - UI_HEIGHT) / 2.0f;
-    
-    // Smooth easing function (ease-out cubic)
-    float easedProgress = 1.0f - std::pow(1.0f - animationProgress, 3.0f);
-    
-    // Scale animation
-    float scale = 0.7f + easedProgress * 0.3f;  // Scale from 70% to 100%
-    float scaledWidth = UI_WIDTH * scale;
-    float scaledHeight = UI_HEIGHT * scale;
-    float scaledX = UI_X + (UI_WIDTH - scaledWidth) / 2.0f;
-    float scaledY = UI_Y + (UI_HEIGHT - scaledHeight) / 2.0f;
-    
-    // Alpha for fade-in
-    sf::Uint8 alpha = static_cast<sf::Uint8>(easedProgress * 230);
-    
-    // Draw semi-transparent background overlay
-    sf::RectangleShape overlay(sf::Vector2f(windowSize.x, windowSize.y));
-    overlay.setFillColor(sf::Color(0, 0, 0, static_cast<sf::Uint8>(easedProgress * 180)));
-    window.draw(overlay);
-    
-    // Draw main shop panel
-    sf::RectangleShape shopPanel(sf::Vector2f(scaledWidth, scaledHeight));
-    shopPanel.setPosition(scaledX, scaledY);
-    shopPanel.setFillColor(sf::Color(40, 40, 40, alpha));
-    shopPanel.setOutlineColor(sf::Color(100, 100, 100, static_cast<sf::Uint8>(easedProgress * 255)));
-    shopPanel.setOutlineThickness(3.0f);
-    window.draw(shopPanel);
-    
-    // Draw title
-    sf::Text titleText;
-    titleText.setFont(font);
-    titleText.setString("WEAPON SHOP");
-    titleText.setCharacterSize(static_cast<unsigned int>(40 * scale));
-    titleText.setFillColor(sf::Color(255, 255, 255, static_cast<sf::Uint8>(easedProgress * 255)));
-    sf::FloatRect titleBounds = titleText.getLocalBounds();
-    titleText.setPosition(
-        scaledX + (scaledWidth - titleBounds.width) / 2.0f - titleBounds.left,
-        scaledY + 20.0f * scale
-    );
-    window.draw(titleText);
-    
-    // Draw player money
-    sf::Text moneyText;
-    moneyText.setFont(font);
-    moneyText.setString("Money: $" + std::to_string(player.money));
-    moneyText.setCharacterSize(static_cast<unsigned int>(28 * scale));
-    moneyText.setFillColor(sf::Color(100, 255, 100, static_cast<sf::Uint8>(easedProgress * 255)));
-    moneyText.setPosition(scaledX + 20.0f * scale, scaledY + 70.0f * scale);
-    window.draw(moneyText);
-    
-    // Column dimensions - now 4 columns
-    const float COLUMN_WIDTH = (scaledWidth - 100.0f * scale) / 4.0f;
-    const float COLUMN_HEIGHT = scaledHeight - 150.0f * scale;
-    const float COLUMN_Y = scaledY + 120.0f * scale;
-    const float COLUMN_PADDING = 20.0f * scale;
-    
-    // Define weapon categories
-    // Requirement 3.3: Three weapon categories + one ammo category
-    struct WeaponCategory {
-        std::string name;
-        std::vector<Weapon::Type> weapons;
-    };
-    
-    std::vector<WeaponCategory> categories = {
-        {"Pistols", {Weapon::USP, Weapon::GLOCK, Weapon::FIVESEVEN, Weapon::R8}},
-        {"Rifles", {Weapon::GALIL, Weapon::M4, Weapon::AK47}},
-        {"Snipers", {Weapon::M10, Weapon::AWP, Weapon::M40}}
-    };
+// ========================
+// Map Generation Functions
+// ========================
+
+bool overlapsSpawnPoint(const Wall& wall) {
+    sf::FloatRect wallBounds(wall.x, wall.y, wall.width, wall.height);
+    sf::FloatRect serverSpawn(0.0f, 450.0f, 50.0f, 50.0f);   // Bottom-left corner
+    sf::FloatRect clientSpawn(450.0f, 0.0f, 50.0f, 50.0f);   // Top-right corner
     
-    // Define ammo types
-    std::vector<AmmoType> ammoTypes = {
-        AmmoType::AMMO_9x18,
-        AmmoType::AMMO_5_45x39,
-        AmmoType::AMMO_7_62x54
-    };
+    return wallBounds.intersects(serverSpawn) || wallBounds.intersects(clientSpawn);
+}
+
+bool cellHasWall(int cellX, int cellY, const GameMap& map) {
+    sf::FloatRect cellBounds(cellX * 10.0f, cellY * 10.0f, 10.0f, 10.0f);
+    for (const auto& wall : map.walls) {
+        sf::FloatRect wallBounds(wall.x, wall.y, wall.width, wall.height);
+        if (cellBounds.intersects(wallBounds)) return true;
+    }
+    return false;
+}
+
+// BREADTH-FIRST SEARCH (BFS) ALGORITHM EXPLANATION:
+// BFS is a graph traversal algorithm that explores all neighbors at the current depth
+// before moving to nodes at the next depth level. It guarantees finding the shortest path.
+//
+// How it works for map validation:
+// 1. Divide the 500x500 map into a 50x50 grid (10 units per cell)
+// 2. Start from server spawn point (bottom-left corner)
+// 3. Explore all adjacent cells (up, down, left, right) that don't contain walls
+// 4. Mark each visited cell to avoid revisiting
+// 5. Continue until we reach client spawn point (top-right corner) or exhaust all paths
+// 6. If we reach the end, the map is valid (players can reach each other)
+//
+// Why BFS instead of DFS?
+// - BFS guarantees finding a path if one exists
+// - BFS finds the shortest path (though we only care about existence)
+// - BFS is more predictable for this use case
+//
+// Performance: O(n) where n = number of grid cells (50x50 = 2500 cells max)
+// Typical runtime: < 1ms for most maps
+bool bfsPathExists(sf::Vector2f start, sf::Vector2f end, const GameMap& map) {
+    // BFS on a grid with 10x10 unit cells
+    const int gridSize = 50; // 500/10 = 50
+    std::vector<std::vector<bool>> visited(gridSize, std::vector<bool>(gridSize, false));
+    std::queue<sf::Vector2i> queue;
     
-    // Variables to store hovered weapon for tooltip rendering at the end
-    Weapon* hoveredWeapon = nullptr;
-    AmmoItem* hoveredAmmo = nullptr;
-    float hoveredMouseX = 0.0f;
-    float hoveredMouseY = 0.0f;
-    
-    // Draw each column
-    for (size_t col = 0; col < categories.size(); col++) {
-        float columnX = scaledX + 20.0f * scale + col * (COLUMN_WIDTH + COLUMN_PADDING);
-        
-        // Draw column background
-        sf::RectangleShape columnBg(sf::Vector2f(COLUMN_WIDTH, COLUMN_HEIGHT));
-        columnBg.setPosition(columnX, COLUMN_Y);
-        columnBg.setFillColor(sf::Color(30, 30, 30, alpha));
-        columnBg.setOutlineColor(sf::Color(80, 80, 80, static_cast<sf::Uint8>(easedProgress * 255)));
-        columnBg.setOutlineThickness(2.0f);
-        window.draw(columnBg);
-        
-        // Draw column title
-        sf::Text columnTitle;
-        columnTitle.setFont(font);
-        columnTitle.setString(categories[col].name);
-        columnTitle.setCharacterSize(static_cast<unsigned int>(26 * scale));
-        columnTitle.setFillColor(sf::Color(255, 200, 100, static_cast<sf::Uint8>(easedProgress * 255)));
-        sf::FloatRect columnTitleBounds = columnTitle.getLocalBounds();
-        columnTitle.setPosition(
-            columnX + (COLUMN_WIDTH - columnTitleBounds.width) / 2.0f - columnTitleBounds.left,
-            COLUMN_Y + 10.0f * scale
-        );
-        window.draw(columnTitle);
+    // Convert world coordinates to grid coordinates
+    sf::Vector2i startCell(static_cast<int>(start.x / 10), static_cast<int>(start.y / 10));
+    sf::Vector2i endCell(static_cast<int>(end.x / 10), static_cast<int>(end.y / 10));
+    
+    // Clamp to valid grid bounds to prevent out-of-bounds access
+    startCell.x = std::max(0, std::min(gridSize - 1, startCell.x));
+    startCell.y = std::max(0, std::min(gridSize - 1, startCell.y));
+    endCell.x = std::max(0, std::min(gridSize - 1, endCell.x));
+    endCell.y = std::max(0, std::min(gridSize - 1, endCell.y));
+    
+    // Initialize BFS: add start cell to queue and mark as visited
+    queue.push(startCell);
+    visited[startCell.x][startCell.y] = true;
+    
+    // Direction vectors for 4-directional movement (right, down, left, up)
+    const int dx[] = {0, 1, 0, -1};
+    const int dy[] = {1, 0, -1, 0};
+    
+    // BFS main loop: explore all reachable cells
+    while (!queue.empty()) {
+        sf::Vector2i current = queue.front();
+        queue.pop();
         
-        // Draw weapons in this column
-        float weaponY = COLUMN_Y + 50.0f * scale;
-        const float WEAPON_HEIGHT = 110.0f * scale;
-        const float WEAPON_PADDING = 10.0f * scale;
+        // Success: we reached the destination
+        if (current == endCell) return true;
         
-        for (Weapon::Type weaponType : categories[col].weapons) {
-            // Create weapon to get stats
-            Weapon* weapon = Weapon::create(weaponType);
-            
-            // Calculate purchase status
-            // Requirement 3.5: Show purchase status
-            PurchaseStatus status = calculatePurchaseStatus(player, weapon);
-            
-            // Draw weapon panel
-            sf::RectangleShape weaponPanel(sf::Vector2f(COLUMN_WIDTH - 20.0f * scale, WEAPON_HEIGHT));
-            weaponPanel.setPosition(columnX + 10.0f * scale, weaponY);
+        // Explore all 4 adjacent cells
+        for (int i = 0; i < 4; ++i) {
+            int nx = current.x + dx[i];
+            int ny = current.y + dy[i];
             
-            // Color based on purchase status
-            if (status == PurchaseStatus::Purchasable) {
-                weaponPanel.setFillColor(sf::Color(50, 70, 50, alpha));  // Green tint
-                weaponPanel.setOutlineColor(sf::Color(100, 200, 100, static_cast<sf::Uint8>(easedProgress * 255)));
-            } else {
-                weaponPanel.setFillColor(sf::Color(50, 50, 50, alpha));  // Gray
-                weaponPanel.setOutlineColor(sf::Color(100, 100, 100, static_cast<sf::Uint8>(easedProgress * 255)));
+            // Check if neighbor is valid: within bounds, not visited, and no wall
+            if (nx >= 0 && nx < gridSize && ny >= 0 && ny < gridSize &&
+                !visited[nx][ny] && !cellHasWall(nx, ny, map)) {
+                visited[nx][ny] = true;
+                queue.push(sf::Vector2i(nx, ny));
             }
-            weaponPanel.setOutlineThickness(1.0f);
-            window.draw(weaponPanel);
+        }
+    }
+    
+    // Failed: no path exists between start and end
+    return false;
+}
+
+bool validateConnectivity(const GameMap& map) {
+    // BFS from bottom-left to top-right
+    sf::Vector2f start(25.0f, 475.0f);  // Server spawn
+    sf::Vector2f end(475.0f, 25.0f);    // Client spawn
+    
+    return bfsPathExists(start, end, map);
+}
+
+void generateWalls(GameMap& map) {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_real_distribution<float> posDist(50.0f, 450.0f); // Avoid edges
+    std::uniform_real_distribution<float> lengthDist(8.0f, 60.0f); // Wall length 8-60 pixels
+    std::uniform_real_distribution<float> thicknessDist(8.0f, 12.0f); // Wall thickness 8-12 pixels
+    std::uniform_int_distribution<int> orientationDist(0, 1); // 0=horizontal, 1=vertical
+    
+    // Generate 15-25 random walls
+    std::uniform_int_distribution<int> wallCountDist(15, 25);
+    int numWalls = wallCountDist(gen);
+    
+    for (int i = 0; i < numWalls; ++i) {
+        Wall wall;
+        float length = lengthDist(gen);
+        float thickness = thicknessDist(gen);
+        int orientation = orientationDist(gen);
+        
+        wall.x = posDist(gen);
+        wall.y = posDist(gen);
+        
+        if (orientation == 0) {
+            // Horizontal wall
+            wall.width = length;
+            wall.height = thickness;
+        } else {
+            // Vertical wall
+            wall.width = thickness;
+            wall.height = length;
+        }
+        
+        // Ensure wall stays within bounds
+        if (wall.x + wall.width > 500.0f) {
+            wall.x = 500.0f - wall.width;
+        }
+        if (wall.y + wall.height > 500.0f) {
+            wall.y = 500.0f - wall.height;
+        }
+        
+        // Ensure wall doesn't overlap spawn points
+        if (!overlapsSpawnPoint(wall)) {
+            map.walls.push_back(wall);
+        }
+    }
+}
+
+std::unique_ptr<Quadtree> buildQuadtree(std::vector<Wall>& walls, float mapWidth, float mapHeight) {
+    // Create root quadtree node covering entire map
+    auto quadtree = std::make_unique<Quadtree>(sf::FloatRect(0.0f, 0.0f, mapWidth, mapHeight));
+    
+    // Insert all walls into the quadtree
+    for (auto& wall : walls) {
+        quadtree->insert(&wall);
+    }
+    
+    std::cout << "[INFO] Quadtree built successfully" << std::endl;
+    return quadtree;
+}
+
+GameMap generateMap() {
+    sf::Clock mapGenClock;
+    
+    for (int attempt = 0; attempt < 10; ++attempt) {
+        GameMap map;
+        generateWalls(map);
+        
+        if (validateConnectivity(map)) {
+            float mapGenTime = mapGenClock.getElapsedTime().asMilliseconds();
             
-            // Draw weapon name
-            // Requirement 3.4: Display weapon name
-            sf::Text weaponName;
-            weaponName.setFont(font);
-            weaponName.setString(weapon->name);
-            weaponName.setCharacterSize(static_cast<unsigned int>(20 * scale));
-            weaponName.setFillColor(sf::Color(255, 255, 255, static_cast<sf::Uint8>(easedProgress * 255)));
-            weaponName.setPosition(columnX + 15.0f * scale, weaponY + 5.0f * scale);
-            window.draw(weaponName);
+            ErrorHandler::logInfo("Map generated successfully on attempt " + std::to_string(attempt + 1));
+            ErrorHandler::logInfo("Total walls: " + std::to_string(map.walls.size()));
             
-            // Draw weapon price
-            // Requirement 3.4: Display price
-            sf::Text weaponPrice;
-            weaponPrice.setFont(font);
-            weaponPrice.setString("$" + std::to_string(weapon->price));
-            weaponPrice.setCharacterSize(static_cast<unsigned int>(18 * scale));
-            weaponPrice.setFillColor(sf::Color(255, 215, 0, static_cast<sf::Uint8>(easedProgress * 255)));  // Gold color
-            weaponPrice.setPosition(columnX + 15.0f * scale, weaponY + 28.0f * scale);
-            window.draw(weaponPrice);
+            // Calculate actual coverage
+            float totalCoverage = 0.0f;
+            for (const auto& wall : map.walls) {
+                totalCoverage += wall.width * wall.height;
+            }
+            float coveragePercent = (totalCoverage / (500.0f * 500.0f)) * 100.0f;
             
-            // Draw weapon stats
-            // Requirement 3.4: Display damage and magazine size
-            sf::Text weaponStats;
-            weaponStats.setFont(font);
-            std::ostringstream statsStream;
-            statsStream << "Damage: " << static_cast<int>(weapon->damage) << "\n";
-            statsStream << "Magazine: " << weapon->magazineSize;
-            weaponStats.setString(statsStream.str());
-            weaponStats.setCharacterSize(static_cast<unsigned int>(16 * scale));
-            weaponStats.setFillColor(sf::Color(200, 200, 200, static_cast<sf::Uint8>(easedProgress * 255)));
-            weaponStats.setPosition(columnX + 15.0f * scale, weaponY + 50.0f * scale);
-            window.draw(weaponStats);
+            std::ostringstream oss;
+            oss << "Map coverage: " << coveragePercent << "%";
+            ErrorHandler::logInfo(oss.str());
             
-            // Draw purchase status
-            // Requirement 3.5: Show purchase status
-            sf::Text statusText;
-            statusText.setFont(font);
-            statusText.setString(getPurchaseStatusText(status, weapon->price));
-            statusText.setCharacterSize(static_cast<unsigned int>(14 * scale));
-            sf::Color statusColor = getPurchaseStatusColor(status);
-            statusText.setFillColor(sf::Color(statusColor.r, statusColor.g, statusColor.b, static_cast<sf::Uint8>(easedProgress * 255)));
-            statusText.setPosition(columnX + 15.0f * scale, weaponY + 90.0f * scale);
-            window.draw(statusText);
+            // Build quadtree for spatial partitioning
+            map.spatialIndex = buildQuadtree(map.walls, map.width, map.height);
             
-            // Check if mouse is hovering over this weapon slot
-            sf::Vector2i mousePixelPos = sf::Mouse::getPosition(window);
-            sf::FloatRect weaponBounds(
-                columnX + 10.0f * scale,
-                weaponY,
-                COLUMN_WIDTH - 20.0f * scale,
-                WEAPON_HEIGHT
-            );
+            // Log map generation performance
+            std::cout << "\n=== MAP GENERATION PERFORMANCE ===" << std::endl;
+            std::cout << "Total Time: " << mapGenTime << "ms (target: <100ms)" << std::endl;
+            std::cout << "Attempts: " << (attempt + 1) << std::endl;
+            std::cout << "Walls Generated: " << map.walls.size() << std::endl;
+            std::cout << "Coverage: " << coveragePercent << "%" << std::endl;
             
-            // If hovering, store weapon for tooltip rendering at the end
-            if (weaponBounds.contains(static_cast<float>(mousePixelPos.x), static_cast<float>(mousePixelPos.y))) {
-                // Delete previous hovered weapon if exists
-                if (hoveredWeapon != nullptr) {
-                    delete hoveredWeapon;
-                }
-                // Store this weapon for tooltip (don't delete it yet)
-                hoveredWeapon = weapon;
-                hoveredMouseX = static_cast<float>(mousePixelPos.x);
-                hoveredMouseY = static_cast<float>(mousePixelPos.y);
+            if (mapGenTime > 100.0f) {
+                std::cerr << "[WARNING] Map generation exceeded 100ms target!" << std::endl;
             } else {
-                // Not hovering, delete weapon as usual
-                delete weapon;
+                std::cout << "[SUCCESS] Map generation within target time" << std::endl;
             }
+            std::cout << "===================================\n" << std::endl;
             
-            weaponY += WEAPON_HEIGHT + WEAPON_PADDING;
+            return map;
         }
+        
+        ErrorHandler::logWarning("Map generation attempt " + std::to_string(attempt + 1) + " failed connectivity check");
     }
     
-    // Draw ammo column (4th column)
-    {
-        float columnX = scaledX + 20.0f * scale + 3 * (COLUMN_WIDTH + COLUMN_PADDING);
-        
-        // Draw column background
-        sf::RectangleShape columnBg(sf::Vector2f(COLUMN_WIDTH, COLUMN_HEIGHT));
-        columnBg.setPosition(columnX, COLUMN_Y);
-        columnBg.setFillColor(sf::Color(30, 30, 30, alpha));
-        columnBg.setOutlineColor(sf::Color(80, 80, 80, static_cast<sf::Uint8>(easedProgress * 255)));
-        columnBg.setOutlineThickness(2.0f);
-        window.draw(columnBg);
-        
-        // Draw column title
-        sf::Text columnTitle;
-        columnTitle.setFont(font);
-        columnTitle.setString("Ammo");
-        columnTitle.setCharacterSize(static_cast<unsigned int>(26 * scale));
-        columnTitle.setFillColor(sf::Color(255, 200, 100, static_cast<sf::Uint8>(easedProgress * 255)));
-        sf::FloatRect columnTitleBounds = columnTitle.getLocalBounds();
-        columnTitle.setPosition(
-            columnX + (COLUMN_WIDTH - columnTitleBounds.width) / 2.0f - columnTitleBounds.left,
-            COLUMN_Y + 10.0f * scale
-        );
-        window.draw(columnTitle);
-        
-        // Draw ammo items
-        float ammoY = COLUMN_Y + 50.0f * scale;
-        const float AMMO_HEIGHT = 110.0f * scale;
-        const float AMMO_PADDING = 10.0f * scale;
+    ErrorHandler::handleMapGenerationFailure();
+    throw std::runtime_error("Failed to generate valid map after 10 attempts");
+}
+
+// ========================
+// Performance Monitoring System (moved here for use in collision detection)
+// ========================
+
+// One client connection over the last report window (see LinkQuality)
+// Upstream is client -> server, downstream server -> client
+struct ConnectionReport {
+    uint32_t playerId = 0;
+    bool hasRtt = false;
+    float rtt = 0.0f;             // Smoothed, seconds
+    float rttJitter = 0.0f;       // Mean deviation, seconds
+    uint64_t upstreamReceived = 0;
+    int64_t upstreamLost = 0;     // Late datagrams may make a window negative
+    uint64_t upstreamOutOfOrder = 0;
+    uint64_t upstreamDuplicates = 0;
+    uint64_t downstreamSent = 0;
+    int64_t downstreamLost = 0;   // As reported by the client
+    uint64_t reliableResends = 0;
+};
+
+class PerformanceMonitor {
+public:
+    PerformanceMonitor() : frameCount_(0), elapsedTime_(0.0f), currentFPS_(0.0f),
+                          totalCollisionTime_(0.0f), collisionSamples_(0),
+                          totalNetworkBytesSent_(0), totalNetworkBytesReceived_(0),
+                          networkSampleTime_(0.0f), targetRate_(60.0f),
+                          totalTickCost_(0.0f), maxTickCost_(0.0f), tickSamples_(0),
+                          tickOverruns_(0), skippedTicks_(0) {}
+    
+    // Set the expected update rate (simulation tick rate in Hz)
+    // Targets and frame budget in the report are derived from it
+    void setTargetRate(float rate) {
+        targetRate_ = rate;
+    }
+    
+    // Update performance metrics each simulation tick
+    void update(float deltaTime, size_t playerCount, size_t wallCount) {
+        frameCount_++;
+        elapsedTime_ += deltaTime;
+        networkSampleTime_ += deltaTime;
         
-        for (AmmoType ammoType : ammoTypes) {
-            // Create ammo item to get stats
-            AmmoItem* ammo = AmmoItem::create(ammoType);
-            
-            // Check if player has weapon for this ammo type
-            bool hasCompatibleWeapon = false;
-            for (int i = 0; i < 4; i++) {
-                if (player.inventory[i] != nullptr) {
-                    if (player.inventory[i]->getAmmoType() == ammoType) {
-                        hasCompatibleWeapon = true;
-                        break;
-                    }
-                }
-            }
+        // Calculate FPS every 1 second window
+        if (elapsedTime_ >= 1.0f) {
+            currentFPS_ = frameCount_ / elapsedTime_;
             
-            // Check if player has enough money
-            bool canAfford = player.money >= ammo->price;
+            // Calculate average collision detection time
+            float avgCollisionTime = (collisionSamples_ > 0) ? 
+                (totalCollisionTime_ / collisionSamples_) * 1000.0f : 0.0f; // Convert to ms
             
-            // Draw ammo panel
-            sf::RectangleShape ammoPanel(sf::Vector2f(COLUMN_WIDTH - 20.0f * scale, AMMO_HEIGHT));
-            ammoPanel.setPosition(columnX + 10.0f * scale, ammoY);
+            // Calculate network bandwidth (bytes per second)
+            float networkBandwidthSent = totalNetworkBytesSent_ / networkSampleTime_;
+            float networkBandwidthReceived = totalNetworkBytesReceived_ / networkSampleTime_;
             
-            // Color based on purchase status
-            if (hasCompatibleWeapon && canAfford) {
-                ammoPanel.setFillColor(sf::Color(50, 70, 50, alpha));  // Green tint
-                ammoPanel.setOutlineColor(sf::Color(100, 200, 100, static_cast<sf::Uint8>(easedProgress * 255)));
-            } else {
-                ammoPanel.setFillColor(sf::Color(50, 50, 50, alpha));  // Gray
-                ammoPanel.setOutlineColor(sf::Color(100, 100, 100, static_cast<sf::Uint8>(easedProgress * 255)));
-            }
-            ammoPanel.setOutlineThickness(1.0f);
-            window.draw(ammoPanel);
+            // Tick budget and measured simulation cost
+            float tickBudget = 1000.0f / targetRate_; // ms
+            float avgTickCost = (tickSamples_ > 0) ? (totalTickCost_ / tickSamples_) * 1000.0f : 0.0f;
             
-            // Draw ammo name
-            sf::Text ammoName;
-            ammoName.setFont(font);
-            ammoName.setString(ammo->name);
-            ammoName.setCharacterSize(static_cast<unsigned int>(18 * scale));
-            ammoName.setFillColor(sf::Color(255, 255, 255, static_cast<sf::Uint8>(easedProgress * 255)));
-            ammoName.setPosition(columnX + 15.0f * scale, ammoY + 5.0f * scale);
-            window.draw(ammoName);
+            // Log performance metrics
+            std::cout << "\n=== PERFORMANCE METRICS ===" << std::endl;
+            std::cout << "Tick Rate: " << currentFPS_ << " Hz (target: " << targetRate_ << ")" << std::endl;
+            std::cout << "Tick Interval: " << (elapsedTime_ / frameCount_) * 1000.0f << "ms" << std::endl;
+            std::cout << "Tick Cost: avg " << avgTickCost << "ms, max " << maxTickCost_ * 1000.0f
+                      << "ms (budget: " << tickBudget << "ms)" << std::endl;
+            std::cout << "Tick Overruns: " << tickOverruns_ << ", Skipped Ticks: " << skippedTicks_ << std::endl;
+            std::cout << "Players: " << playerCount << std::endl;
+            std::cout << "Walls: " << wallCount << std::endl;
+            std::cout << "Avg Collision Detection: " << avgCollisionTime << "ms (target: <1ms)" << std::endl;
+            std::cout << "Network Bandwidth Sent: " << networkBandwidthSent << " bytes/sec" << std::endl;
+            std::cout << "Network Bandwidth Received: " << networkBandwidthReceived << " bytes/sec" << std::endl;
             
-            // Draw ammo price
-            sf::Text ammoPrice;
-            ammoPrice.setFont(font);
-            ammoPrice.setString("$" + std::to_string(ammo->price));
-            ammoPrice.setCharacterSize(static_cast<unsigned int>(18 * scale));
-            ammoPrice.setFillColor(sf::Color(255, 215, 0, static_cast<sf::Uint8>(easedProgress * 255)));
-            ammoPrice.setPosition(columnX + 15.0f * scale, ammoY + 28.0f * scale);
-            window.draw(ammoPrice);
+            // Snapshot compression: bytes actually sent vs one PositionPacket per player
+            if (snapshotsSent_ > 0) {
+                float compression = (snapshotBytes_ > 0) ? static_cast<float>(snapshotRawBytes_) / snapshotBytes_ : 0.0f;
+                std::cout << "Snapshots: " << snapshotsSent_ << " sent (" << deltaSnapshots_ << " delta), avg "
+                          << snapshotBytes_ / snapshotsSent_ << " bytes vs " << snapshotRawBytes_ / snapshotsSent_
+                          << " uncompressed (" << compression << "x)" << std::endl;
+            }
             
-            // Draw ammo quantity
-            sf::Text ammoQuantity;
-            ammoQuantity.setFont(font);
-            ammoQuantity.setString("Quantity: " + std::to_string(ammo->quantity));
-            ammoQuantity.setCharacterSize(static_cast<unsigned int>(16 * scale));
-            ammoQuantity.setFillColor(sf::Color(200, 200, 200, static_cast<sf::Uint8>(easedProgress * 255)));
-            ammoQuantity.setPosition(columnX + 15.0f * scale, ammoY + 50.0f * scale);
-            window.draw(ammoQuantity);
+            // Line-of-sight culling: share of in-range players hidden by walls, rays traced
+            if (relevancyCandidates_ > 0) {
+                std::cout << "LOS Culling: " << relevancyOccluded_ << " of " << relevancyCandidates_
+                          << " in-range players occluded (" << 100 * relevancyOccluded_ / relevancyCandidates_
+                          << "%), " << losRays_ << " rays traced" << std::endl;
+            }
             
-            // Draw purchase status
-            sf::Text statusText;
-            statusText.setFont(font);
-            if (!hasCompatibleWeapon) {
-                statusText.setString("No compatible weapon");
-                statusText.setFillColor(sf::Color(255, 100, 100, static_cast<sf::Uint8>(easedProgress * 255)));
-            } else if (!canAfford) {
-                statusText.setString("Insufficient funds");
-                statusText.setFillColor(sf::Color(255, 100, 100, static_cast<sf::Uint8>(easedProgress * 255)));
-            } else {
-                statusText.setString("Can purchase");
-                statusText.setFillColor(sf::Color(100, 255, 100, static_cast<sf::Uint8>(easedProgress * 255)));
+            // UDP send: how many messages each batched datagram carried
+            if (datagramsSent_ > 0) {
+                std::cout << "UDP Send: " << datagramsSent_ << " datagrams carrying " << messagesSent_
+                          << " messages (avg " << static_cast<float>(messagesSent_) / datagramsSent_
+                          << " per datagram)" << std::endl;
             }
-            statusText.setCharacterSize(static_cast<unsigned int>(14 * scale));
-            statusText.setPosition(columnX + 15.0f * scale, ammoY + 75.0f * scale);
-            window.draw(statusText);
             
-            // Check if mouse is hovering over this ammo slot
-            sf::Vector2i mousePixelPos = sf::Mouse::getPosition(window);
-            sf::FloatRect ammoBounds(
-                columnX + 10.0f * scale,
-                ammoY,
-                COLUMN_WIDTH - 20.0f * scale,
-                AMMO_HEIGHT
-            );
+            // UDP ingest: how many datagrams each listener wakeup drained and how many were lost
+            int wakeups = receiveWakeups_.load();
+            float avgDatagramsPerWakeup = (wakeups > 0) ?
+                static_cast<float>(datagramsReceived_.load()) / wakeups : 0.0f;
+            std::cout << "UDP Receive: " << datagramsReceived_.load() << " datagrams in " << wakeups
+                      << " wakeups (avg " << avgDatagramsPerWakeup << ", max " << maxDatagramsPerWakeup_.load()
+                      << " per wakeup)" << std::endl;
+            int64_t inboundSequenceGaps = 0;
+            for (const ConnectionReport& connection : connections_) {
+                inboundSequenceGaps += std::max<int64_t>(0, connection.upstreamLost);
+            }
+            std::cout << "UDP Inbound Loss: " << inboundSequenceGaps << " missing client sequence numbers";
+            if (kernelDropsTotal_.load() >= 0) {
+                std::cout << ", " << kernelDropsTotal_.load() << " kernel socket drops (total)";
+            }
+            std::cout << std::endl;
             
-            // If hovering, store ammo for tooltip rendering at the end
-            if (ammoBounds.contains(static_cast<float>(mousePixelPos.x), static_cast<float>(mousePixelPos.y))) {
-                // Delete previous hovered ammo if exists
-                if (hoveredAmmo != nullptr) {
-                    delete hoveredAmmo;
-                }
-                // Store this ammo for tooltip (don't delete it yet)
-                hoveredAmmo = ammo;
-                hoveredMouseX = static_cast<float>(mousePixelPos.x);
-                hoveredMouseY = static_cast<float>(mousePixelPos.y);
-            } else {
-                // Not hovering, delete ammo as usual
-                delete ammo;
+            // Per-connection latency and loss (both directions)
+            for (const ConnectionReport& connection : connections_) {
+                logConnection(connection);
             }
             
-            ammoY += AMMO_HEIGHT + AMMO_PADDING;
-        }
+            // Game thread load: percentage of the tick budget spent simulating
+            // At 60 Hz, we have 16.67ms per tick
+            // This shows how much of that budget we're using
+            float gameThreadLoad = (avgTickCost / tickBudget) * 100.0f;
+            
+            // Estimate actual CPU usage (more conservative)
+            // Assumes game uses ~40% CPU at full frame budget
+            float estimatedCPUUsage = (gameThreadLoad / 100.0f) * 40.0f;
+            
+            // Display both metrics for better understanding
+            std::cout << "Game Thread Load: " << gameThreadLoad << "% of frame budget" << std::endl;
+            std::cout << "Estimated CPU Usage: " << estimatedCPUUsage << "% (target: <40%)" << std::endl;
+            
+            // Add build type hint if performance is lower
+            if (gameThreadLoad > 100.0f) {
+                std::cout << "Note: Running Debug build? Release build typically 30-50% faster" << std::endl;
+            }
+            
+            std::cout << "==========================\n" << std::endl;
+            
+            // Log warning if the tick rate drops below 90% of the target
+            if (currentFPS_ < targetRate_ * 0.9f) {
+                logPerformanceWarning(playerCount, wallCount, avgCollisionTime, gameThreadLoad);
+            }
+            
+            // Log warning if collision detection is too slow
+            if (avgCollisionTime > 1.0f) {
+                std::cerr << "[WARNING] Collision detection exceeds 1ms target: " 
+                         << avgCollisionTime << "ms" << std::endl;
+            }
+            
+            // Log warning if game thread load is too high (not CPU usage)
+            if (gameThreadLoad > 110.0f) {
+                std::cerr << "[WARNING] Game thread load exceeds frame budget: " 
+                         << gameThreadLoad << "%" << std::endl;
+                std::cerr << "  This means ticks are taking longer than " << tickBudget << "ms" << std::endl;
+                std::cerr << "  Consider optimizing or using Release build" << std::endl;
+            }
+            
+            // Reset counters for next window
+            frameCount_ = 0;
+            elapsedTime_ = 0.0f;
+            totalCollisionTime_ = 0.0f;
+            collisionSamples_ = 0;
+            totalNetworkBytesSent_ = 0;
+            totalNetworkBytesReceived_ = 0;
+            networkSampleTime_ = 0.0f;
+            totalTickCost_ = 0.0f;
+            maxTickCost_ = 0.0f;
+            tickSamples_ = 0;
+            tickOverruns_ = 0;
+            skippedTicks_ = 0;
+            receiveWakeups_ = 0;
+            datagramsReceived_ = 0;
+            maxDatagramsPerWakeup_ = 0;
+            connections_.clear();
+            snapshotsSent_ = 0;
+            deltaSnapshots_ = 0;
+            snapshotBytes_ = 0;
+            snapshotRawBytes_ = 0;
+            datagramsSent_ = 0;
+            messagesSent_ = 0;
+            relevancyCandidates_ = 0;
+            relevancyOccluded_ = 0;
+            losRays_ = 0;
+        }
+    }
+    
+    // Record the wall-clock cost of one simulation tick
+    void recordTickCost(float timeInSeconds, bool overrun) {
+        totalTickCost_ += timeInSeconds;
+        maxTickCost_ = std::max(maxTickCost_, timeInSeconds);
+        tickSamples_++;
+        if (overrun) {
+            tickOverruns_++;
+        }
+    }
+    
+    // Record ticks dropped by the scheduler after falling too far behind
+    void recordSkippedTicks(int count) {
+        skippedTicks_ += count;
+    }
+    
+    // Record collision detection time
+    void recordCollisionTime(float timeInSeconds) {
+        totalCollisionTime_ += timeInSeconds;
+        collisionSamples_++;
+    }
+    
+    // Record network traffic
+    void recordNetworkSent(size_t bytes) {
+        totalNetworkBytesSent_ += bytes;
+    }
+    
+    void recordNetworkReceived(size_t bytes) {
+        totalNetworkBytesReceived_ += bytes;
+    }
+    
+    // Record one batched datagram sent to a client and the messages it carried
+    void recordDatagramSent(size_t bytes, size_t messageCount) {
+        totalNetworkBytesSent_ += bytes;
+        datagramsSent_++;
+        messagesSent_ += messageCount;
+    }
+    
+    // Record one snapshot tick's relevancy filtering
+    // candidates passed the distance check; occluded of them were hidden by walls
+    void recordRelevancy(size_t candidates, size_t occluded, int rays) {
+        relevancyCandidates_ += candidates;
+        relevancyOccluded_ += occluded;
+        losRays_ += rays;
+    }
+    
+    // Record one snapshot message (its datagram is counted by recordDatagramSent)
+    // rawBytes is what the same players cost as individual PositionPackets
+    void recordSnapshot(size_t bytes, size_t rawBytes, bool isDelta) {
+        snapshotsSent_++;
+        snapshotBytes_ += bytes;
+        snapshotRawBytes_ += rawBytes;
+        if (isDelta) {
+            deltaSnapshots_++;
+        }
+    }
+    
+    // Record one UDP listener wakeup and the number of datagrams it drained
+    void recordReceiveWakeup(int datagramCount) {
+        receiveWakeups_++;
+        datagramsReceived_ += datagramCount;
+        if (datagramCount > maxDatagramsPerWakeup_.load()) {
+            maxDatagramsPerWakeup_ = datagramCount;
+        }
+    }
+    
+    // Whether update(deltaTime) will print the report
+    // Connections are recorded just before it, so their windows match the report's
+    bool reportDue(float deltaTime) const {
+        return elapsedTime_ + deltaTime >= 1.0f;
+    }
+    
+    // Record one client connection for the next report
+    void recordConnection(const ConnectionReport& connection) {
+        connections_.push_back(connection);
+    }
+    
+    // Record the kernel's cumulative drop counter for the server socket (-1 = unavailable)
+    void setKernelDrops(long long totalDrops) {
+        kernelDropsTotal_ = totalDrops;
+    }
+    
+    // Get current FPS
+    float getCurrentFPS() const {
+        return currentFPS_;
+    }
+    
+private:
+    void logPerformanceWarning(size_t playerCount, size_t wallCount, float avgCollisionTime, float gameThreadLoad) {
+        std::cerr << "[WARNING] Performance degradation detected!" << std::endl;
+        std::cerr << "  Tick Rate: " << currentFPS_ << " Hz (target: " << targetRate_ << ")" << std::endl;
+        std::cerr << "  Players: " << playerCount << std::endl;
+        std::cerr << "  Walls: " << wallCount << std::endl;
+        std::cerr << "  Avg Collision Time: " << avgCollisionTime << "ms (target: <1ms)" << std::endl;
+        
+        float tickInterval = (elapsedTime_ / frameCount_) * 1000.0f;
+        std::cerr << "  Avg Tick Interval: " << tickInterval << "ms (target: " << (1000.0f / targetRate_) << "ms)" << std::endl;
+        std::cerr << "  Game Thread Load: " << gameThreadLoad << "% of frame budget" << std::endl;
+        
+        // Provide helpful suggestions
+        if (gameThreadLoad > 100.0f) {
+            std::cerr << "  Suggestion: Try Release build for better performance" << std::endl;
+        }
+        if (avgCollisionTime > 0.5f) {
+            std::cerr << "  Suggestion: Check Quadtree optimization" << std::endl;
+        }
+    }
+    
+    static void logConnection(const ConnectionReport& connection) {
+        std::cout << "Player " << connection.playerId << ": RTT ";
+        if (connection.hasRtt) {
+            std::cout << connection.rtt * 1000.0f << "ms (jitter " << connection.rttJitter * 1000.0f << "ms)";
+        } else {
+            std::cout << "unknown";
+        }
+        
+        const int64_t upstreamLost = std::max<int64_t>(0, connection.upstreamLost);
+        const int64_t upstreamExpected = static_cast<int64_t>(connection.upstreamReceived) + upstreamLost;
+        std::cout << ", up " << connection.upstreamReceived << " datagrams (loss "
+                  << (upstreamExpected > 0 ? 100.0f * upstreamLost / upstreamExpected : 0.0f)
+                  << "%, " << connection.upstreamOutOfOrder << " out of order, "
+                  << connection.upstreamDuplicates << " duplicate)";
+        
+        const int64_t downstreamLost = std::max<int64_t>(0, connection.downstreamLost);
+        std::cout << ", down " << connection.downstreamSent << " datagrams (loss "
+                  << (connection.downstreamSent > 0 ? 100.0f * downstreamLost / connection.downstreamSent : 0.0f)
+                  << "%), " << connection.reliableResends << " reliable resends" << std::endl;
+    }
+    
+    int frameCount_;
+    float elapsedTime_;
+    float currentFPS_;
+    float totalCollisionTime_;
+    int collisionSamples_;
+    std::atomic<size_t> totalNetworkBytesSent_;      // Written by the simulation thread
+    std::atomic<size_t> totalNetworkBytesReceived_;  // Written by the UDP listener thread
+    float networkSampleTime_;
+    float targetRate_;
+    float totalTickCost_;
+    float maxTickCost_;
+    int tickSamples_;
+    int tickOverruns_;
+    int skippedTicks_;
+    
+    // UDP ingest counters (written by the UDP listener thread)
+    std::atomic<int> receiveWakeups_{0};
+    std::atomic<int> datagramsReceived_{0};
+    std::atomic<int> maxDatagramsPerWakeup_{0};
+    std::atomic<long long> kernelDropsTotal_{-1};
+    
+    // Client connections for the next report (written by the simulation thread)
+    std::vector<ConnectionReport> connections_;
+    
+    // Snapshot compression counters (written by the simulation thread)
+    size_t snapshotsSent_ = 0;
+    size_t deltaSnapshots_ = 0;
+    size_t snapshotBytes_ = 0;
+    size_t snapshotRawBytes_ = 0;
+    
+    // Outgoing batching counters (written by the simulation thread)
+    size_t datagramsSent_ = 0;
+    size_t messagesSent_ = 0;
+    
+    // Line-of-sight culling counters (written by the simulation thread)
+    size_t relevancyCandidates_ = 0;
+    size_t relevancyOccluded_ = 0;
+    size_t losRays_ = 0;
+};
+
+// ========================
+// Fixed-Timestep Tick Scheduler
+// ========================
+
+// Drives the authoritative simulation at a constant tick rate
+//
+// ALGORITHM:
+// 1. Every tick has an absolute deadline: start + tickNumber * tickPeriod
+//    (deadlines never drift, unlike sleeping a fixed amount after each tick)
+// 2. waitForNextTick() sleeps until SPIN_THRESHOLD before the deadline, then
+//    yields in a short spin loop - sf::sleep() on Windows has ~1-2ms granularity,
+//    so sleeping the whole interval would make 128 Hz ticks jitter by 15-25%
+// 3. If the simulation fell behind, the due ticks are returned so the caller
+//    can catch up, up to MAX_CATCH_UP_TICKS per wakeup. Anything beyond that is
+//    counted as skipped and the schedule is rebased to "now" (no spiral of death)
+//
+// PERFORMANCE:
+// - Idle CPU: ~SPIN_THRESHOLD / tickPeriod of one core (about 12% at 60 Hz)
+// - Every tick advances the world by exactly getTickDelta() seconds
+class TickScheduler {
+public:
+    static const int MAX_CATCH_UP_TICKS = 5;
+    
+    explicit TickScheduler(int tickRate)
+        : tickRate_(tickRate),
+          tickPeriod_(sf::microseconds(1000000 / tickRate)),
+          nextTickTime_(sf::Time::Zero),
+          tickNumber_(0),
+          skippedTicks_(0) {}
+    
+    // Block until at least one tick is due
+    // Returns: number of ticks to run now (1..MAX_CATCH_UP_TICKS)
+    int waitForNextTick() {
+        const sf::Time SPIN_THRESHOLD = sf::milliseconds(2);
+        
+        sf::Time now = clock_.getElapsedTime();
+        if (now < nextTickTime_) {
+            sf::Time remaining = nextTickTime_ - now;
+            if (remaining > SPIN_THRESHOLD) {
+                sf::sleep(remaining - SPIN_THRESHOLD);
+            }
+            while (clock_.getElapsedTime() < nextTickTime_) {
+                std::this_thread::yield();
+            }
+            now = clock_.getElapsedTime();
+        }
+        
+        // Count every deadline that has passed
+        int dueTicks = static_cast<int>((now - nextTickTime_).asMicroseconds() / tickPeriod_.asMicroseconds()) + 1;
+        
+        if (dueTicks > MAX_CATCH_UP_TICKS) {
+            skippedTicks_ += dueTicks - MAX_CATCH_UP_TICKS;
+            dueTicks = MAX_CATCH_UP_TICKS;
+            // Rebase: the next deadline is one period after the ticks we do run
+            nextTickTime_ = now - tickPeriod_ * static_cast<float>(MAX_CATCH_UP_TICKS - 1);
+        }
+        
+        return dueTicks;
+    }
+    
+    // Mark the start of a tick (call once per due tick)
+    void beginTick() {
+        tickStart_ = clock_.getElapsedTime();
+    }
+    
+    // Mark the end of a tick and advance the schedule
+    // Returns: true if the tick took longer than its budget (overrun)
+    bool endTick() {
+        lastTickCost_ = clock_.getElapsedTime() - tickStart_;
+        nextTickTime_ += tickPeriod_;
+        tickNumber_++;
+        return lastTickCost_ > tickPeriod_;
+    }
+    
+    // Take the number of ticks skipped since the last call
+    int takeSkippedTicks() {
+        int skipped = skippedTicks_;
+        skippedTicks_ = 0;
+        return skipped;
+    }
+    
+    float getTickDelta() const { return tickPeriod_.asSeconds(); }
+    int getTickRate() const { return tickRate_; }
+    uint32_t getTickNumber() const { return tickNumber_; }
+    sf::Time getLastTickCost() const { return lastTickCost_; }
+
+private:
+    sf::Clock clock_;
+    int tickRate_;
+    sf::Time tickPeriod_;
+    sf::Time nextTickTime_;
+    sf::Time tickStart_;
+    sf::Time lastTickCost_;
+    uint32_t tickNumber_;
+    int skippedTicks_;
+};
+
+// Ticks between snapshots, so snapshots go out at about snapshotRate whatever
+// the tick rate (bandwidth does not grow with it)
+// Returns: at least 1 - below the snapshot rate every tick sends one
+inline uint32_t snapshotIntervalTicks(int tickRate, int snapshotRate) {
+    return static_cast<uint32_t>(
+        std::max(1, static_cast<int>(std::lround(tickRate / static_cast<float>(snapshotRate)))));
+}
+
+// ========================
+// Collision Detection System
+// ========================
+//
+// CIRCLE-RECTANGLE COLLISION ALGORITHM:
+// Players are represented as circles (radius 30 units), walls as rectangles.
+// This algorithm efficiently detects if a circle intersects with a rectangle.
+//
+// How it works:
+// 1. Find the closest point on the rectangle to the circle's center
+//    - Clamp circle center X to rectangle's X range [wall.x, wall.x + width]
+//    - Clamp circle center Y to rectangle's Y range [wall.y, wall.y + height]
+// 2. Calculate distance from circle center to this closest point
+// 3. If distance < radius, there's a collision
+//
+// Why this works:
+// - If circle center is inside rectangle, closest point = center (distance = 0)
+// - If circle center is outside, closest point is on rectangle edge or corner
+// - This handles all cases: side collisions, corner collisions, and containment
+//
+// Performance: O(1) - constant time, very fast
+//
+
+// Check if a circle collides with a rectangle
+bool circleRectCollision(sf::Vector2f center, float radius, const Wall& wall) {
+    // Find the closest point on the rectangle to the circle center
+    // std::max/min clamps the value to the rectangle's bounds
+    float closestX = std::max(wall.x, std::min(center.x, wall.x + wall.width));
+    float closestY = std::max(wall.y, std::min(center.y, wall.y + wall.height));
+    
+    // Calculate squared distance from circle center to closest point
+    float dx = center.x - closestX;
+    float dy = center.y - closestY;
+    
+    // Compare squared distances to avoid expensive sqrt() operation
+    return (dx * dx + dy * dy) < (radius * radius);
+}
+
+// Resolve collision and return corrected position
+sf::Vector2f resolveCollision(sf::Vector2f oldPos, sf::Vector2f newPos, float radius, const GameMap& map, PerformanceMonitor* perfMonitor = nullptr) {
+    sf::Clock collisionClock;
+    
+    // Query nearby walls using quadtree
+    sf::FloatRect queryArea(
+        newPos.x - radius - 1.0f,
+        newPos.y - radius - 1.0f,
+        radius * 2 + 2.0f,
+        radius * 2 + 2.0f
+    );
+    
+    sf::Vector2f result = newPos;
+    
+    if (map.spatialIndex) {
+        auto nearbyWalls = map.spatialIndex->query(queryArea);
+        
+        for (const Wall* wall : nearbyWalls) {
+            if (circleRectCollision(newPos, radius, *wall)) {
+                // Calculate penetration depth and push back
+                float closestX = std::max(wall->x, std::min(newPos.x, wall->x + wall->width));
+                float closestY = std::max(wall->y, std::min(newPos.y, wall->y + wall->height));
+                
+                float dx = newPos.x - closestX;
+                float dy = newPos.y - closestY;
+                float distance = std::sqrt(dx * dx + dy * dy);
+                
+                if (distance < 0.001f) {
+                    // Player is exactly on the wall edge, use old position
+                    result = oldPos;
+                    break;
+                }
+                
+                // Calculate how much to push back (radius - distance)
+                float penetration = radius - distance;
+                float pushX = (dx / distance) * penetration;
+                float pushY = (dy / distance) * penetration;
+                
+                result = sf::Vector2f(newPos.x + pushX, newPos.y + pushY);
+                break;
+            }
+        }
+    }
+    
+    // Record collision detection time
+    if (perfMonitor) {
+        float collisionTime = collisionClock.getElapsedTime().asSeconds();
+        perfMonitor->recordCollisionTime(collisionTime);
+    }
+    
+    return result;
+}
+
+// Clamp position to map boundaries [0, 500]
+sf::Vector2f clampToMapBounds(sf::Vector2f pos, float radius) {
+    pos.x = std::max(radius, std::min(500.0f - radius, pos.x));
+    pos.y = std::max(radius, std::min(500.0f - radius, pos.y));
+    return pos;
+}
+
+// ========================
+// NEW: Dynamic Camera System
+// ========================
+
+// Update camera to follow player position
+// The camera keeps the player centered on screen while respecting map boundaries
+// Parameters:
+//   window - The render window to apply the view to
+//   playerPosition - Current position of the player in world coordinates
+//
+// ALGORITHM:
+// 1. Create a view with the same size as the window
+// 2. Set the view center to the player's position
+// 3. Clamp the camera to map boundaries to prevent showing areas outside the map
+// 4. Apply the view to the window
+//
+// BOUNDARY CLAMPING:
+// When the player is near the edge of the map, we need to prevent the camera
+// from showing areas outside the map (which would appear as black space).
+// We do this by clamping the camera center to stay within valid bounds:
+// - Minimum X: halfWidth (so left edge of view doesn't go below 0)
+// - Maximum X: MAP_SIZE - halfWidth (so right edge doesn't exceed MAP_SIZE)
+// - Same logic applies for Y axis
+//
+// This creates a smooth camera that follows the player everywhere except
+// at the map edges, where it stops to prevent showing out-of-bounds areas.
+
+// ========================
+// Rounded Rectangle Helper
+// ========================
+
+// Create a rounded rectangle shape
+// Parameters:
+//   size - Size of the rectangle (width, height)
+//   radius - Radius of the rounded corners
+//   pointCount - Number of points per corner (higher = smoother, default = 8)
+// Returns: ConvexShape representing a rounded rectangle
+sf::ConvexShape createRoundedRectangle(sf::Vector2f size, float radius, unsigned int pointCount = 8) {
+    // Clamp radius to not exceed half of the smaller dimension
+    radius = std::min(radius, std::min(size.x, size.y) / 2.0f);
+    
+    // Total points: 4 corners * pointCount points per corner
+    sf::ConvexShape shape;
+    shape.setPointCount(pointCount * 4);
+    
+    // Helper lambda to add corner points
+    auto addCorner = [&](unsigned int startIndex, sf::Vector2f center, float startAngle) {
+        for (unsigned int i = 0; i < pointCount; ++i) {
+            float angle = startAngle + (i * 90.0f / (pointCount - 1)) * 3.14159f / 180.0f;
+            float x = center.x + radius * std::cos(angle);
+            float y = center.y + radius * std::sin(angle);
+            shape.setPoint(startIndex + i, sf::Vector2f(x, y));
+        }
+    };
+    
+    // Top-left corner (180° to 270°)
+    addCorner(0, sf::Vector2f(radius, radius), 180.0f);
+    
+    // Top-right corner (270° to 360°)
+    addCorner(pointCount, sf::Vector2f(size.x - radius, radius), 270.0f);
+    
+    // Bottom-right corner (0° to 90°)
+    addCorner(pointCount * 2, sf::Vector2f(size.x - radius, size.y - radius), 0.0f);
+    
+    // Bottom-left corner (90° to 180°)
+    addCorner(pointCount * 3, sf::Vector2f(radius, size.y - radius), 90.0f);
+    
+    return shape;
+}
+
+void updateCamera(sf::RenderWindow& window, sf::Vector2f playerPosition) {
+    // Create a view with the window's dimensions
+    sf::View view;
+    view.setSize(static_cast<float>(window.getSize().x), static_cast<float>(window.getSize().y));
+    
+    // Calculate half dimensions for boundary clamping
+    float halfWidth = window.getSize().x / 2.0f;
+    float halfHeight = window.getSize().y / 2.0f;
+    
+    // Start with player position as center
+    sf::Vector2f center = playerPosition;
+    
+    // Clamp camera center to map boundaries
+    // This prevents the camera from showing areas outside the map
+    center.x = std::max(halfWidth, std::min(center.x, MAP_SIZE - halfWidth));
+    center.y = std::max(halfHeight, std::min(center.y, MAP_SIZE - halfHeight));
+    
+    // Set the clamped center
+    view.setCenter(center);
+    
+    // Apply the view to the window
+    // All subsequent draw calls will use this view's coordinate system
+    window.setView(view);
+}
+
+// ========================
+// NEW: Optimized Rendering System
+// ========================
+
+// Render only visible walls within camera's viewport
+// Uses camera-based visibility culling for accurate rendering
+// Parameters:
+//   window - The render window to draw walls to
+//   playerPosition - Current position of the player in world coordinates (unused but kept for compatibility)
+//   grid - The cell grid containing wall information
+//
+// ALGORITHM:
+// 1. Get current camera view to determine visible area
+// 2. Calculate visible world bounds with padding
+// 3. Convert to cell coordinates
+// 4. Render walls only in the visible range
+// 5. Center walls on cell boundaries (position - WALL_WIDTH/2)
+//
+// CAMERA-BASED CULLING:
+// Instead of rendering based on player position, we render based on what the
+// camera can actually see. This fixes the issue where walls disappear when
+// the player is near map edges (camera stops but player position continues).
+//
+// ========================
+// NEW: Fog of War Background Rendering
+// ========================
+
+// ========================
+// Purchase Status System
+// ========================
+
+// Enum for purchase status
+// Requirement 3.5: Show purchase status
+enum class PurchaseStatus {
+    Purchasable,
+    InsufficientFunds,
+    InventoryFull
+};
+
+// Calculate purchase status for a player and weapon
+// Requirement 3.5: Purchase status calculation
+PurchaseStatus calculatePurchaseStatus(const Player& player, const Weapon* weapon) {
+    // Check if inventory is full
+    if (!player.hasInventorySpace()) {
+        return PurchaseStatus::InventoryFull;
+    }
+    
+    // Check if player has sufficient funds
+    if (player.money < weapon->price) {
+        return PurchaseStatus::InsufficientFunds;
+    }
+    
+    // Player can purchase
+    return PurchaseStatus::Purchasable;
+}
+
+// Get purchase status text
+std::string getPurchaseStatusText(PurchaseStatus status, int weaponPrice) {
+    switch (status) {
+        case PurchaseStatus::Purchasable:
+            return "Can purchase";
+        case PurchaseStatus::InsufficientFunds:
+            return "Insufficient funds. Required: $" + std::to_string(weaponPrice);
+        case PurchaseStatus::InventoryFull:
+            return "Inventory full. Free a slot to purchase.";
+        default:
+            return "";
+    }
+}
+
+// Get purchase status color
+sf::Color getPurchaseStatusColor(PurchaseStatus status) {
+    switch (status) {
+        case PurchaseStatus::Purchasable:
+            return sf::Color::Green;
+        case PurchaseStatus::InsufficientFunds:
+            return sf::Color::Red;
+        case PurchaseStatus::InventoryFull:
+            return sf::Color::Yellow;
+        default:
+            return sf::Color::White;
+    }
+}
+
+// ========================
+// Purchase Validation and Transaction Logic
+// ========================
+
+// Process weapon purchase request from client
+// Requirements: 4.1, 4.2, 4.3, 4.4, 4.5
+// Returns: true if purchase successful, false otherwise
+bool processPurchase(Player& player, Weapon::Type weaponType) {
+    // Create weapon to get price
+    Weapon* weapon = Weapon::create(weaponType);
+    
+    // Requirement 4.1: Validate player has sufficient money
+    if (player.money < weapon->price) {
+        std::cout << "[PURCHASE] Player " << player.id << " has insufficient funds: " 
+                  << player.money << " < " << weapon->price << std::endl;
+        delete weapon;
+        return false;
+    }
+    
+    // Requirement 4.2: Validate player has empty inventory slot
+    if (!player.hasInventorySpace()) {
+        std::cout << "[PURCHASE] Player " << player.id << " has full inventory" << std::endl;
+        delete weapon;
+        return false;
+    }
+    
+    // Get first empty slot
+    int emptySlot = player.getFirstEmptySlot();
+    if (emptySlot < 0) {
+        // This shouldn't happen if hasInventorySpace() returned true, but check anyway
+        std::cerr << "[ERROR] hasInventorySpace() returned true but getFirstEmptySlot() returned -1" << std::endl;
+        delete weapon;
+        return false;
+    }
+    
+    // Requirement 4.3: Deduct weapon price from player money
+    player.money -= weapon->price;
+    
+    // Requirement 4.4: Add weapon to first empty inventory slot
+    player.inventory[emptySlot] = weapon;
+    
+    // Requirement 4.5: Weapon is already initialized with full magazine and reserve ammo
+    // (This is done in Weapon::create())
+    
+    std::cout << "[PURCHASE] Player " << player.id << " purchased " << weapon->name 
+              << " for $" << weapon->price << " in slot " << emptySlot 
+              << ". New balance: $" << player.money << std::endl;
+    
+    return true;
+}
+
+// Process ammo purchase request
+// Returns: true if purchase successful, false otherwise
+bool processAmmoPurchase(Player& player, AmmoType ammoType) {
+    // Create ammo item to get price and quantity
+    AmmoItem* ammo = AmmoItem::create(ammoType);
+    
+    // Validate player has sufficient money
+    if (player.money < ammo->price) {
+        std::cout << "[AMMO PURCHASE] Player " << player.id << " has insufficient funds: " 
+                  << player.money << " < " << ammo->price << std::endl;
+        delete ammo;
+        return false;
+    }
+    
+    // Find weapons that use this ammo type
+    bool hasCompatibleWeapon = false;
+    for (int i = 0; i < 4; i++) {
+        if (player.inventory[i] != nullptr) {
+            if (player.inventory[i]->getAmmoType() == ammoType) {
+                hasCompatibleWeapon = true;
+                break;
+            }
+        }
+    }
+    
+    if (!hasCompatibleWeapon) {
+        std::cout << "[AMMO PURCHASE] Player " << player.id << " has no weapon for " << ammo->name << std::endl;
+        delete ammo;
+        return false;
+    }
+    
+    // Deduct ammo price from player money
+    player.money -= ammo->price;
+    
+    // Add ammo to shared pool based on ammo type
+    switch (ammoType) {
+        case AmmoType::AMMO_9x18:
+            player.pistolAmmo += ammo->quantity;
+            break;
+        case AmmoType::AMMO_5_45x39:
+            player.rifleAmmo += ammo->quantity;
+            break;
+        case AmmoType::AMMO_7_62x54:
+            player.sniperAmmo += ammo->quantity;
+            break;
+    }
+    
+    std::cout << "[AMMO PURCHASE] Player " << player.id << " purchased " << ammo->name 
+              << " (" << ammo->quantity << " rounds) for $" << ammo->price 
+              << ". New balance: $" << player.money << std::endl;
+    
+    delete ammo;
+    return true;
+}
+
+// ========================
+// Shop UI Rendering System
+// ========================
+
+// PERFORMANCE: Retained-mode shop UI
+// The shop used to rebuild every sf::Text, formatted string and catalog
+// Weapon/AmmoItem each frame while open. ShopUILayer builds them once per
+// window size and font, at full scale, and per frame only:
+// - rewrites the money string when the balance changed
+// - rewrites a row's status string and panel colors when its status changed
+// - refades colors while the open animation runs
+// The open animation scales the whole layout about the panel centre with a
+// render transform instead of re-laying the text at every scale. Tooltip text
+// is built once per catalog entry, on first hover.
+class ShopUILayer {
+public:
+    // Render shop UI with four columns (three for weapons, one for ammo)
+    // Requirements: 3.2, 3.3, 3.4, 3.5
+    void render(sf::RenderWindow& window, const Player& player, const sf::Font& font, float animationProgress) {
+        sf::Vector2u windowSize = window.getSize();
+        if (font_ != &font || windowSize.x != windowSize_.x || windowSize.y != windowSize_.y) {
+            build(windowSize, font);
+        }
+        
+        // Smooth easing function (ease-out cubic)
+        float easedProgress = 1.0f - std::pow(1.0f - animationProgress, 3.0f);
+        
+        // Scale animation: 70% to 100% about the panel centre
+        float scale = 0.7f + easedProgress * 0.3f;
+        sf::Transform transform;
+        transform.translate(center_).scale(scale, scale).translate(-center_.x, -center_.y);
+        
+        if (easedProgress != fade_) {
+            fade_ = easedProgress;
+            applyFade();
+        }
+        
+        // Dynamic fields: money and per-row purchase status
+        if (player.money != shownMoney_) {
+            shownMoney_ = player.money;
+            money_.text.setString("Money: $" + std::to_string(player.money));
+        }
+        for (Column& column : columns_) {
+            for (CatalogRow& row : column.rows) {
+                int state = row.weapon ? static_cast<int>(calculatePurchaseStatus(player, row.weapon.get()))
+                                       : ammoState(player, *row.ammo);
+                if (state != row.shownState) {
+                    row.shownState = state;
+                    setRowState(row, state);
+                }
+            }
+        }
+        
+        // Hover test in layout space (undo the animation scale)
+        sf::Vector2i mousePixelPos = sf::Mouse::getPosition(window);
+        sf::Vector2f mouseLayout = transform.getInverse().transformPoint(
+            static_cast<float>(mousePixelPos.x), static_cast<float>(mousePixelPos.y));
+        CatalogRow* hoveredRow = nullptr;
+        
+        // Draw semi-transparent background overlay
+        window.draw(overlay_.shape);
+        
+        sf::RenderStates states(transform);
+        window.draw(panel_.shape, states);
+        window.draw(title_.text, states);
+        window.draw(money_.text, states);
+        
+        for (Column& column : columns_) {
+            window.draw(column.background.shape, states);
+            window.draw(column.title.text, states);
+            for (CatalogRow& row : column.rows) {
+                window.draw(row.panel.shape, states);
+                window.draw(row.name.text, states);
+                window.draw(row.price.text, states);
+                window.draw(row.details.text, states);
+                window.draw(row.status.text, states);
+                if (row.bounds.contains(mouseLayout)) {
+                    hoveredRow = &row;
+                }
+            }
+        }
+        
+        // Render tooltips at the very end to ensure they're on top of all other UI elements
+        if (hoveredRow != nullptr) {
+            if (!hoveredRow->tooltip) {
+                hoveredRow->tooltip = hoveredRow->weapon ? buildWeaponTooltip(*hoveredRow->weapon)
+                                                         : buildAmmoTooltip(*hoveredRow->ammo);
+            }
+            drawTooltip(window, *hoveredRow->tooltip,
+                        static_cast<float>(mousePixelPos.x), static_cast<float>(mousePixelPos.y));
+        }
+    }
+    
+private:
+    struct FadedText {
+        sf::Text text;
+        sf::Color color;    // Color when fully faded in
+    };
+    
+    struct FadedRect {
+        sf::RectangleShape shape;
+        sf::Color fill;     // Colors when fully faded in
+        sf::Color outline;
+    };
+    
+    // Tooltip geometry relative to its top-left corner
+    struct Tooltip {
+        sf::RectangleShape background;
+        sf::RectangleShape separator;
+        std::vector<sf::Text> texts;
+    };
+    
+    // One catalog entry: a weapon or an ammo type
+    struct CatalogRow {
+        std::unique_ptr<Weapon> weapon;
+        std::unique_ptr<AmmoItem> ammo;
+        FadedRect panel;
+        FadedText name;
+        FadedText price;
+        FadedText details;
+        FadedText status;
+        sf::FloatRect bounds;               // Panel rectangle at full scale
+        int shownState = -1;                // Status currently shown, -1 = none yet
+        std::unique_ptr<Tooltip> tooltip;   // Built on first hover
+    };
+    
+    struct Column {
+        FadedRect background;
+        FadedText title;
+        std::vector<CatalogRow> rows;
+    };
+    
+    // Lay the shop out at full scale for this window size
+    void build(sf::Vector2u windowSize, const sf::Font& font) {
+        font_ = &font;
+        windowSize_ = windowSize;
+        fade_ = -1.0f;
+        shownMoney_ = std::numeric_limits<int>::min();
+        
+        // Shop UI dimensions - increased width for 4 columns
+        const float UI_WIDTH = 1300.0f;
+        const float UI_HEIGHT = 700.0f;
+        const float UI_X = (windowSize.x - UI_WIDTH) / 2.0f;
+        const float UI_Y = (windowSize.y - UI_HEIGHT) / 2.0f;
+        center_ = sf::Vector2f(UI_X + UI_WIDTH / 2.0f, UI_Y + UI_HEIGHT / 2.0f);
+        
+        initRect(overlay_, sf::Vector2f(0.0f, 0.0f), sf::Vector2f(windowSize.x, windowSize.y),
+                 sf::Color(0, 0, 0, 180), sf::Color::Transparent, 0.0f);
+        initRect(panel_, sf::Vector2f(UI_X, UI_Y), sf::Vector2f(UI_WIDTH, UI_HEIGHT),
+                 sf::Color(40, 40, 40, 230), sf::Color(100, 100, 100), 3.0f);
+        
+        initText(title_, "WEAPON SHOP", 40, sf::Color(255, 255, 255), 0.0f, UI_Y + 20.0f);
+        centerText(title_.text, UI_X, UI_WIDTH);
+        initText(money_, "", 28, sf::Color(100, 255, 100), UI_X + 20.0f, UI_Y + 70.0f);
+        
+        // Column dimensions - now 4 columns
+        const float COLUMN_WIDTH = (UI_WIDTH - 100.0f) / 4.0f;
+        const float COLUMN_HEIGHT = UI_HEIGHT - 150.0f;
+        const float COLUMN_Y = UI_Y + 120.0f;
+        const float COLUMN_PADDING = 20.0f;
+        const float ROW_HEIGHT = 110.0f;
+        const float ROW_PADDING = 10.0f;
+        
+        // Requirement 3.3: Three weapon categories + one ammo category
+        struct WeaponCategory {
+            std::string name;
+            std::vector<Weapon::Type> weapons;
+        };
+        std::vector<WeaponCategory> categories = {
+            {"Pistols", {Weapon::USP, Weapon::GLOCK, Weapon::FIVESEVEN, Weapon::R8}},
+            {"Rifles", {Weapon::GALIL, Weapon::M4, Weapon::AK47}},
+            {"Snipers", {Weapon::M10, Weapon::AWP, Weapon::M40}}
+        };
+        std::vector<AmmoType> ammoTypes = {
+            AmmoType::AMMO_9x18,
+            AmmoType::AMMO_5_45x39,
+            AmmoType::AMMO_7_62x54
+        };
+        
+        for (size_t col = 0; col < columns_.size(); col++) {
+            Column& column = columns_[col];
+            column.rows.clear();
+            float columnX = UI_X + 20.0f + col * (COLUMN_WIDTH + COLUMN_PADDING);
+            initRect(column.background, sf::Vector2f(columnX, COLUMN_Y), sf::Vector2f(COLUMN_WIDTH, COLUMN_HEIGHT),
+                     sf::Color(30, 30, 30, 230), sf::Color(80, 80, 80), 2.0f);
+            initText(column.title, col < categories.size() ? categories[col].name : "Ammo", 26,
+                     sf::Color(255, 200, 100), 0.0f, COLUMN_Y + 10.0f);
+            centerText(column.title.text, columnX, COLUMN_WIDTH);
+            
+            size_t rowCount = col < categories.size() ? categories[col].weapons.size() : ammoTypes.size();
+            column.rows.resize(rowCount);
+            float rowY = COLUMN_Y + 50.0f;
+            for (size_t r = 0; r < rowCount; r++) {
+                CatalogRow& row = column.rows[r];
+                row.bounds = sf::FloatRect(columnX + 10.0f, rowY, COLUMN_WIDTH - 20.0f, ROW_HEIGHT);
+                initRect(row.panel, sf::Vector2f(row.bounds.left, row.bounds.top), sf::Vector2f(row.bounds.width, row.bounds.height),
+                         sf::Color(50, 50, 50, 230), sf::Color(100, 100, 100), 1.0f);
+                
+                float textX = columnX + 15.0f;
+                if (col < categories.size()) {
+                    // Requirement 3.4: Display weapon name, price, damage and magazine size
+                    row.weapon.reset(Weapon::create(categories[col].weapons[r]));
+                    const Weapon& weapon = *row.weapon;
+                    std::ostringstream statsStream;
+                    statsStream << "Damage: " << static_cast<int>(weapon.damage) << "\n";
+                    statsStream << "Magazine: " << weapon.magazineSize;
+                    initText(row.name, weapon.name, 20, sf::Color(255, 255, 255), textX, rowY + 5.0f);
+                    initText(row.price, "$" + std::to_string(weapon.price), 18, sf::Color(255, 215, 0), textX, rowY + 28.0f);
+                    initText(row.details, statsStream.str(), 16, sf::Color(200, 200, 200), textX, rowY + 50.0f);
+                    initText(row.status, "", 14, sf::Color::White, textX, rowY + 90.0f);
+                } else {
+                    row.ammo.reset(AmmoItem::create(ammoTypes[r]));
+                    const AmmoItem& ammo = *row.ammo;
+                    initText(row.name, ammo.name, 18, sf::Color(255, 255, 255), textX, rowY + 5.0f);
+                    initText(row.price, "$" + std::to_string(ammo.price), 18, sf::Color(255, 215, 0), textX, rowY + 28.0f);
+                    initText(row.details, "Quantity: " + std::to_string(ammo.quantity), 16, sf::Color(200, 200, 200), textX, rowY + 50.0f);
+                    initText(row.status, "", 14, sf::Color::White, textX, rowY + 75.0f);
+                }
+                rowY += ROW_HEIGHT + ROW_PADDING;
+            }
+        }
+    }
+    
+    // Ammo row status: 0 can purchase, 1 no compatible weapon, 2 insufficient funds
+    static int ammoState(const Player& player, const AmmoItem& ammo) {
+        bool hasCompatibleWeapon = false;
+        for (int i = 0; i < 4; i++) {
+            if (player.inventory[i] != nullptr && player.inventory[i]->getAmmoType() == ammo.type) {
+                hasCompatibleWeapon = true;
+                break;
+            }
+        }
+        if (!hasCompatibleWeapon) return 1;
+        if (player.money < ammo.price) return 2;
+        return 0;
+    }
+    
+    // Requirement 3.5: Show purchase status (text, text color, panel tint)
+    void setRowState(CatalogRow& row, int state) {
+        bool purchasable;
+        if (row.weapon) {
+            PurchaseStatus status = static_cast<PurchaseStatus>(state);
+            purchasable = (status == PurchaseStatus::Purchasable);
+            row.status.text.setString(getPurchaseStatusText(status, row.weapon->price));
+            row.status.color = getPurchaseStatusColor(status);
+        } else {
+            purchasable = (state == 0);
+            row.status.text.setString(state == 1 ? "No compatible weapon" : state == 2 ? "Insufficient funds" : "Can purchase");
+            row.status.color = purchasable ? sf::Color(100, 255, 100) : sf::Color(255, 100, 100);
+        }
+        
+        if (purchasable) {
+            row.panel.fill = sf::Color(50, 70, 50, 230);      // Green tint
+            row.panel.outline = sf::Color(100, 200, 100);
+        } else {
+            row.panel.fill = sf::Color(50, 50, 50, 230);      // Gray
+            row.panel.outline = sf::Color(100, 100, 100);
+        }
+        fadeText(row.status);
+        fadeRect(row.panel);
+    }
+    
+    void applyFade() {
+        fadeRect(overlay_);
+        fadeRect(panel_);
+        fadeText(title_);
+        fadeText(money_);
+        for (Column& column : columns_) {
+            fadeRect(column.background);
+            fadeText(column.title);
+            for (CatalogRow& row : column.rows) {
+                fadeRect(row.panel);
+                fadeText(row.name);
+                fadeText(row.price);
+                fadeText(row.details);
+                fadeText(row.status);
+            }
+        }
+    }
+    
+    sf::Color faded(sf::Color color) const {
+        return sf::Color(color.r, color.g, color.b, static_cast<sf::Uint8>(fade_ * color.a));
+    }
+    
+    void fadeText(FadedText& text) const {
+        text.text.setFillColor(faded(text.color));
+    }
+    
+    void fadeRect(FadedRect& rect) const {
+        rect.shape.setFillColor(faded(rect.fill));
+        rect.shape.setOutlineColor(faded(rect.outline));
+    }
+    
+    void initText(FadedText& text, const std::string& string, unsigned int size, sf::Color color, float x, float y) const {
+        text.text.setFont(*font_);
+        text.text.setString(string);
+        text.text.setCharacterSize(size);
+        text.text.setPosition(x, y);
+        text.color = color;
+    }
+    
+    static void initRect(FadedRect& rect, sf::Vector2f position, sf::Vector2f size,
+                         sf::Color fill, sf::Color outline, float outlineThickness) {
+        rect.shape.setSize(size);
+        rect.shape.setPosition(position);
+        rect.shape.setOutlineThickness(outlineThickness);
+        rect.fill = fill;
+        rect.outline = outline;
+    }
+    
+    // Center horizontally within [left, left + width]
+    static void centerText(sf::Text& text, float left, float width) {
+        sf::FloatRect bounds = text.getLocalBounds();
+        text.setPosition(left + (width - bounds.width) / 2.0f - bounds.left, text.getPosition().y);
+    }
+    
+    // Tooltip layouts: built once per catalog entry at the origin, drawn translated
+    std::unique_ptr<Tooltip> newTooltip(float width, float height) const {
+        const float PADDING = 15.0f;
+        std::unique_ptr<Tooltip> tooltip(new Tooltip());
+        tooltip->background.setSize(sf::Vector2f(width, height));
+        tooltip->background.setFillColor(sf::Color(20, 20, 20, 240));
+        tooltip->background.setOutlineColor(sf::Color(255, 215, 0));  // Gold border
+        tooltip->background.setOutlineThickness(2.0f);
+        tooltip->separator.setSize(sf::Vector2f(width - 2 * PADDING, 1.0f));
+        tooltip->separator.setPosition(PADDING, PADDING + 65.0f);
+        tooltip->separator.setFillColor(sf::Color(100, 100, 100));
+        return tooltip;
+    }
+    
+    void addTooltipText(Tooltip& tooltip, const std::string& string, unsigned int size, sf::Color color,
+                        float x, float y, bool bold = false) const {
+        sf::Text text;
+        text.setFont(*font_);
+        text.setString(string);
+        text.setCharacterSize(size);
+        text.setFillColor(color);
+        if (bold) text.setStyle(sf::Text::Bold);
+        text.setPosition(x, y);
+        tooltip.texts.push_back(text);
+    }
+    
+    // Weapon tooltip with full stats
+    std::unique_ptr<Tooltip> buildWeaponTooltip(const Weapon& weapon) const {
+        const float PADDING = 15.0f;
+        std::unique_ptr<Tooltip> tooltip = newTooltip(320.0f, 290.0f);
+        addTooltipText(*tooltip, weapon.name, 24, sf::Color(255, 215, 0), PADDING, PADDING, true);
+        addTooltipText(*tooltip, "Price: $" + std::to_string(weapon.price), 20, sf::Color(100, 255, 100), PADDING, PADDING + 35.0f);
+        
+        // Stats - format floats properly
+        std::ostringstream reloadStream, moveStream;
+        reloadStream << std::fixed << std::setprecision(1) << weapon.reloadTime;
+        moveStream << std::fixed << std::setprecision(1) << weapon.movementSpeed;
+        
+        std::vector<std::pair<std::string, std::string>> stats = {
+            {"Damage:", std::to_string(static_cast<int>(weapon.damage))},
+            {"Magazine:", std::to_string(weapon.magazineSize)},
+            {"Range:", std::to_string(static_cast<int>(weapon.range)) + " px"},
+            {"Bullet Speed:", std::to_string(static_cast<int>(weapon.bulletSpeed)) + " px/s"},
+            {"Reload Time:", reloadStream.str() + " s"},
+            {"Movement Speed:", moveStream.str()},
+            {"Fire Mode:", weapon.isAutomatic() ? "Automatic (" + std::to_string(static_cast<int>(weapon.fireRate)) + " rps)" : "Semi-Auto"}
+        };
+        
+        float textY = PADDING + 75.0f;
+        for (const auto& stat : stats) {
+            addTooltipText(*tooltip, stat.first, 16, sf::Color(200, 200, 200), PADDING, textY);
+            addTooltipText(*tooltip, stat.second, 16, sf::Color::White, PADDING + 150.0f, textY, true);
+            textY += 22.0f;
+        }
+        return tooltip;
+    }
+    
+    // Ammo tooltip with full information
+    std::unique_ptr<Tooltip> buildAmmoTooltip(const AmmoItem& ammo) const {
+        const float PADDING = 15.0f;
+        std::unique_ptr<Tooltip> tooltip = newTooltip(320.0f, 220.0f);
+        addTooltipText(*tooltip, ammo.name, 24, sf::Color(255, 215, 0), PADDING, PADDING, true);
+        addTooltipText(*tooltip, "Price: $" + std::to_string(ammo.price), 20, sf::Color(100, 255, 100), PADDING, PADDING + 35.0f);
+        addTooltipText(*tooltip, "Quantity: " + std::to_string(ammo.quantity) + " rounds", 18, sf::Color::White, PADDING, PADDING + 75.0f);
+        addTooltipText(*tooltip, "Compatible with:", 18, sf::Color(200, 200, 200), PADDING, PADDING + 105.0f);
+        
+        // List compatible weapon types
+        std::string weaponList;
+        switch (ammo.type) {
+            case AmmoType::AMMO_9x18:
+                weaponList = "-> Pistols:\n  USP, Glock-18,\n  Five-SeveN, R8 Revolver";
+                break;
+            case AmmoType::AMMO_5_45x39:
+                weaponList = "-> Rifles:\n  Galil AR, M4, AK-47";
+                break;
+            case AmmoType::AMMO_7_62x54:
+                weaponList = "-> Sniper Rifles:\n  M10, AWP, M40";
+                break;
+        }
+        addTooltipText(*tooltip, weaponList, 16, sf::Color(150, 200, 255), PADDING, PADDING + 130.0f);  // Light blue
+        return tooltip;
+    }
+    
+    // Position tooltip near mouse, but keep it on screen
+    void drawTooltip(sf::RenderWindow& window, const Tooltip& tooltip, float mouseX, float mouseY) const {
+        // Reserve space for UI elements at bottom (150px for "Press B" and "E - inventory")
+        const float BOTTOM_UI_RESERVE = 150.0f;
+        sf::Vector2f size = tooltip.background.getSize();
+        
+        float tooltipX = mouseX + 20.0f;
+        float tooltipY = mouseY + 20.0f;
+        
+        // Adjust if tooltip goes off screen
+        if (tooltipX + size.x > windowSize_.x - 10.0f) {
+            tooltipX = mouseX - size.x - 20.0f;
+        }
+        if (tooltipY + size.y > windowSize_.y - BOTTOM_UI_RESERVE) {
+            // Position above cursor if would overlap bottom UI
+            tooltipY = mouseY - size.y - 20.0f;
+        }
+        if (tooltipX < 10.0f) tooltipX = 10.0f;
+        if (tooltipY < 10.0f) tooltipY = 10.0f;
+        
+        sf::RenderStates states;
+        states.transform.translate(tooltipX, tooltipY);
+        window.draw(tooltip.background, states);
+        window.draw(tooltip.separator, states);
+        for (const sf::Text& text : tooltip.texts) {
+            window.draw(text, states);
+        }
+    }
+    
+    const sf::Font* font_ = nullptr;
+    sf::Vector2u windowSize_;
+    sf::Vector2f center_;                // Panel centre, the animation's scale origin
+    float fade_ = -1.0f;                 // easedProgress the colors were faded to
+    int shownMoney_ = 0;
+    FadedRect overlay_;
+    FadedRect panel_;
+    FadedText title_;
+    FadedText money_;
+    std::array<Column, 4> columns_;      // Pistols, Rifles, Snipers, Ammo
+};
+
+// Global shop UI layer (render thread only)
+ShopUILayer g_shopUI;
+
+// Render shop UI with four columns (three for weapons, one for ammo)
+// Requirements: 3.2, 3.3, 3.4, 3.5
+void renderShopUI(sf::RenderWindow& window, const Player& player, const sf::Font& font, float animationProgress) {
+    g_shopUI.render(window, player, font, animationProgress);
+}
+
+// Check if player is near any shop and render interaction prompt
+// Requirement 3.1: Display prompt when player within 60 pixels
+void renderShopInteractionPrompt(sf::RenderWindow& window, sf::Vector2f playerPosition, 
+                                 const std::vector<Shop>& shops, const sf::Font& font, bool shopUIOpen) {
+    const float INTERACTION_RANGE = 60.0f;  // 60 pixels interaction range
+    
+    // Check if player is near any shop
+    bool nearShop = false;
+    for (const auto& shop : shops) {
+        if (shop.isPlayerNear(playerPosition.x, playerPosition.y)) {
+            nearShop = true;
+            break;
+        }
+    }
+    
+    // Display prompt based on shop state
+    if (nearShop || shopUIOpen) {
+        // Get window size for UI positioning
+        sf::Vector2u windowSize = window.getSize();
+        
+        // Create prompt text
+        sf::Text promptText;
+        promptText.setFont(font);
+        // Show different text based on shop state
+        promptText.setString(shopUIOpen ? "Press B to close" : "Press B to purchase");
+        promptText.setCharacterSize(28);
+        promptText.setFillColor(sf::Color::White);
+        promptText.setOutlineColor(sf::Color::Black);
+        promptText.setOutlineThickness(2.0f);
+        
+        // Position at bottom center of screen
+        sf::FloatRect textBounds = promptText.getLocalBounds();
+        promptText.setPosition(
+            windowSize.x / 2.0f - textBounds.width / 2.0f - textBounds.left,
+            windowSize.y - 120.0f  // 120px from bottom (above inventory hint)
+        );
+        
+        window.draw(promptText);
+    }
+}
+
+// Render shops with fog of war integration
+// Requirements: 2.6, 3.1, 10.5
+void renderShops(sf::RenderWindow& window, sf::Vector2f playerPosition, const std::vector<Shop>& shops) {
+    const float SHOP_SIZE = 20.0f;  // 20×20 pixel red square
+    const sf::Color shopColor(255, 0, 0);  // Red color for shops
+    
+    for (const auto& shop : shops) {
+        // Calculate distance from player to shop center
+        float dx = shop.worldX - playerPosition.x;
+        float dy = shop.worldY - playerPosition.y;
+        float distance = std::sqrt(dx * dx + dy * dy);
+        
+        // Calculate fog alpha (same as other entities for consistency)
+        // Requirement 10.5: Fog of war consistency for shops
+        sf::Uint8 alpha = calculateFogAlpha(distance);
+        
+        // Only render if visible (alpha > 0)
+        if (alpha > 0) {
+            // Create shop visual as 20×20 red square
+            // Requirement 2.6: Render each shop as 20×20 red square at grid cell center
+            sf::RectangleShape shopRect(sf::Vector2f(SHOP_SIZE, SHOP_SIZE));
+            
+            // Position at grid cell center (worldX and worldY are already at center)
+            // Offset by half the shop size to center the square
+            shopRect.setPosition(shop.worldX - SHOP_SIZE / 2.0f, shop.worldY - SHOP_SIZE / 2.0f);
+            
+            // Apply fog to shop color
+            sf::Color foggedColor(shopColor.r, shopColor.g, shopColor.b, alpha);
+            shopRect.setFillColor(foggedColor);
+            
+            window.draw(shopRect);
+        }
+    }
+}
+
+// ========================
+// PERFORMANCE: Cached Fog Meshes
+// ========================
+
+// ALGORITHM:
+// The fogged background and the fog overlay are grids of flat-colored squares
+// whose alpha depends only on the distance from the square's centre to the
+// player. Each layer is kept as one sf::VertexArray of world-aligned quads:
+// - Quad positions are laid out only when the view crosses a chunk boundary
+//   (the covered column/row range changes)
+// - When the player moves, the fog band of every quad is recomputed and only
+//   quads whose band changed get their 4 vertex colors rewritten
+// - A frame draws each layer with a single call
+//
+// PERFORMANCE:
+// Replaces building and drawing one sf::RectangleShape per chunk every frame
+// (~1400 background + ~250 overlay shapes at 1920x1080) with two draw calls.
+class FogMesh {
+public:
+    // darken: false = color fades out with distance (background),
+    //         true = black fades in with distance (overlay)
+    FogMesh(float chunkSize, sf::Color color, bool darken)
+        : chunkSize_(chunkSize), color_(color), darken_(darken) {
+        vertices_.setPrimitiveType(sf::Quads);
+    }
+    
+    // Bring the mesh up to date for the world region [minX, maxX) x [minY, maxY)
+    // and the player's position. Returns the number of quads recolored.
+    size_t update(float minX, float minY, float maxX, float maxY, sf::Vector2f playerPosition) {
+        int firstCol = static_cast<int>(std::floor(minX / chunkSize_));
+        int firstRow = static_cast<int>(std::floor(minY / chunkSize_));
+        int cols = std::max(0, static_cast<int>(std::ceil(maxX / chunkSize_)) - firstCol);
+        int rows = std::max(0, static_cast<int>(std::ceil(maxY / chunkSize_)) - firstRow);
+        
+        bool relaid = false;
+        if (firstCol != firstCol_ || firstRow != firstRow_ || cols != cols_ || rows != rows_) {
+            layout(firstCol, firstRow, cols, rows);
+            relaid = true;
+        }
+        
+        if (!relaid && playerPosition.x == lastPlayerPos_.x && playerPosition.y == lastPlayerPos_.y) {
+            return 0;
+        }
+        lastPlayerPos_ = playerPosition;
+        
+        size_t recolored = 0;
+        for (int c = 0; c < cols_; c++) {
+            float dx = (firstCol_ + c + 0.5f) * chunkSize_ - playerPosition.x;
+            for (int r = 0; r < rows_; r++) {
+                float dy = (firstRow_ + r + 0.5f) * chunkSize_ - playerPosition.y;
+                sf::Uint8 alpha = calculateFogAlpha(std::sqrt(dx * dx + dy * dy));
+                
+                size_t quad = static_cast<size_t>(c) * rows_ + r;
+                if (!relaid && alpha == quadAlpha_[quad]) continue;
+                quadAlpha_[quad] = alpha;
+                
+                sf::Color fogged(color_.r, color_.g, color_.b, darken_ ? 255 - alpha : alpha);
+                for (size_t v = quad * 4; v < quad * 4 + 4; v++) {
+                    vertices_[v].color = fogged;
+                }
+                recolored++;
+            }
+        }
+        return recolored;
+    }
+    
+    void draw(sf::RenderTarget& target) const {
+        target.draw(vertices_);
+    }
+    
+private:
+    // Lay out cols x rows quads starting at chunk (firstCol, firstRow)
+    void layout(int firstCol, int firstRow, int cols, int rows) {
+        firstCol_ = firstCol;
+        firstRow_ = firstRow;
+        cols_ = cols;
+        rows_ = rows;
+        vertices_.resize(static_cast<size_t>(cols) * rows * 4);
+        quadAlpha_.assign(static_cast<size_t>(cols) * rows, 0);
+        
+        for (int c = 0; c < cols; c++) {
+            float left = (firstCol + c) * chunkSize_;
+            for (int r = 0; r < rows; r++) {
+                float top = (firstRow + r) * chunkSize_;
+                size_t v = (static_cast<size_t>(c) * rows + r) * 4;
+                vertices_[v].position = sf::Vector2f(left, top);
+                vertices_[v + 1].position = sf::Vector2f(left + chunkSize_, top);
+                vertices_[v + 2].position = sf::Vector2f(left + chunkSize_, top + chunkSize_);
+                vertices_[v + 3].position = sf::Vector2f(left, top + chunkSize_);
+            }
+        }
+    }
+    
+    float chunkSize_;
+    sf::Color color_;
+    bool darken_;
+    sf::VertexArray vertices_;
+    std::vector<sf::Uint8> quadAlpha_;   // calculateFogAlpha value each quad shows
+    int firstCol_ = 0;
+    int firstRow_ = 0;
+    int cols_ = -1;                      // -1: nothing laid out yet
+    int rows_ = -1;
+    sf::Vector2f lastPlayerPos_;
+};
+
+// Global fog meshes (render thread only)
+FogMesh g_fogBackground(50.0f, sf::Color(136, 101, 56), false);  // Base background color
+FogMesh g_fogOverlay(100.0f, sf::Color(0, 0, 0), true);          // Black vignette
+
+// Render background with smooth fog of war gradient effect
+// The background gets darker the further it is from the player (50x50 chunks
+// of the cached g_fogBackground mesh)
+void renderFoggedBackground(sf::RenderWindow& window, sf::Vector2f playerPosition) {
+    // Get current view to determine visible area
+    sf::View currentView = window.getView();
+    sf::Vector2f viewCenter = currentView.getCenter();
+    sf::Vector2f viewSize = currentView.getSize();
+    
+    // Calculate visible world bounds with padding
+    float padding = 200.0f;
+    float minX = std::max(0.0f, viewCenter.x - viewSize.x / 2.0f - padding);
+    float maxX = std::min(MAP_SIZE, viewCenter.x + viewSize.x / 2.0f + padding);
+    float minY = std::max(0.0f, viewCenter.y - viewSize.y / 2.0f - padding);
+    float maxY = std::min(MAP_SIZE, viewCenter.y + viewSize.y / 2.0f + padding);
+    
+    g_fogBackground.update(minX, minY, maxX, maxY, playerPosition);
+    g_fogBackground.draw(window);
+}
+
+// ========================
+// NEW: Fog Overlay Effect
+// ========================
+
+// Render fog overlay that darkens everything far from player
+// This creates a smooth vignette effect (100x100 chunks of the cached
+// g_fogOverlay mesh)
+void renderFogOverlay(sf::RenderWindow& window, sf::Vector2f playerPosition) {
+    // Get current view
+    sf::View currentView = window.getView();
+    sf::Vector2f viewCenter = currentView.getCenter();
+    sf::Vector2f viewSize = currentView.getSize();
+    
+    // Calculate visible world bounds
+    float minX = viewCenter.x - viewSize.x / 2.0f;
+    float maxX = viewCenter.x + viewSize.x / 2.0f;
+    float minY = viewCenter.y - viewSize.y / 2.0f;
+    float maxY = viewCenter.y + viewSize.y / 2.0f;
+    
+    g_fogOverlay.update(minX, minY, maxX, maxY, playerPosition);
+    g_fogOverlay.draw(window);
+}
+
+// ========================
+// PERFORMANCE: Batched Wall Rendering
+// ========================
+
+// ALGORITHM:
+// Walls never move once the map exists, so they are baked a single time into
+// static vertex buffers, one per WALL_CHUNK_CELLS x WALL_CHUNK_CELLS block of
+// cells. Each wall becomes the same rounded rectangle createRoundedRectangle
+// builds, triangulated as a fan. A frame then draws one buffer per chunk that
+// overlaps the view instead of one ConvexShape per wall.
+//
+// FOG TINT:
+// Every vertex carries the centre of its wall in texCoords. The vertex shader
+// measures the distance from that centre to the player and picks the same
+// band as calculateFogAlpha, so a wall keeps a single tint exactly as before.
+// Without shader or vertex buffer support the chunks stay plain vertex arrays
+// and the alpha is rewritten on the CPU, only for walls whose band changed.
+//
+// PERFORMANCE:
+// A 1920x1080 view overlaps about a dozen chunks, so several hundred draw
+// calls per frame become at most a dozen; chunks beyond FOG_RANGE_4 are
+// skipped outright.
+const int WALL_CHUNK_CELLS = 8;
+const int WALL_CHUNKS_PER_SIDE = (GRID_SIZE + WALL_CHUNK_CELLS - 1) / WALL_CHUNK_CELLS;
+const float WALL_CORNER_RADIUS = 3.0f;
+const unsigned int WALL_CORNER_POINTS = 8;
+const size_t WALL_VERTEX_COUNT = (WALL_CORNER_POINTS * 4 - 2) * 3;
+
+const char* const WALL_FOG_VERTEX_SHADER =
+    "uniform vec2 player;\n"
+    "uniform vec4 fogRanges;\n"
+    "void main() {\n"
+    "    gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;\n"
+    "    float d = distance(gl_MultiTexCoord0.xy, player);\n"
+    "    float a = d <= fogRanges.x ? 1.0 : d <= fogRanges.y ? 0.6 : d <= fogRanges.z ? 0.4 : d <= fogRanges.w ? 0.2 : 0.0;\n"
+    "    gl_FrontColor = vec4(gl_Color.rgb, a);\n"
+    "}\n";
+
+const char* const WALL_FOG_FRAGMENT_SHADER =
+    "void main() {\n"
+    "    gl_FragColor = gl_Color;\n"
+    "}\n";
+
+class WallRenderer {
+public:
+    // Drop the baked chunks; they are rebuilt from the grid on the next draw
+    void invalidate() { built_ = false; }
+    
+    // Draw every chunk that overlaps [minX, maxX] x [minY, maxY] and has walls
+    // within fog range of the player. Must run on the thread that owns the GL
+    // context. Returns the number of draw calls issued.
+    int draw(sf::RenderTarget& target, sf::Vector2f playerPosition,
+             const CellGrid& grid,
+             float minX, float minY, float maxX, float maxY) {
+        if (!built_) {
+            build(grid);
+        }
+        
+        if (useShader_) {
+            fogShader_->setUniform("player", sf::Glsl::Vec2(playerPosition));
+        }
+        
+        int drawCalls = 0;
+        for (Chunk& chunk : chunks_) {
+            if (chunk.wallCount == 0) continue;
+            
+            // View culling: wall geometry reaches WALL_WIDTH / 2 past the cells
+            const float reach = WALL_WIDTH / 2.0f;
+            if (chunk.maxX + reach < minX || chunk.minX - reach > maxX ||
+                chunk.maxY + reach < minY || chunk.minY - reach > maxY) {
+                continue;
+            }
+            
+            // Fog culling: every wall centre lies inside the chunk's cells
+            float dx = std::max({chunk.minX - playerPosition.x, 0.0f, playerPosition.x - chunk.maxX});
+            float dy = std::max({chunk.minY - playerPosition.y, 0.0f, playerPosition.y - chunk.maxY});
+            if (dx * dx + dy * dy > FOG_RANGE_4 * FOG_RANGE_4) continue;
+            
+            if (useShader_) {
+                target.draw(chunk.buffer, fogShader_.get());
+            } else {
+                applyCpuFog(chunk, playerPosition);
+                target.draw(chunk.vertices.data(), chunk.vertices.size(), sf::Triangles);
+            }
+            drawCalls++;
+        }
+        return drawCalls;
+    }
+    
+private:
+    struct Chunk {
+        float minX = 0.0f, minY = 0.0f, maxX = 0.0f, maxY = 0.0f;  // World bounds of the chunk's cells
+        size_t wallCount = 0;
+        std::vector<sf::Vertex> vertices;    // Kept only for the CPU fallback
+        std::vector<sf::Uint8> wallAlpha;    // CPU fallback: alpha each wall was last tinted with
+        sf::VertexBuffer buffer{sf::Triangles, sf::VertexBuffer::Static};
+    };
+    
+    void build(const CellGrid& grid) {
+        built_ = true;
+        
+        if (!shaderLoaded_ && sf::Shader::isAvailable() && sf::VertexBuffer::isAvailable()) {
+            shaderLoaded_ = true;
+            fogShader_ = std::make_unique<sf::Shader>();
+            shaderUsable_ = fogShader_->loadFromMemory(WALL_FOG_VERTEX_SHADER, WALL_FOG_FRAGMENT_SHADER);
+            if (shaderUsable_) {
+                fogShader_->setUniform("fogRanges", sf::Glsl::Vec4(FOG_RANGE_1, FOG_RANGE_2, FOG_RANGE_3, FOG_RANGE_4));
+            }
+        }
+        useShader_ = shaderUsable_;
+        
+        sf::ConvexShape horizontalWall = createRoundedRectangle(sf::Vector2f(WALL_LENGTH, WALL_WIDTH), WALL_CORNER_RADIUS, WALL_CORNER_POINTS);
+        sf::ConvexShape verticalWall = createRoundedRectangle(sf::Vector2f(WALL_WIDTH, WALL_LENGTH), WALL_CORNER_RADIUS, WALL_CORNER_POINTS);
+        
+        chunks_.assign(WALL_CHUNKS_PER_SIDE * WALL_CHUNKS_PER_SIDE, Chunk());
+        size_t totalWalls = 0;
+        
+        for (int cx = 0; cx < WALL_CHUNKS_PER_SIDE; cx++) {
+            for (int cy = 0; cy < WALL_CHUNKS_PER_SIDE; cy++) {
+                Chunk& chunk = chunks_[cx * WALL_CHUNKS_PER_SIDE + cy];
+                int startX = cx * WALL_CHUNK_CELLS;
+                int startY = cy * WALL_CHUNK_CELLS;
+                int endX = std::min(GRID_SIZE, startX + WALL_CHUNK_CELLS);
+                int endY = std::min(GRID_SIZE, startY + WALL_CHUNK_CELLS);
+                chunk.minX = startX * CELL_SIZE;
+                chunk.minY = startY * CELL_SIZE;
+                chunk.maxX = endX * CELL_SIZE;
+                chunk.maxY = endY * CELL_SIZE;
+                
+                // Same placement as the per-wall renderer. Each edge is baked once,
+                // by the chunk owning the cell below / right of it; the chunks on
+                // the far sides of the map also take the edges along the map border
+                const int edgeEndX = (endX == GRID_SIZE) ? GRID_SIZE + 1 : endX;
+                const int edgeEndY = (endY == GRID_SIZE) ? GRID_SIZE + 1 : endY;
+                for (int i = startX; i < endX; i++) {
+                    for (int j = startY; j < edgeEndY; j++) {
+                        float x = i * CELL_SIZE;
+                        float y = j * CELL_SIZE;
+                        bakeWall(chunk, horizontalWall, grid.horizontal(i, j),
+                                 sf::Vector2f(x, y - WALL_WIDTH / 2.0f), sf::Vector2f(x + WALL_LENGTH / 2.0f, y));
+                    }
+                }
+                for (int i = startX; i < edgeEndX; i++) {
+                    for (int j = startY; j < endY; j++) {
+                        float x = i * CELL_SIZE;
+                        float y = j * CELL_SIZE;
+                        bakeWall(chunk, verticalWall, grid.vertical(i, j),
+                                 sf::Vector2f(x - WALL_WIDTH / 2.0f, y), sf::Vector2f(x, y + WALL_LENGTH / 2.0f));
+                    }
+                }
+                totalWalls += chunk.wallCount;
+                
+                if (useShader_ && chunk.wallCount > 0) {
+                    if (chunk.buffer.create(chunk.vertices.size()) && chunk.buffer.update(chunk.vertices.data())) {
+                        std::vector<sf::Vertex>().swap(chunk.vertices);
+                    } else {
+                        useShader_ = false;
+                    }
+                }
+            }
+        }
+        
+        // A failed upload leaves some chunks without a CPU copy: rebake them all
+        if (shaderUsable_ && !useShader_) {
+            shaderUsable_ = false;
+            build(grid);
+            return;
+        }
+        
+        for (Chunk& chunk : chunks_) {
+            chunk.wallAlpha.assign(chunk.wallCount, 255);
+        }
+        
+        std::cout << "[INFO] Walls baked: " << totalWalls << " walls in " << chunks_.size()
+                  << " chunks (" << (useShader_ ? "shader fog tint" : "CPU fog tint") << ")" << std::endl;
+    }
+    
+    // Append one wall as a triangle fan over the rounded rectangle's outline
+    static void bakeWall(Chunk& chunk, const sf::ConvexShape& shape, WallType type,
+                         sf::Vector2f position, sf::Vector2f center) {
+        if (type == WallType::None) return;
+        
+        sf::Color color = (type == WallType::Concrete) ? sf::Color(150, 150, 150) : sf::Color(139, 90, 43);
+        size_t pointCount = shape.getPointCount();
+        sf::Vector2f first = position + shape.getPoint(0);
+        for (size_t k = 1; k + 1 < pointCount; k++) {
+            chunk.vertices.push_back(sf::Vertex(first, color, center));
+            chunk.vertices.push_back(sf::Vertex(position + shape.getPoint(k), color, center));
+            chunk.vertices.push_back(sf::Vertex(position + shape.getPoint(k + 1), color, center));
+        }
+        chunk.wallCount++;
+    }
+    
+    // CPU fallback: retint only the walls whose fog band changed
+    static void applyCpuFog(Chunk& chunk, sf::Vector2f playerPosition) {
+        for (size_t w = 0; w < chunk.wallCount; w++) {
+            sf::Vertex* wall = &chunk.vertices[w * WALL_VERTEX_COUNT];
+            float dx = wall->texCoords.x - playerPosition.x;
+            float dy = wall->texCoords.y - playerPosition.y;
+            sf::Uint8 alpha = calculateFogAlpha(std::sqrt(dx * dx + dy * dy));
+            if (alpha == chunk.wallAlpha[w]) continue;
+            
+            chunk.wallAlpha[w] = alpha;
+            for (size_t v = 0; v < WALL_VERTEX_COUNT; v++) {
+                wall[v].color.a = alpha;
+            }
+        }
+    }
+    
+    std::vector<Chunk> chunks_;
+    std::unique_ptr<sf::Shader> fogShader_;  // Created lazily: needs a GL context
+    bool shaderLoaded_ = false;
+    bool shaderUsable_ = false;
+    bool useShader_ = false;
+    bool built_ = false;
+};
+
+// Global batched wall renderer (render thread only)
+WallRenderer g_wallRenderer;
+
+// VISIBLE RANGE:
+// We calculate the visible area from the camera view and add 2 cells of padding
+// to prevent walls from popping in/out at screen edges.
+//
+// WALL POSITIONING:
+// Walls are centered on cell boundaries to ensure they align properly:
+// - A 12-pixel wide wall on a boundary extends 6 pixels into each adjacent cell
+// - This is why WallRenderer bakes them at position - WALL_WIDTH/2
+void renderVisibleWalls(sf::RenderWindow& window, sf::Vector2f playerPosition, const CellGrid& grid) {
+    // Get current view to determine visible area
+    sf::View currentView = window.getView();
+    sf::Vector2f viewCenter = currentView.getCenter();
+    sf::Vector2f viewSize = currentView.getSize();
+    
+    // Calculate visible world bounds with padding
+    float padding = CELL_SIZE * 2.0f; // 2 cells padding to avoid pop-in
+    float minX = viewCenter.x - viewSize.x / 2.0f - padding;
+    float maxX = viewCenter.x + viewSize.x / 2.0f + padding;
+    float minY = viewCenter.y - viewSize.y / 2.0f - padding;
+    float maxY = viewCenter.y + viewSize.y / 2.0f + padding;
+    
+    // One draw call per visible chunk of baked walls
+    #ifdef _DEBUG
+    int drawCalls = g_wallRenderer.draw(window, playerPosition, grid, minX, minY, maxX, maxY);
+    // Debug output in debug builds only
+    std::cout << "Wall chunks drawn: " << drawCalls << std::endl;
+    #else
+    g_wallRenderer.draw(window, playerPosition, grid, minX, minY, maxX, maxY);
+    #endif
+}
+
+// ========================
+// NEW: Cell-Based Collision System with Sliding
+// ========================
+
+// Helper function to check if a position collides with walls
+bool checkCollision(sf::Vector2f pos, const CellGrid& grid) {
+    sf::FloatRect playerRect(
+        pos.x - PLAYER_SIZE / 2.0f,
+        pos.y - PLAYER_SIZE / 2.0f,
+        PLAYER_SIZE,
+        PLAYER_SIZE
+    );
+    
+    // Only the edges whose wall can overlap the player are tested: horizontal edges
+    // on the lines within WALL_WIDTH/2 of the player's top..bottom, vertical edges on
+    // the lines within WALL_WIDTH/2 of its left..right; usually one or two of each
+    const float half = WALL_WIDTH / 2.0f;
+    const float right = playerRect.left + playerRect.width;
+    const float bottom = playerRect.top + playerRect.height;
+    const int cellMinX = static_cast<int>(std::floor(playerRect.left / CELL_SIZE));
+    const int cellMaxX = static_cast<int>(std::floor(right / CELL_SIZE));
+    const int cellMinY = static_cast<int>(std::floor(playerRect.top / CELL_SIZE));
+    const int cellMaxY = static_cast<int>(std::floor(bottom / CELL_SIZE));
+    
+    const int lineMinY = static_cast<int>(std::ceil((playerRect.top - half) / CELL_SIZE));
+    const int lineMaxY = static_cast<int>(std::floor((bottom + half) / CELL_SIZE));
+    for (int j = lineMinY; j <= lineMaxY; j++) {
+        for (int i = cellMinX; i <= cellMaxX; i++) {
+            if (grid.horizontal(i, j) != WallType::None) {
+                sf::FloatRect wallRect(i * CELL_SIZE, j * CELL_SIZE - half, WALL_LENGTH, WALL_WIDTH);
+                if (playerRect.intersects(wallRect)) return true;
+            }
+        }
+    }
+    
+    const int lineMinX = static_cast<int>(std::ceil((playerRect.left - half) / CELL_SIZE));
+    const int lineMaxX = static_cast<int>(std::floor((right + half) / CELL_SIZE));
+    for (int i = lineMinX; i <= lineMaxX; i++) {
+        for (int j = cellMinY; j <= cellMaxY; j++) {
+            if (grid.vertical(i, j) != WallType::None) {
+                sf::FloatRect wallRect(i * CELL_SIZE - half, j * CELL_SIZE, WALL_WIDTH, WALL_LENGTH);
+                if (playerRect.intersects(wallRect)) return true;
+            }
+        }
+    }
+    
+    return false;
+}
+
+// Resolve collision with wall sliding
+// This function implements smooth wall sliding when player moves diagonally into a wall
+//
+// ALGORITHM:
+// 1. Check if new position collides
+// 2. If no collision, return new position
+// 3. If collision, try sliding along X axis (keep Y from newPos, X from oldPos)
+// 4. If X-slide works, return that position
+// 5. If X-slide fails, try sliding along Y axis (keep X from newPos, Y from oldPos)
+// 6. If Y-slide works, return that position
+// 7. If both fail, return old position (stuck against corner)
+//
+// SLIDING BEHAVIOR:
+// - When moving diagonally into a horizontal wall, player slides horizontally
+// - When moving diagonally into a vertical wall, player slides vertically
+// - This creates smooth, intuitive movement along walls
+// - No more getting stuck when pressing two keys at once
+//
+// PERFORMANCE:
+// - Maximum 3 collision checks per frame (newPos, slideX, slideY)
+// - Each check examines the 2-4 edges the player box can overlap
+// - Target: < 0.3ms per collision resolution
+sf::Vector2f resolveCollisionCellBased(sf::Vector2f oldPos, sf::Vector2f newPos, const CellGrid& grid) {
+    // Step 1: Check if new position collides
+    if (!checkCollision(newPos, grid)) {
+        // No collision, clamp to map boundaries and return
+        newPos.x = std::max(PLAYER_SIZE / 2.0f, std::min(newPos.x, MAP_SIZE - PLAYER_SIZE / 2.0f));
+        newPos.y = std::max(PLAYER_SIZE / 2.0f, std::min(newPos.y, MAP_SIZE - PLAYER_SIZE / 2.0f));
+        return newPos;
+    }
+    
+    // Step 2: Collision detected, try sliding along X axis
+    // Keep the new X position, but use old Y position
+    sf::Vector2f slideX(newPos.x, oldPos.y);
+    if (!checkCollision(slideX, grid)) {
+        // X-axis slide works! Player slides horizontally along the wall
+        slideX.x = std::max(PLAYER_SIZE / 2.0f, std::min(slideX.x, MAP_SIZE - PLAYER_SIZE / 2.0f));
+        slideX.y = std::max(PLAYER_SIZE / 2.0f, std::min(slideX.y, MAP_SIZE - PLAYER_SIZE / 2.0f));
+        return slideX;
+    }
+    
+    // Step 3: X-axis slide failed, try sliding along Y axis
+    // Keep the new Y position, but use old X position
+    sf::Vector2f slideY(oldPos.x, newPos.y);
+    if (!checkCollision(slideY, grid)) {
+        // Y-axis slide works! Player slides vertically along the wall
+        slideY.x = std::max(PLAYER_SIZE / 2.0f, std::min(slideY.x, MAP_SIZE - PLAYER_SIZE / 2.0f));
+        slideY.y = std::max(PLAYER_SIZE / 2.0f, std::min(slideY.y, MAP_SIZE - PLAYER_SIZE / 2.0f));
+        return slideY;
+    }
+    
+    // Step 4: Both slides failed (stuck in corner), return old position
+    return oldPos;
+}
+
+// ========================
+// Input Command Movement
+// ========================
+
+// Movement speed for an input command's weapon code (0 = no weapon, else Weapon::Type + 1)
+// Same values as Player::getMovementSpeed(); unknown codes get the base speed
+float inputMovementSpeed(uint8_t weaponCode) {
+    static const std::array<float, Weapon::M40 + 2> speeds = [] {
+        std::array<float, Weapon::M40 + 2> table;
+        table[0] = Player().getMovementSpeed();
+        for (int type = Weapon::USP; type <= Weapon::M40; ++type) {
+            Weapon* weapon = Weapon::create(static_cast<Weapon::Type>(type));
+            table[type + 1] = weapon->movementSpeed;
+            delete weapon;
+        }
+        return table;
+    }();
+    return weaponCode < speeds.size() ? speeds[weaponCode] : speeds[0];
+}
+
+// Simulate one input command: move by its buttons for INPUT_STEP, then resolve walls
+// The server and the client's prediction both run this, so replaying the same
+// commands from the same position always ends at the same place.
+sf::Vector2f applyInputCommand(sf::Vector2f position, uint8_t buttons, const CellGrid& grid) {
+    if ((buttons & (INPUT_UP | INPUT_DOWN | INPUT_LEFT | INPUT_RIGHT)) == 0) {
+        return position;
+    }
+    
+    // Speeds are pixels per 1/60 s
+    const float step = inputMovementSpeed(inputWeaponCode(buttons)) * INPUT_STEP * 60.0f;
+    sf::Vector2f target = position;
+    if (buttons & INPUT_UP) target.y -= step;
+    if (buttons & INPUT_DOWN) target.y += step;
+    if (buttons & INPUT_LEFT) target.x -= step;
+    if (buttons & INPUT_RIGHT) target.x += step;
+    
+    return resolveCollisionCellBased(position, target, grid);
+}
+
+// ========================
+// NEW: Map Serialization Functions
+// ========================
+
+// Serialize the cell-based grid map into a byte buffer for network transmission
+// Parameters:
+//   grid - The cell grid to serialize
+//   buffer - Output buffer to store serialized data
+//
+// SERIALIZATION FORMAT:
+// The grid is serialized as the two edge bit-planes backing CellGrid: the
+// horizontal plane, then the vertical plane, CellGrid::WORDS_PER_PLANE 64-bit
+// words each, 2 bits per edge. Total size: 2 x 83 x 8 = 1,328 bytes (~1.3 KB)
+//
+// ALGORITHM:
+// 1. Resize buffer to fit the entire grid
+// 2. Copy the grid storage into the buffer with a single std::memcpy
+//
+// PERFORMANCE:
+// - One memory copy of ~1.3 KB
+// - Network transmission time: ~10-50ms depending on connection
+void serializeMap(const CellGrid& grid, std::vector<char>& buffer) {
+    // Calculate total size needed for serialization
+    size_t totalSize = CellGrid::BYTE_SIZE;
+    
+    // Resize buffer to fit all data
+    buffer.resize(totalSize);
+    
+    // The grid is one contiguous array of words, so it is copied as a single span
+    std::memcpy(buffer.data(), grid.data(), totalSize);
+    
+    std::cout << "[INFO] Map serialized: " << totalSize << " bytes (" 
+              << (totalSize / 1024) << " KB)" << std::endl;
+}
+
+// Append the raw bytes of a TCP handshake packet to a send buffer
+// The join handshake sends packets in their in-memory layout (client and server share it)
+template <typename T>
+void appendPacket(std::vector<char>& out, const T& packet) {
+    const char* bytes = reinterpret_cast<const char*>(&packet);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+// Append the serialized map, as sent to a joining client, to a TCP send buffer
+// Parameters:
+//   out - Send buffer to append to
+//   grid - The cell grid to send
+//
+// PROTOCOL:
+// 1. Data size as uint32_t (4 bytes)
+// 2. Serialized map data (CellGrid::BYTE_SIZE, ~1.3 KB)
+//
+// The map never changes after startup, so tcpListenerThread builds this once
+// and ConnectionAcceptor copies the bytes into each joining client's send buffer
+void appendMapData(std::vector<char>& out, const CellGrid& grid) {
+    std::vector<char> mapData;
+    serializeMap(grid, mapData);
+    
+    uint32_t dataSize = static_cast<uint32_t>(mapData.size());
+    appendPacket(out, dataSize);
+    out.insert(out.end(), mapData.begin(), mapData.end());
+    
+    std::cout << "[INFO] Map transfer prepared: " << dataSize << " bytes" << std::endl;
+}
+
+// Append shop positions, as sent to a joining client, to a TCP send buffer
+// Parameters:
+//   out - Send buffer to append to
+//   shops - Vector of shops to send
+//
+// PROTOCOL:
+// 1. Shop count as uint8_t (1 byte)
+// 2. For each shop, gridX and gridY as int32_t (8 bytes per shop)
+void appendShopData(std::vector<char>& out, const std::vector<Shop>& shops) {
+    uint8_t shopCount = static_cast<uint8_t>(shops.size());
+    appendPacket(out, shopCount);
+    
+    for (const auto& shop : shops) {
+        struct ShopData {
+            int32_t gridX;
+            int32_t gridY;
+        } shopData;
+        
+        shopData.gridX = shop.gridX;
+        shopData.gridY = shop.gridY;
+        appendPacket(out, shopData);
+    }
+    
+    std::cout << "[INFO] Shop transfer prepared: " << static_cast<int>(shopCount) << " shops" << std::endl;
+}
+
+// ========================
+// Thread-Safe Game State Manager
+// ========================
+
+// Player table IDs
+// The host (windowed server) is always player 0; remote clients get 1..MAX_PLAYERS-1
+// at handshake time. IDs travel in the 8-bit playerId/ownerId/victimId packet fields.
+const uint32_t HOST_PLAYER_ID = 0;
+const uint32_t MAX_PLAYERS = 64;
+
+class GameState {
+public:
+    // Run fn(players) with the whole table locked once
+    // Used by the simulation tick so hit detection, respawn and snapshots iterate
+    // the table directly instead of taking the lock per player.
+    // fn must not call other GameState methods (the mutex is not recursive).
+    template <typename Fn>
+    void withPlayers(Fn&& fn) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fn(players_);
+    }
+    
+    // Thread-safe lookup of the remote player that owns an address
+    // Returns: true and sets playerId if found (the host player has no address)
+    bool findPlayerByAddress(const sf::IpAddress& address, uint32_t& playerId) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& pair : players_) {
+            if (pair.first != HOST_PLAYER_ID && pair.second.ipAddress == address) {
+                playerId = pair.first;
+                return true;
+            }
+        }
+        return false;
     }
     
-    // Render tooltips at the very end to ensure they're on top of all other UI elements
-    if (hoveredWeapon != nullptr) {
-        renderWeaponTooltip(window, hoveredWeapon, hoveredMouseX, hoveredMouseY, font);
-        delete hoveredWeapon;  // Clean up after rendering
+    // Thread-safe update player position
+    void updatePlayerPosition(uint32_t playerId, float x, float y) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (players_.count(playerId)) {
+            players_[playerId].previousX = players_[playerId].x;
+            players_[playerId].previousY = players_[playerId].y;
+            players_[playerId].x = x;
+            players_[playerId].y = y;
+        }
     }
     
-    if (hoveredAmmo != nullptr) {
-        renderAmmoTooltip(window, hoveredAmmo, hoveredMouseX, hoveredMouseY, font);
-        delete hoveredAmmo;  // Clean up after rendering
+    // Thread-safe get player
+    Player getPlayer(uint32_t playerId) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (players_.count(playerId)) {
+            return players_.at(playerId);
+        }
+        return Player(); // Return default player if not found
     }
-}
-
-// Check if player is near any shop and render interaction prompt
-// Requirement 3.1: Display prompt when player within 60 pixels
-void renderShopInteractionPrompt(sf::RenderWindow& window, sf::Vector2f playerPosition, 
-                                 const std::vector<Shop>& shops, const sf::Font& font, bool shopUIOpen) {
-    const float INTERACTION_RANGE = 60.0f;  // 60 pixels interaction range
     
-    // Check if player is near any shop
-    bool nearShop = false;
-    for (const auto& shop : shops) {
-        if (shop.isPlayerNear(playerPosition.x, playerPosition.y)) {
-            nearShop = true;
-            break;
+    // Thread-safe set player ready status
+    void setPlayerReady(uint32_t playerId, bool ready) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (players_.count(playerId)) {
+            players_[playerId].isReady = ready;
         }
     }
     
-    // Display prompt based on shop state
-    if (nearShop || shopUIOpen) {
-        // Get window size for UI positioning
-        sf::Vector2u windowSize = window.getSize();
-        
-        // Create prompt text
-        sf::Text promptText;
-        promptText.setFont(font);
-        // Show different text based on shop state
-        promptText.setString(shopUIOpen ? "Press B to close" : "Press B to purchase");
-        promptText.setCharacterSize(28);
-        promptText.setFillColor(sf::Color::White);
-        promptText.setOutlineColor(sf::Color::Black);
-        promptText.setOutlineThickness(2.0f);
+    // Thread-safe check if all players are ready
+    bool allPlayersReady() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (players_.empty()) {
+            return false;
+        }
         
-        // Position at bottom center of screen
-        sf::FloatRect textBounds = promptText.getLocalBounds();
-        promptText.setPosition(
-            windowSize.x / 2.0f - textBounds.width / 2.0f - textBounds.left,
-            windowSize.y - 120.0f  // 120px from bottom (above inventory hint)
-        );
+        for (const auto& pair : players_) {
+            const Player& player = pair.second;
+            if (!player.isReady) {
+                return false;
+            }
+        }
         
-        window.draw(promptText);
+        return true;
+    }
+    
+    // Thread-safe add player
+    void addPlayer(uint32_t playerId, const Player& player) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        players_[playerId] = player;
+    }
+    
+    // Thread-safe remove player
+    void removePlayer(uint32_t playerId) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        players_.erase(playerId);
+    }
+    
+    // Thread-safe get all players
+    std::map<uint32_t, Player> getAllPlayers() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return players_;
+    }
+    
+    // Thread-safe check if player exists
+    bool hasPlayer(uint32_t playerId) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return players_.count(playerId) > 0;
+    }
+    
+    // Thread-safe get player count
+    size_t getPlayerCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return players_.size();
+    }
+    
+    // Requirement 8.1: Thread-safe apply damage to player
+    void applyDamage(uint32_t playerId, float damage) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (players_.count(playerId)) {
+            players_[playerId].health -= damage;
+            if (players_[playerId].health < 0.0f) {
+                players_[playerId].health = 0.0f;
+            }
+        }
+    }
+    
+    // Requirement 8.3: Thread-safe check if player is dead
+    bool isPlayerDead(uint32_t playerId) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (players_.count(playerId)) {
+            return players_.at(playerId).health <= 0.0f;
+        }
+        return false;
+    }
+    
+    // Requirement 8.4: Thread-safe award money to player
+    void awardMoney(uint32_t playerId, int amount) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (players_.count(playerId)) {
+            players_[playerId].money += amount;
+            ErrorHandler::logInfo("Player " + std::to_string(playerId) + 
+                                 " awarded $" + std::to_string(amount) + 
+                                 ". New balance: $" + std::to_string(players_[playerId].money));
+        }
+    }
+    
+    // Requirement 8.5: Thread-safe respawn player
+    void respawnPlayer(uint32_t playerId, float x, float y) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (players_.count(playerId)) {
+            players_[playerId].health = 100.0f;
+            players_[playerId].isAlive = true;
+            players_[playerId].x = x;
+            players_[playerId].y = y;
+            players_[playerId].previousX = x;
+            players_[playerId].previousY = y;
+        }
+    }
+    
+    // Thread-safe set player alive status
+    void setPlayerAlive(uint32_t playerId, bool alive) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (players_.count(playerId)) {
+            players_[playerId].isAlive = alive;
+        }
     }
+    
+private:
+    mutable std::mutex mutex_;
+    std::map<uint32_t, Player> players_;
+};
+
+// ========================
+// Movement and Interpolation Constants
+// ========================
+
+const float MOVEMENT_SPEED = 3.0f; // 3 units per second
+
+// Linear interpolation function for smooth position transitions
+float lerp(float start, float end, float alpha) {
+    return start + (end - start) * alpha;
 }
 
-// Render shops with fog of war integration
-// Requirements: 2.6, 3.1, 10.5
-void renderShops(sf::RenderWindow& window, sf::Vector2f playerPosition, const std::vector<Shop>& shops) {
-    const float SHOP_SIZE = 20.0f;  // 20×20 pixel red square
-    const sf::Color shopColor(255, 0, 0);  // Red color for shops
+sf::Vector2f lerpPosition(sf::Vector2f start, sf::Vector2f end, float alpha) {
+    return sf::Vector2f(lerp(start.x, end.x, alpha), lerp(start.y, end.y, alpha));
+}
+
+// ========================
+// Random Spawn Generation
+// ========================
+
+// Generate random spawn positions with minimum distance constraint
+// Parameters:
+//   grid - The cell grid to check for wall collisions
+//   minDistance - Minimum distance between spawn points (in pixels)
+// Returns: pair of positions (server spawn, client spawn)
+//
+// ALGORITHM:
+// 1. Generate random position for server player
+// 2. Check if position is valid (no wall collision)
+// 3. Generate random position for client player
+// 4. Check if position is valid and distance >= minDistance
+// 5. Retry if constraints not met (max 100 attempts)
+std::pair<Position, Position> generateRandomSpawns(const CellGrid& grid, float minDistance = 2100.0f) {
+    std::random_device rd;
+    std::mt19937 gen(rd());
     
-    for (const auto& shop : shops) {
-        // Calculate distance from player to shop center
-        float dx = shop.worldX - playerPosition.x;
-        float dy = shop.worldY - playerPosition.y;
-        float distance = std::sqrt(dx * dx + dy * dy);
+    // Generate positions with margin from edges (at least 1 cell = 100 pixels)
+    const float MARGIN = CELL_SIZE;
+    std::uniform_real_distribution<float> xDist(MARGIN, MAP_SIZE - MARGIN);
+    std::uniform_real_distribution<float> yDist(MARGIN, MAP_SIZE - MARGIN);
+    
+    const int MAX_ATTEMPTS = 100;
+    
+    for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
+        // Generate server spawn position
+        Position serverSpawn;
+        serverSpawn.x = xDist(gen);
+        serverSpawn.y = yDist(gen);
         
-        // Calculate fog alpha (same as other entities for consistency)
-        // Requirement 10.5: Fog of war consistency for shops
-        sf::Uint8 alpha = calculateFogAlpha(distance);
+        // Check if server spawn is valid (no wall collision)
+        if (checkCollision(sf::Vector2f(serverSpawn.x, serverSpawn.y), grid)) {
+            continue; // Try again
+        }
         
-        // Only render if visible (alpha > 0)
-        if (alpha > 0) {
-            // Create shop visual as 20×20 red square
-            // Requirement 2.6: Render each shop as 20×20 red square at grid cell center
-            sf::RectangleShape shopRect(sf::Vector2f(SHOP_SIZE, SHOP_SIZE));
-            
-            // Position at grid cell center (worldX and worldY are already at center)
-            // Offset by half the shop size to center the square
-            shopRect.setPosition(shop.worldX - SHOP_SIZE / 2.0f, shop.worldY - SHOP_SIZE / 2.0f);
-            
-            // Apply fog to shop color
-            sf::Color foggedColor(shopColor.r, shopColor.g, shopColor.b, alpha);
-            shopRect.setFillColor(foggedColor);
+        // Generate client spawn position
+        Position clientSpawn;
+        clientSpawn.x = xDist(gen);
+        clientSpawn.y = yDist(gen);
+        
+        // Check if client spawn is valid (no wall collision)
+        if (checkCollision(sf::Vector2f(clientSpawn.x, clientSpawn.y), grid)) {
+            continue; // Try again
+        }
+        
+        // Check distance between spawns
+        float dx = serverSpawn.x - clientSpawn.x;
+        float dy = serverSpawn.y - clientSpawn.y;
+        float distance = std::sqrt(dx * dx + dy * dy);
+        
+        if (distance >= minDistance) {
+            // Success! Found valid spawn positions
+            std::cout << "[INFO] Generated random spawns:" << std::endl;
+            std::cout << "  Server spawn: (" << serverSpawn.x << ", " << serverSpawn.y << ")" << std::endl;
+            std::cout << "  Client spawn: (" << clientSpawn.x << ", " << clientSpawn.y << ")" << std::endl;
+            std::cout << "  Distance: " << distance << " pixels (" << (distance / CELL_SIZE) << " cells)" << std::endl;
+            std::cout << "  Attempts: " << (attempt + 1) << std::endl;
             
-            window.draw(shopRect);
+            return std::make_pair(serverSpawn, clientSpawn);
         }
     }
+    
+    // Failed to find valid spawns, use fallback positions
+    std::cerr << "[WARNING] Failed to generate random spawns after " << MAX_ATTEMPTS << " attempts" << std::endl;
+    std::cerr << "  Using fallback spawn positions" << std::endl;
+    
+    Position serverSpawn = { 250.0f, 4850.0f };
+    Position clientSpawn = { 4850.0f, 250.0f };
+    
+    return std::make_pair(serverSpawn, clientSpawn);
 }
 
-// Render background with smooth fog of war gradient effect
-// The background gets darker the further it is from the player (pixel-based gradient)
-void renderFoggedBackground(sf::RenderWindow& window, sf::Vector2f playerPosition) {
-    // Get current view to determine visible area
-    sf::View currentView = window.getView();
-    sf::Vector2f viewCenter = currentView.getCenter();
-    sf::Vector2f viewSize = currentView.getSize();
+// Find a spawn position away from every other living player
+// Parameters:
+//   grid - The cell grid to check for wall collisions
+//   players - Player table (positions of other players)
+//   excludeId - Player being spawned (ignored in the distance check)
+//   minDistance - Desired minimum distance to other players (in pixels)
+// Returns: first valid position at least minDistance from everyone, otherwise the
+//          candidate farthest from its nearest player (with 64 players on the map
+//          1000px of clearance is not always possible)
+Position findSpawnPosition(const CellGrid& grid, const std::map<uint32_t, Player>& players,
+                           uint32_t excludeId, float minDistance = 1000.0f) {
+    std::random_device rd;
+    std::mt19937 gen(rd());
     
-    // Calculate visible world bounds with padding
-    float padding = 200.0f;
-    float minX = std::max(0.0f, viewCenter.x - viewSize.x / 2.0f - padding);
-    float maxX = std::min(MAP_SIZE, viewCenter.x + viewSize.x / 2.0f + padding);
-    float minY = std::max(0.0f, viewCenter.y - viewSize.y / 2.0f - padding);
-    float maxY = std::min(MAP_SIZE, viewCenter.y + viewSize.y / 2.0f + padding);
+    const float MARGIN = CELL_SIZE;
+    std::uniform_real_distribution<float> xDist(MARGIN, MAP_SIZE - MARGIN);
+    std::uniform_real_distribution<float> yDist(MARGIN, MAP_SIZE - MARGIN);
     
-    // Base background color (136, 101, 56)
-    const sf::Color baseColor(136, 101, 56);
+    const int MAX_ATTEMPTS = 100;
+    const float minDistanceSq = minDistance * minDistance;
     
-    // OPTIMIZED: Use larger chunks (50x50) for better performance
-    // This reduces draw calls from ~10000 to ~400 per frame
-    const float chunkSize = 50.0f;
+    Position best = { 4850.0f, 250.0f }; // Fallback if every candidate hits a wall
+    float bestNearestSq = -1.0f;
     
-    for (float x = minX; x < maxX; x += chunkSize) {
-        for (float y = minY; y < maxY; y += chunkSize) {
-            // Calculate center of chunk
-            float chunkCenterX = x + chunkSize / 2.0f;
-            float chunkCenterY = y + chunkSize / 2.0f;
-            
-            // Calculate distance from player to chunk center
-            float dx = chunkCenterX - playerPosition.x;
-            float dy = chunkCenterY - playerPosition.y;
-            float distance = std::sqrt(dx * dx + dy * dy);
-            
-            // Calculate fog alpha (smooth gradient)
-            sf::Uint8 alpha = calculateFogAlpha(distance);
-            
-            // Apply fog to background color
-            sf::Color foggedColor(baseColor.r, baseColor.g, baseColor.b, alpha);
-            
-            // Create and draw background rectangle
-            sf::RectangleShape bgRect(sf::Vector2f(chunkSize, chunkSize));
-            bgRect.setPosition(x, y);
-            bgRect.setFillColor(foggedColor);
-            window.draw(bgRect);
+    for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
+        Position candidate;
+        candidate.x = xDist(gen);
+        candidate.y = yDist(gen);
+        
+        if (checkCollision(sf::Vector2f(candidate.x, candidate.y), grid)) {
+            continue;
+        }
+        
+        // Squared distance to the nearest living player
+        float nearestSq = MAP_SIZE * MAP_SIZE * 2.0f;
+        for (const auto& pair : players) {
+            const Player& other = pair.second;
+            if (other.id == excludeId || !other.isAlive) continue;
+            float dx = candidate.x - other.x;
+            float dy = candidate.y - other.y;
+            nearestSq = std::min(nearestSq, dx * dx + dy * dy);
+        }
+        
+        if (nearestSq >= minDistanceSq) {
+            return candidate;
+        }
+        if (nearestSq > bestNearestSq) {
+            bestNearestSq = nearestSq;
+            best = candidate;
         }
     }
+    
+    ErrorHandler::logWarning("No spawn position " + std::to_string(minDistance) +
+                             " pixels from all players, using best of " + std::to_string(MAX_ATTEMPTS));
+    return best;
 }
 
 // ========================
-// NEW: Fog Overlay Effect
+// Global State
 // ========================
 
-// Render fog overlay that darkens everything far from player
-// This creates a smooth vignette effect
-void renderFogOverlay(sf::RenderWindow& window, sf::Vector2f playerPosition) {
-    // Get current view
-    sf::View currentView = window.getView();
-    sf::Vector2f viewCenter = currentView.getCenter();
-    sf::Vector2f viewSize = currentView.getSize();
+std::mutex mutex;
+Position serverPos = { 250.0f, 4850.0f }; // Server spawn position (will be randomized)
+Position serverPosPrevious = { 250.0f, 4850.0f }; // Previous position for interpolation
+float serverHealth = 100.0f; // Server player health (0-100)
+int serverScore = 0; // Server player score
+bool serverIsAlive = true; // Server player alive status
+GameMap gameMap;
+
+// Authoritative player table: host (ID 0, windowed mode only) and every remote client
+// The host's health/alive/score are mirrored into the globals above each tick
+GameState gameState;
+
+// Server player with inventory and weapons
+Player serverPlayer;
+
+// Shop system
+std::vector<Shop> shops;
+
+// Requirement 7.1: Store active bullets
+// 64 players firing automatic weapons at 10 shots/s with ~1s flight time stay well below this
+const size_t MAX_ACTIVE_BULLETS = 4096;
+BulletPool activeBullets(MAX_ACTIVE_BULLETS);
+std::mutex bulletsMutex;
+
+// Requirement 8.2: Store active damage texts
+std::vector<DamageText> damageTexts;
+std::mutex damageTextsMutex;
+
+// Store active purchase notification texts
+std::vector<PurchaseText> purchaseTexts;
+std::mutex purchaseTextsMutex;
+
+// Client connection state
+struct ClientConnection {
+    std::unique_ptr<sf::TcpSocket> socket;
+    sf::IpAddress address;
+    bool isReady = false;
+    uint32_t playerId = 0;
+};
+
+std::vector<ClientConnection> connectedClients;
+std::mutex clientsMutex;
+std::string connectionStatus = "Waiting for player..."; // Waiting for player... in Russian
+sf::Color connectionStatusColor = sf::Color::White;
+bool showPlayButton = false;
+
+// ========================
+// Weapon Firing System (Server)
+// ========================
+
+// Fire weapon and send shot packet to all clients
+void fireWeaponServer(Player& player, const sf::RenderWindow& window,
+                      BulletPool& activeBullets, std::mutex& bulletsMutex) {
+    Weapon* activeWeapon = player.getActiveWeapon();
+    if (activeWeapon == nullptr || !activeWeapon->canFire()) {
+        return;
+    }
     
-    // Calculate visible world bounds
-    float minX = viewCenter.x - viewSize.x / 2.0f;
-    float maxX = viewCenter.x + viewSize.x / 2.0f;
-    float minY = viewCenter.y - viewSize.y / 2.0f;
-    float maxY = viewCenter.y + viewSize.y / 2.0f;
+    // Get mouse position in world coordinates
+    sf::Vector2i mousePixelPos = sf::Mouse::getPosition(window);
+    sf::Vector2f mouseWorldPos = window.mapPixelToCoords(mousePixelPos);
     
-    // Render fog overlay in larger chunks for smooth gradient
-    const float chunkSize = 100.0f;
+    // Calculate bullet trajectory
+    float dx = mouseWorldPos.x - player.x;
+    float dy = mouseWorldPos.y - player.y;
+    float distance = std::sqrt(dx * dx + dy * dy);
     
-    for (float x = minX; x < maxX; x += chunkSize) {
-        for (float y = minY; y < maxY; y += chunkSize) {
-            // Calculate center of chunk
-            float chunkCenterX = x + chunkSize / 2.0f;
-            float chunkCenterY = y + chunkSize / 2.0f;
-            
-            // Calculate distance from player
-            float dx = chunkCenterX - playerPosition.x;
-            float dy = chunkCenterY - playerPosition.y;
-            float distance = std::sqrt(dx * dx + dy * dy);
-            
-            // Calculate fog darkness (inverse of visibility)
-            // Close = transparent, far = dark
-            sf::Uint8 darkness = 255 - calculateFogAlpha(distance);
+    if (distance > 0.001f) {  // Avoid division by zero
+        // Normalize direction
+        dx /= distance;
+        dy /= distance;
+        
+        // Create bullet
+        Bullet bullet;
+        bullet.ownerId = HOST_PLAYER_ID;
+        bullet.x = player.x;
+        bullet.y = player.y;
+        bullet.prevX = player.x;  // Initialize previous position
+        bullet.prevY = player.y;
+        bullet.vx = dx * activeWeapon->bulletSpeed;
+        bullet.vy = dy * activeWeapon->bulletSpeed;
+        bullet.damage = activeWeapon->damage;
+        bullet.range = activeWeapon->range;
+        bullet.maxRange = activeWeapon->range;
+        bullet.weaponType = activeWeapon->type;
+        
+        // Fire weapon (consumes ammo)
+        activeWeapon->fire();
+        
+        // Add bullet to active bullets list
+        {
+            std::lock_guard<std::mutex> lock(bulletsMutex);
             
-            // Apply black fog overlay
-            sf::Color fogColor(0, 0, 0, darkness);
+            // Count bullets owned by this player
+            int playerBulletCount = activeBullets.countOwnedBy(HOST_PLAYER_ID);
             
-            sf::RectangleShape fogRect(sf::Vector2f(chunkSize, chunkSize));
-            fogRect.setPosition(x, y);
-            fogRect.setFillColor(fogColor);
-            window.draw(fogRect);
+            // Only add if under limit
+            if (playerBulletCount < 20 && activeBullets.spawn(bullet)) {
+                ErrorHandler::logInfo("Bullet created! Total bullets: " + std::to_string(activeBullets.size()));
+            } else {
+                ErrorHandler::logInfo("Bullet limit reached (20)");
+            }
         }
+        
+        // Send shot packet to all clients
+        ShotPacket shotPacket;
+        shotPacket.playerId = HOST_PLAYER_ID;
+        shotPacket.x = player.x;
+        shotPacket.y = player.y;
+        shotPacket.dirX = dx;
+        shotPacket.dirY = dy;
+        shotPacket.weaponType = static_cast<uint8_t>(activeWeapon->type);
+        shotPacket.bulletSpeed = activeWeapon->bulletSpeed;
+        shotPacket.damage = activeWeapon->damage;
+        shotPacket.range = activeWeapon->range;
+        shotPacket.viewTick = 0;  // Host shots are never rewound
+        
+        // Sent to all clients with the next tick's datagrams
+        queueBroadcast(shotPacket);
+        
+        int* ammoPool = activeWeapon->getAmmoPool(&player);
+        int reserveAmmo = ammoPool ? *ammoPool : 0;
+        ErrorHandler::logInfo("Fired " + activeWeapon->name + " - Ammo: " + 
+                             std::to_string(activeWeapon->currentAmmo) + "/" + 
+                             std::to_string(reserveAmmo));
     }
 }
 
-// VISIBLE RANGE:
-// We calculate the visible area from the camera view and add 2 cells of padding
-// to prevent walls from popping in/out at screen edges.
+// ========================
+// Connection Acceptor
+// ========================
+
+// One TCP connection between accept and hand-over to connectedClients
 //
-// WALL POSITIONING:
-// Walls are centered on cell boundaries to ensure they align properly:
-// - A 12-pixel wide wall on a boundary extends 6 pixels into each adjacent cell
-// - This is why we use: position - WALL_WIDTH/2 for positioning
-void renderVisibleWalls(sf::RenderWindow& window, sf::Vector2f playerPosition, const std::vector<std::vector<Cell>>& grid) {
-    // Get current view to determine visible area
-    sf::View currentView = window.getView();
-    sf::Vector2f viewCenter = currentView.getCenter();
-    sf::Vector2f viewSize = currentView.getSize();
-    
-    // Calculate visible world bounds with padding
-    float padding = CELL_SIZE * 2.0f; // 2 cells padding to avoid pop-in
-    float minX = viewCenter.x - viewSize.x / 2.0f - padding;
-    float maxX = viewCenter.x + viewSize.x / 2.0f + padding;
-    float minY = viewCenter.y - viewSize.y / 2.0f - padding;
-    float maxY = viewCenter.y + viewSize.y / 2.0f + padding;
-    
-    // Convert to cell coordinates
-    int startX = std::max(0, static_cast<int>(minX / CELL_SIZE));
-    int startY = std::max(0, static_cast<int>(minY / CELL_SIZE));
-    int endX = std::min(GRID_SIZE - 1, static_cast<int>(maxX / CELL_SIZE));
-    int endY = std::min(GRID_SIZE - 1, static_cast<int>(maxY / CELL_SIZE));
-    
-    // Counter for rendered walls (for performance monitoring)
-    int wallCount = 0;
-    
-    // Wall colors
-    sf::Color concreteColor(150, 150, 150);  // Gray for concrete
-    sf::Color woodColor(139, 90, 43);        // Brown for wood
+// Stages:
+//   AwaitConnect - reading the ConnectPacket (CONNECT_TIMEOUT)
+//   SendWorld    - flushing map, shops and the two PositionPackets (SEND_TIMEOUT)
+//   AwaitReady   - reading the ReadyPacket; no deadline, the player readies up when they like
+//   SendStart    - flushing the StartPacket to a client joining a running game (SEND_TIMEOUT)
+struct PendingConnection {
+    enum class Stage { AwaitConnect, SendWorld, AwaitReady, SendStart };
     
-    // Corner radius for rounded walls
-    const float cornerRadius = 3.0f;
+    std::unique_ptr<sf::TcpSocket> socket;
+    sf::IpAddress address;
+    Stage stage = Stage::AwaitConnect;
+    uint32_t playerId = HOST_PLAYER_ID;  // HOST_PLAYER_ID until admitted
+    std::array<char, sizeof(ConnectPacket)> inbox;
+    size_t inboxBytes = 0;
+    std::vector<char> outbox;            // Unsent bytes start at outboxSent
+    size_t outboxSent = 0;
+    float deadline = 0.0f;               // Seconds on the acceptor's clock
+    bool watched = false;                // In the acceptor's selector
+    bool closed = false;
+};
+
+// What ConnectionAcceptor calls into the game for; the acceptor keeps no game state
+struct AcceptorHooks {
+    // A valid ConnectPacket arrived: take a player slot and spawn point and append
+    // the two initial PositionPackets to out
+    // Returns: the player ID, or HOST_PLAYER_ID if the server is full
+    std::function<uint32_t(const sf::IpAddress& address, std::vector<char>& out)> admit;
+    // Map, shops and positions reached the client
+    std::function<void(const PendingConnection& conn)> welcomed;
+    // The client is ready: move conn.socket into connectedClients
+    // Returns: false instead if the game is already running, after appending a
+    // StartPacket to conn.outbox; the acceptor flushes it and calls started
+    std::function<bool(PendingConnection& conn)> ready;
+    // The StartPacket reached a client joining a running game: move conn.socket into connectedClients
+    std::function<void(PendingConnection& conn)> started;
+    // An admitted client disconnected or timed out before hand-over: free its player slot
+    std::function<void(const PendingConnection& conn)> dropped;
+};
+
+struct AcceptorStats {
+    uint64_t accepted = 0;
+    uint64_t admitted = 0;
+    uint64_t rejected = 0;    // Invalid ConnectPacket or server full
+    uint64_t handedOver = 0;  // Ready clients moved into connectedClients
+    uint64_t timedOut = 0;
+    uint64_t dropped = 0;     // Admitted, then lost before hand-over
+};
+
+// Runs the join handshake of every connecting client on one thread, without blocking
+//
+// ALGORITHM:
+// Listener and client sockets are non-blocking. Each poll() waits on one
+// sf::SocketSelector for the listener and the sockets still in their timed
+// handshake, then:
+// 1. Accepts every queued connection
+// 2. Receives whatever bytes arrived into each connection's inbox; a complete
+//    ConnectPacket admits the player and queues map + shops + positions, a
+//    complete ReadyPacket hands the socket over
+// 3. Sends as much of each outbox as the socket takes (Partial keeps the rest)
+// 4. Drops connections past their deadline, freeing their player slot
+// The map and shop bytes are serialized once (world) and copied into each outbox,
+// so a join costs one memcpy of ~1.4 KB instead of 2 + shop count blocking sends.
+// A client that stops reading or never sends its ConnectPacket holds nothing but
+// its own buffer until its deadline; every other join carries on meanwhile.
+//
+// Connections waiting for the player to ready up leave the selector and are read
+// once per poll instead: sf::SocketSelector holds at most FD_SETSIZE sockets (64
+// on Windows), and up to MAX_PLAYERS - 1 clients can sit in that stage. So does a
+// connection whose ReadyPacket came before the world was sent - it would keep the
+// selector waking up with bytes nobody reads yet.
+//
+// PERFORMANCE:
+// - The selector cannot wait for writability, so while any outbox is non-empty
+//   poll() waits at most FLUSH_INTERVAL; otherwise it sleeps until a socket is
+//   readable or maxWait passes
+// - MAX_HANDSHAKES bounds the selector; at the cap the listener leaves it too and
+//   further connections wait in the listener backlog until a handshake moves on
+class ConnectionAcceptor {
+public:
+    static constexpr float CONNECT_TIMEOUT = 5.0f;   // Accept -> complete ConnectPacket
+    static constexpr float SEND_TIMEOUT = 10.0f;     // Whole world (or StartPacket) transfer
+    static constexpr float FLUSH_INTERVAL = 0.002f;  // Poll period while any outbox is non-empty
+    static const size_t MAX_HANDSHAKES = 63;         // Selector sockets besides the listener
+    
+    ConnectionAcceptor(sf::TcpListener& listener, std::vector<char> world, AcceptorHooks hooks)
+        : listener_(listener), world_(std::move(world)), hooks_(std::move(hooks)) {
+        listener_.setBlocking(false);
+    }
+    
+    // Wait up to maxWait (non-zero) for socket activity, then advance every connection
+    void poll(sf::Time maxWait) {
+        size_t watchedCount = 0;
+        bool sending = false;
+        for (const PendingConnection& conn : pending_) {
+            watchedCount += conn.watched ? 1 : 0;
+            sending = sending || !conn.outbox.empty();
+        }
+        const bool listening = watchedCount < MAX_HANDSHAKES;
+        if (listening != listening_) {
+            if (listening) {
+                selector_.add(listener_);
+            } else {
+                selector_.remove(listener_);
+            }
+            listening_ = listening;
+        }
+        
+        if (selector_.wait(sending ? sf::seconds(FLUSH_INTERVAL) : maxWait)) {
+            if (listening_ && selector_.isReady(listener_)) {
+                acceptAll(watchedCount);
+            }
+            for (PendingConnection& conn : pending_) {
+                if (!conn.closed && conn.watched && selector_.isReady(*conn.socket)) {
+                    receive(conn);
+                }
+            }
+        }
+        
+        for (PendingConnection& conn : pending_) {
+            if (!conn.closed && conn.stage == PendingConnection::Stage::AwaitReady) {
+                receive(conn);
+            }
+            if (!conn.closed && !conn.outbox.empty()) {
+                flush(conn);
+            }
+        }
+        
+        const float now = clock_.getElapsedTime().asSeconds();
+        for (PendingConnection& conn : pending_) {
+            if (!conn.closed && conn.stage != PendingConnection::Stage::AwaitReady && now >= conn.deadline) {
+                ErrorHandler::logWarning("Join handshake with " + conn.address.toString() + " timed out");
+                stats_.timedOut++;
+                drop(conn);
+            }
+        }
+        
+        for (PendingConnection& conn : pending_) {
+            if (conn.closed && conn.socket) {
+                unwatch(conn);
+                conn.socket->disconnect();
+            }
+        }
+        pending_.erase(std::remove_if(pending_.begin(), pending_.end(),
+                                      [](const PendingConnection& conn) { return conn.closed; }),
+                       pending_.end());
+    }
     
-    // PERFORMANCE OPTIMIZATION: Cache wall shapes
-    // Create shapes once and reuse them by only changing position and color
-    // This avoids expensive shape creation every frame for every wall
-    static sf::ConvexShape horizontalWall = createRoundedRectangle(sf::Vector2f(WALL_LENGTH, WALL_WIDTH), cornerRadius);
-    static sf::ConvexShape verticalWall = createRoundedRectangle(sf::Vector2f(WALL_WIDTH, WALL_LENGTH), cornerRadius);
-    static bool shapesInitialized = false;
+    size_t pending() const { return pending_.size(); }
+    const AcceptorStats& stats() const { return stats_; }
     
-    if (!shapesInitialized) {
-        shapesInitialized = true;
+private:
+    void unwatch(PendingConnection& conn) {
+        if (conn.watched) {
+            selector_.remove(*conn.socket);
+            conn.watched = false;
+        }
     }
     
-    // Iterate through visible cells and render their walls with smooth gradient
-    for (int i = startX; i <= endX; i++) {
-        for (int j = startY; j <= endY; j++) {
-            // Calculate world position of this cell's top-left corner
-            float x = i * CELL_SIZE;
-            float y = j * CELL_SIZE;
-            
-            // Render topWall (horizontal wall on top boundary of cell)
-            if (grid[i][j].topWall != WallType::None) {
-                // Calculate center of this specific wall for smooth gradient
-                float wallCenterX = x + WALL_LENGTH / 2.0f;
-                float wallCenterY = y;
-                float dx = wallCenterX - playerPosition.x;
-                float dy = wallCenterY - playerPosition.y;
-                float distance = std::sqrt(dx * dx + dy * dy);
-                sf::Uint8 alpha = calculateFogAlpha(distance);
-                
-                if (alpha > 0) {
-                    // Choose color based on wall type
-                    sf::Color baseColor = (grid[i][j].topWall == WallType::Concrete) ? concreteColor : woodColor;
-                    horizontalWall.setFillColor(sf::Color(baseColor.r, baseColor.g, baseColor.b, alpha));
-                    horizontalWall.setPosition(x, y - WALL_WIDTH / 2.0f);
-                    window.draw(horizontalWall);
-                    wallCount++;
-                }
-            }
-            
-            // Render rightWall (vertical wall on right boundary of cell)
-            if (grid[i][j].rightWall != WallType::None) {
-                // Calculate center of this specific wall for smooth gradient
-                float wallCenterX = x + CELL_SIZE;
-                float wallCenterY = y + WALL_LENGTH / 2.0f;
-                float dx = wallCenterX - playerPosition.x;
-                float dy = wallCenterY - playerPosition.y;
-                float distance = std::sqrt(dx * dx + dy * dy);
-                sf::Uint8 alpha = calculateFogAlpha(distance);
-                
-                if (alpha > 0) {
-                    // Choose color based on wall type
-                    sf::Color baseColor = (grid[i][j].rightWall == WallType::Concrete) ? concreteColor : woodColor;
-                    verticalWall.setFillColor(sf::Color(baseColor.r, baseColor.g, baseColor.b, alpha));
-                    verticalWall.setPosition(x + CELL_SIZE - WALL_WIDTH / 2.0f, y);
-                    window.draw(verticalWall);
-                    wallCount++;
+    void acceptAll(size_t watchedCount) {
+        while (watchedCount < MAX_HANDSHAKES) {
+            auto socket = std::make_unique<sf::TcpSocket>();
+            sf::Socket::Status status = listener_.accept(*socket);
+            if (status != sf::Socket::Done) {
+                if (status != sf::Socket::NotReady) {
+                    ErrorHandler::logTCPError("Accept client connection", status);
                 }
+                return;
             }
             
-            // Render bottomWall (horizontal wall on bottom boundary of cell)
-            if (grid[i][j].bottomWall != WallType::None) {
-                // Calculate center of this specific wall for smooth gradient
-                float wallCenterX = x + WALL_LENGTH / 2.0f;
-                float wallCenterY = y + CELL_SIZE;
-                float dx = wallCenterX - playerPosition.x;
-                float dy = wallCenterY - playerPosition.y;
-                float distance = std::sqrt(dx * dx + dy * dy);
-                sf::Uint8 alpha = calculateFogAlpha(distance);
-                
-                if (alpha > 0) {
-                    // Choose color based on wall type
-                    sf::Color baseColor = (grid[i][j].bottomWall == WallType::Concrete) ? concreteColor : woodColor;
-                    horizontalWall.setFillColor(sf::Color(baseColor.r, baseColor.g, baseColor.b, alpha));
-                    horizontalWall.setPosition(x, y + CELL_SIZE - WALL_WIDTH / 2.0f);
-                    window.draw(horizontalWall);
-                    wallCount++;
-                }
+            socket->setBlocking(false);
+            PendingConnection conn;
+            conn.address = socket->getRemoteAddress();
+            conn.socket = std::move(socket);
+            conn.deadline = clock_.getElapsedTime().asSeconds() + CONNECT_TIMEOUT;
+            conn.watched = true;
+            selector_.add(*conn.socket);
+            pending_.push_back(std::move(conn));
+            stats_.accepted++;
+            watchedCount++;
+            ErrorHandler::logInfo("Accepted connection from " + pending_.back().address.toString());
+        }
+    }
+    
+    // Read the rest of the packet the current stage expects
+    void receive(PendingConnection& conn) {
+        const bool connecting = conn.stage == PendingConnection::Stage::AwaitConnect;
+        const size_t expected = connecting ? sizeof(ConnectPacket) : sizeof(ReadyPacket);
+        
+        std::size_t received = 0;
+        sf::Socket::Status status = conn.socket->receive(conn.inbox.data() + conn.inboxBytes,
+                                                         expected - conn.inboxBytes, received);
+        if (status == sf::Socket::Disconnected) {
+            ErrorHandler::handleConnectionLost(conn.address.toString());
+            drop(conn);
+            return;
+        }
+        if (status != sf::Socket::Done) {
+            if (status != sf::Socket::NotReady) {
+                ErrorHandler::logTCPError(connecting ? "Receive ConnectPacket" : "Receive ReadyPacket",
+                                          status, conn.address.toString());
+                drop(conn);
             }
-            
-            // Render leftWall (vertical wall on left boundary of cell)
-            if (grid[i][j].leftWall != WallType::None) {
-                // Calculate center of this specific wall for smooth gradient
-                float wallCenterX = x;
-                float wallCenterY = y + WALL_LENGTH / 2.0f;
-                float dx = wallCenterX - playerPosition.x;
-                float dy = wallCenterY - playerPosition.y;
-                float distance = std::sqrt(dx * dx + dy * dy);
-                sf::Uint8 alpha = calculateFogAlpha(distance);
-                
-                if (alpha > 0) {
-                    // Choose color based on wall type
-                    sf::Color baseColor = (grid[i][j].leftWall == WallType::Concrete) ? concreteColor : woodColor;
-                    verticalWall.setFillColor(sf::Color(baseColor.r, baseColor.g, baseColor.b, alpha));
-                    verticalWall.setPosition(x - WALL_WIDTH / 2.0f, y);
-                    window.draw(verticalWall);
-                    wallCount++;
-                }
+            return;
+        }
+        
+        conn.inboxBytes += received;
+        if (conn.inboxBytes < expected) {
+            return;
+        }
+        if (connecting) {
+            onConnect(conn);
+        } else if (conn.stage == PendingConnection::Stage::AwaitReady) {
+            onReady(conn);
+        } else {
+            unwatch(conn);  // Early ReadyPacket, taken once the world is sent
+        }
+    }
+    
+    void onConnect(PendingConnection& conn) {
+        ConnectPacket packet;
+        std::memcpy(&packet, conn.inbox.data(), sizeof(packet));
+        conn.inboxBytes = 0;
+        if (!validateConnect(packet)) {
+            ErrorHandler::handleInvalidPacket("ConnectPacket validation failed", conn.address.toString());
+            stats_.rejected++;
+            drop(conn);
+            return;
+        }
+        ErrorHandler::logInfo("Player name: " + std::string(packet.playerName));
+        
+        conn.outbox = world_;
+        conn.outboxSent = 0;
+        const uint32_t playerId = hooks_.admit(conn.address, conn.outbox);
+        if (playerId == HOST_PLAYER_ID) {
+            ErrorHandler::logWarning("Server full (" + std::to_string(MAX_PLAYERS - 1) +
+                                     " clients), rejecting " + conn.address.toString());
+            stats_.rejected++;
+            drop(conn);
+            return;
+        }
+        
+        conn.playerId = playerId;
+        conn.stage = PendingConnection::Stage::SendWorld;
+        conn.deadline = clock_.getElapsedTime().asSeconds() + SEND_TIMEOUT;
+        stats_.admitted++;
+        ErrorHandler::logInfo("Client " + conn.address.toString() + " is player " + std::to_string(playerId));
+    }
+    
+    void onReady(PendingConnection& conn) {
+        ReadyPacket packet;
+        std::memcpy(&packet, conn.inbox.data(), sizeof(packet));
+        conn.inboxBytes = 0;
+        if (packet.type != MessageType::CLIENT_READY || !packet.isReady) {
+            ErrorHandler::handleInvalidPacket("ReadyPacket validation failed", conn.address.toString());
+            return;
+        }
+        ErrorHandler::logInfo("Client " + conn.address.toString() + " is ready");
+        
+        if (hooks_.ready(conn)) {
+            handOver(conn);
+            return;
+        }
+        conn.stage = PendingConnection::Stage::SendStart;
+        conn.deadline = clock_.getElapsedTime().asSeconds() + SEND_TIMEOUT;
+    }
+    
+    void flush(PendingConnection& conn) {
+        std::size_t sent = 0;
+        sf::Socket::Status status = conn.socket->send(conn.outbox.data() + conn.outboxSent,
+                                                      conn.outbox.size() - conn.outboxSent, sent);
+        conn.outboxSent += sent;
+        if (status == sf::Socket::Disconnected || status == sf::Socket::Error) {
+            ErrorHandler::logTCPError("Send join handshake", status, conn.address.toString());
+            drop(conn);
+            return;
+        }
+        if (conn.outboxSent < conn.outbox.size()) {
+            return;  // Partial or NotReady: the rest goes out on a later poll
+        }
+        
+        conn.outbox.clear();
+        conn.outboxSent = 0;
+        if (conn.stage == PendingConnection::Stage::SendWorld) {
+            ErrorHandler::logInfo("Sent map, shops and positions to " + conn.address.toString());
+            unwatch(conn);
+            conn.stage = PendingConnection::Stage::AwaitReady;
+            hooks_.welcomed(conn);
+            if (conn.inboxBytes == sizeof(ReadyPacket)) {
+                onReady(conn);
             }
+        } else if (conn.stage == PendingConnection::Stage::SendStart) {
+            ErrorHandler::logInfo("Sent StartPacket to " + conn.address.toString());
+            hooks_.started(conn);
+            handOver(conn);
         }
     }
     
-    // Step 6: Debug output in debug builds only
-    #ifdef _DEBUG
-    std::cout << "Walls rendered: " << wallCount << std::endl;
-    #endif
+    // The hook took conn.socket (never in the selector in these stages)
+    void handOver(PendingConnection& conn) {
+        stats_.handedOver++;
+        conn.closed = true;
+    }
+    
+    void drop(PendingConnection& conn) {
+        if (conn.playerId != HOST_PLAYER_ID) {
+            hooks_.dropped(conn);
+            stats_.dropped++;
+        }
+        conn.closed = true;
+    }
+    
+    sf::TcpListener& listener_;
+    std::vector<char> world_;  // Map + shops, identical for every client
+    AcceptorHooks hooks_;
+    sf::SocketSelector selector_;
+    bool listening_ = false;   // Listener in the selector
+    std::vector<PendingConnection> pending_;
+    sf::Clock clock_;
+    AcceptorStats stats_;
+};
+
+// Pick the lowest free remote player ID (1..MAX_PLAYERS-1)
+// Returns: the ID, or HOST_PLAYER_ID if the server is full
+uint32_t allocatePlayerId() {
+    std::lock_guard<std::mutex> lock(clientsMutex);
+    for (uint32_t id = 1; id < MAX_PLAYERS; ++id) {
+        bool used = gameState.hasPlayer(id);
+        for (const auto& client : connectedClients) {
+            if (client.playerId == id) {
+                used = true;
+                break;
+            }
+        }
+        if (!used) {
+            return id;
+        }
+    }
+    return HOST_PLAYER_ID;
 }
 
-// ========================
-// NEW: Cell-Based Collision System with Sliding
-// ========================
+// Move a ready client's socket into connectedClients (caller holds clientsMutex)
+void addReadyClient(PendingConnection& conn) {
+    ClientConnection client;
+    client.socket = std::move(conn.socket);
+    client.address = conn.address;
+    client.isReady = true;
+    client.playerId = conn.playerId;
+    connectedClients.push_back(std::move(client));
+    gameState.setPlayerReady(conn.playerId, true);
+}
 
-// Helper function to check if a position collides with walls
-bool checkCollision(sf::Vector2f pos, const std::vector<std::vector<Cell>>& grid) {
-    sf::FloatRect playerRect(
-        pos.x - PLAYER_SIZE / 2.0f,
-        pos.y - PLAYER_SIZE / 2.0f,
-        PLAYER_SIZE,
-        PLAYER_SIZE
-    );
+// TCP listener thread: runs every client's join handshake (see ConnectionAcceptor)
+void tcpListenerThread(sf::TcpListener* listener, const CellGrid* grid) {
+    ErrorHandler::logInfo("=== TCP Listener Thread Started ===");
+    ErrorHandler::logInfo("Listening on port 53000 for incoming connections");
     
-    int playerCellX = static_cast<int>(pos.x / CELL_SIZE);
-    int playerCellY = static_cast<int>(pos.y / CELL_SIZE);
+    // Map and shops are fixed once the server is up: serialize them once for all clients
+    std::vector<char> world;
+    appendMapData(world, *grid);
+    appendShopData(world, shops);
     
-    int startX = std::max(0, playerCellX - 1);
-    int startY = std::max(0, playerCellY - 1);
-    int endX = std::min(GRID_SIZE - 1, playerCellX + 1);
-    int endY = std::min(GRID_SIZE - 1, playerCellY + 1);
+    AcceptorHooks hooks;
+    hooks.admit = [grid](const sf::IpAddress& address, std::vector<char>& out) -> uint32_t {
+        uint32_t playerId = allocatePlayerId();
+        if (playerId == HOST_PLAYER_ID) {
+            return HOST_PLAYER_ID;
+        }
+        
+        // Same starting equipment as the client's own copy, so their purchases agree
+        Player newPlayer;
+        newPlayer.id = playerId;
+        newPlayer.ipAddress = address;
+        initializePlayer(newPlayer);
+        gameState.withPlayers([&](std::map<uint32_t, Player>& players) {
+            Position spawn = findSpawnPosition(*grid, players, playerId);
+            newPlayer.x = newPlayer.previousX = spawn.x;
+            newPlayer.y = newPlayer.previousY = spawn.y;
+            players[playerId] = newPlayer;
+        });
+        
+        // Server player position first
+        PositionPacket serverPosPacket;
+        serverPosPacket.x = serverPos.x;
+        serverPosPacket.y = serverPos.y;
+        serverPosPacket.isAlive = !headlessMode; // No host player on a dedicated server
+        serverPosPacket.frameID = 0;
+        serverPosPacket.playerId = HOST_PLAYER_ID;
+        appendPacket(out, serverPosPacket);
+        
+        // Then the client's spawn position; playerId tells the client its assigned ID
+        PositionPacket clientPosPacket;
+        clientPosPacket.x = newPlayer.x;
+        clientPosPacket.y = newPlayer.y;
+        clientPosPacket.isAlive = true;
+        clientPosPacket.frameID = 0;
+        clientPosPacket.playerId = static_cast<uint8_t>(playerId);
+        appendPacket(out, clientPosPacket);
+        return playerId;
+    };
     
-    for (int i = startX; i <= endX; i++) {
-        for (int j = startY; j <= endY; j++) {
-            float x = i * CELL_SIZE;
-            float y = j * CELL_SIZE;
-            
-            if (grid[i][j].topWall != WallType::None) {
-                sf::FloatRect wallRect(x, y - WALL_WIDTH / 2.0f, WALL_LENGTH, WALL_WIDTH);
-                if (playerRect.intersects(wallRect)) return true;
-            }
-            
-            if (grid[i][j].rightWall != WallType::None) {
-                sf::FloatRect wallRect(x + CELL_SIZE - WALL_WIDTH / 2.0f, y, WALL_WIDTH, WALL_LENGTH);
-                if (playerRect.intersects(wallRect)) return true;
-            }
-            
-            if (grid[i][j].bottomWall != WallType::None) {
-                sf::FloatRect wallRect(x, y + CELL_SIZE - WALL_WIDTH / 2.0f, WALL_LENGTH, WALL_WIDTH);
-                if (playerRect.intersects(wallRect)) return true;
-            }
-            
-            if (grid[i][j].leftWall != WallType::None) {
-                sf::FloatRect wallRect(x - WALL_WIDTH / 2.0f, y, WALL_WIDTH, WALL_LENGTH);
-                if (playerRect.intersects(wallRect)) return true;
-            }
+    hooks.welcomed = [](const PendingConnection&) {
+        std::lock_guard<std::mutex> lock(clientsMutex);
+        connectionStatus = "The player is connected, but not ready"; // Player connected but not ready in Russian
+        connectionStatusColor = sf::Color::Yellow;
+    };
+    
+    hooks.ready = [](PendingConnection& conn) {
+        std::lock_guard<std::mutex> lock(clientsMutex);
+        connectionStatus = "The player is connected and ready to play"; // Player connected and ready to play in Russian
+        connectionStatusColor = sf::Color::Green;
+        showPlayButton = true;
+        
+        // The PLAY button only starts clients that are ready before it is pressed
+        if (serverState.load() == ServerState::MainScreen) {
+            ErrorHandler::logInfo("Server is already in game, sending StartPacket immediately");
+            StartPacket startPacket;
+            startPacket.type = MessageType::SERVER_START;
+            startPacket.timestamp = static_cast<uint32_t>(std::time(nullptr));
+            startPacket.tickRate = static_cast<uint16_t>(serverTickRate);
+            appendPacket(conn.outbox, startPacket);
+            return false;
         }
-    }
+        addReadyClient(conn);
+        return true;
+    };
     
-    return false;
+    hooks.started = [](PendingConnection& conn) {
+        std::lock_guard<std::mutex> lock(clientsMutex);
+        addReadyClient(conn);
+    };
+    
+    hooks.dropped = [](const PendingConnection& conn) {
+        gameState.removePlayer(conn.playerId);
+    };
+    
+    ConnectionAcceptor acceptor(*listener, std::move(world), std::move(hooks));
+    while (true) {
+        acceptor.poll(sf::milliseconds(50));
+    }
 }
 
-// Resolve collision with wall sliding
-// This function implements smooth wall sliding when player moves diagonally into a wall
-//
-// ALGORITHM:
-// 1. Check if new position collides
-// 2. If no collision, return new position
-// 3. If collision, try sliding along X axis (keep Y from newPos, X from oldPos)
-// 4. If X-slide works, return that position
-// 5. If X-slide fails, try sliding along Y axis (keep X from newPos, Y from oldPos)
-// 6. If Y-slide works, return that position
-// 7. If both fail, return old position (stuck against corner)
+// ========================
+// Lag Compensation
+// ========================
+
+// Where a player was during one simulation tick
+// prev -> current is exactly the motion the swept bullet test used on that tick
+struct PositionSample {
+    uint32_t tick = 0;
+    float prevX = 0.0f;
+    float prevY = 0.0f;
+    float x = 0.0f;
+    float y = 0.0f;
+    bool isAlive = false;
+};
+
+// Per-player ring buffer of the last HISTORY_SIZE tick samples
 //
-// SLIDING BEHAVIOR:
-// - When moving diagonally into a horizontal wall, player slides horizontally
-// - When moving diagonally into a vertical wall, player slides vertically
-// - This creates smooth, intuitive movement along walls
-// - No more getting stuck when pressing two keys at once
+// A client sees other players as they were in the latest snapshot it received,
+// i.e. some ticks in the past. Its shots carry that snapshot's tick (ShotPacket::viewTick)
+// and the server tests the bullet against targets rewound by the same number of
+// ticks, so a shot that hit on the shooter's screen also hits on the server.
 //
-// PERFORMANCE:
-// - Maximum 3 collision checks per frame (newPos, slideX, slideY)
-// - Each check examines ~10-15 walls in nearby cells
-// - Target: < 0.3ms per collision resolution
-sf::Vector2f resolveCollisionCellBased(sf::Vector2f oldPos, sf::Vector2f newPos, const std::vector<std::vector<Cell>>& grid) {
-    // Step 1: Check if new position collides
-    if (!checkCollision(newPos, grid)) {
-        // No collision, clamp to map boundaries and return
-        newPos.x = std::max(PLAYER_SIZE / 2.0f, std::min(newPos.x, MAP_SIZE - PLAYER_SIZE / 2.0f));
-        newPos.y = std::max(PLAYER_SIZE / 2.0f, std::min(newPos.y, MAP_SIZE - PLAYER_SIZE / 2.0f));
-        return newPos;
-    }
-    
-    // Step 2: Collision detected, try sliding along X axis
-    // Keep the new X position, but use old Y position
-    sf::Vector2f slideX(newPos.x, oldPos.y);
-    if (!checkCollision(slideX, grid)) {
-        // X-axis slide works! Player slides horizontally along the wall
-        slideX.x = std::max(PLAYER_SIZE / 2.0f, std::min(slideX.x, MAP_SIZE - PLAYER_SIZE / 2.0f));
-        slideX.y = std::max(PLAYER_SIZE / 2.0f, std::min(slideX.y, MAP_SIZE - PLAYER_SIZE / 2.0f));
-        return slideX;
+// ALGORITHM:
+// One sample is recorded per executed tick, so the slot for a tick is simply
+// tick % HISTORY_SIZE; at() checks the stored tick to reject overwritten or
+// never-recorded slots. Lookups are O(1) and the buffer never allocates.
+class PositionHistory {
+public:
+    static const uint32_t HISTORY_SIZE = 64;  // > LAG_COMPENSATION_MAX_REWIND at 240 Hz
+    
+    void record(uint32_t tick, const Player& player) {
+        PositionSample& sample = samples_[tick % HISTORY_SIZE];
+        sample.tick = tick;
+        sample.prevX = player.previousX;
+        sample.prevY = player.previousY;
+        sample.x = player.x;
+        sample.y = player.y;
+        sample.isAlive = player.isAlive;
+        recorded_ = true;
+    }
+    
+    // Sample recorded on the given tick, or nullptr if it is not in the buffer
+    const PositionSample* at(uint32_t tick) const {
+        const PositionSample& sample = samples_[tick % HISTORY_SIZE];
+        if (!recorded_ || sample.tick != tick) {
+            return nullptr;
+        }
+        return &sample;
     }
     
-    // Step 3: X-axis slide failed, try sliding along Y axis
-    // Keep the new Y position, but use old X position
-    sf::Vector2f slideY(oldPos.x, newPos.y);
-    if (!checkCollision(slideY, grid)) {
-        // Y-axis slide works! Player slides vertically along the wall
-        slideY.x = std::max(PLAYER_SIZE / 2.0f, std::min(slideY.x, MAP_SIZE - PLAYER_SIZE / 2.0f));
-        slideY.y = std::max(PLAYER_SIZE / 2.0f, std::min(slideY.y, MAP_SIZE - PLAYER_SIZE / 2.0f));
-        return slideY;
+private:
+    std::array<PositionSample, HISTORY_SIZE> samples_;
+    bool recorded_ = false;  // Tick 0 must not match default-constructed samples
+};
+
+// Upper bound on how far back shots are rewound; older views are clamped so a
+// lagging client cannot hit players who have long since moved behind cover
+const float LAG_COMPENSATION_MAX_REWIND = 0.25f;  // Seconds
+
+// Furthest a client's shot origin may be from where the server had that player
+// during the rewind window (the client predicts ahead of the server by its input delay)
+const float SHOT_ORIGIN_TOLERANCE = 100.0f;
+
+// Position history per player ID
+// Only touched on the simulation thread (under the global mutex)
+std::map<uint32_t, PositionHistory> positionHistories;
+
+// Convert a client's view tick into a rewind distance in ticks
+// A client that saw the last completed tick (currentTick - 1) needs no rewind: its
+// bullet's first step plays against the motion of the tick being simulated now.
+// Future or missing view ticks (e.g. before the first snapshot) also mean no rewind.
+uint16_t computeRewindTicks(uint32_t viewTick, uint32_t currentTick, uint32_t maxRewindTicks) {
+    if (viewTick == 0 || viewTick >= currentTick) {
+        return 0;
     }
-    
-    // Step 4: Both slides failed (stuck in corner), return old position
-    return oldPos;
+    return static_cast<uint16_t>(std::min(currentTick - 1 - viewTick, maxRewindTicks));
 }
 
 // ========================
-// NEW: Map Serialization Functions
+// Client Channels
 // ========================
 
-// Serialize the cell-based grid map into a byte buffer for network transmission
-// Parameters:
-//   grid - The cell grid to serialize
-//   buffer - Output buffer to store serialized data
-//
-// SERIALIZATION FORMAT:
-// The grid is serialized as a contiguous block of memory containing all Cell structures.
-// Each Cell is 4 bytes (4 booleans), and we have GRID_SIZE × GRID_SIZE cells.
-// Total size: 167 × 167 × 4 = 111,556 bytes (~109 KB)
+// Latency and loss of one client connection, for the performance report
 //
 // ALGORITHM:
-// 1. Resize buffer to fit the entire grid
-// 2. Use std::memcpy to copy grid data directly into buffer
-// 3. This is efficient because Cell structure is POD (Plain Old Data)
+// RTT: the send time of the last SENT_SNAPSHOTS snapshots is kept. The client
+// acknowledges the newest snapshot in every input message together with how
+// long it held it (ackDelay), so arrival - send - ackDelay is one round trip
+// without the client's 20 Hz send phase in it. Each tick is sampled once, from
+// the first input message acknowledging it, and smoothed by RttEstimator.
+// Upstream loss: gaps in the client's wire sequence (SequenceTracker).
+// Downstream loss: the client's running count of missing server sequence
+// numbers; its 16-bit differences are summed, so reordered reports cancel out.
 //
 // PERFORMANCE:
-// - Memory copy operation: O(n) where n = grid size
-// - Typical time: < 1ms for 109 KB
-// - Network transmission time: ~10-50ms depending on connection
-void serializeMap(const std::vector<std::vector<Cell>>& grid, std::vector<char>& buffer) {
-    // Calculate total size needed for serialization
-    // Each Cell is sizeof(Cell) bytes, and we have GRID_SIZE × GRID_SIZE cells
-    size_t totalSize = GRID_SIZE * GRID_SIZE * sizeof(Cell);
-    
-    // Resize buffer to fit all data
-    buffer.resize(totalSize);
+// Fixed arrays, no allocation; a snapshot ack scans SENT_SNAPSHOTS entries.
+class LinkQuality {
+public:
+    static const size_t SENT_SNAPSHOTS = 32;  // 1.6 s at 20 Hz; older acks give no sample
     
-    // Copy grid data into buffer
-    // We need to copy row by row because std::vector<std::vector<>> is not contiguous
-    size_t offset = 0;
-    for (int i = 0; i < GRID_SIZE; i++) {
-        // Copy entire row at once
-        std::memcpy(buffer.data() + offset, grid[i].data(), GRID_SIZE * sizeof(Cell));
-        offset += GRID_SIZE * sizeof(Cell);
+    LinkQuality() {
+        for (SentSnapshot& sent : sent_) {
+            sent.tick = NO_SNAPSHOT_ACK;
+        }
     }
     
-    std::cout << "[INFO] Map serialized: " << totalSize << " bytes (" 
-              << (totalSize / 1024) << " KB)" << std::endl;
-}
-
-// Send the serialized map to a connected client via TCP
-// Parameters:
-//   clientSocket - TCP socket connected to the client
-//   grid - The cell grid to send
-// Returns: true if successful, false if any error occurred
-//
-// PROTOCOL:
-// 1. Send data size as uint32_t (4 bytes)
-// 2. Send serialized map data (variable size, ~109 KB)
-//
-// ERROR HANDLING:
-// - Logs errors using ErrorHandler
-// - Returns false on any transmission error
-// - Client should disconnect and retry if this fails
-//
-// PERFORMANCE:
-// - TCP ensures reliable delivery (retransmits if packets lost)
-// - Typical transmission time: 10-50ms on LAN, 50-200ms on internet
-// - Blocking operation: thread will wait until all data is sent
-bool sendMapToClient(sf::TcpSocket& clientSocket, const std::vector<std::vector<Cell>>& grid) {
-    std::cout << "[INFO] Preparing to send map to client..." << std::endl;
+    // A snapshot for tick went out at now (networkClock)
+    void onSnapshotSent(uint32_t tick, float now) {
+        sent_[sentCount_ % SENT_SNAPSHOTS] = SentSnapshot{ tick, now };
+        sentCount_++;
+    }
     
-    // Step 1: Serialize the map into a byte buffer
-    std::vector<char> mapData;
-    serializeMap(grid, mapData);
+    // An input message that arrived at receivedAt acknowledged tick, held ackDelay ms
+    void onSnapshotAck(uint32_t tick, uint16_t ackDelay, float receivedAt) {
+        if (ackDelay == NO_ACK_DELAY || (sampledAny_ && tick <= lastSampledTick_)) {
+            return;
+        }
+        for (const SentSnapshot& sent : sent_) {
+            if (sent.tick == tick) {
+                rtt_.sample(std::max(0.0f, receivedAt - sent.sentAt - ackDelay * 0.001f));
+                lastSampledTick_ = tick;
+                sampledAny_ = true;
+                return;
+            }
+        }
+    }
     
-    // Step 2: Send the size of the data first (4 bytes)
-    uint32_t dataSize = static_cast<uint32_t>(mapData.size());
-    std::cout << "[INFO] Sending map data size: " << dataSize << " bytes" << std::endl;
+    // Wire sequence of a datagram from the client
+    void onDatagram(uint32_t sequence) {
+        upstream_.onDatagram(sequence);
+    }
     
-    sf::Socket::Status sizeStatus = clientSocket.send(&dataSize, sizeof(dataSize));
-    if (sizeStatus != sf::Socket::Done) {
-        ErrorHandler::logTCPError("Send map data size", sizeStatus, 
-                                 clientSocket.getRemoteAddress().toString());
-        return false;
+    void onDatagramsSent(uint32_t count) {
+        downstreamSent_ += count;
     }
     
-    std::cout << "[INFO] Map data size sent successfully" << std::endl;
+    // The client's count of missing server sequence numbers (input message lostDatagrams)
+    void onDownstreamReport(uint16_t lostDatagrams) {
+        downstreamLost_ += static_cast<int16_t>(static_cast<uint16_t>(lostDatagrams - lastLostReport_));
+        lastLostReport_ = lostDatagrams;
+    }
     
-    // Step 3: Send the actual map data
-    std::cout << "[INFO] Sending map data..." << std::endl;
+    const RttEstimator& rtt() const { return rtt_; }
+    const SequenceTracker& upstream() const { return upstream_; }
+    uint64_t downstreamSent() const { return downstreamSent_; }
+    int64_t downstreamLost() const { return downstreamLost_; }
     
-    sf::Socket::Status dataStatus = clientSocket.send(mapData.data(), mapData.size());
-    if (dataStatus != sf::Socket::Done) {
-        ErrorHandler::logTCPError("Send map data", dataStatus, 
-                                 clientSocket.getRemoteAddress().toString());
-        return false;
+    // Counters since the previous call, plus the current RTT estimate
+    ConnectionReport takeReport(uint32_t playerId, uint64_t reliableResends) {
+        ConnectionReport report;
+        report.playerId = playerId;
+        report.hasRtt = rtt_.hasSample();
+        report.rtt = rtt_.smoothed();
+        report.rttJitter = rtt_.variance();
+        report.upstreamReceived = upstream_.received() - reported_.upstreamReceived;
+        report.upstreamLost = static_cast<int64_t>(upstream_.lost()) - reported_.upstreamLost;
+        report.upstreamOutOfOrder = upstream_.outOfOrder() - reported_.upstreamOutOfOrder;
+        report.upstreamDuplicates = upstream_.duplicates() - reported_.upstreamDuplicates;
+        report.downstreamSent = downstreamSent_ - reported_.downstreamSent;
+        report.downstreamLost = downstreamLost_ - reported_.downstreamLost;
+        report.reliableResends = reliableResends - reported_.reliableResends;
+        
+        reported_.upstreamReceived = upstream_.received();
+        reported_.upstreamLost = static_cast<int64_t>(upstream_.lost());
+        reported_.upstreamOutOfOrder = upstream_.outOfOrder();
+        reported_.upstreamDuplicates = upstream_.duplicates();
+        reported_.downstreamSent = downstreamSent_;
+        reported_.downstreamLost = downstreamLost_;
+        reported_.reliableResends = reliableResends;
+        return report;
     }
     
-    std::cout << "[INFO] Map data sent successfully to client" << std::endl;
-    return true;
-}
+private:
+    struct SentSnapshot {
+        uint32_t tick;
+        float sentAt;
+    };
+    
+    std::array<SentSnapshot, SENT_SNAPSHOTS> sent_;
+    size_t sentCount_ = 0;
+    uint32_t lastSampledTick_ = 0;
+    bool sampledAny_ = false;
+    RttEstimator rtt_;
+    SequenceTracker upstream_;
+    uint64_t downstreamSent_ = 0;
+    int64_t downstreamLost_ = 0;
+    uint16_t lastLostReport_ = 0;
+    ConnectionReport reported_;  // Totals at the previous takeReport()
+};
 
-// Send shop positions to a connected client via TCP
-// Parameters:
-//   clientSocket - TCP socket connected to the client
-//   shops - Vector of shops to send
-// Returns: true if successful, false if any error occurred
+// Per-client stream state
+// history holds the snapshots sent to the client; lastAck is the newest snapshot
+// tick the client reported receiving (input message ackTick) and becomes the
+// delta baseline; outgoingSequence is the wire sequence of the next datagram;
+// reliable carries hits and purchases both ways (see ReliableChannel);
+// link measures the connection's latency and loss (see LinkQuality)
+struct ClientChannel {
+    SnapshotHistory history;
+    uint32_t lastAck = NO_SNAPSHOT_ACK;
+    uint32_t outgoingSequence = 0;
+    ReliableChannel reliable;
+    LinkQuality link;
+};
+
+// Channel per remote player ID
+// Only touched on the simulation thread (under the global mutex)
+std::map<uint32_t, ClientChannel> clientChannels;
+
+// ========================
+// Input Queues
+// ========================
+
+// Per-player buffer of received input commands waiting to be simulated
 //
-// PROTOCOL:
-// 1. Send shop count as uint8_t (1 byte)
-// 2. For each shop, send gridX and gridY as int32_t (8 bytes per shop)
+// Clients repeat their newest commands in every datagram, so receive() keeps only
+// sequences newer than any seen before (duplicates and reordered datagrams are
+// dropped). Commands lost for good are simply skipped; the InputAck tells the
+// client which command the server is at and its prediction is corrected.
 //
-// ERROR HANDLING:
-// - Logs errors using ErrorHandler
-// - Returns false on any transmission error
-bool sendShopsToClient(sf::TcpSocket& clientSocket, const std::vector<Shop>& shops) {
-    std::cout << "[INFO] Preparing to send shops to client..." << std::endl;
-    
-    // Step 1: Send shop count
-    uint8_t shopCount = static_cast<uint8_t>(shops.size());
-    std::cout << "[INFO] Sending shop count: " << static_cast<int>(shopCount) << std::endl;
+// ALGORITHM:
+// Commands are simulated at the rate the client sampled them: every tick adds
+// deltaTime * INPUT_RATE commands of credit, capped at MAX_CREDIT, and each
+// simulated command spends one. Commands arriving in a 20 Hz batch are simulated
+// as soon as they arrive, but a client sending more than INPUT_RATE commands per
+// second (fast clock, speed hack) only fills the queue - the server sets the pace.
+//
+// PERFORMANCE:
+// Fixed ring of CAPACITY commands, no allocation; an idle player costs one
+// comparison per tick.
+class InputQueue {
+public:
+    static const size_t CAPACITY = 16;          // ~0.27 s of commands; older ones are dropped when full
+    static constexpr float MAX_CREDIT = 15.0f;  // Commands (0.25 s): catch-up burst after a stall
     
-    sf::Socket::Status countStatus = clientSocket.send(&shopCount, sizeof(shopCount));
-    if (countStatus != sf::Socket::Done) {
-        ErrorHandler::logTCPError("Send shop count", countStatus, 
-                                 clientSocket.getRemoteAddress().toString());
-        return false;
+    // Queue one received command
+    // Returns: false for a duplicate or stale sequence
+    bool receive(const InputCommand& command) {
+        if (received_ && command.sequence <= newestSequence_) {
+            return false;
+        }
+        if (count_ == CAPACITY) {
+            head_ = (head_ + 1) % CAPACITY;
+            count_--;
+        }
+        commands_[(head_ + count_) % CAPACITY] = command;
+        count_++;
+        newestSequence_ = command.sequence;
+        received_ = true;
+        return true;
     }
     
-    // Step 2: Send each shop's grid position
-    for (const auto& shop : shops) {
-        struct ShopData {
-            int32_t gridX;
-            int32_t gridY;
-        } shopData;
+    // Simulate the commands this tick's credit allows, oldest first
+    // Returns: number of commands passed to apply(const InputCommand&)
+    template <typename ApplyFn>
+    size_t consume(float deltaTime, ApplyFn apply) {
+        // Tick deltas are not exact multiples of INPUT_STEP; the epsilon keeps a
+        // 60 Hz server from always running one tick behind on rounding
+        const float epsilon = 0.001f;
+        credit_ = std::min(credit_ + deltaTime * INPUT_RATE, MAX_CREDIT);
         
-        shopData.gridX = shop.gridX;
-        shopData.gridY = shop.gridY;
-        
-        sf::Socket::Status shopStatus = clientSocket.send(&shopData, sizeof(shopData));
-        if (shopStatus != sf::Socket::Done) {
-            ErrorHandler::logTCPError("Send shop data", shopStatus, 
-                                     clientSocket.getRemoteAddress().toString());
-            return false;
+        size_t simulated = 0;
+        while (count_ > 0 && credit_ >= 1.0f - epsilon) {
+            const InputCommand& command = commands_[head_];
+            apply(command);
+            lastSimulated_ = command.sequence;
+            simulatedAny_ = true;
+            head_ = (head_ + 1) % CAPACITY;
+            count_--;
+            credit_ -= 1.0f;
+            simulated++;
         }
+        return simulated;
     }
     
-    std::cout << "[INFO] Shops sent successfully: " << static_cast<int>(shopCount) << " shops" << std::endl;
-    return true;
+    // Whether any command has been simulated (only then is there something to acknowledge)
+    bool hasSimulated() const { return simulatedAny_; }
+    
+    // Sequence of the newest simulated command
+    uint32_t lastSimulated() const { return lastSimulated_; }
+    
+    size_t pending() const { return count_; }
+    
+private:
+    std::array<InputCommand, CAPACITY> commands_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    uint32_t newestSequence_ = 0;
+    bool received_ = false;
+    uint32_t lastSimulated_ = 0;
+    bool simulatedAny_ = false;
+    float credit_ = 0.0f;
+};
+
+// Input queue per remote player ID
+// Only touched on the simulation thread (under the global mutex)
+std::map<uint32_t, InputQueue> inputQueues;
+
+// ========================
+// Interest Management
+// ========================
+
+// Index of the lowest set bit (mask must be non-zero)
+inline int lowestSetBit(uint64_t mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(mask);
+#endif
 }
 
+static_assert(MAX_PLAYERS <= 64, "Snapshot culling stores player IDs in 64-bit masks");
+
 // ========================
-// Thread-Safe Game State Manager
+// Line-of-Sight Relevancy
 // ========================
 
-class GameState {
-public:
-    // Thread-safe update player position
-    void updatePlayerPosition(uint32_t playerId, float x, float y) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (players_.count(playerId)) {
-            players_[playerId].previousX = players_[playerId].x;
-            players_[playerId].previousY = players_[playerId].y;
-            players_[playerId].x = x;
-            players_[playerId].y = y;
-        }
-    }
-    
-    // Thread-safe get player
-    Player getPlayer(uint32_t playerId) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (players_.count(playerId)) {
-            return players_.at(playerId);
-        }
-        return Player(); // Return default player if not found
-    }
-    
-    // Thread-safe get players within radius
-    std::vector<Player> getPlayersInRadius(sf::Vector2f center, float radius) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        std::vector<Player> result;
-        
-        for (const auto& pair : players_) {
-            const Player& player = pair.second;
-            float dx = player.x - center.x;
-            float dy = player.y - center.y;
-            float distance = std::sqrt(dx * dx + dy * dy);
-            
-            if (distance <= radius) {
-                result.push_back(player);
-            }
-        }
-        
-        return result;
+// Players hidden behind concrete walls are not replicated to a client: it saves
+// the bandwidth and a modified client cannot draw them through walls.
+const float LOS_HIDE_GRACE = 0.5f;           // Seconds a player that went out of sight is still sent
+const float LOS_TARGET_MARGIN = 40.0f;       // Side rays aim this far beside the target's center
+const float LOS_RECHECK_DISTANCE = 25.0f;    // Movement (per axis, px) that invalidates a cached result
+const int LOS_MAX_PAIR_CHECKS_PER_TICK = 512;
+
+// True if no concrete wall blocks the segment (wood does not block sight)
+inline bool concreteLineOfSight(const CellGrid& grid, float x1, float y1, float x2, float y2) {
+    return Bullet::traceCellWallsDDA(grid, x1, y1, x2, y2, true).type == WallType::None;
+}
+
+// Whether a viewer at (vx, vy) can see any part of a target at (tx, ty)
+// Tests the center ray and two rays LOS_TARGET_MARGIN to either side of the
+// target, so players peeking around a corner are sent before their center is
+// visible (the client's fog and the 20 Hz snapshot delay need that slack).
+// Returns: visibility; rays counts the traversals used (1-3)
+inline bool targetVisible(const CellGrid& grid, float vx, float vy, float tx, float ty,
+                          int& rays) {
+    rays = 1;
+    if (concreteLineOfSight(grid, vx, vy, tx, ty)) {
+        return true;
     }
     
-    // Thread-safe set player ready status
-    void setPlayerReady(uint32_t playerId, bool ready) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (players_.count(playerId)) {
-            players_[playerId].isReady = ready;
-        }
+    const float dx = tx - vx;
+    const float dy = ty - vy;
+    const float length = std::sqrt(dx * dx + dy * dy);
+    if (length < 0.001f) {
+        return true;
     }
+    const float px = -dy / length * LOS_TARGET_MARGIN;
+    const float py = dx / length * LOS_TARGET_MARGIN;
     
-    // Thread-safe check if all players are ready
-    bool allPlayersReady() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (players_.empty()) {
-            return false;
-        }
+    rays = 2;
+    if (concreteLineOfSight(grid, vx, vy, tx + px, ty + py)) {
+        return true;
+    }
+    rays = 3;
+    return concreteLineOfSight(grid, vx, vy, tx - px, ty - py);
+}
+
+// Per viewer/target pair visibility cache with hysteresis
+//
+// ALGORITHM:
+// - A pair is re-traced only when the viewer or the target moved into another
+//   LOS_RECHECK_DISTANCE square since the last trace (the map never changes), so
+//   standing players cost nothing after the first tick.
+// - At most LOS_MAX_PAIR_CHECKS_PER_TICK pairs are re-traced per call to
+//   beginTick(); pairs over the budget keep their cached result until a later tick.
+//   Pairs never traced are treated as visible.
+// - Hysteresis: a target stays relevant for graceTicks after it was last seen,
+//   so players flickering along wall edges don't pop in and out. Becoming
+//   visible takes effect immediately.
+//
+// PERFORMANCE: each trace is 1-3 grid traversals (Bullet::traceCellWallsDDA),
+// O(cells crossed); with the cache, per-tick cost scales with how many players
+// moved, not with players^2.
+class LineOfSightRelevancy {
+public:
+    // Start a snapshot tick: resets the re-trace budget
+    void beginTick() {
+        budget_ = LOS_MAX_PAIR_CHECKS_PER_TICK;
+        raysThisTick_ = 0;
+    }
+    
+    // Whether the target should be replicated to the viewer this tick
+    bool isRelevant(const CellGrid& grid, uint32_t viewerId, float vx, float vy,
+                    uint32_t targetId, float tx, float ty, uint32_t tickNumber, uint32_t graceTicks) {
+        PairState& pair = pairs_[viewerId * MAX_PLAYERS + targetId];
+        const int32_t viewerKey = positionKey(vx, vy);
+        const int32_t targetKey = positionKey(tx, ty);
         
-        for (const auto& pair : players_) {
-            const Player& player = pair.second;
-            if (!player.isReady) {
-                return false;
-            }
+        const bool stale = (pair.viewerKey != viewerKey || pair.targetKey != targetKey);
+        if (stale && budget_ > 0) {
+            budget_--;
+            int rays = 0;
+            pair.visible = targetVisible(grid, vx, vy, tx, ty, rays);
+            pair.viewerKey = viewerKey;
+            pair.targetKey = targetKey;
+            raysThisTick_ += rays;
         }
         
-        return true;
+        if (pair.viewerKey == NO_KEY || pair.visible) {
+            pair.lastVisibleTick = tickNumber;
+            pair.seen = true;
+            return true;
+        }
+        return pair.seen && tickNumber - pair.lastVisibleTick <= graceTicks;
     }
     
-    // Thread-safe add player
-    void addPlayer(uint32_t playerId, const Player& player) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        players_[playerId] = player;
+    // Drop every pair the player is part of, as viewer or target
+    // Call when the player leaves: its ID may be reused by a new player
+    void forgetPlayer(uint32_t playerId) {
+        if (playerId >= MAX_PLAYERS) {
+            return;
+        }
+        for (uint32_t other = 0; other < MAX_PLAYERS; ++other) {
+            pairs_[playerId * MAX_PLAYERS + other] = PairState();
+            pairs_[other * MAX_PLAYERS + playerId] = PairState();
+        }
     }
     
-    // Thread-safe remove player
-    void removePlayer(uint32_t playerId) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        players_.erase(playerId);
-    }
+    // Grid traversals used since beginTick()
+    int raysThisTick() const { return raysThisTick_; }
     
-    // Thread-safe get all players
-    std::map<uint32_t, Player> getAllPlayers() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return players_;
-    }
+private:
+    static constexpr int32_t NO_KEY = -1;
+    
+    struct PairState {
+        int32_t viewerKey = NO_KEY;  // positionKey() of both ends at the last trace
+        int32_t targetKey = NO_KEY;
+        bool visible = true;
+        bool seen = false;
+        uint32_t lastVisibleTick = 0;
+    };
     
-    // Thread-safe check if player exists
-    bool hasPlayer(uint32_t playerId) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return players_.count(playerId) > 0;
+    static int32_t positionKey(float x, float y) {
+        const int32_t kx = static_cast<int32_t>(std::max(0.0f, x) / LOS_RECHECK_DISTANCE);
+        const int32_t ky = static_cast<int32_t>(std::max(0.0f, y) / LOS_RECHECK_DISTANCE);
+        return (kx << 12) | (ky & 0xFFF);
     }
     
-    // Thread-safe get player count
-    size_t getPlayerCount() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return players_.size();
+    std::array<PairState, MAX_PLAYERS * MAX_PLAYERS> pairs_;
+    int budget_ = LOS_MAX_PAIR_CHECKS_PER_TICK;
+    int raysThisTick_ = 0;
+};
+
+// Visibility cache for snapshot culling
+// Only touched on the simulation thread (under the global mutex)
+LineOfSightRelevancy losRelevancy;
+
+// ========================
+// Inbound Datagram Queue
+// ========================
+
+// Raw datagram received by the UDP listener thread
+// The listener only receives and queues; all game state changes happen on the
+// simulation tick (see runServerTick) so inputs are applied in a deterministic order.
+struct InboundDatagram {
+    sf::IpAddress sender;
+    unsigned short senderPort = 0;
+    std::size_t size = 0;
+    float receivedAt = 0.0f;  // networkClock time (RTT samples)
+    uint8_t data[MAX_DATAGRAM_BYTES];  // DatagramBuilder starts a new datagram before exceeding this
+};
+
+std::vector<InboundDatagram> inboundDatagrams;
+std::mutex inboundMutex;
+
+// Time base shared by the listener and simulation threads: datagram arrival
+// times and the simulation's send times must come from the same clock
+sf::Clock networkClock;
+
+// Bind the server UDP socket to port 53001
+// Must be called before the listener and simulation threads start using the socket,
+// otherwise the first send() would implicitly bind it to a random port.
+bool bindServerUdpSocket(sf::UdpSocket& socket) {
+    sf::Socket::Status bindStatus = socket.bind(53001);
+    if (bindStatus != sf::Socket::Done) {
+        ErrorHandler::logUDPError("Bind UDP socket to port 53001", "Failed to bind");
+        return false;
     }
     
-    // Requirement 8.1: Thread-safe apply damage to player
-    void applyDamage(uint32_t playerId, float damage) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (players_.count(playerId)) {
-            players_[playerId].health -= damage;
-            if (players_[playerId].health < 0.0f) {
-                players_[playerId].health = 0.0f;
-            }
-        }
+    ErrorHandler::logInfo("UDP socket bound successfully to port 53001");
+    return true;
+}
+
+// Parse one row of /proc/net/udp:
+// "sl local_address rem_address st tx_queue:rx_queue tr:tm->when retrnsmt uid timeout inode ref pointer drops"
+// Returns: true with drops set if the row is well formed and bound to localPort;
+// malformed or truncated rows return false (the file can change while it is read)
+bool parseUdpDropsLine(const std::string& line, unsigned short localPort, long long& drops) {
+    std::istringstream fields(line);
+    std::string slot, localAddress, field, lastField;
+    if (!(fields >> slot >> localAddress)) {
+        return false;
     }
     
-    // Requirement 8.3: Thread-safe check if player is dead
-    bool isPlayerDead(uint32_t playerId) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (players_.count(playerId)) {
-            return players_.at(playerId).health <= 0.0f;
-        }
+    size_t colon = localAddress.find(':');
+    if (colon == std::string::npos || colon + 1 >= localAddress.size()) {
         return false;
     }
-    
-    // Requirement 8.4: Thread-safe award money to player
-    void awardMoney(uint32_t playerId, int amount) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (players_.count(playerId)) {
-            players_[playerId].money += amount;
-            ErrorHandler::logInfo("Player " + std::to_string(playerId) + 
-                                 " awarded $" + std::to_string(amount) + 
-                                 ". New balance: $" + std::to_string(players_[playerId].money));
-        }
+    const char* portText = localAddress.c_str() + colon + 1;
+    char* end = nullptr;
+    unsigned long port = std::strtoul(portText, &end, 16);
+    if (end == portText || *end != '\0' || port != localPort) {
+        return false;
     }
     
-    // Requirement 8.5: Thread-safe respawn player
-    void respawnPlayer(uint32_t playerId, float x, float y) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (players_.count(playerId)) {
-            players_[playerId].health = 100.0f;
-            players_[playerId].isAlive = true;
-            players_[playerId].x = x;
-            players_[playerId].y = y;
-            players_[playerId].previousX = x;
-            players_[playerId].previousY = y;
-        }
+    // drops is the last of 13 columns
+    int columns = 2;
+    while (fields >> field) {
+        lastField = field;
+        columns++;
     }
-    
-    // Thread-safe set player alive status
-    void setPlayerAlive(uint32_t playerId, bool alive) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (players_.count(playerId)) {
-            players_[playerId].isAlive = alive;
-        }
+    if (columns < 13) {
+        return false;
     }
-    
-private:
-    mutable std::mutex mutex_;
-    std::map<uint32_t, Player> players_;
-};
-
-// ========================
-// Movement and Interpolation Constants
-// ========================
-
-const float MOVEMENT_SPEED = 3.0f; // 3 units per second
+    end = nullptr;
+    long long value = std::strtoll(lastField.c_str(), &end, 10);
+    if (end == lastField.c_str() || *end != '\0' || value < 0) {
+        return false;
+    }
+    drops = value;
+    return true;
+}
 
-// Linear interpolation function for smooth position transitions
-float lerp(float start, float end, float alpha) {
-    return start + (end - start) * alpha;
+// Find the drop counter of localPort in a /proc/net/udp style table
+// Returns: the first well-formed row's drops, or -1 if there is none
+long long findUdpDrops(std::istream& table, unsigned short localPort) {
+    std::string line;
+    std::getline(table, line); // Skip header
+    while (std::getline(table, line)) {
+        long long drops = 0;
+        if (parseUdpDropsLine(line, localPort, drops)) {
+            return drops;
+        }
+    }
+    return -1;
 }
 
-sf::Vector2f lerpPosition(sf::Vector2f start, sf::Vector2f end, float alpha) {
-    return sf::Vector2f(lerp(start.x, end.x, alpha), lerp(start.y, end.y, alpha));
+// Read the kernel's receive-drop counter for a local UDP port
+// Returns: cumulative drops since the socket was created, or -1 if the platform
+// does not expose a per-socket counter (Windows only has system-wide UDP stats)
+long long readKernelUdpDrops(unsigned short localPort) {
+#ifdef __linux__
+    std::ifstream procFile("/proc/net/udp");
+    if (!procFile) {
+        return -1;
+    }
+    return findUdpDrops(procFile, localPort);
+#else
+    (void)localPort;
+    return -1;
+#endif
 }
 
-// ========================
-// Random Spawn Generation
-// ========================
+// Receive every datagram already queued on a non-blocking socket into batch
+// Returns: false if the socket reported an error; the datagrams after it are
+// picked up on the next wakeup
+bool drainUdpSocket(sf::UdpSocket& socket, std::vector<InboundDatagram>& batch) {
+    while (true) {
+        InboundDatagram datagram;
+        sf::Socket::Status status = socket.receive(datagram.data, sizeof(datagram.data), datagram.size,
+                                                   datagram.sender, datagram.senderPort);
+        
+        if (status == sf::Socket::NotReady) {
+            return true;
+        }
+        if (status != sf::Socket::Done) {
+            return false;
+        }
+        
+        // Stamped here, not on the tick: the tick wait would add up to a tick to every RTT sample
+        datagram.receivedAt = networkClock.getElapsedTime().asSeconds();
+        batch.push_back(datagram);
+    }
+}
 
-// Generate random spawn positions with minimum distance constraint
-// Parameters:
-//   grid - The cell grid to check for wall collisions
-//   minDistance - Minimum distance between spawn points (in pixels)
-// Returns: pair of positions (server spawn, client spawn)
+// UDP listener thread: receives client datagrams and queues them for the simulation tick
 //
 // ALGORITHM:
-// 1. Generate random position for server player
-// 2. Check if position is valid (no wall collision)
-// 3. Generate random position for client player
-// 4. Check if position is valid and distance >= minDistance
-// 5. Retry if constraints not met (max 100 attempts)
-std::pair<Position, Position> generateRandomSpawns(const std::vector<std::vector<Cell>>& grid, float minDistance = 2100.0f) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+// 1. Block on a SocketSelector until the socket is readable (no fixed sleep)
+// 2. Drain every pending datagram with non-blocking receive() until NotReady
+// 3. Push the whole batch to the inbound queue under a single lock
+//
+// PERFORMANCE:
+// The previous loop received one datagram and slept 10ms, capping ingest at
+// ~100 datagrams/s for the whole server - two players with automatic weapons
+// (10 shots/s) plus 20 Hz position updates already came close to that and the
+// OS socket buffer started dropping packets. Draining per wakeup scales with load
+// and wakes up immediately when data arrives.
+void udpListenerThread(sf::UdpSocket* socket, PerformanceMonitor* perfMonitor) {
+    ErrorHandler::logInfo("UDP listener thread started on port 53001");
     
-    // Generate positions with margin from edges (at least 1 cell = 100 pixels)
-    const float MARGIN = CELL_SIZE;
-    std::uniform_real_distribution<float> xDist(MARGIN, MAP_SIZE - MARGIN);
-    std::uniform_real_distribution<float> yDist(MARGIN, MAP_SIZE - MARGIN);
+    // Non-blocking so the drain loop stops as soon as the queue is empty
+    socket->setBlocking(false);
     
-    const int MAX_ATTEMPTS = 100;
+    sf::SocketSelector selector;
+    selector.add(*socket);
     
-    for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
-        // Generate server spawn position
-        Position serverSpawn;
-        serverSpawn.x = xDist(gen);
-        serverSpawn.y = yDist(gen);
-        
-        // Check if server spawn is valid (no wall collision)
-        if (checkCollision(sf::Vector2f(serverSpawn.x, serverSpawn.y), grid)) {
-            continue; // Try again
+    sf::Clock kernelDropsClock;
+    std::vector<InboundDatagram> batch;
+    
+    while (true) {
+        // Poll the kernel drop counter about once per second
+        if (perfMonitor && kernelDropsClock.getElapsedTime() >= sf::seconds(1.0f)) {
+            perfMonitor->setKernelDrops(readKernelUdpDrops(socket->getLocalPort()));
+            kernelDropsClock.restart();
         }
         
-        // Generate client spawn position
-        Position clientSpawn;
-        clientSpawn.x = xDist(gen);
-        clientSpawn.y = yDist(gen);
+        // Wake up when data arrives (timeout keeps the drop counter polling alive)
+        if (!selector.wait(sf::milliseconds(100))) {
+            continue;
+        }
         
-        // Check if client spawn is valid (no wall collision)
-        if (checkCollision(sf::Vector2f(clientSpawn.x, clientSpawn.y), grid)) {
-            continue; // Try again
+        // Drain every pending datagram
+        if (!drainUdpSocket(*socket, batch)) {
+            ErrorHandler::logUDPError("Receive packet", "Socket error occurred");
         }
         
-        // Check distance between spawns
-        float dx = serverSpawn.x - clientSpawn.x;
-        float dy = serverSpawn.y - clientSpawn.y;
-        float distance = std::sqrt(dx * dx + dy * dy);
+        // Track network bandwidth
+        if (perfMonitor) {
+            for (const InboundDatagram& datagram : batch) {
+                perfMonitor->recordNetworkReceived(datagram.size);
+            }
+            perfMonitor->recordReceiveWakeup(static_cast<int>(batch.size()));
+        }
         
-        if (distance >= minDistance) {
-            // Success! Found valid spawn positions
-            std::cout << "[INFO] Generated random spawns:" << std::endl;
-            std::cout << "  Server spawn: (" << serverSpawn.x << ", " << serverSpawn.y << ")" << std::endl;
-            std::cout << "  Client spawn: (" << clientSpawn.x << ", " << clientSpawn.y << ")" << std::endl;
-            std::cout << "  Distance: " << distance << " pixels (" << (distance / CELL_SIZE) << " cells)" << std::endl;
-            std::cout << "  Attempts: " << (attempt + 1) << std::endl;
-            
-            return std::make_pair(serverSpawn, clientSpawn);
+        if (!batch.empty()) {
+            std::lock_guard<std::mutex> lock(inboundMutex);
+            inboundDatagrams.insert(inboundDatagrams.end(), batch.begin(), batch.end());
         }
+        batch.clear();
     }
-    
-    // Failed to find valid spawns, use fallback positions
-    std::cerr << "[WARNING] Failed to generate random spawns after " << MAX_ATTEMPTS << " attempts" << std::endl;
-    std::cerr << "  Using fallback spawn positions" << std::endl;
-    
-    Position serverSpawn = { 250.0f, 4850.0f };
-    Position clientSpawn = { 4850.0f, 250.0f };
-    
-    return std::make_pair(serverSpawn, clientSpawn);
 }
 
-// ========================
-// Global State
-// ========================
-
-std::mutex mutex;
-Position serverPos = { 250.0f, 4850.0f }; // Server spawn position (will be randomized)
-Position serverPosPrevious = { 250.0f, 4850.0f }; // Previous position for interpolation
-float serverHealth = 100.0f; // Server player health (0-100)
-int serverScore = 0; // Server player score
-bool serverIsAlive = true; // Server player alive status
-sf::Clock serverRespawnTimer; // Requirement 8.4: Timer for respawn
-bool serverWaitingRespawn = false; // Requirement 8.3: Waiting for respawn flag
-std::map<sf::IpAddress, Position> clients;
-Position clientPos = { 4850.0f, 250.0f }; // Client position (will be randomized)
-Position clientPosPrevious = { 4850.0f, 250.0f }; // Previous client position
-Position clientPosTarget = { 4850.0f, 250.0f }; // Target client position (latest received)
-float clientHealth = 100.0f; // Client player health (0-100)
-int clientScore = 0; // Client player score
-bool clientIsAlive = true; // Client player alive status
-sf::Clock clientRespawnTimer; // Timer for client respawn
-bool clientWaitingRespawn = false; // Waiting for client respawn flag
-GameMap gameMap;
-GameState gameState; // Thread-safe game state manager
+// What the inbound message handlers need besides the payload
+struct InboundContext {
+    const sf::IpAddress& sender;
+    uint32_t playerId;        // From the sender address (authoritative)
+    uint32_t tickNumber;      // Current simulation tick (positionHistories holds ticks before it)
+    uint32_t maxRewindTicks;  // Lag compensation limit in ticks
+    float now;                // Network time in seconds (reliable channel timing)
+    float receivedAt;         // Arrival time of the datagram (networkClock)
+};
 
-// Server player with inventory and weapons
-Player serverPlayer;
+// Input message: queue the movement commands and take the snapshot ack
+void handleInputMessage(const uint8_t* payload, size_t length, InboundContext& context) {
+    const InputMessageView input(payload, length);
+    const uint32_t playerId = context.playerId;
+    
+    // Newest snapshot the client has: next snapshots are delta-encoded against it
+    // (reordered packets never move the baseline back)
+    ClientChannel& channel = clientChannels[playerId];
+    const uint32_t ackTick = input.ackTick();
+    if (ackTick != NO_SNAPSHOT_ACK && ackTick <= context.tickNumber) {
+        if (channel.lastAck == NO_SNAPSHOT_ACK || ackTick > channel.lastAck) {
+            channel.lastAck = ackTick;
+        }
+        channel.link.onSnapshotAck(ackTick, input.ackDelay(), context.receivedAt);
+    }
+    channel.link.onDownstreamReport(input.lostDatagrams());
+    
+    // Simulated on this and the following ticks (see InputQueue); the client
+    // never sends a position, so there is nothing to validate but the sequence
+    InputQueue& queue = inputQueues[playerId];
+    for (size_t i = 0; i < input.count(); ++i) {
+        queue.receive(input.command(i));
+    }
+}
 
-// Client player (for tracking opponent state)
-Player clientPlayer;
+// Shot message: validate, spawn the (lag compensated) bullet and rebroadcast it
+void handleShotMessage(const uint8_t* payload, size_t, InboundContext& context) {
+    const ShotMessageView shot(payload);
+    const uint32_t playerId = context.playerId;
+    const uint32_t tickNumber = context.tickNumber;
+    
+    ErrorHandler::logInfo("Received shot packet from player " + std::to_string(playerId));
+    
+    // Lag compensation: how many ticks behind the server the shooter was looking
+    const uint16_t rewindTicks = computeRewindTicks(shot.viewTick(), tickNumber, context.maxRewindTicks);
+    
+    // Validate the shot against the shooter's own recorded positions between
+    // its view tick and now: it must have been alive and near the shot origin
+    const float originX = shot.x();
+    const float originY = shot.y();
+    bool shooterAlive = false;
+    bool originValid = false;
+    gameState.withPlayers([&](std::map<uint32_t, Player>& players) {
+        auto shooter = players.find(playerId);
+        if (shooter == players.end()) return;
+        
+        const float toleranceSq = SHOT_ORIGIN_TOLERANCE * SHOT_ORIGIN_TOLERANCE;
+        auto nearOrigin = [&](float px, float py) {
+            float dx = originX - px;
+            float dy = originY - py;
+            return dx * dx + dy * dy <= toleranceSq;
+        };
+        
+        shooterAlive = shooter->second.isAlive;
+        originValid = nearOrigin(shooter->second.x, shooter->second.y);
+        
+        auto history = positionHistories.find(playerId);
+        if (history == positionHistories.end()) return;
+        for (uint32_t back = 1; back <= rewindTicks + 1u && back <= tickNumber; ++back) {
+            const PositionSample* sample = history->second.at(tickNumber - back);
+            if (!sample) continue;
+            shooterAlive = shooterAlive || sample->isAlive;
+            originValid = originValid || nearOrigin(sample->x, sample->y);
+        }
+    });
+    
+    if (!shooterAlive || !originValid) {
+        ErrorHandler::logWarning("Rejected shot from player " + std::to_string(playerId) +
+                                 (shooterAlive ? " (origin too far from player)" : " (player dead)"));
+        return;
+    }
+    
+    // The sender address decides the owner, not the playerId field
+    ShotPacket shotPacket;
+    shotPacket.playerId = static_cast<uint8_t>(playerId);
+    shotPacket.x = originX;
+    shotPacket.y = originY;
+    shotPacket.dirX = shot.dirX();
+    shotPacket.dirY = shot.dirY();
+    shotPacket.weaponType = shot.weaponType();
+    shotPacket.bulletSpeed = shot.bulletSpeed();
+    shotPacket.damage = shot.damage();
+    shotPacket.range = shot.range();
+    shotPacket.viewTick = shot.viewTick();
+    
+    // Create bullet on server
+    Bullet bullet;
+    bullet.ownerId = shotPacket.playerId;
+    bullet.x = shotPacket.x;
+    bullet.y = shotPacket.y;
+    bullet.prevX = shotPacket.x;  // Initialize previous position
+    bullet.prevY = shotPacket.y;
+    bullet.vx = shotPacket.dirX * shotPacket.bulletSpeed;
+    bullet.vy = shotPacket.dirY * shotPacket.bulletSpeed;
+    bullet.damage = shotPacket.damage;
+    bullet.range = shotPacket.range;
+    bullet.maxRange = shotPacket.range;
+    bullet.weaponType = static_cast<Weapon::Type>(shotPacket.weaponType);
+    
+    // Add bullet to active bullets list
+    {
+        std::lock_guard<std::mutex> lock(bulletsMutex);
+        if (activeBullets.spawn(bullet, rewindTicks)) {
+            ErrorHandler::logInfo("Client bullet added! Total bullets: " + std::to_string(activeBullets.size()) +
+                                  ", rewind " + std::to_string(rewindTicks) + " ticks");
+        } else {
+            ErrorHandler::logWarning("Bullet pool full (" + std::to_string(activeBullets.capacity()) +
+                                     "), dropping shot from player " + std::to_string(playerId));
+        }
+    }
+    
+    // Broadcast shot packet to all clients (sent at the end of this tick)
+    queueBroadcast(shotPacket);
+}
 
-// Shop system
-std::vector<Shop> shops;
+// Purchase message: buy on the server's copy of the player and answer with the result
+// The client already applied the purchase; the answer confirms it or makes it undo it
+void handlePurchaseMessage(const uint8_t* payload, size_t, InboundContext& context) {
+    const PurchaseMessageView purchase(payload);
+    const uint32_t playerId = context.playerId;
+    
+    InventoryPacket inventory;
+    inventory.playerId = static_cast<uint8_t>(playerId);
+    inventory.slot = PURCHASE_NONE;
+    inventory.weaponType = PURCHASE_NONE;
+    inventory.accepted = false;
+    inventory.newMoneyBalance = 0;
+    gameState.withPlayers([&](std::map<uint32_t, Player>& players) {
+        auto buyer = players.find(playerId);
+        if (buyer == players.end()) return;
+        Player& player = buyer->second;
+        
+        if (purchase.weaponType() <= Weapon::M40) {
+            const int slot = player.getFirstEmptySlot();
+            inventory.accepted = processPurchase(player, static_cast<Weapon::Type>(purchase.weaponType()));
+            if (inventory.accepted) {
+                inventory.slot = static_cast<uint8_t>(slot);
+                inventory.weaponType = purchase.weaponType();
+            }
+        } else if (purchase.ammoType() <= static_cast<uint8_t>(AmmoType::AMMO_7_62x54)) {
+            inventory.accepted = processAmmoPurchase(player, static_cast<AmmoType>(purchase.ammoType()));
+        }
+        inventory.newMoneyBalance = player.money;
+    });
+    
+    uint8_t body[INVENTORY_MESSAGE_BYTES];
+    writeInventoryMessage(body, inventory);
+    if (!clientChannels[playerId].reliable.send(WireMessageType::Inventory, body, sizeof(body))) {
+        ErrorHandler::logWarning("Reliable queue full, dropping inventory update for player " + std::to_string(playerId));
+    }
+}
 
-// Requirement 7.1: Store active bullets
-std::vector<Bullet> activeBullets;
-std::mutex bulletsMutex;
+// Messages a client may send inside a Reliable message, indexed by WireMessageType
+const WireHandler<InboundContext> INBOUND_RELIABLE_HANDLERS[WIRE_MESSAGE_TYPE_COUNT] = {
+    nullptr,                // invalid
+    nullptr,                // Input (unreliable)
+    nullptr,                // Shot (unreliable)
+    nullptr,                // Hit (server -> client only)
+    nullptr,                // Snapshot (server -> client only)
+    nullptr,                // InputAck (server -> client only)
+    handlePurchaseMessage,  // Purchase
+    nullptr,                // Inventory (server -> client only)
+    nullptr,                // Reliable (not nested)
+    nullptr                 // ReliableAck (not nested)
+};
 
-// Requirement 8.2: Store active damage texts
-std::vector<DamageText> damageTexts;
-std::mutex damageTextsMutex;
+// Reliable message: buffer it, then handle every message that is now in order
+void handleReliableMessage(const uint8_t* payload, size_t length, InboundContext& context) {
+    const ReliableMessageView message(payload, length);
+    ReliableChannel& reliable = clientChannels[context.playerId].reliable;
+    reliable.receive(message.id(), message.type(), message.body(), message.bodyLength());
+    reliable.deliver([&](uint8_t type, const uint8_t* body, size_t bodyLength) {
+        WireStatus status = dispatchWireMessage(type, body, bodyLength, INBOUND_RELIABLE_HANDLERS, context);
+        if (status != WireStatus::Ok) {
+            ErrorHandler::handleInvalidPacket("Rejected reliable message from player " + std::to_string(context.playerId) +
+                                              " (" + wireStatusName(status) + ")", context.sender.toString());
+        }
+    });
+}
 
-// Store active purchase notification texts
-std::vector<PurchaseText> purchaseTexts;
-std::mutex purchaseTextsMutex;
+void handleReliableAckMessage(const uint8_t* payload, size_t, InboundContext& context) {
+    const ReliableAckMessageView ack(payload);
+    clientChannels[context.playerId].reliable.onAck(ack.nextExpected(), ack.received(), context.now);
+}
 
-// Client connection state
-struct ClientConnection {
-    std::unique_ptr<sf::TcpSocket> socket;
-    sf::IpAddress address;
-    bool isReady = false;
-    uint32_t playerId = 0;
+// Messages a client may send, indexed by WireMessageType (null = rejected)
+const WireHandler<InboundContext> INBOUND_HANDLERS[WIRE_MESSAGE_TYPE_COUNT] = {
+    nullptr,                  // invalid
+    handleInputMessage,       // Input
+    handleShotMessage,        // Shot
+    nullptr,                  // Hit (server -> client only)
+    nullptr,                  // Snapshot (server -> client only)
+    nullptr,                  // InputAck (server -> client only)
+    nullptr,                  // Purchase (reliable only)
+    nullptr,                  // Inventory (server -> client only)
+    handleReliableMessage,    // Reliable
+    handleReliableAckMessage  // ReliableAck
 };
 
-std::vector<ClientConnection> connectedClients;
-std::mutex clientsMutex;
-std::string connectionStatus = "Waiting for player..."; // Waiting for player... in Russian
-sf::Color connectionStatusColor = sf::Color::White;
-bool showPlayButton = false;
-
-// ========================
-// Weapon Firing System (Server)
-// ========================
+// Apply one queued client datagram to the game state (called from the simulation tick)
+// Parameters:
+//   datagram - The received datagram
+//   tickNumber - Current simulation tick (positionHistories holds ticks before it)
+//   maxRewindTicks - Lag compensation limit in ticks
+//   now - Network time in seconds (reliable channel timing)
+void processInboundDatagram(const InboundDatagram& datagram, uint32_t tickNumber, uint32_t maxRewindTicks, float now) {
+    const sf::IpAddress& sender = datagram.sender;
+    std::size_t received = datagram.size;
+    
+    // The sender address is authoritative for the player ID; the playerId field in
+    // the packet is only informational (a client cannot move or shoot as someone else)
+    uint32_t playerId = HOST_PLAYER_ID;
+    if (!gameState.findPlayerByAddress(sender, playerId)) {
+        ErrorHandler::handleInvalidPacket("Datagram from unknown sender - " + std::to_string(received) + " bytes",
+                                          sender.toString());
+        return;
+    }
+    
+    InboundContext context{ sender, playerId, tickNumber, maxRewindTicks, now, datagram.receivedAt };
+    uint32_t sequence = 0;
+    WireStatus status = decodeDatagram(datagram.data, received, INBOUND_HANDLERS, context, sequence);
+    if (status == WireStatus::Ok) {
+        clientChannels[playerId].link.onDatagram(sequence);
+    } else {
+        std::ostringstream oss;
+        oss << "Rejected datagram from " << sender.toString() << " (" << wireStatusName(status)
+            << ") - received " << received << " bytes";
+        ErrorHandler::handleInvalidPacket(oss.str());
+    }
+}
 
-// Fire weapon and send shot packet to all clients
-void fireWeaponServer(Player& player, const sf::RenderWindow& window, sf::UdpSocket& udpSocket, 
-                      std::vector<Bullet>& activeBullets, std::mutex& bulletsMutex) {
-    Weapon* activeWeapon = player.getActiveWeapon();
-    if (activeWeapon == nullptr || !activeWeapon->canFire()) {
+// Send this tick's outgoing messages to every ready client (called from the simulation tick)
+// Parameters:
+//   socket - Server UDP socket
+//   perfMonitor - Performance monitor for bandwidth accounting (may be null)
+//   tickNumber - Current simulation tick, identifies the snapshot
+//   includeSnapshot - Whether this is a snapshot tick (~20 Hz)
+//   grid - The cell grid (line-of-sight culling)
+//   losGraceTicks - Ticks a player that went out of sight is still sent
+//   now - Network time in seconds (reliable channel timing)
+//
+// Each client gets one datagram holding its snapshot and input ack followed by
+// every queued shot and its reliable channel's ack and due messages (hits,
+// inventory updates and resends; see DatagramBuilder); only if that exceeds
+// MAX_DATAGRAM_BYTES is a second datagram started. Ticks with nothing to send
+// send nothing.
+//
+// SNAPSHOTS:
+// Every player within the culling radius that is not hidden behind concrete
+// walls (see LineOfSightRelevancy), quantized and delta-encoded against the last
+// snapshot that client acknowledged (see writeSnapshot). Without an ack in the
+// channel history the snapshot is sent in full, so a lost datagram only costs
+// compression, never correctness.
+void sendTickDatagrams(sf::UdpSocket& socket, PerformanceMonitor* perfMonitor, uint32_t tickNumber,
+                       bool includeSnapshot, const CellGrid& grid, uint32_t losGraceTicks, float now) {
+    OutgoingBroadcast broadcast;
+    {
+        std::lock_guard<std::mutex> lock(outgoingMutex);
+        std::swap(broadcast, pendingBroadcast);
+    }
+    
+    bool reliableDue = false;
+    for (const auto& pair : clientChannels) {
+        if (pair.second.reliable.wantsToSend(now)) {
+            reliableDue = true;
+            break;
+        }
+    }
+    if (!includeSnapshot && broadcast.shots.empty() && broadcast.hits.empty() && !reliableDue) {
         return;
     }
     
-    // Get mouse position in world coordinates
-    sf::Vector2i mousePixelPos = sf::Mouse::getPosition(window);
-    sf::Vector2f mouseWorldPos = window.mapPixelToCoords(mousePixelPos);
+    // Quantize every player once (same for every recipient), indexed by id
+    // The exact positions go into the recipients' input acks
+    std::array<QuantizedPlayerState, MAX_PLAYERS> quantizedById;
+    std::array<Position, MAX_PLAYERS> positionById;
+    uint64_t quantizedMask = 0;
+    if (includeSnapshot) {
+        gameState.withPlayers([&](const std::map<uint32_t, Player>& players) {
+            for (const auto& pair : players) {
+                const Player& player = pair.second;
+                if (pair.first >= MAX_PLAYERS) continue;
+                quantizedById[pair.first] = quantizePlayerState(player.id, player.x, player.y, player.rotation,
+                                                                player.health, player.isAlive);
+                positionById[pair.first] = { player.x, player.y };
+                quantizedMask |= uint64_t(1) << pair.first;
+            }
+        });
+    }
     
-    // Calculate bullet trajectory
-    float dx = mouseWorldPos.x - player.x;
-    float dy = mouseWorldPos.y - player.y;
-    float distance = std::sqrt(dx * dx + dy * dy);
+    // Get list of connected clients
+    std::vector<ClientConnection> clientsCopy;
+    {
+        std::lock_guard<std::mutex> lock(clientsMutex);
+        for (const auto& client : connectedClients) {
+            if (client.socket && client.isReady) {
+                clientsCopy.push_back(ClientConnection{
+                    nullptr, // Don't copy socket
+                    client.address,
+                    client.isReady,
+                    client.playerId
+                });
+            }
+        }
+    }
     
-    if (distance > 0.001f) {  // Avoid division by zero
-        // Normalize direction
-        dx /= distance;
-        dy /= distance;
-        
-        // Create bullet
-        Bullet bullet;
-        bullet.ownerId = 1;  // Server player ID (1 for server, 0 for clients)
-        bullet.x = player.x;
-        bullet.y = player.y;
-        bullet.prevX = player.x;  // Initialize previous position
-        bullet.prevY = player.y;
-        bullet.vx = dx * activeWeapon->bulletSpeed;
-        bullet.vy = dy * activeWeapon->bulletSpeed;
-        bullet.damage = activeWeapon->damage;
-        bullet.range = activeWeapon->range;
-        bullet.maxRange = activeWeapon->range;
-        bullet.weaponType = activeWeapon->type;
-        
-        // Fire weapon (consumes ammo)
-        activeWeapon->fire();
+    // Implement network culling: only send other players within 25*CELL_SIZE of the recipient
+    // The host and the recipient's own state (authoritative health) are always sent.
+    // A linear scan over the ID-indexed states: the radius covers most of the 51x51
+    // map, so a spatial grid returns nearly every player anyway and measured slower
+    const float NETWORK_CULLING_RADIUS = 25.0f * CELL_SIZE;
+    const float cullingRadiusSq = NETWORK_CULLING_RADIUS * NETWORK_CULLING_RADIUS;
+    
+    std::vector<QuantizedPlayerState> visible;
+    uint8_t snapshotBuffer[MAX_SNAPSHOT_BYTES];
+    size_t relevancyCandidates = 0;
+    size_t relevancyOccluded = 0;
+    if (includeSnapshot) {
+        losRelevancy.beginTick();
+    }
+    
+    for (const auto& client : clientsCopy) {
+        ClientChannel& channel = clientChannels[client.playerId];
+        DatagramBuilder builder([&](const uint8_t* data, size_t size, size_t messageCount) {
+            socket.send(data, size, client.address, 53002);
+            if (perfMonitor) {
+                perfMonitor->recordDatagramSent(size, messageCount);
+            }
+        }, channel.outgoingSequence);
         
-        // Add bullet to active bullets list
-        {
-            std::lock_guard<std::mutex> lock(bulletsMutex);
+        if (includeSnapshot) {
+            const uint64_t alwaysSend = quantizedMask &
+                ((uint64_t(1) << HOST_PLAYER_ID) | (uint64_t(1) << client.playerId));
+            
+            // Without our own state yet there is nothing to cull around: send everyone
+            uint64_t candidates = quantizedMask;
+            float ownX = 0.0f;
+            float ownY = 0.0f;
+            const bool hasOwn = (quantizedMask >> client.playerId) & 1;
+            if (hasOwn) {
+                ownX = dequantizePosition(quantizedById[client.playerId].x);
+                ownY = dequantizePosition(quantizedById[client.playerId].y);
+            }
             
-            // Count bullets owned by this player
-            int playerBulletCount = 0;
-            for (const auto& b : activeBullets) {
-                if (b.ownerId == 1) playerBulletCount++;
+            // Ascending bit order keeps the snapshot sorted by id
+            visible.clear();
+            while (candidates != 0) {
+                const int playerId = lowestSetBit(candidates);
+                candidates &= candidates - 1;
+                const QuantizedPlayerState& state = quantizedById[playerId];
+                if (hasOwn && !((alwaysSend >> playerId) & 1)) {
+                    float targetX = dequantizePosition(state.x);
+                    float targetY = dequantizePosition(state.y);
+                    float dx = targetX - ownX;
+                    float dy = targetY - ownY;
+                    if (dx * dx + dy * dy > cullingRadiusSq) {
+                        continue;
+                    }
+                    relevancyCandidates++;
+                    if (!losRelevancy.isRelevant(grid, client.playerId, ownX, ownY, playerId, targetX, targetY,
+                                                 tickNumber, losGraceTicks)) {
+                        relevancyOccluded++;
+                        continue;
+                    }
+                }
+                visible.push_back(state);
             }
             
-            // Only add if under limit
-            if (playerBulletCount < 20) {
-                activeBullets.push_back(bullet);
-                ErrorHandler::logInfo("Bullet created! Total bullets: " + std::to_string(activeBullets.size()));
+            // Delta against the acknowledged snapshot if we still have it
+            const std::vector<QuantizedPlayerState>* baseline = nullptr;
+            if (channel.lastAck != NO_SNAPSHOT_ACK && tickNumber - channel.lastAck < (1u << SNAPSHOT_BASELINE_BITS)) {
+                baseline = channel.history.find(channel.lastAck);
+            }
+            
+            BitWriter writer(snapshotBuffer, sizeof(snapshotBuffer));
+            writeSnapshot(writer, tickNumber, visible, baseline, channel.lastAck);
+            if (writer.overflowed()) {
+                ErrorHandler::logWarning("Snapshot for player " + std::to_string(client.playerId) +
+                                         " exceeds " + std::to_string(MAX_SNAPSHOT_BYTES) + " bytes, not sent");
             } else {
-                ErrorHandler::logInfo("Bullet limit reached (20)");
+                channel.history.store(tickNumber, visible);
+                channel.link.onSnapshotSent(tickNumber, now);
+                builder.append(WireMessageType::Snapshot, snapshotBuffer, writer.bytesWritten());
+                
+                if (perfMonitor) {
+                    perfMonitor->recordSnapshot(writer.bytesWritten(), visible.size() * sizeof(PositionPacket),
+                                                baseline != nullptr);
+                }
+            }
+            
+            // Reconciliation point for the client's prediction
+            auto queue = inputQueues.find(client.playerId);
+            if (hasOwn && queue != inputQueues.end() && queue->second.hasSimulated()) {
+                const Position& own = positionById[client.playerId];
+                builder.appendInputAck(queue->second.lastSimulated(), own.x, own.y);
             }
         }
         
-        // Send shot packet to all clients
-        ShotPacket shotPacket;
-        shotPacket.playerId = 1;  // Server player ID
-        shotPacket.x = player.x;
-        shotPacket.y = player.y;
-        shotPacket.dirX = dx;
-        shotPacket.dirY = dy;
-        shotPacket.weaponType = static_cast<uint8_t>(activeWeapon->type);
-        shotPacket.bulletSpeed = activeWeapon->bulletSpeed;
-        shotPacket.damage = activeWeapon->damage;
-        shotPacket.range = activeWeapon->range;
+        for (const auto& shotPacket : broadcast.shots) {
+            builder.appendShot(shotPacket);
+        }
         
-        {
-            std::lock_guard<std::mutex> lock(clientsMutex);
-            for (const auto& client : connectedClients) {
-                if (client.socket && client.isReady) {
-                    udpSocket.send(&shotPacket, sizeof(ShotPacket), client.address, 53002);
-                }
+        // Hits decide health, kills and rewards on the client: delivered exactly once, in order
+        for (const auto& hitPacket : broadcast.hits) {
+            uint8_t body[HIT_MESSAGE_BYTES];
+            writeHitMessage(body, hitPacket);
+            if (!channel.reliable.send(WireMessageType::Hit, body, sizeof(body))) {
+                ErrorHandler::logWarning("Reliable queue full, dropping hit for player " + std::to_string(client.playerId));
             }
         }
+        channel.reliable.write(builder, now);
         
-        int* ammoPool = activeWeapon->getAmmoPool(&player);
-        int reserveAmmo = ammoPool ? *ammoPool : 0;
-        ErrorHandler::logInfo("Fired " + activeWeapon->name + " - Ammo: " + 
-                             std::to_string(activeWeapon->currentAmmo) + "/" + 
-                             std::to_string(reserveAmmo));
+        builder.flush();
+        channel.link.onDatagramsSent(builder.nextSequence() - channel.outgoingSequence);
+        channel.outgoingSequence = builder.nextSequence();
     }
-}
-
-// Thread to handle ready status from connected clients
-void readyListenerThread() {
-    ErrorHandler::logInfo("Ready listener thread started");
     
-    while (true) {
-        std::vector<ClientConnection*> clientsToCheck;
-        
-        // Get list of connected clients and clean up disconnected ones
-        {
-            std::lock_guard<std::mutex> lock(clientsMutex);
-            
-            // Remove disconnected clients
-            connectedClients.erase(
-                std::remove_if(connectedClients.begin(), connectedClients.end(),
-                    [](const ClientConnection& client) {
-                        if (!client.socket) {
-                            ErrorHandler::logInfo("Removing client with null socket");
-                            return true;
-                        }
-                        return false;
-                    }),
-                connectedClients.end()
-            );
-            
-            for (auto& client : connectedClients) {
-                if (!client.isReady && client.socket) {
-                    clientsToCheck.push_back(&client);
+    if (includeSnapshot && perfMonitor) {
+        perfMonitor->recordRelevancy(relevancyCandidates, relevancyOccluded, losRelevancy.raysThisTick());
+    }
+    
+    // Forget channels and visibility pairs of clients that disconnected (their IDs may be reused)
+    if (includeSnapshot) {
+        for (auto it = clientChannels.begin(); it != clientChannels.end();) {
+            bool connected = false;
+            for (const auto& client : clientsCopy) {
+                if (client.playerId == it->first) {
+                    connected = true;
+                    break;
                 }
             }
-            
-            // Log client status periodically
-            static sf::Clock logClock;
-            if (logClock.getElapsedTime().asSeconds() > 5.0f && !connectedClients.empty()) {
-                ErrorHandler::logInfo("Ready listener status: " + std::to_string(connectedClients.size()) + 
-                                     " total clients, " + std::to_string(clientsToCheck.size()) + " waiting for ready");
-                logClock.restart();
-            }
-        }
-        
-        // Check each client for ready packet
-        for (auto* client : clientsToCheck) {
-            if (client->socket) {
-                // Save original blocking mode
-                bool wasBlocking = client->socket->isBlocking();
-                client->socket->setBlocking(false);
-                
-                ReadyPacket readyPacket;
-                std::size_t received = 0;
-                sf::Socket::Status status = client->socket->receive(&readyPacket, sizeof(ReadyPacket), received);
-                
-                // Restore original blocking mode
-                client->socket->setBlocking(wasBlocking);
-                
-                if (status == sf::Socket::Done && received == sizeof(ReadyPacket)) {
-                    if (readyPacket.type == MessageType::CLIENT_READY && readyPacket.isReady) {
-                        ErrorHandler::logInfo("Client " + client->address.toString() + " is ready");
-                        
-                        bool serverInGame = false;
-                        
-                        // Update client ready status
-                        {
-                            std::lock_guard<std::mutex> lock(clientsMutex);
-                            client->isReady = true;
-                            
-                            // Check if server is already in game
-                            serverInGame = (serverState.load() == ServerState::MainScreen);
-                            
-                            // Update UI status
-                            connectionStatus = "The player is connected and ready to play"; // Player connected and ready to play in Russian
-                            connectionStatusColor = sf::Color::Green;
-                            showPlayButton = true;
-                            
-                            ErrorHandler::logInfo("Updated UI to show player ready");
-                            
-                            // If server is already in game, send StartPacket immediately
-                            if (serverInGame) {
-                                ErrorHandler::logInfo("Server is already in game, sending StartPacket immediately");
-                                
-                                StartPacket startPacket;
-                                startPacket.type = MessageType::SERVER_START;
-                                startPacket.timestamp = static_cast<uint32_t>(std::time(nullptr));
-                                
-                                client->socket->setBlocking(true);
-                                sf::Socket::Status sendStatus = client->socket->send(&startPacket, sizeof(StartPacket));
-                                
-                                if (sendStatus == sf::Socket::Done) {
-                                    ErrorHandler::logInfo("✓ Sent StartPacket to reconnected client " + client->address.toString());
-                                } else {
-                                    ErrorHandler::logTCPError("Send StartPacket to reconnected client", sendStatus, client->address.toString());
-                                }
-                            }
-                        }
-                        
-                        // Update GameState
-                        gameState.setPlayerReady(client->playerId, true);
-                    } else {
-                        ErrorHandler::handleInvalidPacket("ReadyPacket validation failed", client->address.toString());
-                    }
-                } else if (status == sf::Socket::Done && received != sizeof(ReadyPacket)) {
-                    std::ostringstream oss;
-                    oss << "ReadyPacket size mismatch - expected " << sizeof(ReadyPacket) 
-                        << " bytes, got " << received;
-                    ErrorHandler::handleInvalidPacket(oss.str(), client->address.toString());
-                } else if (status == sf::Socket::Disconnected) {
-                    ErrorHandler::handleConnectionLost(client->address.toString());
-                    // Mark socket as null so it will be removed in next iteration
-                    std::lock_guard<std::mutex> lock(clientsMutex);
-                    client->socket.reset();
-                } else if (status != sf::Socket::NotReady && status != sf::Socket::Done) {
-                    ErrorHandler::logTCPError("Receive ReadyPacket", status, client->address.toString());
-                }
+            if (connected) {
+                ++it;
+            } else {
+                losRelevancy.forgetPlayer(it->first);
+                it = clientChannels.erase(it);
             }
         }
-        
-        sf::sleep(sf::milliseconds(50)); // Check every 50ms
     }
 }
 
-// TCP listener thread to handle client connections
-void tcpListenerThread(sf::TcpListener* listener, const std::vector<std::vector<Cell>>* grid) {
-    ErrorHandler::logInfo("=== TCP Listener Thread Started ===");
-    ErrorHandler::logInfo("Listening on port 53000 for incoming connections");
-    
-    while (true) {
-        auto clientSocket = std::make_unique<sf::TcpSocket>();
+// ========================
+// Authoritative Simulation Step
+// ========================
+
+const float PLAYER_HIT_RADIUS = 15.0f;  // PLAYER_SIZE / 2 (30 / 2 = 15)
+const float RESPAWN_DELAY = 5.0f;       // Seconds between death and respawn
+
+// Apply a bullet hit to a player in the table
+// Parameters:
+//   bullets - Bullet pool
+//   index - Index of the bullet that hit (marked for removal)
+//   victim - The player that was hit
+//   players - Player table (to credit the shooter on a kill)
+// Returns: HitPacket to broadcast to clients
+HitPacket applyBulletHit(BulletPool& bullets, size_t index, Player& victim, std::map<uint32_t, Player>& players) {
+    const uint8_t shooterId = bullets.ownerId(index);
+    const float damage = bullets.damage(index);
+    
+    // Requirement 8.1: Apply damage
+    float oldHealth = victim.health;
+    victim.health -= damage;
+    if (victim.health < 0.0f) victim.health = 0.0f;
+    
+    // Mark bullet for removal
+    bullets.kill(index);
+    
+    ErrorHandler::logInfo("Player " + std::to_string(victim.id) + " hit by player " + std::to_string(shooterId) +
+                          "! Damage: " + std::to_string(damage) + ", Health: " +
+                          std::to_string(oldHealth) + " -> " + std::to_string(victim.health));
+    
+    // Requirement 8.2: Create damage text visualization
+    {
+        std::lock_guard<std::mutex> lock(damageTextsMutex);
+        DamageText damageText;
+        damageText.x = victim.x;
+        damageText.y = victim.y - 30.0f; // Start above player
+        damageText.damage = damage;
+        damageTexts.push_back(damageText);
+    }
+    
+    // Requirement 8.3: Check for player death
+    bool wasKill = false;
+    if (victim.health <= 0.0f) {
+        victim.isAlive = false;
+        victim.waitingRespawn = true;
+        victim.respawnCountdown = RESPAWN_DELAY;
+        wasKill = true;
         
-        sf::Socket::Status acceptStatus = listener->accept(*clientSocket);
-        if (acceptStatus == sf::Socket::Done) {
-            std::string clientIP = clientSocket->getRemoteAddress().toString();
-            ErrorHandler::logInfo("=== New Client Connection Accepted ===");
-            ErrorHandler::logInfo("Client IP: " + clientIP);
-            
-            // Set socket to blocking mode for reliable TCP communication
-            clientSocket->setBlocking(true);
-            
-            // Receive ConnectPacket
-            ErrorHandler::logInfo("Waiting for ConnectPacket from client...");
-            ConnectPacket connectPacket;
-            std::size_t received = 0;
-            sf::Socket::Status receiveStatus = clientSocket->receive(&connectPacket, sizeof(ConnectPacket), received);
-            ErrorHandler::logInfo("Receive status: " + std::to_string(static_cast<int>(receiveStatus)) + ", received bytes: " + std::to_string(received));
-            
-            if (receiveStatus == sf::Socket::Done) {
-                if (received == sizeof(ConnectPacket)) {
-                    if (validateConnect(connectPacket)) {
-                        ErrorHandler::logInfo("Valid ConnectPacket received from " + clientIP);
-                        ErrorHandler::logInfo("Player name: " + std::string(connectPacket.playerName));
-                    
-                    // Send cell-based map data using new serialization
-                    if (sendMapToClient(*clientSocket, *grid)) {
-                        ErrorHandler::logInfo("Successfully sent cell-based map to client");
-                        
-                        // Send shop positions to client
-                        if (!sendShopsToClient(*clientSocket, shops)) {
-                            ErrorHandler::logTCPError("Send shop positions", sf::Socket::Error, clientIP);
-                            return;
-                        }
-                        ErrorHandler::logInfo("Successfully sent shop positions to client");
-                        
-                        // Send initial player positions
-                        // First send server player position
-                        PositionPacket serverPosPacket;
-                        serverPosPacket.x = serverPos.x;
-                        serverPosPacket.y = serverPos.y;
-                        serverPosPacket.isAlive = true;
-                        serverPosPacket.frameID = 0;
-                        serverPosPacket.playerId = 0; // Server is player 0
-                        
-                        sf::Socket::Status serverPosStatus = clientSocket->send(&serverPosPacket, sizeof(PositionPacket));
-                        if (serverPosStatus == sf::Socket::Done) {
-                            ErrorHandler::logInfo("Sent server initial position to client");
-                        } else {
-                            ErrorHandler::logTCPError("Send server initial position", serverPosStatus, clientIP);
-                        }
-                        
-                        // Send client's spawn position (randomly generated)
-                        PositionPacket clientPosPacket;
-                        clientPosPacket.x = clientPos.x;
-                        clientPosPacket.y = clientPos.y;
-                        clientPosPacket.isAlive = true;
-                        clientPosPacket.frameID = 0;
-                        clientPosPacket.playerId = 1; // Client is player 1
-                        
-                        sf::Socket::Status clientPosStatus = clientSocket->send(&clientPosPacket, sizeof(PositionPacket));
-                        if (clientPosStatus == sf::Socket::Done) {
-                            ErrorHandler::logInfo("Sent client initial position");
-                        } else {
-                            ErrorHandler::logTCPError("Send client initial position", clientPosStatus, clientIP);
-                        }
-                        
-                        // Store client connection
-                        {
-                            std::lock_guard<std::mutex> lock(clientsMutex);
-                            ClientConnection conn;
-                            conn.socket = std::move(clientSocket);
-                            conn.address = conn.socket->getRemoteAddress();
-                            conn.isReady = false;
-                            conn.playerId = static_cast<uint32_t>(connectedClients.size() + 1);
-                            connectedClients.push_back(std::move(conn));
-                            
-                            // Update connection status
-                            connectionStatus = "The player is connected, but not ready"; // Player connected but not ready in Russian
-                            connectionStatusColor = sf::Color::Yellow;
-                            
-                            ErrorHandler::logInfo("Client added to connected clients list");
-                        }
-                    } else {
-                        ErrorHandler::logTCPError("Send cell-based map data", sf::Socket::Error, clientIP);
-                    }
-                    } else {
-                        ErrorHandler::handleInvalidPacket("ConnectPacket validation failed", clientIP);
-                    }
-                } else {
-                    ErrorHandler::handleInvalidPacket("ConnectPacket size mismatch - expected " + 
-                        std::to_string(sizeof(ConnectPacket)) + " bytes, got " + std::to_string(received), clientIP);
-                }
-            } else {
-                ErrorHandler::logTCPError("Receive ConnectPacket", receiveStatus, clientIP);
+        // Requirement 8.4: Award $5000 and +1 score to the eliminating player
+        auto killer = players.find(shooterId);
+        if (killer != players.end()) {
+            killer->second.money += 5000;
+            killer->second.score += 1;
+            
+            // Host money lives on serverPlayer (shop and HUD use it)
+            if (killer->first == HOST_PLAYER_ID) {
+                serverPlayer.money += 5000;
             }
-        } else if (acceptStatus != sf::Socket::NotReady) {
-            ErrorHandler::logTCPError("Accept client connection", acceptStatus);
         }
         
-        sf::sleep(sf::milliseconds(100)); // Small delay to prevent busy waiting
-    }
+        ErrorHandler::logInfo("!!! PLAYER " + std::to_string(victim.id) + " DIED !!! Eliminated by player " +
+                              std::to_string(shooterId) + ", respawn in " +
+                              std::to_string(static_cast<int>(RESPAWN_DELAY)) + " seconds");
+    }
+    
+    // Requirement 10.4: Hit packet for all clients
+    HitPacket hitPacket;
+    hitPacket.shooterId = shooterId;
+    hitPacket.victimId = static_cast<uint8_t>(victim.id);
+    hitPacket.damage = damage;
+    hitPacket.hitX = victim.x;
+    hitPacket.hitY = victim.y;
+    hitPacket.wasKill = wasKill;
+    return hitPacket;
 }
 
-// UDP listener thread for position synchronization (20Hz)
-void udpListenerThread(sf::UdpSocket* socket, PerformanceMonitor* perfMonitor) {
-    ErrorHandler::logInfo("UDP listener thread started on port 53001");
-    
-    // Bind UDP socket to port 53001
-    sf::Socket::Status bindStatus = socket->bind(53001);
-    if (bindStatus != sf::Socket::Done) {
-        ErrorHandler::logUDPError("Bind UDP socket to port 53001", "Failed to bind");
-        return;
-    }
-    
-    socket->setBlocking(false);
-    ErrorHandler::logInfo("UDP socket bound successfully to port 53001");
-    
-    sf::Clock updateClock;
-    const float UPDATE_INTERVAL = 1.0f / 20.0f; // 20Hz = 50ms per update
-    
-    while (true) {
-        // Receive packets from clients (position or shot)
-        char buffer[256]; // Buffer large enough for any packet type
-        std::size_t received = 0;
-        sf::IpAddress sender;
-        unsigned short senderPort;
-        
-        sf::Socket::Status status = socket->receive(buffer, sizeof(buffer), received, sender, senderPort);
+// Advance the authoritative game simulation by one step
+// Parameters:
+//   deltaTime - Simulation step in seconds (the fixed tick delta)
+//   tickNumber - Current simulation tick (key for positionHistories)
+//   grid - The cell grid used for movement, bullet-wall collisions and respawn checks
+//
+// This function contains remote player movement from input commands, bullet integration,
+// bullet-wall and bullet-player collisions, damage and kill bookkeeping, expiry
+// of floating texts and the 5 second respawn timers. It is called once per tick
+// by runServerTick() with the global mutex held, so it must not touch
+// sf::RenderWindow or any graphics resources.
+//
+// PLAYER TABLE:
+// Everything runs off gameState's player table under a single lock. The host
+// (ID 0) is copied in from serverPos before the step and its health, alive
+// flag, score and (respawn) position are copied back afterwards, so the render
+// loop keeps using the serverPos/serverHealth globals.
+//
+// LAG COMPENSATION:
+// After movement every player's motion for this tick is recorded in
+// positionHistories. Bullets fired by clients carry a rewind distance and are
+// swept against the victim's recorded motion that many ticks ago, i.e. what the
+// shooter saw; the victim must still be alive now to take damage.
+//
+// PERFORMANCE:
+// Bullets live in a SoA BulletPool integrated with SIMD. Hit detection is
+// O(bullets * players) with a swept-circle test; at 64
+// players and ~1000 bullets that is 64k tests per tick (see
+// tests/run_player_table_benchmark.cpp for tick cost vs player count).
+void updateServerSimulation(float deltaTime, uint32_t tickNumber, const CellGrid& grid) {
+    std::vector<HitPacket> hitPackets;
+    
+    gameState.withPlayers([&](std::map<uint32_t, Player>& players) {
+        // Host player input comes from the render thread
+        auto host = players.find(HOST_PLAYER_ID);
+        if (host != players.end()) {
+            host->second.previousX = host->second.x;
+            host->second.previousY = host->second.y;
+            host->second.x = serverPos.x;
+            host->second.y = serverPos.y;
+            host->second.rotation = serverPlayer.rotation;
+        }
         
-        if (status == sf::Socket::Done) {
-            // Track network bandwidth
-            if (perfMonitor) {
-                perfMonitor->recordNetworkReceived(received);
-            }
-            
-            // Determine packet type by size
-            if (received == sizeof(PositionPacket)) {
-                // Handle position packet
-                PositionPacket* receivedPacket = reinterpret_cast<PositionPacket*>(buffer);
-                
-                // Validate received position
-                if (validatePosition(*receivedPacket)) {
-                    // Update GameState with validated position
-                    gameState.updatePlayerPosition(receivedPacket->playerId, receivedPacket->x, receivedPacket->y);
-                    
-                    // Update client position with interpolation support
-                    // IMPORTANT: Only update if client is alive or not waiting for respawn
-                    // This prevents client from overwriting server-assigned respawn position
-                    if (clientIsAlive && !clientWaitingRespawn) {
-                        std::lock_guard<std::mutex> lock(mutex);
-                        
-                        // Store previous position for interpolation
-                        clientPosPrevious.x = clientPosTarget.x;
-                        clientPosPrevious.y = clientPosTarget.y;
-                        
-                        // Update target position (latest received)
-                        clientPosTarget.x = receivedPacket->x;
-                        clientPosTarget.y = receivedPacket->y;
-                        
-                        // Update client player rotation
-                        clientPlayer.rotation = receivedPacket->rotation;
-                        
-                        // Also update legacy clients map for backward compatibility
-                        Position pos;
-                        pos.x = receivedPacket->x;
-                        pos.y = receivedPacket->y;
-                        clients[sender] = pos;
-                    }
-                }
-            }
-            else if (received == sizeof(ShotPacket)) {
-                // Handle shot packet
-                ShotPacket* shotPacket = reinterpret_cast<ShotPacket*>(buffer);
-                
-                ErrorHandler::logInfo("Received shot packet from client! Owner: " + std::to_string(shotPacket->playerId));
-                
-                // Create bullet on server
-                Bullet bullet;
-                bullet.ownerId = shotPacket->playerId;
-                bullet.x = shotPacket->x;
-                bullet.y = shotPacket->y;
-                bullet.prevX = shotPacket->x;  // Initialize previous position
-                bullet.prevY = shotPacket->y;
-                bullet.vx = shotPacket->dirX * shotPacket->bulletSpeed;
-                bullet.vy = shotPacket->dirY * shotPacket->bulletSpeed;
-                bullet.damage = shotPacket->damage;
-                bullet.range = shotPacket->range;
-                bullet.maxRange = shotPacket->range;
-                bullet.weaponType = static_cast<Weapon::Type>(shotPacket->weaponType);
-                
-                // Add bullet to active bullets list
-                {
-                    std::lock_guard<std::mutex> lock(bulletsMutex);
-                    activeBullets.push_back(bullet);
-                    ErrorHandler::logInfo("Client bullet added! Total bullets: " + std::to_string(activeBullets.size()));
-                }
+        // Move remote players by their queued input commands (see InputQueue),
+        // with the same applyInputCommand the client predicts with
+        for (auto& pair : players) {
+            Player& player = pair.second;
+            if (player.id == HOST_PLAYER_ID) continue;
+            player.previousX = player.x;
+            player.previousY = player.y;
+            
+            auto queue = inputQueues.find(pair.first);
+            if (queue == inputQueues.end()) continue;
+            queue->second.consume(deltaTime, [&](const InputCommand& command) {
+                player.rotation = dequantizeAim(command.aim);
                 
-                // Broadcast shot packet to all clients
-                {
-                    std::lock_guard<std::mutex> lock(clientsMutex);
-                    for (const auto& client : connectedClients) {
-                        if (client.socket && client.isReady) {
-                            socket->send(shotPacket, sizeof(ShotPacket), client.address, 53002);
-                        }
-                    }
-                }
+                // Dead players wait for respawn: commands are acknowledged but do not move them
+                if (!player.isAlive || player.waitingRespawn) return;
+                sf::Vector2f moved = applyInputCommand(sf::Vector2f(player.x, player.y), command.buttons, grid);
+                player.x = moved.x;
+                player.y = moved.y;
+            });
+        }
+        
+        // Record this tick's motion for lag compensation; forget players that left
+        for (auto& pair : players) {
+            positionHistories[pair.first].record(tickNumber, pair.second);
+        }
+        for (auto it = positionHistories.begin(); it != positionHistories.end();) {
+            if (players.count(it->first) == 0) {
+                it = positionHistories.erase(it);
+            } else {
+                ++it;
             }
-            else {
-                std::ostringstream oss;
-                oss << "Unknown packet size from " << sender.toString() 
-                    << " - received " << received << " bytes";
-                ErrorHandler::handleInvalidPacket(oss.str());
+        }
+        for (auto it = inputQueues.begin(); it != inputQueues.end();) {
+            if (players.count(it->first) == 0) {
+                it = inputQueues.erase(it);
+            } else {
+                ++it;
             }
-        } else if (status != sf::Socket::NotReady && status != sf::Socket::Done) {
-            ErrorHandler::logUDPError("Receive packet", "Socket error occurred");
         }
         
-        // Send position updates to clients at 20Hz
-        if (updateClock.getElapsedTime().asSeconds() >= UPDATE_INTERVAL) {
-            updateClock.restart();
-            
-            // Get list of connected clients
-            std::vector<ClientConnection> clientsCopy;
-            {
-                std::lock_guard<std::mutex> lock(clientsMutex);
-                for (const auto& client : connectedClients) {
-                    if (client.socket && client.isReady) {
-                        clientsCopy.push_back(ClientConnection{
-                            nullptr, // Don't copy socket
-                            client.address,
-                            client.isReady,
-                            client.playerId
-                        });
-                    }
-                }
+        // Requirement 7.2: Update bullet positions
+        // Requirement 7.3, 7.4: Check bullet collisions
+        // Requirement 7.5, 10.1, 10.2, 10.3: Remove bullets based on conditions
+        {
+            std::lock_guard<std::mutex> lock(bulletsMutex);
+        
+            // Integrate all bullets (SIMD) and drop those out of range or off the map
+            activeBullets.integrateAndCull(deltaTime);
+        
+            // Debug: Log bullet count
+            static sf::Clock bulletLogClock;
+            if (bulletLogClock.getElapsedTime().asSeconds() > 2.0f && !activeBullets.empty()) {
+                ErrorHandler::logInfo("Active bullets: " + std::to_string(activeBullets.size()));
+                bulletLogClock.restart();
             }
-            
-            // Send server position to each client
-            for (const auto& client : clientsCopy) {
-                // Prepare server position packet
-                PositionPacket serverPacket;
-                serverPacket.x = serverPos.x;
-                serverPacket.y = serverPos.y;
-                serverPacket.rotation = serverPlayer.rotation;  // Send server player rotation
-                serverPacket.health = serverHealth;
-                serverPacket.isAlive = serverIsAlive;
-                serverPacket.frameID = static_cast<uint32_t>(std::time(nullptr));
-                serverPacket.playerId = 0; // Server is player 0
+        
+            // Requirement 7.3, 7.4: Sweep each bullet's path this tick against walls and players.
+            // Both return a time of impact along prev -> current, so the earliest event wins:
+            // a player behind a concrete wall is safe, a player in front of it is hit.
+            // Bullets pass through wooden walls but stop at concrete walls.
+            for (size_t i = 0; i < activeBullets.size(); ++i) {
+                const float bx0 = activeBullets.prevX(i);
+                const float by0 = activeBullets.prevY(i);
+                const float bx1 = activeBullets.x(i);
+                const float by1 = activeBullets.y(i);
+                const uint8_t ownerId = activeBullets.ownerId(i);
+                const uint16_t rewindTicks = activeBullets.rewindTicks(i);
                 
-                // Send server position
-                socket->send(&serverPacket, sizeof(PositionPacket), client.address, 53002);
+                WallHit wallHit = Bullet::traceCellWallsDDA(grid, bx0, by0, bx1, by1);
                 
-                // Track network bandwidth
-                if (perfMonitor) {
-                    perfMonitor->recordNetworkSent(sizeof(PositionPacket));
+                // Earliest player hit (a bullet can only hit one player)
+                Player* victim = nullptr;
+                float victimToi = 1.0f;
+                for (auto& pair : players) {
+                    Player& player = pair.second;
+                    
+                    // Don't check collision with bullet owner or dead players
+                    if (player.id == ownerId || !player.isAlive) continue;
+                    
+                    // Target motion as the shooter saw it (current motion without rewind)
+                    float px0 = player.previousX, py0 = player.previousY;
+                    float px1 = player.x, py1 = player.y;
+                    if (rewindTicks > 0 && rewindTicks <= tickNumber) {
+                        const PositionSample* sample = positionHistories[pair.first].at(tickNumber - rewindTicks);
+                        if (sample) {
+                            if (!sample->isAlive) continue;
+                            px0 = sample->prevX;
+                            py0 = sample->prevY;
+                            px1 = sample->x;
+                            py1 = sample->y;
+                        }
+                    }
+                    
+                    float toi;
+                    if (Bullet::sweptCircleHit(bx0, by0, bx1, by1, px0, py0, px1, py1, PLAYER_HIT_RADIUS, toi) &&
+                        (victim == nullptr || toi < victimToi)) {
+                        victim = &player;
+                        victimToi = toi;
+                    }
                 }
                 
-                // Send client's own position and health back to them
-                // This is important so client knows their health (calculated on server)
-                PositionPacket clientPacket;
-                clientPacket.x = clientPos.x;
-                clientPacket.y = clientPos.y;
-                clientPacket.rotation = clientPlayer.rotation;  // Send client player rotation
-                clientPacket.health = clientHealth;
-                clientPacket.isAlive = clientIsAlive;
-                clientPacket.frameID = static_cast<uint32_t>(std::time(nullptr));
-                clientPacket.playerId = 1; // Client is player 1
-                
-                socket->send(&clientPacket, sizeof(PositionPacket), client.address, 53002);
-                
-                // Track network bandwidth
-                if (perfMonitor) {
-                    perfMonitor->recordNetworkSent(sizeof(PositionPacket));
+                if (victim != nullptr && (wallHit.type != WallType::Concrete || victimToi <= wallHit.t)) {
+                    hitPackets.push_back(applyBulletHit(activeBullets, i, *victim, players));
                 }
-                
-                // Implement network culling: only send players within 25*CELL_SIZE (750 pixels) radius
-                const float NETWORK_CULLING_RADIUS = 25.0f * CELL_SIZE;
-                sf::Vector2f serverPosition(serverPos.x, serverPos.y);
-                
-                // Get players within radius
-                std::vector<Player> nearbyPlayers = gameState.getPlayersInRadius(serverPosition, NETWORK_CULLING_RADIUS);
-                
-                // Send each nearby player's position
-                for (const auto& player : nearbyPlayers) {
-                    if (player.id != 0 && player.id != client.playerId) { // Don't send server or client's own position
-                        PositionPacket playerPacket;
-                        playerPacket.x = player.x;
-                        playerPacket.y = player.y;
-                        playerPacket.isAlive = player.isAlive;
-                        playerPacket.frameID = static_cast<uint32_t>(std::time(nullptr));
-                        playerPacket.playerId = static_cast<uint8_t>(player.id);
-                        
-                        socket->send(&playerPacket, sizeof(PositionPacket), client.address, 53002);
-                        
-                        // Track network bandwidth
-                        if (perfMonitor) {
-                            perfMonitor->recordNetworkSent(sizeof(PositionPacket));
-                        }
-                    }
+                else if (wallHit.type == WallType::Concrete) {
+                    // Concrete walls stop bullets completely
+                    activeBullets.kill(i);
                 }
+                else if (wallHit.type == WallType::Wood) {
+                    // Wooden walls reduce bullet speed and remaining range by 50%
+                    activeBullets.slowDown(i, 0.5f);
+                }
+            }
+        
+            // Remove bullets stopped by walls or players this tick
+            activeBullets.cull();
+        }
+        
+        // NEW DEATH SYSTEM: Handle respawn with 5 second delay
+        for (auto& pair : players) {
+            Player& player = pair.second;
+            if (!player.waitingRespawn) continue;
+            
+            player.respawnCountdown -= deltaTime;
+            if (player.respawnCountdown > 0.0f) continue;
+            
+            // Respawn at least 1000 pixels away from every other living player
+            Position spawn = findSpawnPosition(grid, players, player.id, 1000.0f);
+            player.health = 100.0f;
+            player.isAlive = true;
+            player.waitingRespawn = false;
+            player.x = player.previousX = spawn.x;
+            player.y = player.previousY = spawn.y;
+            
+            ErrorHandler::logInfo("!!! PLAYER " + std::to_string(player.id) + " RESPAWNED !!! at (" +
+                                  std::to_string(spawn.x) + ", " + std::to_string(spawn.y) + ")");
+        }
+        
+        // Mirror host state back to the render-thread globals
+        if (host != players.end()) {
+            const Player& hostPlayer = host->second;
+            serverHealth = hostPlayer.health;
+            serverIsAlive = hostPlayer.isAlive;
+            serverScore = hostPlayer.score;
+            if (hostPlayer.x != serverPos.x || hostPlayer.y != serverPos.y) {
+                // Respawned: teleport without interpolation
+                serverPos.x = hostPlayer.x;
+                serverPos.y = hostPlayer.y;
+                serverPosPrevious = serverPos;
+                serverPlayer.x = hostPlayer.x;
+                serverPlayer.y = hostPlayer.y;
             }
         }
+    });
+    
+    // Requirement 10.4: Send hit packets to all clients (sent at the end of this tick)
+    if (!hitPackets.empty()) {
+        queueBroadcast(hitPackets);
+    }
+
+    // Requirement 8.2: Update and remove expired damage texts
+    {
+        std::lock_guard<std::mutex> lock(damageTextsMutex);
+        damageTexts.erase(
+            std::remove_if(damageTexts.begin(), damageTexts.end(),
+                [](const DamageText& dt) {
+                    return dt.shouldRemove();
+                }),
+            damageTexts.end()
+        );
+    }
+
+    // Update and remove expired purchase notification texts
+    {
+        std::lock_guard<std::mutex> lock(purchaseTextsMutex);
+        purchaseTexts.erase(
+            std::remove_if(purchaseTexts.begin(), purchaseTexts.end(),
+                [](const PurchaseText& pt) {
+                    return pt.shouldRemove();
+                }),
+            purchaseTexts.end()
+        );
+    }
+}
+
+// ========================
+// Authoritative Server Tick
+// ========================
+
+// Run one authoritative server tick
+// Parameters:
+//   scheduler - Tick scheduler (provides the fixed delta and tick number)
+//   grid - The cell grid
+//   udpSocket - Server UDP socket (bound to 53001)
+//   perfMonitor - Performance monitor
+//   wallCount - Number of walls in the grid (for performance monitoring)
+//
+// TICK ORDER (deterministic):
+// 1. Drain queued client datagrams and apply them in arrival order
+// 2. Advance the simulation by exactly one fixed delta
+// 3. Send each client one batched datagram: the snapshot (nearby players not
+//    hidden behind concrete walls) every snapshotInterval ticks (serverSnapshotRate) plus
+//    the shots and hits queued during the tick
+// 4. Update performance metrics
+void runServerTick(TickScheduler& scheduler, const CellGrid& grid,
+                   sf::UdpSocket& udpSocket, PerformanceMonitor& perfMonitor, size_t wallCount) {
+    const float tickDelta = scheduler.getTickDelta();
+    const uint32_t tickNumber = scheduler.getTickNumber();
+    
+    // Snapshots stay at serverSnapshotRate so bandwidth does not grow with the tick rate
+    const uint32_t snapshotInterval = snapshotIntervalTicks(scheduler.getTickRate(), serverSnapshotRate);
+    
+    // Take the whole inbound queue at once so the listener is never blocked for long
+    std::vector<InboundDatagram> datagrams;
+    {
+        std::lock_guard<std::mutex> lock(inboundMutex);
+        datagrams.swap(inboundDatagrams);
+    }
+    
+    // Lag compensation window in ticks (the history buffer bounds it at high tick rates)
+    const uint32_t maxRewindTicks = std::min<uint32_t>(
+        PositionHistory::HISTORY_SIZE - 1,
+        static_cast<uint32_t>(std::lround(LAG_COMPENSATION_MAX_REWIND * scheduler.getTickRate())));
+    
+    // Network time of this tick, on the clock that stamps inbound datagrams
+    // (after skipped ticks the scheduled time would lag it)
+    const float now = networkClock.getElapsedTime().asSeconds();
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    for (const auto& datagram : datagrams) {
+        processInboundDatagram(datagram, tickNumber, maxRewindTicks, now);
+    }
+    
+    updateServerSimulation(tickDelta, tickNumber, grid);
+    
+    // Hysteresis for line-of-sight culling, in ticks
+    const uint32_t losGraceTicks = static_cast<uint32_t>(std::lround(LOS_HIDE_GRACE * scheduler.getTickRate()));
+    
+    sendTickDatagrams(udpSocket, &perfMonitor, tickNumber, tickNumber % snapshotInterval == 0, grid, losGraceTicks, now);
+    
+    if (perfMonitor.reportDue(tickDelta)) {
+        for (auto& pair : clientChannels) {
+            perfMonitor.recordConnection(pair.second.link.takeReport(pair.first, pair.second.reliable.resends()));
+        }
+    }
+    
+    perfMonitor.update(tickDelta, gameState.getPlayerCount(), wallCount);
+}
+
+// Simulation thread: runs server ticks at the configured rate until the process exits
+// In windowed mode this runs beside the render loop; the render loop only reads
+// the game state (under the global mutex) and never advances it.
+void simulationLoop(const CellGrid* grid, sf::UdpSocket* udpSocket,
+                    PerformanceMonitor* perfMonitor, size_t wallCount) {
+    TickScheduler scheduler(serverTickRate);
+    perfMonitor->setTargetRate(static_cast<float>(serverTickRate));
+    
+    ErrorHandler::logInfo("Simulation thread started: " + std::to_string(serverTickRate) + " Hz (" +
+                          std::to_string(scheduler.getTickDelta() * 1000.0f) + "ms per tick)");
+    
+    while (true) {
+        int dueTicks = scheduler.waitForNextTick();
+        
+        for (int i = 0; i < dueTicks; ++i) {
+            scheduler.beginTick();
+            runServerTick(scheduler, *grid, *udpSocket, *perfMonitor, wallCount);
+            bool overrun = scheduler.endTick();
+            perfMonitor->recordTickCost(scheduler.getLastTickCost().asSeconds(), overrun);
+        }
         
-        sf::sleep(sf::milliseconds(10)); // Small sleep to prevent busy waiting
+        int skipped = scheduler.takeSkippedTicks();
+        if (skipped > 0) {
+            perfMonitor->recordSkippedTicks(skipped);
+            ErrorHandler::logWarning("Simulation fell behind, skipped " + std::to_string(skipped) + " ticks");
+        }
+    }
+}
+
+// ========================
+// Headless Dedicated Server
+// ========================
+
+// Run the server without a window (started with --headless)
+// Parameters:
+//   grid - The generated cell grid
+//   wallCount - Number of walls in the grid (for performance monitoring)
+// Returns: process exit code
+//
+// HEADLESS MODE:
+// - No sf::RenderWindow, fonts or textures are created
+// - There is no host player: only remote clients play on this server
+// - The game starts immediately: clients receive StartPacket as soon as they are ready
+// - The simulation loop runs on the main thread at serverTickRate
+int runHeadlessServer(const CellGrid& grid, size_t wallCount) {
+    ErrorHandler::logInfo("=== Headless Dedicated Server ===");
+    
+    // Skip menu and waiting screens - clients are started as soon as they report ready
+    serverState.store(ServerState::MainScreen);
+    
+    sf::UdpSocket udpSocket;
+    if (!bindServerUdpSocket(udpSocket)) {
+        return -1;
     }
+    
+    PerformanceMonitor perfMonitor;
+    std::thread udpWorker(udpListenerThread, &udpSocket, &perfMonitor);
+    ErrorHandler::logInfo("UDP listener thread started for position synchronization");
+    
+    simulationLoop(&grid, &udpSocket, &perfMonitor, wallCount);
+    
+    udpWorker.join();
+    return 0;
 }
 
 bool isButtonClicked(const sf::RectangleShape& button, const sf::Event& event, const sf::RenderWindow& window) {
@@ -4299,9 +7937,62 @@ void toggleFullscreen(sf::RenderWindow& window, bool& isFullscreen, const sf::Vi
     window.setView(window.getDefaultView());
 }
 
-int main() {
+// Apply the command line options to headlessMode, serverTickRate and
+// serverSnapshotRate. Invalid values and unknown options are logged as
+// warnings and keep the current value
+void parseCommandLine(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--headless") {
+            headlessMode = true;
+        } else if (arg.rfind("--tick-rate", 0) == 0) {
+            // Accept both --tick-rate=N and --tick-rate N
+            std::string value;
+            if (arg.size() > 12 && arg[11] == '=') {
+                value = arg.substr(12);
+            } else if (arg.size() == 11 && i + 1 < argc) {
+                value = argv[++i];
+            }
+            
+            int rate = std::atoi(value.c_str());
+            if (rate >= 10 && rate <= 240) {
+                serverTickRate = rate;
+            } else {
+                ErrorHandler::logWarning("Invalid tick rate '" + value + "' (expected 10-240), using " +
+                                         std::to_string(serverTickRate) + " Hz");
+            }
+        } else if (arg.rfind("--snapshot-rate", 0) == 0) {
+            // Accept both --snapshot-rate=N and --snapshot-rate N
+            std::string value;
+            if (arg.size() > 16 && arg[15] == '=') {
+                value = arg.substr(16);
+            } else if (arg.size() == 15 && i + 1 < argc) {
+                value = argv[++i];
+            }
+            
+            int rate = std::atoi(value.c_str());
+            if (rate >= 5 && rate <= 60) {
+                serverSnapshotRate = rate;
+            } else {
+                ErrorHandler::logWarning("Invalid snapshot rate '" + value + "' (expected 5-60), using " +
+                                         std::to_string(serverSnapshotRate) + " Hz");
+            }
+        } else {
+            ErrorHandler::logWarning("Unknown command line option: " + arg);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    parseCommandLine(argc, argv);
+    if (headlessMode) {
+        ErrorHandler::logInfo("Starting in headless dedicated-server mode");
+    }
+    ErrorHandler::logInfo("Server tick rate: " + std::to_string(serverTickRate) + " Hz, snapshots at " +
+                          std::to_string(serverSnapshotRate) + " Hz");
+    
     // NEW: Grid for cell-based map system
-    std::vector<std::vector<Cell>> grid(GRID_SIZE, std::vector<Cell>(GRID_SIZE));
+    CellGrid grid;
     
     // Generate map at startup using new cell-based system with retry logic
     std::cout << "\n=== Server Startup: Map Generation ===" << std::endl;
@@ -4312,21 +8003,19 @@ int main() {
         return -1;
     }
     std::cout << "Map generation complete, server ready to start\n" << std::endl;
+    size_t wallCount = grid.countWalls();  // The map never changes after generation
     
     // Generate random spawn positions with minimum distance of 2100 pixels (21 cells)
     std::cout << "\n=== Generating Random Spawn Positions ===" << std::endl;
     auto spawns = generateRandomSpawns(grid, 2100.0f);
     serverPos = spawns.first;
     serverPosPrevious = spawns.first;
-    clientPos = spawns.second;
-    clientPosPrevious = spawns.second;
-    clientPosTarget = spawns.second;
     std::cout << "Spawn generation complete\n" << std::endl;
     
     // Generate shops
     std::vector<sf::Vector2i> spawnPoints;
     spawnPoints.push_back(sf::Vector2i(static_cast<int>(serverPos.x), static_cast<int>(serverPos.y)));
-    spawnPoints.push_back(sf::Vector2i(static_cast<int>(clientPos.x), static_cast<int>(clientPos.y)));
+    spawnPoints.push_back(sf::Vector2i(static_cast<int>(spawns.second.x), static_cast<int>(spawns.second.y)));
     
     if (!generateShops(shops, spawnPoints, grid)) {
         std::cerr << "[CRITICAL] Shop generation failed, exiting..." << std::endl;
@@ -4334,24 +8023,37 @@ int main() {
     }
     std::cout << "Shop generation complete - Generated " << shops.size() << " shops\n" << std::endl;
     
-    // Initialize server player with starting equipment
-    // Requirements: 1.1, 1.2, 1.3
-    initializePlayer(serverPlayer);
-    serverPlayer.x = serverPos.x;
-    serverPlayer.y = serverPos.y;
-    
-    // Debug: Check weapon initialization
-    Weapon* usp = serverPlayer.inventory[0];
-    if (usp != nullptr) {
-        int* ammoPool = usp->getAmmoPool(&serverPlayer);
-        int reserveAmmo = ammoPool ? *ammoPool : 0;
-        std::cout << "Server player initialized with:" << std::endl;
-        std::cout << "  Weapon: " << usp->name << std::endl;
-        std::cout << "  Ammo: " << usp->currentAmmo << "/" << reserveAmmo << std::endl;
-        std::cout << "  Active slot: " << serverPlayer.activeSlot << std::endl;
-        std::cout << "  Money: $" << serverPlayer.money << "\n" << std::endl;
+    // Headless server has no host player: keep it out of hit detection and snapshots
+    if (headlessMode) {
+        serverIsAlive = false;
     } else {
-        std::cout << "ERROR: Server player weapon is NULL!\n" << std::endl;
+        // Initialize server player with starting equipment
+        // Requirements: 1.1, 1.2, 1.3
+        initializePlayer(serverPlayer);
+        serverPlayer.x = serverPos.x;
+        serverPlayer.y = serverPos.y;
+        
+        // Host takes player table slot 0 (clients get 1..MAX_PLAYERS-1)
+        Player hostRecord;
+        hostRecord.id = HOST_PLAYER_ID;
+        hostRecord.x = hostRecord.previousX = serverPos.x;
+        hostRecord.y = hostRecord.previousY = serverPos.y;
+        hostRecord.isReady = true;
+        gameState.addPlayer(HOST_PLAYER_ID, hostRecord);
+        
+        // Debug: Check weapon initialization
+        Weapon* usp = serverPlayer.inventory[0];
+        if (usp != nullptr) {
+            int* ammoPool = usp->getAmmoPool(&serverPlayer);
+            int reserveAmmo = ammoPool ? *ammoPool : 0;
+            std::cout << "Server player initialized with:" << std::endl;
+            std::cout << "  Weapon: " << usp->name << std::endl;
+            std::cout << "  Ammo: " << usp->currentAmmo << "/" << reserveAmmo << std::endl;
+            std::cout << "  Active slot: " << serverPlayer.activeSlot << std::endl;
+            std::cout << "  Money: $" << serverPlayer.money << "\n" << std::endl;
+        } else {
+            std::cout << "ERROR: Server player weapon is NULL!\n" << std::endl;
+        }
     }
     
     sf::TcpListener tcpListener;
@@ -4368,12 +8070,13 @@ int main() {
     tcpListener.setBlocking(false);
     
     // Start TCP listener thread (pass grid pointer for map synchronization)
+    // It runs the whole join handshake, ready status included
     std::thread tcpListenerWorker(tcpListenerThread, &tcpListener, &grid);
     ErrorHandler::logInfo("TCP listener thread started");
     
-    // Start ready listener thread
-    std::thread readyListenerWorker(readyListenerThread);
-    ErrorHandler::logInfo("Ready listener thread started");
+    if (headlessMode) {
+        return runHeadlessServer(grid, wallCount);
+    }
 
     sf::VideoMode desktopMode = sf::VideoMode::getDesktopMode();
     sf::RenderWindow window(desktopMode, "Server", sf::Style::Fullscreen);
@@ -4399,6 +8102,7 @@ int main() {
     // Use global serverState instead of local state
     sf::UdpSocket udpSocket;
     std::thread udpWorker;
+    std::thread simulationWorker;
     bool udpThreadStarted = false;
     
     // Shop system
@@ -4543,7 +8247,7 @@ int main() {
     serverSprite.setOrigin(PLAYER_SIZE / 2.0f, PLAYER_SIZE / 2.0f); // Center origin
     serverSprite.setPosition(serverPos.x, serverPos.y);
 
-    std::map<sf::IpAddress, sf::Sprite> clientSprites;
+    std::map<uint32_t, sf::Sprite> clientSprites; // Remote player sprites by player ID
     
     // Clock for delta time calculation
     sf::Clock deltaClock;
@@ -4860,7 +8564,7 @@ int main() {
                 }
                 if (activeWeapon != nullptr && !shopUIOpen && !inventoryOpen) {
                     // Fire weapon (works for both automatic and semi-automatic)
-                    fireWeaponServer(serverPlayer, window, udpSocket, activeBullets, bulletsMutex);
+                    fireWeaponServer(serverPlayer, window, activeBullets, bulletsMutex);
                     
                     // Requirement 6.2: Trigger automatic reload when magazine empty
                     int* ammoPool = activeWeapon->getAmmoPool(&serverPlayer);
@@ -4900,6 +8604,7 @@ int main() {
                         StartPacket startPacket;
                         startPacket.type = MessageType::SERVER_START;
                         startPacket.timestamp = static_cast<uint32_t>(std::time(nullptr));
+                        startPacket.tickRate = static_cast<uint16_t>(serverTickRate);
                         
                         int readyCount = 0;
                         int sentCount = 0;
@@ -4937,9 +8642,10 @@ int main() {
                     serverState.store(ServerState::MainScreen);
                     ErrorHandler::logInfo("Server transitioning to game screen");
 
-                    // Start UDP listener thread for position synchronization
-                    if (!udpThreadStarted) {
+                    // Start UDP listener and simulation threads for position synchronization
+                    if (!udpThreadStarted && bindServerUdpSocket(udpSocket)) {
                         udpWorker = std::thread(udpListenerThread, &udpSocket, &perfMonitor);
+                        simulationWorker = std::thread(simulationLoop, &grid, &udpSocket, &perfMonitor, wallCount);
                         udpThreadStarted = true;
                         ErrorHandler::logInfo("UDP listener thread started for position synchronization");
                     }
@@ -5086,7 +8792,7 @@ int main() {
                     if (sf::Mouse::isButtonPressed(sf::Mouse::Left)) {
                         // Check if enough time has passed since last shot (fire rate control)
                         if (activeWeapon->canFireAutomatic()) {
-                            fireWeaponServer(serverPlayer, window, udpSocket, activeBullets, bulletsMutex);
+                            fireWeaponServer(serverPlayer, window, activeBullets, bulletsMutex);
                             
                             // Trigger automatic reload when magazine empty
                             int* ammoPool = activeWeapon->getAmmoPool(&serverPlayer);
@@ -5100,453 +8806,8 @@ int main() {
                 }
             }
             
-            // Requirement 7.2: Update bullet positions
-            // Requirement 7.3, 7.4: Check bullet collisions
-            // Requirement 7.5, 10.1, 10.2, 10.3: Remove bullets based on conditions
-            {
-                std::lock_guard<std::mutex> lock(bulletsMutex);
-                
-                // Update all bullets
-                for (auto& bullet : activeBullets) {
-                    bullet.update(deltaTime);
-                }
-                
-                // Requirement 7.3: Check bullet-wall collisions with cell-based grid
-                // Bullets pass through wooden walls but stop at concrete walls
-                for (auto& bullet : activeBullets) {
-                    WallType hitWallType = bullet.checkCellWallCollision(grid, bullet.prevX, bullet.prevY);
-                    
-                    if (hitWallType == WallType::Concrete) {
-                        // Concrete walls stop bullets completely
-                        bullet.range = 0.0f;
-                    }
-                    else if (hitWallType == WallType::Wood) {
-                        // Wooden walls reduce bullet speed by 50%
-                        bullet.vx *= 0.5f;
-                        bullet.vy *= 0.5f;
-                        
-                        // Also reduce remaining range proportionally
-                        bullet.range *= 0.5f;
-                    }
-                }
-                
-                // Requirement 7.4: Check bullet-player collisions
-                const float PLAYER_RADIUS = 15.0f; // PLAYER_SIZE / 2 (30 / 2 = 15)
-                
-                // Debug: Log bullet count
-                static sf::Clock bulletLogClock;
-                if (bulletLogClock.getElapsedTime().asSeconds() > 2.0f && !activeBullets.empty()) {
-                    ErrorHandler::logInfo("Active bullets: " + std::to_string(activeBullets.size()));
-                    bulletLogClock.restart();
-                }
-                
-                // Check collision with server player
-                for (auto& bullet : activeBullets) {
-                    // Don't check collision with own bullets (server is ID=1) and skip if already dead
-                    if (bullet.ownerId != 1 && serverIsAlive) {
-                        // Debug: Check distance to player
-                        float dx = bullet.x - serverPos.x;
-                        float dy = bullet.y - serverPos.y;
-                        float distance = std::sqrt(dx * dx + dy * dy);
-                        if (distance < 50.0f) {  // Close to player
-                            ErrorHandler::logInfo("Bullet near server player! Distance: " + std::to_string(distance) + 
-                                                 ", Owner: " + std::to_string(bullet.ownerId));
-                        }
-                        
-                        if (bullet.checkPlayerCollision(serverPos.x, serverPos.y, PLAYER_RADIUS)) {
-                            // Requirement 8.1: Apply damage to server player
-                            float oldHealth = serverHealth;
-                            ErrorHandler::logInfo("BEFORE damage: serverHealth = " + std::to_string(serverHealth));
-                            serverHealth -= bullet.damage;
-                            ErrorHandler::logInfo("AFTER subtraction: serverHealth = " + std::to_string(serverHealth));
-                            if (serverHealth < 0.0f) serverHealth = 0.0f;
-                            ErrorHandler::logInfo("AFTER clamp: serverHealth = " + std::to_string(serverHealth));
-                            
-                            // Mark bullet for removal
-                            bullet.range = 0.0f;
-                            
-                            ErrorHandler::logInfo("Server player hit! Damage: " + std::to_string(bullet.damage) + 
-                                                 ", Health: " + std::to_string(oldHealth) + " -> " + std::to_string(serverHealth));
-                            
-                            // Requirement 8.2: Create damage text visualization
-                            {
-                                std::lock_guard<std::mutex> lock(damageTextsMutex);
-                                DamageText damageText;
-                                damageText.x = serverPos.x;
-                                damageText.y = serverPos.y - 30.0f; // Start above player
-                                damageText.damage = bullet.damage;
-                                damageTexts.push_back(damageText);
-                                ErrorHandler::logInfo("Damage text created at (" + std::to_string(damageText.x) + 
-                                                     ", " + std::to_string(damageText.y) + ")");
-                            }
-                            
-                            // NEW DEATH SYSTEM: Check for player death
-                            bool wasKill = false;
-                            if (serverHealth <= 0.0f) {
-                                ErrorHandler::logInfo("!!! SERVER PLAYER DEATH TRIGGERED !!! Health: " + std::to_string(serverHealth));
-                                serverIsAlive = false;
-                                serverWaitingRespawn = true;
-                                serverRespawnTimer.restart(); // Start 5 second respawn timer
-                                wasKill = true;
-                                
-                                // Requirement 8.4: Award $5000 to eliminating player
-                                uint8_t killerId = bullet.ownerId;
-                                
-                                // Award money to killer
-                                if (killerId == 0) {
-                                    // Client killed server - client will award itself when it sees serverHealth <= 0
-                                    ErrorHandler::logInfo("!!! SERVER PLAYER DIED !!! Killed by client (player 0)");
-                                } else if (gameState.hasPlayer(killerId)) {
-                                    // Other player killed server
-                                    gameState.awardMoney(killerId, 5000);
-                                    ErrorHandler::logInfo("!!! SERVER PLAYER DIED !!! Player " + std::to_string(killerId) + " gets $5000 reward");
-                                }
-                                
-                                ErrorHandler::logInfo("Server player eliminated by player " + 
-                                                     std::to_string(killerId) + "! Respawn in 5 seconds...");
-                                
-                                // TODO: Requirement 9.5: Broadcast death event to all clients
-                            }
-                            
-                            // Requirement 10.4: Send hit packet to all clients
-                            HitPacket hitPacket;
-                            hitPacket.shooterId = bullet.ownerId;
-                            hitPacket.victimId = 1; // Server is player 1
-                            hitPacket.damage = bullet.damage;
-                            hitPacket.hitX = serverPos.x;
-                            hitPacket.hitY = serverPos.y;
-                            hitPacket.wasKill = wasKill;
-                            
-                            // Broadcast to all connected clients
-                            for (const auto& client : connectedClients) {
-                                if (client.socket && client.isReady) {
-                                    udpSocket.send(&hitPacket, sizeof(HitPacket), client.address, 53002);
-                                }
-                            }
-                            
-                            ErrorHandler::logInfo("Hit packet sent to all clients");
-                            
-                            // TODO: Requirement 10.4: Send hit packet to all clients
-                        }
-                    }
-                }
-                
-                // Requirement 7.4: Check collision with all other players from GameState
-                std::vector<Player> allPlayers = gameState.getPlayersInRadius(
-                    sf::Vector2f(serverPos.x, serverPos.y), 10000.0f); // Large radius to get all players
-                
-                for (auto& bullet : activeBullets) {
-                    if (bullet.range <= 0.0f) continue; // Skip already hit bullets
-                    
-                    // Check collision with each player
-                    for (const auto& player : allPlayers) {
-                        // Don't check collision with bullet owner or dead players
-                        if (bullet.ownerId == player.id || !player.isAlive) continue;
-                        
-                        if (bullet.checkPlayerCollision(player.x, player.y, PLAYER_RADIUS)) {
-                            // Requirement 8.1: Apply damage to player
-                            gameState.applyDamage(player.id, bullet.damage);
-                            
-                            // Mark bullet for removal
-                            bullet.range = 0.0f;
-                            
-                            ErrorHandler::logInfo("Player " + std::to_string(player.id) + 
-                                                " hit! Damage: " + std::to_string(bullet.damage));
-                            
-                            // Requirement 8.2: Create damage text visualization
-                            {
-                                std::lock_guard<std::mutex> lock(damageTextsMutex);
-                                DamageText damageText;
-                                damageText.x = player.x;
-                                damageText.y = player.y - 30.0f; // Start above player
-                                damageText.damage = bullet.damage;
-                                damageTexts.push_back(damageText);
-                            }
-                            
-                            // Requirement 8.3: Check for player death
-                            bool wasKill = false;
-                            if (gameState.isPlayerDead(player.id)) {
-                                gameState.setPlayerAlive(player.id, false);
-                                wasKill = true;
-                                
-                                // Requirement 8.4: Award $5000 to eliminating player
-                                if (gameState.hasPlayer(bullet.ownerId)) {
-                                    gameState.awardMoney(bullet.ownerId, 5000);
-                                }
-                                
-                                ErrorHandler::logInfo("Player " + std::to_string(player.id) + 
-                                                     " eliminated by player " + std::to_string(bullet.ownerId) + "!");
-                                
-                                // TODO: Requirement 8.4: Schedule respawn after 5 seconds
-                                // TODO: Requirement 9.5: Broadcast death event to all clients
-                            }
-                            
-                            // Requirement 10.4: Send hit packet to all clients
-                            HitPacket hitPacket;
-                            hitPacket.shooterId = bullet.ownerId;
-                            hitPacket.victimId = player.id;
-                            hitPacket.damage = bullet.damage;
-                            hitPacket.hitX = player.x;
-                            hitPacket.hitY = player.y;
-                            hitPacket.wasKill = wasKill;
-                            
-                            // Broadcast to all connected clients
-                            for (const auto& client : connectedClients) {
-                                if (client.socket && client.isReady) {
-                                    udpSocket.send(&hitPacket, sizeof(HitPacket), client.address, 53002);
-                                }
-                            }
-                            
-                            ErrorHandler::logInfo("Hit packet sent to all clients");
-                            
-                            break; // Bullet can only hit one player
-                        }
-                    }
-                }
-                
-                // Also check collision with simple client position (for basic 2-player mode)
-                for (auto& bullet : activeBullets) {
-                    if (bullet.range <= 0.0f) continue; // Skip already hit bullets
-                    
-                    // Don't check collision with own bullets (server bullets hit client)
-                    if (bullet.ownerId == 1 && clientIsAlive) {
-                        if (bullet.checkPlayerCollision(clientPos.x, clientPos.y, PLAYER_RADIUS)) {
-                            // Mark bullet for removal
-                            bullet.range = 0.0f;
-                            
-                            // Apply damage to client
-                            float oldHealth = clientHealth;
-                            clientHealth -= bullet.damage;
-                            if (clientHealth < 0.0f) clientHealth = 0.0f;
-                            
-                            ErrorHandler::logInfo("Client player hit! Damage: " + std::to_string(bullet.damage) + 
-                                                 ", Health: " + std::to_string(oldHealth) + " -> " + std::to_string(clientHealth));
-                            
-                            // Requirement 8.2: Create damage text visualization on server
-                            {
-                                std::lock_guard<std::mutex> lock(damageTextsMutex);
-                                DamageText damageText;
-                                damageText.x = clientPos.x;
-                                damageText.y = clientPos.y - 30.0f; // Start above player
-                                damageText.damage = bullet.damage;
-                                damageTexts.push_back(damageText);
-                            }
-                            
-                            // NEW DEATH SYSTEM: Check if client died
-                            bool wasKill = false;
-                            if (clientHealth <= 0.0f && clientIsAlive) {
-                                clientIsAlive = false;
-                                clientWaitingRespawn = true;
-                                clientRespawnTimer.restart(); // Start 5 second respawn timer
-                                wasKill = true;
-                                
-                                // Server gets kill reward
-                                serverPlayer.money += 5000;
-                                serverScore += 1;
-                                
-                                ErrorHandler::logInfo("!!! CLIENT PLAYER DIED !!! Server gets $5000 reward and +1 score. Server money: $" + std::to_string(serverPlayer.money) + ", Score: " + std::to_string(serverScore));
-                            }
-                            
-                            // Requirement 10.4: Send hit packet to client
-                            HitPacket hitPacket;
-                            hitPacket.shooterId = bullet.ownerId;
-                            hitPacket.victimId = 0; // Client is player 0
-                            hitPacket.damage = bullet.damage;
-                            hitPacket.hitX = clientPos.x;
-                            hitPacket.hitY = clientPos.y;
-                            hitPacket.wasKill = wasKill;
-                            
-                            // Send to client
-                            for (const auto& client : connectedClients) {
-                                if (client.socket && client.isReady) {
-                                    udpSocket.send(&hitPacket, sizeof(HitPacket), client.address, 53002);
-                                }
-                            }
-                            
-                            ErrorHandler::logInfo("Hit packet sent to client");
-                        }
-                    }
-                }
-                
-                // Get screen bounds with 20% buffer for culling
-                sf::Vector2f viewCenter = window.getView().getCenter();
-                sf::Vector2f viewSize = window.getView().getSize();
-                float bufferMultiplier = 1.2f;
-                float screenLeft = viewCenter.x - (viewSize.x * bufferMultiplier) / 2.0f;
-                float screenRight = viewCenter.x + (viewSize.x * bufferMultiplier) / 2.0f;
-                float screenTop = viewCenter.y - (viewSize.y * bufferMultiplier) / 2.0f;
-                float screenBottom = viewCenter.y + (viewSize.y * bufferMultiplier) / 2.0f;
-                
-                // Remove bullets that should be removed
-                activeBullets.erase(
-                    std::remove_if(activeBullets.begin(), activeBullets.end(),
-                        [screenLeft, screenRight, screenTop, screenBottom](const Bullet& b) {
-                            // Requirement 7.5: Remove if exceeded range
-                            if (b.shouldRemove()) return true;
-                            
-                            // Requirement 10.2: Remove if outside screen + 20% buffer
-                            if (b.x < screenLeft || b.x > screenRight || 
-                                b.y < screenTop || b.y > screenBottom) {
-                                return true;
-                            }
-                            
-                            return false;
-                        }),
-                    activeBullets.end()
-                );
-            }
-            
-            // Requirement 8.2: Update and remove expired damage texts
-            {
-                std::lock_guard<std::mutex> lock(damageTextsMutex);
-                damageTexts.erase(
-                    std::remove_if(damageTexts.begin(), damageTexts.end(),
-                        [](const DamageText& dt) {
-                            return dt.shouldRemove();
-                        }),
-                    damageTexts.end()
-                );
-            }
-            
-            // Update and remove expired purchase notification texts
-            {
-                std::lock_guard<std::mutex> lock(purchaseTextsMutex);
-                purchaseTexts.erase(
-                    std::remove_if(purchaseTexts.begin(), purchaseTexts.end(),
-                        [](const PurchaseText& pt) {
-                            return pt.shouldRemove();
-                        }),
-                    purchaseTexts.end()
-                );
-            }
-            
-            // NEW DEATH SYSTEM: Handle respawn with 5 second delay
-            if (serverWaitingRespawn) {
-                // Check if 5 seconds have passed since death
-                if (serverRespawnTimer.getElapsedTime().asSeconds() >= 5.0f) {
-                    // Respawn after 5 second delay
-                    ErrorHandler::logInfo("!!! SERVER PLAYER RESPAWNING !!!");
-                    serverHealth = 100.0f;
-                    serverIsAlive = true;
-                    serverWaitingRespawn = false;
-                
-                // Generate random respawn position at least 1000 pixels away from client
-                std::random_device rd;
-                std::mt19937 gen(rd());
-                const float MARGIN = CELL_SIZE;
-                std::uniform_real_distribution<float> xDist(MARGIN, MAP_SIZE - MARGIN);
-                std::uniform_real_distribution<float> yDist(MARGIN, MAP_SIZE - MARGIN);
-                
-                const int MAX_ATTEMPTS = 100;
-                bool foundValidSpawn = false;
-                
-                for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
-                    Position newSpawn;
-                    newSpawn.x = xDist(gen);
-                    newSpawn.y = yDist(gen);
-                    
-                    // Check if position is valid (no wall collision)
-                    if (checkCollision(sf::Vector2f(newSpawn.x, newSpawn.y), grid)) {
-                        continue;
-                    }
-                    
-                    // Check distance from client (must be >= 1000 pixels)
-                    float dx = newSpawn.x - clientPos.x;
-                    float dy = newSpawn.y - clientPos.y;
-                    float distance = std::sqrt(dx * dx + dy * dy);
-                    
-                    if (distance >= 1000.0f) {
-                        serverPos = newSpawn;
-                        serverPosPrevious = newSpawn;
-                        foundValidSpawn = true;
-                        ErrorHandler::logInfo("Server player respawned at (" + std::to_string(serverPos.x) + 
-                                            ", " + std::to_string(serverPos.y) + "), distance from client: " + 
-                                            std::to_string(distance) + " pixels");
-                        break;
-                    }
-                }
-                
-                    if (!foundValidSpawn) {
-                        // Fallback: use original spawn position
-                        serverPos.x = 250.0f;
-                        serverPos.y = 4850.0f;
-                        serverPosPrevious = serverPos;
-                        ErrorHandler::logWarning("Failed to find valid respawn position, using fallback");
-                    }
-                }
-            }
-            
-            // NEW DEATH SYSTEM: Handle client respawn with 5 second delay
-            if (clientWaitingRespawn) {
-                // Check if 5 seconds have passed since death
-                if (clientRespawnTimer.getElapsedTime().asSeconds() >= 5.0f) {
-                    // Respawn after 5 second delay
-                    ErrorHandler::logInfo("!!! CLIENT PLAYER RESPAWNING !!!");
-                    clientHealth = 100.0f;
-                    clientIsAlive = true;
-                    clientWaitingRespawn = false;
-                
-                // Generate random respawn position at least 1000 pixels away from server
-                std::random_device rd;
-                std::mt19937 gen(rd());
-                const float MARGIN = CELL_SIZE;
-                std::uniform_real_distribution<float> xDist(MARGIN, MAP_SIZE - MARGIN);
-                std::uniform_real_distribution<float> yDist(MARGIN, MAP_SIZE - MARGIN);
-                
-                const int MAX_ATTEMPTS = 100;
-                bool foundValidSpawn = false;
-                
-                for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
-                    Position newSpawn;
-                    newSpawn.x = xDist(gen);
-                    newSpawn.y = yDist(gen);
-                    
-                    // Check if position is valid (no wall collision)
-                    if (checkCollision(sf::Vector2f(newSpawn.x, newSpawn.y), grid)) {
-                        continue;
-                    }
-                    
-                    // Check distance from server (must be >= 1000 pixels)
-                    float dx = newSpawn.x - serverPos.x;
-                    float dy = newSpawn.y - serverPos.y;
-                    float distance = std::sqrt(dx * dx + dy * dy);
-                    
-                    if (distance >= 1000.0f) {
-                        clientPos = newSpawn;
-                        clientPosPrevious = newSpawn;
-                        clientPosTarget = newSpawn;
-                        foundValidSpawn = true;
-                        ErrorHandler::logInfo("Client player respawned at (" + std::to_string(clientPos.x) + 
-                                            ", " + std::to_string(clientPos.y) + "), distance from server: " + 
-                                            std::to_string(distance) + " pixels");
-                        break;
-                    }
-                }
-                
-                    if (!foundValidSpawn) {
-                        // Fallback: use original spawn position
-                        clientPos.x = 4850.0f;
-                        clientPos.y = 250.0f;
-                        clientPosPrevious = clientPos;
-                        clientPosTarget = clientPos;
-                        ErrorHandler::logWarning("Failed to find valid respawn position, using fallback");
-                    }
-                }
-            }
-            
-            // Update performance monitoring
-            size_t playerCount = gameState.getPlayerCount() + 1; // +1 for server player
-            // Count walls in the grid for performance monitoring
-            size_t wallCount = 0;
-            for (int i = 0; i < GRID_SIZE; i++) {
-                for (int j = 0; j < GRID_SIZE; j++) {
-                    if (grid[i][j].topWall != WallType::None) wallCount++;
-                    if (grid[i][j].rightWall != WallType::None) wallCount++;
-                    if (grid[i][j].bottomWall != WallType::None) wallCount++;
-                    if (grid[i][j].leftWall != WallType::None) wallCount++;
-                }
-            }
-            perfMonitor.update(deltaTime, playerCount, wallCount);
+            // The authoritative simulation (bullets, hits, respawns) runs on the
+            // simulation thread at serverTickRate - this loop only renders it
             
             // NEW: Update camera to follow server player
             // This must be called before any rendering to ensure the view is set correctly
@@ -5575,6 +8836,8 @@ int main() {
                 // NEW: Apply cell-based collision detection
                 newPos = resolveCollisionCellBased(oldPos, newPos, grid);
                 
+                // Simulation thread reads serverPos for hits and respawn distance checks
+                std::lock_guard<std::mutex> lock(mutex);
                 serverPos.x = newPos.x;
                 serverPos.y = newPos.y;
                 // Update player position for weapon firing
@@ -5596,36 +8859,23 @@ int main() {
             // Render visible walls using cell-based system
             renderVisibleWalls(window, sf::Vector2f(serverPos.x, serverPos.y), grid);
             
-            // Update and render connected clients with interpolation
+            // Render remote players from the player table (interpolated by the simulation tick)
             {
-                std::lock_guard<std::mutex> lock(mutex);
-                
-                // Interpolate client position for smooth movement
-                // This prevents jerky movement when receiving position updates at 20Hz
-                const float clientInterpolationSpeed = 15.0f; // Higher = faster catch-up
-                float clientAlpha = std::min(1.0f, deltaTime * clientInterpolationSpeed);
-                
-                clientPos.x = lerp(clientPos.x, clientPosTarget.x, clientAlpha);
-                clientPos.y = lerp(clientPos.y, clientPosTarget.y, clientAlpha);
-                
-                // Get all players from GameState for interpolated positions
-                auto allPlayers = gameState.getAllPlayers();
+                std::map<uint32_t, Player> allPlayers = gameState.getAllPlayers();
                 
-                for (auto& pair : clients) {
-                    sf::IpAddress ip = pair.first;
-
-                    if (clientSprites.find(ip) == clientSprites.end()) {
-                        clientSprites[ip] = sf::Sprite();
-                        clientSprites[ip].setTexture(playerTexture);
-                        clientSprites[ip].setOrigin(PLAYER_SIZE / 2.0f, PLAYER_SIZE / 2.0f);
+                for (const auto& pair : allPlayers) {
+                    const Player& player = pair.second;
+                    if (player.id == HOST_PLAYER_ID || !player.isAlive) continue;
+
+                    if (clientSprites.find(player.id) == clientSprites.end()) {
+                        clientSprites[player.id] = sf::Sprite();
+                        clientSprites[player.id].setTexture(playerTexture);
+                        clientSprites[player.id].setOrigin(PLAYER_SIZE / 2.0f, PLAYER_SIZE / 2.0f);
                     }
-
-                    // Use interpolated position for smooth movement
-                    sf::Vector2f renderClientPos(clientPos.x, clientPos.y);
                     
                     // Calculate distance from server player to client player
-                    float dx = renderClientPos.x - renderPos.x;
-                    float dy = renderClientPos.y - renderPos.y;
+                    float dx = player.x - renderPos.x;
+                    float dy = player.y - renderPos.y;
                     float distance = std::sqrt(dx * dx + dy * dy);
                     
                     // Calculate fog alpha
@@ -5633,17 +8883,19 @@ int main() {
                     
                     // Only draw if visible
                     if (alpha > 0) {
+                        sf::Sprite& sprite = clientSprites[player.id];
+                        
                         // Apply fog to client player sprite
-                        clientSprites[ip].setColor(sf::Color(255, 255, 255, alpha));
+                        sprite.setColor(sf::Color(255, 255, 255, alpha));
                         
                         // Position client sprite (centered on position)
-                        clientSprites[ip].setPosition(renderClientPos.x, renderClientPos.y);
+                        sprite.setPosition(player.x, player.y);
                         
                         // Apply client player rotation (subtract 90 degrees because sprite initially faces up)
-                        clientSprites[ip].setRotation(clientPlayer.rotation - 90.0f);
+                        sprite.setRotation(player.rotation - 90.0f);
                         
                         // Draw client player
-                        window.draw(clientSprites[ip]);
+                        window.draw(sprite);
                     }
                 }
             }
@@ -5660,10 +8912,10 @@ int main() {
                 sf::Vector2u bulletTexSize = bulletTexture.getSize();
                 bulletSprite.setOrigin(bulletTexSize.x / 2.0f, bulletTexSize.y / 2.0f);
                 
-                for (const auto& bullet : activeBullets) {
+                for (size_t i = 0; i < activeBullets.size(); ++i) {
                     // Calculate distance for fog
-                    float dx = bullet.x - renderPos.x;
-                    float dy = bullet.y - renderPos.y;
+                    float dx = activeBullets.x(i) - renderPos.x;
+                    float dy = activeBullets.y(i) - renderPos.y;
                     float distance = std::sqrt(dx * dx + dy * dy);
                     
                     // Calculate fog alpha
@@ -5671,17 +8923,12 @@ int main() {
                     
                     // Only draw if visible
                     if (alpha > 0) {
-                        // Calculate bullet direction and rotation
-                        float speed = std::sqrt(bullet.vx * bullet.vx + bullet.vy * bullet.vy);
-                        float dirX = (speed > 0.001f) ? bullet.vx / speed : 1.0f;
-                        float dirY = (speed > 0.001f) ? bullet.vy / speed : 0.0f;
-                        
                         // Calculate rotation angle (bullet points in direction of travel)
-                        float angle = std::atan2(dirY, dirX) * 180.0f / 3.14159f;
+                        float angle = std::atan2(activeBullets.vy(i), activeBullets.vx(i)) * 180.0f / 3.14159f;
                         
                         // Apply fog, position and rotation to bullet sprite
                         bulletSprite.setColor(sf::Color(255, 255, 255, alpha));
-                        bulletSprite.setPosition(bullet.x, bullet.y);
+                        bulletSprite.setPosition(activeBullets.x(i), activeBullets.y(i));
                         bulletSprite.setRotation(angle);
                         
                         window.draw(bulletSprite);
@@ -5787,14 +9034,11 @@ int main() {
             // Debug: Log health periodically
             static sf::Clock healthLogClock;
             static float lastLoggedHealth = serverHealth;
-            static float lastLoggedClientHealth = clientHealth;
             if (healthLogClock.getElapsedTime().asSeconds() > 3.0f || 
-                std::abs(serverHealth - lastLoggedHealth) > 0.1f ||
-                std::abs(clientHealth - lastLoggedClientHealth) > 0.1f) {
+                std::abs(serverHealth - lastLoggedHealth) > 0.1f) {
                 ErrorHandler::logInfo("Current server health: " + std::to_string(serverHealth) + 
-                                     ", Client health: " + std::to_string(clientHealth));
+                                     ", Players: " + std::to_string(gameState.getPlayerCount()));
                 lastLoggedHealth = serverHealth;
-                lastLoggedClientHealth = clientHealth;
                 healthLogClock.restart();
             }
             
@@ -6101,6 +9345,7 @@ int main() {
     // ��������� ������ UDP
     if (udpThreadStarted) {
         udpWorker.join();
+        simulationWorker.join();
     }
 
     return 0;
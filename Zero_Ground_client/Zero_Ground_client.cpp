@@ -3,6 +3,7 @@
 #include <iostream>
 #include <thread>
 #include <mutex>
+#include <map>
 #include <sstream>
 #include <iomanip>
 #include <memory>
@@ -10,6 +11,14 @@
 #include <array>
 #include <cstring>
 #include <queue>
+#include <deque>
+#include <atomic>
+#include <functional>
+#include <limits>
+
+#if defined(_MSC_VER)
+#include <intrin.h>  // __popcnt64
+#endif
 
 // Global icon image (needs to persist for window lifetime)
 sf::Image g_windowIcon;
@@ -38,15 +47,135 @@ enum class WallType : uint8_t {
     Wood = 2       // Wooden wall (brown)
 };
 
-// Cell structure for grid-based map
-// ========================
-// Each cell can have walls on its four sides
-// Walls are centered on cell boundaries (WALL_WIDTH/2 on each side)
-struct Cell {
-    WallType topWall = WallType::None;
-    WallType rightWall = WallType::None;
-    WallType bottomWall = WallType::None;
-    WallType leftWall = WallType::None;
+// Number of set bits
+inline int popCount(uint64_t mask) {
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(mask));
+#else
+    return __builtin_popcountll(mask);
+#endif
+}
+
+// Map walls stored on the cell edges they occupy
+//
+// A wall lies on the boundary between two cells, so it is stored once per edge
+// rather than once per cell side: the right wall of (i, j) and the left wall of
+// (i + 1, j) are the same edge and can no longer disagree. Two bit-planes hold
+// the horizontal edges (top of cell (i, j), lines j = 0..GRID_SIZE) and the
+// vertical edges (left of cell (i, j), lines i = 0..GRID_SIZE), 2 bits per edge
+// holding the WallType value, 32 edges per 64-bit word. Queries outside the map
+// return WallType::None. Walls are centered on their edge (WALL_WIDTH/2 on each side).
+//
+// PERFORMANCE: 2 x 83 words = 1,328 bytes for the whole map instead of 10 KB of
+// per-cell sides, so it stays in L1 and is sent to clients as one span; wall
+// counts take one popcount per 32 edges.
+class CellGrid {
+public:
+    static constexpr int EDGES_PER_PLANE = (GRID_SIZE + 1) * GRID_SIZE;
+    static constexpr int EDGES_PER_WORD = 32;
+    static constexpr int WORDS_PER_PLANE = (EDGES_PER_PLANE + EDGES_PER_WORD - 1) / EDGES_PER_WORD;
+    static constexpr int WORD_COUNT = 2 * WORDS_PER_PLANE;
+    static constexpr size_t BYTE_SIZE = WORD_COUNT * sizeof(uint64_t);  // Serialized map size
+    
+    CellGrid() { clear(); }
+    
+    // Wall on the horizontal edge along the top of cell (i, j), j in [0, GRID_SIZE]
+    WallType horizontal(int i, int j) const {
+        if (i < 0 || i >= GRID_SIZE || j < 0 || j > GRID_SIZE) return WallType::None;
+        return get(HORIZONTAL, j * GRID_SIZE + i);
+    }
+    
+    // Wall on the vertical edge along the left of cell (i, j), i in [0, GRID_SIZE]
+    WallType vertical(int i, int j) const {
+        if (i < 0 || i > GRID_SIZE || j < 0 || j >= GRID_SIZE) return WallType::None;
+        return get(VERTICAL, i * GRID_SIZE + j);
+    }
+    
+    void setHorizontal(int i, int j, WallType type) {
+        if (i < 0 || i >= GRID_SIZE || j < 0 || j > GRID_SIZE) return;
+        set(HORIZONTAL, j * GRID_SIZE + i, type);
+    }
+    
+    void setVertical(int i, int j, WallType type) {
+        if (i < 0 || i > GRID_SIZE || j < 0 || j >= GRID_SIZE) return;
+        set(VERTICAL, i * GRID_SIZE + j, type);
+    }
+    
+    // Wall on one side of cell (i, j): 0 = top, 1 = right, 2 = bottom, 3 = left
+    WallType wall(int i, int j, int side) const {
+        switch (side) {
+            case 0: return horizontal(i, j);
+            case 1: return vertical(i + 1, j);
+            case 2: return horizontal(i, j + 1);
+            default: return vertical(i, j);
+        }
+    }
+    
+    void setWall(int i, int j, int side, WallType type) {
+        switch (side) {
+            case 0: setHorizontal(i, j, type); break;
+            case 1: setVertical(i + 1, j, type); break;
+            case 2: setHorizontal(i, j + 1, type); break;
+            default: setVertical(i, j, type); break;
+        }
+    }
+    
+    // Number of walls, a word (32 edges) at a time
+    size_t countWalls() const {
+        size_t count = 0;
+        for (uint64_t word : words_) {
+            count += popCount((word | (word >> 1)) & LOW_BITS);
+        }
+        return count;
+    }
+    
+    // Number of walls of one type (Concrete or Wood)
+    size_t countWalls(WallType type) const {
+        size_t count = 0;
+        for (uint64_t word : words_) {
+            uint64_t low = word & LOW_BITS;
+            uint64_t high = (word >> 1) & LOW_BITS;
+            count += popCount(type == WallType::Wood ? (high & ~low) : (low & ~high));
+        }
+        return count;
+    }
+    
+    // Remove every wall
+    void clear() { words_.fill(0); }
+    
+    // Clear the bit pairs that encode no wall (the value 3 and the unused tail of
+    // each plane), so nothing received from the network can corrupt the map
+    void sanitize() {
+        const int tailEdges = EDGES_PER_PLANE % EDGES_PER_WORD;
+        const uint64_t tailMask = (tailEdges == 0) ? ~0ULL : (1ULL << (tailEdges * 2)) - 1;
+        for (int w = 0; w < WORD_COUNT; w++) {
+            uint64_t invalid = words_[w] & (words_[w] >> 1) & LOW_BITS;
+            words_[w] &= ~(invalid * 3);
+            if (w % WORDS_PER_PLANE == WORDS_PER_PLANE - 1) words_[w] &= tailMask;
+        }
+    }
+    
+    // Raw storage, WORD_COUNT words: the horizontal plane, then the vertical plane
+    const uint64_t* data() const { return words_.data(); }
+    uint64_t* data() { return words_.data(); }
+    
+private:
+    static constexpr int HORIZONTAL = 0;
+    static constexpr int VERTICAL = 1;
+    static constexpr uint64_t LOW_BITS = 0x5555555555555555ULL;  // Low bit of every edge
+    
+    WallType get(int plane, int edge) const {
+        uint64_t word = words_[plane * WORDS_PER_PLANE + edge / EDGES_PER_WORD];
+        return static_cast<WallType>((word >> (edge % EDGES_PER_WORD * 2)) & 3);
+    }
+    
+    void set(int plane, int edge, WallType type) {
+        uint64_t& word = words_[plane * WORDS_PER_PLANE + edge / EDGES_PER_WORD];
+        const int shift = edge % EDGES_PER_WORD * 2;
+        word = (word & ~(3ULL << shift)) | (static_cast<uint64_t>(type) << shift);
+    }
+    
+    std::array<uint64_t, WORD_COUNT> words_;
 };
 
 // ========================
@@ -555,7 +684,7 @@ struct Bullet {
     
     // Check collision with cell-based walls using ray casting (returns wall type if collision, None otherwise)
     // This method checks the trajectory from previous position to current position
-    WallType checkCellWallCollision(const std::vector<std::vector<Cell>>& grid, 
+    WallType checkCellWallCollision(const CellGrid& grid, 
                                     float prevX, float prevY) const {
         // Calculate which cells the bullet trajectory passes through
         int cellX1 = static_cast<int>(prevX / CELL_SIZE);
@@ -569,46 +698,22 @@ struct Bullet {
         int minCellY = std::max(0, std::min(cellY1, cellY2) - 1);
         int maxCellY = std::min(GRID_SIZE - 1, std::max(cellY1, cellY2) + 1);
         
-        // Check all cells along the trajectory
-        for (int i = minCellX; i <= maxCellX; i++) {
-            for (int j = minCellY; j <= maxCellY; j++) {
-                float cellWorldX = i * CELL_SIZE;
-                float cellWorldY = j * CELL_SIZE;
-                
-                // Check top wall
-                if (grid[i][j].topWall != WallType::None) {
-                    float wallX = cellWorldX;
-                    float wallY = cellWorldY - WALL_WIDTH / 2.0f;
-                    if (lineIntersectsRect(prevX, prevY, x, y, wallX, wallY, WALL_LENGTH, WALL_WIDTH)) {
-                        return grid[i][j].topWall;
-                    }
+        // Check the edges around those cells, each shared edge once
+        for (int j = minCellY; j <= maxCellY + 1; j++) {
+            for (int i = minCellX; i <= maxCellX; i++) {
+                WallType type = grid.horizontal(i, j);
+                if (type != WallType::None &&
+                    lineIntersectsRect(prevX, prevY, x, y, i * CELL_SIZE, j * CELL_SIZE - WALL_WIDTH / 2.0f, WALL_LENGTH, WALL_WIDTH)) {
+                    return type;
                 }
-                
-                // Check right wall
-                if (grid[i][j].rightWall != WallType::None) {
-                    float wallX = cellWorldX + CELL_SIZE - WALL_WIDTH / 2.0f;
-                    float wallY = cellWorldY;
-                    if (lineIntersectsRect(prevX, prevY, x, y, wallX, wallY, WALL_WIDTH, WALL_LENGTH)) {
-                        return grid[i][j].rightWall;
-                    }
-                }
-                
-                // Check bottom wall
-                if (grid[i][j].bottomWall != WallType::None) {
-                    float wallX = cellWorldX;
-                    float wallY = cellWorldY + CELL_SIZE - WALL_WIDTH / 2.0f;
-                    if (lineIntersectsRect(prevX, prevY, x, y, wallX, wallY, WALL_LENGTH, WALL_WIDTH)) {
-                        return grid[i][j].bottomWall;
-                    }
-                }
-                
-                // Check left wall
-                if (grid[i][j].leftWall != WallType::None) {
-                    float wallX = cellWorldX - WALL_WIDTH / 2.0f;
-                    float wallY = cellWorldY;
-                    if (lineIntersectsRect(prevX, prevY, x, y, wallX, wallY, WALL_WIDTH, WALL_LENGTH)) {
-                        return grid[i][j].leftWall;
-                    }
+            }
+        }
+        for (int i = minCellX; i <= maxCellX + 1; i++) {
+            for (int j = minCellY; j <= maxCellY; j++) {
+                WallType type = grid.vertical(i, j);
+                if (type != WallType::None &&
+                    lineIntersectsRect(prevX, prevY, x, y, i * CELL_SIZE - WALL_WIDTH / 2.0f, j * CELL_SIZE, WALL_WIDTH, WALL_LENGTH)) {
+                    return type;
                 }
             }
         }
@@ -829,6 +934,7 @@ struct ReadyPacket {
 struct StartPacket {
     MessageType type = MessageType::SERVER_START;
     uint32_t timestamp = 0;
+    uint16_t tickRate = 0;  // Server simulation ticks per second (snapshot ticks -> time)
 };
 
 struct MapDataPacket {
@@ -850,15 +956,17 @@ struct PositionPacket {
 // Requirement 4.1-4.5: Purchase validation and transaction
 struct PurchasePacket {
     uint8_t playerId;
-    uint8_t weaponType;  // Weapon::Type enum value
+    uint8_t weaponType;        // Weapon::Type enum value, 255 = buying ammo
+    uint8_t ammoType = 255;    // AmmoType enum value, 255 = buying a weapon
 };
 
-// Inventory update packet (server → all clients)
-// Sent after successful purchase to synchronize inventory
+// Inventory update packet (server → buyer)
+// Sent in answer to every purchase to confirm or undo it and synchronize the balance
 struct InventoryPacket {
     uint8_t playerId;
-    uint8_t slot;        // Which slot changed (0-3)
+    uint8_t slot;        // Which slot changed (0-3), 255 = none
     uint8_t weaponType;  // Weapon::Type enum value, 255 = empty slot
+    bool accepted;       // False if the server refused the purchase
     int newMoneyBalance;
 };
 
@@ -872,6 +980,7 @@ struct ShotPacket {
     float bulletSpeed;   // Bullet speed for this weapon
     float damage;        // Damage for this weapon
     float range;         // Range for this weapon
+    uint32_t viewTick;   // Tick of the latest server snapshot the shooter had (lag compensation)
 };
 
 // Requirement 10.4: Hit packet (server → all clients)
@@ -1017,246 +1126,1532 @@ bool validateConnect(const ConnectPacket& packet) {
 }
 
 // ========================
-// Collision Detection System
+// Snapshot Compression
 // ========================
 
-// Check if a circle collides with a rectangle
-bool circleRectCollision(sf::Vector2f center, float radius, const Wall& wall) {
-    // Find the closest point on the rectangle to the circle center
-    float closestX = std::max(wall.x, std::min(center.x, wall.x + wall.width));
-    float closestY = std::max(wall.y, std::min(center.y, wall.y + wall.height));
-    
-    float dx = center.x - closestX;
-    float dy = center.y - closestY;
-    
-    return (dx * dx + dy * dy) < (radius * radius);
-}
+// Player state as carried in snapshots, quantized to the map and byte ranges
+struct QuantizedPlayerState {
+    uint8_t id = 0;
+    uint16_t x = 0;         // 0..65535 over 0..MAP_SIZE (~0.08 px)
+    uint16_t y = 0;
+    uint16_t rotation = 0;  // 0..511 over 0..360 degrees (~0.7 degrees)
+    uint8_t health = 0;     // Whole hit points, clamped to 0..255
+    bool isAlive = false;
+};
 
-// Resolve collision and return corrected position
-sf::Vector2f resolveCollision(sf::Vector2f oldPos, sf::Vector2f newPos, float radius, const GameMap& map) {
-    // Query nearby walls using quadtree
-    sf::FloatRect queryArea(
-        newPos.x - radius - 1.0f,
-        newPos.y - radius - 1.0f,
-        radius * 2 + 2.0f,
-        radius * 2 + 2.0f
-    );
-    
-    if (map.spatialIndex) {
-        auto nearbyWalls = map.spatialIndex->query(queryArea);
-        
-        for (const Wall* wall : nearbyWalls) {
-            if (circleRectCollision(newPos, radius, *wall)) {
-                // Calculate penetration depth and push back
-                float closestX = std::max(wall->x, std::min(newPos.x, wall->x + wall->width));
-                float closestY = std::max(wall->y, std::min(newPos.y, wall->y + wall->height));
-                
-                float dx = newPos.x - closestX;
-                float dy = newPos.y - closestY;
-                float distance = std::sqrt(dx * dx + dy * dy);
-                
-                if (distance < 0.001f) {
-                    // Player is exactly on the wall edge, use old position
-                    return oldPos;
-                }
-                
-                // Calculate how much to push back (radius - distance)
-                float penetration = radius - distance;
-                float pushX = (dx / distance) * penetration;
-                float pushY = (dy / distance) * penetration;
-                
-                return sf::Vector2f(newPos.x + pushX, newPos.y + pushY);
-            }
-        }
-    }
-    
-    return newPos; // No collision
+const uint8_t SNAPSHOT_MARKER = 0xD5;           // First byte of a snapshot payload
+const int SNAPSHOT_ID_BITS = 6;                 // MAX_PLAYERS = 64
+const int SNAPSHOT_COUNT_BITS = 7;              // 0..64 players
+const int SNAPSHOT_POSITION_BITS = 16;
+const int SNAPSHOT_SMALL_DELTA_BITS = 10;       // Signed, +-511 units (~40 px) covers normal movement
+const int SNAPSHOT_ROTATION_BITS = 9;
+const int SNAPSHOT_HEALTH_BITS = 8;
+const int SNAPSHOT_BASELINE_BITS = 16;          // Baseline is sent as a tick offset
+const uint32_t SNAPSHOT_HISTORY_SIZE = 32;      // Snapshots kept as delta baselines (1.6 s at 20 Hz)
+const size_t MAX_SNAPSHOT_BYTES = 1192;         // Leaves room for the wire headers in one datagram
+const uint32_t NO_SNAPSHOT_ACK = 0xFFFFFFFF;    // Input message ackTick before the first snapshot
+
+uint16_t quantizePosition(float value) {
+    float clamped = std::max(0.0f, std::min(MAP_SIZE, value));
+    return static_cast<uint16_t>(std::lround(clamped / MAP_SIZE * 65535.0f));
 }
 
-// Clamp position to map boundaries [0, MAP_SIZE]
-// NOTE: This function is deprecated - collision system now handles boundary clamping
-// Kept for backward compatibility but not used in new cell-based system
-sf::Vector2f clampToMapBounds(sf::Vector2f pos, float radius) {
-    pos.x = std::max(radius, std::min(MAP_SIZE - radius, pos.x));
-    pos.y = std::max(radius, std::min(MAP_SIZE - radius, pos.y));
-    return pos;
+float dequantizePosition(uint16_t value) {
+    return value * (MAP_SIZE / 65535.0f);
 }
 
-// ========================
-// Movement and Interpolation Constants
-// ========================
-
-const float MOVEMENT_SPEED = 3.0f; // 5 units per second
-
-// Linear interpolation function for smooth position transitions
-float lerp(float start, float end, float alpha) {
-    return start + (end - start) * alpha;
+uint16_t quantizeRotation(float degrees) {
+    float wrapped = std::fmod(degrees, 360.0f);
+    if (wrapped < 0.0f) wrapped += 360.0f;
+    const uint32_t steps = 1u << SNAPSHOT_ROTATION_BITS;
+    return static_cast<uint16_t>(static_cast<uint32_t>(std::lround(wrapped / 360.0f * steps)) & (steps - 1));
 }
 
-sf::Vector2f lerpPosition(sf::Vector2f start, sf::Vector2f end, float alpha) {
-    return sf::Vector2f(lerp(start.x, end.x, alpha), lerp(start.y, end.y, alpha));
+float dequantizeRotation(uint16_t value) {
+    return value * (360.0f / (1u << SNAPSHOT_ROTATION_BITS));
 }
 
-// ========================
-// Performance Monitoring System
-// ========================
+QuantizedPlayerState quantizePlayerState(uint32_t id, float x, float y, float rotation, float health, bool isAlive) {
+    QuantizedPlayerState state;
+    state.id = static_cast<uint8_t>(id);
+    state.x = quantizePosition(x);
+    state.y = quantizePosition(y);
+    state.rotation = quantizeRotation(rotation);
+    state.health = static_cast<uint8_t>(std::max(0L, std::min(255L, std::lround(health))));
+    state.isAlive = isAlive;
+    return state;
+}
 
-class PerformanceMonitor {
+// Appends values of 1-32 bits to a fixed buffer, least significant bit first
+// Writing past the end sets overflowed() instead of growing the buffer
+class BitWriter {
 public:
-    PerformanceMonitor() : frameCount_(0), elapsedTime_(0.0f), currentFPS_(0.0f) {}
+    BitWriter(uint8_t* buffer, size_t capacity) : buffer_(buffer), capacity_(capacity), bitPos_(0), overflowed_(false) {
+        std::memset(buffer_, 0, capacity_);
+    }
     
-    // Update performance metrics each frame
-    void update(float deltaTime, size_t playerCount, size_t wallCount) {
-        frameCount_++;
-        elapsedTime_ += deltaTime;
-        
-        // Calculate FPS every 1 second window
-        if (elapsedTime_ >= 1.0f) {
-            currentFPS_ = frameCount_ / elapsedTime_;
-            
-            // Calculate frame time
-            float frameTime = (elapsedTime_ / frameCount_) * 1000.0f;
-            
-            // Calculate game thread load (percentage of frame budget used)
-            float gameThreadLoad = (frameTime / 16.67f) * 100.0f;
-            
-            // Estimate actual CPU usage (more conservative)
-            float estimatedCPUUsage = (gameThreadLoad / 100.0f) * 40.0f;
-            
-            // Log performance metrics
-            std::cout << "\n=== CLIENT PERFORMANCE METRICS ===" << std::endl;
-            std::cout << "FPS: " << currentFPS_ << " (target: 55+)" << std::endl;
-            std::cout << "Frame Time: " << frameTime << "ms" << std::endl;
-            std::cout << "Players: " << playerCount << std::endl;
-            std::cout << "Walls: " << wallCount << std::endl;
-            std::cout << "Game Thread Load: " << gameThreadLoad << "% of frame budget" << std::endl;
-            std::cout << "Estimated CPU Usage: " << estimatedCPUUsage << "% (target: <40%)" << std::endl;
-            
-            // Add build type hint if performance is lower
-            if (gameThreadLoad > 100.0f) {
-                std::cout << "Note: Running Debug build? Release build typically 30-50% faster" << std::endl;
-            }
-            
-            std::cout << "====================================\n" << std::endl;
-            
-            // Log warning if FPS drops below 55
-            if (currentFPS_ < 55.0f) {
-                logPerformanceWarning(playerCount, wallCount, gameThreadLoad);
-            }
-            
-            // Log warning if game thread load is too high
-            if (gameThreadLoad > 110.0f) {
-                std::cerr << "[WARNING] Game thread load exceeds frame budget: " 
-                         << gameThreadLoad << "%" << std::endl;
-                std::cerr << "  This means frames are taking longer than 16.67ms" << std::endl;
-                std::cerr << "  Consider optimizing or using Release build" << std::endl;
+    void write(uint32_t value, int bits) {
+        if (bitPos_ + bits > capacity_ * 8) {
+            overflowed_ = true;
+            return;
+        }
+        for (int i = 0; i < bits; ++i) {
+            if (value & (1u << i)) {
+                buffer_[bitPos_ >> 3] |= static_cast<uint8_t>(1u << (bitPos_ & 7));
             }
-            
-            // Reset counters for next window
-            frameCount_ = 0;
-            elapsedTime_ = 0.0f;
+            bitPos_++;
         }
     }
     
-    // Get current FPS
-    float getCurrentFPS() const {
-        return currentFPS_;
-    }
+    void writeBool(bool value) { write(value ? 1u : 0u, 1); }
     
-private:
-    void logPerformanceWarning(size_t playerCount, size_t wallCount, float gameThreadLoad) {
-        std::cerr << "[WARNING] Performance degradation detected!" << std::endl;
-        std::cerr << "  FPS: " << currentFPS_ << " (target: 55+)" << std::endl;
-        std::cerr << "  Players: " << playerCount << std::endl;
-        std::cerr << "  Walls: " << wallCount << std::endl;
-        
-        float frameTime = (elapsedTime_ / frameCount_) * 1000.0f;
-        std::cerr << "  Avg Frame Time: " << frameTime << "ms (target: 16.67ms)" << std::endl;
-        std::cerr << "  Game Thread Load: " << gameThreadLoad << "% of frame budget" << std::endl;
-        
-        // Provide helpful suggestions
-        if (gameThreadLoad > 100.0f) {
-            std::cerr << "  Suggestion: Try Release build for better performance" << std::endl;
-        }
-    }
+    size_t bytesWritten() const { return (bitPos_ + 7) / 8; }
+    bool overflowed() const { return overflowed_; }
     
-    int frameCount_;
-    float elapsedTime_;
-    float currentFPS_;
+private:
+    uint8_t* buffer_;
+    size_t capacity_;
+    size_t bitPos_;
+    bool overflowed_;
 };
 
-// ========================
-// Rounded Rectangle Helper
-// ========================
-
-// Create a rounded rectangle shape
-// Parameters:
-//   size - Size of the rectangle (width, height)
-//   radius - Radius of the rounded corners
-//   pointCount - Number of points per corner (higher = smoother, default = 8)
-// Returns: ConvexShape representing a rounded rectangle
-sf::ConvexShape createRoundedRectangle(sf::Vector2f size, float radius, unsigned int pointCount = 8) {
-    // Clamp radius to not exceed half of the smaller dimension
-    radius = std::min(radius, std::min(size.x, size.y) / 2.0f);
-    
-    // Total points: 4 corners * pointCount points per corner
-    sf::ConvexShape shape;
-    shape.setPointCount(pointCount * 4);
+// Reads values written by BitWriter straight from the receive buffer
+// Reading past the end returns 0 and sets failed(); callers check once at the end
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size) : data_(data), size_(size), bitPos_(0), failed_(false) {}
     
-    // Helper lambda to add corner points
-    auto addCorner = [&](unsigned int startIndex, sf::Vector2f center, float startAngle) {
-        for (unsigned int i = 0; i < pointCount; ++i) {
-            float angle = startAngle + (i * 90.0f / (pointCount - 1)) * 3.14159f / 180.0f;
-            float x = center.x + radius * std::cos(angle);
-            float y = center.y + radius * std::sin(angle);
-            shape.setPoint(startIndex + i, sf::Vector2f(x, y));
+    uint32_t read(int bits) {
+        if (bitPos_ + bits > size_ * 8) {
+            failed_ = true;
+            return 0;
         }
-    };
+        uint32_t value = 0;
+        for (int i = 0; i < bits; ++i) {
+            if (data_[bitPos_ >> 3] & (1u << (bitPos_ & 7))) {
+                value |= (1u << i);
+            }
+            bitPos_++;
+        }
+        return value;
+    }
     
-    // Top-left corner (180° to 270°)
-    addCorner(0, sf::Vector2f(radius, radius), 180.0f);
+    bool readBool() { return read(1) != 0; }
     
-    // Top-right corner (270° to 360°)
-    addCorner(pointCount, sf::Vector2f(size.x - radius, radius), 270.0f);
+    bool failed() const { return failed_; }
     
-    // Bottom-right corner (0° to 90°)
-    addCorner(pointCount * 2, sf::Vector2f(size.x - radius, size.y - radius), 0.0f);
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t bitPos_;
+    bool failed_;
+};
+
+// Recently sent (server, per client) or received (client) snapshots, usable as delta baselines
+// Slots are reused round-robin so the tick spacing between snapshots does not matter
+class SnapshotHistory {
+public:
+    void store(uint32_t tick, const std::vector<QuantizedPlayerState>& players) {
+        Entry& entry = entries_[next_];
+        entry.tick = tick;
+        entry.valid = true;
+        entry.players = players;  // Reuses the slot's capacity
+        next_ = (next_ + 1) % SNAPSHOT_HISTORY_SIZE;
+    }
     
-    // Bottom-left corner (90° to 180°)
-    addCorner(pointCount * 3, sf::Vector2f(radius, size.y - radius), 90.0f);
+    const std::vector<QuantizedPlayerState>* find(uint32_t tick) const {
+        for (const Entry& entry : entries_) {
+            if (entry.valid && entry.tick == tick) {
+                return &entry.players;
+            }
+        }
+        return nullptr;
+    }
     
-    return shape;
+private:
+    struct Entry {
+        uint32_t tick = 0;
+        bool valid = false;
+        std::vector<QuantizedPlayerState> players;  // Sorted by id
+    };
+    std::array<Entry, SNAPSHOT_HISTORY_SIZE> entries_;
+    uint32_t next_ = 0;
+};
+
+// Position field: unchanged (1 bit), small signed delta (12 bits) or full value (18 bits)
+inline void writePositionDelta(BitWriter& writer, uint16_t value, uint16_t base) {
+    int delta = static_cast<int>(value) - static_cast<int>(base);
+    const int smallLimit = 1 << (SNAPSHOT_SMALL_DELTA_BITS - 1);
+    writer.writeBool(delta != 0);
+    if (delta == 0) return;
+    bool small = delta >= -smallLimit && delta < smallLimit;
+    writer.writeBool(small);
+    if (small) {
+        writer.write(static_cast<uint32_t>(delta) & ((1u << SNAPSHOT_SMALL_DELTA_BITS) - 1), SNAPSHOT_SMALL_DELTA_BITS);
+    } else {
+        writer.write(value, SNAPSHOT_POSITION_BITS);
+    }
+}
+
+inline uint16_t readPositionDelta(BitReader& reader, uint16_t base) {
+    if (!reader.readBool()) return base;
+    if (!reader.readBool()) return static_cast<uint16_t>(reader.read(SNAPSHOT_POSITION_BITS));
+    uint32_t raw = reader.read(SNAPSHOT_SMALL_DELTA_BITS);
+    int delta = static_cast<int>(raw);
+    if (raw & (1u << (SNAPSHOT_SMALL_DELTA_BITS - 1))) {
+        delta -= (1 << SNAPSHOT_SMALL_DELTA_BITS);  // Sign-extend
+    }
+    return static_cast<uint16_t>(static_cast<int>(base) + delta);
+}
+
+// Encode one snapshot
+// Parameters:
+//   writer - Output buffer
+//   tick - Server tick of this snapshot
+//   players - States to send, sorted by id
+//   baseline - Snapshot the client acknowledged (nullptr = full snapshot)
+//   baselineTick - Tick of baseline, at most 65535 ticks old
+//
+// FORMAT (bit-packed, LSB first):
+//   marker:8  tick:32  hasBaseline:1  [tick - baselineTick:16]  count:7
+//   per player: id:6, then
+//     not in baseline: x:16 y:16 rotation:9 health:8 alive:1
+//     in baseline:     x:delta y:delta [changed:1 rotation:9] [changed:1 health:8] alive:1
+//   Players missing from a snapshot are not visible to the client (culled or gone).
+//
+// PERFORMANCE: a PositionPacket per player costs 32 bytes; a full entry is
+// 56 bits and an idle player in a delta snapshot is 11 bits (~23x smaller).
+void writeSnapshot(BitWriter& writer, uint32_t tick, const std::vector<QuantizedPlayerState>& players,
+                   const std::vector<QuantizedPlayerState>* baseline, uint32_t baselineTick) {
+    writer.write(SNAPSHOT_MARKER, 8);
+    writer.write(tick, 32);
+    writer.writeBool(baseline != nullptr);
+    if (baseline) {
+        writer.write(tick - baselineTick, SNAPSHOT_BASELINE_BITS);
+    }
+    writer.write(static_cast<uint32_t>(players.size()), SNAPSHOT_COUNT_BITS);
+    
+    size_t b = 0;  // Both lists are sorted by id: merge instead of searching
+    for (const QuantizedPlayerState& state : players) {
+        writer.write(state.id, SNAPSHOT_ID_BITS);
+        
+        const QuantizedPlayerState* base = nullptr;
+        if (baseline) {
+            while (b < baseline->size() && (*baseline)[b].id < state.id) b++;
+            if (b < baseline->size() && (*baseline)[b].id == state.id) base = &(*baseline)[b];
+        }
+        
+        if (base) {
+            writePositionDelta(writer, state.x, base->x);
+            writePositionDelta(writer, state.y, base->y);
+            writer.writeBool(state.rotation != base->rotation);
+            if (state.rotation != base->rotation) writer.write(state.rotation, SNAPSHOT_ROTATION_BITS);
+            writer.writeBool(state.health != base->health);
+            if (state.health != base->health) writer.write(state.health, SNAPSHOT_HEALTH_BITS);
+        } else {
+            writer.write(state.x, SNAPSHOT_POSITION_BITS);
+            writer.write(state.y, SNAPSHOT_POSITION_BITS);
+            writer.write(state.rotation, SNAPSHOT_ROTATION_BITS);
+            writer.write(state.health, SNAPSHOT_HEALTH_BITS);
+        }
+        writer.writeBool(state.isAlive);
+    }
+}
+
+// Decode one snapshot in place from the receive buffer
+// Parameters:
+//   data, size - Received datagram
+//   history - Previously decoded snapshots (delta baselines)
+//   tick - Out: server tick of the snapshot
+//   players - Out: decoded states, sorted by id
+// Returns: false if the datagram is malformed/truncated or its baseline is unknown
+bool readSnapshot(const uint8_t* data, size_t size, const SnapshotHistory& history,
+                  uint32_t& tick, std::vector<QuantizedPlayerState>& players) {
+    BitReader reader(data, size);
+    if (reader.read(8) != SNAPSHOT_MARKER) return false;
+    tick = reader.read(32);
+    
+    const std::vector<QuantizedPlayerState>* baseline = nullptr;
+    if (reader.readBool()) {
+        uint32_t baselineTick = tick - reader.read(SNAPSHOT_BASELINE_BITS);
+        baseline = history.find(baselineTick);
+        if (!baseline) return false;  // Baseline already evicted (or never received)
+    }
+    
+    uint32_t count = reader.read(SNAPSHOT_COUNT_BITS);
+    if (reader.failed() || count > (1u << SNAPSHOT_ID_BITS)) return false;
+    
+    players.clear();
+    size_t b = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        QuantizedPlayerState state;
+        state.id = static_cast<uint8_t>(reader.read(SNAPSHOT_ID_BITS));
+        if (!players.empty() && state.id <= players.back().id) return false;  // Must be strictly sorted
+        
+        const QuantizedPlayerState* base = nullptr;
+        if (baseline) {
+            while (b < baseline->size() && (*baseline)[b].id < state.id) b++;
+            if (b < baseline->size() && (*baseline)[b].id == state.id) base = &(*baseline)[b];
+        }
+        
+        if (base) {
+            state.x = readPositionDelta(reader, base->x);
+            state.y = readPositionDelta(reader, base->y);
+            state.rotation = reader.readBool() ? static_cast<uint16_t>(reader.read(SNAPSHOT_ROTATION_BITS)) : base->rotation;
+            state.health = reader.readBool() ? static_cast<uint8_t>(reader.read(SNAPSHOT_HEALTH_BITS)) : base->health;
+        } else {
+            state.x = static_cast<uint16_t>(reader.read(SNAPSHOT_POSITION_BITS));
+            state.y = static_cast<uint16_t>(reader.read(SNAPSHOT_POSITION_BITS));
+            state.rotation = static_cast<uint16_t>(reader.read(SNAPSHOT_ROTATION_BITS));
+            state.health = static_cast<uint8_t>(reader.read(SNAPSHOT_HEALTH_BITS));
+        }
+        state.isAlive = reader.readBool();
+        players.push_back(state);
+    }
+    
+    return !reader.failed();
+}
+
+// ========================
+// Wire Protocol
+// ========================
+
+// Every UDP datagram, in both directions, is a versioned header followed by
+// one or more length-prefixed messages:
+//
+//   header:       version:8, sequence:32
+//   per message:  type:8, length:16, payload[length]
+//
+// All integers are little-endian and every payload has an explicit byte layout
+// (see the *Message sections below), so struct padding and compiler ABI never
+// reach the wire and two messages of equal size can't be confused.
+// The sequence counts datagrams per sender and direction (loss detection).
+// Messages never span datagrams; a message that does not fit starts a new one.
+
+const uint8_t WIRE_VERSION = 5;                 // Version 4 input messages had no link report
+const size_t WIRE_HEADER_BYTES = 5;
+const size_t WIRE_MESSAGE_HEADER_BYTES = 3;
+const size_t MAX_DATAGRAM_BYTES = 1200;         // Stays below a typical 1500 byte MTU
+static_assert(MAX_SNAPSHOT_BYTES + WIRE_HEADER_BYTES + WIRE_MESSAGE_HEADER_BYTES <= MAX_DATAGRAM_BYTES,
+              "A full snapshot must fit in one datagram");
+
+enum class WireMessageType : uint8_t {
+    Input = 1,     // Client -> server: sequenced InputCommands and snapshot ack
+    Shot = 2,      // Both directions: ShotPacket
+    Hit = 3,          // Server -> client, reliable only: HitPacket
+    Snapshot = 4,     // Server -> client: writeSnapshot() payload
+    InputAck = 5,     // Server -> client: last simulated input and resulting position
+    Purchase = 6,     // Client -> server, reliable only: PurchasePacket
+    Inventory = 7,    // Server -> client, reliable only: InventoryPacket
+    Reliable = 8,     // Both directions: one of the above, sequenced (see ReliableChannel)
+    ReliableAck = 9   // Both directions: which Reliable messages arrived
+};
+const size_t WIRE_MESSAGE_TYPE_COUNT = 10;      // Type 0 is never valid
+
+// Little-endian field access; payloads are unaligned, so go through bytes
+inline void storeU16(uint8_t* p, uint16_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+}
+
+inline void storeU32(uint8_t* p, uint32_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+    p[2] = static_cast<uint8_t>(value >> 16);
+    p[3] = static_cast<uint8_t>(value >> 24);
+}
+
+inline void storeF32(uint8_t* p, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    storeU32(p, bits);
+}
+
+inline uint16_t loadU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t loadU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline float loadF32(const uint8_t* p) {
+    uint32_t bits = loadU32(p);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// ------------------------
+// Input Message
+// ------------------------
+// playerId:8, ackTick:32, ackDelay:16, lostDatagrams:16, firstSequence:32, count:8,
+// then count * (buttons:8, aim:16) with sequences firstSequence, firstSequence + 1, ...
+//
+// The client samples its controls INPUT_RATE times per second into sequenced
+// commands and sends the newest MAX_INPUT_COMMANDS with every datagram, so a lost
+// datagram is covered by the next one. The server simulates the movement itself
+// (see InputQueue) and never takes a position from the client.
+// ackDelay (ms the client held the ackTick snapshot before this send) and
+// lostDatagrams (running count of missing server sequence numbers, mod 65536)
+// are the client's link report: the server derives RTT and downstream loss from them.
+
+const float INPUT_RATE = 60.0f;                  // Commands per second (movement speeds are per 1/60 s)
+const float INPUT_STEP = 1.0f / INPUT_RATE;      // Simulated time per command
+const size_t MAX_INPUT_COMMANDS = 8;             // Newest commands repeated in every datagram
+const size_t INPUT_MESSAGE_HEADER_BYTES = 14;
+const size_t INPUT_COMMAND_BYTES = 3;
+const size_t MAX_INPUT_MESSAGE_BYTES = INPUT_MESSAGE_HEADER_BYTES + MAX_INPUT_COMMANDS * INPUT_COMMAND_BYTES;
+
+// Low nibble of InputCommand::buttons; the high nibble is the active weapon
+// (Weapon::Type + 1, 0 = no weapon), which decides the movement speed
+const uint16_t NO_ACK_DELAY = 0xFFFF;            // ackDelay before the first snapshot
+
+const uint8_t INPUT_UP = 0x01;
+const uint8_t INPUT_DOWN = 0x02;
+const uint8_t INPUT_LEFT = 0x04;
+const uint8_t INPUT_RIGHT = 0x08;
+
+// One sampled frame of client controls
+struct InputCommand {
+    uint32_t sequence = 0;  // Client input tick, +1 per command
+    uint8_t buttons = 0;    // INPUT_* bits | weapon code << 4
+    uint16_t aim = 0;       // Rotation, 1/65536 of a turn
+};
+
+// Client's view of the server -> client link, sent with every input message
+struct InputLinkReport {
+    uint16_t ackDelay = NO_ACK_DELAY;  // ms, see above
+    uint16_t lostDatagrams = 0;
+};
+
+inline uint8_t inputWeaponCode(uint8_t buttons) {
+    return static_cast<uint8_t>(buttons >> 4);
+}
+
+inline uint16_t quantizeAim(float degrees) {
+    float turns = degrees / 360.0f;
+    turns -= std::floor(turns);
+    return static_cast<uint16_t>(static_cast<uint32_t>(std::lround(turns * 65536.0f)) & 0xFFFF);
+}
+
+inline float dequantizeAim(uint16_t aim) {
+    return aim * (360.0f / 65536.0f);
+}
+
+// Write the input payload; count must be 1..MAX_INPUT_COMMANDS with consecutive sequences
+// Returns: payload length in bytes
+size_t writeInputMessage(uint8_t* out, uint8_t playerId, uint32_t ackTick, const InputLinkReport& link,
+                         const InputCommand* commands, size_t count) {
+    out[0] = playerId;
+    storeU32(out + 1, ackTick);
+    storeU16(out + 5, link.ackDelay);
+    storeU16(out + 7, link.lostDatagrams);
+    storeU32(out + 9, commands[0].sequence);
+    out[13] = static_cast<uint8_t>(count);
+    uint8_t* p = out + INPUT_MESSAGE_HEADER_BYTES;
+    for (size_t i = 0; i < count; ++i, p += INPUT_COMMAND_BYTES) {
+        p[0] = commands[i].buttons;
+        storeU16(p + 1, commands[i].aim);
+    }
+    return INPUT_MESSAGE_HEADER_BYTES + count * INPUT_COMMAND_BYTES;
+}
+
+// Reads a validated input payload in place (no copy)
+class InputMessageView {
+public:
+    InputMessageView(const uint8_t* payload, size_t length) : p_(payload), length_(length) {}
+    
+    uint8_t playerId() const { return p_[0]; }
+    uint32_t ackTick() const { return loadU32(p_ + 1); }
+    uint16_t ackDelay() const { return loadU16(p_ + 5); }
+    uint16_t lostDatagrams() const { return loadU16(p_ + 7); }
+    uint32_t firstSequence() const { return loadU32(p_ + 9); }
+    
+    // Commands actually present (the count field is checked against the length)
+    size_t count() const {
+        return std::min<size_t>(p_[13], (length_ - INPUT_MESSAGE_HEADER_BYTES) / INPUT_COMMAND_BYTES);
+    }
+    
+    InputCommand command(size_t index) const {
+        const uint8_t* p = p_ + INPUT_MESSAGE_HEADER_BYTES + index * INPUT_COMMAND_BYTES;
+        InputCommand command;
+        command.sequence = firstSequence() + static_cast<uint32_t>(index);
+        command.buttons = p[0];
+        command.aim = loadU16(p + 1);
+        return command;
+    }
+    
+private:
+    const uint8_t* p_;
+    size_t length_;
+};
+
+// ------------------------
+// Shot Message
+// ------------------------
+// playerId:8, x:f32, y:f32, dirX:f32, dirY:f32, weaponType:8,
+// bulletSpeed:f32, damage:f32, range:f32, viewTick:32
+
+const size_t SHOT_MESSAGE_BYTES = 34;
+
+void writeShotMessage(uint8_t* out, const ShotPacket& packet) {
+    out[0] = packet.playerId;
+    storeF32(out + 1, packet.x);
+    storeF32(out + 5, packet.y);
+    storeF32(out + 9, packet.dirX);
+    storeF32(out + 13, packet.dirY);
+    out[17] = packet.weaponType;
+    storeF32(out + 18, packet.bulletSpeed);
+    storeF32(out + 22, packet.damage);
+    storeF32(out + 26, packet.range);
+    storeU32(out + 30, packet.viewTick);
+}
+
+// Reads a validated shot payload in place (no copy)
+class ShotMessageView {
+public:
+    explicit ShotMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint8_t playerId() const { return p_[0]; }
+    float x() const { return loadF32(p_ + 1); }
+    float y() const { return loadF32(p_ + 5); }
+    float dirX() const { return loadF32(p_ + 9); }
+    float dirY() const { return loadF32(p_ + 13); }
+    uint8_t weaponType() const { return p_[17]; }
+    float bulletSpeed() const { return loadF32(p_ + 18); }
+    float damage() const { return loadF32(p_ + 22); }
+    float range() const { return loadF32(p_ + 26); }
+    uint32_t viewTick() const { return loadU32(p_ + 30); }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Hit Message
+// ------------------------
+// shooterId:8, victimId:8, damage:f32, hitX:f32, hitY:f32, wasKill:8
+
+const size_t HIT_MESSAGE_BYTES = 15;
+
+void writeHitMessage(uint8_t* out, const HitPacket& packet) {
+    out[0] = packet.shooterId;
+    out[1] = packet.victimId;
+    storeF32(out + 2, packet.damage);
+    storeF32(out + 6, packet.hitX);
+    storeF32(out + 10, packet.hitY);
+    out[14] = packet.wasKill ? 1 : 0;
+}
+
+// Reads a validated hit payload in place (no copy)
+class HitMessageView {
+public:
+    explicit HitMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint8_t shooterId() const { return p_[0]; }
+    uint8_t victimId() const { return p_[1]; }
+    float damage() const { return loadF32(p_ + 2); }
+    float hitX() const { return loadF32(p_ + 6); }
+    float hitY() const { return loadF32(p_ + 10); }
+    bool wasKill() const { return p_[14] != 0; }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Input Ack Message
+// ------------------------
+// sequence:32, x:f32, y:f32
+//
+// Sent to each client with its snapshot: the last input command the server
+// simulated for that client and the exact position it ended at. The client
+// rewinds its prediction to it and replays the newer commands (see InputPredictor).
+
+const size_t INPUT_ACK_MESSAGE_BYTES = 12;
+
+void writeInputAckMessage(uint8_t* out, uint32_t sequence, float x, float y) {
+    storeU32(out, sequence);
+    storeF32(out + 4, x);
+    storeF32(out + 8, y);
+}
+
+// Reads a validated input ack payload in place (no copy)
+class InputAckMessageView {
+public:
+    explicit InputAckMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint32_t sequence() const { return loadU32(p_); }
+    float x() const { return loadF32(p_ + 4); }
+    float y() const { return loadF32(p_ + 8); }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Purchase Message
+// ------------------------
+// playerId:8, weaponType:8, ammoType:8
+//
+// One shop purchase (client -> server, reliable). Exactly one of weaponType and
+// ammoType names an item; the other is PURCHASE_NONE.
+
+const size_t PURCHASE_MESSAGE_BYTES = 3;
+const uint8_t PURCHASE_NONE = 255;
+
+void writePurchaseMessage(uint8_t* out, const PurchasePacket& packet) {
+    out[0] = packet.playerId;
+    out[1] = packet.weaponType;
+    out[2] = packet.ammoType;
+}
+
+// Reads a validated purchase payload in place (no copy)
+class PurchaseMessageView {
+public:
+    explicit PurchaseMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint8_t playerId() const { return p_[0]; }
+    uint8_t weaponType() const { return p_[1]; }
+    uint8_t ammoType() const { return p_[2]; }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Inventory Message
+// ------------------------
+// playerId:8, slot:8, weaponType:8, accepted:8, newMoneyBalance:32
+//
+// The server's answer to one purchase (server -> buyer, reliable, same order as
+// the purchases). slot and weaponType are PURCHASE_NONE unless a weapon was added.
+
+const size_t INVENTORY_MESSAGE_BYTES = 8;
+
+void writeInventoryMessage(uint8_t* out, const InventoryPacket& packet) {
+    out[0] = packet.playerId;
+    out[1] = packet.slot;
+    out[2] = packet.weaponType;
+    out[3] = packet.accepted ? 1 : 0;
+    storeU32(out + 4, static_cast<uint32_t>(packet.newMoneyBalance));
+}
+
+// Reads a validated inventory payload in place (no copy)
+class InventoryMessageView {
+public:
+    explicit InventoryMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint8_t playerId() const { return p_[0]; }
+    uint8_t slot() const { return p_[1]; }
+    uint8_t weaponType() const { return p_[2]; }
+    bool accepted() const { return p_[3] != 0; }
+    int newMoneyBalance() const { return static_cast<int32_t>(loadU32(p_ + 4)); }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Reliable Message
+// ------------------------
+// id:16, type:8, then the payload of the wrapped message
+//
+// Purchases, inventory updates and hits must arrive exactly once and in order.
+// Instead of a second (TCP) connection, which would stall behind every lost
+// segment, they are wrapped in Reliable messages and ride on the same datagrams
+// as snapshots and inputs; ReliableChannel numbers, acknowledges, resends and
+// reorders them, and nothing unreliable ever waits for them.
+
+const size_t RELIABLE_MESSAGE_HEADER_BYTES = 3;
+const size_t MAX_RELIABLE_BODY_BYTES = 32;
+
+void writeReliableMessage(uint8_t* out, uint16_t id, uint8_t type, const uint8_t* body, size_t length) {
+    storeU16(out, id);
+    out[2] = type;
+    std::memcpy(out + RELIABLE_MESSAGE_HEADER_BYTES, body, length);
+}
+
+// Reads a validated reliable payload in place (no copy)
+class ReliableMessageView {
+public:
+    ReliableMessageView(const uint8_t* payload, size_t length) : p_(payload), length_(length) {}
+    
+    uint16_t id() const { return loadU16(p_); }
+    uint8_t type() const { return p_[2]; }
+    const uint8_t* body() const { return p_ + RELIABLE_MESSAGE_HEADER_BYTES; }
+    size_t bodyLength() const { return length_ - RELIABLE_MESSAGE_HEADER_BYTES; }
+    
+private:
+    const uint8_t* p_;
+    size_t length_;
+};
+
+// ------------------------
+// Reliable Ack Message
+// ------------------------
+// nextExpected:16, received:32
+//
+// nextExpected is the first reliable id not received yet (all older ones arrived);
+// bit i of received is set when id nextExpected + 1 + i is already buffered.
+
+const size_t RELIABLE_ACK_MESSAGE_BYTES = 6;
+
+void writeReliableAckMessage(uint8_t* out, uint16_t nextExpected, uint32_t received) {
+    storeU16(out, nextExpected);
+    storeU32(out + 2, received);
+}
+
+// Reads a validated reliable ack payload in place (no copy)
+class ReliableAckMessageView {
+public:
+    explicit ReliableAckMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint16_t nextExpected() const { return loadU16(p_); }
+    uint32_t received() const { return loadU32(p_ + 2); }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Decoding
+// ------------------------
+
+// Allowed payload length per message type, indexed by WireMessageType
+struct WireMessageSpec {
+    const char* name;
+    size_t minLength;
+    size_t maxLength;
+};
+
+const WireMessageSpec WIRE_MESSAGE_SPECS[WIRE_MESSAGE_TYPE_COUNT] = {
+    { "invalid", 1, 0 },  // Empty range: never accepted
+    { "input", INPUT_MESSAGE_HEADER_BYTES + INPUT_COMMAND_BYTES, MAX_INPUT_MESSAGE_BYTES },
+    { "shot", SHOT_MESSAGE_BYTES, SHOT_MESSAGE_BYTES },
+    { "hit", HIT_MESSAGE_BYTES, HIT_MESSAGE_BYTES },
+    { "snapshot", 1, MAX_SNAPSHOT_BYTES },
+    { "input ack", INPUT_ACK_MESSAGE_BYTES, INPUT_ACK_MESSAGE_BYTES },
+    { "purchase", PURCHASE_MESSAGE_BYTES, PURCHASE_MESSAGE_BYTES },
+    { "inventory", INVENTORY_MESSAGE_BYTES, INVENTORY_MESSAGE_BYTES },
+    { "reliable", RELIABLE_MESSAGE_HEADER_BYTES, RELIABLE_MESSAGE_HEADER_BYTES + MAX_RELIABLE_BODY_BYTES },
+    { "reliable ack", RELIABLE_ACK_MESSAGE_BYTES, RELIABLE_ACK_MESSAGE_BYTES }
+};
+
+enum class WireStatus {
+    Ok,
+    Truncated,    // Header or message runs past the end of the datagram
+    BadVersion,   // Sender speaks another protocol version
+    UnknownType,  // Type not in the table or not accepted by this receiver
+    BadLength     // Payload length outside the type's allowed range
+};
+
+// Message handler: payload points into the receive buffer and has been bounds-checked
+template <typename Context>
+using WireHandler = void (*)(const uint8_t* payload, size_t length, Context& context);
+
+// Read the datagram header
+// Returns: Ok and the sequence, or why the datagram was rejected
+inline WireStatus readWireHeader(const uint8_t* data, size_t size, uint32_t& sequence) {
+    if (size < WIRE_HEADER_BYTES) {
+        return WireStatus::Truncated;
+    }
+    if (data[0] != WIRE_VERSION) {
+        return WireStatus::BadVersion;
+    }
+    sequence = loadU32(data + 1);
+    return WireStatus::Ok;
+}
+
+// Validate a whole datagram in place, then dispatch each message to handlers[type]
+// Parameters:
+//   data, size - The received datagram (never copied)
+//   handlers - Handler per WireMessageType; null rejects that type
+//   context - Passed through to the handlers
+//   sequence - Receives the datagram sequence number
+// Returns: Ok if every message was dispatched; otherwise nothing was dispatched
+//
+// PERFORMANCE:
+// Type lookup is an array index and each message is checked once against the
+// spec table, so decoding is O(1) per message with no allocation. Validating
+// the whole datagram before dispatching means a malformed tail can't leave a
+// half-applied datagram behind.
+template <typename Context>
+WireStatus decodeDatagram(const uint8_t* data, size_t size, const WireHandler<Context>* handlers,
+                          Context& context, uint32_t& sequence) {
+    WireStatus status = readWireHeader(data, size, sequence);
+    if (status != WireStatus::Ok) {
+        return status;
+    }
+    
+    // Pass 1: bounds and type checks
+    size_t pos = WIRE_HEADER_BYTES;
+    while (pos < size) {
+        if (size - pos < WIRE_MESSAGE_HEADER_BYTES) {
+            return WireStatus::Truncated;
+        }
+        uint8_t type = data[pos];
+        size_t length = loadU16(data + pos + 1);
+        if (type >= WIRE_MESSAGE_TYPE_COUNT || handlers[type] == nullptr) {
+            return WireStatus::UnknownType;
+        }
+        if (length < WIRE_MESSAGE_SPECS[type].minLength || length > WIRE_MESSAGE_SPECS[type].maxLength) {
+            return WireStatus::BadLength;
+        }
+        pos += WIRE_MESSAGE_HEADER_BYTES;
+        if (size - pos < length) {
+            return WireStatus::Truncated;
+        }
+        pos += length;
+    }
+    
+    // Pass 2: dispatch
+    pos = WIRE_HEADER_BYTES;
+    while (pos < size) {
+        uint8_t type = data[pos];
+        size_t length = loadU16(data + pos + 1);
+        pos += WIRE_MESSAGE_HEADER_BYTES;
+        handlers[type](data + pos, length, context);
+        pos += length;
+    }
+    return WireStatus::Ok;
+}
+
+// Validate and dispatch one message that did not come straight from decodeDatagram
+// (the payload of a Reliable message, delivered once it is in order)
+// Returns: Ok if the handler was called
+template <typename Context>
+WireStatus dispatchWireMessage(uint8_t type, const uint8_t* payload, size_t length,
+                               const WireHandler<Context>* handlers, Context& context) {
+    if (type >= WIRE_MESSAGE_TYPE_COUNT || handlers[type] == nullptr) {
+        return WireStatus::UnknownType;
+    }
+    if (length < WIRE_MESSAGE_SPECS[type].minLength || length > WIRE_MESSAGE_SPECS[type].maxLength) {
+        return WireStatus::BadLength;
+    }
+    handlers[type](payload, length, context);
+    return WireStatus::Ok;
+}
+
+inline const char* wireStatusName(WireStatus status) {
+    switch (status) {
+        case WireStatus::Ok: return "ok";
+        case WireStatus::Truncated: return "truncated";
+        case WireStatus::BadVersion: return "wrong protocol version";
+        case WireStatus::UnknownType: return "unexpected message type";
+        case WireStatus::BadLength: return "bad message length";
+    }
+    return "unknown";
+}
+
+// ------------------------
+// Encoding
+// ------------------------
+
+// Builds the datagrams for one recipient
+// Completed datagrams are handed to the sink (data, size, message count);
+// call flush() once all messages have been appended.
+class DatagramBuilder {
+public:
+    using Sink = std::function<void(const uint8_t*, size_t, size_t)>;
+    
+    // firstSequence - Sequence number of the first datagram this builder sends
+    DatagramBuilder(Sink sink, uint32_t firstSequence)
+        : sink_(std::move(sink)), nextSequence_(firstSequence) {
+        buffer_[0] = WIRE_VERSION;
+    }
+    
+    // Reserve room for one message, flushing the current datagram first if it would not fit
+    // Returns: where to write the payload (exactly length bytes), or null if the
+    // message is too large for any datagram
+    uint8_t* reserve(WireMessageType type, size_t length) {
+        const size_t needed = WIRE_MESSAGE_HEADER_BYTES + length;
+        if (WIRE_HEADER_BYTES + needed > MAX_DATAGRAM_BYTES) {
+            return nullptr;
+        }
+        if (used_ + needed > MAX_DATAGRAM_BYTES) {
+            flush();
+        }
+        
+        buffer_[used_] = static_cast<uint8_t>(type);
+        storeU16(buffer_ + used_ + 1, static_cast<uint16_t>(length));
+        uint8_t* payload = buffer_ + used_ + WIRE_MESSAGE_HEADER_BYTES;
+        used_ += needed;
+        messageCount_++;
+        return payload;
+    }
+    
+    // Append a pre-encoded payload (e.g. a snapshot)
+    bool append(WireMessageType type, const uint8_t* payload, size_t length) {
+        uint8_t* out = reserve(type, length);
+        if (out == nullptr) {
+            return false;
+        }
+        std::memcpy(out, payload, length);
+        return true;
+    }
+    
+    // commands - Consecutive commands, oldest first (at most MAX_INPUT_COMMANDS are sent: the newest)
+    bool appendInput(uint8_t playerId, uint32_t ackTick, const InputLinkReport& link,
+                     const InputCommand* commands, size_t count) {
+        if (count == 0) {
+            return false;
+        }
+        if (count > MAX_INPUT_COMMANDS) {
+            commands += count - MAX_INPUT_COMMANDS;
+            count = MAX_INPUT_COMMANDS;
+        }
+        uint8_t* out = reserve(WireMessageType::Input, INPUT_MESSAGE_HEADER_BYTES + count * INPUT_COMMAND_BYTES);
+        if (out) writeInputMessage(out, playerId, ackTick, link, commands, count);
+        return out != nullptr;
+    }
+    
+    bool appendShot(const ShotPacket& packet) {
+        uint8_t* out = reserve(WireMessageType::Shot, SHOT_MESSAGE_BYTES);
+        if (out) writeShotMessage(out, packet);
+        return out != nullptr;
+    }
+    
+    bool appendHit(const HitPacket& packet) {
+        uint8_t* out = reserve(WireMessageType::Hit, HIT_MESSAGE_BYTES);
+        if (out) writeHitMessage(out, packet);
+        return out != nullptr;
+    }
+    
+    bool appendInputAck(uint32_t sequence, float x, float y) {
+        uint8_t* out = reserve(WireMessageType::InputAck, INPUT_ACK_MESSAGE_BYTES);
+        if (out) writeInputAckMessage(out, sequence, x, y);
+        return out != nullptr;
+    }
+    
+    // Hand the pending datagram to the sink (no-op when nothing is pending)
+    void flush() {
+        if (messageCount_ == 0) {
+            return;
+        }
+        storeU32(buffer_ + 1, nextSequence_++);
+        sink_(buffer_, used_, messageCount_);
+        datagramsSent_++;
+        used_ = WIRE_HEADER_BYTES;
+        messageCount_ = 0;
+    }
+    
+    size_t datagramsSent() const { return datagramsSent_; }
+    
+    // Sequence number the next datagram will carry
+    uint32_t nextSequence() const { return nextSequence_; }
+    
+private:
+    Sink sink_;
+    uint8_t buffer_[MAX_DATAGRAM_BYTES];
+    size_t used_ = WIRE_HEADER_BYTES;
+    size_t messageCount_ = 0;
+    size_t datagramsSent_ = 0;
+    uint32_t nextSequence_;
+};
+
+// ------------------------
+// Link Statistics
+// ------------------------
+
+// Smoothed round-trip time and its mean deviation (RFC 6298)
+// The deviation is the RTT jitter: how far single samples stray from the mean
+class RttEstimator {
+public:
+    void sample(float rtt) {
+        if (!hasSample_) {
+            smoothed_ = rtt;
+            variance_ = rtt * 0.5f;
+            hasSample_ = true;
+            return;
+        }
+        variance_ = 0.75f * variance_ + 0.25f * std::fabs(smoothed_ - rtt);
+        smoothed_ = 0.875f * smoothed_ + 0.125f * rtt;
+    }
+    
+    bool hasSample() const { return hasSample_; }
+    float smoothed() const { return smoothed_; }
+    float variance() const { return variance_; }
+    
+private:
+    bool hasSample_ = false;
+    float smoothed_ = 0.0f;
+    float variance_ = 0.0f;
+};
+
+// Loss and reordering of one incoming datagram stream, from its wire sequence numbers
+//
+// ALGORITHM:
+// A jump past the newest sequence counts the skipped ones as lost; a bit mask of
+// the last 64 sequences remembers which arrived, so a late datagram inside that
+// window is taken back from the loss count (out of order) and a repeated one is
+// a duplicate. Datagrams older than the window stay counted as lost - for a
+// real-time stream they are. Sequences before the first one received were never
+// counted as lost, so a late one only arrives out of order.
+class SequenceTracker {
+public:
+    // Take the sequence of one received datagram
+    // Returns: true if it is the newest so far
+    bool onDatagram(uint32_t sequence) {
+        if (!started_) {
+            started_ = true;
+            first_ = sequence;
+            newest_ = sequence;
+            seen_ = 1;
+            received_++;
+            return true;
+        }
+        if (sequence > newest_) {
+            const uint32_t skipped = sequence - newest_ - 1;
+            lost_ += skipped;
+            seen_ = (skipped >= 63) ? 1 : (seen_ << (skipped + 1)) | 1;
+            newest_ = sequence;
+            received_++;
+            return true;
+        }
+        
+        const uint32_t age = newest_ - sequence;
+        if (age < 64 && ((seen_ >> age) & 1)) {
+            duplicates_++;
+            return false;
+        }
+        if (age < 64) {
+            seen_ |= uint64_t(1) << age;
+            if (sequence > first_) {
+                lost_--;
+            }
+        }
+        outOfOrder_++;
+        received_++;
+        return false;
+    }
+    
+    uint64_t received() const { return received_; }      // Distinct datagrams
+    uint64_t lost() const { return lost_; }              // Missing sequence numbers
+    uint64_t outOfOrder() const { return outOfOrder_; }  // Arrived after a newer one
+    uint64_t duplicates() const { return duplicates_; }
+    
+private:
+    bool started_ = false;
+    uint32_t first_ = 0;   // Gaps are only counted after this one
+    uint32_t newest_ = 0;
+    uint64_t seen_ = 0;  // Bit i: newest_ - i arrived
+    uint64_t received_ = 0;
+    uint64_t lost_ = 0;
+    uint64_t outOfOrder_ = 0;
+    uint64_t duplicates_ = 0;
+};
+
+// ------------------------
+// Reliable Channel
+// ------------------------
+
+// Reliable, ordered message stream to one peer, carried on the unreliable datagrams
+//
+// ALGORITHM:
+// Sending: every message gets the next 16-bit id and stays queued until the peer
+// acknowledges it. write() appends the pending ack plus every message that was
+// never sent or whose resend timeout expired. Only WINDOW ids past the oldest
+// unacknowledged one are in flight, so everything the peer can have buffered
+// fits in the 32-bit ack mask. The timeout is smoothed RTT + 4 x RTT variance
+// (RFC 6298), sampled only from messages acknowledged after their first send
+// (Karn). A message that needs a second resend doubles it until the next
+// sample, so a sudden RTT rise can't cause endless spurious resends, while
+// single losses on a link that keeps answering are resent one timeout apart.
+// Receiving: messages ahead of the next expected id wait in WINDOW slots until
+// the gap is filled, then deliver() releases them in id order. Duplicates are
+// dropped but re-arm the ack, so a lost ack is repeated by the next datagram.
+//
+// PERFORMANCE:
+// Fixed rings indexed by id (both sizes divide 65536, so wraparound is free), no
+// allocation. The ack costs 9 bytes and only goes out after something arrived;
+// a lost message delays only the reliable messages behind it, never snapshots
+// or inputs.
+class ReliableChannel {
+public:
+    static const uint16_t WINDOW = 32;              // Ids in flight / buffered ahead of the gap
+    static const uint16_t QUEUE_CAPACITY = 128;     // Queued outgoing messages (in flight + waiting)
+    static constexpr float INITIAL_TIMEOUT = 0.2f;  // Resend timeout before the first RTT sample
+    static constexpr float MIN_TIMEOUT = 0.05f;     // Below this the peer's ack delay causes spurious resends
+    static constexpr float MAX_TIMEOUT = 1.0f;      // Cap for the backed-off timeout
+    static const int MAX_BACKOFF = 5;               // Doublings without an RTT sample
+    
+    // Queue a message for reliable delivery
+    // Returns: false if the body is too large or the queue is full (peer not acknowledging)
+    bool send(WireMessageType type, const uint8_t* body, size_t length) {
+        if (length > MAX_RELIABLE_BODY_BYTES || queued() == QUEUE_CAPACITY) {
+            return false;
+        }
+        Outgoing& message = outgoing_[nextSendId_ % QUEUE_CAPACITY];
+        message.type = static_cast<uint8_t>(type);
+        message.length = static_cast<uint8_t>(length);
+        std::memcpy(message.body, body, length);
+        message.sends = 0;
+        message.acked = false;
+        nextSendId_++;
+        return true;
+    }
+    
+    // Returns: true if write() would append anything at this time
+    bool wantsToSend(float now) const {
+        if (ackPending_) {
+            return true;
+        }
+        const uint16_t end = inFlightEnd();
+        for (uint16_t id = oldestUnacked_; id != end; ++id) {
+            const Outgoing& message = outgoing_[id % QUEUE_CAPACITY];
+            if (!message.acked && (message.sends == 0 || now - message.sentAt >= resendTimeout())) {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    // Append the pending ack and every message due for (re)sending
+    void write(DatagramBuilder& builder, float now) {
+        if (ackPending_) {
+            uint8_t* out = builder.reserve(WireMessageType::ReliableAck, RELIABLE_ACK_MESSAGE_BYTES);
+            if (out) {
+                writeReliableAckMessage(out, nextReceiveId_, receivedMask());
+                ackPending_ = false;
+            }
+        }
+        
+        const uint16_t end = inFlightEnd();
+        const float timeout = resendTimeout();
+        bool resentAgain = false;
+        for (uint16_t id = oldestUnacked_; id != end; ++id) {
+            Outgoing& message = outgoing_[id % QUEUE_CAPACITY];
+            if (message.acked || (message.sends > 0 && now - message.sentAt < timeout)) {
+                continue;
+            }
+            uint8_t* out = builder.reserve(WireMessageType::Reliable, RELIABLE_MESSAGE_HEADER_BYTES + message.length);
+            if (!out) {
+                continue;
+            }
+            writeReliableMessage(out, id, message.type, message.body, message.length);
+            if (message.sends > 0) {
+                resends_++;
+                resentAgain = resentAgain || message.sends > 1;
+            }
+            if (message.sends < 255) {
+                message.sends++;
+            }
+            message.sentAt = now;
+        }
+        if (resentAgain && backoff_ < MAX_BACKOFF) {
+            backoff_++;
+        }
+    }
+    
+    // Take the peer's ack (see the Reliable Ack Message layout)
+    void onAck(uint16_t nextExpected, uint32_t received, float now) {
+        // An ack for ids we never sent is stale or forged
+        if (before(nextSendId_, nextExpected)) {
+            return;
+        }
+        
+        const uint16_t end = inFlightEnd();
+        for (uint16_t id = oldestUnacked_; id != end; ++id) {
+            Outgoing& message = outgoing_[id % QUEUE_CAPACITY];
+            if (message.acked || message.sends == 0) {
+                continue;
+            }
+            const uint16_t bit = static_cast<uint16_t>(id - nextExpected - 1);
+            if (!before(id, nextExpected) && !(bit < 32 && ((received >> bit) & 1))) {
+                continue;
+            }
+            message.acked = true;
+            // A resent message's ack may answer any of its copies: no sample
+            if (message.sends == 1) {
+                sampleRtt(now - message.sentAt);
+            }
+        }
+        
+        while (oldestUnacked_ != nextSendId_ && outgoing_[oldestUnacked_ % QUEUE_CAPACITY].acked) {
+            oldestUnacked_++;
+        }
+    }
+    
+    // Take one received message; call deliver() afterwards
+    // Returns: false for a duplicate or an id outside the receive window
+    bool receive(uint16_t id, uint8_t type, const uint8_t* body, size_t length) {
+        ackPending_ = true;
+        if (before(id, nextReceiveId_) || static_cast<uint16_t>(id - nextReceiveId_) >= WINDOW ||
+            length > MAX_RELIABLE_BODY_BYTES) {
+            duplicates_++;
+            return false;
+        }
+        Incoming& slot = incoming_[id % WINDOW];
+        if (slot.present) {
+            duplicates_++;
+            return false;
+        }
+        slot.present = true;
+        slot.type = type;
+        slot.length = static_cast<uint8_t>(length);
+        std::memcpy(slot.body, body, length);
+        return true;
+    }
+    
+    // Hand every message that is now in order to fn(type, body, length), oldest first
+    // fn may send() on this channel
+    template <typename Fn>
+    void deliver(Fn&& fn) {
+        while (incoming_[nextReceiveId_ % WINDOW].present) {
+            Incoming& slot = incoming_[nextReceiveId_ % WINDOW];
+            slot.present = false;
+            nextReceiveId_++;
+            fn(slot.type, static_cast<const uint8_t*>(slot.body), static_cast<size_t>(slot.length));
+        }
+    }
+    
+    // Resend timeout from the RTT estimate, before backoff
+    float timeout() const {
+        if (!rtt_.hasSample()) {
+            return INITIAL_TIMEOUT;
+        }
+        return std::min(MAX_TIMEOUT, std::max(MIN_TIMEOUT, rtt_.smoothed() + 4.0f * rtt_.variance()));
+    }
+    
+    bool hasRttSample() const { return rtt_.hasSample(); }
+    float smoothedRtt() const { return rtt_.smoothed(); }
+    float rttVariance() const { return rtt_.variance(); }
+    size_t resends() const { return resends_; }
+    size_t duplicates() const { return duplicates_; }
+    
+    // Messages sent or waiting to be sent that the peer has not acknowledged
+    uint16_t queued() const { return static_cast<uint16_t>(nextSendId_ - oldestUnacked_); }
+    
+private:
+    struct Outgoing {
+        uint8_t type = 0;
+        uint8_t length = 0;
+        uint8_t sends = 0;     // 0 = never sent
+        bool acked = false;
+        float sentAt = 0.0f;   // Time of the latest send
+        uint8_t body[MAX_RELIABLE_BODY_BYTES];
+    };
+    
+    struct Incoming {
+        bool present = false;
+        uint8_t type = 0;
+        uint8_t length = 0;
+        uint8_t body[MAX_RELIABLE_BODY_BYTES];
+    };
+    
+    // Serial number order: a comes before b (valid while they are < 32768 apart)
+    static bool before(uint16_t a, uint16_t b) {
+        return static_cast<int16_t>(static_cast<uint16_t>(a - b)) < 0;
+    }
+    
+    // One past the newest id that may be in flight
+    uint16_t inFlightEnd() const {
+        return queued() > WINDOW ? static_cast<uint16_t>(oldestUnacked_ + WINDOW) : nextSendId_;
+    }
+    
+    float resendTimeout() const {
+        return std::min(MAX_TIMEOUT, timeout() * static_cast<float>(1u << backoff_));
+    }
+    
+    uint32_t receivedMask() const {
+        uint32_t mask = 0;
+        for (uint16_t i = 0; i + 1 < WINDOW; ++i) {
+            if (incoming_[static_cast<uint16_t>(nextReceiveId_ + 1 + i) % WINDOW].present) {
+                mask |= uint32_t(1) << i;
+            }
+        }
+        return mask;
+    }
+    
+    void sampleRtt(float rtt) {
+        backoff_ = 0;
+        rtt_.sample(rtt);
+    }
+    
+    std::array<Outgoing, QUEUE_CAPACITY> outgoing_;
+    std::array<Incoming, WINDOW> incoming_;
+    uint16_t nextSendId_ = 0;
+    uint16_t oldestUnacked_ = 0;
+    uint16_t nextReceiveId_ = 0;
+    bool ackPending_ = false;
+    int backoff_ = 0;
+    RttEstimator rtt_;
+    size_t resends_ = 0;
+    size_t duplicates_ = 0;
+};
+
+// ========================
+// Collision Detection System
+// ========================
+
+// Check if a circle collides with a rectangle
+bool circleRectCollision(sf::Vector2f center, float radius, const Wall& wall) {
+    // Find the closest point on the rectangle to the circle center
+    float closestX = std::max(wall.x, std::min(center.x, wall.x + wall.width));
+    float closestY = std::max(wall.y, std::min(center.y, wall.y + wall.height));
+    
+    float dx = center.x - closestX;
+    float dy = center.y - closestY;
+    
+    return (dx * dx + dy * dy) < (radius * radius);
+}
+
+// Resolve collision and return corrected position
+sf::Vector2f resolveCollision(sf::Vector2f oldPos, sf::Vector2f newPos, float radius, const GameMap& map) {
+    // Query nearby walls using quadtree
+    sf::FloatRect queryArea(
+        newPos.x - radius - 1.0f,
+        newPos.y - radius - 1.0f,
+        radius * 2 + 2.0f,
+        radius * 2 + 2.0f
+    );
+    
+    if (map.spatialIndex) {
+        auto nearbyWalls = map.spatialIndex->query(queryArea);
+        
+        for (const Wall* wall : nearbyWalls) {
+            if (circleRectCollision(newPos, radius, *wall)) {
+                // Calculate penetration depth and push back
+                float closestX = std::max(wall->x, std::min(newPos.x, wall->x + wall->width));
+                float closestY = std::max(wall->y, std::min(newPos.y, wall->y + wall->height));
+                
+                float dx = newPos.x - closestX;
+                float dy = newPos.y - closestY;
+                float distance = std::sqrt(dx * dx + dy * dy);
+                
+                if (distance < 0.001f) {
+                    // Player is exactly on the wall edge, use old position
+                    return oldPos;
+                }
+                
+                // Calculate how much to push back (radius - distance)
+                float penetration = radius - distance;
+                float pushX = (dx / distance) * penetration;
+                float pushY = (dy / distance) * penetration;
+                
+                return sf::Vector2f(newPos.x + pushX, newPos.y + pushY);
+            }
+        }
+    }
+    
+    return newPos; // No collision
+}
+
+// Clamp position to map boundaries [0, MAP_SIZE]
+// NOTE: This function is deprecated - collision system now handles boundary clamping
+// Kept for backward compatibility but not used in new cell-based system
+sf::Vector2f clampToMapBounds(sf::Vector2f pos, float radius) {
+    pos.x = std::max(radius, std::min(MAP_SIZE - radius, pos.x));
+    pos.y = std::max(radius, std::min(MAP_SIZE - radius, pos.y));
+    return pos;
+}
+
+// ========================
+// Movement and Interpolation Constants
+// ========================
+
+const float MOVEMENT_SPEED = 3.0f; // 5 units per second
+
+// Linear interpolation function for smooth position transitions
+float lerp(float start, float end, float alpha) {
+    return start + (end - start) * alpha;
+}
+
+sf::Vector2f lerpPosition(sf::Vector2f start, sf::Vector2f end, float alpha) {
+    return sf::Vector2f(lerp(start.x, end.x, alpha), lerp(start.y, end.y, alpha));
+}
+
+// ========================
+// Performance Monitoring System
+// ========================
+
+class PerformanceMonitor {
+public:
+    PerformanceMonitor() : frameCount_(0), elapsedTime_(0.0f), currentFPS_(0.0f) {}
+    
+    // Update performance metrics each frame
+    // shopOpen splits the frame time so the shop UI cost shows up on its own
+    void update(float deltaTime, size_t playerCount, size_t wallCount, bool shopOpen = false) {
+        frameCount_++;
+        elapsedTime_ += deltaTime;
+        if (shopOpen) {
+            shopOpenFrames_++;
+            shopOpenTime_ += deltaTime;
+        }
+        
+        // Calculate FPS every 1 second window
+        if (elapsedTime_ >= 1.0f) {
+            currentFPS_ = frameCount_ / elapsedTime_;
+            
+            // Calculate frame time
+            float frameTime = (elapsedTime_ / frameCount_) * 1000.0f;
+            
+            // Calculate game thread load (percentage of frame budget used)
+            float gameThreadLoad = (frameTime / 16.67f) * 100.0f;
+            
+            // Estimate actual CPU usage (more conservative)
+            float estimatedCPUUsage = (gameThreadLoad / 100.0f) * 40.0f;
+            
+            // Log performance metrics
+            std::cout << "\n=== CLIENT PERFORMANCE METRICS ===" << std::endl;
+            std::cout << "FPS: " << currentFPS_ << " (target: 55+)" << std::endl;
+            std::cout << "Frame Time: " << frameTime << "ms" << std::endl;
+            if (shopOpenFrames_ > 0) {
+                int closedFrames = frameCount_ - shopOpenFrames_;
+                std::cout << "Frame Time (shop open): " << (shopOpenTime_ / shopOpenFrames_) * 1000.0f
+                          << "ms over " << shopOpenFrames_ << " frames" << std::endl;
+                if (closedFrames > 0) {
+                    std::cout << "Frame Time (shop closed): " << ((elapsedTime_ - shopOpenTime_) / closedFrames) * 1000.0f
+                              << "ms over " << closedFrames << " frames" << std::endl;
+                }
+            }
+            std::cout << "Players: " << playerCount << std::endl;
+            std::cout << "Walls: " << wallCount << std::endl;
+            if (interpolationDelay_ > 0.0f) {
+                std::cout << "Interpolation Delay: " << interpolationDelay_ * 1000.0f << "ms (jitter "
+                          << interpolationJitter_ * 1000.0f << "ms, extrapolated " << extrapolatedFrames_
+                          << " frames)" << std::endl;
+            }
+            std::cout << "Game Thread Load: " << gameThreadLoad << "% of frame budget" << std::endl;
+            std::cout << "Estimated CPU Usage: " << estimatedCPUUsage << "% (target: <40%)" << std::endl;
+            
+            // Add build type hint if performance is lower
+            if (gameThreadLoad > 100.0f) {
+                std::cout << "Note: Running Debug build? Release build typically 30-50% faster" << std::endl;
+            }
+            
+            std::cout << "====================================\n" << std::endl;
+            
+            // Log warning if FPS drops below 55
+            if (currentFPS_ < 55.0f) {
+                logPerformanceWarning(playerCount, wallCount, gameThreadLoad);
+            }
+            
+            // Log warning if game thread load is too high
+            if (gameThreadLoad > 110.0f) {
+                std::cerr << "[WARNING] Game thread load exceeds frame budget: " 
+                         << gameThreadLoad << "%" << std::endl;
+                std::cerr << "  This means frames are taking longer than 16.67ms" << std::endl;
+                std::cerr << "  Consider optimizing or using Release build" << std::endl;
+            }
+            
+            // Reset counters for next window
+            frameCount_ = 0;
+            elapsedTime_ = 0.0f;
+            shopOpenFrames_ = 0;
+            shopOpenTime_ = 0.0f;
+            extrapolatedFrames_ = 0;
+        }
+    }
+    
+    // Remote player interpolation this frame: delay and jitter in seconds,
+    // and whether any player was extrapolated past its newest snapshot
+    void recordInterpolation(float delay, float jitter, bool extrapolated) {
+        interpolationDelay_ = delay;
+        interpolationJitter_ = jitter;
+        if (extrapolated) {
+            extrapolatedFrames_++;
+        }
+    }
+    
+    // Get current FPS
+    float getCurrentFPS() const {
+        return currentFPS_;
+    }
+    
+private:
+    void logPerformanceWarning(size_t playerCount, size_t wallCount, float gameThreadLoad) {
+        std::cerr << "[WARNING] Performance degradation detected!" << std::endl;
+        std::cerr << "  FPS: " << currentFPS_ << " (target: 55+)" << std::endl;
+        std::cerr << "  Players: " << playerCount << std::endl;
+        std::cerr << "  Walls: " << wallCount << std::endl;
+        
+        float frameTime = (elapsedTime_ / frameCount_) * 1000.0f;
+        std::cerr << "  Avg Frame Time: " << frameTime << "ms (target: 16.67ms)" << std::endl;
+        std::cerr << "  Game Thread Load: " << gameThreadLoad << "% of frame budget" << std::endl;
+        
+        // Provide helpful suggestions
+        if (gameThreadLoad > 100.0f) {
+            std::cerr << "  Suggestion: Try Release build for better performance" << std::endl;
+        }
+    }
+    
+    int frameCount_;
+    float elapsedTime_;
+    float currentFPS_;
+    int shopOpenFrames_ = 0;      // Frames in this window with the shop UI open
+    float shopOpenTime_ = 0.0f;
+    float interpolationDelay_ = 0.0f;
+    float interpolationJitter_ = 0.0f;
+    int extrapolatedFrames_ = 0;  // Frames in this window with a remote player extrapolated
+};
+
+// ========================
+// Rounded Rectangle Helper
+// ========================
+
+// Create a rounded rectangle shape
+// Parameters:
+//   size - Size of the rectangle (width, height)
+//   radius - Radius of the rounded corners
+//   pointCount - Number of points per corner (higher = smoother, default = 8)
+// Returns: ConvexShape representing a rounded rectangle
+sf::ConvexShape createRoundedRectangle(sf::Vector2f size, float radius, unsigned int pointCount = 8) {
+    // Clamp radius to not exceed half of the smaller dimension
+    radius = std::min(radius, std::min(size.x, size.y) / 2.0f);
+    
+    // Total points: 4 corners * pointCount points per corner
+    sf::ConvexShape shape;
+    shape.setPointCount(pointCount * 4);
+    
+    // Helper lambda to add corner points
+    auto addCorner = [&](unsigned int startIndex, sf::Vector2f center, float startAngle) {
+        for (unsigned int i = 0; i < pointCount; ++i) {
+            float angle = startAngle + (i * 90.0f / (pointCount - 1)) * 3.14159f / 180.0f;
+            float x = center.x + radius * std::cos(angle);
+            float y = center.y + radius * std::sin(angle);
+            shape.setPoint(startIndex + i, sf::Vector2f(x, y));
+        }
+    };
+    
+    // Top-left corner (180° to 270°)
+    addCorner(0, sf::Vector2f(radius, radius), 180.0f);
+    
+    // Top-right corner (270° to 360°)
+    addCorner(pointCount, sf::Vector2f(size.x - radius, radius), 270.0f);
+    
+    // Bottom-right corner (0° to 90°)
+    addCorner(pointCount * 2, sf::Vector2f(size.x - radius, size.y - radius), 0.0f);
+    
+    // Bottom-left corner (90° to 180°)
+    addCorner(pointCount * 3, sf::Vector2f(radius, size.y - radius), 90.0f);
+    
+    return shape;
 }
 
 // ========================
-// PERFORMANCE: Global Visibility Cache
+// PERFORMANCE: Global Fog Vertex Cache
 // ========================
 
-// Global visibility cache for fog of war
-// Cache is updated only when player moves significantly (50+ pixels)
-struct VisibilityCache {
-    std::vector<std::vector<bool>> cache;
-    sf::Vector2f lastPlayerPos = sf::Vector2f(-1000.0f, -1000.0f);
-    float cacheChunkSize = 50.0f;  // Larger cache chunks for better performance
-    int cacheChunksX = 0;
-    int cacheChunksY = 0;
-    float minX = 0.0f;
-    float minY = 0.0f;
-    bool needsUpdate = true;
-};
-
-// Global instance of visibility cache
-VisibilityCache g_visibilityCache;
+const float FOG_TILE_SIZE = 15.0f;      // Side of one fog quad (world-aligned)
+const float FOG_LAYOUT_SLACK = 150.0f;  // Extra area laid out around the view so scrolling rarely re-lays quads
 
-// PERFORMANCE: Global vertex cache - rebuilt only when visibility changes
+// PERFORMANCE: Global vertex cache - quad positions are laid out once per region,
+// colors are rewritten only for quads whose visibility changed
 struct BackgroundVertexCache {
     sf::VertexArray vertices;
+    std::vector<uint8_t> tileLit;     // Per quad: 1 lit, 0 dark, 2 not colored yet
+    int tilesX = 0;
+    int tilesY = 0;
+    float layoutMinX = 0.0f;          // Laid-out region (multiples of FOG_TILE_SIZE)
+    float layoutMinY = 0.0f;
+    float layoutMaxX = 0.0f;
+    float layoutMaxY = 0.0f;
     sf::Vector2f lastPlayerPos = sf::Vector2f(-1000.0f, -1000.0f);
-    float lastMinX = 0.0f;
-    float lastMaxX = 0.0f;
-    float lastMinY = 0.0f;
-    float lastMaxY = 0.0f;
-    bool needsUpdate = true;
+    bool needsUpdate = true;          // Force a re-layout (new map)
 };
 
 BackgroundVertexCache g_bgVertexCache;
@@ -1265,105 +2660,567 @@ BackgroundVertexCache g_bgVertexCache;
 // Line of Sight Check (Wall Occlusion)
 // ========================
 
+// Slab test: does the segment (x1, y1) + t * (dx, dy), t in [0, 1], touch the rectangle?
+inline bool segmentTouchesRect(float x1, float y1, float dx, float dy,
+                               float rectX, float rectY, float rectW, float rectH) {
+    float tMin = 0.0f;
+    float tMax = 1.0f;
+    
+    const float origin[2] = { x1, y1 };
+    const float dir[2] = { dx, dy };
+    const float lo[2] = { rectX, rectY };
+    const float hi[2] = { rectX + rectW, rectY + rectH };
+    
+    for (int axis = 0; axis < 2; ++axis) {
+        if (dir[axis] == 0.0f) {
+            // Parallel to this slab: must already be inside it
+            if (origin[axis] < lo[axis] || origin[axis] > hi[axis]) return false;
+            continue;
+        }
+        float t1 = (lo[axis] - origin[axis]) / dir[axis];
+        float t2 = (hi[axis] - origin[axis]) / dir[axis];
+        if (t1 > t2) std::swap(t1, t2);
+        tMin = std::max(tMin, t1);
+        tMax = std::min(tMax, t2);
+        if (tMin > tMax) return false;
+    }
+    return true;
+}
+
+// Exact wall test: does the segment (x1, y1) -> (x2, y2) touch any wall?
+//
+// ALGORITHM: Amanda-Woo grid traversal (same walk as the server's
+// Bullet::traceCellWallsDDA); every visited cell tests the four edges around
+// it and the walk stops at the first hit.
+//
+// PERFORMANCE: visits |dCellX| + |dCellY| + 1 cells and tests only walls that
+// exist, instead of checking nine cells every 3 pixels along the segment.
+bool segmentHitsWall(const CellGrid& grid, float x1, float y1, float x2, float y2) {
+    const float dx = x2 - x1;
+    const float dy = y2 - y1;
+    const float half = WALL_WIDTH / 2.0f;
+    
+    // Walls on the four edges around cell (i, j)
+    auto cellBoundariesHit = [&](int i, int j) {
+        const float cellWorldX = i * CELL_SIZE;
+        const float cellWorldY = j * CELL_SIZE;
+        if (grid.horizontal(i, j) != WallType::None &&
+            segmentTouchesRect(x1, y1, dx, dy, cellWorldX, cellWorldY - half, CELL_SIZE, WALL_WIDTH)) return true;
+        if (grid.vertical(i + 1, j) != WallType::None &&
+            segmentTouchesRect(x1, y1, dx, dy, cellWorldX + CELL_SIZE - half, cellWorldY, WALL_WIDTH, CELL_SIZE)) return true;
+        if (grid.horizontal(i, j + 1) != WallType::None &&
+            segmentTouchesRect(x1, y1, dx, dy, cellWorldX, cellWorldY + CELL_SIZE - half, CELL_SIZE, WALL_WIDTH)) return true;
+        if (grid.vertical(i, j) != WallType::None &&
+            segmentTouchesRect(x1, y1, dx, dy, cellWorldX - half, cellWorldY, WALL_WIDTH, CELL_SIZE)) return true;
+        return false;
+    };
+    
+    int cellX = static_cast<int>(std::floor(x1 / CELL_SIZE));
+    int cellY = static_cast<int>(std::floor(y1 / CELL_SIZE));
+    const int endCellX = static_cast<int>(std::floor(x2 / CELL_SIZE));
+    const int endCellY = static_cast<int>(std::floor(y2 / CELL_SIZE));
+    
+    const int stepX = (dx > 0.0f) ? 1 : (dx < 0.0f ? -1 : 0);
+    const int stepY = (dy > 0.0f) ? 1 : (dy < 0.0f ? -1 : 0);
+    const float inf = std::numeric_limits<float>::infinity();
+    
+    float tMaxX = inf, tDeltaX = inf;
+    if (stepX != 0) {
+        tMaxX = ((cellX + (stepX > 0 ? 1 : 0)) * CELL_SIZE - x1) / dx;
+        tDeltaX = CELL_SIZE / std::abs(dx);
+    }
+    float tMaxY = inf, tDeltaY = inf;
+    if (stepY != 0) {
+        tMaxY = ((cellY + (stepY > 0 ? 1 : 0)) * CELL_SIZE - y1) / dy;
+        tDeltaY = CELL_SIZE / std::abs(dy);
+    }
+    
+    // Exact number of boundary crossings; also bounds the loop against rounding
+    int remainingSteps = std::abs(endCellX - cellX) + std::abs(endCellY - cellY);
+    
+    while (true) {
+        if (cellBoundariesHit(cellX, cellY)) return true;
+        if (remainingSteps-- <= 0) return false;
+        
+        if (tMaxX < tMaxY) {
+            cellX += stepX;
+            tMaxX += tDeltaX;
+        } else {
+            cellY += stepY;
+            tMaxY += tDeltaY;
+        }
+    }
+}
+
 // Check if there's a clear line of sight between two points (no walls blocking)
 // Returns true if visible, false if blocked by walls
-// OPTIMIZED: Larger step size and only check current cell (not adjacent)
-bool hasLineOfSight(sf::Vector2f from, sf::Vector2f to, const std::vector<std::vector<Cell>>& grid) {
-    // Calculate direction and distance
+// Exact: used for players, bullets and shops (the fog uses FogVisibilityField)
+bool hasLineOfSight(sf::Vector2f from, sf::Vector2f to, const CellGrid& grid) {
     float dx = to.x - from.x;
     float dy = to.y - from.y;
-    float distance = std::sqrt(dx * dx + dy * dy);
+    if (dx * dx + dy * dy < 0.01f) return true; // Same position
+    
+    // Out of bounds = blocked
+    if (from.x < 0.0f || from.x >= MAP_SIZE || from.y < 0.0f || from.y >= MAP_SIZE ||
+        to.x < 0.0f || to.x >= MAP_SIZE || to.y < 0.0f || to.y >= MAP_SIZE) {
+        return false;
+    }
+    
+    return !segmentHitsWall(grid, from.x, from.y, to.x, to.y);
+}
+
+// ========================
+// PERFORMANCE: Potentially Visible Set
+// ========================
+
+// Line of sight between two points is mostly decided per pair of cells: a table
+// built once per map records, for every cell and every cell within PVS_RADIUS,
+// whether all of the target cell is visible, none of it is, or it depends on
+// where in the cells the two points are.
+const int PVS_RADIUS = 12;  // Cells in each direction; covers the view plus fog padding
+const int PVS_SPAN = 2 * PVS_RADIUS + 1;
+const int PVS_OFFSETS = PVS_SPAN * PVS_SPAN;
+const float PVS_SAMPLE_INSET = WALL_WIDTH / 2.0f + 2.0f;  // Keeps sample points clear of boundary walls
+
+// How much of cell B can be seen from cell A
+enum class CellVisibility : uint8_t {
+    Hidden,   // No point of B is visible from any point of A
+    Visible,  // Every point of B is visible from every point of A
+    Partial   // Depends on the points
+};
+
+// Cell-to-cell visibility for the current map (two bits per cell pair)
+//
+// ALGORITHM:
+// - Each cell is sampled at its four corners (inset past the boundary walls)
+//   and its center. A pair is Visible if all 25 rays between the samples are
+//   clear, Hidden if all are blocked, Partial otherwise.
+// - Walls are 100 px long, so a wall between two cells that are not Partial
+//   almost never slips between the sampled rays; for points inside the inset
+//   squares Visible pairs match the exact test, and Hidden pairs disagree with it
+//   for well under 0.1% of point pairs (narrow gaps between walls).
+// - Visibility is symmetric: each pair is traced once and stored for both cells.
+//
+// PERFORMANCE: queries are two bit reads. The table is 2 bits x 625 offsets per
+// cell (~400 KB for 51x51) and is built once when the map arrives.
+class VisibilityTable {
+public:
+    // Classify every cell pair within PVS_RADIUS of each other
+    void build(const CellGrid& grid) {
+        const size_t words = (static_cast<size_t>(GRID_SIZE) * GRID_SIZE * PVS_OFFSETS + 63) / 64;
+        visible_.assign(words, 0);
+        hidden_.assign(words, 0);
+        
+        for (int ax = 0; ax < GRID_SIZE; ++ax) {
+            for (int ay = 0; ay < GRID_SIZE; ++ay) {
+                // Second half of the offsets only; the mirrored pair gets the same result
+                for (int offset = PVS_OFFSETS / 2; offset < PVS_OFFSETS; ++offset) {
+                    const int bx = ax + offset % PVS_SPAN - PVS_RADIUS;
+                    const int by = ay + offset / PVS_SPAN - PVS_RADIUS;
+                    if (bx < 0 || bx >= GRID_SIZE || by < 0 || by >= GRID_SIZE) continue;
+                    
+                    CellVisibility result = classifyPair(grid, ax, ay, bx, by);
+                    store(ax, ay, offset, result);
+                    store(bx, by, PVS_OFFSETS - 1 - offset, result);
+                }
+            }
+        }
+        built_ = true;
+    }
+    
+    // Visibility of cell (bx, by) from cell (ax, ay); Partial if out of range or not built
+    CellVisibility query(int ax, int ay, int bx, int by) const {
+        const int ox = bx - ax + PVS_RADIUS;
+        const int oy = by - ay + PVS_RADIUS;
+        if (!built_ || ox < 0 || ox >= PVS_SPAN || oy < 0 || oy >= PVS_SPAN ||
+            ax < 0 || ax >= GRID_SIZE || ay < 0 || ay >= GRID_SIZE ||
+            bx < 0 || bx >= GRID_SIZE || by < 0 || by >= GRID_SIZE) {
+            return CellVisibility::Partial;
+        }
+        const size_t bit = index(ax, ay, oy * PVS_SPAN + ox);
+        if ((visible_[bit >> 6] >> (bit & 63)) & 1) return CellVisibility::Visible;
+        if ((hidden_[bit >> 6] >> (bit & 63)) & 1) return CellVisibility::Hidden;
+        return CellVisibility::Partial;
+    }
+    
+    bool isBuilt() const { return built_; }
+    
+private:
+    static size_t index(int x, int y, int offset) {
+        return (static_cast<size_t>(x) * GRID_SIZE + y) * PVS_OFFSETS + offset;
+    }
+    
+    void store(int x, int y, int offset, CellVisibility result) {
+        const size_t bit = index(x, y, offset);
+        if (result == CellVisibility::Visible) visible_[bit >> 6] |= uint64_t(1) << (bit & 63);
+        if (result == CellVisibility::Hidden) hidden_[bit >> 6] |= uint64_t(1) << (bit & 63);
+    }
+    
+    static CellVisibility classifyPair(const CellGrid& grid, int ax, int ay, int bx, int by) {
+        float axs[5], ays[5], bxs[5], bys[5];
+        samplePoints(ax, ay, axs, ays);
+        samplePoints(bx, by, bxs, bys);
+        
+        bool anyClear = false;
+        bool anyBlocked = false;
+        for (int a = 0; a < 5; ++a) {
+            for (int b = 0; b < 5; ++b) {
+                if (segmentHitsWall(grid, axs[a], ays[a], bxs[b], bys[b])) {
+                    anyBlocked = true;
+                } else {
+                    anyClear = true;
+                }
+                if (anyClear && anyBlocked) return CellVisibility::Partial;
+            }
+        }
+        return anyClear ? CellVisibility::Visible : CellVisibility::Hidden;
+    }
     
-    // Normalize direction
-    if (distance < 0.1f) return true; // Same position
-    dx /= distance;
-    dy /= distance;
+    // Center first: it is the ray most likely to disagree with the corners
+    static void samplePoints(int x, int y, float* xs, float* ys) {
+        const float lo = PVS_SAMPLE_INSET;
+        const float hi = CELL_SIZE - PVS_SAMPLE_INSET;
+        const float ox[5] = { CELL_SIZE / 2.0f, lo, hi, lo, hi };
+        const float oy[5] = { CELL_SIZE / 2.0f, lo, lo, hi, hi };
+        for (int k = 0; k < 5; ++k) {
+            xs[k] = x * CELL_SIZE + ox[k];
+            ys[k] = y * CELL_SIZE + oy[k];
+        }
+    }
     
-    // Use precise step size (3 pixels) for accurate wall detection
-    const float stepSize = 3.0f;
-    int steps = static_cast<int>(distance / stepSize);
+    std::vector<uint64_t> visible_;
+    std::vector<uint64_t> hidden_;
+    bool built_ = false;
+};
+
+// Cell visibility for the current map, rebuilt by receiveMapFromServer
+VisibilityTable g_visibilityTable;
+
+// ========================
+// PERFORMANCE: Fog Visibility Field
+// ========================
+
+// Shadow casting for the fog of war: for each of FOG_ANGLE_BINS directions
+// around the player, the distance to the nearest wall (an angular depth map).
+// A point is lit if it is closer than the wall in its direction.
+const int FOG_ANGLE_BINS = 4096;  // Power of two; ~2 px wide at 1200 px from the player
+
+// Pseudo-angle of (dx, dy) in [0, 4): increases with the real angle like
+// atan2 (counter-clockwise from +x), without trigonometry
+inline float diamondAngle(float dx, float dy) {
+    if (dy >= 0.0f) {
+        return (dx >= 0.0f) ? dy / (dx + dy) : 1.0f - dx / (-dx + dy);
+    }
+    return (dx < 0.0f) ? 2.0f - dy / (-dx - dy) : 3.0f + dx / (dx - dy);
+}
+
+// Visible region around one point, rebuilt whenever the player moves
+//
+// ALGORITHM:
+// - Walls are processed in rings of cells around the player, nearest first.
+//   Each wall rectangle covers a range of pseudo-angles (its corners); for the
+//   bins in that range the ray through the bin center is intersected with the
+//   rectangle and the bin keeps the nearest hit.
+// - Broad phase (VisibilityTable): a wall surrounded by cells Hidden from the
+//   player's cell is never reached by a ray, so it is not cast; once a whole
+//   ring is Hidden, nothing behind it is reached either and the cast stops.
+// - A bin already closer than the wall's nearest point is skipped without the
+//   ray test, so walls standing in an earlier wall's shadow cost almost nothing.
+// - Lookups compute one pseudo-angle and compare squared distances.
+//
+// PERFORMANCE: one pass over the walls near the player that the table cannot
+// rule out, after which each fog tile is an O(1) lookup; replaces a line of
+// sight ray per 50 px chunk.
+class FogVisibilityField {
+public:
+    FogVisibilityField() {
+        // Unit direction through the center of every bin
+        for (int bin = 0; bin < FOG_ANGLE_BINS; ++bin) {
+            float p = (bin + 0.5f) * 4.0f / FOG_ANGLE_BINS;
+            float x, y;
+            if (p < 1.0f) { x = 1.0f - p; y = p; }
+            else if (p < 2.0f) { x = 1.0f - p; y = 2.0f - p; }
+            else if (p < 3.0f) { x = p - 3.0f; y = 2.0f - p; }
+            else { x = p - 3.0f; y = p - 4.0f; }
+            float length = std::sqrt(x * x + y * y);
+            dirX_[bin] = x / length;
+            dirY_[bin] = y / length;
+        }
+        depth_.fill(std::numeric_limits<float>::infinity());
+    }
     
-    for (int i = 0; i <= steps; i++) {
-        float t = (i * stepSize);
-        if (t > distance) t = distance;
+    // Cast the shadows of every wall that can block a segment between the
+    // origin and a point of [minX, maxX] x [minY, maxY]
+    // Returns: number of wall rectangles cast
+    size_t compute(const CellGrid& grid, const VisibilityTable& table, sf::Vector2f origin,
+                   float minX, float minY, float maxX, float maxY) {
+        origin_ = origin;
+        depth_.fill(std::numeric_limits<float>::infinity());
         
-        float checkX = from.x + dx * t;
-        float checkY = from.y + dy * t;
+        // Segments between points of the region and the origin stay inside
+        // their bounding box, so walls outside it cannot block them
+        minX = std::min(minX, origin.x);
+        minY = std::min(minY, origin.y);
+        maxX = std::max(maxX, origin.x);
+        maxY = std::max(maxY, origin.y);
+        const int minCellX = std::max(0, static_cast<int>(std::floor(minX / CELL_SIZE)) - 1);
+        const int minCellY = std::max(0, static_cast<int>(std::floor(minY / CELL_SIZE)) - 1);
+        const int maxCellX = std::min(GRID_SIZE - 1, static_cast<int>(std::floor(maxX / CELL_SIZE)) + 1);
+        const int maxCellY = std::min(GRID_SIZE - 1, static_cast<int>(std::floor(maxY / CELL_SIZE)) + 1);
         
-        // Get cell coordinates
-        int cellX = static_cast<int>(checkX / CELL_SIZE);
-        int cellY = static_cast<int>(checkY / CELL_SIZE);
+        const int originCellX = static_cast<int>(std::floor(origin.x / CELL_SIZE));
+        const int originCellY = static_cast<int>(std::floor(origin.y / CELL_SIZE));
+        const int maxRing = std::max(std::max(originCellX - minCellX, maxCellX - originCellX),
+                                     std::max(originCellY - minCellY, maxCellY - originCellY));
         
-        // Check bounds
-        if (cellX < 0 || cellX >= GRID_SIZE || cellY < 0 || cellY >= GRID_SIZE) {
-            return false; // Out of bounds = blocked
+        // Broad phase: cells of the region (and a one-cell border) Hidden from the player's cell
+        const int spanY = maxCellY - minCellY + 3;
+        hidden_.assign(static_cast<size_t>(maxCellX - minCellX + 3) * spanY, 0);
+        for (int i = minCellX - 1; i <= maxCellX + 1; ++i) {
+            for (int j = minCellY - 1; j <= maxCellY + 1; ++j) {
+                hidden_[(i - minCellX + 1) * spanY + (j - minCellY + 1)] =
+                    (table.query(originCellX, originCellY, i, j) == CellVisibility::Hidden);
+            }
         }
-        
-        // Check walls in current cell AND adjacent cells to catch boundary walls
-        for (int offsetX = -1; offsetX <= 1; offsetX++) {
-            for (int offsetY = -1; offsetY <= 1; offsetY++) {
-                int checkCellX = cellX + offsetX;
-                int checkCellY = cellY + offsetY;
-                
-                // Skip if out of bounds
-                if (checkCellX < 0 || checkCellX >= GRID_SIZE || checkCellY < 0 || checkCellY >= GRID_SIZE) {
-                    continue;
-                }
-                
-                float cellWorldX = checkCellX * CELL_SIZE;
-                float cellWorldY = checkCellY * CELL_SIZE;
-                
-                // Check top wall
-                if (grid[checkCellX][checkCellY].topWall != WallType::None) {
-                    float wallY = cellWorldY;
-                    if (checkY >= wallY - WALL_WIDTH/2 && checkY <= wallY + WALL_WIDTH/2 &&
-                        checkX >= cellWorldX && checkX <= cellWorldX + CELL_SIZE) {
-                        return false;
-                    }
-                }
-                
-                // Check right wall
-                if (grid[checkCellX][checkCellY].rightWall != WallType::None) {
-                    float wallX = cellWorldX + CELL_SIZE;
-                    if (checkX >= wallX - WALL_WIDTH/2 && checkX <= wallX + WALL_WIDTH/2 &&
-                        checkY >= cellWorldY && checkY <= cellWorldY + CELL_SIZE) {
-                        return false;
-                    }
-                }
-                
-                // Check bottom wall
-                if (grid[checkCellX][checkCellY].bottomWall != WallType::None) {
-                    float wallY = cellWorldY + CELL_SIZE;
-                    if (checkY >= wallY - WALL_WIDTH/2 && checkY <= wallY + WALL_WIDTH/2 &&
-                        checkX >= cellWorldX && checkX <= cellWorldX + CELL_SIZE) {
-                        return false;
-                    }
+        // The table speaks for the inset part of each cell, so light can still graze
+        // a wall's end: a wall is skipped only if the cells along it and past both
+        // of its ends are Hidden too
+        auto blockHidden = [&](int i0, int j0, int i1, int j1) {
+            for (int i = i0; i <= i1; ++i) {
+                for (int j = j0; j <= j1; ++j) {
+                    if (!hidden_[(i - minCellX + 1) * spanY + (j - minCellY + 1)]) return false;
                 }
-                
-                // Check left wall
-                if (grid[checkCellX][checkCellY].leftWall != WallType::None) {
-                    float wallX = cellWorldX;
-                    if (checkX >= wallX - WALL_WIDTH/2 && checkX <= wallX + WALL_WIDTH/2 &&
-                        checkY >= cellWorldY && checkY <= cellWorldY + CELL_SIZE) {
-                        return false;
+            }
+            return true;
+        };
+        
+        // Rings of cells at Chebyshev distance 0, 1, 2, ... from the player's cell
+        walls_ = 0;
+        for (int ring = 0; ring <= maxRing; ++ring) {
+            bool ringHidden = (ring > 0);
+            for (int i = originCellX - ring; i <= originCellX + ring; ++i) {
+                if (i < minCellX || i > maxCellX) continue;
+                const bool edgeColumn = (i == originCellX - ring || i == originCellX + ring);
+                const int stepJ = edgeColumn ? 1 : 2 * ring;
+                for (int j = originCellY - ring; j <= originCellY + ring; j += std::max(1, stepJ)) {
+                    if (j < minCellY || j > maxCellY) continue;
+                    if (!hidden_[(i - minCellX + 1) * spanY + (j - minCellY + 1)]) {
+                        ringHidden = false;
+                        castCellWalls(grid, i, j, i == maxCellX, j == maxCellY, false, false, false, false);
+                    } else {
+                        castCellWalls(grid, i, j, i == maxCellX, j == maxCellY,
+                                      blockHidden(i - 1, j - 1, i + 1, j), blockHidden(i, j - 1, i + 1, j + 1),
+                                      blockHidden(i - 1, j, i + 1, j + 1), blockHidden(i - 1, j - 1, i, j + 1));
                     }
                 }
             }
+            // Every ray leaving the player's cell crosses this ring: nothing behind it is reached
+            if (ringHidden) break;
         }
+        return walls_;
     }
     
-    return true; // No walls blocking
-}
+    // Whether (x, y) is visible from the origin of the last compute()
+    bool isVisible(float x, float y) const {
+        const float dx = x - origin_.x;
+        const float dy = y - origin_.y;
+        if (dx == 0.0f && dy == 0.0f) return true;
+        int bin = static_cast<int>(diamondAngle(dx, dy) * (FOG_ANGLE_BINS / 4.0f));
+        bin = std::min(bin, FOG_ANGLE_BINS - 1);
+        const float depth = depth_[bin];
+        return dx * dx + dy * dy <= depth * depth;
+    }
+    
+private:
+    // Each cell casts its top and left edges, so a shared edge is cast once;
+    // the last row and column of the region also cast their bottom/right edges.
+    // Sides the broad phase ruled out (the skip flags) are left out.
+    void castCellWalls(const CellGrid& grid, int i, int j, bool lastColumn, bool lastRow,
+                       bool skipTop, bool skipRight, bool skipBottom, bool skipLeft) {
+        const float cellWorldX = i * CELL_SIZE;
+        const float cellWorldY = j * CELL_SIZE;
+        const float half = WALL_WIDTH / 2.0f;
+        if (!skipTop && grid.horizontal(i, j) != WallType::None) castWall(cellWorldX, cellWorldY - half, CELL_SIZE, WALL_WIDTH);
+        if (lastColumn && !skipRight && grid.vertical(i + 1, j) != WallType::None) castWall(cellWorldX + CELL_SIZE - half, cellWorldY, WALL_WIDTH, CELL_SIZE);
+        if (lastRow && !skipBottom && grid.horizontal(i, j + 1) != WallType::None) castWall(cellWorldX, cellWorldY + CELL_SIZE - half, CELL_SIZE, WALL_WIDTH);
+        if (!skipLeft && grid.vertical(i, j) != WallType::None) castWall(cellWorldX - half, cellWorldY, WALL_WIDTH, CELL_SIZE);
+    }
+    
+    void castWall(float rectX, float rectY, float rectW, float rectH) {
+        walls_++;
+        const float x0 = rectX - origin_.x;
+        const float y0 = rectY - origin_.y;
+        const float x1 = x0 + rectW;
+        const float y1 = y0 + rectH;
+        
+        // Standing inside a wall's rectangle (touching it): it hides nothing useful
+        if (x0 <= 0.0f && x1 >= 0.0f && y0 <= 0.0f && y1 >= 0.0f) return;
+        
+        // Distance to the nearest point of the rectangle
+        const float nx = std::max(std::max(x0, -x1), 0.0f);
+        const float ny = std::max(std::max(y0, -y1), 0.0f);
+        const float nearest = std::sqrt(nx * nx + ny * ny);
+        
+        // Pseudo-angle range of the corners; a range wider than half a turn
+        // wraps through angle 0 (the +x axis)
+        const float angles[4] = { diamondAngle(x0, y0), diamondAngle(x1, y0),
+                                  diamondAngle(x0, y1), diamondAngle(x1, y1) };
+        float lo = std::min(std::min(angles[0], angles[1]), std::min(angles[2], angles[3]));
+        float hi = std::max(std::max(angles[0], angles[1]), std::max(angles[2], angles[3]));
+        if (hi - lo > 2.0f) {
+            lo = 4.0f;
+            hi = 0.0f;
+            for (float angle : angles) {
+                if (angle < 2.0f) angle += 4.0f;
+                lo = std::min(lo, angle);
+                hi = std::max(hi, angle);
+            }
+        }
+        
+        const int first = static_cast<int>(lo * (FOG_ANGLE_BINS / 4.0f));
+        const int last = static_cast<int>(hi * (FOG_ANGLE_BINS / 4.0f));
+        for (int k = first; k <= last; ++k) {
+            const int bin = k & (FOG_ANGLE_BINS - 1);
+            if (depth_[bin] <= nearest) continue;  // Already in a nearer wall's shadow
+            
+            // Slab test for the ray origin + t * dir, t >= 0
+            const float dx = dirX_[bin];
+            const float dy = dirY_[bin];
+            float tMin = 0.0f;
+            float tMax = std::numeric_limits<float>::infinity();
+            if (dx != 0.0f) {
+                float t1 = x0 / dx, t2 = x1 / dx;
+                if (t1 > t2) std::swap(t1, t2);
+                tMin = std::max(tMin, t1);
+                tMax = std::min(tMax, t2);
+            } else if (x0 > 0.0f || x1 < 0.0f) {
+                continue;
+            }
+            if (dy != 0.0f) {
+                float t1 = y0 / dy, t2 = y1 / dy;
+                if (t1 > t2) std::swap(t1, t2);
+                tMin = std::max(tMin, t1);
+                tMax = std::min(tMax, t2);
+            } else if (y0 > 0.0f || y1 < 0.0f) {
+                continue;
+            }
+            if (tMin <= tMax && tMin < depth_[bin]) {
+                depth_[bin] = tMin;
+            }
+        }
+    }
+    
+    std::array<float, FOG_ANGLE_BINS> depth_;
+    std::array<float, FOG_ANGLE_BINS> dirX_;
+    std::array<float, FOG_ANGLE_BINS> dirY_;
+    sf::Vector2f origin_;
+    std::vector<uint8_t> hidden_;  // Broad phase scratch, reused between computes
+    size_t walls_ = 0;
+};
+
+// Visible region around the local player, rebuilt by renderFoggedBackground
+FogVisibilityField g_fogField;
 
 // ========================
 // NEW: Optimized Fog of War Background Rendering
 // ========================
 
+// Bring the fog quads up to date for the player's position
+// Parameters:
+//   cache - Quads and their current visibility
+//   field - Scratch visibility field (recomputed here when the player moved)
+//   table - Cell visibility (broad phase for the field)
+//   grid - The cell grid
+//   playerPosition - Where the fog is seen from
+//   minX, minY, maxX, maxY - Visible world bounds with padding
+// Returns: number of quads whose color was written
+//
+// ALGORITHM:
+// 1. Lay out world-aligned FOG_TILE_SIZE quads over the bounds plus
+//    FOG_LAYOUT_SLACK; done again only when the bounds leave that region
+// 2. When the player moved, shadow-cast the walls the visibility table cannot
+//    rule out (FogVisibilityField) and look up every quad's center in the field
+// 3. Rewrite the colors of quads whose visibility changed
+//
+// PERFORMANCE: no per-chunk line of sight rays and no vertex rebuild while
+// moving; only the quads along moving shadow edges are written.
+size_t updateFogVertices(BackgroundVertexCache& cache, FogVisibilityField& field,
+                         const VisibilityTable& table, const CellGrid& grid, sf::Vector2f playerPosition,
+                         float minX, float minY, float maxX, float maxY) {
+    // Base background color (136, 101, 56)
+    const sf::Color baseColor(136, 101, 56);
+    const sf::Color darkColor(baseColor.r, baseColor.g, baseColor.b, 0);  // Completely dark behind walls
+    
+    // Step 1: Re-lay the quads when the padded view leaves the laid-out region
+    bool relaid = false;
+    if (cache.needsUpdate || minX < cache.layoutMinX || maxX > cache.layoutMaxX ||
+        minY < cache.layoutMinY || maxY > cache.layoutMaxY) {
+        cache.layoutMinX = std::floor(std::max(0.0f, minX - FOG_LAYOUT_SLACK) / FOG_TILE_SIZE) * FOG_TILE_SIZE;
+        cache.layoutMinY = std::floor(std::max(0.0f, minY - FOG_LAYOUT_SLACK) / FOG_TILE_SIZE) * FOG_TILE_SIZE;
+        cache.layoutMaxX = std::min(MAP_SIZE, maxX + FOG_LAYOUT_SLACK);
+        cache.layoutMaxY = std::min(MAP_SIZE, maxY + FOG_LAYOUT_SLACK);
+        cache.tilesX = static_cast<int>(std::ceil((cache.layoutMaxX - cache.layoutMinX) / FOG_TILE_SIZE));
+        cache.tilesY = static_cast<int>(std::ceil((cache.layoutMaxY - cache.layoutMinY) / FOG_TILE_SIZE));
+        cache.layoutMaxX = cache.layoutMinX + cache.tilesX * FOG_TILE_SIZE;
+        cache.layoutMaxY = cache.layoutMinY + cache.tilesY * FOG_TILE_SIZE;
+        
+        cache.vertices.setPrimitiveType(sf::Quads);
+        cache.vertices.resize(static_cast<size_t>(cache.tilesX) * cache.tilesY * 4);
+        cache.tileLit.assign(static_cast<size_t>(cache.tilesX) * cache.tilesY, 2);
+        
+        size_t vertexIndex = 0;
+        for (int tx = 0; tx < cache.tilesX; ++tx) {
+            const float x = cache.layoutMinX + tx * FOG_TILE_SIZE;
+            for (int ty = 0; ty < cache.tilesY; ++ty) {
+                const float y = cache.layoutMinY + ty * FOG_TILE_SIZE;
+                cache.vertices[vertexIndex].position = sf::Vector2f(x, y);
+                cache.vertices[vertexIndex + 1].position = sf::Vector2f(x + FOG_TILE_SIZE, y);
+                cache.vertices[vertexIndex + 2].position = sf::Vector2f(x + FOG_TILE_SIZE, y + FOG_TILE_SIZE);
+                cache.vertices[vertexIndex + 3].position = sf::Vector2f(x, y + FOG_TILE_SIZE);
+                vertexIndex += 4;
+            }
+        }
+        
+        cache.needsUpdate = false;
+        relaid = true;
+    }
+    
+    // Step 2: Shadow-cast from the new position and look up every quad
+    size_t written = 0;
+    if (relaid || playerPosition.x != cache.lastPlayerPos.x || playerPosition.y != cache.lastPlayerPos.y) {
+        field.compute(grid, table, playerPosition, cache.layoutMinX, cache.layoutMinY,
+                      cache.layoutMaxX, cache.layoutMaxY);
+        cache.lastPlayerPos = playerPosition;
+        
+        // Step 3: Rewrite only the quads whose visibility changed
+        size_t tileIndex = 0;
+        for (int tx = 0; tx < cache.tilesX; ++tx) {
+            const float centerX = cache.layoutMinX + (tx + 0.5f) * FOG_TILE_SIZE;
+            for (int ty = 0; ty < cache.tilesY; ++ty, ++tileIndex) {
+                const float centerY = cache.layoutMinY + (ty + 0.5f) * FOG_TILE_SIZE;
+                const uint8_t lit = field.isVisible(centerX, centerY) ? 1 : 0;
+                if (lit == cache.tileLit[tileIndex]) continue;
+                
+                cache.tileLit[tileIndex] = lit;
+                const sf::Color color = lit ? baseColor : darkColor;
+                const size_t vertexIndex = tileIndex * 4;
+                cache.vertices[vertexIndex].color = color;
+                cache.vertices[vertexIndex + 1].color = color;
+                cache.vertices[vertexIndex + 2].color = color;
+                cache.vertices[vertexIndex + 3].color = color;
+                written++;
+            }
+        }
+    }
+    
+    return written;
+}
+
 // Render background with smooth fog of war gradient effect (optimized with VertexArray)
 // The background gets darker the further it is from the player
 // NOW WITH LINE OF SIGHT: Areas behind walls are completely dark
-// MEGA OPTIMIZED: Cache both visibility AND vertices, update only when needed
-void renderFoggedBackground(sf::RenderWindow& window, sf::Vector2f playerPosition, const std::vector<std::vector<Cell>>& grid) {
+// MEGA OPTIMIZED: quads are laid out once and recolored incrementally (updateFogVertices)
+void renderFoggedBackground(sf::RenderWindow& window, sf::Vector2f playerPosition, const CellGrid& grid) {
     // Get current view to determine visible area
     sf::View currentView = window.getView();
     sf::Vector2f viewCenter = currentView.getCenter();
@@ -1376,118 +3233,7 @@ void renderFoggedBackground(sf::RenderWindow& window, sf::Vector2f playerPositio
     float minY = std::max(0.0f, viewCenter.y - viewSize.y / 2.0f - padding);
     float maxY = std::min(MAP_SIZE, viewCenter.y + viewSize.y / 2.0f + padding);
     
-    // Base background color (136, 101, 56)
-    const sf::Color baseColor(136, 101, 56);
-    
-    // Check if we need to update visibility cache (player moved 100+ pixels OR view changed)
-    float dx = playerPosition.x - g_visibilityCache.lastPlayerPos.x;
-    float dy = playerPosition.y - g_visibilityCache.lastPlayerPos.y;
-    float distanceMoved = std::sqrt(dx * dx + dy * dy);
-    
-    bool viewChanged = (minX != g_bgVertexCache.lastMinX || maxX != g_bgVertexCache.lastMaxX ||
-                        minY != g_bgVertexCache.lastMinY || maxY != g_bgVertexCache.lastMaxY);
-    
-    if (distanceMoved > 50.0f || g_visibilityCache.needsUpdate || viewChanged || g_bgVertexCache.needsUpdate) {
-        // Update visibility cache with 50x50 chunks for better performance
-        const float cacheChunkSize = 50.0f;
-        int cacheChunksX = static_cast<int>((maxX - minX) / cacheChunkSize) + 2;
-        int cacheChunksY = static_cast<int>((maxY - minY) / cacheChunkSize) + 2;
-        
-        // Resize cache if needed
-        g_visibilityCache.cache.resize(cacheChunksX);
-        for (auto& row : g_visibilityCache.cache) {
-            row.resize(cacheChunksY, true);
-        }
-        
-        g_visibilityCache.cacheChunksX = cacheChunksX;
-        g_visibilityCache.cacheChunksY = cacheChunksY;
-        g_visibilityCache.minX = minX;
-        g_visibilityCache.minY = minY;
-        g_visibilityCache.lastPlayerPos = playerPosition;
-        g_visibilityCache.needsUpdate = false;
-        
-        // Fill visibility cache
-        for (int cx = 0; cx < cacheChunksX; cx++) {
-            for (int cy = 0; cy < cacheChunksY; cy++) {
-                float cacheX = minX + cx * cacheChunkSize + cacheChunkSize / 2.0f;
-                float cacheY = minY + cy * cacheChunkSize + cacheChunkSize / 2.0f;
-                
-                // Check line of sight (no distance check for simplicity)
-                g_visibilityCache.cache[cx][cy] = hasLineOfSight(playerPosition, sf::Vector2f(cacheX, cacheY), grid);
-            }
-        }
-        
-        // REBUILD VERTEX CACHE (only when visibility changes)
-        const float chunkSize = 15.0f;
-        const float halfChunk = chunkSize * 0.5f;
-        
-        int chunksX = static_cast<int>((maxX - minX) / chunkSize) + 1;
-        int chunksY = static_cast<int>((maxY - minY) / chunkSize) + 1;
-        
-        // Resize vertex array
-        g_bgVertexCache.vertices.resize(chunksX * chunksY * 4);
-        g_bgVertexCache.vertices.setPrimitiveType(sf::Quads);
-        
-        // Pre-calculate constants
-        const float invCacheChunkSize = 1.0f / g_visibilityCache.cacheChunkSize;
-        const float cacheMinX = g_visibilityCache.minX;
-        const float cacheMinY = g_visibilityCache.minY;
-        const int maxCacheX = g_visibilityCache.cacheChunksX - 1;
-        const int maxCacheY = g_visibilityCache.cacheChunksY - 1;
-        
-        int vertexIndex = 0;
-        
-        // Build vertices
-        for (float x = minX; x < maxX; x += chunkSize) {
-            float xPlusChunk = x + chunkSize;
-            
-            for (float y = minY; y < maxY; y += chunkSize) {
-                float yPlusChunk = y + chunkSize;
-                
-                // NO FOG OF WAR - Simple visibility: 100% visible or 0% (black behind walls)
-                sf::Uint8 alpha = 255; // Default: fully visible
-                
-                // Look up visibility from cache
-                int cacheX = static_cast<int>((x - cacheMinX) * invCacheChunkSize);
-                int cacheY = static_cast<int>((y - cacheMinY) * invCacheChunkSize);
-                
-                // Clamp to cache bounds
-                cacheX = (cacheX < 0) ? 0 : ((cacheX > maxCacheX) ? maxCacheX : cacheX);
-                cacheY = (cacheY < 0) ? 0 : ((cacheY > maxCacheY) ? maxCacheY : cacheY);
-                
-                // Check visibility
-                if (!g_visibilityCache.cache[cacheX][cacheY]) {
-                    alpha = 0; // Completely dark behind walls
-                }
-                
-                // Apply visibility to background color
-                sf::Color foggedColor(baseColor.r, baseColor.g, baseColor.b, alpha);
-                
-                // Create quad vertices
-                g_bgVertexCache.vertices[vertexIndex].position = sf::Vector2f(x, y);
-                g_bgVertexCache.vertices[vertexIndex].color = foggedColor;
-                
-                g_bgVertexCache.vertices[vertexIndex + 1].position = sf::Vector2f(xPlusChunk, y);
-                g_bgVertexCache.vertices[vertexIndex + 1].color = foggedColor;
-                
-                g_bgVertexCache.vertices[vertexIndex + 2].position = sf::Vector2f(xPlusChunk, yPlusChunk);
-                g_bgVertexCache.vertices[vertexIndex + 2].color = foggedColor;
-                
-                g_bgVertexCache.vertices[vertexIndex + 3].position = sf::Vector2f(x, yPlusChunk);
-                g_bgVertexCache.vertices[vertexIndex + 3].color = foggedColor;
-                
-                vertexIndex += 4;
-            }
-        }
-        
-        // Update cache state
-        g_bgVertexCache.lastPlayerPos = playerPosition;
-        g_bgVertexCache.lastMinX = minX;
-        g_bgVertexCache.lastMaxX = maxX;
-        g_bgVertexCache.lastMinY = minY;
-        g_bgVertexCache.lastMaxY = maxY;
-        g_bgVertexCache.needsUpdate = false;
-    }
+    updateFogVertices(g_bgVertexCache, g_fogField, g_visibilityTable, grid, playerPosition, minX, minY, maxX, maxY);
     
     // FAST PATH: Just draw cached vertices (runs every frame)
     window.draw(g_bgVertexCache.vertices);
@@ -1608,13 +3354,233 @@ void updateCamera(sf::RenderWindow& window, sf::Vector2f playerPosition) {
     center.x = std::max(halfWidth, std::min(center.x, MAP_SIZE - halfWidth));
     center.y = std::max(halfHeight, std::min(center.y, MAP_SIZE - halfHeight));
     
-    // Set the clamped center
-    view.setCenter(center);
+    // Set the clamped center
+    view.setCenter(center);
+    
+    // Apply the view to the window
+    // All subsequent draw calls will use this view's coordinate system
+    window.setView(view);
+}
+
+// ========================
+// PERFORMANCE: Batched Wall Rendering
+// ========================
+
+// ALGORITHM:
+// Walls never move once the map exists, so they are baked a single time into
+// static vertex buffers, one per WALL_CHUNK_CELLS x WALL_CHUNK_CELLS block of
+// cells. Each wall becomes the same rounded rectangle createRoundedRectangle
+// builds, triangulated as a fan. A frame then draws one buffer per chunk that
+// overlaps the view instead of one ConvexShape per wall.
+//
+// FOG TINT:
+// Every vertex carries the centre of its wall in texCoords. The vertex shader
+// measures the distance from that centre to the player and picks the same
+// band as calculateFogAlpha, so a wall keeps a single tint exactly as before.
+// Without shader or vertex buffer support the chunks stay plain vertex arrays
+// and the alpha is rewritten on the CPU, only for walls whose band changed.
+//
+// PERFORMANCE:
+// A 1920x1080 view overlaps about a dozen chunks, so several hundred draw
+// calls per frame become at most a dozen; chunks beyond FOG_RANGE_4 are
+// skipped outright.
+const int WALL_CHUNK_CELLS = 8;
+const int WALL_CHUNKS_PER_SIDE = (GRID_SIZE + WALL_CHUNK_CELLS - 1) / WALL_CHUNK_CELLS;
+const float WALL_CORNER_RADIUS = 3.0f;
+const unsigned int WALL_CORNER_POINTS = 8;
+const size_t WALL_VERTEX_COUNT = (WALL_CORNER_POINTS * 4 - 2) * 3;
+
+const char* const WALL_FOG_VERTEX_SHADER =
+    "uniform vec2 player;\n"
+    "uniform vec4 fogRanges;\n"
+    "void main() {\n"
+    "    gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;\n"
+    "    float d = distance(gl_MultiTexCoord0.xy, player);\n"
+    "    float a = d <= fogRanges.x ? 1.0 : d <= fogRanges.y ? 0.6 : d <= fogRanges.z ? 0.4 : d <= fogRanges.w ? 0.2 : 0.0;\n"
+    "    gl_FrontColor = vec4(gl_Color.rgb, a);\n"
+    "}\n";
+
+const char* const WALL_FOG_FRAGMENT_SHADER =
+    "void main() {\n"
+    "    gl_FragColor = gl_Color;\n"
+    "}\n";
+
+class WallRenderer {
+public:
+    // Drop the baked chunks; they are rebuilt from the grid on the next draw
+    void invalidate() { built_ = false; }
+    
+    // Draw every chunk that overlaps [minX, maxX] x [minY, maxY] and has walls
+    // within fog range of the player. Must run on the thread that owns the GL
+    // context. Returns the number of draw calls issued.
+    int draw(sf::RenderTarget& target, sf::Vector2f playerPosition,
+             const CellGrid& grid,
+             float minX, float minY, float maxX, float maxY) {
+        if (!built_) {
+            build(grid);
+        }
+        
+        if (useShader_) {
+            fogShader_->setUniform("player", sf::Glsl::Vec2(playerPosition));
+        }
+        
+        int drawCalls = 0;
+        for (Chunk& chunk : chunks_) {
+            if (chunk.wallCount == 0) continue;
+            
+            // View culling: wall geometry reaches WALL_WIDTH / 2 past the cells
+            const float reach = WALL_WIDTH / 2.0f;
+            if (chunk.maxX + reach < minX || chunk.minX - reach > maxX ||
+                chunk.maxY + reach < minY || chunk.minY - reach > maxY) {
+                continue;
+            }
+            
+            // Fog culling: every wall centre lies inside the chunk's cells
+            float dx = std::max({chunk.minX - playerPosition.x, 0.0f, playerPosition.x - chunk.maxX});
+            float dy = std::max({chunk.minY - playerPosition.y, 0.0f, playerPosition.y - chunk.maxY});
+            if (dx * dx + dy * dy > FOG_RANGE_4 * FOG_RANGE_4) continue;
+            
+            if (useShader_) {
+                target.draw(chunk.buffer, fogShader_.get());
+            } else {
+                applyCpuFog(chunk, playerPosition);
+                target.draw(chunk.vertices.data(), chunk.vertices.size(), sf::Triangles);
+            }
+            drawCalls++;
+        }
+        return drawCalls;
+    }
+    
+private:
+    struct Chunk {
+        float minX = 0.0f, minY = 0.0f, maxX = 0.0f, maxY = 0.0f;  // World bounds of the chunk's cells
+        size_t wallCount = 0;
+        std::vector<sf::Vertex> vertices;    // Kept only for the CPU fallback
+        std::vector<sf::Uint8> wallAlpha;    // CPU fallback: alpha each wall was last tinted with
+        sf::VertexBuffer buffer{sf::Triangles, sf::VertexBuffer::Static};
+    };
+    
+    void build(const CellGrid& grid) {
+        built_ = true;
+        
+        if (!shaderLoaded_ && sf::Shader::isAvailable() && sf::VertexBuffer::isAvailable()) {
+            shaderLoaded_ = true;
+            fogShader_ = std::make_unique<sf::Shader>();
+            shaderUsable_ = fogShader_->loadFromMemory(WALL_FOG_VERTEX_SHADER, WALL_FOG_FRAGMENT_SHADER);
+            if (shaderUsable_) {
+                fogShader_->setUniform("fogRanges", sf::Glsl::Vec4(FOG_RANGE_1, FOG_RANGE_2, FOG_RANGE_3, FOG_RANGE_4));
+            }
+        }
+        useShader_ = shaderUsable_;
+        
+        sf::ConvexShape horizontalWall = createRoundedRectangle(sf::Vector2f(WALL_LENGTH, WALL_WIDTH), WALL_CORNER_RADIUS, WALL_CORNER_POINTS);
+        sf::ConvexShape verticalWall = createRoundedRectangle(sf::Vector2f(WALL_WIDTH, WALL_LENGTH), WALL_CORNER_RADIUS, WALL_CORNER_POINTS);
+        
+        chunks_.assign(WALL_CHUNKS_PER_SIDE * WALL_CHUNKS_PER_SIDE, Chunk());
+        size_t totalWalls = 0;
+        
+        for (int cx = 0; cx < WALL_CHUNKS_PER_SIDE; cx++) {
+            for (int cy = 0; cy < WALL_CHUNKS_PER_SIDE; cy++) {
+                Chunk& chunk = chunks_[cx * WALL_CHUNKS_PER_SIDE + cy];
+                int startX = cx * WALL_CHUNK_CELLS;
+                int startY = cy * WALL_CHUNK_CELLS;
+                int endX = std::min(GRID_SIZE, startX + WALL_CHUNK_CELLS);
+                int endY = std::min(GRID_SIZE, startY + WALL_CHUNK_CELLS);
+                chunk.minX = startX * CELL_SIZE;
+                chunk.minY = startY * CELL_SIZE;
+                chunk.maxX = endX * CELL_SIZE;
+                chunk.maxY = endY * CELL_SIZE;
+                
+                // Same placement as the per-wall renderer. Each edge is baked once,
+                // by the chunk owning the cell below / right of it; the chunks on
+                // the far sides of the map also take the edges along the map border
+                const int edgeEndX = (endX == GRID_SIZE) ? GRID_SIZE + 1 : endX;
+                const int edgeEndY = (endY == GRID_SIZE) ? GRID_SIZE + 1 : endY;
+                for (int i = startX; i < endX; i++) {
+                    for (int j = startY; j < edgeEndY; j++) {
+                        float x = i * CELL_SIZE;
+                        float y = j * CELL_SIZE;
+                        bakeWall(chunk, horizontalWall, grid.horizontal(i, j),
+                                 sf::Vector2f(x, y - WALL_WIDTH / 2.0f), sf::Vector2f(x + WALL_LENGTH / 2.0f, y));
+                    }
+                }
+                for (int i = startX; i < edgeEndX; i++) {
+                    for (int j = startY; j < endY; j++) {
+                        float x = i * CELL_SIZE;
+                        float y = j * CELL_SIZE;
+                        bakeWall(chunk, verticalWall, grid.vertical(i, j),
+                                 sf::Vector2f(x - WALL_WIDTH / 2.0f, y), sf::Vector2f(x, y + WALL_LENGTH / 2.0f));
+                    }
+                }
+                totalWalls += chunk.wallCount;
+                
+                if (useShader_ && chunk.wallCount > 0) {
+                    if (chunk.buffer.create(chunk.vertices.size()) && chunk.buffer.update(chunk.vertices.data())) {
+                        std::vector<sf::Vertex>().swap(chunk.vertices);
+                    } else {
+                        useShader_ = false;
+                    }
+                }
+            }
+        }
+        
+        // A failed upload leaves some chunks without a CPU copy: rebake them all
+        if (shaderUsable_ && !useShader_) {
+            shaderUsable_ = false;
+            build(grid);
+            return;
+        }
+        
+        for (Chunk& chunk : chunks_) {
+            chunk.wallAlpha.assign(chunk.wallCount, 255);
+        }
+        
+        std::cout << "[INFO] Walls baked: " << totalWalls << " walls in " << chunks_.size()
+                  << " chunks (" << (useShader_ ? "shader fog tint" : "CPU fog tint") << ")" << std::endl;
+    }
+    
+    // Append one wall as a triangle fan over the rounded rectangle's outline
+    static void bakeWall(Chunk& chunk, const sf::ConvexShape& shape, WallType type,
+                         sf::Vector2f position, sf::Vector2f center) {
+        if (type == WallType::None) return;
+        
+        sf::Color color = (type == WallType::Concrete) ? sf::Color(150, 150, 150) : sf::Color(139, 90, 43);
+        size_t pointCount = shape.getPointCount();
+        sf::Vector2f first = position + shape.getPoint(0);
+        for (size_t k = 1; k + 1 < pointCount; k++) {
+            chunk.vertices.push_back(sf::Vertex(first, color, center));
+            chunk.vertices.push_back(sf::Vertex(position + shape.getPoint(k), color, center));
+            chunk.vertices.push_back(sf::Vertex(position + shape.getPoint(k + 1), color, center));
+        }
+        chunk.wallCount++;
+    }
+    
+    // CPU fallback: retint only the walls whose fog band changed
+    static void applyCpuFog(Chunk& chunk, sf::Vector2f playerPosition) {
+        for (size_t w = 0; w < chunk.wallCount; w++) {
+            sf::Vertex* wall = &chunk.vertices[w * WALL_VERTEX_COUNT];
+            float dx = wall->texCoords.x - playerPosition.x;
+            float dy = wall->texCoords.y - playerPosition.y;
+            sf::Uint8 alpha = calculateFogAlpha(std::sqrt(dx * dx + dy * dy));
+            if (alpha == chunk.wallAlpha[w]) continue;
+            
+            chunk.wallAlpha[w] = alpha;
+            for (size_t v = 0; v < WALL_VERTEX_COUNT; v++) {
+                wall[v].color.a = alpha;
+            }
+        }
+    }
     
-    // Apply the view to the window
-    // All subsequent draw calls will use this view's coordinate system
-    window.setView(view);
-}
+    std::vector<Chunk> chunks_;
+    std::unique_ptr<sf::Shader> fogShader_;  // Created lazily: needs a GL context
+    bool shaderLoaded_ = false;
+    bool shaderUsable_ = false;
+    bool useShader_ = false;
+    bool built_ = false;
+};
+
+// Global batched wall renderer (render thread only)
+WallRenderer g_wallRenderer;
 
 // ========================
 // NEW: Optimized Visible Wall Rendering
@@ -1622,153 +3588,35 @@ void updateCamera(sf::RenderWindow& window, sf::Vector2f playerPosition) {
 
 // Render only visible walls within the camera view
 // This function implements:
-// 1. Camera-based visibility culling (render walls visible in current view)
-// 2. Caching of visible bounds (recalculate only when camera moves significantly)
-// 3. Debug output for rendered wall count
-//
-// PERFORMANCE OPTIMIZATION:
-// - Static variables cache the last camera center and visible bounds
-// - Bounds are recalculated only when camera moves significantly
-// - This reduces computation from every frame to only when needed
+// 1. Camera-based visibility culling (draw only chunks overlapping the view)
+// 2. Batched drawing through g_wallRenderer (one draw call per chunk)
+// 3. Debug output for the number of draw calls
 //
 // WALL POSITIONING:
 // - Walls are centered on cell boundaries
-// - topWall: centered on top edge (y - WALL_WIDTH/2)
-// - rightWall: centered on right edge (x + CELL_SIZE - WALL_WIDTH/2)
-// - bottomWall: centered on bottom edge (y + CELL_SIZE - WALL_WIDTH/2)
-// - leftWall: centered on left edge (x - WALL_WIDTH/2)
+// - Horizontal edge (i, j): centered on y = j * CELL_SIZE (y - WALL_WIDTH/2)
+// - Vertical edge (i, j): centered on x = i * CELL_SIZE (x - WALL_WIDTH/2)
 void renderVisibleWalls(sf::RenderWindow& window, sf::Vector2f playerPosition, 
-                       const std::vector<std::vector<Cell>>& grid) {
+                       const CellGrid& grid) {
     // Get current view to determine visible area
     sf::View currentView = window.getView();
     sf::Vector2f viewCenter = currentView.getCenter();
     sf::Vector2f viewSize = currentView.getSize();
     
-    // Calculate visible world bounds with some padding
+    // Calculate visible world bounds with padding
     float padding = CELL_SIZE * 2.0f; // 2 cells padding to avoid pop-in
     float minX = viewCenter.x - viewSize.x / 2.0f - padding;
     float maxX = viewCenter.x + viewSize.x / 2.0f + padding;
     float minY = viewCenter.y - viewSize.y / 2.0f - padding;
     float maxY = viewCenter.y + viewSize.y / 2.0f + padding;
     
-    // Convert to cell coordinates
-    int startX = std::max(0, static_cast<int>(minX / CELL_SIZE));
-    int startY = std::max(0, static_cast<int>(minY / CELL_SIZE));
-    int endX = std::min(GRID_SIZE - 1, static_cast<int>(maxX / CELL_SIZE));
-    int endY = std::min(GRID_SIZE - 1, static_cast<int>(maxY / CELL_SIZE));
-    
-    int wallCount = 0;
-    
-    // Wall colors
-    sf::Color concreteColor(150, 150, 150);  // Gray for concrete
-    sf::Color woodColor(139, 90, 43);        // Brown for wood
-    
-    // Corner radius for rounded walls
-    const float cornerRadius = 3.0f;
-    
-    // PERFORMANCE OPTIMIZATION: Cache wall shapes
-    // Create shapes once and reuse them by only changing position and color
-    // This avoids expensive shape creation every frame for every wall
-    static sf::ConvexShape horizontalWall = createRoundedRectangle(sf::Vector2f(WALL_LENGTH, WALL_WIDTH), cornerRadius);
-    static sf::ConvexShape verticalWall = createRoundedRectangle(sf::Vector2f(WALL_WIDTH, WALL_LENGTH), cornerRadius);
-    static bool shapesInitialized = false;
-    
-    if (!shapesInitialized) {
-        shapesInitialized = true;
-    }
-    
-    // Iterate through visible cells and render their walls with smooth gradient
-    for (int i = startX; i <= endX; i++) {
-        for (int j = startY; j <= endY; j++) {
-            // Calculate cell position in world coordinates
-            float x = i * CELL_SIZE;
-            float y = j * CELL_SIZE;
-            
-            // Render topWall (horizontal wall on top edge of cell)
-            if (grid[i][j].topWall != WallType::None) {
-                // Calculate center of this specific wall for smooth gradient
-                float wallCenterX = x + WALL_LENGTH / 2.0f;
-                float wallCenterY = y;
-                float dx = wallCenterX - playerPosition.x;
-                float dy = wallCenterY - playerPosition.y;
-                float distance = std::sqrt(dx * dx + dy * dy);
-                sf::Uint8 alpha = calculateFogAlpha(distance);
-                
-                if (alpha > 0) {
-                    // Choose color based on wall type
-                    sf::Color baseColor = (grid[i][j].topWall == WallType::Concrete) ? concreteColor : woodColor;
-                    horizontalWall.setFillColor(sf::Color(baseColor.r, baseColor.g, baseColor.b, alpha));
-                    horizontalWall.setPosition(x, y - WALL_WIDTH / 2.0f);
-                    window.draw(horizontalWall);
-                    wallCount++;
-                }
-            }
-            
-            // Render rightWall (vertical wall on right edge of cell)
-            if (grid[i][j].rightWall != WallType::None) {
-                // Calculate center of this specific wall for smooth gradient
-                float wallCenterX = x + CELL_SIZE;
-                float wallCenterY = y + WALL_LENGTH / 2.0f;
-                float dx = wallCenterX - playerPosition.x;
-                float dy = wallCenterY - playerPosition.y;
-                float distance = std::sqrt(dx * dx + dy * dy);
-                sf::Uint8 alpha = calculateFogAlpha(distance);
-                
-                if (alpha > 0) {
-                    // Choose color based on wall type
-                    sf::Color baseColor = (grid[i][j].rightWall == WallType::Concrete) ? concreteColor : woodColor;
-                    verticalWall.setFillColor(sf::Color(baseColor.r, baseColor.g, baseColor.b, alpha));
-                    verticalWall.setPosition(x + CELL_SIZE - WALL_WIDTH / 2.0f, y);
-                    window.draw(verticalWall);
-                    wallCount++;
-                }
-            }
-            
-            // Render bottomWall (horizontal wall on bottom edge of cell)
-            if (grid[i][j].bottomWall != WallType::None) {
-                // Calculate center of this specific wall for smooth gradient
-                float wallCenterX = x + WALL_LENGTH / 2.0f;
-                float wallCenterY = y + CELL_SIZE;
-                float dx = wallCenterX - playerPosition.x;
-                float dy = wallCenterY - playerPosition.y;
-                float distance = std::sqrt(dx * dx + dy * dy);
-                sf::Uint8 alpha = calculateFogAlpha(distance);
-                
-                if (alpha > 0) {
-                    // Choose color based on wall type
-                    sf::Color baseColor = (grid[i][j].bottomWall == WallType::Concrete) ? concreteColor : woodColor;
-                    horizontalWall.setFillColor(sf::Color(baseColor.r, baseColor.g, baseColor.b, alpha));
-                    horizontalWall.setPosition(x, y + CELL_SIZE - WALL_WIDTH / 2.0f);
-                    window.draw(horizontalWall);
-                    wallCount++;
-                }
-            }
-            
-            // Render leftWall (vertical wall on left edge of cell)
-            if (grid[i][j].leftWall != WallType::None) {
-                // Calculate center of this specific wall for smooth gradient
-                float wallCenterX = x;
-                float wallCenterY = y + WALL_LENGTH / 2.0f;
-                float dx = wallCenterX - playerPosition.x;
-                float dy = wallCenterY - playerPosition.y;
-                float distance = std::sqrt(dx * dx + dy * dy);
-                sf::Uint8 alpha = calculateFogAlpha(distance);
-                
-                if (alpha > 0) {
-                    // Choose color based on wall type
-                    sf::Color baseColor = (grid[i][j].leftWall == WallType::Concrete) ? concreteColor : woodColor;
-                    verticalWall.setFillColor(sf::Color(baseColor.r, baseColor.g, baseColor.b, alpha));
-                    verticalWall.setPosition(x - WALL_WIDTH / 2.0f, y);
-                    window.draw(verticalWall);
-                    wallCount++;
-                }
-            }
-        }
-    }
-    
-    // Debug output: log wall count in debug builds only
+    // One draw call per visible chunk of baked walls
     #ifdef _DEBUG
-    std::cout << "Walls rendered: " << wallCount << std::endl;
+    int drawCalls = g_wallRenderer.draw(window, playerPosition, grid, minX, minY, maxX, maxY);
+    // Debug output: log draw calls in debug builds only
+    std::cout << "Wall chunks drawn: " << drawCalls << std::endl;
+    #else
+    g_wallRenderer.draw(window, playerPosition, grid, minX, minY, maxX, maxY);
     #endif
 }
 
@@ -1777,7 +3625,7 @@ void renderVisibleWalls(sf::RenderWindow& window, sf::Vector2f playerPosition,
 // ========================
 
 // Helper function to check if a position collides with walls
-bool checkCollision(sf::Vector2f pos, const std::vector<std::vector<Cell>>& grid) {
+bool checkCollision(sf::Vector2f pos, const CellGrid& grid) {
     sf::FloatRect playerRect(
         pos.x - PLAYER_SIZE / 2.0f,
         pos.y - PLAYER_SIZE / 2.0f,
@@ -1785,36 +3633,34 @@ bool checkCollision(sf::Vector2f pos, const std::vector<std::vector<Cell>>& grid
         PLAYER_SIZE
     );
     
-    int playerCellX = static_cast<int>(pos.x / CELL_SIZE);
-    int playerCellY = static_cast<int>(pos.y / CELL_SIZE);
-    
-    int startX = std::max(0, playerCellX - 1);
-    int startY = std::max(0, playerCellY - 1);
-    int endX = std::min(GRID_SIZE - 1, playerCellX + 1);
-    int endY = std::min(GRID_SIZE - 1, playerCellY + 1);
-    
-    for (int i = startX; i <= endX; i++) {
-        for (int j = startY; j <= endY; j++) {
-            float x = i * CELL_SIZE;
-            float y = j * CELL_SIZE;
-            
-            if (grid[i][j].topWall != WallType::None) {
-                sf::FloatRect wallRect(x, y - WALL_WIDTH / 2.0f, WALL_LENGTH, WALL_WIDTH);
-                if (playerRect.intersects(wallRect)) return true;
-            }
-            
-            if (grid[i][j].rightWall != WallType::None) {
-                sf::FloatRect wallRect(x + CELL_SIZE - WALL_WIDTH / 2.0f, y, WALL_WIDTH, WALL_LENGTH);
-                if (playerRect.intersects(wallRect)) return true;
-            }
-            
-            if (grid[i][j].bottomWall != WallType::None) {
-                sf::FloatRect wallRect(x, y + CELL_SIZE - WALL_WIDTH / 2.0f, WALL_LENGTH, WALL_WIDTH);
+    // Only the edges whose wall can overlap the player are tested: horizontal edges
+    // on the lines within WALL_WIDTH/2 of the player's top..bottom, vertical edges on
+    // the lines within WALL_WIDTH/2 of its left..right; usually one or two of each
+    const float half = WALL_WIDTH / 2.0f;
+    const float right = playerRect.left + playerRect.width;
+    const float bottom = playerRect.top + playerRect.height;
+    const int cellMinX = static_cast<int>(std::floor(playerRect.left / CELL_SIZE));
+    const int cellMaxX = static_cast<int>(std::floor(right / CELL_SIZE));
+    const int cellMinY = static_cast<int>(std::floor(playerRect.top / CELL_SIZE));
+    const int cellMaxY = static_cast<int>(std::floor(bottom / CELL_SIZE));
+    
+    const int lineMinY = static_cast<int>(std::ceil((playerRect.top - half) / CELL_SIZE));
+    const int lineMaxY = static_cast<int>(std::floor((bottom + half) / CELL_SIZE));
+    for (int j = lineMinY; j <= lineMaxY; j++) {
+        for (int i = cellMinX; i <= cellMaxX; i++) {
+            if (grid.horizontal(i, j) != WallType::None) {
+                sf::FloatRect wallRect(i * CELL_SIZE, j * CELL_SIZE - half, WALL_LENGTH, WALL_WIDTH);
                 if (playerRect.intersects(wallRect)) return true;
             }
-            
-            if (grid[i][j].leftWall != WallType::None) {
-                sf::FloatRect wallRect(x - WALL_WIDTH / 2.0f, y, WALL_WIDTH, WALL_LENGTH);
+        }
+    }
+    
+    const int lineMinX = static_cast<int>(std::ceil((playerRect.left - half) / CELL_SIZE));
+    const int lineMaxX = static_cast<int>(std::floor((right + half) / CELL_SIZE));
+    for (int i = lineMinX; i <= lineMaxX; i++) {
+        for (int j = cellMinY; j <= cellMaxY; j++) {
+            if (grid.vertical(i, j) != WallType::None) {
+                sf::FloatRect wallRect(i * CELL_SIZE - half, j * CELL_SIZE, WALL_WIDTH, WALL_LENGTH);
                 if (playerRect.intersects(wallRect)) return true;
             }
         }
@@ -1843,9 +3689,9 @@ bool checkCollision(sf::Vector2f pos, const std::vector<std::vector<Cell>>& grid
 //
 // PERFORMANCE:
 // - Maximum 3 collision checks per frame (newPos, slideX, slideY)
-// - Each check examines ~10-15 walls in nearby cells
+// - Each check examines the 2-4 edges the player box can overlap
 // - Target: < 0.3ms per collision resolution
-sf::Vector2f resolveCollisionCellBased(sf::Vector2f oldPos, sf::Vector2f newPos, const std::vector<std::vector<Cell>>& grid) {
+sf::Vector2f resolveCollisionCellBased(sf::Vector2f oldPos, sf::Vector2f newPos, const CellGrid& grid) {
     // Step 1: Check if new position collides
     if (!checkCollision(newPos, grid)) {
         // No collision, clamp to map boundaries and return
@@ -1884,12 +3730,345 @@ sf::Vector2f resolveCollisionCellBased(sf::Vector2f oldPos, sf::Vector2f newPos,
     return newPos;
 }
 
+// ========================
+// Input Command Movement
+// ========================
+
+// Movement speed for an input command's weapon code (0 = no weapon, else Weapon::Type + 1)
+// Same values as Player::getMovementSpeed(); unknown codes get the base speed
+float inputMovementSpeed(uint8_t weaponCode) {
+    static const std::array<float, Weapon::M40 + 2> speeds = [] {
+        std::array<float, Weapon::M40 + 2> table;
+        table[0] = Player().getMovementSpeed();
+        for (int type = Weapon::USP; type <= Weapon::M40; ++type) {
+            Weapon* weapon = Weapon::create(static_cast<Weapon::Type>(type));
+            table[type + 1] = weapon->movementSpeed;
+            delete weapon;
+        }
+        return table;
+    }();
+    return weaponCode < speeds.size() ? speeds[weaponCode] : speeds[0];
+}
+
+// Simulate one input command: move by its buttons for INPUT_STEP, then resolve walls
+// The server and the client's prediction both run this, so replaying the same
+// commands from the same position always ends at the same place.
+sf::Vector2f applyInputCommand(sf::Vector2f position, uint8_t buttons, const CellGrid& grid) {
+    if ((buttons & (INPUT_UP | INPUT_DOWN | INPUT_LEFT | INPUT_RIGHT)) == 0) {
+        return position;
+    }
+    
+    // Speeds are pixels per 1/60 s
+    const float step = inputMovementSpeed(inputWeaponCode(buttons)) * INPUT_STEP * 60.0f;
+    sf::Vector2f target = position;
+    if (buttons & INPUT_UP) target.y -= step;
+    if (buttons & INPUT_DOWN) target.y += step;
+    if (buttons & INPUT_LEFT) target.x -= step;
+    if (buttons & INPUT_RIGHT) target.x += step;
+    
+    return resolveCollisionCellBased(position, target, grid);
+}
+
+// Client-side prediction with server reconciliation
+//
+// Every sampled command moves the local player immediately (no round trip before
+// the player sees the result) and is kept until the server acknowledges it. Each
+// InputAck carries the last command the server simulated and the position that
+// left the player at: reconcile() restarts from there and replays the commands
+// the server has not reached yet. Both sides run applyInputCommand, so for an
+// undisturbed stream the replay ends exactly where the prediction already was;
+// only lost commands, respawns and hits on the server move the player.
+//
+// PERFORMANCE:
+// Fixed ring of CAPACITY commands, no allocation. A reconciliation replays the
+// unacknowledged commands (~RTT * INPUT_RATE, 6 at 100 ms) once per ack (20 Hz).
+class InputPredictor {
+public:
+    static const size_t CAPACITY = 64;  // ~1 s of commands; older unacknowledged ones are dropped
+    
+    // Record a new command (the sequence is assigned here) and predict it
+    // Returns: the position after the command
+    sf::Vector2f predict(sf::Vector2f position, uint8_t buttons, uint16_t aim, const CellGrid& grid) {
+        if (count_ == CAPACITY) {
+            head_ = (head_ + 1) % CAPACITY;
+            count_--;
+        }
+        InputCommand& command = commands_[(head_ + count_) % CAPACITY];
+        command.sequence = nextSequence_++;
+        command.buttons = buttons;
+        command.aim = aim;
+        count_++;
+        return applyInputCommand(position, buttons, grid);
+    }
+    
+    // Store the server's acknowledgement for the next reconcile()
+    // Acks older than the newest one received (reordered datagrams) are ignored
+    void acknowledge(uint32_t sequence, float x, float y) {
+        if (hasAck_ && sequence <= ackSequence_) {
+            return;
+        }
+        ackSequence_ = sequence;
+        ackPosition_ = sf::Vector2f(x, y);
+        hasAck_ = true;
+        ackPending_ = true;
+    }
+    
+    // Rewind to the acknowledged position and replay the unacknowledged commands
+    // Returns: true (and the corrected position) if a new ack was applied
+    bool reconcile(sf::Vector2f& position, const CellGrid& grid) {
+        if (!ackPending_) {
+            return false;
+        }
+        ackPending_ = false;
+        
+        while (count_ > 0 && commands_[head_].sequence <= ackSequence_) {
+            head_ = (head_ + 1) % CAPACITY;
+            count_--;
+        }
+        
+        position = ackPosition_;
+        for (size_t i = 0; i < count_; ++i) {
+            position = applyInputCommand(position, commands_[(head_ + i) % CAPACITY].buttons, grid);
+        }
+        return true;
+    }
+    
+    // Copy the newest unacknowledged commands, oldest first, for sending
+    // Returns: number of commands copied (at most maxCount)
+    size_t unacknowledged(InputCommand* out, size_t maxCount) const {
+        const size_t count = std::min(count_, maxCount);
+        const size_t first = count_ - count;
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = commands_[(head_ + first + i) % CAPACITY];
+        }
+        return count;
+    }
+    
+    size_t pending() const { return count_; }
+    
+private:
+    std::array<InputCommand, CAPACITY> commands_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    uint32_t nextSequence_ = 0;
+    uint32_t ackSequence_ = 0;
+    sf::Vector2f ackPosition_;
+    bool hasAck_ = false;
+    bool ackPending_ = false;
+};
+
+// ========================
+// Snapshot Interpolation
+// ========================
+
+// State of one remote player in one snapshot
+struct EntityState {
+    float x = 0.0f;
+    float y = 0.0f;
+    float rotation = 0.0f;  // Degrees
+    bool isAlive = true;
+};
+
+// Maps server ticks to local time and picks the delayed render time
+//
+// Remote players are drawn where they were interpDelay seconds ago on the
+// server's timeline, so there are normally two snapshots around the render
+// time to interpolate between, whatever the frame rate.
+//
+// ALGORITHM:
+// - Clock offset: each snapshot gives arrival - tick * tickDuration. The
+//   offset follows the earliest arrivals (a lower value is taken at once,
+//   a higher one only by slow drift), so it tracks an on-time packet.
+// - Jitter: how late snapshots arrive relative to that offset, smoothed with
+//   a fast rise and a slow decay, so one late packet widens the margin at once
+//   and a calm link narrows it again over a few seconds.
+// - Delay target: measured snapshot spacing + 1.5 * jitter + a small margin,
+//   clamped to [MIN_DELAY, MAX_DELAY]. The delay moves toward the target by at
+//   most DELAY_SLEW seconds per second, so the remote players speed up or slow
+//   down by a few percent instead of jumping.
+class SnapshotClock {
+public:
+    static constexpr float MIN_DELAY = 0.03f;    // Seconds
+    static constexpr float MAX_DELAY = 0.3f;
+    static constexpr float SAFETY_MARGIN = 0.005f;
+    static constexpr float DELAY_SLEW = 0.1f;    // Delay change per second of play
+    static constexpr float OFFSET_DRIFT = 0.002f;
+    
+    void setTickRate(float ticksPerSecond) {
+        tickDuration_ = 1.0 / ticksPerSecond;
+    }
+    
+    // Record the arrival of the newest snapshot
+    // now - local time in seconds (same clock as advance())
+    void onSnapshot(uint32_t tick, float now) {
+        const double serverTime = tick * tickDuration_;
+        const double offset = now - serverTime;
+        
+        if (!synced_) {
+            offset_ = offset;
+            lastTick_ = tick;
+            synced_ = true;
+            return;
+        }
+        
+        if (offset < offset_) {
+            offset_ = offset;
+        } else {
+            offset_ += (offset - offset_) * OFFSET_DRIFT;
+        }
+        
+        const float lateness = static_cast<float>(offset - offset_);
+        jitter_ += (lateness - jitter_) * (lateness > jitter_ ? 0.25f : 0.02f);
+        
+        if (tick > lastTick_) {
+            const float spacing = static_cast<float>((tick - lastTick_) * tickDuration_);
+            spacing_ = spacing_ == 0.0f ? spacing : spacing_ + (spacing - spacing_) * 0.1f;
+            lastTick_ = tick;
+        }
+    }
+    
+    // Move the delay toward its target and return the render time in (fractional) ticks
+    double advance(float now, float deltaTime) {
+        const float target = targetDelay();
+        const float maxStep = DELAY_SLEW * deltaTime;
+        if (delay_ == 0.0f) {
+            delay_ = target;
+        } else {
+            delay_ += std::max(-maxStep, std::min(maxStep, target - delay_));
+        }
+        return (now - offset_ - delay_) / tickDuration_;
+    }
+    
+    float targetDelay() const {
+        return std::max(MIN_DELAY, std::min(MAX_DELAY, spacing_ + 1.5f * jitter_ + SAFETY_MARGIN));
+    }
+    
+    bool synced() const { return synced_; }
+    float delay() const { return delay_; }
+    float jitter() const { return jitter_; }
+    double tickDuration() const { return tickDuration_; }
+    
+private:
+    double tickDuration_ = 1.0 / 60.0;
+    double offset_ = 0.0;       // Local arrival time minus server time of an on-time snapshot
+    uint32_t lastTick_ = 0;
+    float spacing_ = 0.0f;      // Seconds between consecutive snapshots
+    float jitter_ = 0.0f;       // Smoothed lateness in seconds
+    float delay_ = 0.0f;        // Current interpolation delay in seconds
+    bool synced_ = false;
+};
+
+// Recent snapshot states of one remote player, ordered by server tick
+//
+// sample() interpolates between the two states around the render tick. Past
+// the newest state (late or lost snapshots) it extrapolates along the last
+// velocity for at most maxExtrapolationTicks, then holds, so a lost packet
+// costs a small overshoot instead of a freeze followed by a jump.
+//
+// PERFORMANCE:
+// Fixed ring of CAPACITY states, no allocation; a lookup scans back from the
+// newest state, which with a ~100 ms delay is two or three steps.
+class SnapshotTrack {
+public:
+    static const size_t CAPACITY = 16;  // 0.8 s at 20 Hz
+    
+    // Moves larger than this between two snapshots are teleports (respawn): no sliding across the map
+    static constexpr float TELEPORT_DISTANCE = 200.0f;
+    
+    enum class Result { Empty, Interpolated, Extrapolated, Held };
+    
+    // Add the state of a snapshot; ticks not newer than the newest state are ignored
+    void push(uint32_t tick, const EntityState& state) {
+        if (count_ > 0 && tick <= ticks_[newestIndex()]) {
+            return;
+        }
+        const size_t index = (head_ + count_) % CAPACITY;
+        if (count_ == CAPACITY) {
+            head_ = (head_ + 1) % CAPACITY;
+        } else {
+            count_++;
+        }
+        ticks_[index] = tick;
+        states_[index] = state;
+    }
+    
+    Result sample(double renderTick, double maxExtrapolationTicks, EntityState& out) const {
+        if (count_ == 0) {
+            return Result::Empty;
+        }
+        
+        const size_t newest = newestIndex();
+        if (renderTick >= ticks_[newest]) {
+            out = states_[newest];
+            if (count_ < 2) {
+                return Result::Held;
+            }
+            const size_t previous = (newest + CAPACITY - 1) % CAPACITY;
+            const EntityState& from = states_[previous];
+            const double span = static_cast<double>(ticks_[newest] - ticks_[previous]);
+            const double ahead = std::min(renderTick - ticks_[newest], maxExtrapolationTicks);
+            if (ahead <= 0.0 || !from.isAlive || !out.isAlive || isTeleport(from, out)) {
+                return Result::Held;
+            }
+            const float t = static_cast<float>(ahead / span);
+            out.x += (out.x - from.x) * t;
+            out.y += (out.y - from.y) * t;
+            return Result::Extrapolated;
+        }
+        
+        // Newest state at or before the render tick, then blend toward its successor
+        for (size_t back = 1; back < count_; ++back) {
+            const size_t index = (newest + CAPACITY - back) % CAPACITY;
+            if (ticks_[index] > renderTick) {
+                continue;
+            }
+            const size_t next = (index + 1) % CAPACITY;
+            const EntityState& from = states_[index];
+            const EntityState& to = states_[next];
+            out = from;
+            if (isTeleport(from, to)) {
+                return Result::Interpolated;
+            }
+            const float t = static_cast<float>((renderTick - ticks_[index]) / static_cast<double>(ticks_[next] - ticks_[index]));
+            out.x = from.x + (to.x - from.x) * t;
+            out.y = from.y + (to.y - from.y) * t;
+            float turn = std::fmod(to.rotation - from.rotation + 540.0f, 360.0f) - 180.0f;  // Shortest arc
+            out.rotation = from.rotation + turn * t;
+            return Result::Interpolated;
+        }
+        
+        // Older than everything buffered
+        out = states_[head_];
+        return Result::Held;
+    }
+    
+    size_t size() const { return count_; }
+    
+private:
+    size_t newestIndex() const { return (head_ + count_ - 1) % CAPACITY; }
+    
+    static bool isTeleport(const EntityState& from, const EntityState& to) {
+        const float dx = to.x - from.x;
+        const float dy = to.y - from.y;
+        return dx * dx + dy * dy > TELEPORT_DISTANCE * TELEPORT_DISTANCE;
+    }
+    
+    std::array<uint32_t, CAPACITY> ticks_;
+    std::array<EntityState, CAPACITY> states_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+};
+
+// Seconds a remote player keeps moving past its newest snapshot before it is held
+const float MAX_EXTRAPOLATION = 0.1f;
+
 std::mutex mutex;
 Position clientPos = { 4850.0f, 250.0f }; // Client spawn position (top-right corner of 5100×5100 map)
 Position clientPosPrevious = { 4850.0f, 250.0f }; // Previous position for interpolation
 Position serverPos = { 250.0f, 4850.0f }; // Server spawn position (bottom-left corner of 5100×5100 map)
-Position serverPosPrevious = { 250.0f, 4850.0f }; // Previous server position for interpolation
-Position serverPosTarget = { 250.0f, 4850.0f }; // Target server position (latest received)
+SnapshotTrack serverTrack; // Host player's received states (protected by mutex)
+SnapshotClock snapshotClock; // Server tick -> local time and interpolation delay (protected by mutex)
+sf::Clock gameClock; // Time base shared by the UDP and render threads (snapshot timing)
 std::string serverIP = "127.0.0.1";
 GameMap clientGameMap; // Store map data received from server
 std::unique_ptr<sf::TcpSocket> tcpSocket; // TCP socket for connection
@@ -1898,10 +4077,25 @@ sf::Color connectionMessageColor = sf::Color::White;
 bool udpRunning = true; // Flag to control UDP thread
 bool serverConnected = false; // Track server connection status
 sf::Clock lastPacketReceived; // Track last received packet for connection loss detection
-uint32_t currentFrameID = 0; // Frame counter for position packets
+InputPredictor inputPredictor; // Local player's unacknowledged input commands (protected by mutex)
+std::atomic<uint32_t> latestSnapshotTick(0); // Server tick of the newest snapshot applied, sent with shots
+std::atomic<uint32_t> outgoingSequence(0); // Wire sequence of the next datagram to the server
+ReliableChannel reliableChannel; // Hits and purchases, exactly once and in order (protected by reliableMutex)
+std::mutex reliableMutex; // Taken before mutex, never after it
+uint8_t localPlayerId = 1; // Our player ID on the server (assigned in the TCP handshake, host is 0)
+
+// Other clients on the same server (the host player is tracked separately in serverPos)
+struct RemotePlayer {
+    SnapshotTrack track;     // Received states, sampled at the render tick
+    Position pos;            // Render position
+    float rotation = 0.0f;
+    bool isAlive = true;
+    sf::Clock lastUpdate;    // Dropped when snapshots stop (culled by distance or disconnected)
+};
+std::map<uint8_t, RemotePlayer> remotePlayers; // Protected by mutex
 
 // Grid for cell-based map system (global for easy access from handshake)
-std::vector<std::vector<Cell>> grid(GRID_SIZE, std::vector<Cell>(GRID_SIZE));
+CellGrid grid;
 
 // Shop system
 std::vector<Shop> shops;  // Shops received from server
@@ -1924,6 +4118,15 @@ std::mutex purchaseTextsMutex;
 // Client player with inventory and weapons
 Player clientPlayer;
 
+// Purchase applied locally and sent to the server, waiting for its InventoryPacket
+struct PendingPurchase {
+    int price = 0;
+    int slot = -1;          // Slot the weapon went into (weapon purchases)
+    int weaponType = -1;    // Weapon::Type, or -1 for ammo
+    int ammoType = -1;      // AmmoType, or -1 for a weapon
+};
+std::deque<PendingPurchase> pendingPurchases; // Oldest first, protected by mutex
+
 // Server player (for rendering opponent)
 Player serverPlayer;
 
@@ -1938,7 +4141,7 @@ sf::Clock inventoryAnimationClock;
 // HUD variables
 float clientHealth = 100.0f; // Client player health (0-100)
 float serverHealth = 100.0f; // Server player health (0-100)
-bool serverWasAlive = true; // Track if server was alive in previous frame
+bool serverPlayerPresent = true; // False when connected to a headless dedicated server (no host player)
 int clientScore = 0; // Client player score
 bool clientIsAlive = true; // Client player alive status
 
@@ -1952,17 +4155,16 @@ bool clientIsAlive = true; // Client player alive status
 //   grid - The grid to populate with deserialized data
 //
 // PROTOCOL:
-// The buffer contains GRID_SIZE × GRID_SIZE Cell structures serialized row by row.
-// Each Cell is sizeof(Cell) bytes (4 bytes for 4 booleans).
-// Total size: 167 × 167 × 4 = 111,556 bytes (~109 KB)
+// The buffer contains the server's CellGrid storage: the horizontal edge plane,
+// then the vertical edge plane, CellGrid::WORDS_PER_PLANE 64-bit words each,
+// 2 bits per edge. Total size: 2 x 83 x 8 = 1,328 bytes (~1.3 KB)
 //
 // ALGORITHM:
-// 1. Copy data from buffer into grid row by row
-// 2. Use std::memcpy for efficient memory copy
-// 3. Grid must be pre-allocated to GRID_SIZE × GRID_SIZE
-void deserializeMap(const std::vector<char>& buffer, std::vector<std::vector<Cell>>& grid) {
+// 1. Copy the buffer into the grid storage with a single std::memcpy
+// 2. Clear the bit pairs that encode no wall, so the received data cannot corrupt the map
+void deserializeMap(const std::vector<char>& buffer, CellGrid& grid) {
     // Calculate expected size
-    size_t expectedSize = GRID_SIZE * GRID_SIZE * sizeof(Cell);
+    size_t expectedSize = CellGrid::BYTE_SIZE;
     
     if (buffer.size() != expectedSize) {
         std::cerr << "[ERROR] Buffer size mismatch in deserializeMap: expected " 
@@ -1970,17 +4172,33 @@ void deserializeMap(const std::vector<char>& buffer, std::vector<std::vector<Cel
         return;
     }
     
-    // Copy buffer data into grid row by row
-    size_t offset = 0;
-    for (int i = 0; i < GRID_SIZE; i++) {
-        std::memcpy(grid[i].data(), buffer.data() + offset, GRID_SIZE * sizeof(Cell));
-        offset += GRID_SIZE * sizeof(Cell);
-    }
+    // The grid is one contiguous array of words, so it is filled as a single span
+    std::memcpy(grid.data(), buffer.data(), expectedSize);
+    grid.sanitize();
     
     std::cout << "[INFO] Map deserialized: " << buffer.size() << " bytes (" 
               << (buffer.size() / 1024) << " KB)" << std::endl;
 }
 
+// Receive exactly size bytes from a blocking TCP socket
+// One receive() returns what has arrived so far: TCP is a byte stream, and the
+// server queues map, shops and positions as one buffer, so a packet can arrive
+// split across reads or glued to the next one
+// Returns: Done once all size bytes are in, otherwise the failing status
+sf::Socket::Status receiveExact(sf::TcpSocket& socket, void* data, std::size_t size) {
+    char* bytes = static_cast<char*>(data);
+    std::size_t total = 0;
+    while (total < size) {
+        std::size_t received = 0;
+        sf::Socket::Status status = socket.receive(bytes + total, size - total, received);
+        if (status != sf::Socket::Done) {
+            return status;
+        }
+        total += received;
+    }
+    return sf::Socket::Done;
+}
+
 // Receive map data from server via TCP
 // Parameters:
 //   serverSocket - TCP socket connected to the server
@@ -1990,8 +4208,9 @@ void deserializeMap(const std::vector<char>& buffer, std::vector<std::vector<Cel
 //
 // PROTOCOL:
 // 1. Receive data size as uint32_t (4 bytes)
-// 2. Receive serialized map data (variable size, ~109 KB)
+// 2. Receive serialized map data (CellGrid::BYTE_SIZE, ~1.3 KB)
 // 3. Deserialize data into grid
+// 4. Build the visibility table used by the fog of war (VisibilityTable)
 //
 // ERROR HANDLING:
 // - Validates received data size
@@ -2001,33 +4220,24 @@ void deserializeMap(const std::vector<char>& buffer, std::vector<std::vector<Cel
 // PERFORMANCE:
 // - TCP ensures reliable delivery
 // - Typical receive time: 10-50ms on LAN, 50-200ms on internet
-// - Blocking operation: will wait until all data is received
-bool receiveMapFromServer(sf::TcpSocket& serverSocket, std::vector<std::vector<Cell>>& grid) {
+// - Blocking operation: will wait until all data is received (receiveExact)
+bool receiveMapFromServer(sf::TcpSocket& serverSocket, CellGrid& grid) {
     std::cout << "[INFO] Waiting to receive map from server..." << std::endl;
     
     // Step 1: Receive the size of the data (4 bytes)
     uint32_t dataSize = 0;
-    std::size_t received = 0;
     
-    sf::Socket::Status sizeStatus = serverSocket.receive(&dataSize, sizeof(dataSize), received);
+    sf::Socket::Status sizeStatus = receiveExact(serverSocket, &dataSize, sizeof(dataSize));
     if (sizeStatus != sf::Socket::Done) {
         ErrorHandler::logTCPError("Receive map data size", sizeStatus, 
                                  serverSocket.getRemoteAddress().toString());
         return false;
     }
     
-    if (received != sizeof(dataSize)) {
-        std::ostringstream oss;
-        oss << "Map data size packet mismatch - expected " << sizeof(dataSize) 
-            << " bytes, got " << received;
-        ErrorHandler::handleInvalidPacket(oss.str(), serverSocket.getRemoteAddress().toString());
-        return false;
-    }
-    
     std::cout << "[INFO] Map data size received: " << dataSize << " bytes" << std::endl;
     
     // Validate data size
-    size_t expectedSize = GRID_SIZE * GRID_SIZE * sizeof(Cell);
+    size_t expectedSize = CellGrid::BYTE_SIZE;
     if (dataSize != expectedSize) {
         std::ostringstream oss;
         oss << "Invalid map data size - expected " << expectedSize 
@@ -2040,26 +4250,28 @@ bool receiveMapFromServer(sf::TcpSocket& serverSocket, std::vector<std::vector<C
     std::vector<char> mapData(dataSize);
     std::cout << "[INFO] Receiving map data..." << std::endl;
     
-    sf::Socket::Status dataStatus = serverSocket.receive(mapData.data(), dataSize, received);
+    sf::Socket::Status dataStatus = receiveExact(serverSocket, mapData.data(), dataSize);
     if (dataStatus != sf::Socket::Done) {
         ErrorHandler::logTCPError("Receive map data", dataStatus, 
                                  serverSocket.getRemoteAddress().toString());
         return false;
     }
     
-    if (received != dataSize) {
-        std::ostringstream oss;
-        oss << "Map data packet mismatch - expected " << dataSize 
-            << " bytes, got " << received;
-        ErrorHandler::handleInvalidPacket(oss.str(), serverSocket.getRemoteAddress().toString());
-        return false;
-    }
-    
     std::cout << "[INFO] Map data received successfully" << std::endl;
     
     // Step 3: Deserialize the map data into grid
     deserializeMap(mapData, grid);
     
+    // New walls: re-lay and recolor the fog, rebake the wall batches
+    g_bgVertexCache.needsUpdate = true;
+    g_wallRenderer.invalidate();
+    
+    // Step 4: Precompute cell-to-cell visibility for the fog of war
+    sf::Clock pvsClock;
+    g_visibilityTable.build(grid);
+    std::cout << "[INFO] Visibility table built in " << pvsClock.getElapsedTime().asMilliseconds()
+              << " ms" << std::endl;
+    
     std::cout << "[INFO] Map successfully received and deserialized from server" << std::endl;
     return true;
 }
@@ -2079,9 +4291,8 @@ bool receiveShopsFromServer(sf::TcpSocket& serverSocket, std::vector<Shop>& shop
     
     // Step 1: Receive shop count
     uint8_t shopCount = 0;
-    std::size_t received = 0;
     
-    sf::Socket::Status countStatus = serverSocket.receive(&shopCount, sizeof(shopCount), received);
+    sf::Socket::Status countStatus = receiveExact(serverSocket, &shopCount, sizeof(shopCount));
     if (countStatus != sf::Socket::Done) {
         ErrorHandler::logTCPError("Receive shop count", countStatus, 
                                  serverSocket.getRemoteAddress().toString());
@@ -2100,7 +4311,7 @@ bool receiveShopsFromServer(sf::TcpSocket& serverSocket, std::vector<Shop>& shop
             int32_t gridY;
         } shopData;
         
-        sf::Socket::Status shopStatus = serverSocket.receive(&shopData, sizeof(shopData), received);
+        sf::Socket::Status shopStatus = receiveExact(serverSocket, &shopData, sizeof(shopData));
         if (shopStatus != sf::Socket::Done) {
             ErrorHandler::logTCPError("Receive shop data", shopStatus, 
                                      serverSocket.getRemoteAddress().toString());
@@ -2194,8 +4405,7 @@ bool performTCPHandshake(const std::string& ip) {
     
     // Receive initial server position
     PositionPacket serverPosPacket;
-    std::size_t received = 0;
-    sf::Socket::Status serverPosStatus = tcpSocket->receive(&serverPosPacket, sizeof(PositionPacket), received);
+    sf::Socket::Status serverPosStatus = receiveExact(*tcpSocket, &serverPosPacket, sizeof(PositionPacket));
     
     if (serverPosStatus != sf::Socket::Done) {
         ErrorHandler::logTCPError("Receive server initial position", serverPosStatus, ip);
@@ -2205,21 +4415,18 @@ bool performTCPHandshake(const std::string& ip) {
         return false;
     }
     
-    if (received != sizeof(PositionPacket)) {
-        std::ostringstream oss;
-        oss << "Server position packet size mismatch - expected " << sizeof(PositionPacket) 
-            << " bytes, got " << received;
-        ErrorHandler::handleInvalidPacket(oss.str(), ip);
-    } else if (validatePosition(serverPosPacket)) {
+    if (validatePosition(serverPosPacket)) {
         serverPos.x = serverPosPacket.x;
         serverPos.y = serverPosPacket.y;
+        // Dedicated servers report their (non-existent) host player as not alive
+        serverPlayerPresent = serverPosPacket.isAlive;
         ErrorHandler::logInfo("Server initial position: (" + std::to_string(serverPos.x) + 
                              ", " + std::to_string(serverPos.y) + ")");
     }
     
     // Receive initial client position
     PositionPacket clientPosPacket;
-    sf::Socket::Status clientPosStatus = tcpSocket->receive(&clientPosPacket, sizeof(PositionPacket), received);
+    sf::Socket::Status clientPosStatus = receiveExact(*tcpSocket, &clientPosPacket, sizeof(PositionPacket));
     
     if (clientPosStatus != sf::Socket::Done) {
         ErrorHandler::logTCPError("Receive client initial position", clientPosStatus, ip);
@@ -2229,12 +4436,11 @@ bool performTCPHandshake(const std::string& ip) {
         return false;
     }
     
-    if (received != sizeof(PositionPacket)) {
-        std::ostringstream oss;
-        oss << "Client position packet size mismatch - expected " << sizeof(PositionPacket) 
-            << " bytes, got " << received;
-        ErrorHandler::handleInvalidPacket(oss.str(), ip);
-    } else if (validatePosition(clientPosPacket)) {
+    if (validatePosition(clientPosPacket)) {
+        // The server assigns our player ID in this packet
+        localPlayerId = clientPosPacket.playerId;
+        ErrorHandler::logInfo("Assigned player ID: " + std::to_string(localPlayerId));
+        
         clientPos.x = clientPosPacket.x;
         clientPos.y = clientPosPacket.y;
         clientPosPrevious.x = clientPosPacket.x;
@@ -2242,12 +4448,325 @@ bool performTCPHandshake(const std::string& ip) {
         ErrorHandler::logInfo("Client initial position: (" + std::to_string(clientPos.x) + 
                              ", " + std::to_string(clientPos.y) + ")");
     }
-    
-    connectionMessage = "Connection established";
-    connectionMessageColor = sf::Color::Green;
-    ErrorHandler::logInfo("TCP handshake completed successfully");
-    
-    return true;
+    
+    connectionMessage = "Connection established";
+    connectionMessageColor = sf::Color::Green;
+    ErrorHandler::logInfo("TCP handshake completed successfully");
+    
+    return true;
+}
+
+// Apply one snapshot message from the server
+// Parameters:
+//   data, size - The writeSnapshot() payload
+//   snapshotHistory - Received snapshots (baselines for the server's deltas)
+//   decodedPlayers - Scratch buffer for the decoded players
+//   ackTick - Newest snapshot applied, acknowledged in every input message
+void applySnapshotMessage(const uint8_t* data, size_t size, SnapshotHistory& snapshotHistory,
+                          std::vector<QuantizedPlayerState>& decodedPlayers, uint32_t& ackTick) {
+    uint32_t tick = 0;
+    if (!readSnapshot(data, size, snapshotHistory, tick, decodedPlayers)) {
+        // Truncated, or delta against a snapshot we never got; the server
+        // falls back to our last ack (or a full snapshot) on its own
+        ErrorHandler::logWarning("Dropped snapshot (" + std::to_string(size) + " bytes)");
+    }
+    else {
+        snapshotHistory.store(tick, decodedPlayers);
+        
+        // Only the newest snapshot is applied (UDP may reorder)
+        if (ackTick == NO_SNAPSHOT_ACK || tick > ackTick) {
+            ackTick = tick;
+            
+            // Shots report the newest snapshot tick so the server can
+            // rewind other players to what we are seeing
+            latestSnapshotTick = tick;
+            
+            std::lock_guard<std::mutex> lock(mutex);
+            snapshotClock.onSnapshot(tick, gameClock.getElapsedTime().asSeconds());
+            for (const QuantizedPlayerState& quantized : decodedPlayers) {
+                PositionPacket state;
+                state.x = dequantizePosition(quantized.x);
+                state.y = dequantizePosition(quantized.y);
+                state.rotation = dequantizeRotation(quantized.rotation);
+                state.health = quantized.health;
+                state.isAlive = quantized.isAlive;
+                state.playerId = quantized.id;
+                
+                EntityState entity;
+                entity.x = state.x;
+                entity.y = state.y;
+                entity.rotation = state.rotation;
+                entity.isAlive = state.isAlive;
+                
+                // Remote positions are buffered by tick and sampled by the render loop
+                if (state.playerId == 0) { // Server is player 0
+                    serverTrack.push(tick, entity);
+                    serverPlayerPresent = true;
+                    
+                    // Update server health
+                    serverHealth = state.health;
+                    
+                    serverConnected = true;
+                    lastPacketReceived.restart(); // Reset timeout timer
+                }
+                else if (state.playerId == localPlayerId) { // Our own health from server
+                    // Update client health (calculated on server when hit by bullets)
+                    clientHealth = state.health;
+                    clientIsAlive = state.isAlive;
+                    
+                    serverConnected = true;
+                    lastPacketReceived.restart(); // Reset timeout timer
+                }
+                else { // Another client on the same server
+                    RemotePlayer& remote = remotePlayers[state.playerId];
+                    remote.track.push(tick, entity);
+                    remote.lastUpdate.restart();
+                }
+            }
+        }
+    }
+}
+
+// Apply one shot message from the server: spawn the bullet locally
+void applyShotMessage(const ShotMessageView& shot) {
+    ErrorHandler::logInfo("Received shot packet! Owner: " + std::to_string(shot.playerId()));
+    
+    // Create bullet on client
+    Bullet bullet;
+    bullet.ownerId = shot.playerId();
+    bullet.x = shot.x();
+    bullet.y = shot.y();
+    bullet.prevX = shot.x();  // Initialize previous position
+    bullet.prevY = shot.y();
+    bullet.vx = shot.dirX() * shot.bulletSpeed();
+    bullet.vy = shot.dirY() * shot.bulletSpeed();
+    bullet.damage = shot.damage();
+    bullet.range = shot.range();
+    bullet.maxRange = shot.range();
+    bullet.weaponType = static_cast<Weapon::Type>(shot.weaponType());
+    
+    // Add bullet to active bullets list
+    {
+        std::lock_guard<std::mutex> lock(bulletsMutex);
+        activeBullets.push_back(bullet);
+        ErrorHandler::logInfo("Bullet added from server! Total bullets: " + std::to_string(activeBullets.size()));
+    }
+}
+
+// Apply one hit message from the server: damage text, kill reward, bullet removal
+void applyHitMessage(const HitMessageView& hit) {
+    ErrorHandler::logInfo("Received hit packet! Shooter: " + std::to_string(hit.shooterId()) + 
+                         ", Victim: " + std::to_string(hit.victimId()) + 
+                         ", Damage: " + std::to_string(hit.damage()));
+    
+    // Requirement 8.4: The server credits kills by shooter ID; mirror our reward locally
+    if (hit.wasKill() && hit.shooterId() == localPlayerId) {
+        std::lock_guard<std::mutex> lock(mutex);
+        clientPlayer.money += 5000;
+        clientScore += 1;
+        ErrorHandler::logInfo("!!! PLAYER " + std::to_string(hit.victimId()) + " ELIMINATED !!! Client gets $5000 reward and +1 score. Client money: $" + std::to_string(clientPlayer.money) + ", Score: " + std::to_string(clientScore));
+    }
+    
+    // Create damage text at hit location
+    {
+        std::lock_guard<std::mutex> lock(damageTextsMutex);
+        DamageText damageText;
+        damageText.x = hit.hitX();
+        damageText.y = hit.hitY() - 30.0f; // Start above hit position
+        damageText.damage = hit.damage();
+        damageTexts.push_back(damageText);
+    }
+    
+    // Mark bullet for removal at hit location
+    {
+        std::lock_guard<std::mutex> lock(bulletsMutex);
+        for (auto& bullet : activeBullets) {
+            // Find bullet near hit location from the shooter
+            if (bullet.ownerId == hit.shooterId()) {
+                float dx = bullet.x - hit.hitX();
+                float dy = bullet.y - hit.hitY();
+                float distSq = dx * dx + dy * dy;
+                if (distSq < 100.0f) { // Within 10 pixels
+                    bullet.range = 0.0f; // Mark for removal
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Apply the server's answer to our oldest unconfirmed purchase
+// Purchases are applied locally at once; the server's balance replaces ours
+// minus what the purchases it has not answered yet cost (like InputPredictor),
+// and a refused purchase is taken back.
+void applyInventoryMessage(const InventoryMessageView& inventory) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (pendingPurchases.empty()) {
+        ErrorHandler::logWarning("Inventory update without a pending purchase");
+        clientPlayer.money = inventory.newMoneyBalance();
+        return;
+    }
+    const PendingPurchase purchase = pendingPurchases.front();
+    pendingPurchases.pop_front();
+    
+    if (!inventory.accepted()) {
+        ErrorHandler::logWarning("Server refused purchase, undoing it");
+        if (purchase.weaponType >= 0 && purchase.slot >= 0) {
+            Weapon*& weapon = clientPlayer.inventory[purchase.slot];
+            if (weapon != nullptr && weapon->type == purchase.weaponType) {
+                delete weapon;
+                weapon = nullptr;
+                if (clientPlayer.activeSlot == purchase.slot) {
+                    clientPlayer.activeSlot = -1;
+                }
+            }
+        } else if (purchase.ammoType >= 0) {
+            AmmoItem* ammo = AmmoItem::create(static_cast<AmmoType>(purchase.ammoType));
+            int* pool = ammo->type == AmmoType::AMMO_9x18 ? &clientPlayer.pistolAmmo :
+                        ammo->type == AmmoType::AMMO_5_45x39 ? &clientPlayer.rifleAmmo : &clientPlayer.sniperAmmo;
+            *pool = std::max(0, *pool - ammo->quantity);
+            delete ammo;
+        }
+    }
+    
+    int unconfirmed = 0;
+    for (const PendingPurchase& pending : pendingPurchases) {
+        unconfirmed += pending.price;
+    }
+    clientPlayer.money = inventory.newMoneyBalance() - unconfirmed;
+}
+
+// Apply a purchase locally first (processPurchase/processAmmoPurchase), then call this
+// Records it for applyInventoryMessage and sends it to the server reliably
+void sendPurchase(const PendingPurchase& purchase) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pendingPurchases.push_back(purchase);
+    }
+    
+    PurchasePacket packet;
+    packet.playerId = localPlayerId;
+    packet.weaponType = purchase.weaponType >= 0 ? static_cast<uint8_t>(purchase.weaponType) : PURCHASE_NONE;
+    packet.ammoType = purchase.ammoType >= 0 ? static_cast<uint8_t>(purchase.ammoType) : PURCHASE_NONE;
+    uint8_t body[PURCHASE_MESSAGE_BYTES];
+    writePurchaseMessage(body, packet);
+    
+    std::lock_guard<std::mutex> lock(reliableMutex);
+    if (!reliableChannel.send(WireMessageType::Purchase, body, sizeof(body))) {
+        ErrorHandler::logWarning("Reliable queue full, purchase not sent to server");
+    }
+}
+
+// Receive-side state of udpThread, passed to the message handlers
+struct ReceiveContext {
+    SnapshotHistory snapshotHistory;                  // Received snapshots (baselines for the server's deltas)
+    std::vector<QuantizedPlayerState> decodedPlayers; // Scratch buffer for decoded snapshots
+    uint32_t ackTick = NO_SNAPSHOT_ACK;               // Newest snapshot applied, acknowledged in every input message
+    float ackReceivedAt = 0.0f;                       // When ackTick arrived (gameClock), for the ack delay
+    SequenceTracker downstream;                       // Loss of the server's datagrams, reported in every input message
+};
+
+void handleSnapshotMessage(const uint8_t* payload, size_t length, ReceiveContext& context) {
+    const uint32_t previousAck = context.ackTick;
+    applySnapshotMessage(payload, length, context.snapshotHistory, context.decodedPlayers, context.ackTick);
+    if (context.ackTick != previousAck) {
+        context.ackReceivedAt = gameClock.getElapsedTime().asSeconds();
+    }
+}
+
+void handleShotMessage(const uint8_t* payload, size_t, ReceiveContext&) {
+    applyShotMessage(ShotMessageView(payload));
+}
+
+void handleHitMessage(const uint8_t* payload, size_t, ReceiveContext&) {
+    applyHitMessage(HitMessageView(payload));
+}
+
+// Applied by the main loop before its next movement step (see InputPredictor)
+void handleInputAckMessage(const uint8_t* payload, size_t, ReceiveContext&) {
+    const InputAckMessageView ack(payload);
+    std::lock_guard<std::mutex> lock(mutex);
+    inputPredictor.acknowledge(ack.sequence(), ack.x(), ack.y());
+}
+
+void handleInventoryMessage(const uint8_t* payload, size_t, ReceiveContext&) {
+    applyInventoryMessage(InventoryMessageView(payload));
+}
+
+// Messages the server may send inside a Reliable message, indexed by WireMessageType
+const WireHandler<ReceiveContext> RELIABLE_RECEIVE_HANDLERS[WIRE_MESSAGE_TYPE_COUNT] = {
+    nullptr,                 // invalid
+    nullptr,                 // Input (client -> server only)
+    nullptr,                 // Shot (unreliable)
+    handleHitMessage,        // Hit
+    nullptr,                 // Snapshot (unreliable)
+    nullptr,                 // InputAck (unreliable)
+    nullptr,                 // Purchase (client -> server only)
+    handleInventoryMessage,  // Inventory
+    nullptr,                 // Reliable (not nested)
+    nullptr                  // ReliableAck (not nested)
+};
+
+// Reliable message: buffer it, then apply every message that is now in order
+void handleReliableMessage(const uint8_t* payload, size_t length, ReceiveContext& context) {
+    const ReliableMessageView message(payload, length);
+    std::lock_guard<std::mutex> lock(reliableMutex);
+    reliableChannel.receive(message.id(), message.type(), message.body(), message.bodyLength());
+    reliableChannel.deliver([&](uint8_t type, const uint8_t* body, size_t bodyLength) {
+        WireStatus status = dispatchWireMessage(type, body, bodyLength, RELIABLE_RECEIVE_HANDLERS, context);
+        if (status != WireStatus::Ok) {
+            ErrorHandler::handleInvalidPacket(std::string("Rejected reliable message (") + wireStatusName(status) + ")");
+        }
+    });
+}
+
+void handleReliableAckMessage(const uint8_t* payload, size_t, ReceiveContext&) {
+    const ReliableAckMessageView ack(payload);
+    std::lock_guard<std::mutex> lock(reliableMutex);
+    reliableChannel.onAck(ack.nextExpected(), ack.received(), gameClock.getElapsedTime().asSeconds());
+}
+
+// Messages the server may send, indexed by WireMessageType (null = rejected)
+const WireHandler<ReceiveContext> RECEIVE_HANDLERS[WIRE_MESSAGE_TYPE_COUNT] = {
+    nullptr,                  // invalid
+    nullptr,                  // Input (client -> server only)
+    handleShotMessage,        // Shot
+    nullptr,                  // Hit (reliable only)
+    handleSnapshotMessage,    // Snapshot
+    handleInputAckMessage,    // InputAck
+    nullptr,                  // Purchase (client -> server only)
+    nullptr,                  // Inventory (reliable only)
+    handleReliableMessage,    // Reliable
+    handleReliableAckMessage  // ReliableAck
+};
+
+// Send the messages append() adds to the server, in as few datagrams as they fit
+// Shots and inputs go out from different threads and sockets, so the wire
+// sequence is shared through outgoingSequence. How many datagrams the builder
+// produces is only known after flush(), so they are built first and then claim
+// that many consecutive sequences with one fetch_add: a shot sent meanwhile
+// can't be stamped with one of them.
+// Returns: Done if every datagram was sent, otherwise the worst failure
+template <typename AppendFn>
+sf::Socket::Status sendToServer(sf::UdpSocket& socket, const std::string& ip, AppendFn append) {
+    std::vector<std::vector<uint8_t>> datagrams;
+    DatagramBuilder builder([&](const uint8_t* data, size_t size, size_t) {
+        datagrams.emplace_back(data, data + size);
+    }, 0);
+    append(builder);
+    builder.flush();
+    
+    uint32_t sequence = outgoingSequence.fetch_add(static_cast<uint32_t>(datagrams.size()));
+    const sf::IpAddress server(ip);
+    sf::Socket::Status status = sf::Socket::Done;
+    for (std::vector<uint8_t>& datagram : datagrams) {
+        storeU32(datagram.data() + 1, sequence++);  // Header: version:8, sequence:32
+        sf::Socket::Status sendStatus = socket.send(datagram.data(), datagram.size(), server, 53001);
+        if (sendStatus != sf::Socket::Done && (status == sf::Socket::Done || status == sf::Socket::NotReady)) {
+            status = sendStatus;
+        }
+    }
+    return status;
 }
 
 void udpThread(std::unique_ptr<sf::UdpSocket> socket, const std::string& ip) {
@@ -2264,32 +4783,67 @@ void udpThread(std::unique_ptr<sf::UdpSocket> socket, const std::string& ip) {
     sf::Clock sendClock; // Clock for 20Hz send rate
     const float sendInterval = 1.0f / 20.0f; // 50ms = 20Hz
     
+    // Snapshot decoding: received snapshots are the baselines for the server's deltas
+    ReceiveContext receiveContext;
+    
+    // A new connection starts a new reliable stream (the server's side is new as well)
+    {
+        std::lock_guard<std::mutex> lock(reliableMutex);
+        reliableChannel = ReliableChannel();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pendingPurchases.clear();
+    }
+    
     while (udpRunning) {
-        // Send position at 20Hz
-        if (sendClock.getElapsedTime().asSeconds() >= sendInterval) {
-            PositionPacket outPacket;
-            
+        // Send input commands at 20Hz: each datagram repeats the newest
+        // MAX_INPUT_COMMANDS unacknowledged ones, so a lost datagram loses no input.
+        // Reliable acks, purchases and resends don't wait for the 20Hz slot
+        const float now = gameClock.getElapsedTime().asSeconds();
+        bool reliableDue = false;
+        {
+            std::lock_guard<std::mutex> lock(reliableMutex);
+            reliableDue = reliableChannel.wantsToSend(now);
+        }
+        const bool inputDue = sendClock.getElapsedTime().asSeconds() >= sendInterval;
+        if (inputDue || reliableDue) {
+            InputCommand commands[MAX_INPUT_COMMANDS];
+            size_t commandCount = 0;
             {
                 std::lock_guard<std::mutex> lock(mutex);
-                outPacket.x = clientPos.x;
-                outPacket.y = clientPos.y;
-                outPacket.rotation = clientPlayer.rotation;  // Send player rotation
-                outPacket.isAlive = true;
-                outPacket.frameID = currentFrameID++;
-                outPacket.playerId = 1; // Client is player 1, server is player 0
+                commandCount = inputPredictor.unacknowledged(commands, MAX_INPUT_COMMANDS);
             }
             
-            // Send position to server
-            sf::Socket::Status sendStatus = socket->send(&outPacket, sizeof(PositionPacket), sf::IpAddress(ip), 53001);
-            if (sendStatus != sf::Socket::Done && sendStatus != sf::Socket::NotReady) {
-                ErrorHandler::logUDPError("Send position packet", "Failed to send to server");
+            if (commandCount > 0 || reliableDue) {
+                // Link report: the server subtracts how long we held the acknowledged
+                // snapshot from its round trip, and learns how many of its datagrams we missed
+                InputLinkReport link;
+                if (receiveContext.ackTick != NO_SNAPSHOT_ACK) {
+                    const float held = std::max(0.0f, now - receiveContext.ackReceivedAt);
+                    link.ackDelay = static_cast<uint16_t>(std::min(65534.0f, std::round(held * 1000.0f)));
+                }
+                link.lostDatagrams = static_cast<uint16_t>(receiveContext.downstream.lost());
+                
+                sf::Socket::Status sendStatus = sendToServer(*socket, ip, [&](DatagramBuilder& builder) {
+                    if (commandCount > 0) {
+                        builder.appendInput(localPlayerId, receiveContext.ackTick, link, commands, commandCount);
+                    }
+                    std::lock_guard<std::mutex> lock(reliableMutex);
+                    reliableChannel.write(builder, now);
+                });
+                if (sendStatus != sf::Socket::Done && sendStatus != sf::Socket::NotReady) {
+                    ErrorHandler::logUDPError("Send input packet", "Failed to send to server");
+                }
             }
             
-            sendClock.restart();
+            if (inputDue) {
+                sendClock.restart();
+            }
         }
         
         // Receive positions from server (non-blocking)
-        char buffer[256];  // Buffer large enough for any packet type
+        char buffer[MAX_DATAGRAM_BYTES];  // Buffer large enough for any batched datagram
         std::size_t received;
         sf::IpAddress sender;
         unsigned short port;
@@ -2298,118 +4852,15 @@ void udpThread(std::unique_ptr<sf::UdpSocket> socket, const std::string& ip) {
         
         if (status == sf::Socket::Done) {
             if (sender == sf::IpAddress(ip)) {
-                // Check packet type by size
-                if (received == sizeof(PositionPacket)) {
-                    PositionPacket* inPacket = reinterpret_cast<PositionPacket*>(buffer);
-                    
-                    if (validatePosition(*inPacket)) {
-                        std::lock_guard<std::mutex> lock(mutex);
-                        
-                        // Update server position with interpolation support
-                        if (inPacket->playerId == 0) { // Server is player 0
-                            // Store previous position for interpolation
-                            serverPosPrevious.x = serverPosTarget.x;
-                            serverPosPrevious.y = serverPosTarget.y;
-                            
-                            // Update target position (latest received)
-                            serverPosTarget.x = inPacket->x;
-                            serverPosTarget.y = inPacket->y;
-                            
-                            // Update server player rotation
-                            serverPlayer.rotation = inPacket->rotation;
-                            
-                            // Update server health
-                            float previousServerHealth = serverHealth;
-                            serverHealth = inPacket->health;
-                            
-                            // Check if server just died (was alive, now dead)
-                            if (serverWasAlive && serverHealth <= 0.0f) {
-                                serverWasAlive = false;
-                                clientPlayer.money += 5000;
-                                clientScore += 1;
-                                ErrorHandler::logInfo("!!! SERVER PLAYER DIED !!! Client gets $5000 reward and +1 score. Client money: $" + std::to_string(clientPlayer.money) + ", Score: " + std::to_string(clientScore));
-                            } else if (serverHealth > 0.0f) {
-                                serverWasAlive = true;
-                            }
-                            
-                            serverConnected = true;
-                            lastPacketReceived.restart(); // Reset timeout timer
-                        }
-                        else if (inPacket->playerId == 1) { // Client's own position and health from server
-                            // Update client health (calculated on server when hit by bullets)
-                            clientHealth = inPacket->health;
-                            clientIsAlive = inPacket->isAlive;
-                            
-                            serverConnected = true;
-                            lastPacketReceived.restart(); // Reset timeout timer
-                        }
-                    }
-                }
-                else if (received == sizeof(ShotPacket)) {
-                    // Handle shot packet from server
-                    ShotPacket* shotPacket = reinterpret_cast<ShotPacket*>(buffer);
-                    
-                    ErrorHandler::logInfo("Received shot packet! Owner: " + std::to_string(shotPacket->playerId));
-                    
-                    // Create bullet on client
-                    Bullet bullet;
-                    bullet.ownerId = shotPacket->playerId;
-                    bullet.x = shotPacket->x;
-                    bullet.y = shotPacket->y;
-                    bullet.prevX = shotPacket->x;  // Initialize previous position
-                    bullet.prevY = shotPacket->y;
-                    bullet.vx = shotPacket->dirX * shotPacket->bulletSpeed;
-                    bullet.vy = shotPacket->dirY * shotPacket->bulletSpeed;
-                    bullet.damage = shotPacket->damage;
-                    bullet.range = shotPacket->range;
-                    bullet.maxRange = shotPacket->range;
-                    bullet.weaponType = static_cast<Weapon::Type>(shotPacket->weaponType);
-                    
-                    // Add bullet to active bullets list
-                    {
-                        std::lock_guard<std::mutex> lock(bulletsMutex);
-                        activeBullets.push_back(bullet);
-                        ErrorHandler::logInfo("Bullet added from server! Total bullets: " + std::to_string(activeBullets.size()));
-                    }
-                }
-                else if (received == sizeof(HitPacket)) {
-                    // Handle hit packet from server
-                    HitPacket* hitPacket = reinterpret_cast<HitPacket*>(buffer);
-                    
-                    ErrorHandler::logInfo("Received hit packet! Shooter: " + std::to_string(hitPacket->shooterId) + 
-                                         ", Victim: " + std::to_string(hitPacket->victimId) + 
-                                         ", Damage: " + std::to_string(hitPacket->damage));
-                    
-                    // Create damage text at hit location
-                    {
-                        std::lock_guard<std::mutex> lock(damageTextsMutex);
-                        DamageText damageText;
-                        damageText.x = hitPacket->hitX;
-                        damageText.y = hitPacket->hitY - 30.0f; // Start above hit position
-                        damageText.damage = hitPacket->damage;
-                        damageTexts.push_back(damageText);
-                    }
-                    
-                    // Mark bullet for removal at hit location
-                    {
-                        std::lock_guard<std::mutex> lock(bulletsMutex);
-                        for (auto& bullet : activeBullets) {
-                            // Find bullet near hit location from the shooter
-                            if (bullet.ownerId == hitPacket->shooterId) {
-                                float dx = bullet.x - hitPacket->hitX;
-                                float dy = bullet.y - hitPacket->hitY;
-                                float distSq = dx * dx + dy * dy;
-                                if (distSq < 100.0f) { // Within 10 pixels
-                                    bullet.range = 0.0f; // Mark for removal
-                                    break;
-                                }
-                            }
-                        }
-                    }
-                }
-                else {
+                // One datagram carries everything the server sent us this tick
+                uint32_t sequence = 0;
+                WireStatus wireStatus = decodeDatagram(reinterpret_cast<const uint8_t*>(buffer), received,
+                                                       RECEIVE_HANDLERS, receiveContext, sequence);
+                if (wireStatus == WireStatus::Ok) {
+                    receiveContext.downstream.onDatagram(sequence);
+                } else {
                     std::ostringstream oss;
-                    oss << "Unknown packet size - received " << received << " bytes";
+                    oss << "Rejected datagram (" << wireStatusName(wireStatus) << ") - received " << received << " bytes";
                     ErrorHandler::handleInvalidPacket(oss.str(), ip);
                 }
             } else {
@@ -2466,7 +4917,7 @@ void fireWeapon(Player& player, const sf::RenderWindow& window, const std::strin
         
         // Send shot packet to server
         ShotPacket shotPacket;
-        shotPacket.playerId = 0; // Client is player 0
+        shotPacket.playerId = localPlayerId;
         shotPacket.x = player.x;
         shotPacket.y = player.y;
         shotPacket.dirX = dx;
@@ -2475,10 +4926,13 @@ void fireWeapon(Player& player, const sf::RenderWindow& window, const std::strin
         shotPacket.bulletSpeed = activeWeapon->bulletSpeed;
         shotPacket.damage = activeWeapon->damage;
         shotPacket.range = activeWeapon->range;
+        shotPacket.viewTick = latestSnapshotTick;
         
         // Create temporary UDP socket for sending shot
         sf::UdpSocket shotSocket;
-        sf::Socket::Status shotStatus = shotSocket.send(&shotPacket, sizeof(ShotPacket), sf::IpAddress(serverIP), 53001);
+        sf::Socket::Status shotStatus = sendToServer(shotSocket, serverIP, [&](DatagramBuilder& builder) {
+            builder.appendShot(shotPacket);
+        });
         if (shotStatus == sf::Socket::Done) {
             ErrorHandler::logInfo("Shot packet sent to server");
         } else {
@@ -2499,7 +4953,7 @@ void fireWeapon(Player& player, const sf::RenderWindow& window, const std::strin
 
 // Render shops with fog of war integration
 // Requirements: 2.6, 3.1, 10.5
-void renderShops(sf::RenderWindow& window, sf::Vector2f playerPosition, const std::vector<Shop>& shops, const std::vector<std::vector<Cell>>& grid) {
+void renderShops(sf::RenderWindow& window, sf::Vector2f playerPosition, const std::vector<Shop>& shops, const CellGrid& grid) {
     const float SHOP_SIZE = 20.0f;  // 20×20 pixel red square
     const sf::Color shopColor(255, 0, 0);  // Red color for shops
     
@@ -2743,575 +5197,449 @@ void renderShopInteractionPrompt(sf::RenderWindow& window, sf::Vector2f playerPo
 // Shop UI Rendering System
 // ========================
 
-// Render ammo tooltip with full information
-void renderAmmoTooltip(sf::RenderWindow& window, const AmmoItem* ammo, float mouseX, float mouseY, const sf::Font& font) {
-    sf::Vector2u windowSize = window.getSize();
-    
-    // Tooltip dimensions
-    const float TOOLTIP_WIDTH = 320.0f;
-    const float TOOLTIP_HEIGHT = 220.0f;
-    const float PADDING = 15.0f;
-    
-    // Position tooltip near mouse, but keep it on screen
-    const float BOTTOM_UI_RESERVE = 150.0f;
-    
-    float tooltipX = mouseX + 20.0f;
-    float tooltipY = mouseY + 20.0f;
-    
-    // Adjust if tooltip goes off screen
-    if (tooltipX + TOOLTIP_WIDTH > windowSize.x - 10.0f) {
-        tooltipX = mouseX - TOOLTIP_WIDTH - 20.0f;
-    }
-    if (tooltipY + TOOLTIP_HEIGHT > windowSize.y - BOTTOM_UI_RESERVE) {
-        tooltipY = mouseY - TOOLTIP_HEIGHT - 20.0f;
-    }
-    if (tooltipX < 10.0f) tooltipX = 10.0f;
-    if (tooltipY < 10.0f) tooltipY = 10.0f;
-    
-    // Draw tooltip background
-    sf::RectangleShape tooltipBg(sf::Vector2f(TOOLTIP_WIDTH, TOOLTIP_HEIGHT));
-    tooltipBg.setPosition(tooltipX, tooltipY);
-    tooltipBg.setFillColor(sf::Color(20, 20, 20, 240));
-    tooltipBg.setOutlineColor(sf::Color(255, 215, 0));  // Gold border
-    tooltipBg.setOutlineThickness(2.0f);
-    window.draw(tooltipBg);
-    
-    float textY = tooltipY + PADDING;
-    
-    // Ammo name (title)
-    sf::Text nameText;
-    nameText.setFont(font);
-    nameText.setString(ammo->name);
-    nameText.setCharacterSize(24);
-    nameText.setFillColor(sf::Color(255, 215, 0));  // Gold
-    nameText.setStyle(sf::Text::Bold);
-    nameText.setPosition(tooltipX + PADDING, textY);
-    window.draw(nameText);
-    textY += 35.0f;
-    
-    // Price
-    sf::Text priceText;
-    priceText.setFont(font);
-    priceText.setString("Price: $" + std::to_string(ammo->price));
-    priceText.setCharacterSize(20);
-    priceText.setFillColor(sf::Color(100, 255, 100));  // Light green
-    priceText.setPosition(tooltipX + PADDING, textY);
-    window.draw(priceText);
-    textY += 30.0f;
-    
-    // Separator line
-    sf::RectangleShape separator(sf::Vector2f(TOOLTIP_WIDTH - 2 * PADDING, 1.0f));
-    separator.setPosition(tooltipX + PADDING, textY);
-    separator.setFillColor(sf::Color(100, 100, 100));
-    window.draw(separator);
-    textY += 10.0f;
-    
-    // Quantity per purchase
-    sf::Text quantityText;
-    quantityText.setFont(font);
-    quantityText.setString("Quantity: " + std::to_string(ammo->quantity) + " bullets");
-    quantityText.setCharacterSize(18);
-    quantityText.setFillColor(sf::Color::White);
-    quantityText.setPosition(tooltipX + PADDING, textY);
-    window.draw(quantityText);
-    textY += 30.0f;
-    
-    // Compatible weapons section
-    sf::Text compatibleLabel;
-    compatibleLabel.setFont(font);
-    compatibleLabel.setString("Compatible with:");
-    compatibleLabel.setCharacterSize(18);
-    compatibleLabel.setFillColor(sf::Color(200, 200, 200));
-    compatibleLabel.setPosition(tooltipX + PADDING, textY);
-    window.draw(compatibleLabel);
-    textY += 25.0f;
-    
-    // List compatible weapon types
-    std::string weaponList;
-    switch (ammo->type) {
-        case AmmoType::AMMO_9x18:
-            weaponList = "-> Pistols:\n  USP, Glock-18,\n  Five-SeveN, R8 Revolver";
-            break;
-        case AmmoType::AMMO_5_45x39:
-            weaponList = "-> Rifles:\n  Galil AR, M4, AK-47";
-            break;
-        case AmmoType::AMMO_7_62x54:
-            weaponList = "-> Sniper Rifles:\n  M10, AWP, M40";
-            break;
+// PERFORMANCE: Retained-mode shop UI
+// The shop used to rebuild every sf::Text, formatted string and catalog
+// Weapon/AmmoItem each frame while open. ShopUILayer builds them once per
+// window size and font, at full scale, and per frame only:
+// - rewrites the money string when the balance changed
+// - rewrites a row's status string and panel colors when its status changed
+// - refades colors while the open animation runs
+// The open animation scales the whole layout about the panel centre with a
+// render transform instead of re-laying the text at every scale. Tooltip text
+// is built once per catalog entry, on first hover.
+class ShopUILayer {
+public:
+    // Render shop UI with four columns (three for weapons, one for ammo)
+    // Requirements: 3.2, 3.3, 3.4, 3.5
+    void render(sf::RenderWindow& window, const Player& player, const sf::Font& font, float animationProgress) {
+        sf::Vector2u windowSize = window.getSize();
+        if (font_ != &font || windowSize.x != windowSize_.x || windowSize.y != windowSize_.y) {
+            build(windowSize, font);
+        }
+        
+        // Smooth easing function (ease-out cubic)
+        float easedProgress = 1.0f - std::pow(1.0f - animationProgress, 3.0f);
+        
+        // Scale animation: 70% to 100% about the panel centre
+        float scale = 0.7f + easedProgress * 0.3f;
+        sf::Transform transform;
+        transform.translate(center_).scale(scale, scale).translate(-center_.x, -center_.y);
+        
+        if (easedProgress != fade_) {
+            fade_ = easedProgress;
+            applyFade();
+        }
+        
+        // Dynamic fields: money and per-row purchase status
+        if (player.money != shownMoney_) {
+            shownMoney_ = player.money;
+            money_.text.setString("Money: $" + std::to_string(player.money));
+        }
+        for (Column& column : columns_) {
+            for (CatalogRow& row : column.rows) {
+                int state = row.weapon ? static_cast<int>(calculatePurchaseStatus(player, row.weapon.get()))
+                                       : ammoState(player, *row.ammo);
+                if (state != row.shownState) {
+                    row.shownState = state;
+                    setRowState(row, state);
+                }
+            }
+        }
+        
+        // Hover test in layout space (undo the animation scale)
+        sf::Vector2i mousePixelPos = sf::Mouse::getPosition(window);
+        sf::Vector2f mouseLayout = transform.getInverse().transformPoint(
+            static_cast<float>(mousePixelPos.x), static_cast<float>(mousePixelPos.y));
+        CatalogRow* hoveredRow = nullptr;
+        
+        // Draw semi-transparent background overlay
+        window.draw(overlay_.shape);
+        
+        sf::RenderStates states(transform);
+        window.draw(panel_.shape, states);
+        window.draw(title_.text, states);
+        window.draw(money_.text, states);
+        
+        for (Column& column : columns_) {
+            window.draw(column.background.shape, states);
+            window.draw(column.title.text, states);
+            for (CatalogRow& row : column.rows) {
+                window.draw(row.panel.shape, states);
+                window.draw(row.name.text, states);
+                window.draw(row.price.text, states);
+                window.draw(row.details.text, states);
+                window.draw(row.status.text, states);
+                if (row.bounds.contains(mouseLayout)) {
+                    hoveredRow = &row;
+                }
+            }
+        }
+        
+        // Render tooltips at the very end to ensure they're on top of all other UI elements
+        if (hoveredRow != nullptr) {
+            if (!hoveredRow->tooltip) {
+                hoveredRow->tooltip = hoveredRow->weapon ? buildWeaponTooltip(*hoveredRow->weapon)
+                                                         : buildAmmoTooltip(*hoveredRow->ammo);
+            }
+            drawTooltip(window, *hoveredRow->tooltip,
+                        static_cast<float>(mousePixelPos.x), static_cast<float>(mousePixelPos.y));
+        }
     }
     
-    sf::Text weaponListText;
-    weaponListText.setFont(font);
-    weaponListText.setString(weaponList);
-    weaponListText.setCharacterSize(16);
-    weaponListText.setFillColor(sf::Color(150, 200, 255));  // Light blue
-    weaponListText.setPosition(tooltipX + PADDING, textY);
-    window.draw(weaponListText);
-}
-
-// Render weapon tooltip with full stats
-void renderWeaponTooltip(sf::RenderWindow& window, const Weapon* weapon, float mouseX, float mouseY, const sf::Font& font) {
-    sf::Vector2u windowSize = window.getSize();
-    
-    // Tooltip dimensions
-    const float TOOLTIP_WIDTH = 320.0f;  // Увеличено с 300 до 320 для лучшей читаемости
-    const float TOOLTIP_HEIGHT = 290.0f;  // Увеличено с 280 до 290
-    const float PADDING = 15.0f;
-    
-    // Position tooltip near mouse, but keep it on screen
-    // Reserve space for UI elements at bottom (150px for "Press B" and "E - inventory")
-    const float BOTTOM_UI_RESERVE = 150.0f;
-    
-    float tooltipX = mouseX + 20.0f;
-    float tooltipY = mouseY + 20.0f;
-    
-    // Adjust if tooltip goes off screen
-    if (tooltipX + TOOLTIP_WIDTH > windowSize.x - 10.0f) {
-        tooltipX = mouseX - TOOLTIP_WIDTH - 20.0f;
-    }
-    if (tooltipY + TOOLTIP_HEIGHT > windowSize.y - BOTTOM_UI_RESERVE) {
-        // Position above cursor if would overlap bottom UI
-        tooltipY = mouseY - TOOLTIP_HEIGHT - 20.0f;
-    }
-    if (tooltipX < 10.0f) tooltipX = 10.0f;
-    if (tooltipY < 10.0f) tooltipY = 10.0f;
-    
-    // Draw tooltip background
-    sf::RectangleShape tooltipBg(sf::Vector2f(TOOLTIP_WIDTH, TOOLTIP_HEIGHT));
-    tooltipBg.setPosition(tooltipX, tooltipY);
-    tooltipBg.setFillColor(sf::Color(20, 20, 20, 240));
-    tooltipBg.setOutlineColor(sf::Color(255, 215, 0));  // Gold border
-    tooltipBg.setOutlineThickness(2.0f);
-    window.draw(tooltipBg);
-    
-    float textY = tooltipY + PADDING;
-    
-    // Weapon name (title)
-    sf::Text nameText;
-    nameText.setFont(font);
-    nameText.setString(weapon->name);
-    nameText.setCharacterSize(24);
-    nameText.setFillColor(sf::Color(255, 215, 0));  // Gold
-    nameText.setStyle(sf::Text::Bold);
-    nameText.setPosition(tooltipX + PADDING, textY);
-    window.draw(nameText);
-    textY += 35.0f;
-    
-    // Price
-    sf::Text priceText;
-    priceText.setFont(font);
-    priceText.setString("Price: $" + std::to_string(weapon->price));
-    priceText.setCharacterSize(20);
-    priceText.setFillColor(sf::Color(100, 255, 100));  // Light green
-    priceText.setPosition(tooltipX + PADDING, textY);
-    window.draw(priceText);
-    textY += 30.0f;
-    
-    // Separator line
-    sf::RectangleShape separator(sf::Vector2f(TOOLTIP_WIDTH - 2 * PADDING, 1.0f));
-    separator.setPosition(tooltipX + PADDING, textY);
-    separator.setFillColor(sf::Color(100, 100, 100));
-    window.draw(separator);
-    textY += 10.0f;
-    
-    // Stats - format floats properly
-    std::ostringstream reloadStream, moveStream;
-    reloadStream << std::fixed << std::setprecision(1) << weapon->reloadTime;
-    moveStream << std::fixed << std::setprecision(1) << weapon->movementSpeed;
-    
-    std::vector<std::pair<std::string, std::string>> stats = {
-        {"Damage:", std::to_string(static_cast<int>(weapon->damage))},
-        {"Magazine:", std::to_string(weapon->magazineSize)},
-        {"Range:", std::to_string(static_cast<int>(weapon->range)) + " px"},
-        {"Bullet Speed:", std::to_string(static_cast<int>(weapon->bulletSpeed)) + " px/s"},
-        {"Reload Time:", reloadStream.str() + " s"},
-        {"Movement Speed:", moveStream.str()},
-        {"Fire Mode:", weapon->isAutomatic() ? "Automatic (" + std::to_string(static_cast<int>(weapon->fireRate)) + " rps)" : "Semi-Auto"}
+private:
+    struct FadedText {
+        sf::Text text;
+        sf::Color color;    // Color when fully faded in
     };
     
-    for (const auto& stat : stats) {
-        sf::Text statLabel;
-        statLabel.setFont(font);
-        statLabel.setString(stat.first);
-        statLabel.setCharacterSize(16);
-        statLabel.setFillColor(sf::Color(200, 200, 200));
-        statLabel.setPosition(tooltipX + PADDING, textY);
-        window.draw(statLabel);
-        
-        sf::Text statValue;
-        statValue.setFont(font);
-        statValue.setString(stat.second);
-        statValue.setCharacterSize(16);
-        statValue.setFillColor(sf::Color::White);
-        statValue.setStyle(sf::Text::Bold);
-        statValue.setPosition(tooltipX + PADDING + 150.0f, textY);
-        window.draw(statValue);
-        
-        textY += 22.0f;
-    }
-}
-
-// Render shop UI with four columns (three for weapons, one for ammo)
-// Requirements: 3.2, 3.3, 3.4, 3.5
-void renderShopUI(sf::RenderWindow& window, const Player& player, const sf::Font& font, float animationProgress) {
-    sf::Vector2u windowSize = window.getSize();
-    
-    // Shop UI dimensions - increased width for 4 columns
-    const float UI_WIDTH = 1300.0f;
-    const float UI_HEIGHT = 700.0f;
-    const float UI_X = (windowSize.x - UI_WIDTH) / 2.0f;
-    const float UI_Y = (windowSize.y - UI_HEIGHT) / 2.0f;
-    
-    // Smooth easing function (ease-out cubic)
-    float easedProgress = 1.0f - std::pow(1.0f - animationProgress, 3.0f);
-    
-    // Scale animation
-    float scale = 0.7f + easedProgress * 0.3f;  // Scale from 70% to 100%
-    float scaledWidth = UI_WIDTH * scale;
-    float scaledHeight = UI_HEIGHT * scale;
-    float scaledX = UI_X + (UI_WIDTH - scaledWidth) / 2.0f;
-    float scaledY = UI_Y + (UI_HEIGHT - scaledHeight) / 2.0f;
-    
-    // Alpha for fade-in
-    sf::Uint8 alpha = static_cast<sf::Uint8>(easedProgress * 230);
-    
-    // Draw semi-transparent background overlay
-    sf::RectangleShape overlay(sf::Vector2f(windowSize.x, windowSize.y));
-    overlay.setFillColor(sf::Color(0, 0, 0, static_cast<sf::Uint8>(easedProgress * 180)));
-    window.draw(overlay);
-    
-    // Draw main shop panel
-    sf::RectangleShape shopPanel(sf::Vector2f(scaledWidth, scaledHeight));
-    shopPanel.setPosition(scaledX, scaledY);
-    shopPanel.setFillColor(sf::Color(40, 40, 40, alpha));
-    shopPanel.setOutlineColor(sf::Color(100, 100, 100, static_cast<sf::Uint8>(easedProgress * 255)));
-    shopPanel.setOutlineThickness(3.0f);
-    window.draw(shopPanel);
-    
-    // Draw title
-    sf::Text titleText;
-    titleText.setFont(font);
-    titleText.setString("WEAPON SHOP");
-    titleText.setCharacterSize(static_cast<unsigned int>(40 * scale));
-    titleText.setFillColor(sf::Color(255, 255, 255, static_cast<sf::Uint8>(easedProgress * 255)));
-    sf::FloatRect titleBounds = titleText.getLocalBounds();
-    titleText.setPosition(
-        scaledX + (scaledWidth - titleBounds.width) / 2.0f - titleBounds.left,
-        scaledY + 20.0f * scale
-    );
-    window.draw(titleText);
-    
-    // Draw player money
-    sf::Text moneyText;
-    moneyText.setFont(font);
-    moneyText.setString("Money: $" + std::to_string(player.money));
-    moneyText.setCharacterSize(static_cast<unsigned int>(28 * scale));
-    moneyText.setFillColor(sf::Color(100, 255, 100, static_cast<sf::Uint8>(easedProgress * 255)));
-    moneyText.setPosition(scaledX + 20.0f * scale, scaledY + 70.0f * scale);
-    window.draw(moneyText);
-    
-    // Column dimensions - now 4 columns
-    const float COLUMN_WIDTH = (scaledWidth - 100.0f * scale) / 4.0f;
-    const float COLUMN_HEIGHT = scaledHeight - 150.0f * scale;
-    const float COLUMN_Y = scaledY + 120.0f * scale;
-    const float COLUMN_PADDING = 20.0f * scale;
-    
-    // Define weapon categories
-    // Requirement 3.3: Three weapon categories + one ammo category
-    struct WeaponCategory {
-        std::string name;
-        std::vector<Weapon::Type> weapons;
+    struct FadedRect {
+        sf::RectangleShape shape;
+        sf::Color fill;     // Colors when fully faded in
+        sf::Color outline;
     };
     
-    std::vector<WeaponCategory> categories = {
-        {"Pistols", {Weapon::USP, Weapon::GLOCK, Weapon::FIVESEVEN, Weapon::R8}},
-        {"Rifles", {Weapon::GALIL, Weapon::M4, Weapon::AK47}},
-        {"Snipers", {Weapon::M10, Weapon::AWP, Weapon::M40}}
+    // Tooltip geometry relative to its top-left corner
+    struct Tooltip {
+        sf::RectangleShape background;
+        sf::RectangleShape separator;
+        std::vector<sf::Text> texts;
     };
     
-    // Define ammo types
-    std::vector<AmmoType> ammoTypes = {
-        AmmoType::AMMO_9x18,
-        AmmoType::AMMO_5_45x39,
-        AmmoType::AMMO_7_62x54
+    // One catalog entry: a weapon or an ammo type
+    struct CatalogRow {
+        std::unique_ptr<Weapon> weapon;
+        std::unique_ptr<AmmoItem> ammo;
+        FadedRect panel;
+        FadedText name;
+        FadedText price;
+        FadedText details;
+        FadedText status;
+        sf::FloatRect bounds;               // Panel rectangle at full scale
+        int shownState = -1;                // Status currently shown, -1 = none yet
+        std::unique_ptr<Tooltip> tooltip;   // Built on first hover
     };
     
-    // Variables to store hovered weapon for tooltip rendering at the end
-    Weapon* hoveredWeapon = nullptr;
-    AmmoItem* hoveredAmmo = nullptr;
-    float hoveredMouseX = 0.0f;
-    float hoveredMouseY = 0.0f;
+    struct Column {
+        FadedRect background;
+        FadedText title;
+        std::vector<CatalogRow> rows;
+    };
     
-    // Draw each column
-    for (size_t col = 0; col < categories.size(); col++) {
-        float columnX = scaledX + 20.0f * scale + col * (COLUMN_WIDTH + COLUMN_PADDING);
+    // Lay the shop out at full scale for this window size
+    void build(sf::Vector2u windowSize, const sf::Font& font) {
+        font_ = &font;
+        windowSize_ = windowSize;
+        fade_ = -1.0f;
+        shownMoney_ = std::numeric_limits<int>::min();
         
-        // Draw column background
-        sf::RectangleShape columnBg(sf::Vector2f(COLUMN_WIDTH, COLUMN_HEIGHT));
-        columnBg.setPosition(columnX, COLUMN_Y);
-        columnBg.setFillColor(sf::Color(30, 30, 30, alpha));
-        columnBg.setOutlineColor(sf::Color(80, 80, 80, static_cast<sf::Uint8>(easedProgress * 255)));
-        columnBg.setOutlineThickness(2.0f);
-        window.draw(columnBg);
+        // Shop UI dimensions - increased width for 4 columns
+        const float UI_WIDTH = 1300.0f;
+        const float UI_HEIGHT = 700.0f;
+        const float UI_X = (windowSize.x - UI_WIDTH) / 2.0f;
+        const float UI_Y = (windowSize.y - UI_HEIGHT) / 2.0f;
+        center_ = sf::Vector2f(UI_X + UI_WIDTH / 2.0f, UI_Y + UI_HEIGHT / 2.0f);
         
-        // Draw column title
-        sf::Text columnTitle;
-        columnTitle.setFont(font);
-        columnTitle.setString(categories[col].name);
-        columnTitle.setCharacterSize(static_cast<unsigned int>(26 * scale));
-        columnTitle.setFillColor(sf::Color(255, 200, 100, static_cast<sf::Uint8>(easedProgress * 255)));
-        sf::FloatRect columnTitleBounds = columnTitle.getLocalBounds();
-        columnTitle.setPosition(
-            columnX + (COLUMN_WIDTH - columnTitleBounds.width) / 2.0f - columnTitleBounds.left,
-            COLUMN_Y + 10.0f * scale
-        );
-        window.draw(columnTitle);
+        initRect(overlay_, sf::Vector2f(0.0f, 0.0f), sf::Vector2f(windowSize.x, windowSize.y),
+                 sf::Color(0, 0, 0, 180), sf::Color::Transparent, 0.0f);
+        initRect(panel_, sf::Vector2f(UI_X, UI_Y), sf::Vector2f(UI_WIDTH, UI_HEIGHT),
+                 sf::Color(40, 40, 40, 230), sf::Color(100, 100, 100), 3.0f);
         
-        // Draw weapons in this column
-        float weaponY = COLUMN_Y + 50.0f * scale;
-        const float WEAPON_HEIGHT = 110.0f * scale;
-        const float WEAPON_PADDING = 10.0f * scale;
+        initText(title_, "WEAPON SHOP", 40, sf::Color(255, 255, 255), 0.0f, UI_Y + 20.0f);
+        centerText(title_.text, UI_X, UI_WIDTH);
+        initText(money_, "", 28, sf::Color(100, 255, 100), UI_X + 20.0f, UI_Y + 70.0f);
         
-        for (Weapon::Type weaponType : categories[col].weapons) {
-            // Create weapon to get stats
-            Weapon* weapon = Weapon::create(weaponType);
-            
-            // Calculate purchase status
-            // Requirement 3.5: Show purchase status
-            PurchaseStatus status = calculatePurchaseStatus(player, weapon);
-            
-            // Draw weapon panel
-            sf::RectangleShape weaponPanel(sf::Vector2f(COLUMN_WIDTH - 20.0f * scale, WEAPON_HEIGHT));
-            weaponPanel.setPosition(columnX + 10.0f * scale, weaponY);
-            
-            // Color based on purchase status
-            if (status == PurchaseStatus::Purchasable) {
-                weaponPanel.setFillColor(sf::Color(50, 70, 50, alpha));  // Green tint
-                weaponPanel.setOutlineColor(sf::Color(100, 200, 100, static_cast<sf::Uint8>(easedProgress * 255)));
-            } else {
-                weaponPanel.setFillColor(sf::Color(50, 50, 50, alpha));  // Gray
-                weaponPanel.setOutlineColor(sf::Color(100, 100, 100, static_cast<sf::Uint8>(easedProgress * 255)));
-            }
-            weaponPanel.setOutlineThickness(1.0f);
-            window.draw(weaponPanel);
-            
-            // Draw weapon name
-            // Requirement 3.4: Display weapon name
-            sf::Text weaponName;
-            weaponName.setFont(font);
-            weaponName.setString(weapon->name);
-            weaponName.setCharacterSize(static_cast<unsigned int>(20 * scale));
-            weaponName.setFillColor(sf::Color(255, 255, 255, static_cast<sf::Uint8>(easedProgress * 255)));
-            weaponName.setPosition(columnX + 15.0f * scale, weaponY + 5.0f * scale);
-            window.draw(weaponName);
-            
-            // Draw weapon price
-            // Requirement 3.4: Display price
-            sf::Text weaponPrice;
-            weaponPrice.setFont(font);
-            weaponPrice.setString("$" + std::to_string(weapon->price));
-            weaponPrice.setCharacterSize(static_cast<unsigned int>(18 * scale));
-            weaponPrice.setFillColor(sf::Color(255, 215, 0, static_cast<sf::Uint8>(easedProgress * 255)));  // Gold color
-            weaponPrice.setPosition(columnX + 15.0f * scale, weaponY + 28.0f * scale);
-            window.draw(weaponPrice);
-            
-            // Draw weapon stats
-            // Requirement 3.4: Display damage and magazine size
-            sf::Text weaponStats;
-            weaponStats.setFont(font);
-            std::ostringstream statsStream;
-            statsStream << "Damage: " << static_cast<int>(weapon->damage) << "\n";
-            statsStream << "Magazine: " << weapon->magazineSize;
-            weaponStats.setString(statsStream.str());
-            weaponStats.setCharacterSize(static_cast<unsigned int>(16 * scale));
-            weaponStats.setFillColor(sf::Color(200, 200, 200, static_cast<sf::Uint8>(easedProgress * 255)));
-            weaponStats.setPosition(columnX + 15.0f * scale, weaponY + 50.0f * scale);
-            window.draw(weaponStats);
-            
-            // Draw purchase status
-            // Requirement 3.5: Show purchase status
-            sf::Text statusText;
-            statusText.setFont(font);
-            statusText.setString(getPurchaseStatusText(status, weapon->price));
-            statusText.setCharacterSize(static_cast<unsigned int>(14 * scale));
-            sf::Color statusColor = getPurchaseStatusColor(status);
-            statusText.setFillColor(sf::Color(statusColor.r, statusColor.g, statusColor.b, static_cast<sf::Uint8>(easedProgress * 255)));
-            statusText.setPosition(columnX + 15.0f * scale, weaponY + 90.0f * scale);
-            window.draw(statusText);
-            
-            // Check if mouse is hovering over this weapon slot
-            sf::Vector2i mousePixelPos = sf::Mouse::getPosition(window);
-            sf::FloatRect weaponBounds(
-                columnX + 10.0f * scale,
-                weaponY,
-                COLUMN_WIDTH - 20.0f * scale,
-                WEAPON_HEIGHT
-            );
+        // Column dimensions - now 4 columns
+        const float COLUMN_WIDTH = (UI_WIDTH - 100.0f) / 4.0f;
+        const float COLUMN_HEIGHT = UI_HEIGHT - 150.0f;
+        const float COLUMN_Y = UI_Y + 120.0f;
+        const float COLUMN_PADDING = 20.0f;
+        const float ROW_HEIGHT = 110.0f;
+        const float ROW_PADDING = 10.0f;
+        
+        // Requirement 3.3: Three weapon categories + one ammo category
+        struct WeaponCategory {
+            std::string name;
+            std::vector<Weapon::Type> weapons;
+        };
+        std::vector<WeaponCategory> categories = {
+            {"Pistols", {Weapon::USP, Weapon::GLOCK, Weapon::FIVESEVEN, Weapon::R8}},
+            {"Rifles", {Weapon::GALIL, Weapon::M4, Weapon::AK47}},
+            {"Snipers", {Weapon::M10, Weapon::AWP, Weapon::M40}}
+        };
+        std::vector<AmmoType> ammoTypes = {
+            AmmoType::AMMO_9x18,
+            AmmoType::AMMO_5_45x39,
+            AmmoType::AMMO_7_62x54
+        };
+        
+        for (size_t col = 0; col < columns_.size(); col++) {
+            Column& column = columns_[col];
+            column.rows.clear();
+            float columnX = UI_X + 20.0f + col * (COLUMN_WIDTH + COLUMN_PADDING);
+            initRect(column.background, sf::Vector2f(columnX, COLUMN_Y), sf::Vector2f(COLUMN_WIDTH, COLUMN_HEIGHT),
+                     sf::Color(30, 30, 30, 230), sf::Color(80, 80, 80), 2.0f);
+            initText(column.title, col < categories.size() ? categories[col].name : "Ammo", 26,
+                     sf::Color(255, 200, 100), 0.0f, COLUMN_Y + 10.0f);
+            centerText(column.title.text, columnX, COLUMN_WIDTH);
             
-            // If hovering, store weapon for tooltip rendering at the end
-            if (weaponBounds.contains(static_cast<float>(mousePixelPos.x), static_cast<float>(mousePixelPos.y))) {
-                // Delete previous hovered weapon if exists
-                if (hoveredWeapon != nullptr) {
-                    delete hoveredWeapon;
+            size_t rowCount = col < categories.size() ? categories[col].weapons.size() : ammoTypes.size();
+            column.rows.resize(rowCount);
+            float rowY = COLUMN_Y + 50.0f;
+            for (size_t r = 0; r < rowCount; r++) {
+                CatalogRow& row = column.rows[r];
+                row.bounds = sf::FloatRect(columnX + 10.0f, rowY, COLUMN_WIDTH - 20.0f, ROW_HEIGHT);
+                initRect(row.panel, sf::Vector2f(row.bounds.left, row.bounds.top), sf::Vector2f(row.bounds.width, row.bounds.height),
+                         sf::Color(50, 50, 50, 230), sf::Color(100, 100, 100), 1.0f);
+                
+                float textX = columnX + 15.0f;
+                if (col < categories.size()) {
+                    // Requirement 3.4: Display weapon name, price, damage and magazine size
+                    row.weapon.reset(Weapon::create(categories[col].weapons[r]));
+                    const Weapon& weapon = *row.weapon;
+                    std::ostringstream statsStream;
+                    statsStream << "Damage: " << static_cast<int>(weapon.damage) << "\n";
+                    statsStream << "Magazine: " << weapon.magazineSize;
+                    initText(row.name, weapon.name, 20, sf::Color(255, 255, 255), textX, rowY + 5.0f);
+                    initText(row.price, "$" + std::to_string(weapon.price), 18, sf::Color(255, 215, 0), textX, rowY + 28.0f);
+                    initText(row.details, statsStream.str(), 16, sf::Color(200, 200, 200), textX, rowY + 50.0f);
+                    initText(row.status, "", 14, sf::Color::White, textX, rowY + 90.0f);
+                } else {
+                    row.ammo.reset(AmmoItem::create(ammoTypes[r]));
+                    const AmmoItem& ammo = *row.ammo;
+                    initText(row.name, ammo.name, 18, sf::Color(255, 255, 255), textX, rowY + 5.0f);
+                    initText(row.price, "$" + std::to_string(ammo.price), 18, sf::Color(255, 215, 0), textX, rowY + 28.0f);
+                    initText(row.details, "Quantity: " + std::to_string(ammo.quantity), 16, sf::Color(200, 200, 200), textX, rowY + 50.0f);
+                    initText(row.status, "", 14, sf::Color::White, textX, rowY + 75.0f);
                 }
-                // Store this weapon for tooltip (don't delete it yet)
-                hoveredWeapon = weapon;
-                hoveredMouseX = static_cast<float>(mousePixelPos.x);
-                hoveredMouseY = static_cast<float>(mousePixelPos.y);
-            } else {
-                // Not hovering, delete weapon as usual
-                delete weapon;
+                rowY += ROW_HEIGHT + ROW_PADDING;
             }
-            
-            weaponY += WEAPON_HEIGHT + WEAPON_PADDING;
         }
     }
     
-    // Draw ammo column (4th column)
-    {
-        float columnX = scaledX + 20.0f * scale + 3 * (COLUMN_WIDTH + COLUMN_PADDING);
+    // Ammo row status: 0 can purchase, 1 no compatible weapon, 2 insufficient funds
+    static int ammoState(const Player& player, const AmmoItem& ammo) {
+        bool hasCompatibleWeapon = false;
+        for (int i = 0; i < 4; i++) {
+            if (player.inventory[i] != nullptr && player.inventory[i]->getAmmoType() == ammo.type) {
+                hasCompatibleWeapon = true;
+                break;
+            }
+        }
+        if (!hasCompatibleWeapon) return 1;
+        if (player.money < ammo.price) return 2;
+        return 0;
+    }
+    
+    // Requirement 3.5: Show purchase status (text, text color, panel tint)
+    void setRowState(CatalogRow& row, int state) {
+        bool purchasable;
+        if (row.weapon) {
+            PurchaseStatus status = static_cast<PurchaseStatus>(state);
+            purchasable = (status == PurchaseStatus::Purchasable);
+            row.status.text.setString(getPurchaseStatusText(status, row.weapon->price));
+            row.status.color = getPurchaseStatusColor(status);
+        } else {
+            purchasable = (state == 0);
+            row.status.text.setString(state == 1 ? "No compatible weapon" : state == 2 ? "Insufficient funds" : "Can purchase");
+            row.status.color = purchasable ? sf::Color(100, 255, 100) : sf::Color(255, 100, 100);
+        }
         
-        // Draw column background
-        sf::RectangleShape columnBg(sf::Vector2f(COLUMN_WIDTH, COLUMN_HEIGHT));
-        columnBg.setPosition(columnX, COLUMN_Y);
-        columnBg.setFillColor(sf::Color(30, 30, 30, alpha));
-        columnBg.setOutlineColor(sf::Color(80, 80, 80, static_cast<sf::Uint8>(easedProgress * 255)));
-        columnBg.setOutlineThickness(2.0f);
-        window.draw(columnBg);
+        if (purchasable) {
+            row.panel.fill = sf::Color(50, 70, 50, 230);      // Green tint
+            row.panel.outline = sf::Color(100, 200, 100);
+        } else {
+            row.panel.fill = sf::Color(50, 50, 50, 230);      // Gray
+            row.panel.outline = sf::Color(100, 100, 100);
+        }
+        fadeText(row.status);
+        fadeRect(row.panel);
+    }
+    
+    void applyFade() {
+        fadeRect(overlay_);
+        fadeRect(panel_);
+        fadeText(title_);
+        fadeText(money_);
+        for (Column& column : columns_) {
+            fadeRect(column.background);
+            fadeText(column.title);
+            for (CatalogRow& row : column.rows) {
+                fadeRect(row.panel);
+                fadeText(row.name);
+                fadeText(row.price);
+                fadeText(row.details);
+                fadeText(row.status);
+            }
+        }
+    }
+    
+    sf::Color faded(sf::Color color) const {
+        return sf::Color(color.r, color.g, color.b, static_cast<sf::Uint8>(fade_ * color.a));
+    }
+    
+    void fadeText(FadedText& text) const {
+        text.text.setFillColor(faded(text.color));
+    }
+    
+    void fadeRect(FadedRect& rect) const {
+        rect.shape.setFillColor(faded(rect.fill));
+        rect.shape.setOutlineColor(faded(rect.outline));
+    }
+    
+    void initText(FadedText& text, const std::string& string, unsigned int size, sf::Color color, float x, float y) const {
+        text.text.setFont(*font_);
+        text.text.setString(string);
+        text.text.setCharacterSize(size);
+        text.text.setPosition(x, y);
+        text.color = color;
+    }
+    
+    static void initRect(FadedRect& rect, sf::Vector2f position, sf::Vector2f size,
+                         sf::Color fill, sf::Color outline, float outlineThickness) {
+        rect.shape.setSize(size);
+        rect.shape.setPosition(position);
+        rect.shape.setOutlineThickness(outlineThickness);
+        rect.fill = fill;
+        rect.outline = outline;
+    }
+    
+    // Center horizontally within [left, left + width]
+    static void centerText(sf::Text& text, float left, float width) {
+        sf::FloatRect bounds = text.getLocalBounds();
+        text.setPosition(left + (width - bounds.width) / 2.0f - bounds.left, text.getPosition().y);
+    }
+    
+    // Tooltip layouts: built once per catalog entry at the origin, drawn translated
+    std::unique_ptr<Tooltip> newTooltip(float width, float height) const {
+        const float PADDING = 15.0f;
+        std::unique_ptr<Tooltip> tooltip(new Tooltip());
+        tooltip->background.setSize(sf::Vector2f(width, height));
+        tooltip->background.setFillColor(sf::Color(20, 20, 20, 240));
+        tooltip->background.setOutlineColor(sf::Color(255, 215, 0));  // Gold border
+        tooltip->background.setOutlineThickness(2.0f);
+        tooltip->separator.setSize(sf::Vector2f(width - 2 * PADDING, 1.0f));
+        tooltip->separator.setPosition(PADDING, PADDING + 65.0f);
+        tooltip->separator.setFillColor(sf::Color(100, 100, 100));
+        return tooltip;
+    }
+    
+    void addTooltipText(Tooltip& tooltip, const std::string& string, unsigned int size, sf::Color color,
+                        float x, float y, bool bold = false) const {
+        sf::Text text;
+        text.setFont(*font_);
+        text.setString(string);
+        text.setCharacterSize(size);
+        text.setFillColor(color);
+        if (bold) text.setStyle(sf::Text::Bold);
+        text.setPosition(x, y);
+        tooltip.texts.push_back(text);
+    }
+    
+    // Weapon tooltip with full stats
+    std::unique_ptr<Tooltip> buildWeaponTooltip(const Weapon& weapon) const {
+        const float PADDING = 15.0f;
+        std::unique_ptr<Tooltip> tooltip = newTooltip(320.0f, 290.0f);
+        addTooltipText(*tooltip, weapon.name, 24, sf::Color(255, 215, 0), PADDING, PADDING, true);
+        addTooltipText(*tooltip, "Price: $" + std::to_string(weapon.price), 20, sf::Color(100, 255, 100), PADDING, PADDING + 35.0f);
         
-        // Draw column title
-        sf::Text columnTitle;
-        columnTitle.setFont(font);
-        columnTitle.setString("Ammo");
-        columnTitle.setCharacterSize(static_cast<unsigned int>(26 * scale));
-        columnTitle.setFillColor(sf::Color(255, 200, 100, static_cast<sf::Uint8>(easedProgress * 255)));
-        sf::FloatRect columnTitleBounds = columnTitle.getLocalBounds();
-        columnTitle.setPosition(
-            columnX + (COLUMN_WIDTH - columnTitleBounds.width) / 2.0f - columnTitleBounds.left,
-            COLUMN_Y + 10.0f * scale
-        );
-        window.draw(columnTitle);
+        // Stats - format floats properly
+        std::ostringstream reloadStream, moveStream;
+        reloadStream << std::fixed << std::setprecision(1) << weapon.reloadTime;
+        moveStream << std::fixed << std::setprecision(1) << weapon.movementSpeed;
         
-        // Draw ammo items
-        float ammoY = COLUMN_Y + 50.0f * scale;
-        const float AMMO_HEIGHT = 110.0f * scale;
-        const float AMMO_PADDING = 10.0f * scale;
+        std::vector<std::pair<std::string, std::string>> stats = {
+            {"Damage:", std::to_string(static_cast<int>(weapon.damage))},
+            {"Magazine:", std::to_string(weapon.magazineSize)},
+            {"Range:", std::to_string(static_cast<int>(weapon.range)) + " px"},
+            {"Bullet Speed:", std::to_string(static_cast<int>(weapon.bulletSpeed)) + " px/s"},
+            {"Reload Time:", reloadStream.str() + " s"},
+            {"Movement Speed:", moveStream.str()},
+            {"Fire Mode:", weapon.isAutomatic() ? "Automatic (" + std::to_string(static_cast<int>(weapon.fireRate)) + " rps)" : "Semi-Auto"}
+        };
         
-        for (AmmoType ammoType : ammoTypes) {
-            // Create ammo item to get stats
-            AmmoItem* ammo = AmmoItem::create(ammoType);
-            
-            // Check if player has weapon for this ammo type
-            bool hasCompatibleWeapon = false;
-            for (int i = 0; i < 4; i++) {
-                if (player.inventory[i] != nullptr) {
-                    if (player.inventory[i]->getAmmoType() == ammoType) {
-                        hasCompatibleWeapon = true;
-                        break;
-                    }
-                }
-            }
-            
-            // Check if player has enough money
-            bool canAfford = player.money >= ammo->price;
-            
-            // Draw ammo panel
-            sf::RectangleShape ammoPanel(sf::Vector2f(COLUMN_WIDTH - 20.0f * scale, AMMO_HEIGHT));
-            ammoPanel.setPosition(columnX + 10.0f * scale, ammoY);
-            
-            // Color based on purchase status
-            if (hasCompatibleWeapon && canAfford) {
-                ammoPanel.setFillColor(sf::Color(50, 70, 50, alpha));  // Green tint
-                ammoPanel.setOutlineColor(sf::Color(100, 200, 100, static_cast<sf::Uint8>(easedProgress * 255)));
-            } else {
-                ammoPanel.setFillColor(sf::Color(50, 50, 50, alpha));  // Gray
-                ammoPanel.setOutlineColor(sf::Color(100, 100, 100, static_cast<sf::Uint8>(easedProgress * 255)));
-            }
-            ammoPanel.setOutlineThickness(1.0f);
-            window.draw(ammoPanel);
-            
-            // Draw ammo name
-            sf::Text ammoName;
-            ammoName.setFont(font);
-            ammoName.setString(ammo->name);
-            ammoName.setCharacterSize(static_cast<unsigned int>(18 * scale));
-            ammoName.setFillColor(sf::Color(255, 255, 255, static_cast<sf::Uint8>(easedProgress * 255)));
-            ammoName.setPosition(columnX + 15.0f * scale, ammoY + 5.0f * scale);
-            window.draw(ammoName);
-            
-            // Draw ammo price
-            sf::Text ammoPrice;
-            ammoPrice.setFont(font);
-            ammoPrice.setString("$" + std::to_string(ammo->price));
-            ammoPrice.setCharacterSize(static_cast<unsigned int>(18 * scale));
-            ammoPrice.setFillColor(sf::Color(255, 215, 0, static_cast<sf::Uint8>(easedProgress * 255)));
-            ammoPrice.setPosition(columnX + 15.0f * scale, ammoY + 28.0f * scale);
-            window.draw(ammoPrice);
-            
-            // Draw ammo quantity
-            sf::Text ammoQuantity;
-            ammoQuantity.setFont(font);
-            ammoQuantity.setString("Quantity: " + std::to_string(ammo->quantity));
-            ammoQuantity.setCharacterSize(static_cast<unsigned int>(16 * scale));
-            ammoQuantity.setFillColor(sf::Color(200, 200, 200, static_cast<sf::Uint8>(easedProgress * 255)));
-            ammoQuantity.setPosition(columnX + 15.0f * scale, ammoY + 50.0f * scale);
-            window.draw(ammoQuantity);
-            
-            // Draw purchase status
-            sf::Text statusText;
-            statusText.setFont(font);
-            if (!hasCompatibleWeapon) {
-                statusText.setString("No compatible weapon");
-                statusText.setFillColor(sf::Color(255, 100, 100, static_cast<sf::Uint8>(easedProgress * 255)));
-            } else if (!canAfford) {
-                statusText.setString("Insufficient funds");
-                statusText.setFillColor(sf::Color(255, 100, 100, static_cast<sf::Uint8>(easedProgress * 255)));
-            } else {
-                statusText.setString("Can purchase");
-                statusText.setFillColor(sf::Color(100, 255, 100, static_cast<sf::Uint8>(easedProgress * 255)));
-            }
-            statusText.setCharacterSize(static_cast<unsigned int>(14 * scale));
-            statusText.setPosition(columnX + 15.0f * scale, ammoY + 75.0f * scale);
-            window.draw(statusText);
-            
-            // Check if mouse is hovering over this ammo slot
-            sf::Vector2i mousePixelPos = sf::Mouse::getPosition(window);
-            sf::FloatRect ammoBounds(
-                columnX + 10.0f * scale,
-                ammoY,
-                COLUMN_WIDTH - 20.0f * scale,
-                AMMO_HEIGHT
-            );
-            
-            // If hovering, store ammo for tooltip rendering at the end
-            if (ammoBounds.contains(static_cast<float>(mousePixelPos.x), static_cast<float>(mousePixelPos.y))) {
-                // Delete previous hovered ammo if exists
-                if (hoveredAmmo != nullptr) {
-                    delete hoveredAmmo;
-                }
-                // Store this ammo for tooltip (don't delete it yet)
-                hoveredAmmo = ammo;
-                hoveredMouseX = static_cast<float>(mousePixelPos.x);
-                hoveredMouseY = static_cast<float>(mousePixelPos.y);
-            } else {
-                // Not hovering, delete ammo as usual
-                delete ammo;
-            }
-            
-            ammoY += AMMO_HEIGHT + AMMO_PADDING;
+        float textY = PADDING + 75.0f;
+        for (const auto& stat : stats) {
+            addTooltipText(*tooltip, stat.first, 16, sf::Color(200, 200, 200), PADDING, textY);
+            addTooltipText(*tooltip, stat.second, 16, sf::Color::White, PADDING + 150.0f, textY, true);
+            textY += 22.0f;
         }
+        return tooltip;
     }
     
-    // Render tooltips at the very end to ensure they're on top of all other UI elements
-    if (hoveredWeapon != nullptr) {
-        renderWeaponTooltip(window, hoveredWeapon, hoveredMouseX, hoveredMouseY, font);
-        delete hoveredWeapon;  // Clean up after rendering
+    // Ammo tooltip with full information
+    std::unique_ptr<Tooltip> buildAmmoTooltip(const AmmoItem& ammo) const {
+        const float PADDING = 15.0f;
+        std::unique_ptr<Tooltip> tooltip = newTooltip(320.0f, 220.0f);
+        addTooltipText(*tooltip, ammo.name, 24, sf::Color(255, 215, 0), PADDING, PADDING, true);
+        addTooltipText(*tooltip, "Price: $" + std::to_string(ammo.price), 20, sf::Color(100, 255, 100), PADDING, PADDING + 35.0f);
+        addTooltipText(*tooltip, "Quantity: " + std::to_string(ammo.quantity) + " bullets", 18, sf::Color::White, PADDING, PADDING + 75.0f);
+        addTooltipText(*tooltip, "Compatible with:", 18, sf::Color(200, 200, 200), PADDING, PADDING + 105.0f);
+        
+        // List compatible weapon types
+        std::string weaponList;
+        switch (ammo.type) {
+            case AmmoType::AMMO_9x18:
+                weaponList = "-> Pistols:\n  USP, Glock-18,\n  Five-SeveN, R8 Revolver";
+                break;
+            case AmmoType::AMMO_5_45x39:
+                weaponList = "-> Rifles:\n  Galil AR, M4, AK-47";
+                break;
+            case AmmoType::AMMO_7_62x54:
+                weaponList = "-> Sniper Rifles:\n  M10, AWP, M40";
+                break;
+        }
+        addTooltipText(*tooltip, weaponList, 16, sf::Color(150, 200, 255), PADDING, PADDING + 130.0f);  // Light blue
+        return tooltip;
     }
     
-    if (hoveredAmmo != nullptr) {
-        renderAmmoTooltip(window, hoveredAmmo, hoveredMouseX, hoveredMouseY, font);
-        delete hoveredAmmo;  // Clean up after rendering
+    // Position tooltip near mouse, but keep it on screen
+    void drawTooltip(sf::RenderWindow& window, const Tooltip& tooltip, float mouseX, float mouseY) const {
+        // Reserve space for UI elements at bottom (150px for "Press B" and "E - inventory")
+        const float BOTTOM_UI_RESERVE = 150.0f;
+        sf::Vector2f size = tooltip.background.getSize();
+        
+        float tooltipX = mouseX + 20.0f;
+        float tooltipY = mouseY + 20.0f;
+        
+        // Adjust if tooltip goes off screen
+        if (tooltipX + size.x > windowSize_.x - 10.0f) {
+            tooltipX = mouseX - size.x - 20.0f;
+        }
+        if (tooltipY + size.y > windowSize_.y - BOTTOM_UI_RESERVE) {
+            // Position above cursor if would overlap bottom UI
+            tooltipY = mouseY - size.y - 20.0f;
+        }
+        if (tooltipX < 10.0f) tooltipX = 10.0f;
+        if (tooltipY < 10.0f) tooltipY = 10.0f;
+        
+        sf::RenderStates states;
+        states.transform.translate(tooltipX, tooltipY);
+        window.draw(tooltip.background, states);
+        window.draw(tooltip.separator, states);
+        for (const sf::Text& text : tooltip.texts) {
+            window.draw(text, states);
+        }
     }
+    
+    const sf::Font* font_ = nullptr;
+    sf::Vector2u windowSize_;
+    sf::Vector2f center_;                // Panel centre, the animation's scale origin
+    float fade_ = -1.0f;                 // easedProgress the colors were faded to
+    int shownMoney_ = 0;
+    FadedRect overlay_;
+    FadedRect panel_;
+    FadedText title_;
+    FadedText money_;
+    std::array<Column, 4> columns_;      // Pistols, Rifles, Snipers, Ammo
+};
+
+// Global shop UI layer (render thread only)
+ShopUILayer g_shopUI;
+
+// Render shop UI with four columns (three for weapons, one for ammo)
+// Requirements: 3.2, 3.3, 3.4, 3.5
+void renderShopUI(sf::RenderWindow& window, const Player& player, const sf::Font& font, float animationProgress) {
+    g_shopUI.render(window, player, font, animationProgress);
 }
 
 bool isButtonClicked(const sf::RectangleShape& button, const sf::Event& event, const sf::RenderWindow& window) {
@@ -3519,7 +5847,7 @@ int main() {
     
     // Clock for delta time calculation
     sf::Clock deltaClock;
-    float interpolationAlpha = 0.0f;
+    float inputAccumulator = 0.0f; // Frame time not yet turned into input commands
     
     // Performance monitoring
     PerformanceMonitor perfMonitor;
@@ -3726,12 +6054,19 @@ int main() {
                             PurchaseStatus status = calculatePurchaseStatus(clientPlayer, weapon);
                             
                             if (status == PurchaseStatus::Purchasable) {
-                                // Process purchase locally
+                                // Process purchase locally; the server confirms it (see applyInventoryMessage)
+                                const int slot = clientPlayer.getFirstEmptySlot();
                                 bool success = processPurchase(clientPlayer, weaponType);
                                 
                                 if (success) {
                                     ErrorHandler::logInfo("Client player purchased " + weapon->name);
                                     
+                                    PendingPurchase purchase;
+                                    purchase.price = weapon->price;
+                                    purchase.slot = slot;
+                                    purchase.weaponType = weaponType;
+                                    sendPurchase(purchase);
+                                    
                                     // Create purchase notification text
                                     {
                                         std::lock_guard<std::mutex> lock(purchaseTextsMutex);
@@ -3794,12 +6129,17 @@ int main() {
                             }
                             
                             if (hasCompatibleWeapon && clientPlayer.money >= ammo->price) {
-                                // Process ammo purchase
+                                // Process ammo purchase; the server confirms it (see applyInventoryMessage)
                                 bool success = processAmmoPurchase(clientPlayer, ammoType);
                                 
                                 if (success) {
                                     ErrorHandler::logInfo("Client player purchased " + ammo->name);
                                     
+                                    PendingPurchase purchase;
+                                    purchase.price = ammo->price;
+                                    purchase.ammoType = static_cast<int>(ammoType);
+                                    sendPurchase(purchase);
+                                    
                                     // Create purchase notification text
                                     {
                                         std::lock_guard<std::mutex> lock(purchaseTextsMutex);
@@ -4133,6 +6473,12 @@ int main() {
                         if (startPacket.type == MessageType::SERVER_START) {
                             ErrorHandler::logInfo("✓ Valid StartPacket received from server!");
                             
+                            // Snapshot ticks are converted to time for interpolation
+                            if (startPacket.tickRate > 0) {
+                                std::lock_guard<std::mutex> lock(mutex);
+                                snapshotClock.setTickRate(startPacket.tickRate);
+                            }
+                            
                             // Start UDP thread for position synchronization
                             if (!udpThreadStarted) {
                                 lastPacketReceived.restart(); // Initialize connection timeout timer
@@ -4195,48 +6541,51 @@ int main() {
             
             // Update performance monitoring
             size_t playerCount = serverConnected ? 2 : 1; // Client + server (if connected)
-            // Count walls in the grid (approximate - each cell can have 0-4 walls)
-            size_t wallCount = 0;
-            for (int i = 0; i < GRID_SIZE; i++) {
-                for (int j = 0; j < GRID_SIZE; j++) {
-                    if (grid[i][j].topWall != WallType::None) wallCount++;
-                    if (grid[i][j].rightWall != WallType::None) wallCount++;
-                    if (grid[i][j].bottomWall != WallType::None) wallCount++;
-                    if (grid[i][j].leftWall != WallType::None) wallCount++;
-                }
-            }
-            perfMonitor.update(deltaTime, playerCount, wallCount);
+            // Count walls in the grid (one popcount per 32 edges)
+            size_t wallCount = grid.countWalls();
+            perfMonitor.update(deltaTime, playerCount, wallCount, shopUIOpen);
             
             // Handle client player movement (input isolation - client controls only blue circle)
-            if (window.hasFocus()) {
-                // Store previous position for interpolation
-                clientPosPrevious.x = clientPos.x;
-                clientPosPrevious.y = clientPos.y;
-                
-                sf::Vector2f oldPos(clientPos.x, clientPos.y);
-                sf::Vector2f newPos = oldPos;
-                
-                // Handle WASD input with delta time for frame-independent movement
-                // Requirements: 5.3, 5.4 - Use weapon-modified movement speed
-                float currentSpeed = clientPlayer.getMovementSpeed();
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::W)) newPos.y -= currentSpeed * deltaTime * 60.0f;
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::S)) newPos.y += currentSpeed * deltaTime * 60.0f;
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::A)) newPos.x -= currentSpeed * deltaTime * 60.0f;
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::D)) newPos.x += currentSpeed * deltaTime * 60.0f;
+            // Controls are sampled into input commands at INPUT_RATE; each one is
+            // predicted locally and sent to the server, which simulates the same
+            // commands and corrects us through its acks (see InputPredictor)
+            inputAccumulator = std::min(inputAccumulator + deltaTime, 0.25f);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
                 
-                // Apply cell-based collision detection with walls
-                // The new system uses the grid directly instead of the old GameMap
-                newPos = resolveCollisionCellBased(oldPos, newPos, grid);
+                sf::Vector2f position(clientPos.x, clientPos.y);
+                if (inputPredictor.reconcile(position, grid)) {
+                    clientPos.x = position.x;
+                    clientPos.y = position.y;
+                }
                 
-                // Update client position
-                {
-                    std::lock_guard<std::mutex> lock(mutex);
-                    clientPos.x = newPos.x;
-                    clientPos.y = newPos.y;
-                    // Update player position for weapon firing
-                    clientPlayer.x = newPos.x;
-                    clientPlayer.y = newPos.y;
+                while (inputAccumulator >= INPUT_STEP) {
+                    inputAccumulator -= INPUT_STEP;
+                    
+                    // WASD only with focus; dead players wait for respawn
+                    uint8_t buttons = 0;
+                    if (window.hasFocus() && clientIsAlive) {
+                        if (sf::Keyboard::isKeyPressed(sf::Keyboard::W)) buttons |= INPUT_UP;
+                        if (sf::Keyboard::isKeyPressed(sf::Keyboard::S)) buttons |= INPUT_DOWN;
+                        if (sf::Keyboard::isKeyPressed(sf::Keyboard::A)) buttons |= INPUT_LEFT;
+                        if (sf::Keyboard::isKeyPressed(sf::Keyboard::D)) buttons |= INPUT_RIGHT;
+                    }
+                    
+                    // Requirements: 5.3, 5.4 - The active weapon sets the movement speed
+                    Weapon* activeWeapon = clientPlayer.getActiveWeapon();
+                    buttons |= static_cast<uint8_t>((activeWeapon ? activeWeapon->type + 1 : 0) << 4);
+                    
+                    // Store previous position for interpolation
+                    clientPosPrevious = clientPos;
+                    position = inputPredictor.predict(sf::Vector2f(clientPos.x, clientPos.y), buttons,
+                                                      quantizeAim(clientPlayer.rotation), grid);
+                    clientPos.x = position.x;
+                    clientPos.y = position.y;
                 }
+                
+                // Update player position for weapon firing
+                clientPlayer.x = clientPos.x;
+                clientPlayer.y = clientPos.y;
             }
             
             // Update weapon reload state
@@ -4367,15 +6716,12 @@ int main() {
                 );
             }
             
-            // Update interpolation alpha for smooth rendering
-            interpolationAlpha += deltaTime * 10.0f; // Adjust multiplier for smoothness
-            if (interpolationAlpha > 1.0f) interpolationAlpha = 1.0f;
-            
-            // Use interpolated position for rendering smooth movement
+            // Interpolate between the last two input steps for smooth rendering
+            // at any frame rate (the player is drawn up to one step behind)
             sf::Vector2f renderPos = lerpPosition(
                 sf::Vector2f(clientPosPrevious.x, clientPosPrevious.y),
                 sf::Vector2f(clientPos.x, clientPos.y),
-                interpolationAlpha
+                inputAccumulator / INPUT_STEP
             );
             
             // Update camera to follow the local player (blue circle)
@@ -4395,20 +6741,53 @@ int main() {
             // Get server position for rendering with interpolation
             sf::Vector2f currentServerPos;
             bool isServerConnected = false;
+            std::vector<EntityState> visibleRemotePlayers;
             {
                 std::lock_guard<std::mutex> lock(mutex);
                 
-                // Interpolate server position for smooth movement
-                // This prevents jerky movement when receiving position updates at 20Hz
-                // We interpolate between the previous and target positions
-                const float serverInterpolationSpeed = 15.0f; // Higher = faster catch-up
-                float serverAlpha = std::min(1.0f, deltaTime * serverInterpolationSpeed);
+                // Remote players are drawn interpolation-delay seconds behind the
+                // server, between the buffered snapshots around that time, so late
+                // or reordered packets do not show (see SnapshotClock / SnapshotTrack)
+                const double renderTick = snapshotClock.advance(gameClock.getElapsedTime().asSeconds(), deltaTime);
+                const double maxExtrapolationTicks = MAX_EXTRAPOLATION / snapshotClock.tickDuration();
+                bool extrapolated = false;
                 
-                serverPos.x = lerp(serverPos.x, serverPosTarget.x, serverAlpha);
-                serverPos.y = lerp(serverPos.y, serverPosTarget.y, serverAlpha);
+                EntityState sampled;
+                SnapshotTrack::Result result = serverTrack.sample(renderTick, maxExtrapolationTicks, sampled);
+                if (result != SnapshotTrack::Result::Empty) {
+                    serverPos.x = sampled.x;
+                    serverPos.y = sampled.y;
+                    serverPlayer.rotation = sampled.rotation;
+                    extrapolated = extrapolated || result == SnapshotTrack::Result::Extrapolated;
+                }
                 
                 currentServerPos = sf::Vector2f(serverPos.x, serverPos.y);
-                isServerConnected = serverConnected;
+                isServerConnected = serverConnected && serverPlayerPresent;
+                
+                // Sample other clients the same way and drop stale ones
+                for (auto it = remotePlayers.begin(); it != remotePlayers.end(); ) {
+                    if (it->second.lastUpdate.getElapsedTime().asSeconds() > 1.0f) {
+                        it = remotePlayers.erase(it);
+                        continue;
+                    }
+                    RemotePlayer& remote = it->second;
+                    result = remote.track.sample(renderTick, maxExtrapolationTicks, sampled);
+                    if (result != SnapshotTrack::Result::Empty) {
+                        remote.pos.x = sampled.x;
+                        remote.pos.y = sampled.y;
+                        remote.rotation = sampled.rotation;
+                        remote.isAlive = sampled.isAlive;
+                        extrapolated = extrapolated || result == SnapshotTrack::Result::Extrapolated;
+                        if (remote.isAlive) {
+                            visibleRemotePlayers.push_back(sampled);
+                        }
+                    }
+                    ++it;
+                }
+                
+                if (snapshotClock.synced()) {
+                    perfMonitor.recordInterpolation(snapshotClock.delay(), snapshotClock.jitter(), extrapolated);
+                }
             }
             
             // Render visible walls using cell-based system
@@ -4465,6 +6844,23 @@ int main() {
                 }
             }
             
+            // Draw other clients with the same fog of war and line of sight rules
+            if (textureLoaded) {
+                for (const auto& remote : visibleRemotePlayers) {
+                    sf::Vector2f remotePos(remote.x, remote.y);
+                    float dx = remotePos.x - clientPos.x;
+                    float dy = remotePos.y - clientPos.y;
+                    sf::Uint8 alpha = calculateFogAlpha(std::sqrt(dx * dx + dy * dy));
+                    
+                    if (alpha > 0 && hasLineOfSight(sf::Vector2f(clientPos.x, clientPos.y), remotePos, grid)) {
+                        serverSprite.setColor(sf::Color(255, 255, 255, alpha));
+                        serverSprite.setPosition(remotePos.x, remotePos.y);
+                        serverSprite.setRotation(remote.rotation - 90.0f);
+                        window.draw(serverSprite);
+                    }
+                }
+            }
+            
             // Requirement 7.1: Render bullets as sprites with texture
             {
                 std::lock_guard<std::mutex> lock(bulletsMutex);
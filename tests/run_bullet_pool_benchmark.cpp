@@ -0,0 +1,489 @@
+// Bullet Pool Tests and Microbenchmark for Zero Ground
+// Compares the SoA BulletPool (SIMD integrate + swap-remove cull) against the
+// previous std::vector<Bullet> path (per-bullet sqrt + erase(remove_if))
+// at 1k/10k/100k bullets.
+//
+// BulletPool is copied from Zero_Ground.cpp. Build with /O2 (or -O2); add
+// /arch:AVX (or -mavx) to benchmark the AVX kernel instead of SSE2.
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define ZG_BULLETS_AVX 1
+#define ZG_BULLETS_SSE 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ZG_BULLETS_SSE 1
+#endif
+
+// ========================
+// Test Framework Macros
+// ========================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "Running test: " << #name << "..."; \
+    try { \
+        test_##name(); \
+        std::cout << " PASSED" << std::endl; \
+        passedTests++; \
+    } catch (const std::exception& e) { \
+        std::cout << " FAILED: " << e.what() << std::endl; \
+        failedTests++; \
+    } \
+    totalTests++; \
+} while(0)
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: " << #condition << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_NEAR(expected, actual, epsilon) do { \
+    if (std::abs((expected) - (actual)) > (epsilon)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << (expected) << " but got " << (actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+// Test counters
+int totalTests = 0;
+int passedTests = 0;
+int failedTests = 0;
+
+// ========================
+// Structures (copied from main code)
+// ========================
+
+const float MAP_SIZE = 5100.0f;
+
+namespace Weapon {
+    enum Type { USP = 0, GLOCK = 1, FIVESEVEN = 2, R8 = 3, GALIL = 4, M4 = 5, AK47 = 6, M10 = 7, AWP = 8, M40 = 9 };
+}
+
+// Previous bullet representation (sf::Clock replaced by a steady_clock time point)
+struct Bullet {
+    uint8_t ownerId = 0;
+    float x = 0.0f;
+    float y = 0.0f;
+    float prevX = 0.0f;
+    float prevY = 0.0f;
+    float vx = 0.0f;
+    float vy = 0.0f;
+    float damage = 0.0f;
+    float range = 0.0f;
+    float maxRange = 0.0f;
+    Weapon::Type weaponType = Weapon::USP;
+    std::chrono::steady_clock::time_point lifetime;
+
+    void update(float deltaTime) {
+        prevX = x;
+        prevY = y;
+        x += vx * deltaTime;
+        y += vy * deltaTime;
+        float distanceTraveled = std::sqrt(vx * vx + vy * vy) * deltaTime;
+        range -= distanceTraveled;
+    }
+
+    bool shouldRemove() const {
+        if (range <= 0.0f) return true;
+        if (x < 0.0f || x > 5100.0f || y < 0.0f || y > 5100.0f) return true;
+        return false;
+    }
+};
+
+// ========================
+// Bullet Pool (Structure of Arrays)
+// ========================
+
+class BulletPool {
+public:
+    explicit BulletPool(size_t capacity) : capacity_(capacity), count_(0) {
+        size_t padded = (capacity + 7) & ~static_cast<size_t>(7);
+        for (std::vector<float>* field : { &x_, &y_, &prevX_, &prevY_, &vx_, &vy_, &speed_, &range_, &maxRange_, &damage_ }) {
+            field->assign(padded, 0.0f);
+        }
+        ownerId_.assign(padded, 0);
+        weaponType_.assign(padded, 0);
+    }
+    
+    // Add a bullet; returns false if the pool is full
+    bool spawn(const Bullet& bullet) {
+        if (count_ >= capacity_) {
+            return false;
+        }
+        size_t i = count_++;
+        x_[i] = bullet.x;
+        y_[i] = bullet.y;
+        prevX_[i] = bullet.prevX;
+        prevY_[i] = bullet.prevY;
+        vx_[i] = bullet.vx;
+        vy_[i] = bullet.vy;
+        speed_[i] = std::sqrt(bullet.vx * bullet.vx + bullet.vy * bullet.vy);
+        range_[i] = bullet.range;
+        maxRange_[i] = bullet.maxRange;
+        damage_[i] = bullet.damage;
+        ownerId_[i] = bullet.ownerId;
+        weaponType_[i] = static_cast<uint8_t>(bullet.weaponType);
+        return true;
+    }
+    
+    size_t size() const { return count_; }
+    size_t capacity() const { return capacity_; }
+    bool empty() const { return count_ == 0; }
+    void clear() { count_ = 0; }
+    
+    // Count live bullets fired by one player (per-player bullet limit)
+    int countOwnedBy(uint8_t ownerId) const {
+        int count = 0;
+        for (size_t i = 0; i < count_; ++i) {
+            if (ownerId_[i] == ownerId) count++;
+        }
+        return count;
+    }
+    
+    float x(size_t i) const { return x_[i]; }
+    float y(size_t i) const { return y_[i]; }
+    float prevX(size_t i) const { return prevX_[i]; }
+    float prevY(size_t i) const { return prevY_[i]; }
+    float vx(size_t i) const { return vx_[i]; }
+    float vy(size_t i) const { return vy_[i]; }
+    float range(size_t i) const { return range_[i]; }
+    float damage(size_t i) const { return damage_[i]; }
+    uint8_t ownerId(size_t i) const { return ownerId_[i]; }
+    
+    // Mark a bullet for removal by the next cull()
+    void kill(size_t i) { range_[i] = 0.0f; }
+    
+    // Scale velocity and remaining range (wooden walls)
+    void slowDown(size_t i, float factor) {
+        vx_[i] *= factor;
+        vy_[i] *= factor;
+        speed_[i] *= factor;
+        range_[i] *= factor;
+    }
+    
+    // Requirement 7.2: Advance every bullet by deltaTime, then drop expired ones
+    void integrateAndCull(float deltaTime) {
+        size_t i = 0;
+        const size_t n = count_;
+        
+#ifdef ZG_BULLETS_AVX
+        const __m256 dt8 = _mm256_set1_ps(deltaTime);
+        for (; i + 8 <= n; i += 8) {
+            __m256 px = _mm256_loadu_ps(&x_[i]);
+            __m256 py = _mm256_loadu_ps(&y_[i]);
+            _mm256_storeu_ps(&prevX_[i], px);
+            _mm256_storeu_ps(&prevY_[i], py);
+            _mm256_storeu_ps(&x_[i], _mm256_add_ps(px, _mm256_mul_ps(_mm256_loadu_ps(&vx_[i]), dt8)));
+            _mm256_storeu_ps(&y_[i], _mm256_add_ps(py, _mm256_mul_ps(_mm256_loadu_ps(&vy_[i]), dt8)));
+            _mm256_storeu_ps(&range_[i], _mm256_sub_ps(_mm256_loadu_ps(&range_[i]),
+                                                       _mm256_mul_ps(_mm256_loadu_ps(&speed_[i]), dt8)));
+        }
+#endif
+#ifdef ZG_BULLETS_SSE
+        const __m128 dt4 = _mm_set1_ps(deltaTime);
+        for (; i + 4 <= n; i += 4) {
+            __m128 px = _mm_loadu_ps(&x_[i]);
+            __m128 py = _mm_loadu_ps(&y_[i]);
+            _mm_storeu_ps(&prevX_[i], px);
+            _mm_storeu_ps(&prevY_[i], py);
+            _mm_storeu_ps(&x_[i], _mm_add_ps(px, _mm_mul_ps(_mm_loadu_ps(&vx_[i]), dt4)));
+            _mm_storeu_ps(&y_[i], _mm_add_ps(py, _mm_mul_ps(_mm_loadu_ps(&vy_[i]), dt4)));
+            _mm_storeu_ps(&range_[i], _mm_sub_ps(_mm_loadu_ps(&range_[i]),
+                                                 _mm_mul_ps(_mm_loadu_ps(&speed_[i]), dt4)));
+        }
+#endif
+        // Scalar tail (and the whole pool without SIMD)
+        for (; i < n; ++i) {
+            prevX_[i] = x_[i];
+            prevY_[i] = y_[i];
+            x_[i] += vx_[i] * deltaTime;
+            y_[i] += vy_[i] * deltaTime;
+            range_[i] -= speed_[i] * deltaTime;
+        }
+        
+        cull();
+    }
+    
+    // Requirement 7.5, 10.2: Remove bullets out of range or outside the map
+    void cull() {
+        size_t i = 0;
+        while (i < count_) {
+#ifdef ZG_BULLETS_SSE
+            if (i + 4 <= count_) {
+                const __m128 zero = _mm_setzero_ps();
+                const __m128 mapSize = _mm_set1_ps(MAP_SIZE);
+                __m128 bx = _mm_loadu_ps(&x_[i]);
+                __m128 by = _mm_loadu_ps(&y_[i]);
+                __m128 dead = _mm_cmple_ps(_mm_loadu_ps(&range_[i]), zero);
+                dead = _mm_or_ps(dead, _mm_or_ps(_mm_cmplt_ps(bx, zero), _mm_cmpgt_ps(bx, mapSize)));
+                dead = _mm_or_ps(dead, _mm_or_ps(_mm_cmplt_ps(by, zero), _mm_cmpgt_ps(by, mapSize)));
+                if (_mm_movemask_ps(dead) == 0) {
+                    i += 4; // Whole block alive
+                    continue;
+                }
+            }
+#endif
+            if (isDead(i)) {
+                removeAt(i); // Re-check index i: it now holds the former last bullet
+            } else {
+                ++i;
+            }
+        }
+    }
+    
+private:
+    bool isDead(size_t i) const {
+        return range_[i] <= 0.0f || x_[i] < 0.0f || x_[i] > MAP_SIZE || y_[i] < 0.0f || y_[i] > MAP_SIZE;
+    }
+    
+    // Swap-remove: move the last bullet into slot i
+    void removeAt(size_t i) {
+        size_t last = --count_;
+        if (i == last) {
+            return;
+        }
+        x_[i] = x_[last];
+        y_[i] = y_[last];
+        prevX_[i] = prevX_[last];
+        prevY_[i] = prevY_[last];
+        vx_[i] = vx_[last];
+        vy_[i] = vy_[last];
+        speed_[i] = speed_[last];
+        range_[i] = range_[last];
+        maxRange_[i] = maxRange_[last];
+        damage_[i] = damage_[last];
+        ownerId_[i] = ownerId_[last];
+        weaponType_[i] = weaponType_[last];
+    }
+    
+    size_t capacity_;
+    size_t count_;
+    std::vector<float> x_, y_;
+    std::vector<float> prevX_, prevY_;
+    std::vector<float> vx_, vy_;
+    std::vector<float> speed_;      // |v|, cached at spawn
+    std::vector<float> range_;      // Remaining range
+    std::vector<float> maxRange_;   // Initial range
+    std::vector<float> damage_;
+    std::vector<uint8_t> ownerId_;
+    std::vector<uint8_t> weaponType_;
+};
+
+// Previous per-frame path: update every bullet, then erase(remove_if)
+void legacyIntegrateAndCull(std::vector<Bullet>& bullets, float deltaTime) {
+    for (auto& bullet : bullets) {
+        bullet.update(deltaTime);
+    }
+    bullets.erase(std::remove_if(bullets.begin(), bullets.end(),
+        [](const Bullet& b) { return b.shouldRemove(); }), bullets.end());
+}
+
+std::mt19937 rng(4242);
+
+Bullet randomBullet() {
+    std::uniform_real_distribution<float> pos(100.0f, MAP_SIZE - 100.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+    std::uniform_real_distribution<float> range(300.0f, 2000.0f);
+    std::uniform_real_distribution<float> speed(400.0f, 1200.0f);
+
+    Bullet bullet;
+    bullet.x = bullet.prevX = pos(rng);
+    bullet.y = bullet.prevY = pos(rng);
+    float a = angle(rng);
+    float v = speed(rng);
+    bullet.vx = std::cos(a) * v;
+    bullet.vy = std::sin(a) * v;
+    bullet.range = bullet.maxRange = range(rng);
+    bullet.damage = 15.0f;
+    bullet.ownerId = static_cast<uint8_t>(rng() % 64);
+    return bullet;
+}
+
+// ========================
+// Bullet Pool Tests
+// ========================
+
+// The pool and the Bullet path agree on positions and removals
+// (sizes that are not a multiple of 8 exercise the SIMD tail)
+TEST(PoolMatchesBulletPath) {
+    for (size_t count : { 1u, 3u, 7u, 13u, 250u, 1001u }) {
+        std::vector<Bullet> legacy;
+        BulletPool pool(count);
+        for (size_t i = 0; i < count; ++i) {
+            Bullet b = randomBullet();
+            legacy.push_back(b);
+            ASSERT_TRUE(pool.spawn(b));
+        }
+
+        for (int tick = 0; tick < 90; ++tick) {
+            legacyIntegrateAndCull(legacy, 1.0f / 60.0f);
+            pool.integrateAndCull(1.0f / 60.0f);
+            ASSERT_TRUE(legacy.size() == pool.size());
+        }
+
+        // Order differs after swap-remove: compare sorted positions
+        std::vector<std::pair<float, float>> a, b;
+        for (const auto& bullet : legacy) a.push_back({ bullet.x, bullet.y });
+        for (size_t i = 0; i < pool.size(); ++i) b.push_back({ pool.x(i), pool.y(i) });
+        std::sort(a.begin(), a.end());
+        std::sort(b.begin(), b.end());
+        for (size_t i = 0; i < a.size(); ++i) {
+            ASSERT_NEAR(a[i].first, b[i].first, 0.01f);
+            ASSERT_NEAR(a[i].second, b[i].second, 0.01f);
+        }
+    }
+}
+
+// spawn() fails when the pool is full and succeeds again after a cull
+TEST(PoolCapacityAndReuse) {
+    BulletPool pool(4);
+    Bullet b = randomBullet();
+    for (int i = 0; i < 4; ++i) ASSERT_TRUE(pool.spawn(b));
+    ASSERT_TRUE(!pool.spawn(b));
+
+    pool.kill(1);
+    pool.cull();
+    ASSERT_TRUE(pool.size() == 3);
+    ASSERT_TRUE(pool.spawn(b));
+}
+
+// Killed bullets are removed by swap-remove and the survivors keep their data
+TEST(SwapRemoveKeepsSurvivors) {
+    BulletPool pool(16);
+    for (int i = 0; i < 10; ++i) {
+        Bullet b = randomBullet();
+        b.damage = static_cast<float>(i);
+        pool.spawn(b);
+    }
+    pool.kill(0);
+    pool.kill(4);
+    pool.kill(9);
+    pool.cull();
+
+    ASSERT_TRUE(pool.size() == 7);
+    std::vector<int> damages;
+    for (size_t i = 0; i < pool.size(); ++i) damages.push_back(static_cast<int>(pool.damage(i)));
+    std::sort(damages.begin(), damages.end());
+    ASSERT_TRUE((damages == std::vector<int>{ 1, 2, 3, 5, 6, 7, 8 }));
+}
+
+// Wooden walls halve speed: remaining range must shrink at the new speed
+TEST(SlowDownScalesSpeedAndRange) {
+    BulletPool pool(1);
+    Bullet b;
+    b.x = b.y = 1000.0f;
+    b.vx = 600.0f;
+    b.range = 600.0f;
+    pool.spawn(b);
+    pool.slowDown(0, 0.5f);
+    pool.integrateAndCull(0.5f);
+
+    ASSERT_NEAR(1150.0f, pool.x(0), 0.01f);
+    ASSERT_NEAR(150.0f, pool.range(0), 0.01f);
+}
+
+// ========================
+// Microbenchmark
+// ========================
+
+// Average integrate + cull time per tick with a steady bullet population
+void benchmarkBullets(size_t count) {
+    const int TICKS = 200;
+    const float dt = 1.0f / 60.0f;
+
+    std::vector<Bullet> legacy;
+    legacy.reserve(count);
+    BulletPool pool(count);
+    double legacyMs = 0.0;
+    double poolMs = 0.0;
+
+    for (int tick = 0; tick < TICKS; ++tick) {
+        // Top up both containers with the same new bullets (not timed)
+        while (legacy.size() < count) {
+            Bullet b = randomBullet();
+            legacy.push_back(b);
+            pool.spawn(b);
+        }
+        while (pool.size() < count) {
+            pool.spawn(randomBullet());
+        }
+
+        auto t0 = std::chrono::high_resolution_clock::now();
+        legacyIntegrateAndCull(legacy, dt);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        pool.integrateAndCull(dt);
+        auto t2 = std::chrono::high_resolution_clock::now();
+
+        legacyMs += std::chrono::duration<double, std::milli>(t1 - t0).count();
+        poolMs += std::chrono::duration<double, std::milli>(t2 - t1).count();
+    }
+
+    std::cout << std::setw(10) << count
+              << std::setw(16) << std::fixed << std::setprecision(4) << (legacyMs / TICKS)
+              << std::setw(16) << (poolMs / TICKS)
+              << std::setw(10) << std::setprecision(2) << (poolMs > 0.0 ? legacyMs / poolMs : 0.0) << "x"
+              << std::endl;
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Zero Ground Bullet Pool Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+#if defined(ZG_BULLETS_AVX)
+    std::cout << "SIMD kernel: AVX" << std::endl;
+#elif defined(ZG_BULLETS_SSE)
+    std::cout << "SIMD kernel: SSE2" << std::endl;
+#else
+    std::cout << "SIMD kernel: none (scalar fallback)" << std::endl;
+#endif
+    std::cout << std::endl;
+
+    std::cout << "--- Bullet Pool Tests ---" << std::endl;
+    RUN_TEST(PoolMatchesBulletPath);
+    RUN_TEST(PoolCapacityAndReuse);
+    RUN_TEST(SwapRemoveKeepsSurvivors);
+    RUN_TEST(SlowDownScalesSpeedAndRange);
+
+    std::cout << std::endl;
+    std::cout << "--- Integrate + Cull per Tick (200 ticks) ---" << std::endl;
+    std::cout << std::setw(10) << "Bullets" << std::setw(16) << "Bullet (ms)"
+              << std::setw(16) << "Pool (ms)" << std::setw(11) << "Speedup" << std::endl;
+    for (size_t count : { 1000u, 10000u, 100000u }) {
+        benchmarkBullets(count);
+    }
+
+    // Print summary
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Test Summary" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Total tests: " << totalTests << std::endl;
+    std::cout << "Passed: " << passedTests << std::endl;
+    std::cout << "Failed: " << failedTests << std::endl;
+    std::cout << std::endl;
+
+    if (failedTests == 0) {
+        std::cout << "✓ All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "✗ Some tests failed!" << std::endl;
+        return 1;
+    }
+}
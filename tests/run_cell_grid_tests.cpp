@@ -0,0 +1,870 @@
+// Cell Grid Tests and Benchmark for Zero Ground
+// Checks the flat CellGrid (one array with an empty border) against the nested
+// std::vector<std::vector<Cell>> grid it replaced: same cells for the same map,
+// same BFS path validation, same player collision, and a single-span map
+// serialization round trip. Then times BFS and collision queries on both.
+//
+// Code under test is copied from Zero_Ground.cpp and Zero_Ground_client.cpp;
+// the few SFML types it touches are replaced by minimal stand-ins.
+// Build with /O2 (or -O2).
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <queue>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+
+// ========================
+// Test Framework Macros
+// ========================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "Running test: " << #name << "..."; \
+    try { \
+        test_##name(); \
+        std::cout << " PASSED" << std::endl; \
+        passedTests++; \
+    } catch (const std::exception& e) { \
+        std::cout << " FAILED: " << e.what() << std::endl; \
+        failedTests++; \
+    } \
+    totalTests++; \
+} while(0)
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: " << #condition << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_NEAR(expected, actual, epsilon) do { \
+    if (std::abs((expected) - (actual)) > (epsilon)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << (expected) << " but got " << (actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(expected, actual) do { \
+    if ((expected) != (actual)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << static_cast<int>(expected) << " but got " << static_cast<int>(actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+// Test counters
+int totalTests = 0;
+int passedTests = 0;
+int failedTests = 0;
+
+
+// ========================
+// Structures (copied from main code)
+// ========================
+
+// Minimal stand-ins for the SFML types used by the grid code
+namespace sf {
+struct Vector2f {
+    float x = 0.0f;
+    float y = 0.0f;
+    Vector2f() {}
+    Vector2f(float x_, float y_) : x(x_), y(y_) {}
+};
+struct Vector2i {
+    int x = 0;
+    int y = 0;
+    Vector2i() {}
+    Vector2i(int x_, int y_) : x(x_), y(y_) {}
+    bool operator==(const Vector2i& other) const { return x == other.x && y == other.y; }
+};
+struct FloatRect {
+    float left = 0.0f, top = 0.0f, width = 0.0f, height = 0.0f;
+    FloatRect(float l, float t, float w, float h) : left(l), top(t), width(w), height(h) {}
+    bool intersects(const FloatRect& other) const {
+        float interLeft = std::max(left, other.left);
+        float interTop = std::max(top, other.top);
+        float interRight = std::min(left + width, other.left + other.width);
+        float interBottom = std::min(top + height, other.top + other.height);
+        return interLeft < interRight && interTop < interBottom;
+    }
+};
+}
+
+const float PLAYER_SIZE = 30.0f;
+
+const float MAP_SIZE = 5100.0f;
+const float CELL_SIZE = 100.0f;
+const int GRID_SIZE = 51;
+const float WALL_WIDTH = 12.0f;
+const float WALL_LENGTH = 100.0f;
+
+enum class WallType : uint8_t {
+    None = 0,
+    Concrete = 1,
+    Wood = 2
+};
+
+struct Cell {
+    WallType topWall = WallType::None;
+    WallType rightWall = WallType::None;
+    WallType bottomWall = WallType::None;
+    WallType leftWall = WallType::None;
+};
+
+// Map grid stored as one contiguous array of cells
+//
+// Indexed like the nested vectors it replaces: grid[i][j] is the cell in column i
+// (x) and row j (y), and the cells of one column are adjacent in memory. A border
+// of empty cells surrounds the GRID_SIZE x GRID_SIZE map, so grid[i][j] is valid
+// for i, j in [-1, GRID_SIZE] and the neighbours of any map cell can be read
+// without bounds checks. Walls are only ever set inside the map.
+//
+// PERFORMANCE: one allocation instead of GRID_SIZE + 1; a lookup is a single
+// multiply-add instead of two dependent loads, neighbouring columns share cache
+// lines, and the whole map (border included) is sent as one span.
+class CellGrid {
+public:
+    static constexpr int STRIDE = GRID_SIZE + 2;                          // Cells per column, border included
+    static constexpr size_t CELL_COUNT = static_cast<size_t>(STRIDE) * STRIDE;
+    static constexpr size_t BYTE_SIZE = CELL_COUNT * sizeof(Cell);        // Serialized map size
+    
+    CellGrid() : cells_(CELL_COUNT) {}
+    
+    // Column i, indexable by row j in [-1, GRID_SIZE]
+    Cell* operator[](int i) { return cells_.data() + (i + 1) * STRIDE + 1; }
+    const Cell* operator[](int i) const { return cells_.data() + (i + 1) * STRIDE + 1; }
+    
+    // True if (i, j) is a map cell (not part of the border)
+    static bool contains(int i, int j) {
+        return i >= 0 && i < GRID_SIZE && j >= 0 && j < GRID_SIZE;
+    }
+    
+    // Remove every wall
+    void clear() { cells_.assign(CELL_COUNT, Cell()); }
+    
+    // Empty the border again after raw data was copied in, so nothing received
+    // from the network can place walls outside the map
+    void clearBorder() {
+        for (int k = -1; k <= GRID_SIZE; k++) {
+            (*this)[-1][k] = Cell();
+            (*this)[GRID_SIZE][k] = Cell();
+            (*this)[k][-1] = Cell();
+            (*this)[k][GRID_SIZE] = Cell();
+        }
+    }
+    
+    // Raw storage, CELL_COUNT cells including the border
+    const Cell* data() const { return cells_.data(); }
+    Cell* data() { return cells_.data(); }
+    
+private:
+    std::vector<Cell> cells_;
+};
+
+typedef std::vector<std::vector<Cell>> Grid;
+
+void setWall(Cell& cell, int side, WallType type) {
+    switch (side) {
+        case 0: cell.topWall = type; break;
+        case 1: cell.rightWall = type; break;
+        case 2: cell.bottomWall = type; break;
+        case 3: cell.leftWall = type; break;
+    }
+}
+
+// Same generator as the server, seeded for reproducible runs
+template <typename GridT>
+void generateMap(GridT& grid, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> probDist(0, 99);  // 0-99 for percentages
+    std::uniform_int_distribution<int> sideDist(0, 3);   // 0-3 for sides
+    std::uniform_int_distribution<int> typeDist(0, 99);  // 0-99 for wall type
+    
+    for (int i = 0; i < GRID_SIZE; i++) {
+        for (int j = 0; j < GRID_SIZE; j++) {
+            // Check condition: only cells where (i+j)%2==1 can generate walls
+            if ((i + j) % 2 == 1) {
+                int probability = probDist(gen);
+                
+                if (probability < 60) {
+                    // 60% probability - create one wall on a random side
+                    int side = sideDist(gen);
+                    // Determine wall type: 70% concrete, 30% wood
+                    WallType type = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    setWall(grid[i][j], side, type);
+                }
+                else if (probability < 85) {
+                    // 25% probability (60-84) - create two walls on different sides
+                    int side1 = sideDist(gen);
+                    int side2 = sideDist(gen);
+                    
+                    // Ensure the two sides are different
+                    while (side2 == side1) {
+                        side2 = sideDist(gen);
+                    }
+                    
+                    // Each wall gets its own type
+                    WallType type1 = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    WallType type2 = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    setWall(grid[i][j], side1, type1);
+                    setWall(grid[i][j], side2, type2);
+                }
+                // 15% probability (85-99) - no walls (do nothing)
+            }
+        }
+    }
+}
+
+// ========================
+// Previous nested-vector grid queries, for comparison
+// ========================
+
+bool legacyCanMove(sf::Vector2i from, sf::Vector2i to, const std::vector<std::vector<Cell>>& grid) {
+    // Calculate direction of movement
+    int dx = to.x - from.x;
+    int dy = to.y - from.y;
+    
+    // Check walls based on direction
+    if (dx == 1) {
+        // Moving right: check if there's a right wall in the 'from' cell
+        return grid[from.x][from.y].rightWall == WallType::None;
+    }
+    else if (dx == -1) {
+        // Moving left: check if there's a left wall in the 'from' cell
+        return grid[from.x][from.y].leftWall == WallType::None;
+    }
+    else if (dy == 1) {
+        // Moving down: check if there's a bottom wall in the 'from' cell
+        return grid[from.x][from.y].bottomWall == WallType::None;
+    }
+    else if (dy == -1) {
+        // Moving up: check if there's a top wall in the 'from' cell
+        return grid[from.x][from.y].topWall == WallType::None;
+    }
+    
+    // No movement or invalid movement
+    return false;
+}
+
+bool legacyIsPathExists(sf::Vector2i start, sf::Vector2i end, const std::vector<std::vector<Cell>>& grid) {
+    // Create visited array to track explored cells
+    std::vector<std::vector<bool>> visited(GRID_SIZE, std::vector<bool>(GRID_SIZE, false));
+    
+    // Queue for BFS traversal
+    std::queue<sf::Vector2i> queue;
+    
+    // Convert world coordinates to grid cell coordinates
+    sf::Vector2i startCell(static_cast<int>(start.x / CELL_SIZE), static_cast<int>(start.y / CELL_SIZE));
+    sf::Vector2i endCell(static_cast<int>(end.x / CELL_SIZE), static_cast<int>(end.y / CELL_SIZE));
+    
+    // Clamp to valid grid bounds to prevent out-of-bounds access
+    startCell.x = std::max(0, std::min(GRID_SIZE - 1, startCell.x));
+    startCell.y = std::max(0, std::min(GRID_SIZE - 1, startCell.y));
+    endCell.x = std::max(0, std::min(GRID_SIZE - 1, endCell.x));
+    endCell.y = std::max(0, std::min(GRID_SIZE - 1, endCell.y));
+    
+    // Initialize BFS: add start cell to queue and mark as visited
+    queue.push(startCell);
+    visited[startCell.x][startCell.y] = true;
+    
+    // Direction vectors for 4-directional movement (up, right, down, left)
+    const int dx[] = {0, 1, 0, -1};
+    const int dy[] = {-1, 0, 1, 0};
+    
+    // BFS main loop: explore all reachable cells
+    while (!queue.empty()) {
+        sf::Vector2i current = queue.front();
+        queue.pop();
+        
+        // Success: we reached the destination
+        if (current == endCell) {
+            return true;
+        }
+        
+        // Explore all 4 adjacent cells
+        for (int i = 0; i < 4; ++i) {
+            int nx = current.x + dx[i];
+            int ny = current.y + dy[i];
+            
+            // Check if neighbor is valid: within bounds and not visited
+            if (nx >= 0 && nx < GRID_SIZE && ny >= 0 && ny < GRID_SIZE && !visited[nx][ny]) {
+                // Check if we can move from current cell to neighbor cell (no wall blocking)
+                sf::Vector2i neighbor(nx, ny);
+                if (legacyCanMove(current, neighbor, grid)) {
+                    visited[nx][ny] = true;
+                    queue.push(neighbor);
+                }
+            }
+        }
+    }
+    
+    // Failed: no path exists between start and end
+    return false;
+}
+
+bool legacyCheckCollision(sf::Vector2f pos, const std::vector<std::vector<Cell>>& grid) {
+    sf::FloatRect playerRect(
+        pos.x - PLAYER_SIZE / 2.0f,
+        pos.y - PLAYER_SIZE / 2.0f,
+        PLAYER_SIZE,
+        PLAYER_SIZE
+    );
+    
+    int playerCellX = static_cast<int>(pos.x / CELL_SIZE);
+    int playerCellY = static_cast<int>(pos.y / CELL_SIZE);
+    
+    int startX = std::max(0, playerCellX - 1);
+    int startY = std::max(0, playerCellY - 1);
+    int endX = std::min(GRID_SIZE - 1, playerCellX + 1);
+    int endY = std::min(GRID_SIZE - 1, playerCellY + 1);
+    
+    for (int i = startX; i <= endX; i++) {
+        for (int j = startY; j <= endY; j++) {
+            float x = i * CELL_SIZE;
+            float y = j * CELL_SIZE;
+            
+            if (grid[i][j].topWall != WallType::None) {
+                sf::FloatRect wallRect(x, y - WALL_WIDTH / 2.0f, WALL_LENGTH, WALL_WIDTH);
+                if (playerRect.intersects(wallRect)) return true;
+            }
+            
+            if (grid[i][j].rightWall != WallType::None) {
+                sf::FloatRect wallRect(x + CELL_SIZE - WALL_WIDTH / 2.0f, y, WALL_WIDTH, WALL_LENGTH);
+                if (playerRect.intersects(wallRect)) return true;
+            }
+            
+            if (grid[i][j].bottomWall != WallType::None) {
+                sf::FloatRect wallRect(x, y + CELL_SIZE - WALL_WIDTH / 2.0f, WALL_LENGTH, WALL_WIDTH);
+                if (playerRect.intersects(wallRect)) return true;
+            }
+            
+            if (grid[i][j].leftWall != WallType::None) {
+                sf::FloatRect wallRect(x - WALL_WIDTH / 2.0f, y, WALL_WIDTH, WALL_LENGTH);
+                if (playerRect.intersects(wallRect)) return true;
+            }
+        }
+    }
+    
+    return false;
+}
+
+// ========================
+// Code Under Test (copied from Zero_Ground.cpp and Zero_Ground_client.cpp)
+// ========================
+
+// Check if movement is possible from one cell to another
+// Parameters:
+//   from - Starting cell coordinates
+//   to - Destination cell coordinates
+//   grid - The map grid containing wall information
+// Returns: true if movement is possible (no wall blocking), false otherwise
+bool canMove(sf::Vector2i from, sf::Vector2i to, const CellGrid& grid) {
+    // Calculate direction of movement
+    int dx = to.x - from.x;
+    int dy = to.y - from.y;
+    
+    // Check walls based on direction
+    if (dx == 1) {
+        // Moving right: check if there's a right wall in the 'from' cell
+        return grid[from.x][from.y].rightWall == WallType::None;
+    }
+    else if (dx == -1) {
+        // Moving left: check if there's a left wall in the 'from' cell
+        return grid[from.x][from.y].leftWall == WallType::None;
+    }
+    else if (dy == 1) {
+        // Moving down: check if there's a bottom wall in the 'from' cell
+        return grid[from.x][from.y].bottomWall == WallType::None;
+    }
+    else if (dy == -1) {
+        // Moving up: check if there's a top wall in the 'from' cell
+        return grid[from.x][from.y].topWall == WallType::None;
+    }
+    
+    // No movement or invalid movement
+    return false;
+}
+
+// BFS algorithm to check if a path exists between two points
+// Parameters:
+//   start - Starting position in world coordinates (pixels)
+//   end - Ending position in world coordinates (pixels)
+//   grid - The map grid containing wall information
+// Returns: true if a path exists, false otherwise
+//
+// BREADTH-FIRST SEARCH (BFS) ALGORITHM EXPLANATION:
+// BFS explores all neighbors at the current depth before moving to the next depth level.
+// It guarantees finding a path if one exists.
+//
+// How it works for the cell-based map:
+// 1. Convert world coordinates to grid cell coordinates
+// 2. Start from the starting cell
+// 3. Explore all adjacent cells (up, down, left, right) that are reachable (no walls blocking)
+// 4. Mark each visited cell to avoid revisiting
+// 5. Continue until we reach the end cell or exhaust all paths
+// 6. If we reach the end, a path exists
+//
+// Performance: O(n) where n = number of grid cells (167x167 = 27,889 cells max)
+// Typical runtime: < 10ms for most maps
+bool isPathExists(sf::Vector2i start, sf::Vector2i end, const CellGrid& grid) {
+    // Visited flags laid out like CellGrid storage; the border starts out visited,
+    // so neighbours never need a bounds check
+    std::vector<uint8_t> visited(CellGrid::CELL_COUNT, 0);
+    auto visitedIndex = [](int x, int y) { return (x + 1) * CellGrid::STRIDE + (y + 1); };
+    for (int k = -1; k <= GRID_SIZE; k++) {
+        visited[visitedIndex(-1, k)] = 1;
+        visited[visitedIndex(GRID_SIZE, k)] = 1;
+        visited[visitedIndex(k, -1)] = 1;
+        visited[visitedIndex(k, GRID_SIZE)] = 1;
+    }
+    
+    // Queue for BFS traversal
+    std::queue<sf::Vector2i> queue;
+    
+    // Convert world coordinates to grid cell coordinates
+    sf::Vector2i startCell(static_cast<int>(start.x / CELL_SIZE), static_cast<int>(start.y / CELL_SIZE));
+    sf::Vector2i endCell(static_cast<int>(end.x / CELL_SIZE), static_cast<int>(end.y / CELL_SIZE));
+    
+    // Clamp to valid grid bounds to prevent out-of-bounds access
+    startCell.x = std::max(0, std::min(GRID_SIZE - 1, startCell.x));
+    startCell.y = std::max(0, std::min(GRID_SIZE - 1, startCell.y));
+    endCell.x = std::max(0, std::min(GRID_SIZE - 1, endCell.x));
+    endCell.y = std::max(0, std::min(GRID_SIZE - 1, endCell.y));
+    
+    // Initialize BFS: add start cell to queue and mark as visited
+    queue.push(startCell);
+    visited[visitedIndex(startCell.x, startCell.y)] = 1;
+    
+    // Direction vectors for 4-directional movement (up, right, down, left)
+    const int dx[] = {0, 1, 0, -1};
+    const int dy[] = {-1, 0, 1, 0};
+    
+    // BFS main loop: explore all reachable cells
+    while (!queue.empty()) {
+        sf::Vector2i current = queue.front();
+        queue.pop();
+        
+        // Success: we reached the destination
+        if (current == endCell) {
+            return true;
+        }
+        
+        // Explore all 4 adjacent cells
+        for (int i = 0; i < 4; ++i) {
+            int nx = current.x + dx[i];
+            int ny = current.y + dy[i];
+            
+            // Check if neighbor is not visited (border cells count as visited)
+            if (!visited[visitedIndex(nx, ny)]) {
+                // Check if we can move from current cell to neighbor cell (no wall blocking)
+                sf::Vector2i neighbor(nx, ny);
+                if (canMove(current, neighbor, grid)) {
+                    visited[visitedIndex(nx, ny)] = 1;
+                    queue.push(neighbor);
+                }
+            }
+        }
+    }
+    
+    // Failed: no path exists between start and end
+    return false;
+}
+
+// Helper function to check if a position collides with walls
+bool checkCollision(sf::Vector2f pos, const CellGrid& grid) {
+    sf::FloatRect playerRect(
+        pos.x - PLAYER_SIZE / 2.0f,
+        pos.y - PLAYER_SIZE / 2.0f,
+        PLAYER_SIZE,
+        PLAYER_SIZE
+    );
+    
+    // Clamp once: the grid border keeps the 3x3 neighbourhood of any map cell addressable
+    int playerCellX = std::max(0, std::min(GRID_SIZE - 1, static_cast<int>(pos.x / CELL_SIZE)));
+    int playerCellY = std::max(0, std::min(GRID_SIZE - 1, static_cast<int>(pos.y / CELL_SIZE)));
+    
+    for (int i = playerCellX - 1; i <= playerCellX + 1; i++) {
+        for (int j = playerCellY - 1; j <= playerCellY + 1; j++) {
+            float x = i * CELL_SIZE;
+            float y = j * CELL_SIZE;
+            
+            if (grid[i][j].topWall != WallType::None) {
+                sf::FloatRect wallRect(x, y - WALL_WIDTH / 2.0f, WALL_LENGTH, WALL_WIDTH);
+                if (playerRect.intersects(wallRect)) return true;
+            }
+            
+            if (grid[i][j].rightWall != WallType::None) {
+                sf::FloatRect wallRect(x + CELL_SIZE - WALL_WIDTH / 2.0f, y, WALL_WIDTH, WALL_LENGTH);
+                if (playerRect.intersects(wallRect)) return true;
+            }
+            
+            if (grid[i][j].bottomWall != WallType::None) {
+                sf::FloatRect wallRect(x, y + CELL_SIZE - WALL_WIDTH / 2.0f, WALL_LENGTH, WALL_WIDTH);
+                if (playerRect.intersects(wallRect)) return true;
+            }
+            
+            if (grid[i][j].leftWall != WallType::None) {
+                sf::FloatRect wallRect(x - WALL_WIDTH / 2.0f, y, WALL_WIDTH, WALL_LENGTH);
+                if (playerRect.intersects(wallRect)) return true;
+            }
+        }
+    }
+    
+    return false;
+}
+
+// Serialize the cell-based grid map into a byte buffer for network transmission
+// Parameters:
+//   grid - The cell grid to serialize
+//   buffer - Output buffer to store serialized data
+//
+// SERIALIZATION FORMAT:
+// The grid is serialized as the contiguous block of memory backing CellGrid,
+// border included: (GRID_SIZE + 2)^2 Cell structures, column by column.
+// Each Cell is 4 bytes (4 wall types), so 53 x 53 x 4 = 11,236 bytes (~11 KB)
+//
+// ALGORITHM:
+// 1. Resize buffer to fit the entire grid
+// 2. Copy the grid storage into the buffer with a single std::memcpy
+// 3. This is valid because Cell structure is POD (Plain Old Data)
+//
+// PERFORMANCE:
+// - One memory copy of ~11 KB, no per-column loop
+// - Network transmission time: ~10-50ms depending on connection
+void serializeMap(const CellGrid& grid, std::vector<char>& buffer) {
+    // Calculate total size needed for serialization
+    size_t totalSize = CellGrid::BYTE_SIZE;
+    
+    // Resize buffer to fit all data
+    buffer.resize(totalSize);
+    
+    // The grid is one contiguous array, so it is copied as a single span
+    std::memcpy(buffer.data(), grid.data(), totalSize);
+    
+    std::cout << "[INFO] Map serialized: " << totalSize << " bytes (" 
+              << (totalSize / 1024) << " KB)" << std::endl;
+}
+
+// Deserialize map data from byte buffer into grid
+// Parameters:
+//   buffer - Byte buffer containing serialized grid data
+//   grid - The grid to populate with deserialized data
+//
+// PROTOCOL:
+// The buffer contains the server's CellGrid storage, border included:
+// (GRID_SIZE + 2)^2 Cell structures, column by column.
+// Each Cell is sizeof(Cell) bytes (4 bytes for 4 wall types).
+// Total size: 53 x 53 x 4 = 11,236 bytes (~11 KB)
+//
+// ALGORITHM:
+// 1. Copy the buffer into the grid storage with a single std::memcpy
+// 2. Empty the border again so the received data cannot put walls outside the map
+void deserializeMap(const std::vector<char>& buffer, CellGrid& grid) {
+    // Calculate expected size
+    size_t expectedSize = CellGrid::BYTE_SIZE;
+    
+    if (buffer.size() != expectedSize) {
+        std::cerr << "[ERROR] Buffer size mismatch in deserializeMap: expected " 
+                  << expectedSize << " bytes, got " << buffer.size() << " bytes" << std::endl;
+        return;
+    }
+    
+    // The grid is one contiguous array, so it is filled as a single span
+    std::memcpy(grid.data(), buffer.data(), expectedSize);
+    grid.clearBorder();
+    
+    std::cout << "[INFO] Map deserialized: " << buffer.size() << " bytes (" 
+              << (buffer.size() / 1024) << " KB)" << std::endl;
+}
+
+// ========================
+// Helpers
+// ========================
+
+bool sameCell(const Cell& a, const Cell& b) {
+    return a.topWall == b.topWall && a.rightWall == b.rightWall &&
+           a.bottomWall == b.bottomWall && a.leftWall == b.leftWall;
+}
+
+bool isEmpty(const Cell& cell) {
+    return sameCell(cell, Cell());
+}
+
+bool borderIsEmpty(const CellGrid& grid) {
+    for (int k = -1; k <= GRID_SIZE; k++) {
+        if (!isEmpty(grid[-1][k]) || !isEmpty(grid[GRID_SIZE][k]) ||
+            !isEmpty(grid[k][-1]) || !isEmpty(grid[k][GRID_SIZE])) return false;
+    }
+    return true;
+}
+
+bool sameMap(const Grid& nested, const CellGrid& flat) {
+    for (int i = 0; i < GRID_SIZE; i++) {
+        for (int j = 0; j < GRID_SIZE; j++) {
+            if (!sameCell(nested[i][j], flat[i][j])) return false;
+        }
+    }
+    return true;
+}
+
+// Map with random walls in every cell, denser than the generator, so BFS often fails
+template <typename GridT>
+void generateDenseMap(GridT& grid, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> wallDist(0, 99);
+    for (int i = 0; i < GRID_SIZE; i++) {
+        for (int j = 0; j < GRID_SIZE; j++) {
+            for (int side = 0; side < 4; side++) {
+                if (wallDist(gen) < 35) setWall(grid[i][j], side, WallType::Concrete);
+            }
+        }
+    }
+}
+
+// ========================
+// Tests
+// ========================
+
+TEST(StorageIsOneBorderedArray) {
+    CellGrid grid;
+    ASSERT_EQ(GRID_SIZE + 2, CellGrid::STRIDE);
+    ASSERT_TRUE(CellGrid::CELL_COUNT == static_cast<size_t>((GRID_SIZE + 2) * (GRID_SIZE + 2)));
+    ASSERT_TRUE(CellGrid::BYTE_SIZE == CellGrid::CELL_COUNT * sizeof(Cell));
+    // Columns are adjacent: the first map cell follows one border column and one border cell
+    ASSERT_TRUE(&grid[0][0] == grid.data() + CellGrid::STRIDE + 1);
+    ASSERT_TRUE(&grid[1][0] == &grid[0][0] + CellGrid::STRIDE);
+    ASSERT_TRUE(&grid[0][1] == &grid[0][0] + 1);
+    ASSERT_TRUE(&grid[-1][-1] == grid.data());
+    ASSERT_TRUE(&grid[GRID_SIZE][GRID_SIZE] == grid.data() + CellGrid::CELL_COUNT - 1);
+    ASSERT_TRUE(CellGrid::contains(0, 0) && CellGrid::contains(GRID_SIZE - 1, GRID_SIZE - 1));
+    ASSERT_TRUE(!CellGrid::contains(-1, 0) && !CellGrid::contains(0, GRID_SIZE));
+}
+
+TEST(SameCellsAsNestedVectors) {
+    for (unsigned seed = 1; seed <= 20; seed++) {
+        Grid nested(GRID_SIZE, std::vector<Cell>(GRID_SIZE));
+        CellGrid flat;
+        generateMap(nested, seed);
+        generateMap(flat, seed);
+        ASSERT_TRUE(sameMap(nested, flat));
+        ASSERT_TRUE(borderIsEmpty(flat));
+    }
+}
+
+TEST(ClearRemovesEveryWall) {
+    CellGrid grid;
+    generateDenseMap(grid, 7);
+    grid.clear();
+    for (int i = -1; i <= GRID_SIZE; i++) {
+        for (int j = -1; j <= GRID_SIZE; j++) {
+            ASSERT_TRUE(isEmpty(grid[i][j]));
+        }
+    }
+}
+
+TEST(PathExistsMatchesNestedVectors) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> coord(-200, static_cast<int>(MAP_SIZE) + 200);
+    int reachable = 0;
+    int unreachable = 0;
+    for (unsigned seed = 1; seed <= 40; seed++) {
+        Grid nested(GRID_SIZE, std::vector<Cell>(GRID_SIZE));
+        CellGrid flat;
+        if (seed % 2 == 0) {
+            generateMap(nested, seed);
+            generateMap(flat, seed);
+        } else {
+            generateDenseMap(nested, seed);
+            generateDenseMap(flat, seed);
+        }
+        for (int k = 0; k < 20; k++) {
+            sf::Vector2i start(coord(rng), coord(rng));
+            sf::Vector2i end(coord(rng), coord(rng));
+            bool expected = legacyIsPathExists(start, end, nested);
+            ASSERT_EQ(expected, isPathExists(start, end, flat));
+            (expected ? reachable : unreachable)++;
+        }
+    }
+    // Both outcomes must actually be exercised
+    ASSERT_TRUE(reachable > 0 && unreachable > 0);
+}
+
+TEST(PathStopsAtMapEdge) {
+    // Walls everywhere except an open ring along the map edge: the ring connects
+    // the corners, but nothing may leak through the border
+    CellGrid grid;
+    for (int i = 0; i < GRID_SIZE; i++) {
+        for (int j = 0; j < GRID_SIZE; j++) {
+            for (int side = 0; side < 4; side++) setWall(grid[i][j], side, WallType::Concrete);
+        }
+    }
+    for (int k = 0; k < GRID_SIZE; k++) {
+        grid[k][0] = Cell();
+        grid[k][GRID_SIZE - 1] = Cell();
+        grid[0][k] = Cell();
+        grid[GRID_SIZE - 1][k] = Cell();
+    }
+    const int far = static_cast<int>(MAP_SIZE) - 50;
+    ASSERT_TRUE(isPathExists(sf::Vector2i(50, 50), sf::Vector2i(far, far), grid));
+    ASSERT_TRUE(!isPathExists(sf::Vector2i(50, 50), sf::Vector2i(far / 2, far / 2), grid));
+}
+
+TEST(CollisionMatchesNestedVectors) {
+    std::mt19937 rng(7);
+    // Includes positions just outside the map, as resolveCollisionCellBased checks
+    // the unclamped target position
+    std::uniform_real_distribution<float> coord(-40.0f, MAP_SIZE + 40.0f);
+    int hits = 0;
+    for (unsigned seed = 1; seed <= 10; seed++) {
+        Grid nested(GRID_SIZE, std::vector<Cell>(GRID_SIZE));
+        CellGrid flat;
+        generateMap(nested, seed);
+        generateMap(flat, seed);
+        for (int k = 0; k < 20000; k++) {
+            sf::Vector2f pos(coord(rng), coord(rng));
+            bool expected = legacyCheckCollision(pos, nested);
+            ASSERT_EQ(expected, checkCollision(pos, flat));
+            if (expected) hits++;
+        }
+    }
+    ASSERT_TRUE(hits > 0);
+}
+
+TEST(SerializeIsOneSpanRoundTrip) {
+    CellGrid source;
+    generateMap(source, 99);
+    std::vector<char> buffer;
+    serializeMap(source, buffer);
+    ASSERT_TRUE(buffer.size() == CellGrid::BYTE_SIZE);
+    ASSERT_TRUE(std::memcmp(buffer.data(), source.data(), buffer.size()) == 0);
+    
+    CellGrid received;
+    deserializeMap(buffer, received);
+    ASSERT_TRUE(std::memcmp(received.data(), source.data(), CellGrid::BYTE_SIZE) == 0);
+}
+
+TEST(DeserializeEmptiesBorder) {
+    // A buffer with walls in the border cells must not put walls outside the map
+    std::vector<char> buffer(CellGrid::BYTE_SIZE, static_cast<char>(WallType::Concrete));
+    CellGrid grid;
+    deserializeMap(buffer, grid);
+    ASSERT_TRUE(borderIsEmpty(grid));
+    ASSERT_EQ(WallType::Concrete, grid[0][0].topWall);
+    ASSERT_EQ(WallType::Concrete, grid[GRID_SIZE - 1][GRID_SIZE - 1].leftWall);
+}
+
+TEST(DeserializeRejectsWrongSize) {
+    CellGrid grid;
+    // The old GRID_SIZE x GRID_SIZE format is refused, the grid is left untouched
+    std::vector<char> buffer(GRID_SIZE * GRID_SIZE * sizeof(Cell), static_cast<char>(WallType::Wood));
+    deserializeMap(buffer, grid);
+    for (int i = -1; i <= GRID_SIZE; i++) {
+        for (int j = -1; j <= GRID_SIZE; j++) {
+            ASSERT_TRUE(isEmpty(grid[i][j]));
+        }
+    }
+}
+
+// ========================
+// Benchmark
+// ========================
+
+template <typename F>
+double timeNs(int iterations, F&& body) {
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (int k = 0; k < iterations; k++) body(k);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::nano>(end - begin).count() / iterations;
+}
+
+void benchmarkQueries() {
+    Grid nested(GRID_SIZE, std::vector<Cell>(GRID_SIZE));
+    CellGrid flat;
+    generateMap(nested, 1234);
+    generateMap(flat, 1234);
+    
+    // BFS across the map, as generateValidMap does between the spawn points
+    const sf::Vector2i start(250, 4750);
+    const sf::Vector2i end(4750, 250);
+    volatile int sink = 0;
+    const int bfsIterations = 2000;
+    double legacyBfs = timeNs(bfsIterations, [&](int) { sink = sink + legacyIsPathExists(start, end, nested); });
+    double flatBfs = timeNs(bfsIterations, [&](int) { sink = sink + isPathExists(start, end, flat); });
+    
+    // Player collision at random positions
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> coord(0.0f, MAP_SIZE);
+    std::vector<sf::Vector2f> positions(4096);
+    for (auto& p : positions) p = sf::Vector2f(coord(rng), coord(rng));
+    const int collisionIterations = 2000000;
+    double legacyCollision = timeNs(collisionIterations, [&](int k) {
+        sink = sink + legacyCheckCollision(positions[k & 4095], nested);
+    });
+    double flatCollision = timeNs(collisionIterations, [&](int k) {
+        sink = sink + checkCollision(positions[k & 4095], flat);
+    });
+    
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::setw(22) << "Query" << std::setw(14) << "Nested (ns)"
+              << std::setw(12) << "Flat (ns)" << std::setw(11) << "Speedup" << std::endl;
+    std::cout << std::setw(22) << "isPathExists" << std::setw(14) << legacyBfs
+              << std::setw(12) << flatBfs << std::setw(10) << (legacyBfs / flatBfs) << "x" << std::endl;
+    std::cout << std::setw(22) << "checkCollision" << std::setw(14) << legacyCollision
+              << std::setw(12) << flatCollision << std::setw(10) << (legacyCollision / flatCollision) << "x" << std::endl;
+}
+
+// ========================
+// Main Test Runner
+// ========================
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Zero Ground Cell Grid Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "--- Cell Grid Tests ---" << std::endl;
+    RUN_TEST(StorageIsOneBorderedArray);
+    RUN_TEST(SameCellsAsNestedVectors);
+    RUN_TEST(ClearRemovesEveryWall);
+    RUN_TEST(PathExistsMatchesNestedVectors);
+    RUN_TEST(PathStopsAtMapEdge);
+    RUN_TEST(CollisionMatchesNestedVectors);
+    RUN_TEST(SerializeIsOneSpanRoundTrip);
+    RUN_TEST(DeserializeEmptiesBorder);
+    RUN_TEST(DeserializeRejectsWrongSize);
+
+    std::cout << std::endl;
+    std::cout << "--- Query Cost (nested vectors vs CellGrid) ---" << std::endl;
+    benchmarkQueries();
+
+    // Print summary
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Test Summary" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Total tests: " << totalTests << std::endl;
+    std::cout << "Passed: " << passedTests << std::endl;
+    std::cout << "Failed: " << failedTests << std::endl;
+    std::cout << std::endl;
+
+    if (failedTests == 0) {
+        std::cout << "✓ All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "✗ Some tests failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,1640 @@
+// Client Datagram Tests for Zero Ground
+// Sends client datagrams through the server's receive path: the client's
+// DatagramBuilder, reliable channel and sendToServer on one side, the
+// listener's drain loop and decodeDatagram on the other. Checks that a full
+// reliable window of purchases plus an input arrives whole (and so does its
+// resend), that the largest reliable messages are split into datagrams the
+// receive buffer holds, that a send split into several datagrams claims a
+// wire sequence for each and reports any failed datagram, and that more than
+// a datagram's worth of queued messages makes the round trip in order.
+// Then reports the largest client datagram for each case.
+//
+// SFML's UdpSocket is replaced by an in-memory queue.
+// Code under test is copied from Zero_Ground.cpp (the client has the same wire
+// code) and Zero_Ground_client.cpp (sendToServer). Build with /O2 (or -O2).
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <deque>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <functional>
+#include <cstdint>
+#include <cstring>
+
+// ========================
+// Test Framework Macros
+// ========================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "Running test: " << #name << "..."; \
+    try { \
+        test_##name(); \
+        std::cout << " PASSED" << std::endl; \
+        passedTests++; \
+    } catch (const std::exception& e) { \
+        std::cout << " FAILED: " << e.what() << std::endl; \
+        failedTests++; \
+    } \
+    totalTests++; \
+} while(0)
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: " << #condition << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_NEAR(expected, actual, epsilon) do { \
+    if (std::abs((expected) - (actual)) > (epsilon)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << (expected) << " but got " << (actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(expected, actual) do { \
+    if ((expected) != (actual)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << static_cast<int>(expected) << " but got " << static_cast<int>(actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+// Test counters
+int totalTests = 0;
+int passedTests = 0;
+int failedTests = 0;
+
+
+// ========================
+// Simulated Socket
+// ========================
+
+double simTime = 0.0;  // Seconds, advanced by the tests
+
+const uint32_t SERVER_ADDRESS = 0x0A000001;
+
+// Minimal stand-ins for the SFML types the send and receive paths use
+namespace sf {
+class Time {
+public:
+    float asSeconds() const { return seconds_; }
+    static Time fromSeconds(float s) { Time t; t.seconds_ = s; return t; }
+private:
+    float seconds_ = 0.0f;
+};
+
+class Clock {
+public:
+    Time getElapsedTime() const { return Time::fromSeconds(static_cast<float>(simTime)); }
+};
+
+class IpAddress {
+public:
+    IpAddress() {}
+    explicit IpAddress(uint32_t address) : address_(address) {}
+    explicit IpAddress(const std::string&) : address_(SERVER_ADDRESS) {}
+    uint32_t toInteger() const { return address_; }
+private:
+    uint32_t address_ = 0;
+};
+
+class Socket {
+public:
+    enum Status { Done, NotReady, Partial, Disconnected, Error };
+};
+
+// Datagrams waiting in the socket's receive buffer; sent datagrams go straight
+// into peer's (the first failing sends fail instead)
+class UdpSocket : public Socket {
+public:
+    struct Queued {
+        std::vector<uint8_t> bytes;
+        uint32_t sender = 0;
+        unsigned short port = 0;
+    };
+    
+    Status send(const void* data, std::size_t size, const IpAddress&, unsigned short) {
+        if (failing > 0) {
+            failing--;
+            return Error;
+        }
+        Queued sent;
+        sent.bytes.assign(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+        sent.sender = address;
+        sent.port = 53002;
+        peer->queue.push_back(sent);
+        return Done;
+    }
+    
+    Status receive(void* data, std::size_t size, std::size_t& received, IpAddress& sender, unsigned short& port) {
+        received = 0;
+        if (queue.empty()) {
+            return NotReady;
+        }
+        Queued next = queue.front();
+        queue.pop_front();
+        received = std::min(size, next.bytes.size());
+        std::memcpy(data, next.bytes.data(), received);
+        sender = IpAddress(next.sender);
+        port = next.port;
+        return Done;
+    }
+    
+    std::deque<Queued> queue;
+    UdpSocket* peer = nullptr;
+    uint32_t address = 0;
+    int failing = 0;
+};
+}
+
+sf::Clock networkClock;
+
+// ========================
+// Code Under Test (copied from Zero_Ground.cpp)
+// ========================
+
+// Purchase packet (client → server)
+// Requirement 4.1-4.5: Purchase validation and transaction
+struct PurchasePacket {
+    uint8_t playerId;
+    uint8_t weaponType;        // Weapon::Type enum value, 255 = buying ammo
+    uint8_t ammoType = 255;    // AmmoType enum value, 255 = buying a weapon
+};
+
+// Inventory update packet (server → buyer)
+// Sent in answer to every purchase to confirm or undo it and synchronize the balance
+struct InventoryPacket {
+    uint8_t playerId;
+    uint8_t slot;        // Which slot changed (0-3), 255 = none
+    uint8_t weaponType;  // Weapon::Type enum value, 255 = empty slot
+    bool accepted;       // False if the server refused the purchase
+    int newMoneyBalance;
+};
+
+// Requirement 7.6: Shot packet (client → server → all clients)
+// Sent when player fires weapon
+struct ShotPacket {
+    uint8_t playerId;
+    float x, y;          // Shot origin position
+    float dirX, dirY;    // Normalized direction vector
+    uint8_t weaponType;  // Weapon::Type enum value
+    float bulletSpeed;   // Bullet speed for this weapon
+    float damage;        // Damage for this weapon
+    float range;         // Range for this weapon
+    uint32_t viewTick;   // Tick of the latest server snapshot the shooter had (lag compensation)
+};
+
+// Requirement 10.4: Hit packet (server → all clients)
+// Sent when bullet hits a player
+struct HitPacket {
+    uint8_t shooterId;   // Player who fired the bullet
+    uint8_t victimId;    // Player who was hit
+    float damage;        // Damage dealt
+    float hitX, hitY;    // Position where hit occurred
+    bool wasKill;        // True if this hit killed the victim
+};
+
+const size_t MAX_SNAPSHOT_BYTES = 1192;         // Leaves room for the wire headers in one datagram
+
+// Every UDP datagram, in both directions, is a versioned header followed by
+// one or more length-prefixed messages:
+//
+//   header:       version:8, sequence:32
+//   per message:  type:8, length:16, payload[length]
+//
+// All integers are little-endian and every payload has an explicit byte layout
+// (see the *Message sections below), so struct padding and compiler ABI never
+// reach the wire and two messages of equal size can't be confused.
+// The sequence counts datagrams per sender and direction (loss detection).
+// Messages never span datagrams; a message that does not fit starts a new one.
+
+const uint8_t WIRE_VERSION = 5;                 // Version 4 input messages had no link report
+const size_t WIRE_HEADER_BYTES = 5;
+const size_t WIRE_MESSAGE_HEADER_BYTES = 3;
+const size_t MAX_DATAGRAM_BYTES = 1200;         // Stays below a typical 1500 byte MTU
+static_assert(MAX_SNAPSHOT_BYTES + WIRE_HEADER_BYTES + WIRE_MESSAGE_HEADER_BYTES <= MAX_DATAGRAM_BYTES,
+              "A full snapshot must fit in one datagram");
+
+enum class WireMessageType : uint8_t {
+    Input = 1,     // Client -> server: sequenced InputCommands and snapshot ack
+    Shot = 2,      // Both directions: ShotPacket
+    Hit = 3,          // Server -> client, reliable only: HitPacket
+    Snapshot = 4,     // Server -> client: writeSnapshot() payload
+    InputAck = 5,     // Server -> client: last simulated input and resulting position
+    Purchase = 6,     // Client -> server, reliable only: PurchasePacket
+    Inventory = 7,    // Server -> client, reliable only: InventoryPacket
+    Reliable = 8,     // Both directions: one of the above, sequenced (see ReliableChannel)
+    ReliableAck = 9   // Both directions: which Reliable messages arrived
+};
+const size_t WIRE_MESSAGE_TYPE_COUNT = 10;      // Type 0 is never valid
+
+// Little-endian field access; payloads are unaligned, so go through bytes
+inline void storeU16(uint8_t* p, uint16_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+}
+
+inline void storeU32(uint8_t* p, uint32_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+    p[2] = static_cast<uint8_t>(value >> 16);
+    p[3] = static_cast<uint8_t>(value >> 24);
+}
+
+inline void storeF32(uint8_t* p, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    storeU32(p, bits);
+}
+
+inline uint16_t loadU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t loadU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline float loadF32(const uint8_t* p) {
+    uint32_t bits = loadU32(p);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// ------------------------
+// Input Message
+// ------------------------
+// playerId:8, ackTick:32, ackDelay:16, lostDatagrams:16, firstSequence:32, count:8,
+// then count * (buttons:8, aim:16) with sequences firstSequence, firstSequence + 1, ...
+//
+// The client samples its controls INPUT_RATE times per second into sequenced
+// commands and sends the newest MAX_INPUT_COMMANDS with every datagram, so a lost
+// datagram is covered by the next one. The server simulates the movement itself
+// (see InputQueue) and never takes a position from the client.
+// ackDelay (ms the client held the ackTick snapshot before this send) and
+// lostDatagrams (running count of missing server sequence numbers, mod 65536)
+// are the client's link report: the server derives RTT and downstream loss from them.
+
+const float INPUT_RATE = 60.0f;                  // Commands per second (movement speeds are per 1/60 s)
+const float INPUT_STEP = 1.0f / INPUT_RATE;      // Simulated time per command
+const size_t MAX_INPUT_COMMANDS = 8;             // Newest commands repeated in every datagram
+const size_t INPUT_MESSAGE_HEADER_BYTES = 14;
+const size_t INPUT_COMMAND_BYTES = 3;
+const size_t MAX_INPUT_MESSAGE_BYTES = INPUT_MESSAGE_HEADER_BYTES + MAX_INPUT_COMMANDS * INPUT_COMMAND_BYTES;
+
+// Low nibble of InputCommand::buttons; the high nibble is the active weapon
+// (Weapon::Type + 1, 0 = no weapon), which decides the movement speed
+const uint16_t NO_ACK_DELAY = 0xFFFF;            // ackDelay before the first snapshot
+
+const uint8_t INPUT_UP = 0x01;
+const uint8_t INPUT_DOWN = 0x02;
+const uint8_t INPUT_LEFT = 0x04;
+const uint8_t INPUT_RIGHT = 0x08;
+
+// One sampled frame of client controls
+struct InputCommand {
+    uint32_t sequence = 0;  // Client input tick, +1 per command
+    uint8_t buttons = 0;    // INPUT_* bits | weapon code << 4
+    uint16_t aim = 0;       // Rotation, 1/65536 of a turn
+};
+
+// Client's view of the server -> client link, sent with every input message
+struct InputLinkReport {
+    uint16_t ackDelay = NO_ACK_DELAY;  // ms, see above
+    uint16_t lostDatagrams = 0;
+};
+
+inline uint8_t inputWeaponCode(uint8_t buttons) {
+    return static_cast<uint8_t>(buttons >> 4);
+}
+
+inline uint16_t quantizeAim(float degrees) {
+    float turns = degrees / 360.0f;
+    turns -= std::floor(turns);
+    return static_cast<uint16_t>(static_cast<uint32_t>(std::lround(turns * 65536.0f)) & 0xFFFF);
+}
+
+inline float dequantizeAim(uint16_t aim) {
+    return aim * (360.0f / 65536.0f);
+}
+
+// Write the input payload; count must be 1..MAX_INPUT_COMMANDS with consecutive sequences
+// Returns: payload length in bytes
+size_t writeInputMessage(uint8_t* out, uint8_t playerId, uint32_t ackTick, const InputLinkReport& link,
+                         const InputCommand* commands, size_t count) {
+    out[0] = playerId;
+    storeU32(out + 1, ackTick);
+    storeU16(out + 5, link.ackDelay);
+    storeU16(out + 7, link.lostDatagrams);
+    storeU32(out + 9, commands[0].sequence);
+    out[13] = static_cast<uint8_t>(count);
+    uint8_t* p = out + INPUT_MESSAGE_HEADER_BYTES;
+    for (size_t i = 0; i < count; ++i, p += INPUT_COMMAND_BYTES) {
+        p[0] = commands[i].buttons;
+        storeU16(p + 1, commands[i].aim);
+    }
+    return INPUT_MESSAGE_HEADER_BYTES + count * INPUT_COMMAND_BYTES;
+}
+
+// Reads a validated input payload in place (no copy)
+class InputMessageView {
+public:
+    InputMessageView(const uint8_t* payload, size_t length) : p_(payload), length_(length) {}
+    
+    uint8_t playerId() const { return p_[0]; }
+    uint32_t ackTick() const { return loadU32(p_ + 1); }
+    uint16_t ackDelay() const { return loadU16(p_ + 5); }
+    uint16_t lostDatagrams() const { return loadU16(p_ + 7); }
+    uint32_t firstSequence() const { return loadU32(p_ + 9); }
+    
+    // Commands actually present (the count field is checked against the length)
+    size_t count() const {
+        return std::min<size_t>(p_[13], (length_ - INPUT_MESSAGE_HEADER_BYTES) / INPUT_COMMAND_BYTES);
+    }
+    
+    InputCommand command(size_t index) const {
+        const uint8_t* p = p_ + INPUT_MESSAGE_HEADER_BYTES + index * INPUT_COMMAND_BYTES;
+        InputCommand command;
+        command.sequence = firstSequence() + static_cast<uint32_t>(index);
+        command.buttons = p[0];
+        command.aim = loadU16(p + 1);
+        return command;
+    }
+    
+private:
+    const uint8_t* p_;
+    size_t length_;
+};
+
+// ------------------------
+// Shot Message
+// ------------------------
+// playerId:8, x:f32, y:f32, dirX:f32, dirY:f32, weaponType:8,
+// bulletSpeed:f32, damage:f32, range:f32, viewTick:32
+
+const size_t SHOT_MESSAGE_BYTES = 34;
+
+void writeShotMessage(uint8_t* out, const ShotPacket& packet) {
+    out[0] = packet.playerId;
+    storeF32(out + 1, packet.x);
+    storeF32(out + 5, packet.y);
+    storeF32(out + 9, packet.dirX);
+    storeF32(out + 13, packet.dirY);
+    out[17] = packet.weaponType;
+    storeF32(out + 18, packet.bulletSpeed);
+    storeF32(out + 22, packet.damage);
+    storeF32(out + 26, packet.range);
+    storeU32(out + 30, packet.viewTick);
+}
+
+// Reads a validated shot payload in place (no copy)
+class ShotMessageView {
+public:
+    explicit ShotMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint8_t playerId() const { return p_[0]; }
+    float x() const { return loadF32(p_ + 1); }
+    float y() const { return loadF32(p_ + 5); }
+    float dirX() const { return loadF32(p_ + 9); }
+    float dirY() const { return loadF32(p_ + 13); }
+    uint8_t weaponType() const { return p_[17]; }
+    float bulletSpeed() const { return loadF32(p_ + 18); }
+    float damage() const { return loadF32(p_ + 22); }
+    float range() const { return loadF32(p_ + 26); }
+    uint32_t viewTick() const { return loadU32(p_ + 30); }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Hit Message
+// ------------------------
+// shooterId:8, victimId:8, damage:f32, hitX:f32, hitY:f32, wasKill:8
+
+const size_t HIT_MESSAGE_BYTES = 15;
+
+void writeHitMessage(uint8_t* out, const HitPacket& packet) {
+    out[0] = packet.shooterId;
+    out[1] = packet.victimId;
+    storeF32(out + 2, packet.damage);
+    storeF32(out + 6, packet.hitX);
+    storeF32(out + 10, packet.hitY);
+    out[14] = packet.wasKill ? 1 : 0;
+}
+
+// Reads a validated hit payload in place (no copy)
+class HitMessageView {
+public:
+    explicit HitMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint8_t shooterId() const { return p_[0]; }
+    uint8_t victimId() const { return p_[1]; }
+    float damage() const { return loadF32(p_ + 2); }
+    float hitX() const { return loadF32(p_ + 6); }
+    float hitY() const { return loadF32(p_ + 10); }
+    bool wasKill() const { return p_[14] != 0; }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Input Ack Message
+// ------------------------
+// sequence:32, x:f32, y:f32
+//
+// Sent to each client with its snapshot: the last input command the server
+// simulated for that client and the exact position it ended at. The client
+// rewinds its prediction to it and replays the newer commands (see InputPredictor).
+
+const size_t INPUT_ACK_MESSAGE_BYTES = 12;
+
+void writeInputAckMessage(uint8_t* out, uint32_t sequence, float x, float y) {
+    storeU32(out, sequence);
+    storeF32(out + 4, x);
+    storeF32(out + 8, y);
+}
+
+// Reads a validated input ack payload in place (no copy)
+class InputAckMessageView {
+public:
+    explicit InputAckMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint32_t sequence() const { return loadU32(p_); }
+    float x() const { return loadF32(p_ + 4); }
+    float y() const { return loadF32(p_ + 8); }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Purchase Message
+// ------------------------
+// playerId:8, weaponType:8, ammoType:8
+//
+// One shop purchase (client -> server, reliable). Exactly one of weaponType and
+// ammoType names an item; the other is PURCHASE_NONE.
+
+const size_t PURCHASE_MESSAGE_BYTES = 3;
+const uint8_t PURCHASE_NONE = 255;
+
+void writePurchaseMessage(uint8_t* out, const PurchasePacket& packet) {
+    out[0] = packet.playerId;
+    out[1] = packet.weaponType;
+    out[2] = packet.ammoType;
+}
+
+// Reads a validated purchase payload in place (no copy)
+class PurchaseMessageView {
+public:
+    explicit PurchaseMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint8_t playerId() const { return p_[0]; }
+    uint8_t weaponType() const { return p_[1]; }
+    uint8_t ammoType() const { return p_[2]; }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Inventory Message
+// ------------------------
+// playerId:8, slot:8, weaponType:8, accepted:8, newMoneyBalance:32
+//
+// The server's answer to one purchase (server -> buyer, reliable, same order as
+// the purchases). slot and weaponType are PURCHASE_NONE unless a weapon was added.
+
+const size_t INVENTORY_MESSAGE_BYTES = 8;
+
+void writeInventoryMessage(uint8_t* out, const InventoryPacket& packet) {
+    out[0] = packet.playerId;
+    out[1] = packet.slot;
+    out[2] = packet.weaponType;
+    out[3] = packet.accepted ? 1 : 0;
+    storeU32(out + 4, static_cast<uint32_t>(packet.newMoneyBalance));
+}
+
+// Reads a validated inventory payload in place (no copy)
+class InventoryMessageView {
+public:
+    explicit InventoryMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint8_t playerId() const { return p_[0]; }
+    uint8_t slot() const { return p_[1]; }
+    uint8_t weaponType() const { return p_[2]; }
+    bool accepted() const { return p_[3] != 0; }
+    int newMoneyBalance() const { return static_cast<int32_t>(loadU32(p_ + 4)); }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Reliable Message
+// ------------------------
+// id:16, type:8, then the payload of the wrapped message
+//
+// Purchases, inventory updates and hits must arrive exactly once and in order.
+// Instead of a second (TCP) connection, which would stall behind every lost
+// segment, they are wrapped in Reliable messages and ride on the same datagrams
+// as snapshots and inputs; ReliableChannel numbers, acknowledges, resends and
+// reorders them, and nothing unreliable ever waits for them.
+
+const size_t RELIABLE_MESSAGE_HEADER_BYTES = 3;
+const size_t MAX_RELIABLE_BODY_BYTES = 32;
+
+void writeReliableMessage(uint8_t* out, uint16_t id, uint8_t type, const uint8_t* body, size_t length) {
+    storeU16(out, id);
+    out[2] = type;
+    std::memcpy(out + RELIABLE_MESSAGE_HEADER_BYTES, body, length);
+}
+
+// Reads a validated reliable payload in place (no copy)
+class ReliableMessageView {
+public:
+    ReliableMessageView(const uint8_t* payload, size_t length) : p_(payload), length_(length) {}
+    
+    uint16_t id() const { return loadU16(p_); }
+    uint8_t type() const { return p_[2]; }
+    const uint8_t* body() const { return p_ + RELIABLE_MESSAGE_HEADER_BYTES; }
+    size_t bodyLength() const { return length_ - RELIABLE_MESSAGE_HEADER_BYTES; }
+    
+private:
+    const uint8_t* p_;
+    size_t length_;
+};
+
+// ------------------------
+// Reliable Ack Message
+// ------------------------
+// nextExpected:16, received:32
+//
+// nextExpected is the first reliable id not received yet (all older ones arrived);
+// bit i of received is set when id nextExpected + 1 + i is already buffered.
+
+const size_t RELIABLE_ACK_MESSAGE_BYTES = 6;
+
+void writeReliableAckMessage(uint8_t* out, uint16_t nextExpected, uint32_t received) {
+    storeU16(out, nextExpected);
+    storeU32(out + 2, received);
+}
+
+// Reads a validated reliable ack payload in place (no copy)
+class ReliableAckMessageView {
+public:
+    explicit ReliableAckMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint16_t nextExpected() const { return loadU16(p_); }
+    uint32_t received() const { return loadU32(p_ + 2); }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Decoding
+// ------------------------
+
+// Allowed payload length per message type, indexed by WireMessageType
+struct WireMessageSpec {
+    const char* name;
+    size_t minLength;
+    size_t maxLength;
+};
+
+const WireMessageSpec WIRE_MESSAGE_SPECS[WIRE_MESSAGE_TYPE_COUNT] = {
+    { "invalid", 1, 0 },  // Empty range: never accepted
+    { "input", INPUT_MESSAGE_HEADER_BYTES + INPUT_COMMAND_BYTES, MAX_INPUT_MESSAGE_BYTES },
+    { "shot", SHOT_MESSAGE_BYTES, SHOT_MESSAGE_BYTES },
+    { "hit", HIT_MESSAGE_BYTES, HIT_MESSAGE_BYTES },
+    { "snapshot", 1, MAX_SNAPSHOT_BYTES },
+    { "input ack", INPUT_ACK_MESSAGE_BYTES, INPUT_ACK_MESSAGE_BYTES },
+    { "purchase", PURCHASE_MESSAGE_BYTES, PURCHASE_MESSAGE_BYTES },
+    { "inventory", INVENTORY_MESSAGE_BYTES, INVENTORY_MESSAGE_BYTES },
+    { "reliable", RELIABLE_MESSAGE_HEADER_BYTES, RELIABLE_MESSAGE_HEADER_BYTES + MAX_RELIABLE_BODY_BYTES },
+    { "reliable ack", RELIABLE_ACK_MESSAGE_BYTES, RELIABLE_ACK_MESSAGE_BYTES }
+};
+
+enum class WireStatus {
+    Ok,
+    Truncated,    // Header or message runs past the end of the datagram
+    BadVersion,   // Sender speaks another protocol version
+    UnknownType,  // Type not in the table or not accepted by this receiver
+    BadLength     // Payload length outside the type's allowed range
+};
+
+// Message handler: payload points into the receive buffer and has been bounds-checked
+template <typename Context>
+using WireHandler = void (*)(const uint8_t* payload, size_t length, Context& context);
+
+// Read the datagram header
+// Returns: Ok and the sequence, or why the datagram was rejected
+inline WireStatus readWireHeader(const uint8_t* data, size_t size, uint32_t& sequence) {
+    if (size < WIRE_HEADER_BYTES) {
+        return WireStatus::Truncated;
+    }
+    if (data[0] != WIRE_VERSION) {
+        return WireStatus::BadVersion;
+    }
+    sequence = loadU32(data + 1);
+    return WireStatus::Ok;
+}
+
+// Validate a whole datagram in place, then dispatch each message to handlers[type]
+// Parameters:
+//   data, size - The received datagram (never copied)
+//   handlers - Handler per WireMessageType; null rejects that type
+//   context - Passed through to the handlers
+//   sequence - Receives the datagram sequence number
+// Returns: Ok if every message was dispatched; otherwise nothing was dispatched
+//
+// PERFORMANCE:
+// Type lookup is an array index and each message is checked once against the
+// spec table, so decoding is O(1) per message with no allocation. Validating
+// the whole datagram before dispatching means a malformed tail can't leave a
+// half-applied datagram behind.
+template <typename Context>
+WireStatus decodeDatagram(const uint8_t* data, size_t size, const WireHandler<Context>* handlers,
+                          Context& context, uint32_t& sequence) {
+    WireStatus status = readWireHeader(data, size, sequence);
+    if (status != WireStatus::Ok) {
+        return status;
+    }
+    
+    // Pass 1: bounds and type checks
+    size_t pos = WIRE_HEADER_BYTES;
+    while (pos < size) {
+        if (size - pos < WIRE_MESSAGE_HEADER_BYTES) {
+            return WireStatus::Truncated;
+        }
+        uint8_t type = data[pos];
+        size_t length = loadU16(data + pos + 1);
+        if (type >= WIRE_MESSAGE_TYPE_COUNT || handlers[type] == nullptr) {
+            return WireStatus::UnknownType;
+        }
+        if (length < WIRE_MESSAGE_SPECS[type].minLength || length > WIRE_MESSAGE_SPECS[type].maxLength) {
+            return WireStatus::BadLength;
+        }
+        pos += WIRE_MESSAGE_HEADER_BYTES;
+        if (size - pos < length) {
+            return WireStatus::Truncated;
+        }
+        pos += length;
+    }
+    
+    // Pass 2: dispatch
+    pos = WIRE_HEADER_BYTES;
+    while (pos < size) {
+        uint8_t type = data[pos];
+        size_t length = loadU16(data + pos + 1);
+        pos += WIRE_MESSAGE_HEADER_BYTES;
+        handlers[type](data + pos, length, context);
+        pos += length;
+    }
+    return WireStatus::Ok;
+}
+
+// Validate and dispatch one message that did not come straight from decodeDatagram
+// (the payload of a Reliable message, delivered once it is in order)
+// Returns: Ok if the handler was called
+template <typename Context>
+WireStatus dispatchWireMessage(uint8_t type, const uint8_t* payload, size_t length,
+                               const WireHandler<Context>* handlers, Context& context) {
+    if (type >= WIRE_MESSAGE_TYPE_COUNT || handlers[type] == nullptr) {
+        return WireStatus::UnknownType;
+    }
+    if (length < WIRE_MESSAGE_SPECS[type].minLength || length > WIRE_MESSAGE_SPECS[type].maxLength) {
+        return WireStatus::BadLength;
+    }
+    handlers[type](payload, length, context);
+    return WireStatus::Ok;
+}
+
+inline const char* wireStatusName(WireStatus status) {
+    switch (status) {
+        case WireStatus::Ok: return "ok";
+        case WireStatus::Truncated: return "truncated";
+        case WireStatus::BadVersion: return "wrong protocol version";
+        case WireStatus::UnknownType: return "unexpected message type";
+        case WireStatus::BadLength: return "bad message length";
+    }
+    return "unknown";
+}
+
+// ------------------------
+// Encoding
+// ------------------------
+
+// Builds the datagrams for one recipient
+// Completed datagrams are handed to the sink (data, size, message count);
+// call flush() once all messages have been appended.
+class DatagramBuilder {
+public:
+    using Sink = std::function<void(const uint8_t*, size_t, size_t)>;
+    
+    // firstSequence - Sequence number of the first datagram this builder sends
+    DatagramBuilder(Sink sink, uint32_t firstSequence)
+        : sink_(std::move(sink)), nextSequence_(firstSequence) {
+        buffer_[0] = WIRE_VERSION;
+    }
+    
+    // Reserve room for one message, flushing the current datagram first if it would not fit
+    // Returns: where to write the payload (exactly length bytes), or null if the
+    // message is too large for any datagram
+    uint8_t* reserve(WireMessageType type, size_t length) {
+        const size_t needed = WIRE_MESSAGE_HEADER_BYTES + length;
+        if (WIRE_HEADER_BYTES + needed > MAX_DATAGRAM_BYTES) {
+            return nullptr;
+        }
+        if (used_ + needed > MAX_DATAGRAM_BYTES) {
+            flush();
+        }
+        
+        buffer_[used_] = static_cast<uint8_t>(type);
+        storeU16(buffer_ + used_ + 1, static_cast<uint16_t>(length));
+        uint8_t* payload = buffer_ + used_ + WIRE_MESSAGE_HEADER_BYTES;
+        used_ += needed;
+        messageCount_++;
+        return payload;
+    }
+    
+    // Append a pre-encoded payload (e.g. a snapshot)
+    bool append(WireMessageType type, const uint8_t* payload, size_t length) {
+        uint8_t* out = reserve(type, length);
+        if (out == nullptr) {
+            return false;
+        }
+        std::memcpy(out, payload, length);
+        return true;
+    }
+    
+    // commands - Consecutive commands, oldest first (at most MAX_INPUT_COMMANDS are sent: the newest)
+    bool appendInput(uint8_t playerId, uint32_t ackTick, const InputLinkReport& link,
+                     const InputCommand* commands, size_t count) {
+        if (count == 0) {
+            return false;
+        }
+        if (count > MAX_INPUT_COMMANDS) {
+            commands += count - MAX_INPUT_COMMANDS;
+            count = MAX_INPUT_COMMANDS;
+        }
+        uint8_t* out = reserve(WireMessageType::Input, INPUT_MESSAGE_HEADER_BYTES + count * INPUT_COMMAND_BYTES);
+        if (out) writeInputMessage(out, playerId, ackTick, link, commands, count);
+        return out != nullptr;
+    }
+    
+    bool appendShot(const ShotPacket& packet) {
+        uint8_t* out = reserve(WireMessageType::Shot, SHOT_MESSAGE_BYTES);
+        if (out) writeShotMessage(out, packet);
+        return out != nullptr;
+    }
+    
+    bool appendHit(const HitPacket& packet) {
+        uint8_t* out = reserve(WireMessageType::Hit, HIT_MESSAGE_BYTES);
+        if (out) writeHitMessage(out, packet);
+        return out != nullptr;
+    }
+    
+    bool appendInputAck(uint32_t sequence, float x, float y) {
+        uint8_t* out = reserve(WireMessageType::InputAck, INPUT_ACK_MESSAGE_BYTES);
+        if (out) writeInputAckMessage(out, sequence, x, y);
+        return out != nullptr;
+    }
+    
+    // Hand the pending datagram to the sink (no-op when nothing is pending)
+    void flush() {
+        if (messageCount_ == 0) {
+            return;
+        }
+        storeU32(buffer_ + 1, nextSequence_++);
+        sink_(buffer_, used_, messageCount_);
+        datagramsSent_++;
+        used_ = WIRE_HEADER_BYTES;
+        messageCount_ = 0;
+    }
+    
+    size_t datagramsSent() const { return datagramsSent_; }
+    
+    // Sequence number the next datagram will carry
+    uint32_t nextSequence() const { return nextSequence_; }
+    
+private:
+    Sink sink_;
+    uint8_t buffer_[MAX_DATAGRAM_BYTES];
+    size_t used_ = WIRE_HEADER_BYTES;
+    size_t messageCount_ = 0;
+    size_t datagramsSent_ = 0;
+    uint32_t nextSequence_;
+};
+
+// ------------------------
+// Link Statistics
+// ------------------------
+
+// Smoothed round-trip time and its mean deviation (RFC 6298)
+// The deviation is the RTT jitter: how far single samples stray from the mean
+class RttEstimator {
+public:
+    void sample(float rtt) {
+        if (!hasSample_) {
+            smoothed_ = rtt;
+            variance_ = rtt * 0.5f;
+            hasSample_ = true;
+            return;
+        }
+        variance_ = 0.75f * variance_ + 0.25f * std::fabs(smoothed_ - rtt);
+        smoothed_ = 0.875f * smoothed_ + 0.125f * rtt;
+    }
+    
+    bool hasSample() const { return hasSample_; }
+    float smoothed() const { return smoothed_; }
+    float variance() const { return variance_; }
+    
+private:
+    bool hasSample_ = false;
+    float smoothed_ = 0.0f;
+    float variance_ = 0.0f;
+};
+
+// Loss and reordering of one incoming datagram stream, from its wire sequence numbers
+//
+// ALGORITHM:
+// A jump past the newest sequence counts the skipped ones as lost; a bit mask of
+// the last 64 sequences remembers which arrived, so a late datagram inside that
+// window is taken back from the loss count (out of order) and a repeated one is
+// a duplicate. Datagrams older than the window stay counted as lost - for a
+// real-time stream they are. Sequences before the first one received were never
+// counted as lost, so a late one only arrives out of order.
+class SequenceTracker {
+public:
+    // Take the sequence of one received datagram
+    // Returns: true if it is the newest so far
+    bool onDatagram(uint32_t sequence) {
+        if (!started_) {
+            started_ = true;
+            first_ = sequence;
+            newest_ = sequence;
+            seen_ = 1;
+            received_++;
+            return true;
+        }
+        if (sequence > newest_) {
+            const uint32_t skipped = sequence - newest_ - 1;
+            lost_ += skipped;
+            seen_ = (skipped >= 63) ? 1 : (seen_ << (skipped + 1)) | 1;
+            newest_ = sequence;
+            received_++;
+            return true;
+        }
+        
+        const uint32_t age = newest_ - sequence;
+        if (age < 64 && ((seen_ >> age) & 1)) {
+            duplicates_++;
+            return false;
+        }
+        if (age < 64) {
+            seen_ |= uint64_t(1) << age;
+            if (sequence > first_) {
+                lost_--;
+            }
+        }
+        outOfOrder_++;
+        received_++;
+        return false;
+    }
+    
+    uint64_t received() const { return received_; }      // Distinct datagrams
+    uint64_t lost() const { return lost_; }              // Missing sequence numbers
+    uint64_t outOfOrder() const { return outOfOrder_; }  // Arrived after a newer one
+    uint64_t duplicates() const { return duplicates_; }
+    
+private:
+    bool started_ = false;
+    uint32_t first_ = 0;   // Gaps are only counted after this one
+    uint32_t newest_ = 0;
+    uint64_t seen_ = 0;  // Bit i: newest_ - i arrived
+    uint64_t received_ = 0;
+    uint64_t lost_ = 0;
+    uint64_t outOfOrder_ = 0;
+    uint64_t duplicates_ = 0;
+};
+
+// ------------------------
+// Reliable Channel
+// ------------------------
+
+// Reliable, ordered message stream to one peer, carried on the unreliable datagrams
+//
+// ALGORITHM:
+// Sending: every message gets the next 16-bit id and stays queued until the peer
+// acknowledges it. write() appends the pending ack plus every message that was
+// never sent or whose resend timeout expired. Only WINDOW ids past the oldest
+// unacknowledged one are in flight, so everything the peer can have buffered
+// fits in the 32-bit ack mask. The timeout is smoothed RTT + 4 x RTT variance
+// (RFC 6298), sampled only from messages acknowledged after their first send
+// (Karn). A message that needs a second resend doubles it until the next
+// sample, so a sudden RTT rise can't cause endless spurious resends, while
+// single losses on a link that keeps answering are resent one timeout apart.
+// Receiving: messages ahead of the next expected id wait in WINDOW slots until
+// the gap is filled, then deliver() releases them in id order. Duplicates are
+// dropped but re-arm the ack, so a lost ack is repeated by the next datagram.
+//
+// PERFORMANCE:
+// Fixed rings indexed by id (both sizes divide 65536, so wraparound is free), no
+// allocation. The ack costs 9 bytes and only goes out after something arrived;
+// a lost message delays only the reliable messages behind it, never snapshots
+// or inputs.
+class ReliableChannel {
+public:
+    static const uint16_t WINDOW = 32;              // Ids in flight / buffered ahead of the gap
+    static const uint16_t QUEUE_CAPACITY = 128;     // Queued outgoing messages (in flight + waiting)
+    static constexpr float INITIAL_TIMEOUT = 0.2f;  // Resend timeout before the first RTT sample
+    static constexpr float MIN_TIMEOUT = 0.05f;     // Below this the peer's ack delay causes spurious resends
+    static constexpr float MAX_TIMEOUT = 1.0f;      // Cap for the backed-off timeout
+    static const int MAX_BACKOFF = 5;               // Doublings without an RTT sample
+    
+    // Queue a message for reliable delivery
+    // Returns: false if the body is too large or the queue is full (peer not acknowledging)
+    bool send(WireMessageType type, const uint8_t* body, size_t length) {
+        if (length > MAX_RELIABLE_BODY_BYTES || queued() == QUEUE_CAPACITY) {
+            return false;
+        }
+        Outgoing& message = outgoing_[nextSendId_ % QUEUE_CAPACITY];
+        message.type = static_cast<uint8_t>(type);
+        message.length = static_cast<uint8_t>(length);
+        std::memcpy(message.body, body, length);
+        message.sends = 0;
+        message.acked = false;
+        nextSendId_++;
+        return true;
+    }
+    
+    // Returns: true if write() would append anything at this time
+    bool wantsToSend(float now) const {
+        if (ackPending_) {
+            return true;
+        }
+        const uint16_t end = inFlightEnd();
+        for (uint16_t id = oldestUnacked_; id != end; ++id) {
+            const Outgoing& message = outgoing_[id % QUEUE_CAPACITY];
+            if (!message.acked && (message.sends == 0 || now - message.sentAt >= resendTimeout())) {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    // Append the pending ack and every message due for (re)sending
+    void write(DatagramBuilder& builder, float now) {
+        if (ackPending_) {
+            uint8_t* out = builder.reserve(WireMessageType::ReliableAck, RELIABLE_ACK_MESSAGE_BYTES);
+            if (out) {
+                writeReliableAckMessage(out, nextReceiveId_, receivedMask());
+                ackPending_ = false;
+            }
+        }
+        
+        const uint16_t end = inFlightEnd();
+        const float timeout = resendTimeout();
+        bool resentAgain = false;
+        for (uint16_t id = oldestUnacked_; id != end; ++id) {
+            Outgoing& message = outgoing_[id % QUEUE_CAPACITY];
+            if (message.acked || (message.sends > 0 && now - message.sentAt < timeout)) {
+                continue;
+            }
+            uint8_t* out = builder.reserve(WireMessageType::Reliable, RELIABLE_MESSAGE_HEADER_BYTES + message.length);
+            if (!out) {
+                continue;
+            }
+            writeReliableMessage(out, id, message.type, message.body, message.length);
+            if (message.sends > 0) {
+                resends_++;
+                resentAgain = resentAgain || message.sends > 1;
+            }
+            if (message.sends < 255) {
+                message.sends++;
+            }
+            message.sentAt = now;
+        }
+        if (resentAgain && backoff_ < MAX_BACKOFF) {
+            backoff_++;
+        }
+    }
+    
+    // Take the peer's ack (see the Reliable Ack Message layout)
+    void onAck(uint16_t nextExpected, uint32_t received, float now) {
+        // An ack for ids we never sent is stale or forged
+        if (before(nextSendId_, nextExpected)) {
+            return;
+        }
+        
+        const uint16_t end = inFlightEnd();
+        for (uint16_t id = oldestUnacked_; id != end; ++id) {
+            Outgoing& message = outgoing_[id % QUEUE_CAPACITY];
+            if (message.acked || message.sends == 0) {
+                continue;
+            }
+            const uint16_t bit = static_cast<uint16_t>(id - nextExpected - 1);
+            if (!before(id, nextExpected) && !(bit < 32 && ((received >> bit) & 1))) {
+                continue;
+            }
+            message.acked = true;
+            // A resent message's ack may answer any of its copies: no sample
+            if (message.sends == 1) {
+                sampleRtt(now - message.sentAt);
+            }
+        }
+        
+        while (oldestUnacked_ != nextSendId_ && outgoing_[oldestUnacked_ % QUEUE_CAPACITY].acked) {
+            oldestUnacked_++;
+        }
+    }
+    
+    // Take one received message; call deliver() afterwards
+    // Returns: false for a duplicate or an id outside the receive window
+    bool receive(uint16_t id, uint8_t type, const uint8_t* body, size_t length) {
+        ackPending_ = true;
+        if (before(id, nextReceiveId_) || static_cast<uint16_t>(id - nextReceiveId_) >= WINDOW ||
+            length > MAX_RELIABLE_BODY_BYTES) {
+            duplicates_++;
+            return false;
+        }
+        Incoming& slot = incoming_[id % WINDOW];
+        if (slot.present) {
+            duplicates_++;
+            return false;
+        }
+        slot.present = true;
+        slot.type = type;
+        slot.length = static_cast<uint8_t>(length);
+        std::memcpy(slot.body, body, length);
+        return true;
+    }
+    
+    // Hand every message that is now in order to fn(type, body, length), oldest first
+    // fn may send() on this channel
+    template <typename Fn>
+    void deliver(Fn&& fn) {
+        while (incoming_[nextReceiveId_ % WINDOW].present) {
+            Incoming& slot = incoming_[nextReceiveId_ % WINDOW];
+            slot.present = false;
+            nextReceiveId_++;
+            fn(slot.type, static_cast<const uint8_t*>(slot.body), static_cast<size_t>(slot.length));
+        }
+    }
+    
+    // Resend timeout from the RTT estimate, before backoff
+    float timeout() const {
+        if (!rtt_.hasSample()) {
+            return INITIAL_TIMEOUT;
+        }
+        return std::min(MAX_TIMEOUT, std::max(MIN_TIMEOUT, rtt_.smoothed() + 4.0f * rtt_.variance()));
+    }
+    
+    bool hasRttSample() const { return rtt_.hasSample(); }
+    float smoothedRtt() const { return rtt_.smoothed(); }
+    float rttVariance() const { return rtt_.variance(); }
+    size_t resends() const { return resends_; }
+    size_t duplicates() const { return duplicates_; }
+    
+    // Messages sent or waiting to be sent that the peer has not acknowledged
+    uint16_t queued() const { return static_cast<uint16_t>(nextSendId_ - oldestUnacked_); }
+    
+private:
+    struct Outgoing {
+        uint8_t type = 0;
+        uint8_t length = 0;
+        uint8_t sends = 0;     // 0 = never sent
+        bool acked = false;
+        float sentAt = 0.0f;   // Time of the latest send
+        uint8_t body[MAX_RELIABLE_BODY_BYTES];
+    };
+    
+    struct Incoming {
+        bool present = false;
+        uint8_t type = 0;
+        uint8_t length = 0;
+        uint8_t body[MAX_RELIABLE_BODY_BYTES];
+    };
+    
+    // Serial number order: a comes before b (valid while they are < 32768 apart)
+    static bool before(uint16_t a, uint16_t b) {
+        return static_cast<int16_t>(static_cast<uint16_t>(a - b)) < 0;
+    }
+    
+    // One past the newest id that may be in flight
+    uint16_t inFlightEnd() const {
+        return queued() > WINDOW ? static_cast<uint16_t>(oldestUnacked_ + WINDOW) : nextSendId_;
+    }
+    
+    float resendTimeout() const {
+        return std::min(MAX_TIMEOUT, timeout() * static_cast<float>(1u << backoff_));
+    }
+    
+    uint32_t receivedMask() const {
+        uint32_t mask = 0;
+        for (uint16_t i = 0; i + 1 < WINDOW; ++i) {
+            if (incoming_[static_cast<uint16_t>(nextReceiveId_ + 1 + i) % WINDOW].present) {
+                mask |= uint32_t(1) << i;
+            }
+        }
+        return mask;
+    }
+    
+    void sampleRtt(float rtt) {
+        backoff_ = 0;
+        rtt_.sample(rtt);
+    }
+    
+    std::array<Outgoing, QUEUE_CAPACITY> outgoing_;
+    std::array<Incoming, WINDOW> incoming_;
+    uint16_t nextSendId_ = 0;
+    uint16_t oldestUnacked_ = 0;
+    uint16_t nextReceiveId_ = 0;
+    bool ackPending_ = false;
+    int backoff_ = 0;
+    RttEstimator rtt_;
+    size_t resends_ = 0;
+    size_t duplicates_ = 0;
+};
+
+// Raw datagram received by the UDP listener thread
+// The listener only receives and queues; all game state changes happen on the
+// simulation tick (see runServerTick) so inputs are applied in a deterministic order.
+struct InboundDatagram {
+    sf::IpAddress sender;
+    unsigned short senderPort = 0;
+    std::size_t size = 0;
+    float receivedAt = 0.0f;  // networkClock time (RTT samples)
+    uint8_t data[MAX_DATAGRAM_BYTES];  // DatagramBuilder starts a new datagram before exceeding this
+};
+
+// Receive every datagram already queued on a non-blocking socket into batch
+// Returns: false if the socket reported an error; the datagrams after it are
+// picked up on the next wakeup
+bool drainUdpSocket(sf::UdpSocket& socket, std::vector<InboundDatagram>& batch) {
+    while (true) {
+        InboundDatagram datagram;
+        sf::Socket::Status status = socket.receive(datagram.data, sizeof(datagram.data), datagram.size,
+                                                   datagram.sender, datagram.senderPort);
+        
+        if (status == sf::Socket::NotReady) {
+            return true;
+        }
+        if (status != sf::Socket::Done) {
+            return false;
+        }
+        
+        // Stamped here, not on the tick: the tick wait would add up to a tick to every RTT sample
+        datagram.receivedAt = networkClock.getElapsedTime().asSeconds();
+        batch.push_back(datagram);
+    }
+}
+
+// ========================
+// Code Under Test (copied from Zero_Ground_client.cpp)
+// ========================
+
+std::atomic<uint32_t> outgoingSequence(0); // Wire sequence of the next datagram to the server
+
+// Send the messages append() adds to the server, in as few datagrams as they fit
+// Shots and inputs go out from different threads and sockets, so the wire
+// sequence is shared through outgoingSequence. How many datagrams the builder
+// produces is only known after flush(), so they are built first and then claim
+// that many consecutive sequences with one fetch_add: a shot sent meanwhile
+// can't be stamped with one of them.
+// Returns: Done if every datagram was sent, otherwise the worst failure
+template <typename AppendFn>
+sf::Socket::Status sendToServer(sf::UdpSocket& socket, const std::string& ip, AppendFn append) {
+    std::vector<std::vector<uint8_t>> datagrams;
+    DatagramBuilder builder([&](const uint8_t* data, size_t size, size_t) {
+        datagrams.emplace_back(data, data + size);
+    }, 0);
+    append(builder);
+    builder.flush();
+    
+    uint32_t sequence = outgoingSequence.fetch_add(static_cast<uint32_t>(datagrams.size()));
+    const sf::IpAddress server(ip);
+    sf::Socket::Status status = sf::Socket::Done;
+    for (std::vector<uint8_t>& datagram : datagrams) {
+        storeU32(datagram.data() + 1, sequence++);  // Header: version:8, sequence:32
+        sf::Socket::Status sendStatus = socket.send(datagram.data(), datagram.size(), server, 53001);
+        if (sendStatus != sf::Socket::Done && (status == sf::Socket::Done || status == sf::Socket::NotReady)) {
+            status = sendStatus;
+        }
+    }
+    return status;
+}
+
+// ========================
+// Test Helpers
+// ========================
+
+const uint32_t CLIENT_ADDRESS = 0x0A000002;
+const uint8_t CLIENT_PLAYER_ID = 1;
+
+// Server side of one client connection: what decodeDatagram dispatched
+struct ServerSide {
+    ReliableChannel reliable;
+    SequenceTracker sequences;
+    size_t datagrams = 0;
+    size_t rejected = 0;
+    size_t largest = 0;
+    size_t inputs = 0;
+    size_t shots = 0;
+    size_t delivered = 0;  // Reliable messages released in order
+    std::vector<uint8_t> deliveredTags;  // First body byte of each
+    size_t purchases = 0;
+};
+
+void countInput(const uint8_t*, size_t, ServerSide& server) {
+    server.inputs++;
+}
+
+void countShot(const uint8_t*, size_t, ServerSide& server) {
+    server.shots++;
+}
+
+void countPurchase(const uint8_t*, size_t, ServerSide& server) {
+    server.purchases++;
+}
+
+// Messages carried inside reliable messages (as INBOUND_RELIABLE_HANDLERS)
+const WireHandler<ServerSide> SERVER_RELIABLE_HANDLERS[WIRE_MESSAGE_TYPE_COUNT] = {
+    nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, countPurchase, nullptr, nullptr, nullptr
+};
+
+void receiveReliable(const uint8_t* payload, size_t length, ServerSide& server) {
+    const ReliableMessageView message(payload, length);
+    server.reliable.receive(message.id(), message.type(), message.body(), message.bodyLength());
+    server.reliable.deliver([&](uint8_t type, const uint8_t* body, size_t bodyLength) {
+        server.delivered++;
+        server.deliveredTags.push_back(body[0]);
+        dispatchWireMessage(type, body, bodyLength, SERVER_RELIABLE_HANDLERS, server);
+    });
+}
+
+void receiveReliableAck(const uint8_t*, size_t, ServerSide&) {
+}
+
+// Client -> server table (as INBOUND_HANDLERS)
+const WireHandler<ServerSide> SERVER_HANDLERS[WIRE_MESSAGE_TYPE_COUNT] = {
+    nullptr, countInput, countShot, nullptr, nullptr, nullptr, nullptr, nullptr, receiveReliable, receiveReliableAck
+};
+
+// Drain the server socket and decode every datagram as processInboundDatagram does
+void serverReceive(sf::UdpSocket& socket, ServerSide& server) {
+    std::vector<InboundDatagram> batch;
+    if (!drainUdpSocket(socket, batch)) {
+        throw std::runtime_error("drain failed");
+    }
+    for (const InboundDatagram& datagram : batch) {
+        server.datagrams++;
+        server.largest = std::max(server.largest, datagram.size);
+        uint32_t sequence = 0;
+        if (decodeDatagram(datagram.data, datagram.size, SERVER_HANDLERS, server, sequence) == WireStatus::Ok) {
+            server.sequences.onDatagram(sequence);
+        } else {
+            server.rejected++;
+        }
+    }
+}
+
+// Client side: the udpThread send (input, then the reliable channel's ack and due messages)
+struct ClientSide {
+    ReliableChannel reliable;
+    uint32_t sequence = 0;
+    size_t largest = 0;
+};
+
+void queuePurchases(ClientSide& client, int count) {
+    for (int i = 0; i < count; ++i) {
+        PurchasePacket packet;
+        packet.playerId = CLIENT_PLAYER_ID;
+        packet.weaponType = PURCHASE_NONE;
+        packet.ammoType = static_cast<uint8_t>(i % 3);
+        uint8_t body[PURCHASE_MESSAGE_BYTES];
+        writePurchaseMessage(body, packet);
+        client.reliable.send(WireMessageType::Purchase, body, sizeof(body));
+    }
+}
+
+// Reliable messages with the largest body allowed, tagged with their index
+void queueLargestMessages(ClientSide& client, int count) {
+    uint8_t body[MAX_RELIABLE_BODY_BYTES] = {};
+    for (int i = 0; i < count; ++i) {
+        body[0] = static_cast<uint8_t>(i);
+        client.reliable.send(WireMessageType::Purchase, body, sizeof(body));
+    }
+}
+
+// A full input message: the newest MAX_INPUT_COMMANDS commands
+void appendInput(DatagramBuilder& builder) {
+    InputCommand commands[MAX_INPUT_COMMANDS];
+    for (size_t i = 0; i < MAX_INPUT_COMMANDS; ++i) {
+        commands[i].sequence = static_cast<uint32_t>(100 + i);
+    }
+    builder.appendInput(CLIENT_PLAYER_ID, 0, InputLinkReport(), commands, MAX_INPUT_COMMANDS);
+}
+
+void clientSend(ClientSide& client, sf::UdpSocket& serverSocket, float now) {
+    DatagramBuilder builder([&](const uint8_t* data, size_t size, size_t) {
+        client.largest = std::max(client.largest, size);
+        sf::UdpSocket::Queued queued;
+        queued.bytes.assign(data, data + size);
+        queued.sender = CLIENT_ADDRESS;
+        queued.port = 53002;
+        serverSocket.queue.push_back(queued);
+    }, client.sequence);
+    appendInput(builder);
+    client.reliable.write(builder, now);
+    builder.flush();
+    client.sequence = builder.nextSequence();
+}
+
+// Client and server sockets wired to each other, for sends through sendToServer
+struct Connection {
+    sf::UdpSocket serverSocket;
+    sf::UdpSocket clientSocket;
+    
+    Connection() {
+        clientSocket.peer = &serverSocket;
+        clientSocket.address = CLIENT_ADDRESS;
+        outgoingSequence = 0;
+    }
+};
+
+// What udpThread sends: input, then the reliable channel's ack and due messages
+sf::Socket::Status sendInput(ClientSide& client, sf::UdpSocket& socket, float now) {
+    return sendToServer(socket, "10.0.0.1", [&](DatagramBuilder& builder) {
+        appendInput(builder);
+        client.reliable.write(builder, now);
+    });
+}
+
+// What fireWeapon sends
+sf::Socket::Status sendShot(sf::UdpSocket& socket) {
+    ShotPacket shot = {};
+    shot.playerId = CLIENT_PLAYER_ID;
+    shot.dirX = 1.0f;
+    return sendToServer(socket, "10.0.0.1", [&](DatagramBuilder& builder) {
+        builder.appendShot(shot);
+    });
+}
+
+// The server's ack reaches the client (as the next server datagram would carry it)
+void ackToClient(ServerSide& server, ClientSide& client, float now) {
+    std::vector<uint8_t> datagram;
+    DatagramBuilder builder([&](const uint8_t* data, size_t size, size_t) {
+        datagram.assign(data, data + size);
+    }, 0);
+    server.reliable.write(builder, now);
+    builder.flush();
+    
+    size_t at = WIRE_HEADER_BYTES;
+    ASSERT_TRUE(datagram.size() == at + WIRE_MESSAGE_HEADER_BYTES + RELIABLE_ACK_MESSAGE_BYTES);
+    const ReliableAckMessageView ack(datagram.data() + at + WIRE_MESSAGE_HEADER_BYTES);
+    client.reliable.onAck(ack.nextExpected(), ack.received(), now);
+}
+
+// ========================
+// Tests
+// ========================
+
+// Input plus a full window of purchases is one datagram larger than the old
+// 256-byte receive buffer; all of it decodes
+TEST(FullReliableWindowArrivesWhole) {
+    ClientSide client;
+    ServerSide server;
+    sf::UdpSocket serverSocket;
+    queuePurchases(client, ReliableChannel::WINDOW);
+    
+    clientSend(client, serverSocket, 0.0f);
+    serverReceive(serverSocket, server);
+    
+    ASSERT_EQ(1, static_cast<int>(server.datagrams));
+    ASSERT_TRUE(server.largest > 256);
+    ASSERT_TRUE(server.largest <= sizeof(InboundDatagram::data));
+    ASSERT_EQ(0, static_cast<int>(server.rejected));
+    ASSERT_EQ(1, static_cast<int>(server.inputs));
+    ASSERT_EQ(ReliableChannel::WINDOW, static_cast<int>(server.purchases));
+}
+
+// The window's first send is lost: the resend has the same size and gets
+// through, and once acknowledged the purchases behind the window follow
+TEST(ResentWindowIsAccepted) {
+    ClientSide client;
+    ServerSide server;
+    sf::UdpSocket serverSocket;
+    const int queued = ReliableChannel::WINDOW + 8;
+    queuePurchases(client, queued);
+    
+    clientSend(client, serverSocket, 0.0f);
+    const size_t firstSize = client.largest;
+    serverSocket.queue.clear();
+    
+    clientSend(client, serverSocket, 1.0f);
+    ASSERT_EQ(static_cast<int>(firstSize), static_cast<int>(serverSocket.queue.front().bytes.size()));
+    serverReceive(serverSocket, server);
+    ASSERT_EQ(0, static_cast<int>(server.rejected));
+    ASSERT_EQ(ReliableChannel::WINDOW, static_cast<int>(server.purchases));
+    
+    ackToClient(server, client, 1.1f);
+    clientSend(client, serverSocket, 1.2f);
+    serverReceive(serverSocket, server);
+    ASSERT_EQ(0, static_cast<int>(server.rejected));
+    ASSERT_EQ(queued, static_cast<int>(server.purchases));
+    ASSERT_EQ(2, static_cast<int>(server.inputs));
+}
+
+// A window of the largest reliable messages needs more than one datagram;
+// every one fits the receive buffer and all messages are delivered in order
+TEST(LargestReliableMessagesSplitWithinTheBuffer) {
+    ClientSide client;
+    ServerSide server;
+    sf::UdpSocket serverSocket;
+    queueLargestMessages(client, ReliableChannel::WINDOW);
+    
+    clientSend(client, serverSocket, 0.0f);
+    serverReceive(serverSocket, server);
+    
+    ASSERT_TRUE(server.datagrams > 1);
+    ASSERT_TRUE(server.largest <= sizeof(InboundDatagram::data));
+    ASSERT_EQ(0, static_cast<int>(server.rejected));
+    ASSERT_EQ(1, static_cast<int>(server.inputs));
+    ASSERT_EQ(ReliableChannel::WINDOW, static_cast<int>(server.delivered));
+}
+
+// A send split over two datagrams claims a sequence for each: the shot sent
+// next gets the one after them, and the server counts no duplicates or loss
+TEST(SplitSendClaimsASequencePerDatagram) {
+    Connection connection;
+    ClientSide client;
+    ServerSide server;
+    queueLargestMessages(client, ReliableChannel::WINDOW);
+    
+    ASSERT_EQ(sf::Socket::Done, sendInput(client, connection.clientSocket, 0.0f));
+    ASSERT_EQ(sf::Socket::Done, sendShot(connection.clientSocket));
+    ASSERT_EQ(3, static_cast<int>(outgoingSequence.load()));
+    
+    serverReceive(connection.serverSocket, server);
+    ASSERT_EQ(3, static_cast<int>(server.datagrams));
+    ASSERT_EQ(0, static_cast<int>(server.rejected));
+    ASSERT_EQ(1, static_cast<int>(server.shots));
+    ASSERT_EQ(ReliableChannel::WINDOW, static_cast<int>(server.delivered));
+    ASSERT_EQ(3, static_cast<int>(server.sequences.received()));
+    ASSERT_EQ(0, static_cast<int>(server.sequences.duplicates()));
+    ASSERT_EQ(0, static_cast<int>(server.sequences.lost()));
+}
+
+// The first of two datagrams fails to send: the send reports it although the
+// last one went out, and its sequence stays used (the server sees a loss)
+TEST(SendReportsAnyFailedDatagram) {
+    Connection connection;
+    ClientSide client;
+    ServerSide server;
+    ASSERT_EQ(sf::Socket::Done, sendShot(connection.clientSocket));
+    queueLargestMessages(client, ReliableChannel::WINDOW);
+    connection.clientSocket.failing = 1;
+    
+    ASSERT_EQ(sf::Socket::Error, sendInput(client, connection.clientSocket, 0.0f));
+    ASSERT_EQ(3, static_cast<int>(outgoingSequence.load()));
+    
+    serverReceive(connection.serverSocket, server);
+    ASSERT_EQ(2, static_cast<int>(server.datagrams));
+    ASSERT_EQ(1, static_cast<int>(server.sequences.lost()));
+}
+
+// More than a datagram's worth of reliable messages queued behind the input,
+// with a shot after every send: each datagram fits the receive buffer and
+// decodes, every sequence arrives once, and the server's acks let the messages
+// past the window follow in order
+TEST(QueuedMessagesOverOneDatagramRoundTrip) {
+    Connection connection;
+    ClientSide client;
+    ServerSide server;
+    const int queued = 2 * ReliableChannel::WINDOW + 8;
+    queueLargestMessages(client, queued);
+    ASSERT_TRUE(queued * (WIRE_MESSAGE_HEADER_BYTES + RELIABLE_MESSAGE_HEADER_BYTES + MAX_RELIABLE_BODY_BYTES) >
+                MAX_DATAGRAM_BYTES);
+    
+    float now = 0.0f;
+    int sends = 0;
+    while (server.delivered < static_cast<size_t>(queued) && sends < 10) {
+        ASSERT_EQ(sf::Socket::Done, sendInput(client, connection.clientSocket, now));
+        ASSERT_EQ(sf::Socket::Done, sendShot(connection.clientSocket));
+        serverReceive(connection.serverSocket, server);
+        ackToClient(server, client, now + 0.01f);
+        now += 0.05f;
+        sends++;
+    }
+    
+    ASSERT_EQ(3, sends);
+    ASSERT_EQ(0, static_cast<int>(server.rejected));
+    ASSERT_TRUE(server.largest <= sizeof(InboundDatagram::data));
+    ASSERT_TRUE(server.datagrams > static_cast<size_t>(2 * sends));
+    ASSERT_EQ(sends, static_cast<int>(server.inputs));
+    ASSERT_EQ(sends, static_cast<int>(server.shots));
+    ASSERT_EQ(queued, static_cast<int>(server.delivered));
+    for (int i = 0; i < queued; ++i) {
+        ASSERT_EQ(i, server.deliveredTags[i]);
+    }
+    ASSERT_EQ(static_cast<int>(outgoingSequence.load()), static_cast<int>(server.sequences.received()));
+    ASSERT_EQ(0, static_cast<int>(server.sequences.duplicates()));
+    ASSERT_EQ(0, static_cast<int>(server.sequences.lost()));
+}
+
+// ========================
+// Datagram Sizes
+// ========================
+
+void reportSizes() {
+    struct Case {
+        const char* name;
+        bool largest;
+        int messages;
+    };
+    const Case cases[] = {
+        { "input only", false, 0 },
+        { "input + 8 purchases", false, 8 },
+        { "input + 32 purchases (window)", false, ReliableChannel::WINDOW },
+        { "input + 32 x 32-byte bodies", true, ReliableChannel::WINDOW },
+    };
+    
+    std::cout << std::left << std::setw(32) << "Client send" << std::right
+              << std::setw(12) << "Datagrams" << std::setw(12) << "Largest" << std::setw(12) << "Decoded" << std::endl;
+    for (const Case& c : cases) {
+        ClientSide client;
+        ServerSide server;
+        sf::UdpSocket serverSocket;
+        if (c.largest) {
+            queueLargestMessages(client, c.messages);
+        } else {
+            queuePurchases(client, c.messages);
+        }
+        clientSend(client, serverSocket, 0.0f);
+        serverReceive(serverSocket, server);
+        std::cout << std::left << std::setw(32) << c.name << std::right
+                  << std::setw(12) << server.datagrams
+                  << std::setw(10) << server.largest << " B"
+                  << std::setw(12) << (server.datagrams - server.rejected) << std::endl;
+    }
+    std::cout << "(receive buffer " << sizeof(InboundDatagram::data) << " B, previously 256 B)" << std::endl;
+}
+
+// ========================
+// Main Test Runner
+// ========================
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Zero Ground Client Datagram Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "--- Client Datagram Tests ---" << std::endl;
+    RUN_TEST(FullReliableWindowArrivesWhole);
+    RUN_TEST(ResentWindowIsAccepted);
+    RUN_TEST(LargestReliableMessagesSplitWithinTheBuffer);
+    RUN_TEST(SplitSendClaimsASequencePerDatagram);
+    RUN_TEST(SendReportsAnyFailedDatagram);
+    RUN_TEST(QueuedMessagesOverOneDatagramRoundTrip);
+
+    std::cout << std::endl;
+    std::cout << "--- Client Datagram Sizes ---" << std::endl;
+    reportSizes();
+
+    // Print summary
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Test Summary" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Total tests: " << totalTests << std::endl;
+    std::cout << "Passed: " << passedTests << std::endl;
+    std::cout << "Failed: " << failedTests << std::endl;
+    std::cout << std::endl;
+
+    if (failedTests == 0) {
+        std::cout << "✓ All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "✗ Some tests failed!" << std::endl;
+        return 1;
+    }
+}
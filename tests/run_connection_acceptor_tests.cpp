@@ -0,0 +1,1294 @@
+// Connection Acceptor Tests and Benchmark for Zero Ground
+// Checks the non-blocking join handshake: map, shops and positions reach the
+// client byte for byte through partial sends, ConnectPackets arriving in pieces,
+// invalid and over-capacity clients are turned away, stalled and vanished
+// clients time out or are dropped and free their player slot, a client joining a
+// running game gets its StartPacket, and 100 clients connecting at once all get
+// through while some of them stall. Then compares join times with the old
+// one-client-at-a-time listener loop.
+//
+// SFML networking is replaced by an in-memory network in simulated time (the
+// selector's wait advances the clock and lets the simulated clients act).
+// Code under test is copied from Zero_Ground.cpp. Build with /O2 (or -O2).
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <array>
+#include <deque>
+#include <memory>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+// ========================
+// Test Framework Macros
+// ========================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "Running test: " << #name << "..."; \
+    try { \
+        test_##name(); \
+        std::cout << " PASSED" << std::endl; \
+        passedTests++; \
+    } catch (const std::exception& e) { \
+        std::cout << " FAILED: " << e.what() << std::endl; \
+        failedTests++; \
+    } \
+    totalTests++; \
+} while(0)
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: " << #condition << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_NEAR(expected, actual, epsilon) do { \
+    if (std::abs((expected) - (actual)) > (epsilon)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << (expected) << " but got " << (actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(expected, actual) do { \
+    if ((expected) != (actual)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << static_cast<int>(expected) << " but got " << static_cast<int>(actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+// Test counters
+int totalTests = 0;
+int passedTests = 0;
+int failedTests = 0;
+
+
+// ========================
+// Simulated Network
+// ========================
+
+// One TCP connection; the server side is an sf::TcpSocket, the client a SimClient
+struct SimLink {
+    std::deque<char> toServer;
+    std::deque<char> toClient;
+    size_t window = 512;  // Bytes in flight to the client before the server's send stops
+    bool clientClosed = false;
+    bool serverClosed = false;
+    std::string address;
+};
+
+// Simulated time advances only while the acceptor waits in SocketSelector::wait
+struct SimNetwork {
+    static constexpr double STEP = 0.001;         // Seconds per simulation step
+    double now = 0.0;
+    std::deque<std::shared_ptr<SimLink>> backlog;  // Connected, not yet accepted
+    std::function<void()> step;                    // Let the clients act for one STEP
+    size_t selectorPeak = 0;                       // Most sockets in one SocketSelector
+    double stepSeconds = 0.0;                      // Wall-clock time spent in step()
+    
+    void advance() {
+        now += STEP;
+        if (step) {
+            auto begin = std::chrono::high_resolution_clock::now();
+            step();
+            stepSeconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+        }
+    }
+};
+
+SimNetwork simNet;
+
+// Minimal stand-ins for the SFML types ConnectionAcceptor uses, on top of simNet
+namespace sf {
+class Time {
+public:
+    float asSeconds() const { return seconds_; }
+    static Time fromSeconds(float s) { Time t; t.seconds_ = s; return t; }
+private:
+    float seconds_ = 0.0f;
+};
+inline Time seconds(float s) { return Time::fromSeconds(s); }
+inline Time milliseconds(int ms) { return Time::fromSeconds(ms * 0.001f); }
+    
+class Clock {
+public:
+    Time getElapsedTime() const { return seconds(static_cast<float>(simNet.now - start_)); }
+private:
+    double start_ = simNet.now;
+};
+    
+class IpAddress {
+public:
+    IpAddress() {}
+    IpAddress(const std::string& text) : text_(text) {}
+    std::string toString() const { return text_; }
+private:
+    std::string text_;
+};
+    
+class Socket {
+public:
+    enum Status { Done, NotReady, Partial, Disconnected, Error };
+    virtual ~Socket() {}
+    void setBlocking(bool blocking) { blocking_ = blocking; }
+    bool isBlocking() const { return blocking_; }
+    virtual bool readable() const = 0;
+private:
+    bool blocking_ = true;
+};
+    
+class TcpSocket : public Socket {
+public:
+    IpAddress getRemoteAddress() const { return IpAddress(link ? link->address : ""); }
+    
+    Status send(const void* data, std::size_t size, std::size_t& sent) {
+        sent = 0;
+        if (!link || link->clientClosed) {
+            return Disconnected;
+        }
+        const size_t room = link->window > link->toClient.size() ? link->window - link->toClient.size() : 0;
+        sent = std::min(room, size);
+        const char* bytes = static_cast<const char*>(data);
+        link->toClient.insert(link->toClient.end(), bytes, bytes + sent);
+        if (sent == size) {
+            return Done;
+        }
+        return sent > 0 ? Partial : NotReady;
+    }
+    
+    Status receive(void* data, std::size_t size, std::size_t& received) {
+        received = 0;
+        if (!link) {
+            return Error;
+        }
+        if (!link->toServer.empty()) {
+            received = std::min(size, link->toServer.size());
+            std::copy(link->toServer.begin(), link->toServer.begin() + received, static_cast<char*>(data));
+            link->toServer.erase(link->toServer.begin(), link->toServer.begin() + received);
+            return Done;
+        }
+        return link->clientClosed ? Disconnected : NotReady;
+    }
+    
+    void disconnect() {
+        if (link) {
+            link->serverClosed = true;
+        }
+    }
+    
+    bool readable() const override { return link && (!link->toServer.empty() || link->clientClosed); }
+    
+    std::shared_ptr<SimLink> link;
+};
+    
+class TcpListener : public Socket {
+public:
+    Status accept(TcpSocket& socket) {
+        if (simNet.backlog.empty()) {
+            return NotReady;
+        }
+        socket.link = simNet.backlog.front();
+        simNet.backlog.pop_front();
+        return Done;
+    }
+    
+    bool readable() const override { return !simNet.backlog.empty(); }
+};
+    
+class SocketSelector {
+public:
+    void add(Socket& socket) {
+        if (std::find(sockets_.begin(), sockets_.end(), &socket) == sockets_.end()) {
+            sockets_.push_back(&socket);
+            simNet.selectorPeak = std::max(simNet.selectorPeak, sockets_.size());
+        }
+    }
+    
+    void remove(Socket& socket) {
+        sockets_.erase(std::remove(sockets_.begin(), sockets_.end(), &socket), sockets_.end());
+    }
+    
+    // Returns at once if a socket is readable, else steps simulated time until one
+    // is or the timeout passes
+    bool wait(Time timeout) {
+        const double end = simNet.now + timeout.asSeconds() - 1e-9;
+        while (true) {
+            ready_.clear();
+            for (Socket* socket : sockets_) {
+                if (socket->readable()) {
+                    ready_.push_back(socket);
+                }
+            }
+            if (!ready_.empty()) {
+                return true;
+            }
+            if (simNet.now >= end) {
+                return false;
+            }
+            simNet.advance();
+        }
+    }
+    
+    bool isReady(Socket& socket) const {
+        return std::find(ready_.begin(), ready_.end(), &socket) != ready_.end();
+    }
+    
+private:
+    std::vector<Socket*> sockets_;
+    std::vector<Socket*> ready_;
+};
+}
+
+// Stand-in for the game's logging; the tests only count warnings
+struct ErrorHandler {
+    static int warnings;
+    static void handleInvalidPacket(const std::string&, const std::string& = "") { warnings++; }
+    static void handleConnectionLost(const std::string&) {}
+    static void logTCPError(const std::string&, sf::Socket::Status, const std::string& = "") { warnings++; }
+    static void logInfo(const std::string&) {}
+    static void logWarning(const std::string&) { warnings++; }
+};
+int ErrorHandler::warnings = 0;
+
+// ========================
+// Code Under Test (copied from Zero_Ground.cpp)
+// ========================
+
+enum class MessageType : uint8_t {
+    CLIENT_CONNECT = 0x01,
+    SERVER_ACK = 0x02,
+    CLIENT_READY = 0x03,
+    SERVER_START = 0x04,
+    MAP_DATA = 0x05
+};
+
+struct ConnectPacket {
+    MessageType type = MessageType::CLIENT_CONNECT;
+    uint32_t protocolVersion = 1;
+    char playerName[32] = {0};
+};
+
+struct ReadyPacket {
+    MessageType type = MessageType::CLIENT_READY;
+    bool isReady = true;
+};
+
+struct StartPacket {
+    MessageType type = MessageType::SERVER_START;
+    uint32_t timestamp = 0;
+    uint16_t tickRate = 0;  // Server simulation ticks per second (snapshot ticks -> time)
+};
+
+struct PositionPacket {
+    float x = 0.0f;
+    float y = 0.0f;
+    float rotation = 0.0f;  // Player rotation angle in degrees
+    float health = 100.0f;
+    bool isAlive = true;
+    uint32_t frameID = 0;
+    uint8_t playerId = 0;
+};
+
+bool validateConnect(const ConnectPacket& packet) {
+    bool valid = packet.protocolVersion == 1 &&
+                 std::strlen(packet.playerName) < 32;
+    
+    if (!valid) {
+        std::ostringstream oss;
+        oss << "Invalid connect packet - Protocol version: " << packet.protocolVersion 
+            << ", Name length: " << std::strlen(packet.playerName);
+        ErrorHandler::handleInvalidPacket(oss.str());
+    }
+    
+    return valid;
+}
+
+const uint32_t HOST_PLAYER_ID = 0;
+const uint32_t MAX_PLAYERS = 64;
+
+// Append the raw bytes of a TCP handshake packet to a send buffer
+// The join handshake sends packets in their in-memory layout (client and server share it)
+template <typename T>
+void appendPacket(std::vector<char>& out, const T& packet) {
+    const char* bytes = reinterpret_cast<const char*>(&packet);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+// One TCP connection between accept and hand-over to connectedClients
+//
+// Stages:
+//   AwaitConnect - reading the ConnectPacket (CONNECT_TIMEOUT)
+//   SendWorld    - flushing map, shops and the two PositionPackets (SEND_TIMEOUT)
+//   AwaitReady   - reading the ReadyPacket; no deadline, the player readies up when they like
+//   SendStart    - flushing the StartPacket to a client joining a running game (SEND_TIMEOUT)
+struct PendingConnection {
+    enum class Stage { AwaitConnect, SendWorld, AwaitReady, SendStart };
+    
+    std::unique_ptr<sf::TcpSocket> socket;
+    sf::IpAddress address;
+    Stage stage = Stage::AwaitConnect;
+    uint32_t playerId = HOST_PLAYER_ID;  // HOST_PLAYER_ID until admitted
+    std::array<char, sizeof(ConnectPacket)> inbox;
+    size_t inboxBytes = 0;
+    std::vector<char> outbox;            // Unsent bytes start at outboxSent
+    size_t outboxSent = 0;
+    float deadline = 0.0f;               // Seconds on the acceptor's clock
+    bool watched = false;                // In the acceptor's selector
+    bool closed = false;
+};
+
+// What ConnectionAcceptor calls into the game for; the acceptor keeps no game state
+struct AcceptorHooks {
+    // A valid ConnectPacket arrived: take a player slot and spawn point and append
+    // the two initial PositionPackets to out
+    // Returns: the player ID, or HOST_PLAYER_ID if the server is full
+    std::function<uint32_t(const sf::IpAddress& address, std::vector<char>& out)> admit;
+    // Map, shops and positions reached the client
+    std::function<void(const PendingConnection& conn)> welcomed;
+    // The client is ready: move conn.socket into connectedClients
+    // Returns: false instead if the game is already running, after appending a
+    // StartPacket to conn.outbox; the acceptor flushes it and calls started
+    std::function<bool(PendingConnection& conn)> ready;
+    // The StartPacket reached a client joining a running game: move conn.socket into connectedClients
+    std::function<void(PendingConnection& conn)> started;
+    // An admitted client disconnected or timed out before hand-over: free its player slot
+    std::function<void(const PendingConnection& conn)> dropped;
+};
+
+struct AcceptorStats {
+    uint64_t accepted = 0;
+    uint64_t admitted = 0;
+    uint64_t rejected = 0;    // Invalid ConnectPacket or server full
+    uint64_t handedOver = 0;  // Ready clients moved into connectedClients
+    uint64_t timedOut = 0;
+    uint64_t dropped = 0;     // Admitted, then lost before hand-over
+};
+
+// Runs the join handshake of every connecting client on one thread, without blocking
+//
+// ALGORITHM:
+// Listener and client sockets are non-blocking. Each poll() waits on one
+// sf::SocketSelector for the listener and the sockets still in their timed
+// handshake, then:
+// 1. Accepts every queued connection
+// 2. Receives whatever bytes arrived into each connection's inbox; a complete
+//    ConnectPacket admits the player and queues map + shops + positions, a
+//    complete ReadyPacket hands the socket over
+// 3. Sends as much of each outbox as the socket takes (Partial keeps the rest)
+// 4. Drops connections past their deadline, freeing their player slot
+// The map and shop bytes are serialized once (world) and copied into each outbox,
+// so a join costs one memcpy of ~1.4 KB instead of 2 + shop count blocking sends.
+// A client that stops reading or never sends its ConnectPacket holds nothing but
+// its own buffer until its deadline; every other join carries on meanwhile.
+//
+// Connections waiting for the player to ready up leave the selector and are read
+// once per poll instead: sf::SocketSelector holds at most FD_SETSIZE sockets (64
+// on Windows), and up to MAX_PLAYERS - 1 clients can sit in that stage. So does a
+// connection whose ReadyPacket came before the world was sent - it would keep the
+// selector waking up with bytes nobody reads yet.
+//
+// PERFORMANCE:
+// - The selector cannot wait for writability, so while any outbox is non-empty
+//   poll() waits at most FLUSH_INTERVAL; otherwise it sleeps until a socket is
+//   readable or maxWait passes
+// - MAX_HANDSHAKES bounds the selector; at the cap the listener leaves it too and
+//   further connections wait in the listener backlog until a handshake moves on
+class ConnectionAcceptor {
+public:
+    static constexpr float CONNECT_TIMEOUT = 5.0f;   // Accept -> complete ConnectPacket
+    static constexpr float SEND_TIMEOUT = 10.0f;     // Whole world (or StartPacket) transfer
+    static constexpr float FLUSH_INTERVAL = 0.002f;  // Poll period while any outbox is non-empty
+    static const size_t MAX_HANDSHAKES = 63;         // Selector sockets besides the listener
+    
+    ConnectionAcceptor(sf::TcpListener& listener, std::vector<char> world, AcceptorHooks hooks)
+        : listener_(listener), world_(std::move(world)), hooks_(std::move(hooks)) {
+        listener_.setBlocking(false);
+    }
+    
+    // Wait up to maxWait (non-zero) for socket activity, then advance every connection
+    void poll(sf::Time maxWait) {
+        size_t watchedCount = 0;
+        bool sending = false;
+        for (const PendingConnection& conn : pending_) {
+            watchedCount += conn.watched ? 1 : 0;
+            sending = sending || !conn.outbox.empty();
+        }
+        const bool listening = watchedCount < MAX_HANDSHAKES;
+        if (listening != listening_) {
+            if (listening) {
+                selector_.add(listener_);
+            } else {
+                selector_.remove(listener_);
+            }
+            listening_ = listening;
+        }
+        
+        if (selector_.wait(sending ? sf::seconds(FLUSH_INTERVAL) : maxWait)) {
+            if (listening_ && selector_.isReady(listener_)) {
+                acceptAll(watchedCount);
+            }
+            for (PendingConnection& conn : pending_) {
+                if (!conn.closed && conn.watched && selector_.isReady(*conn.socket)) {
+                    receive(conn);
+                }
+            }
+        }
+        
+        for (PendingConnection& conn : pending_) {
+            if (!conn.closed && conn.stage == PendingConnection::Stage::AwaitReady) {
+                receive(conn);
+            }
+            if (!conn.closed && !conn.outbox.empty()) {
+                flush(conn);
+            }
+        }
+        
+        const float now = clock_.getElapsedTime().asSeconds();
+        for (PendingConnection& conn : pending_) {
+            if (!conn.closed && conn.stage != PendingConnection::Stage::AwaitReady && now >= conn.deadline) {
+                ErrorHandler::logWarning("Join handshake with " + conn.address.toString() + " timed out");
+                stats_.timedOut++;
+                drop(conn);
+            }
+        }
+        
+        for (PendingConnection& conn : pending_) {
+            if (conn.closed && conn.socket) {
+                unwatch(conn);
+                conn.socket->disconnect();
+            }
+        }
+        pending_.erase(std::remove_if(pending_.begin(), pending_.end(),
+                                      [](const PendingConnection& conn) { return conn.closed; }),
+                       pending_.end());
+    }
+    
+    size_t pending() const { return pending_.size(); }
+    const AcceptorStats& stats() const { return stats_; }
+    
+private:
+    void unwatch(PendingConnection& conn) {
+        if (conn.watched) {
+            selector_.remove(*conn.socket);
+            conn.watched = false;
+        }
+    }
+    
+    void acceptAll(size_t watchedCount) {
+        while (watchedCount < MAX_HANDSHAKES) {
+            auto socket = std::make_unique<sf::TcpSocket>();
+            sf::Socket::Status status = listener_.accept(*socket);
+            if (status != sf::Socket::Done) {
+                if (status != sf::Socket::NotReady) {
+                    ErrorHandler::logTCPError("Accept client connection", status);
+                }
+                return;
+            }
+            
+            socket->setBlocking(false);
+            PendingConnection conn;
+            conn.address = socket->getRemoteAddress();
+            conn.socket = std::move(socket);
+            conn.deadline = clock_.getElapsedTime().asSeconds() + CONNECT_TIMEOUT;
+            conn.watched = true;
+            selector_.add(*conn.socket);
+            pending_.push_back(std::move(conn));
+            stats_.accepted++;
+            watchedCount++;
+            ErrorHandler::logInfo("Accepted connection from " + pending_.back().address.toString());
+        }
+    }
+    
+    // Read the rest of the packet the current stage expects
+    void receive(PendingConnection& conn) {
+        const bool connecting = conn.stage == PendingConnection::Stage::AwaitConnect;
+        const size_t expected = connecting ? sizeof(ConnectPacket) : sizeof(ReadyPacket);
+        
+        std::size_t received = 0;
+        sf::Socket::Status status = conn.socket->receive(conn.inbox.data() + conn.inboxBytes,
+                                                         expected - conn.inboxBytes, received);
+        if (status == sf::Socket::Disconnected) {
+            ErrorHandler::handleConnectionLost(conn.address.toString());
+            drop(conn);
+            return;
+        }
+        if (status != sf::Socket::Done) {
+            if (status != sf::Socket::NotReady) {
+                ErrorHandler::logTCPError(connecting ? "Receive ConnectPacket" : "Receive ReadyPacket",
+                                          status, conn.address.toString());
+                drop(conn);
+            }
+            return;
+        }
+        
+        conn.inboxBytes += received;
+        if (conn.inboxBytes < expected) {
+            return;
+        }
+        if (connecting) {
+            onConnect(conn);
+        } else if (conn.stage == PendingConnection::Stage::AwaitReady) {
+            onReady(conn);
+        } else {
+            unwatch(conn);  // Early ReadyPacket, taken once the world is sent
+        }
+    }
+    
+    void onConnect(PendingConnection& conn) {
+        ConnectPacket packet;
+        std::memcpy(&packet, conn.inbox.data(), sizeof(packet));
+        conn.inboxBytes = 0;
+        if (!validateConnect(packet)) {
+            ErrorHandler::handleInvalidPacket("ConnectPacket validation failed", conn.address.toString());
+            stats_.rejected++;
+            drop(conn);
+            return;
+        }
+        ErrorHandler::logInfo("Player name: " + std::string(packet.playerName));
+        
+        conn.outbox = world_;
+        conn.outboxSent = 0;
+        const uint32_t playerId = hooks_.admit(conn.address, conn.outbox);
+        if (playerId == HOST_PLAYER_ID) {
+            ErrorHandler::logWarning("Server full (" + std::to_string(MAX_PLAYERS - 1) +
+                                     " clients), rejecting " + conn.address.toString());
+            stats_.rejected++;
+            drop(conn);
+            return;
+        }
+        
+        conn.playerId = playerId;
+        conn.stage = PendingConnection::Stage::SendWorld;
+        conn.deadline = clock_.getElapsedTime().asSeconds() + SEND_TIMEOUT;
+        stats_.admitted++;
+        ErrorHandler::logInfo("Client " + conn.address.toString() + " is player " + std::to_string(playerId));
+    }
+    
+    void onReady(PendingConnection& conn) {
+        ReadyPacket packet;
+        std::memcpy(&packet, conn.inbox.data(), sizeof(packet));
+        conn.inboxBytes = 0;
+        if (packet.type != MessageType::CLIENT_READY || !packet.isReady) {
+            ErrorHandler::handleInvalidPacket("ReadyPacket validation failed", conn.address.toString());
+            return;
+        }
+        ErrorHandler::logInfo("Client " + conn.address.toString() + " is ready");
+        
+        if (hooks_.ready(conn)) {
+            handOver(conn);
+            return;
+        }
+        conn.stage = PendingConnection::Stage::SendStart;
+        conn.deadline = clock_.getElapsedTime().asSeconds() + SEND_TIMEOUT;
+    }
+    
+    void flush(PendingConnection& conn) {
+        std::size_t sent = 0;
+        sf::Socket::Status status = conn.socket->send(conn.outbox.data() + conn.outboxSent,
+                                                      conn.outbox.size() - conn.outboxSent, sent);
+        conn.outboxSent += sent;
+        if (status == sf::Socket::Disconnected || status == sf::Socket::Error) {
+            ErrorHandler::logTCPError("Send join handshake", status, conn.address.toString());
+            drop(conn);
+            return;
+        }
+        if (conn.outboxSent < conn.outbox.size()) {
+            return;  // Partial or NotReady: the rest goes out on a later poll
+        }
+        
+        conn.outbox.clear();
+        conn.outboxSent = 0;
+        if (conn.stage == PendingConnection::Stage::SendWorld) {
+            ErrorHandler::logInfo("Sent map, shops and positions to " + conn.address.toString());
+            unwatch(conn);
+            conn.stage = PendingConnection::Stage::AwaitReady;
+            hooks_.welcomed(conn);
+            if (conn.inboxBytes == sizeof(ReadyPacket)) {
+                onReady(conn);
+            }
+        } else if (conn.stage == PendingConnection::Stage::SendStart) {
+            ErrorHandler::logInfo("Sent StartPacket to " + conn.address.toString());
+            hooks_.started(conn);
+            handOver(conn);
+        }
+    }
+    
+    // The hook took conn.socket (never in the selector in these stages)
+    void handOver(PendingConnection& conn) {
+        stats_.handedOver++;
+        conn.closed = true;
+    }
+    
+    void drop(PendingConnection& conn) {
+        if (conn.playerId != HOST_PLAYER_ID) {
+            hooks_.dropped(conn);
+            stats_.dropped++;
+        }
+        conn.closed = true;
+    }
+    
+    sf::TcpListener& listener_;
+    std::vector<char> world_;  // Map + shops, identical for every client
+    AcceptorHooks hooks_;
+    sf::SocketSelector selector_;
+    bool listening_ = false;   // Listener in the selector
+    std::vector<PendingConnection> pending_;
+    sf::Clock clock_;
+    AcceptorStats stats_;
+};
+
+// ========================
+// Helpers
+// ========================
+
+const size_t MAP_BYTES = 1328;  // CellGrid::BYTE_SIZE
+const size_t SHOP_COUNT = 4;
+
+// Same layout as appendMapData + appendShopData, with made-up contents
+std::vector<char> makeWorld() {
+    std::vector<char> world;
+    appendPacket(world, static_cast<uint32_t>(MAP_BYTES));
+    std::mt19937 rng(5);
+    for (size_t i = 0; i < MAP_BYTES; ++i) {
+        world.push_back(static_cast<char>(rng() & 0xFF));
+    }
+    appendPacket(world, static_cast<uint8_t>(SHOP_COUNT));
+    for (size_t i = 0; i < SHOP_COUNT; ++i) {
+        appendPacket(world, static_cast<int32_t>(10 + i));
+        appendPacket(world, static_cast<int32_t>(40 - i));
+    }
+    return world;
+}
+
+// Packets go out with their padding bytes, so the tests zero them to compare streams
+template <typename T>
+T zeroedPacket() {
+    T packet;
+    std::memset(static_cast<void*>(&packet), 0, sizeof(packet));
+    return packet;
+}
+
+void appendPositions(std::vector<char>& out, uint32_t playerId) {
+    PositionPacket server = zeroedPacket<PositionPacket>();
+    server.isAlive = true;
+    server.playerId = HOST_PLAYER_ID;
+    appendPacket(out, server);
+    PositionPacket client = zeroedPacket<PositionPacket>();
+    client.x = 100.0f * playerId;
+    client.y = 50.0f;
+    client.isAlive = true;
+    client.playerId = static_cast<uint8_t>(playerId);
+    appendPacket(out, client);
+}
+
+void appendStart(std::vector<char>& out) {
+    StartPacket start = zeroedPacket<StartPacket>();
+    start.type = MessageType::SERVER_START;
+    start.timestamp = 1234;
+    start.tickRate = 60;
+    appendPacket(out, start);
+}
+
+// What a client with playerId must receive, in order
+std::vector<char> expectedHandshake(const std::vector<char>& world, uint32_t playerId) {
+    std::vector<char> bytes = world;
+    appendPositions(bytes, playerId);
+    return bytes;
+}
+
+// The game side of AcceptorHooks: player slots, ready clients
+struct SimGame {
+    std::array<bool, MAX_PLAYERS> used{};
+    bool running = false;
+    std::vector<std::unique_ptr<sf::TcpSocket>> readySockets;
+    std::vector<uint32_t> readyIds;
+    std::vector<double> readyAt;  // Simulated time of each hand-over
+    int welcomed = 0;
+    int dropped = 0;
+    
+    AcceptorHooks hooks() {
+        AcceptorHooks hooks;
+        hooks.admit = [this](const sf::IpAddress&, std::vector<char>& out) -> uint32_t {
+            for (uint32_t id = 1; id < MAX_PLAYERS; ++id) {
+                if (!used[id]) {
+                    used[id] = true;
+                    appendPositions(out, id);
+                    return id;
+                }
+            }
+            return HOST_PLAYER_ID;
+        };
+        hooks.welcomed = [this](const PendingConnection&) { welcomed++; };
+        hooks.ready = [this](PendingConnection& conn) {
+            if (running) {
+                appendStart(conn.outbox);
+                return false;
+            }
+            take(conn);
+            return true;
+        };
+        hooks.started = [this](PendingConnection& conn) { take(conn); };
+        hooks.dropped = [this](const PendingConnection& conn) {
+            used[conn.playerId] = false;
+            dropped++;
+        };
+        return hooks;
+    }
+    
+    void take(PendingConnection& conn) {
+        readySockets.push_back(std::move(conn.socket));
+        readyIds.push_back(conn.playerId);
+        readyAt.push_back(simNet.now);
+    }
+    
+    int usedSlots() const {
+        return static_cast<int>(std::count(used.begin(), used.end(), true));
+    }
+};
+
+enum class ClientKind {
+    Normal,
+    Fragmented,    // ConnectPacket in three pieces over 30 ms
+    SlowReader,    // Reads 64 bytes every 5 ms
+    Stalled,       // Connects, never sends its ConnectPacket
+    StopsReading,  // Sends its ConnectPacket, never reads
+    Vanishes,      // Disconnects after reading 300 bytes
+    EarlyReady     // Sends its ReadyPacket right after the ConnectPacket
+};
+
+// One client in the simulation, acting once per SimNetwork::STEP
+struct SimClient {
+    ClientKind kind = ClientKind::Normal;
+    std::shared_ptr<SimLink> link;
+    double connectedAt = 0.0;
+    uint32_t protocolVersion = 1;
+    size_t handshakeBytes = 0;  // World + positions
+    bool sendsReady = true;
+    double readyDelay = 0.02;   // Player's time to press Ready
+    
+    std::vector<char> received;
+    size_t connectSent = 0;
+    double nextRead = 0.0;
+    double completedAt = -1.0;  // All handshakeBytes in
+    double rejectedAt = -1.0;   // Server closed before that
+    bool readySent = false;
+    
+    void step(double now) {
+        if (link->clientClosed) {
+            return;
+        }
+        
+        ConnectPacket packet;
+        packet.protocolVersion = protocolVersion;
+        std::strcpy(packet.playerName, "Client");
+        if (kind != ClientKind::Stalled && connectSent < sizeof(packet)) {
+            size_t upTo = sizeof(packet);
+            if (kind == ClientKind::Fragmented) {
+                const double age = now - connectedAt;
+                upTo = age >= 0.03 ? sizeof(packet) : (age >= 0.015 ? 25 : 10);
+            }
+            const char* bytes = reinterpret_cast<const char*>(&packet);
+            link->toServer.insert(link->toServer.end(), bytes + connectSent, bytes + upTo);
+            connectSent = upTo;
+            if (kind == ClientKind::EarlyReady && connectSent == sizeof(packet)) {
+                sendReady();
+            }
+        }
+        
+        if (kind != ClientKind::StopsReading) {
+            size_t budget = link->toClient.size();
+            if (kind == ClientKind::SlowReader) {
+                budget = (now >= nextRead) ? std::min<size_t>(budget, 64) : 0;
+                if (budget > 0) {
+                    nextRead = now + 0.005;
+                }
+            }
+            if (kind == ClientKind::Vanishes) {
+                budget = std::min(budget, 300 - received.size());
+            }
+            received.insert(received.end(), link->toClient.begin(), link->toClient.begin() + budget);
+            link->toClient.erase(link->toClient.begin(), link->toClient.begin() + budget);
+            if (kind == ClientKind::Vanishes && received.size() >= 300) {
+                link->clientClosed = true;
+                return;
+            }
+        }
+        
+        if (completedAt < 0.0 && received.size() >= handshakeBytes) {
+            completedAt = now;
+        }
+        if (completedAt < 0.0 && rejectedAt < 0.0 && link->serverClosed && link->toClient.empty()) {
+            rejectedAt = now;
+        }
+        if (completedAt >= 0.0 && sendsReady && !readySent && now >= completedAt + readyDelay) {
+            sendReady();
+        }
+    }
+    
+    void sendReady() {
+        ReadyPacket ready;
+        const char* bytes = reinterpret_cast<const char*>(&ready);
+        link->toServer.insert(link->toServer.end(), bytes, bytes + sizeof(ready));
+        readySent = true;
+    }
+    
+    // Player ID from the second PositionPacket, once it is in
+    uint32_t playerId(size_t worldBytes) const {
+        if (received.size() < worldBytes + 2 * sizeof(PositionPacket)) {
+            return HOST_PLAYER_ID;
+        }
+        PositionPacket packet;
+        std::memcpy(&packet, received.data() + worldBytes + sizeof(PositionPacket), sizeof(packet));
+        return packet.playerId;
+    }
+    
+    double answeredAt() const { return completedAt >= 0.0 ? completedAt : rejectedAt; }
+};
+
+// Fresh network, game and acceptor; clients join with connect()
+struct Harness {
+    std::vector<char> world = makeWorld();
+    SimGame game;
+    sf::TcpListener listener;
+    std::unique_ptr<ConnectionAcceptor> acceptor;
+    std::vector<std::unique_ptr<SimClient>> clients;
+    double pollSeconds = 0.0;  // Wall-clock time in poll(), simulated clients excluded
+    size_t polls = 0;
+    
+    Harness() {
+        simNet = SimNetwork();
+        simNet.step = [this]() {
+            for (auto& client : clients) {
+                client->step(simNet.now);
+            }
+        };
+        ErrorHandler::warnings = 0;
+        acceptor = std::make_unique<ConnectionAcceptor>(listener, world, game.hooks());
+    }
+    
+    ~Harness() {
+        simNet.step = nullptr;
+    }
+    
+    SimClient& connect(ClientKind kind, size_t window = 512) {
+        auto client = std::make_unique<SimClient>();
+        client->kind = kind;
+        client->link = std::make_shared<SimLink>();
+        client->link->window = window;
+        client->link->address = "10.0.0." + std::to_string(clients.size() + 1);
+        client->connectedAt = simNet.now;
+        client->nextRead = simNet.now;
+        client->handshakeBytes = world.size() + 2 * sizeof(PositionPacket);
+        simNet.backlog.push_back(client->link);
+        clients.push_back(std::move(client));
+        return *clients.back();
+    }
+    
+    void runFor(double seconds) {
+        const double end = simNet.now + seconds;
+        while (simNet.now < end) {
+            const double stepBefore = simNet.stepSeconds;
+            auto begin = std::chrono::high_resolution_clock::now();
+            acceptor->poll(sf::milliseconds(50));
+            pollSeconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count()
+                           - (simNet.stepSeconds - stepBefore);
+            if (++polls > 10000000) {
+                throw std::runtime_error("poll() stopped advancing simulated time");
+            }
+        }
+    }
+    
+    bool receivedExactly(const SimClient& client, uint32_t playerId) const {
+        return client.received == expectedHandshake(world, playerId);
+    }
+};
+
+// ========================
+// Tests
+// ========================
+
+TEST(HandshakeDeliversWorldAndHandsOver) {
+    Harness h;
+    SimClient& client = h.connect(ClientKind::Normal);
+    h.runFor(0.5);
+    
+    ASSERT_TRUE(h.receivedExactly(client, 1));
+    ASSERT_EQ(1, h.game.welcomed);
+    ASSERT_EQ(1, static_cast<int>(h.game.readyIds.size()));
+    ASSERT_EQ(1, static_cast<int>(h.game.readyIds[0]));
+    ASSERT_TRUE(h.game.readySockets[0]->link == client.link);
+    ASSERT_EQ(1, static_cast<int>(h.acceptor->stats().handedOver));
+    ASSERT_EQ(0, static_cast<int>(h.acceptor->pending()));
+    ASSERT_TRUE(!client.link->serverClosed);
+    ASSERT_EQ(0, ErrorHandler::warnings);
+}
+
+TEST(PartialSendsResumeUntilAllBytesAreIn) {
+    Harness h;
+    SimClient& client = h.connect(ClientKind::SlowReader, 64);
+    h.runFor(1.0);
+    
+    // 1.4 KB through a 64-byte window, 64 bytes per 5 ms: ~23 partial sends
+    ASSERT_TRUE(h.receivedExactly(client, 1));
+    ASSERT_TRUE(client.completedAt > 0.1);
+    ASSERT_EQ(1, static_cast<int>(h.game.readyIds.size()));
+}
+
+TEST(ConnectPacketInPiecesIsReassembled) {
+    Harness h;
+    SimClient& client = h.connect(ClientKind::Fragmented);
+    h.runFor(0.5);
+    
+    ASSERT_TRUE(h.receivedExactly(client, 1));
+    ASSERT_TRUE(client.completedAt >= 0.03);
+    ASSERT_EQ(1, static_cast<int>(h.acceptor->stats().admitted));
+}
+
+TEST(InvalidConnectPacketIsRejected) {
+    Harness h;
+    SimClient& client = h.connect(ClientKind::Normal);
+    client.protocolVersion = 2;
+    h.runFor(0.2);
+    
+    ASSERT_TRUE(client.received.empty());
+    ASSERT_TRUE(client.link->serverClosed);
+    ASSERT_EQ(1, static_cast<int>(h.acceptor->stats().rejected));
+    ASSERT_EQ(0, h.game.usedSlots());
+    ASSERT_EQ(0, static_cast<int>(h.acceptor->pending()));
+}
+
+TEST(StalledClientTimesOutWithoutBlockingOthers) {
+    Harness h;
+    SimClient& stalled = h.connect(ClientKind::Stalled);
+    h.runFor(0.1);
+    SimClient& normal = h.connect(ClientKind::Normal);
+    h.runFor(0.4);
+    
+    ASSERT_TRUE(h.receivedExactly(normal, 1));
+    ASSERT_TRUE(normal.completedAt < 0.15);
+    ASSERT_TRUE(!stalled.link->serverClosed);
+    
+    h.runFor(ConnectionAcceptor::CONNECT_TIMEOUT);
+    ASSERT_TRUE(stalled.link->serverClosed);
+    ASSERT_EQ(1, static_cast<int>(h.acceptor->stats().timedOut));
+    ASSERT_EQ(0, static_cast<int>(h.acceptor->stats().dropped));  // Never held a slot
+    ASSERT_EQ(0, static_cast<int>(h.acceptor->pending()));
+}
+
+TEST(ClientThatStopsReadingIsDroppedAndFreesItsSlot) {
+    Harness h;
+    SimClient& stuck = h.connect(ClientKind::StopsReading, 256);
+    h.runFor(1.0);
+    ASSERT_EQ(1, h.game.usedSlots());
+    ASSERT_EQ(256, static_cast<int>(stuck.link->toClient.size()));
+    
+    h.runFor(ConnectionAcceptor::SEND_TIMEOUT);
+    ASSERT_TRUE(stuck.link->serverClosed);
+    ASSERT_EQ(1, static_cast<int>(h.acceptor->stats().timedOut));
+    ASSERT_EQ(1, h.game.dropped);
+    ASSERT_EQ(0, h.game.usedSlots());
+    
+    // The slot goes to the next client
+    SimClient& next = h.connect(ClientKind::Normal);
+    h.runFor(0.2);
+    ASSERT_TRUE(h.receivedExactly(next, 1));
+}
+
+TEST(ClientVanishingMidTransferFreesItsSlot) {
+    Harness h;
+    SimClient& gone = h.connect(ClientKind::Vanishes);
+    h.runFor(0.2);
+    
+    ASSERT_EQ(300, static_cast<int>(gone.received.size()));
+    ASSERT_EQ(1, h.game.dropped);
+    ASSERT_EQ(1, static_cast<int>(h.acceptor->stats().dropped));
+    ASSERT_EQ(0, h.game.usedSlots());
+    ASSERT_EQ(0, static_cast<int>(h.acceptor->pending()));
+}
+
+TEST(EarlyReadyPacketWaitsForTheWorld) {
+    Harness h;
+    SimClient& client = h.connect(ClientKind::EarlyReady, 64);
+    h.runFor(0.5);
+    
+    ASSERT_TRUE(client.readySent);
+    ASSERT_TRUE(h.receivedExactly(client, 1));
+    ASSERT_EQ(1, static_cast<int>(h.game.readyIds.size()));
+    ASSERT_TRUE(h.game.readyAt[0] > 0.02);  // 64 bytes per step: the world takes ~22 steps
+}
+
+TEST(FullServerRejectsFurtherClients) {
+    Harness h;
+    std::vector<SimClient*> waiting;
+    for (uint32_t i = 0; i < MAX_PLAYERS; ++i) {
+        SimClient& client = h.connect(ClientKind::Normal);
+        client.sendsReady = false;  // All stay in the lobby
+        waiting.push_back(&client);
+    }
+    h.runFor(1.0);
+    
+    // Lobby clients leave the selector, so the 64th is still accepted and answered
+    ASSERT_EQ(MAX_PLAYERS - 1, h.acceptor->stats().admitted);
+    ASSERT_EQ(1, static_cast<int>(h.acceptor->stats().rejected));
+    ASSERT_TRUE(waiting.back()->link->serverClosed);
+    ASSERT_TRUE(waiting.back()->received.empty());
+    for (uint32_t i = 0; i + 1 < MAX_PLAYERS; ++i) {
+        ASSERT_TRUE(h.receivedExactly(*waiting[i], i + 1));
+    }
+    ASSERT_EQ(static_cast<int>(MAX_PLAYERS - 1), static_cast<int>(h.acceptor->pending()));
+    
+    // Ready later: handed over without any further wait
+    waiting[10]->sendReady();
+    h.runFor(0.1);
+    ASSERT_EQ(1, static_cast<int>(h.game.readyIds.size()));
+    ASSERT_EQ(11, static_cast<int>(h.game.readyIds[0]));
+}
+
+TEST(JoiningRunningGameGetsStartPacket) {
+    Harness h;
+    h.game.running = true;
+    SimClient& client = h.connect(ClientKind::Normal);
+    h.runFor(0.5);
+    
+    std::vector<char> expected = expectedHandshake(h.world, 1);
+    appendStart(expected);
+    ASSERT_TRUE(client.received == expected);
+    ASSERT_EQ(1, static_cast<int>(h.game.readyIds.size()));
+    ASSERT_TRUE(h.game.readySockets[0]->link == client.link);
+}
+
+// The load test: 100 clients connect in the same instant, a fifth of them misbehaving
+TEST(HundredClientsConnectingAtOnce) {
+    Harness h;
+    for (int i = 0; i < 100; ++i) {
+        const int k = i % 20;
+        ClientKind kind = ClientKind::Normal;
+        if (k == 0) kind = ClientKind::Stalled;
+        else if (k == 1) kind = ClientKind::Vanishes;
+        else if (k == 2 || k == 3) kind = ClientKind::Fragmented;
+        else if (k == 4 || k == 5) kind = ClientKind::SlowReader;
+        else if (k == 6) kind = ClientKind::StopsReading;
+        SimClient& client = h.connect(kind);
+        client.readyDelay = 0.01 * (i % 7);
+    }
+    h.runFor(ConnectionAcceptor::SEND_TIMEOUT + 1.0);
+    
+    // Misbehaving clients that got a slot (the last ones in line may have been turned away)
+    int stuckAdmitted = 0;
+    int vanishedAdmitted = 0;
+    for (const auto& client : h.clients) {
+        stuckAdmitted += (client->kind == ClientKind::StopsReading && !client->link->toClient.empty()) ? 1 : 0;
+        vanishedAdmitted += (client->kind == ClientKind::Vanishes && !client->received.empty()) ? 1 : 0;
+    }
+    
+    const AcceptorStats& stats = h.acceptor->stats();
+    ASSERT_EQ(100, static_cast<int>(stats.accepted));
+    ASSERT_EQ(5 + stuckAdmitted, static_cast<int>(stats.timedOut));  // Stalled + stopped reading
+    ASSERT_EQ(vanishedAdmitted + stuckAdmitted, static_cast<int>(stats.dropped));
+    ASSERT_EQ(100, static_cast<int>(stats.admitted + stats.rejected + 5));
+    ASSERT_EQ(static_cast<int>(stats.handedOver), static_cast<int>(h.game.readyIds.size()));
+    ASSERT_EQ(static_cast<int>(stats.admitted), static_cast<int>(stats.handedOver + stats.dropped));
+    // Stuck clients hold their slot until SEND_TIMEOUT, vanished ones give it back at once
+    ASSERT_TRUE(vanishedAdmitted > 0);
+    ASSERT_EQ(static_cast<int>(MAX_PLAYERS - 1) - stuckAdmitted, static_cast<int>(stats.handedOver));
+    ASSERT_EQ(0, static_cast<int>(h.acceptor->pending()));
+    ASSERT_TRUE(simNet.selectorPeak <= 64);
+    
+    std::vector<bool> seen(MAX_PLAYERS, false);
+    double lastAnswer = 0.0;
+    for (const auto& client : h.clients) {
+        if (client->kind == ClientKind::Stalled || client->kind == ClientKind::Vanishes ||
+            client->kind == ClientKind::StopsReading) {
+            continue;
+        }
+        // Everyone else gets the whole world or a clean rejection, within a second
+        if (client->completedAt >= 0.0) {
+            const uint32_t id = client->playerId(h.world.size());
+            ASSERT_TRUE(id != HOST_PLAYER_ID && id < MAX_PLAYERS && !seen[id]);
+            seen[id] = true;
+            ASSERT_TRUE(h.receivedExactly(*client, id));
+        } else {
+            ASSERT_TRUE(client->rejectedAt >= 0.0 && client->received.empty());
+        }
+        lastAnswer = std::max(lastAnswer, client->answeredAt());
+    }
+    ASSERT_TRUE(lastAnswer < 1.0);
+}
+
+// ========================
+// Benchmark
+// ========================
+
+std::vector<ClientKind> crowd(int count, bool misbehaving) {
+    std::vector<ClientKind> kinds(count, ClientKind::Normal);
+    if (misbehaving) {
+        for (int i = 0; i < count; ++i) {
+            if (i % 20 == 0) kinds[i] = ClientKind::Stalled;
+            else if (i % 20 == 4 || i % 20 == 5) kinds[i] = ClientKind::SlowReader;
+        }
+    }
+    return kinds;
+}
+
+// Time until every client that can be answered has its world or its rejection
+double lastAnswer(const std::vector<std::unique_ptr<SimClient>>& clients, int& answered) {
+    double last = 0.0;
+    answered = 0;
+    for (const auto& client : clients) {
+        if (client->answeredAt() >= 0.0) {
+            answered++;
+            last = std::max(last, client->answeredAt());
+        }
+    }
+    return last;
+}
+
+// The listener loop before ConnectionAcceptor, in simulated time: accept one
+// client, block on one receive of its ConnectPacket (no timeout; fewer bytes than
+// a ConnectPacket is a size mismatch and drops the client), block until map,
+// shops and positions are sent, then sleep 100 ms
+void runSequentialModel(Harness& h, double limit) {
+    std::vector<char> world = h.world;
+    while (simNet.now < limit) {
+        if (!simNet.backlog.empty()) {
+            std::shared_ptr<SimLink> link = simNet.backlog.front();
+            simNet.backlog.pop_front();
+            while (link->toServer.empty() && !link->clientClosed && simNet.now < limit) {
+                simNet.advance();
+            }
+            const bool whole = link->toServer.size() >= sizeof(ConnectPacket);
+            link->toServer.clear();
+            
+            uint32_t playerId = HOST_PLAYER_ID;
+            for (uint32_t id = 1; whole && id < MAX_PLAYERS && playerId == HOST_PLAYER_ID; ++id) {
+                if (!h.game.used[id]) {
+                    h.game.used[id] = true;
+                    playerId = id;
+                }
+            }
+            std::vector<char> bytes;
+            if (playerId != HOST_PLAYER_ID) {
+                bytes = expectedHandshake(world, playerId);
+            }
+            size_t sent = 0;
+            while (sent < bytes.size() && !link->clientClosed && simNet.now < limit) {
+                const size_t room = link->window - std::min(link->window, link->toClient.size());
+                const size_t chunk = std::min(room, bytes.size() - sent);
+                link->toClient.insert(link->toClient.end(), bytes.begin() + sent, bytes.begin() + sent + chunk);
+                sent += chunk;
+                if (sent < bytes.size()) {
+                    simNet.advance();
+                }
+            }
+            if (playerId == HOST_PLAYER_ID) {
+                link->serverClosed = true;
+            }
+        }
+        for (int i = 0; i < 100 && simNet.now < limit; ++i) {
+            simNet.advance();
+        }
+    }
+}
+
+void benchmarkJoins() {
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::setw(34) << "Clients" << std::setw(12) << "Answered" << std::setw(14) << "Last answer"
+              << std::setw(10) << "Polls" << std::setw(14) << "CPU/client" << std::setw(15) << "Selector peak" << std::endl;
+    const double limit = 30.0;
+    for (int scenario = 0; scenario < 2; ++scenario) {
+        const bool misbehaving = scenario == 1;
+        const std::vector<ClientKind> kinds = crowd(100, misbehaving);
+        const char* label = misbehaving ? "100 (5 stalled, 10 slow readers)" : "100";
+        
+        {
+            Harness h;
+            for (ClientKind kind : kinds) {
+                h.connect(kind).sendsReady = false;
+            }
+            h.runFor(2.0);
+            int answered = 0;
+            const double last = lastAnswer(h.clients, answered);
+            std::cout << std::setw(34) << (std::string(label) + " acceptor") << std::setw(12) << answered
+                      << std::setw(12) << last << " s" << std::setw(10) << h.polls
+                      << std::setw(11) << h.pollSeconds * 1e6 / kinds.size() << " us"
+                      << std::setw(15) << simNet.selectorPeak << std::endl;
+        }
+        {
+            Harness h;
+            for (ClientKind kind : kinds) {
+                h.connect(kind).sendsReady = false;
+            }
+            runSequentialModel(h, limit);
+            int answered = 0;
+            const double last = lastAnswer(h.clients, answered);
+            std::ostringstream lastText;
+            lastText << std::fixed << std::setprecision(2) << last << " s";
+            std::cout << std::setw(34) << (std::string(label) + " old loop") << std::setw(12) << answered
+                      << std::setw(14) << (answered < static_cast<int>(kinds.size()) - (misbehaving ? 5 : 0) ? "blocked" : lastText.str())
+                      << std::setw(10) << "-" << std::setw(14) << "-" << std::setw(15) << "-" << std::endl;
+        }
+    }
+    std::cout << "63 player slots: the other 37 clients are answered by closing the connection;" << std::endl;
+    std::cout << "stalled clients are never answered (the acceptor closes them after "
+              << std::setprecision(0) << ConnectionAcceptor::CONNECT_TIMEOUT << " s); old loop stopped at "
+              << limit << " s" << std::endl;
+}
+
+// ========================
+// Main Test Runner
+// ========================
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Zero Ground Connection Acceptor Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "--- Connection Acceptor Tests ---" << std::endl;
+    RUN_TEST(HandshakeDeliversWorldAndHandsOver);
+    RUN_TEST(PartialSendsResumeUntilAllBytesAreIn);
+    RUN_TEST(ConnectPacketInPiecesIsReassembled);
+    RUN_TEST(InvalidConnectPacketIsRejected);
+    RUN_TEST(StalledClientTimesOutWithoutBlockingOthers);
+    RUN_TEST(ClientThatStopsReadingIsDroppedAndFreesItsSlot);
+    RUN_TEST(ClientVanishingMidTransferFreesItsSlot);
+    RUN_TEST(EarlyReadyPacketWaitsForTheWorld);
+    RUN_TEST(FullServerRejectsFurtherClients);
+    RUN_TEST(JoiningRunningGameGetsStartPacket);
+    RUN_TEST(HundredClientsConnectingAtOnce);
+
+    std::cout << std::endl;
+    std::cout << "--- 100 Clients Connecting at Once (simulated time, 512-byte send windows) ---" << std::endl;
+    benchmarkJoins();
+
+    // Print summary
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Test Summary" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Total tests: " << totalTests << std::endl;
+    std::cout << "Passed: " << passedTests << std::endl;
+    std::cout << "Failed: " << failedTests << std::endl;
+    std::cout << std::endl;
+
+    if (failedTests == 0) {
+        std::cout << "✓ All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "✗ Some tests failed!" << std::endl;
+        return 1;
+    }
+}
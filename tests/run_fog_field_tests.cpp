@@ -0,0 +1,1375 @@
+// Fog Visibility Field Tests and Benchmark for Zero Ground
+// Checks the client's shadow-cast fog field against the exact wall traversal,
+// the visibility table broad phase against casting every wall, the incremental
+// fog quad updates against a fresh layout, the exact traversal against the
+// previous 3-pixel ray march, and times one fog refresh per frame while walking
+// for several view sizes.
+//
+// Code under test is copied from Zero_Ground_client.cpp; the few SFML types it
+// touches are replaced by minimal stand-ins. Build with /O2 (or -O2).
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <array>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <limits>
+#include <functional>
+#include <stdexcept>
+#include <cstdint>
+
+// ========================
+// Test Framework Macros
+// ========================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "Running test: " << #name << "..."; \
+    try { \
+        test_##name(); \
+        std::cout << " PASSED" << std::endl; \
+        passedTests++; \
+    } catch (const std::exception& e) { \
+        std::cout << " FAILED: " << e.what() << std::endl; \
+        failedTests++; \
+    } \
+    totalTests++; \
+} while(0)
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: " << #condition << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_NEAR(expected, actual, epsilon) do { \
+    if (std::abs((expected) - (actual)) > (epsilon)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << (expected) << " but got " << (actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(expected, actual) do { \
+    if ((expected) != (actual)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << static_cast<int>(expected) << " but got " << static_cast<int>(actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+// Test counters
+int totalTests = 0;
+int passedTests = 0;
+int failedTests = 0;
+
+
+// ========================
+// Code Under Test (copied from Zero_Ground_client.cpp)
+// ========================
+
+// Minimal stand-ins for the SFML types used by the fog code
+namespace sf {
+struct Vector2f {
+    float x = 0.0f;
+    float y = 0.0f;
+    Vector2f() {}
+    Vector2f(float x_, float y_) : x(x_), y(y_) {}
+};
+struct Color {
+    uint8_t r = 0, g = 0, b = 0, a = 255;
+    Color() {}
+    Color(uint8_t r_, uint8_t g_, uint8_t b_, uint8_t a_ = 255) : r(r_), g(g_), b(b_), a(a_) {}
+};
+struct Vertex {
+    Vector2f position;
+    Color color;
+};
+enum PrimitiveType { Quads };
+class VertexArray {
+public:
+    void setPrimitiveType(PrimitiveType) {}
+    void resize(size_t count) { vertices_.resize(count); }
+    size_t getVertexCount() const { return vertices_.size(); }
+    Vertex& operator[](size_t index) { return vertices_[index]; }
+    const Vertex& operator[](size_t index) const { return vertices_[index]; }
+private:
+    std::vector<Vertex> vertices_;
+};
+}
+
+const float MAP_SIZE = 5100.0f;
+const float CELL_SIZE = 100.0f;
+const int GRID_SIZE = 51;
+const float WALL_WIDTH = 12.0f;
+
+// Wall types
+enum class WallType : uint8_t {
+    None = 0,      // No wall
+    Concrete = 1,  // Concrete wall (gray)
+    Wood = 2       // Wooden wall (brown)
+};
+
+// Number of set bits
+inline int popCount(uint64_t mask) {
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(mask));
+#else
+    return __builtin_popcountll(mask);
+#endif
+}
+
+// Map walls stored on the cell edges they occupy
+//
+// A wall lies on the boundary between two cells, so it is stored once per edge
+// rather than once per cell side: the right wall of (i, j) and the left wall of
+// (i + 1, j) are the same edge and can no longer disagree. Two bit-planes hold
+// the horizontal edges (top of cell (i, j), lines j = 0..GRID_SIZE) and the
+// vertical edges (left of cell (i, j), lines i = 0..GRID_SIZE), 2 bits per edge
+// holding the WallType value, 32 edges per 64-bit word. Queries outside the map
+// return WallType::None. Walls are centered on their edge (WALL_WIDTH/2 on each side).
+//
+// PERFORMANCE: 2 x 83 words = 1,328 bytes for the whole map instead of 10 KB of
+// per-cell sides, so it stays in L1 and is sent to clients as one span; wall
+// counts take one popcount per 32 edges.
+class CellGrid {
+public:
+    static constexpr int EDGES_PER_PLANE = (GRID_SIZE + 1) * GRID_SIZE;
+    static constexpr int EDGES_PER_WORD = 32;
+    static constexpr int WORDS_PER_PLANE = (EDGES_PER_PLANE + EDGES_PER_WORD - 1) / EDGES_PER_WORD;
+    static constexpr int WORD_COUNT = 2 * WORDS_PER_PLANE;
+    static constexpr size_t BYTE_SIZE = WORD_COUNT * sizeof(uint64_t);  // Serialized map size
+    
+    CellGrid() { clear(); }
+    
+    // Wall on the horizontal edge along the top of cell (i, j), j in [0, GRID_SIZE]
+    WallType horizontal(int i, int j) const {
+        if (i < 0 || i >= GRID_SIZE || j < 0 || j > GRID_SIZE) return WallType::None;
+        return get(HORIZONTAL, j * GRID_SIZE + i);
+    }
+    
+    // Wall on the vertical edge along the left of cell (i, j), i in [0, GRID_SIZE]
+    WallType vertical(int i, int j) const {
+        if (i < 0 || i > GRID_SIZE || j < 0 || j >= GRID_SIZE) return WallType::None;
+        return get(VERTICAL, i * GRID_SIZE + j);
+    }
+    
+    void setHorizontal(int i, int j, WallType type) {
+        if (i < 0 || i >= GRID_SIZE || j < 0 || j > GRID_SIZE) return;
+        set(HORIZONTAL, j * GRID_SIZE + i, type);
+    }
+    
+    void setVertical(int i, int j, WallType type) {
+        if (i < 0 || i > GRID_SIZE || j < 0 || j >= GRID_SIZE) return;
+        set(VERTICAL, i * GRID_SIZE + j, type);
+    }
+    
+    // Wall on one side of cell (i, j): 0 = top, 1 = right, 2 = bottom, 3 = left
+    WallType wall(int i, int j, int side) const {
+        switch (side) {
+            case 0: return horizontal(i, j);
+            case 1: return vertical(i + 1, j);
+            case 2: return horizontal(i, j + 1);
+            default: return vertical(i, j);
+        }
+    }
+    
+    void setWall(int i, int j, int side, WallType type) {
+        switch (side) {
+            case 0: setHorizontal(i, j, type); break;
+            case 1: setVertical(i + 1, j, type); break;
+            case 2: setHorizontal(i, j + 1, type); break;
+            default: setVertical(i, j, type); break;
+        }
+    }
+    
+    // Number of walls, a word (32 edges) at a time
+    size_t countWalls() const {
+        size_t count = 0;
+        for (uint64_t word : words_) {
+            count += popCount((word | (word >> 1)) & LOW_BITS);
+        }
+        return count;
+    }
+    
+    // Number of walls of one type (Concrete or Wood)
+    size_t countWalls(WallType type) const {
+        size_t count = 0;
+        for (uint64_t word : words_) {
+            uint64_t low = word & LOW_BITS;
+            uint64_t high = (word >> 1) & LOW_BITS;
+            count += popCount(type == WallType::Wood ? (high & ~low) : (low & ~high));
+        }
+        return count;
+    }
+    
+    // Remove every wall
+    void clear() { words_.fill(0); }
+    
+    // Clear the bit pairs that encode no wall (the value 3 and the unused tail of
+    // each plane), so nothing received from the network can corrupt the map
+    void sanitize() {
+        const int tailEdges = EDGES_PER_PLANE % EDGES_PER_WORD;
+        const uint64_t tailMask = (tailEdges == 0) ? ~0ULL : (1ULL << (tailEdges * 2)) - 1;
+        for (int w = 0; w < WORD_COUNT; w++) {
+            uint64_t invalid = words_[w] & (words_[w] >> 1) & LOW_BITS;
+            words_[w] &= ~(invalid * 3);
+            if (w % WORDS_PER_PLANE == WORDS_PER_PLANE - 1) words_[w] &= tailMask;
+        }
+    }
+    
+    // Raw storage, WORD_COUNT words: the horizontal plane, then the vertical plane
+    const uint64_t* data() const { return words_.data(); }
+    uint64_t* data() { return words_.data(); }
+    
+private:
+    static constexpr int HORIZONTAL = 0;
+    static constexpr int VERTICAL = 1;
+    static constexpr uint64_t LOW_BITS = 0x5555555555555555ULL;  // Low bit of every edge
+    
+    WallType get(int plane, int edge) const {
+        uint64_t word = words_[plane * WORDS_PER_PLANE + edge / EDGES_PER_WORD];
+        return static_cast<WallType>((word >> (edge % EDGES_PER_WORD * 2)) & 3);
+    }
+    
+    void set(int plane, int edge, WallType type) {
+        uint64_t& word = words_[plane * WORDS_PER_PLANE + edge / EDGES_PER_WORD];
+        const int shift = edge % EDGES_PER_WORD * 2;
+        word = (word & ~(3ULL << shift)) | (static_cast<uint64_t>(type) << shift);
+    }
+    
+    std::array<uint64_t, WORD_COUNT> words_;
+};
+
+// Generate map using probabilistic algorithm
+// Only cells where (i+j)%2==1 can have walls
+// Probabilities: 60% - 1 wall, 25% - 2 walls, 15% - 0 walls
+// Wall types: 70% concrete, 30% wood
+// A wall on a side shared with a neighbour that already has one there replaces it
+void generateMap(CellGrid& grid, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> probDist(0, 99);  // 0-99 for percentages
+    std::uniform_int_distribution<int> sideDist(0, 3);   // 0-3 for sides
+    std::uniform_int_distribution<int> typeDist(0, 99);  // 0-99 for wall type
+    
+    for (int i = 0; i < GRID_SIZE; i++) {
+        for (int j = 0; j < GRID_SIZE; j++) {
+            // Check condition: only cells where (i+j)%2==1 can generate walls
+            if ((i + j) % 2 == 1) {
+                int probability = probDist(gen);
+                
+                if (probability < 60) {
+                    // 60% probability - create one wall on a random side
+                    int side = sideDist(gen);
+                    // Determine wall type: 70% concrete, 30% wood
+                    WallType type = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    grid.setWall(i, j, side, type);
+                }
+                else if (probability < 85) {
+                    // 25% probability (60-84) - create two walls on different sides
+                    int side1 = sideDist(gen);
+                    int side2 = sideDist(gen);
+                    
+                    // Ensure the two sides are different
+                    while (side2 == side1) {
+                        side2 = sideDist(gen);
+                    }
+                    
+                    // Each wall gets its own type
+                    WallType type1 = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    WallType type2 = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    grid.setWall(i, j, side1, type1);
+                    grid.setWall(i, j, side2, type2);
+                }
+                // 15% probability (85-99) - no walls (do nothing)
+            }
+        }
+    }
+}
+
+// Previous line of sight check (3 px ray march), for comparison; cell sides read through CellGrid::wall
+bool legacyHasLineOfSight(sf::Vector2f from, sf::Vector2f to, const CellGrid& grid) {
+    // Calculate direction and distance
+    float dx = to.x - from.x;
+    float dy = to.y - from.y;
+    float distance = std::sqrt(dx * dx + dy * dy);
+    
+    // Normalize direction
+    if (distance < 0.1f) return true; // Same position
+    dx /= distance;
+    dy /= distance;
+    
+    // Use precise step size (3 pixels) for accurate wall detection
+    const float stepSize = 3.0f;
+    int steps = static_cast<int>(distance / stepSize);
+    
+    for (int i = 0; i <= steps; i++) {
+        float t = (i * stepSize);
+        if (t > distance) t = distance;
+        
+        float checkX = from.x + dx * t;
+        float checkY = from.y + dy * t;
+        
+        // Get cell coordinates
+        int cellX = static_cast<int>(checkX / CELL_SIZE);
+        int cellY = static_cast<int>(checkY / CELL_SIZE);
+        
+        // Check bounds
+        if (cellX < 0 || cellX >= GRID_SIZE || cellY < 0 || cellY >= GRID_SIZE) {
+            return false; // Out of bounds = blocked
+        }
+        
+        // Check walls in current cell AND adjacent cells to catch boundary walls
+        for (int offsetX = -1; offsetX <= 1; offsetX++) {
+            for (int offsetY = -1; offsetY <= 1; offsetY++) {
+                int checkCellX = cellX + offsetX;
+                int checkCellY = cellY + offsetY;
+                
+                // Skip if out of bounds
+                if (checkCellX < 0 || checkCellX >= GRID_SIZE || checkCellY < 0 || checkCellY >= GRID_SIZE) {
+                    continue;
+                }
+                
+                float cellWorldX = checkCellX * CELL_SIZE;
+                float cellWorldY = checkCellY * CELL_SIZE;
+                
+                // Check top wall
+                if (grid.wall(checkCellX, checkCellY, 0) != WallType::None) {
+                    float wallY = cellWorldY;
+                    if (checkY >= wallY - WALL_WIDTH/2 && checkY <= wallY + WALL_WIDTH/2 &&
+                        checkX >= cellWorldX && checkX <= cellWorldX + CELL_SIZE) {
+                        return false;
+                    }
+                }
+                
+                // Check right wall
+                if (grid.wall(checkCellX, checkCellY, 1) != WallType::None) {
+                    float wallX = cellWorldX + CELL_SIZE;
+                    if (checkX >= wallX - WALL_WIDTH/2 && checkX <= wallX + WALL_WIDTH/2 &&
+                        checkY >= cellWorldY && checkY <= cellWorldY + CELL_SIZE) {
+                        return false;
+                    }
+                }
+                
+                // Check bottom wall
+                if (grid.wall(checkCellX, checkCellY, 2) != WallType::None) {
+                    float wallY = cellWorldY + CELL_SIZE;
+                    if (checkY >= wallY - WALL_WIDTH/2 && checkY <= wallY + WALL_WIDTH/2 &&
+                        checkX >= cellWorldX && checkX <= cellWorldX + CELL_SIZE) {
+                        return false;
+                    }
+                }
+                
+                // Check left wall
+                if (grid.wall(checkCellX, checkCellY, 3) != WallType::None) {
+                    float wallX = cellWorldX;
+                    if (checkX >= wallX - WALL_WIDTH/2 && checkX <= wallX + WALL_WIDTH/2 &&
+                        checkY >= cellWorldY && checkY <= cellWorldY + CELL_SIZE) {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    
+    return true; // No walls blocking
+}
+
+// Slab test: does the segment (x1, y1) + t * (dx, dy), t in [0, 1], touch the rectangle?
+inline bool segmentTouchesRect(float x1, float y1, float dx, float dy,
+                               float rectX, float rectY, float rectW, float rectH) {
+    float tMin = 0.0f;
+    float tMax = 1.0f;
+    
+    const float origin[2] = { x1, y1 };
+    const float dir[2] = { dx, dy };
+    const float lo[2] = { rectX, rectY };
+    const float hi[2] = { rectX + rectW, rectY + rectH };
+    
+    for (int axis = 0; axis < 2; ++axis) {
+        if (dir[axis] == 0.0f) {
+            // Parallel to this slab: must already be inside it
+            if (origin[axis] < lo[axis] || origin[axis] > hi[axis]) return false;
+            continue;
+        }
+        float t1 = (lo[axis] - origin[axis]) / dir[axis];
+        float t2 = (hi[axis] - origin[axis]) / dir[axis];
+        if (t1 > t2) std::swap(t1, t2);
+        tMin = std::max(tMin, t1);
+        tMax = std::min(tMax, t2);
+        if (tMin > tMax) return false;
+    }
+    return true;
+}
+
+// Exact wall test: does the segment (x1, y1) -> (x2, y2) touch any wall?
+//
+// ALGORITHM: Amanda-Woo grid traversal (same walk as the server's
+// Bullet::traceCellWallsDDA); every visited cell tests the four edges around
+// it and the walk stops at the first hit.
+//
+// PERFORMANCE: visits |dCellX| + |dCellY| + 1 cells and tests only walls that
+// exist, instead of checking nine cells every 3 pixels along the segment.
+bool segmentHitsWall(const CellGrid& grid, float x1, float y1, float x2, float y2) {
+    const float dx = x2 - x1;
+    const float dy = y2 - y1;
+    const float half = WALL_WIDTH / 2.0f;
+    
+    // Walls on the four edges around cell (i, j)
+    auto cellBoundariesHit = [&](int i, int j) {
+        const float cellWorldX = i * CELL_SIZE;
+        const float cellWorldY = j * CELL_SIZE;
+        if (grid.horizontal(i, j) != WallType::None &&
+            segmentTouchesRect(x1, y1, dx, dy, cellWorldX, cellWorldY - half, CELL_SIZE, WALL_WIDTH)) return true;
+        if (grid.vertical(i + 1, j) != WallType::None &&
+            segmentTouchesRect(x1, y1, dx, dy, cellWorldX + CELL_SIZE - half, cellWorldY, WALL_WIDTH, CELL_SIZE)) return true;
+        if (grid.horizontal(i, j + 1) != WallType::None &&
+            segmentTouchesRect(x1, y1, dx, dy, cellWorldX, cellWorldY + CELL_SIZE - half, CELL_SIZE, WALL_WIDTH)) return true;
+        if (grid.vertical(i, j) != WallType::None &&
+            segmentTouchesRect(x1, y1, dx, dy, cellWorldX - half, cellWorldY, WALL_WIDTH, CELL_SIZE)) return true;
+        return false;
+    };
+    
+    int cellX = static_cast<int>(std::floor(x1 / CELL_SIZE));
+    int cellY = static_cast<int>(std::floor(y1 / CELL_SIZE));
+    const int endCellX = static_cast<int>(std::floor(x2 / CELL_SIZE));
+    const int endCellY = static_cast<int>(std::floor(y2 / CELL_SIZE));
+    
+    const int stepX = (dx > 0.0f) ? 1 : (dx < 0.0f ? -1 : 0);
+    const int stepY = (dy > 0.0f) ? 1 : (dy < 0.0f ? -1 : 0);
+    const float inf = std::numeric_limits<float>::infinity();
+    
+    float tMaxX = inf, tDeltaX = inf;
+    if (stepX != 0) {
+        tMaxX = ((cellX + (stepX > 0 ? 1 : 0)) * CELL_SIZE - x1) / dx;
+        tDeltaX = CELL_SIZE / std::abs(dx);
+    }
+    float tMaxY = inf, tDeltaY = inf;
+    if (stepY != 0) {
+        tMaxY = ((cellY + (stepY > 0 ? 1 : 0)) * CELL_SIZE - y1) / dy;
+        tDeltaY = CELL_SIZE / std::abs(dy);
+    }
+    
+    // Exact number of boundary crossings; also bounds the loop against rounding
+    int remainingSteps = std::abs(endCellX - cellX) + std::abs(endCellY - cellY);
+    
+    while (true) {
+        if (cellBoundariesHit(cellX, cellY)) return true;
+        if (remainingSteps-- <= 0) return false;
+        
+        if (tMaxX < tMaxY) {
+            cellX += stepX;
+            tMaxX += tDeltaX;
+        } else {
+            cellY += stepY;
+            tMaxY += tDeltaY;
+        }
+    }
+}
+
+// Check if there's a clear line of sight between two points (no walls blocking)
+// Returns true if visible, false if blocked by walls
+// Exact: used for players, bullets and shops (the fog uses FogVisibilityField)
+bool hasLineOfSight(sf::Vector2f from, sf::Vector2f to, const CellGrid& grid) {
+    float dx = to.x - from.x;
+    float dy = to.y - from.y;
+    if (dx * dx + dy * dy < 0.01f) return true; // Same position
+    
+    // Out of bounds = blocked
+    if (from.x < 0.0f || from.x >= MAP_SIZE || from.y < 0.0f || from.y >= MAP_SIZE ||
+        to.x < 0.0f || to.x >= MAP_SIZE || to.y < 0.0f || to.y >= MAP_SIZE) {
+        return false;
+    }
+    
+    return !segmentHitsWall(grid, from.x, from.y, to.x, to.y);
+}
+
+// ========================
+// PERFORMANCE: Potentially Visible Set
+// ========================
+
+// Line of sight between two points is mostly decided per pair of cells: a table
+// built once per map records, for every cell and every cell within PVS_RADIUS,
+// whether all of the target cell is visible, none of it is, or it depends on
+// where in the cells the two points are.
+const int PVS_RADIUS = 12;  // Cells in each direction; covers the view plus fog padding
+const int PVS_SPAN = 2 * PVS_RADIUS + 1;
+const int PVS_OFFSETS = PVS_SPAN * PVS_SPAN;
+const float PVS_SAMPLE_INSET = WALL_WIDTH / 2.0f + 2.0f;  // Keeps sample points clear of boundary walls
+
+// How much of cell B can be seen from cell A
+enum class CellVisibility : uint8_t {
+    Hidden,   // No point of B is visible from any point of A
+    Visible,  // Every point of B is visible from every point of A
+    Partial   // Depends on the points
+};
+
+// Cell-to-cell visibility for the current map (two bits per cell pair)
+//
+// ALGORITHM:
+// - Each cell is sampled at its four corners (inset past the boundary walls)
+//   and its center. A pair is Visible if all 25 rays between the samples are
+//   clear, Hidden if all are blocked, Partial otherwise.
+// - Walls are 100 px long, so a wall between two cells that are not Partial
+//   almost never slips between the sampled rays; for points inside the inset
+//   squares Visible pairs match the exact test, and Hidden pairs disagree with it
+//   for well under 0.1% of point pairs (narrow gaps between walls).
+// - Visibility is symmetric: each pair is traced once and stored for both cells.
+//
+// PERFORMANCE: queries are two bit reads. The table is 2 bits x 625 offsets per
+// cell (~400 KB for 51x51) and is built once when the map arrives.
+class VisibilityTable {
+public:
+    // Classify every cell pair within PVS_RADIUS of each other
+    void build(const CellGrid& grid) {
+        const size_t words = (static_cast<size_t>(GRID_SIZE) * GRID_SIZE * PVS_OFFSETS + 63) / 64;
+        visible_.assign(words, 0);
+        hidden_.assign(words, 0);
+        
+        for (int ax = 0; ax < GRID_SIZE; ++ax) {
+            for (int ay = 0; ay < GRID_SIZE; ++ay) {
+                // Second half of the offsets only; the mirrored pair gets the same result
+                for (int offset = PVS_OFFSETS / 2; offset < PVS_OFFSETS; ++offset) {
+                    const int bx = ax + offset % PVS_SPAN - PVS_RADIUS;
+                    const int by = ay + offset / PVS_SPAN - PVS_RADIUS;
+                    if (bx < 0 || bx >= GRID_SIZE || by < 0 || by >= GRID_SIZE) continue;
+                    
+                    CellVisibility result = classifyPair(grid, ax, ay, bx, by);
+                    store(ax, ay, offset, result);
+                    store(bx, by, PVS_OFFSETS - 1 - offset, result);
+                }
+            }
+        }
+        built_ = true;
+    }
+    
+    // Visibility of cell (bx, by) from cell (ax, ay); Partial if out of range or not built
+    CellVisibility query(int ax, int ay, int bx, int by) const {
+        const int ox = bx - ax + PVS_RADIUS;
+        const int oy = by - ay + PVS_RADIUS;
+        if (!built_ || ox < 0 || ox >= PVS_SPAN || oy < 0 || oy >= PVS_SPAN ||
+            ax < 0 || ax >= GRID_SIZE || ay < 0 || ay >= GRID_SIZE ||
+            bx < 0 || bx >= GRID_SIZE || by < 0 || by >= GRID_SIZE) {
+            return CellVisibility::Partial;
+        }
+        const size_t bit = index(ax, ay, oy * PVS_SPAN + ox);
+        if ((visible_[bit >> 6] >> (bit & 63)) & 1) return CellVisibility::Visible;
+        if ((hidden_[bit >> 6] >> (bit & 63)) & 1) return CellVisibility::Hidden;
+        return CellVisibility::Partial;
+    }
+    
+    bool isBuilt() const { return built_; }
+    
+private:
+    static size_t index(int x, int y, int offset) {
+        return (static_cast<size_t>(x) * GRID_SIZE + y) * PVS_OFFSETS + offset;
+    }
+    
+    void store(int x, int y, int offset, CellVisibility result) {
+        const size_t bit = index(x, y, offset);
+        if (result == CellVisibility::Visible) visible_[bit >> 6] |= uint64_t(1) << (bit & 63);
+        if (result == CellVisibility::Hidden) hidden_[bit >> 6] |= uint64_t(1) << (bit & 63);
+    }
+    
+    static CellVisibility classifyPair(const CellGrid& grid, int ax, int ay, int bx, int by) {
+        float axs[5], ays[5], bxs[5], bys[5];
+        samplePoints(ax, ay, axs, ays);
+        samplePoints(bx, by, bxs, bys);
+        
+        bool anyClear = false;
+        bool anyBlocked = false;
+        for (int a = 0; a < 5; ++a) {
+            for (int b = 0; b < 5; ++b) {
+                if (segmentHitsWall(grid, axs[a], ays[a], bxs[b], bys[b])) {
+                    anyBlocked = true;
+                } else {
+                    anyClear = true;
+                }
+                if (anyClear && anyBlocked) return CellVisibility::Partial;
+            }
+        }
+        return anyClear ? CellVisibility::Visible : CellVisibility::Hidden;
+    }
+    
+    // Center first: it is the ray most likely to disagree with the corners
+    static void samplePoints(int x, int y, float* xs, float* ys) {
+        const float lo = PVS_SAMPLE_INSET;
+        const float hi = CELL_SIZE - PVS_SAMPLE_INSET;
+        const float ox[5] = { CELL_SIZE / 2.0f, lo, hi, lo, hi };
+        const float oy[5] = { CELL_SIZE / 2.0f, lo, lo, hi, hi };
+        for (int k = 0; k < 5; ++k) {
+            xs[k] = x * CELL_SIZE + ox[k];
+            ys[k] = y * CELL_SIZE + oy[k];
+        }
+    }
+    
+    std::vector<uint64_t> visible_;
+    std::vector<uint64_t> hidden_;
+    bool built_ = false;
+};
+
+// Cell visibility for the current map, rebuilt by receiveMapFromServer
+VisibilityTable g_visibilityTable;
+
+// Shadow casting for the fog of war: for each of FOG_ANGLE_BINS directions
+// around the player, the distance to the nearest wall (an angular depth map).
+// A point is lit if it is closer than the wall in its direction.
+const int FOG_ANGLE_BINS = 4096;  // Power of two; ~2 px wide at 1200 px from the player
+
+// Pseudo-angle of (dx, dy) in [0, 4): increases with the real angle like
+// atan2 (counter-clockwise from +x), without trigonometry
+inline float diamondAngle(float dx, float dy) {
+    if (dy >= 0.0f) {
+        return (dx >= 0.0f) ? dy / (dx + dy) : 1.0f - dx / (-dx + dy);
+    }
+    return (dx < 0.0f) ? 2.0f - dy / (-dx - dy) : 3.0f + dx / (dx - dy);
+}
+
+// Visible region around one point, rebuilt whenever the player moves
+//
+// ALGORITHM:
+// - Walls are processed in rings of cells around the player, nearest first.
+//   Each wall rectangle covers a range of pseudo-angles (its corners); for the
+//   bins in that range the ray through the bin center is intersected with the
+//   rectangle and the bin keeps the nearest hit.
+// - Broad phase (VisibilityTable): a wall surrounded by cells Hidden from the
+//   player's cell is never reached by a ray, so it is not cast; once a whole
+//   ring is Hidden, nothing behind it is reached either and the cast stops.
+// - A bin already closer than the wall's nearest point is skipped without the
+//   ray test, so walls standing in an earlier wall's shadow cost almost nothing.
+// - Lookups compute one pseudo-angle and compare squared distances.
+//
+// PERFORMANCE: one pass over the walls near the player that the table cannot
+// rule out, after which each fog tile is an O(1) lookup; replaces a line of
+// sight ray per 50 px chunk.
+class FogVisibilityField {
+public:
+    FogVisibilityField() {
+        // Unit direction through the center of every bin
+        for (int bin = 0; bin < FOG_ANGLE_BINS; ++bin) {
+            float p = (bin + 0.5f) * 4.0f / FOG_ANGLE_BINS;
+            float x, y;
+            if (p < 1.0f) { x = 1.0f - p; y = p; }
+            else if (p < 2.0f) { x = 1.0f - p; y = 2.0f - p; }
+            else if (p < 3.0f) { x = p - 3.0f; y = 2.0f - p; }
+            else { x = p - 3.0f; y = p - 4.0f; }
+            float length = std::sqrt(x * x + y * y);
+            dirX_[bin] = x / length;
+            dirY_[bin] = y / length;
+        }
+        depth_.fill(std::numeric_limits<float>::infinity());
+    }
+    
+    // Cast the shadows of every wall that can block a segment between the
+    // origin and a point of [minX, maxX] x [minY, maxY]
+    // Returns: number of wall rectangles cast
+    size_t compute(const CellGrid& grid, const VisibilityTable& table, sf::Vector2f origin,
+                   float minX, float minY, float maxX, float maxY) {
+        origin_ = origin;
+        depth_.fill(std::numeric_limits<float>::infinity());
+        
+        // Segments between points of the region and the origin stay inside
+        // their bounding box, so walls outside it cannot block them
+        minX = std::min(minX, origin.x);
+        minY = std::min(minY, origin.y);
+        maxX = std::max(maxX, origin.x);
+        maxY = std::max(maxY, origin.y);
+        const int minCellX = std::max(0, static_cast<int>(std::floor(minX / CELL_SIZE)) - 1);
+        const int minCellY = std::max(0, static_cast<int>(std::floor(minY / CELL_SIZE)) - 1);
+        const int maxCellX = std::min(GRID_SIZE - 1, static_cast<int>(std::floor(maxX / CELL_SIZE)) + 1);
+        const int maxCellY = std::min(GRID_SIZE - 1, static_cast<int>(std::floor(maxY / CELL_SIZE)) + 1);
+        
+        const int originCellX = static_cast<int>(std::floor(origin.x / CELL_SIZE));
+        const int originCellY = static_cast<int>(std::floor(origin.y / CELL_SIZE));
+        const int maxRing = std::max(std::max(originCellX - minCellX, maxCellX - originCellX),
+                                     std::max(originCellY - minCellY, maxCellY - originCellY));
+        
+        // Broad phase: cells of the region (and a one-cell border) Hidden from the player's cell
+        const int spanY = maxCellY - minCellY + 3;
+        hidden_.assign(static_cast<size_t>(maxCellX - minCellX + 3) * spanY, 0);
+        for (int i = minCellX - 1; i <= maxCellX + 1; ++i) {
+            for (int j = minCellY - 1; j <= maxCellY + 1; ++j) {
+                hidden_[(i - minCellX + 1) * spanY + (j - minCellY + 1)] =
+                    (table.query(originCellX, originCellY, i, j) == CellVisibility::Hidden);
+            }
+        }
+        // The table speaks for the inset part of each cell, so light can still graze
+        // a wall's end: a wall is skipped only if the cells along it and past both
+        // of its ends are Hidden too
+        auto blockHidden = [&](int i0, int j0, int i1, int j1) {
+            for (int i = i0; i <= i1; ++i) {
+                for (int j = j0; j <= j1; ++j) {
+                    if (!hidden_[(i - minCellX + 1) * spanY + (j - minCellY + 1)]) return false;
+                }
+            }
+            return true;
+        };
+        
+        // Rings of cells at Chebyshev distance 0, 1, 2, ... from the player's cell
+        walls_ = 0;
+        for (int ring = 0; ring <= maxRing; ++ring) {
+            bool ringHidden = (ring > 0);
+            for (int i = originCellX - ring; i <= originCellX + ring; ++i) {
+                if (i < minCellX || i > maxCellX) continue;
+                const bool edgeColumn = (i == originCellX - ring || i == originCellX + ring);
+                const int stepJ = edgeColumn ? 1 : 2 * ring;
+                for (int j = originCellY - ring; j <= originCellY + ring; j += std::max(1, stepJ)) {
+                    if (j < minCellY || j > maxCellY) continue;
+                    if (!hidden_[(i - minCellX + 1) * spanY + (j - minCellY + 1)]) {
+                        ringHidden = false;
+                        castCellWalls(grid, i, j, i == maxCellX, j == maxCellY, false, false, false, false);
+                    } else {
+                        castCellWalls(grid, i, j, i == maxCellX, j == maxCellY,
+                                      blockHidden(i - 1, j - 1, i + 1, j), blockHidden(i, j - 1, i + 1, j + 1),
+                                      blockHidden(i - 1, j, i + 1, j + 1), blockHidden(i - 1, j - 1, i, j + 1));
+                    }
+                }
+            }
+            // Every ray leaving the player's cell crosses this ring: nothing behind it is reached
+            if (ringHidden) break;
+        }
+        return walls_;
+    }
+    
+    // Whether (x, y) is visible from the origin of the last compute()
+    bool isVisible(float x, float y) const {
+        const float dx = x - origin_.x;
+        const float dy = y - origin_.y;
+        if (dx == 0.0f && dy == 0.0f) return true;
+        int bin = static_cast<int>(diamondAngle(dx, dy) * (FOG_ANGLE_BINS / 4.0f));
+        bin = std::min(bin, FOG_ANGLE_BINS - 1);
+        const float depth = depth_[bin];
+        return dx * dx + dy * dy <= depth * depth;
+    }
+    
+private:
+    // Each cell casts its top and left edges, so a shared edge is cast once;
+    // the last row and column of the region also cast their bottom/right edges.
+    // Sides the broad phase ruled out (the skip flags) are left out.
+    void castCellWalls(const CellGrid& grid, int i, int j, bool lastColumn, bool lastRow,
+                       bool skipTop, bool skipRight, bool skipBottom, bool skipLeft) {
+        const float cellWorldX = i * CELL_SIZE;
+        const float cellWorldY = j * CELL_SIZE;
+        const float half = WALL_WIDTH / 2.0f;
+        if (!skipTop && grid.horizontal(i, j) != WallType::None) castWall(cellWorldX, cellWorldY - half, CELL_SIZE, WALL_WIDTH);
+        if (lastColumn && !skipRight && grid.vertical(i + 1, j) != WallType::None) castWall(cellWorldX + CELL_SIZE - half, cellWorldY, WALL_WIDTH, CELL_SIZE);
+        if (lastRow && !skipBottom && grid.horizontal(i, j + 1) != WallType::None) castWall(cellWorldX, cellWorldY + CELL_SIZE - half, CELL_SIZE, WALL_WIDTH);
+        if (!skipLeft && grid.vertical(i, j) != WallType::None) castWall(cellWorldX - half, cellWorldY, WALL_WIDTH, CELL_SIZE);
+    }
+    
+    void castWall(float rectX, float rectY, float rectW, float rectH) {
+        walls_++;
+        const float x0 = rectX - origin_.x;
+        const float y0 = rectY - origin_.y;
+        const float x1 = x0 + rectW;
+        const float y1 = y0 + rectH;
+        
+        // Standing inside a wall's rectangle (touching it): it hides nothing useful
+        if (x0 <= 0.0f && x1 >= 0.0f && y0 <= 0.0f && y1 >= 0.0f) return;
+        
+        // Distance to the nearest point of the rectangle
+        const float nx = std::max(std::max(x0, -x1), 0.0f);
+        const float ny = std::max(std::max(y0, -y1), 0.0f);
+        const float nearest = std::sqrt(nx * nx + ny * ny);
+        
+        // Pseudo-angle range of the corners; a range wider than half a turn
+        // wraps through angle 0 (the +x axis)
+        const float angles[4] = { diamondAngle(x0, y0), diamondAngle(x1, y0),
+                                  diamondAngle(x0, y1), diamondAngle(x1, y1) };
+        float lo = std::min(std::min(angles[0], angles[1]), std::min(angles[2], angles[3]));
+        float hi = std::max(std::max(angles[0], angles[1]), std::max(angles[2], angles[3]));
+        if (hi - lo > 2.0f) {
+            lo = 4.0f;
+            hi = 0.0f;
+            for (float angle : angles) {
+                if (angle < 2.0f) angle += 4.0f;
+                lo = std::min(lo, angle);
+                hi = std::max(hi, angle);
+            }
+        }
+        
+        const int first = static_cast<int>(lo * (FOG_ANGLE_BINS / 4.0f));
+        const int last = static_cast<int>(hi * (FOG_ANGLE_BINS / 4.0f));
+        for (int k = first; k <= last; ++k) {
+            const int bin = k & (FOG_ANGLE_BINS - 1);
+            if (depth_[bin] <= nearest) continue;  // Already in a nearer wall's shadow
+            
+            // Slab test for the ray origin + t * dir, t >= 0
+            const float dx = dirX_[bin];
+            const float dy = dirY_[bin];
+            float tMin = 0.0f;
+            float tMax = std::numeric_limits<float>::infinity();
+            if (dx != 0.0f) {
+                float t1 = x0 / dx, t2 = x1 / dx;
+                if (t1 > t2) std::swap(t1, t2);
+                tMin = std::max(tMin, t1);
+                tMax = std::min(tMax, t2);
+            } else if (x0 > 0.0f || x1 < 0.0f) {
+                continue;
+            }
+            if (dy != 0.0f) {
+                float t1 = y0 / dy, t2 = y1 / dy;
+                if (t1 > t2) std::swap(t1, t2);
+                tMin = std::max(tMin, t1);
+                tMax = std::min(tMax, t2);
+            } else if (y0 > 0.0f || y1 < 0.0f) {
+                continue;
+            }
+            if (tMin <= tMax && tMin < depth_[bin]) {
+                depth_[bin] = tMin;
+            }
+        }
+    }
+    
+    std::array<float, FOG_ANGLE_BINS> depth_;
+    std::array<float, FOG_ANGLE_BINS> dirX_;
+    std::array<float, FOG_ANGLE_BINS> dirY_;
+    sf::Vector2f origin_;
+    std::vector<uint8_t> hidden_;  // Broad phase scratch, reused between computes
+    size_t walls_ = 0;
+};
+
+const float FOG_TILE_SIZE = 15.0f;      // Side of one fog quad (world-aligned)
+const float FOG_LAYOUT_SLACK = 150.0f;  // Extra area laid out around the view so scrolling rarely re-lays quads
+
+// PERFORMANCE: Global vertex cache - quad positions are laid out once per region,
+// colors are rewritten only for quads whose visibility changed
+struct BackgroundVertexCache {
+    sf::VertexArray vertices;
+    std::vector<uint8_t> tileLit;     // Per quad: 1 lit, 0 dark, 2 not colored yet
+    int tilesX = 0;
+    int tilesY = 0;
+    float layoutMinX = 0.0f;          // Laid-out region (multiples of FOG_TILE_SIZE)
+    float layoutMinY = 0.0f;
+    float layoutMaxX = 0.0f;
+    float layoutMaxY = 0.0f;
+    sf::Vector2f lastPlayerPos = sf::Vector2f(-1000.0f, -1000.0f);
+    bool needsUpdate = true;          // Force a re-layout (new map)
+};
+
+// Bring the fog quads up to date for the player's position
+// Parameters:
+//   cache - Quads and their current visibility
+//   field - Scratch visibility field (recomputed here when the player moved)
+//   table - Cell visibility (broad phase for the field)
+//   grid - The cell grid
+//   playerPosition - Where the fog is seen from
+//   minX, minY, maxX, maxY - Visible world bounds with padding
+// Returns: number of quads whose color was written
+//
+// ALGORITHM:
+// 1. Lay out world-aligned FOG_TILE_SIZE quads over the bounds plus
+//    FOG_LAYOUT_SLACK; done again only when the bounds leave that region
+// 2. When the player moved, shadow-cast the walls the visibility table cannot
+//    rule out (FogVisibilityField) and look up every quad's center in the field
+// 3. Rewrite the colors of quads whose visibility changed
+//
+// PERFORMANCE: no per-chunk line of sight rays and no vertex rebuild while
+// moving; only the quads along moving shadow edges are written.
+size_t updateFogVertices(BackgroundVertexCache& cache, FogVisibilityField& field,
+                         const VisibilityTable& table, const CellGrid& grid, sf::Vector2f playerPosition,
+                         float minX, float minY, float maxX, float maxY) {
+    // Base background color (136, 101, 56)
+    const sf::Color baseColor(136, 101, 56);
+    const sf::Color darkColor(baseColor.r, baseColor.g, baseColor.b, 0);  // Completely dark behind walls
+    
+    // Step 1: Re-lay the quads when the padded view leaves the laid-out region
+    bool relaid = false;
+    if (cache.needsUpdate || minX < cache.layoutMinX || maxX > cache.layoutMaxX ||
+        minY < cache.layoutMinY || maxY > cache.layoutMaxY) {
+        cache.layoutMinX = std::floor(std::max(0.0f, minX - FOG_LAYOUT_SLACK) / FOG_TILE_SIZE) * FOG_TILE_SIZE;
+        cache.layoutMinY = std::floor(std::max(0.0f, minY - FOG_LAYOUT_SLACK) / FOG_TILE_SIZE) * FOG_TILE_SIZE;
+        cache.layoutMaxX = std::min(MAP_SIZE, maxX + FOG_LAYOUT_SLACK);
+        cache.layoutMaxY = std::min(MAP_SIZE, maxY + FOG_LAYOUT_SLACK);
+        cache.tilesX = static_cast<int>(std::ceil((cache.layoutMaxX - cache.layoutMinX) / FOG_TILE_SIZE));
+        cache.tilesY = static_cast<int>(std::ceil((cache.layoutMaxY - cache.layoutMinY) / FOG_TILE_SIZE));
+        cache.layoutMaxX = cache.layoutMinX + cache.tilesX * FOG_TILE_SIZE;
+        cache.layoutMaxY = cache.layoutMinY + cache.tilesY * FOG_TILE_SIZE;
+        
+        cache.vertices.setPrimitiveType(sf::Quads);
+        cache.vertices.resize(static_cast<size_t>(cache.tilesX) * cache.tilesY * 4);
+        cache.tileLit.assign(static_cast<size_t>(cache.tilesX) * cache.tilesY, 2);
+        
+        size_t vertexIndex = 0;
+        for (int tx = 0; tx < cache.tilesX; ++tx) {
+            const float x = cache.layoutMinX + tx * FOG_TILE_SIZE;
+            for (int ty = 0; ty < cache.tilesY; ++ty) {
+                const float y = cache.layoutMinY + ty * FOG_TILE_SIZE;
+                cache.vertices[vertexIndex].position = sf::Vector2f(x, y);
+                cache.vertices[vertexIndex + 1].position = sf::Vector2f(x + FOG_TILE_SIZE, y);
+                cache.vertices[vertexIndex + 2].position = sf::Vector2f(x + FOG_TILE_SIZE, y + FOG_TILE_SIZE);
+                cache.vertices[vertexIndex + 3].position = sf::Vector2f(x, y + FOG_TILE_SIZE);
+                vertexIndex += 4;
+            }
+        }
+        
+        cache.needsUpdate = false;
+        relaid = true;
+    }
+    
+    // Step 2: Shadow-cast from the new position and look up every quad
+    size_t written = 0;
+    if (relaid || playerPosition.x != cache.lastPlayerPos.x || playerPosition.y != cache.lastPlayerPos.y) {
+        field.compute(grid, table, playerPosition, cache.layoutMinX, cache.layoutMinY,
+                      cache.layoutMaxX, cache.layoutMaxY);
+        cache.lastPlayerPos = playerPosition;
+        
+        // Step 3: Rewrite only the quads whose visibility changed
+        size_t tileIndex = 0;
+        for (int tx = 0; tx < cache.tilesX; ++tx) {
+            const float centerX = cache.layoutMinX + (tx + 0.5f) * FOG_TILE_SIZE;
+            for (int ty = 0; ty < cache.tilesY; ++ty, ++tileIndex) {
+                const float centerY = cache.layoutMinY + (ty + 0.5f) * FOG_TILE_SIZE;
+                const uint8_t lit = field.isVisible(centerX, centerY) ? 1 : 0;
+                if (lit == cache.tileLit[tileIndex]) continue;
+                
+                cache.tileLit[tileIndex] = lit;
+                const sf::Color color = lit ? baseColor : darkColor;
+                const size_t vertexIndex = tileIndex * 4;
+                cache.vertices[vertexIndex].color = color;
+                cache.vertices[vertexIndex + 1].color = color;
+                cache.vertices[vertexIndex + 2].color = color;
+                cache.vertices[vertexIndex + 3].color = color;
+                written++;
+            }
+        }
+    }
+    
+    return written;
+}
+
+// ========================
+// Previous Fog Refresh (for comparison)
+// ========================
+
+// Line of sight per 50 px chunk, then every 15 px quad rebuilt (position and
+// color); ran on every frame the view moved
+void legacyRebuildFog(sf::VertexArray& vertices, std::vector<std::vector<bool>>& chunkCache,
+                      sf::Vector2f playerPosition, float minX, float minY, float maxX, float maxY,
+                      const std::function<bool(sf::Vector2f, sf::Vector2f)>& lineOfSight) {
+    const sf::Color baseColor(136, 101, 56);
+    const float cacheChunkSize = 50.0f;
+    int cacheChunksX = static_cast<int>((maxX - minX) / cacheChunkSize) + 2;
+    int cacheChunksY = static_cast<int>((maxY - minY) / cacheChunkSize) + 2;
+    chunkCache.resize(cacheChunksX);
+    for (auto& row : chunkCache) {
+        row.resize(cacheChunksY, true);
+    }
+    for (int cx = 0; cx < cacheChunksX; cx++) {
+        for (int cy = 0; cy < cacheChunksY; cy++) {
+            float cacheX = minX + cx * cacheChunkSize + cacheChunkSize / 2.0f;
+            float cacheY = minY + cy * cacheChunkSize + cacheChunkSize / 2.0f;
+            chunkCache[cx][cy] = lineOfSight(playerPosition, sf::Vector2f(cacheX, cacheY));
+        }
+    }
+    
+    const float chunkSize = 15.0f;
+    int chunksX = static_cast<int>((maxX - minX) / chunkSize) + 1;
+    int chunksY = static_cast<int>((maxY - minY) / chunkSize) + 1;
+    vertices.resize(chunksX * chunksY * 4);
+    int vertexIndex = 0;
+    for (float x = minX; x < maxX; x += chunkSize) {
+        for (float y = minY; y < maxY; y += chunkSize) {
+            int cacheX = std::min(cacheChunksX - 1, std::max(0, static_cast<int>((x - minX) / cacheChunkSize)));
+            int cacheY = std::min(cacheChunksY - 1, std::max(0, static_cast<int>((y - minY) / cacheChunkSize)));
+            sf::Color color(baseColor.r, baseColor.g, baseColor.b, chunkCache[cacheX][cacheY] ? 255 : 0);
+            vertices[vertexIndex].position = sf::Vector2f(x, y);
+            vertices[vertexIndex].color = color;
+            vertices[vertexIndex + 1].position = sf::Vector2f(x + chunkSize, y);
+            vertices[vertexIndex + 1].color = color;
+            vertices[vertexIndex + 2].position = sf::Vector2f(x + chunkSize, y + chunkSize);
+            vertices[vertexIndex + 2].color = color;
+            vertices[vertexIndex + 3].position = sf::Vector2f(x, y + chunkSize);
+            vertices[vertexIndex + 3].color = color;
+            vertexIndex += 4;
+        }
+    }
+}
+
+// ========================
+// Test Helpers
+// ========================
+
+CellGrid makeMap(unsigned seed) {
+    CellGrid grid;
+    generateMap(grid, seed);
+    return grid;
+}
+
+// Random position a player can stand on (15 px radius clear of walls)
+sf::Vector2f playerPoint(std::mt19937& gen, const CellGrid& grid) {
+    std::uniform_real_distribution<float> posDist(100.0f, MAP_SIZE - 100.0f);
+    while (true) {
+        sf::Vector2f p(posDist(gen), posDist(gen));
+        if (!segmentHitsWall(grid, p.x - 20.0f, p.y, p.x + 20.0f, p.y) &&
+            !segmentHitsWall(grid, p.x, p.y - 20.0f, p.x, p.y + 20.0f)) {
+            return p;
+        }
+    }
+}
+
+// Fog bounds for a view centered on the player
+void viewBounds(sf::Vector2f player, float viewW, float viewH, float& minX, float& minY, float& maxX, float& maxY) {
+    const float padding = 200.0f;
+    minX = std::max(0.0f, player.x - viewW / 2.0f - padding);
+    maxX = std::min(MAP_SIZE, player.x + viewW / 2.0f + padding);
+    minY = std::max(0.0f, player.y - viewH / 2.0f - padding);
+    maxY = std::min(MAP_SIZE, player.y + viewH / 2.0f + padding);
+}
+
+// ========================
+// Fog Field Tests
+// ========================
+
+TEST(EmptyMapIsLit) {
+    CellGrid grid;
+    VisibilityTable table;
+    table.build(grid);
+    FogVisibilityField field;
+    field.compute(grid, table, sf::Vector2f(2550.0f, 2550.0f), 1000.0f, 1500.0f, 4100.0f, 3600.0f);
+    for (float x = 1000.0f; x < 4100.0f; x += 37.0f) {
+        for (float y = 1500.0f; y < 3600.0f; y += 41.0f) {
+            ASSERT_TRUE(field.isVisible(x, y));
+        }
+    }
+}
+
+TEST(WallCastsShadow) {
+    CellGrid grid;
+    grid.setWall(25, 22, 2, WallType::Concrete);  // y = 2300, x 2500..2600
+    VisibilityTable table;
+    table.build(grid);
+    FogVisibilityField field;
+    field.compute(grid, table, sf::Vector2f(2550.0f, 2550.0f), 1500.0f, 1500.0f, 3600.0f, 3600.0f);
+    ASSERT_TRUE(!field.isVisible(2550.0f, 2000.0f));  // Straight behind
+    ASSERT_TRUE(!field.isVisible(2600.0f, 1900.0f));
+    ASSERT_TRUE(field.isVisible(2550.0f, 2320.0f));   // In front
+    ASSERT_TRUE(field.isVisible(2900.0f, 2000.0f));   // Beside the shadow
+    ASSERT_TRUE(field.isVisible(2550.0f, 3000.0f));   // Other direction
+}
+
+TEST(ShadowAcrossAngleZero) {
+    // Wall straight to the +x side: its corners lie on both sides of angle 0
+    CellGrid grid;
+    grid.setWall(26, 25, 1, WallType::Wood);  // x = 2700, y 2500..2600
+    VisibilityTable table;
+    table.build(grid);
+    FogVisibilityField field;
+    field.compute(grid, table, sf::Vector2f(2550.0f, 2550.0f), 1500.0f, 1500.0f, 3600.0f, 3600.0f);
+    ASSERT_TRUE(!field.isVisible(3000.0f, 2550.0f));
+    ASSERT_TRUE(!field.isVisible(3000.0f, 2520.0f));
+    ASSERT_TRUE(!field.isVisible(3000.0f, 2580.0f));
+    ASSERT_TRUE(field.isVisible(3000.0f, 2200.0f));
+    ASSERT_TRUE(field.isVisible(3000.0f, 2900.0f));
+    ASSERT_TRUE(field.isVisible(2650.0f, 2550.0f));
+}
+
+TEST(NearestWallWins) {
+    CellGrid grid;
+    grid.setWall(25, 20, 2, WallType::Concrete);  // y = 2100 (far)
+    grid.setWall(25, 23, 2, WallType::Concrete);  // y = 2400 (near)
+    VisibilityTable table;
+    table.build(grid);
+    FogVisibilityField field;
+    field.compute(grid, table, sf::Vector2f(2550.0f, 2550.0f), 1500.0f, 1500.0f, 3600.0f, 3600.0f);
+    ASSERT_TRUE(!field.isVisible(2550.0f, 2200.0f));  // Between the walls, behind the near one
+    ASSERT_TRUE(field.isVisible(2550.0f, 2450.0f));
+}
+
+TEST(MatchesExactTest) {
+    CellGrid grid = makeMap(42);
+    VisibilityTable table;
+    table.build(grid);
+    FogVisibilityField field;
+    std::mt19937 gen(1);
+    long tiles = 0;
+    long mismatches = 0;
+    for (int n = 0; n < 100; ++n) {
+        sf::Vector2f player = playerPoint(gen, grid);
+        float minX, minY, maxX, maxY;
+        viewBounds(player, 1920.0f, 1080.0f, minX, minY, maxX, maxY);
+        field.compute(grid, table, player, minX, minY, maxX, maxY);
+        for (float x = minX + 7.5f; x < maxX; x += FOG_TILE_SIZE) {
+            for (float y = minY + 7.5f; y < maxY; y += FOG_TILE_SIZE) {
+                tiles++;
+                if (field.isVisible(x, y) != hasLineOfSight(player, sf::Vector2f(x, y), grid)) mismatches++;
+            }
+        }
+    }
+    // Only tiles whose center sits within a bin width of a shadow edge, or in a
+    // narrow gap the table's sampled rays missed, can differ
+    ASSERT_TRUE(mismatches * 1000 < tiles);  // < 0.1%
+}
+
+TEST(HiddenWallsAreNotCast) {
+    // Player's cell closed on all four sides, more walls further out
+    CellGrid grid;
+    for (int side = 0; side < 4; ++side) grid.setWall(25, 25, side, WallType::Concrete);
+    grid.setWall(25, 22, 2, WallType::Concrete);
+    grid.setWall(28, 25, 1, WallType::Wood);
+    grid.setWall(20, 30, 0, WallType::Concrete);
+    
+    VisibilityTable none;
+    FogVisibilityField full;
+    const size_t allWalls = full.compute(grid, none, sf::Vector2f(2550.0f, 2550.0f), 1500.0f, 1500.0f, 3600.0f, 3600.0f);
+    ASSERT_EQ(7, static_cast<int>(allWalls));
+    
+    // Ring 1 is Hidden: only the four walls of the player's cell are cast
+    VisibilityTable table;
+    table.build(grid);
+    FogVisibilityField field;
+    ASSERT_EQ(4, static_cast<int>(field.compute(grid, table, sf::Vector2f(2550.0f, 2550.0f),
+                                                1500.0f, 1500.0f, 3600.0f, 3600.0f)));
+    for (float x = 1500.0f; x < 3600.0f; x += 37.0f) {
+        for (float y = 1500.0f; y < 3600.0f; y += 41.0f) {
+            ASSERT_TRUE(field.isVisible(x, y) == full.isVisible(x, y));
+        }
+    }
+    ASSERT_TRUE(field.isVisible(2550.0f, 2580.0f));
+    ASSERT_TRUE(!field.isVisible(2550.0f, 2700.0f));
+}
+
+TEST(BroadPhaseMatchesFullCast) {
+    CellGrid grid = makeMap(42);
+    VisibilityTable table;
+    table.build(grid);
+    VisibilityTable none;
+    FogVisibilityField field;
+    FogVisibilityField full;
+    std::mt19937 gen(4);
+    long tiles = 0;
+    long mismatches = 0;
+    size_t walls = 0;
+    size_t allWalls = 0;
+    for (int n = 0; n < 200; ++n) {
+        sf::Vector2f player = playerPoint(gen, grid);
+        float minX, minY, maxX, maxY;
+        viewBounds(player, 1920.0f, 1080.0f, minX, minY, maxX, maxY);
+        walls += field.compute(grid, table, player, minX, minY, maxX, maxY);
+        allWalls += full.compute(grid, none, player, minX, minY, maxX, maxY);
+        for (float x = minX + 7.5f; x < maxX; x += FOG_TILE_SIZE) {
+            for (float y = minY + 7.5f; y < maxY; y += FOG_TILE_SIZE) {
+                tiles++;
+                if (field.isVisible(x, y) != full.isVisible(x, y)) mismatches++;
+            }
+        }
+    }
+    ASSERT_TRUE(mismatches * 1000 < tiles);  // < 0.1%
+    ASSERT_TRUE(walls < allWalls);
+}
+
+TEST(IncrementalUpdateMatchesFreshLayout) {
+    CellGrid grid = makeMap(42);
+    VisibilityTable table;
+    table.build(grid);
+    FogVisibilityField field;
+    BackgroundVertexCache cache;
+    std::mt19937 gen(2);
+    sf::Vector2f player = playerPoint(gen, grid);
+    float minX, minY, maxX, maxY;
+    viewBounds(player, 1920.0f, 1080.0f, minX, minY, maxX, maxY);
+    
+    size_t written = updateFogVertices(cache, field, table, grid, player, minX, minY, maxX, maxY);
+    const size_t tiles = static_cast<size_t>(cache.tilesX) * cache.tilesY;
+    ASSERT_TRUE(written == tiles);
+    ASSERT_EQ(0, static_cast<int>(updateFogVertices(cache, field, table, grid, player, minX, minY, maxX, maxY)));
+    
+    // Walk a few pixels at a time, then compare with a cache colored from scratch
+    for (int step = 0; step < 20; ++step) {
+        player.x += 3.0f;
+        player.y += 1.0f;
+        viewBounds(player, 1920.0f, 1080.0f, minX, minY, maxX, maxY);
+        written = updateFogVertices(cache, field, table, grid, player, minX, minY, maxX, maxY);
+        ASSERT_TRUE(written < tiles / 4);
+    }
+    BackgroundVertexCache fresh;
+    FogVisibilityField freshField;
+    updateFogVertices(fresh, freshField, table, grid, player, cache.layoutMinX + FOG_LAYOUT_SLACK,
+                      cache.layoutMinY + FOG_LAYOUT_SLACK, cache.layoutMaxX - FOG_LAYOUT_SLACK,
+                      cache.layoutMaxY - FOG_LAYOUT_SLACK);
+    ASSERT_TRUE(fresh.tilesX == cache.tilesX && fresh.tilesY == cache.tilesY);
+    for (size_t v = 0; v < cache.vertices.getVertexCount(); ++v) {
+        ASSERT_TRUE(cache.vertices[v].color.a == fresh.vertices[v].color.a);
+    }
+}
+
+TEST(RelayoutWhenViewLeavesRegion) {
+    CellGrid grid = makeMap(42);
+    VisibilityTable table;
+    table.build(grid);
+    FogVisibilityField field;
+    BackgroundVertexCache cache;
+    sf::Vector2f player(2550.0f, 2550.0f);
+    float minX, minY, maxX, maxY;
+    viewBounds(player, 800.0f, 600.0f, minX, minY, maxX, maxY);
+    updateFogVertices(cache, field, table, grid, player, minX, minY, maxX, maxY);
+    const float firstMinX = cache.layoutMinX;
+    ASSERT_NEAR(0.0f, std::fmod(firstMinX, FOG_TILE_SIZE), 0.001f);
+    
+    // Inside the slack: same layout
+    player.x += FOG_LAYOUT_SLACK - 20.0f;
+    viewBounds(player, 800.0f, 600.0f, minX, minY, maxX, maxY);
+    updateFogVertices(cache, field, table, grid, player, minX, minY, maxX, maxY);
+    ASSERT_NEAR(firstMinX, cache.layoutMinX, 0.001f);
+    
+    // Past it: laid out again around the new view
+    player.x += 40.0f;
+    viewBounds(player, 800.0f, 600.0f, minX, minY, maxX, maxY);
+    updateFogVertices(cache, field, table, grid, player, minX, minY, maxX, maxY);
+    ASSERT_TRUE(cache.layoutMinX > firstMinX);
+    ASSERT_TRUE(cache.layoutMaxX >= maxX && cache.layoutMinX <= minX);
+    ASSERT_NEAR(cache.layoutMinX, cache.vertices[0].position.x, 0.001f);
+}
+
+TEST(ExactTestMatchesRayMarch) {
+    CellGrid grid = makeMap(7);
+    std::mt19937 gen(5);
+    std::uniform_real_distribution<float> offsetDist(-1200.0f, 1200.0f);
+    const int SAMPLES = 100000;
+    int mismatches = 0;
+    for (int n = 0; n < SAMPLES; ++n) {
+        sf::Vector2f a = playerPoint(gen, grid);
+        sf::Vector2f b(std::min(MAP_SIZE - 1.0f, std::max(1.0f, a.x + offsetDist(gen))),
+                       std::min(MAP_SIZE - 1.0f, std::max(1.0f, a.y + offsetDist(gen) * 0.66f)));
+        if (hasLineOfSight(a, b, grid) != legacyHasLineOfSight(a, b, grid)) mismatches++;
+    }
+    // The march samples every 3 px and can step over the corner of a wall
+    ASSERT_TRUE(mismatches * 200 < SAMPLES);  // < 0.5%
+}
+
+TEST(ExactTestHandlesAxisAlignedSegments) {
+    CellGrid grid;
+    grid.setWall(5, 5, 1, WallType::Concrete);  // x = 600, y 500..600
+    ASSERT_TRUE(!hasLineOfSight(sf::Vector2f(550.0f, 550.0f), sf::Vector2f(650.0f, 550.0f), grid));
+    ASSERT_TRUE(hasLineOfSight(sf::Vector2f(550.0f, 450.0f), sf::Vector2f(650.0f, 450.0f), grid));
+    ASSERT_TRUE(hasLineOfSight(sf::Vector2f(550.0f, 450.0f), sf::Vector2f(550.0f, 650.0f), grid));
+    ASSERT_TRUE(!hasLineOfSight(sf::Vector2f(550.0f, 550.0f), sf::Vector2f(5200.0f, 550.0f), grid));
+}
+
+// ========================
+// Benchmark
+// ========================
+
+// Average cost of one fog refresh per frame while walking (~3-4 px per frame)
+void benchmarkFogRefresh(const CellGrid& grid, const VisibilityTable& table, float viewW, float viewH) {
+    const int FRAMES = 300;
+    std::mt19937 gen(9);
+    std::vector<sf::Vector2f> path;
+    sf::Vector2f start = playerPoint(gen, grid);
+    for (int frame = 0; frame < FRAMES; ++frame) {
+        float t = frame / 60.0f;
+        path.push_back(sf::Vector2f(std::min(MAP_SIZE - 50.0f, std::max(50.0f, start.x + frame * 3.0f)),
+                                    std::min(MAP_SIZE - 50.0f, std::max(50.0f, start.y + std::sin(t) * 150.0f))));
+    }
+    
+    auto timeFrames = [&](const std::function<void(sf::Vector2f, float, float, float, float)>& refresh) {
+        auto t0 = std::chrono::high_resolution_clock::now();
+        for (const sf::Vector2f& p : path) {
+            float minX, minY, maxX, maxY;
+            viewBounds(p, viewW, viewH, minX, minY, maxX, maxY);
+            refresh(p, minX, minY, maxX, maxY);
+        }
+        auto t1 = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::micro>(t1 - t0).count() / FRAMES;
+    };
+    
+    sf::VertexArray legacyVertices;
+    std::vector<std::vector<bool>> chunkCache;
+    double marchUs = timeFrames([&](sf::Vector2f p, float minX, float minY, float maxX, float maxY) {
+        legacyRebuildFog(legacyVertices, chunkCache, p, minX, minY, maxX, maxY,
+                         [&](sf::Vector2f a, sf::Vector2f b) { return legacyHasLineOfSight(a, b, grid); });
+    });
+    double traversalUs = timeFrames([&](sf::Vector2f p, float minX, float minY, float maxX, float maxY) {
+        legacyRebuildFog(legacyVertices, chunkCache, p, minX, minY, maxX, maxY,
+                         [&](sf::Vector2f a, sf::Vector2f b) { return hasLineOfSight(a, b, grid); });
+    });
+    
+    // Without the broad phase (unbuilt table: every cell pair Partial)
+    VisibilityTable none;
+    BackgroundVertexCache fullCache;
+    FogVisibilityField fullField;
+    double fullUs = timeFrames([&](sf::Vector2f p, float minX, float minY, float maxX, float maxY) {
+        updateFogVertices(fullCache, fullField, none, grid, p, minX, minY, maxX, maxY);
+    });
+    
+    BackgroundVertexCache cache;
+    FogVisibilityField field;
+    size_t written = 0;
+    double fieldUs = timeFrames([&](sf::Vector2f p, float minX, float minY, float maxX, float maxY) {
+        written += updateFogVertices(cache, field, table, grid, p, minX, minY, maxX, maxY);
+    });
+    
+    // Wall rectangles cast per refresh, with and without the table
+    size_t walls = 0;
+    size_t allWalls = 0;
+    for (const sf::Vector2f& p : path) {
+        float minX, minY, maxX, maxY;
+        viewBounds(p, viewW, viewH, minX, minY, maxX, maxY);
+        walls += field.compute(grid, table, p, cache.layoutMinX, cache.layoutMinY, cache.layoutMaxX, cache.layoutMaxY);
+        allWalls += fullField.compute(grid, none, p, cache.layoutMinX, cache.layoutMinY, cache.layoutMaxX, cache.layoutMaxY);
+    }
+    
+    std::cout << std::setw(6) << static_cast<int>(viewW) << "x" << std::setw(5) << std::left << static_cast<int>(viewH)
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(9) << marchUs << std::setw(12) << traversalUs << std::setw(11) << fullUs
+              << std::setw(12) << fieldUs << std::setw(10) << walls / FRAMES << " / " << std::setw(3) << allWalls / FRAMES
+              << std::setw(8) << written / FRAMES << " / " << static_cast<size_t>(cache.tilesX) * cache.tilesY
+              << std::endl;
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Zero Ground Fog Visibility Field Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "--- Fog Field Tests ---" << std::endl;
+    RUN_TEST(EmptyMapIsLit);
+    RUN_TEST(WallCastsShadow);
+    RUN_TEST(ShadowAcrossAngleZero);
+    RUN_TEST(NearestWallWins);
+    RUN_TEST(MatchesExactTest);
+    RUN_TEST(HiddenWallsAreNotCast);
+    RUN_TEST(BroadPhaseMatchesFullCast);
+    RUN_TEST(IncrementalUpdateMatchesFreshLayout);
+    RUN_TEST(RelayoutWhenViewLeavesRegion);
+    RUN_TEST(ExactTestMatchesRayMarch);
+    RUN_TEST(ExactTestHandlesAxisAlignedSegments);
+
+    std::cout << std::endl;
+    std::cout << "--- Fog Refresh per Frame (walking, 300 frames, times in us) ---" << std::endl;
+    CellGrid grid = makeMap(42);
+    VisibilityTable table;
+    table.build(grid);
+    std::cout << std::setw(12) << "View" << std::setw(9) << "March" << std::setw(12) << "Traversal"
+              << std::setw(11) << "Field" << std::setw(12) << "Field+PVS" << std::setw(16) << "Walls cast"
+              << std::setw(16) << "Quads written" << std::endl;
+    benchmarkFogRefresh(grid, table, 800.0f, 600.0f);
+    benchmarkFogRefresh(grid, table, 1920.0f, 1080.0f);
+    benchmarkFogRefresh(grid, table, 2560.0f, 1440.0f);
+
+    // Print summary
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Test Summary" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Total tests: " << totalTests << std::endl;
+    std::cout << "Passed: " << passedTests << std::endl;
+    std::cout << "Failed: " << failedTests << std::endl;
+    std::cout << std::endl;
+
+    if (failedTests == 0) {
+        std::cout << "✓ All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "✗ Some tests failed!" << std::endl;
+        return 1;
+    }
+}
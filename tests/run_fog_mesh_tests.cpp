@@ -0,0 +1,493 @@
+// Cached Fog Mesh Tests and Benchmark for Zero Ground
+// Checks the server's cached fog meshes (background and overlay) against the
+// per-chunk fog they replace: every quad shows the fog band of its centre, the
+// view is covered, incremental updates match a fresh mesh and a still player
+// costs nothing. Also compares draw calls and CPU time per frame while walking.
+//
+// Code under test is copied from Zero_Ground.cpp; the few SFML types it
+// touches are replaced by minimal stand-ins. Build with /O2 (or -O2).
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+
+// ========================
+// Test Framework Macros
+// ========================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "Running test: " << #name << "..."; \
+    try { \
+        test_##name(); \
+        std::cout << " PASSED" << std::endl; \
+        passedTests++; \
+    } catch (const std::exception& e) { \
+        std::cout << " FAILED: " << e.what() << std::endl; \
+        failedTests++; \
+    } \
+    totalTests++; \
+} while(0)
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: " << #condition << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_NEAR(expected, actual, epsilon) do { \
+    if (std::abs((expected) - (actual)) > (epsilon)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << (expected) << " but got " << (actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(expected, actual) do { \
+    if ((expected) != (actual)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << static_cast<int>(expected) << " but got " << static_cast<int>(actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+// Test counters
+int totalTests = 0;
+int passedTests = 0;
+int failedTests = 0;
+
+
+// ========================
+// Code Under Test (copied from Zero_Ground.cpp)
+// ========================
+
+// Minimal stand-ins for the SFML types used by the fog meshes
+namespace sf {
+typedef uint8_t Uint8;
+struct Vector2f {
+    float x = 0.0f;
+    float y = 0.0f;
+    Vector2f() {}
+    Vector2f(float x_, float y_) : x(x_), y(y_) {}
+};
+struct Color {
+    Uint8 r = 0, g = 0, b = 0, a = 255;
+    Color() {}
+    Color(Uint8 r_, Uint8 g_, Uint8 b_, Uint8 a_ = 255) : r(r_), g(g_), b(b_), a(a_) {}
+};
+struct Vertex {
+    Vector2f position;
+    Color color;
+};
+enum PrimitiveType { Quads };
+class VertexArray {
+public:
+    void setPrimitiveType(PrimitiveType) {}
+    void resize(size_t count) { vertices_.resize(count); }
+    size_t getVertexCount() const { return vertices_.size(); }
+    Vertex& operator[](size_t index) { return vertices_[index]; }
+    const Vertex& operator[](size_t index) const { return vertices_[index]; }
+private:
+    std::vector<Vertex> vertices_;
+};
+// Records draw calls and the last vertex array drawn
+class RenderTarget {
+public:
+    void draw(const VertexArray& vertices) { drawCalls++; last = &vertices; }
+    int drawCalls = 0;
+    const VertexArray* last = nullptr;
+};
+}
+
+const float MAP_SIZE = 5100.0f;
+
+// Fog of War visibility ranges
+const float FOG_RANGE_1 = 210.0f;   // 100% visibility
+const float FOG_RANGE_2 = 510.0f;   // 60% visibility
+const float FOG_RANGE_3 = 930.0f;   // 40% visibility
+const float FOG_RANGE_4 = 1020.0f;  // 20% visibility
+
+// ========================
+// Fog of War System
+// ========================
+
+// Calculate alpha (transparency) based on distance from player
+// Returns value from 0 (invisible) to 255 (fully visible)
+sf::Uint8 calculateFogAlpha(float distance) {
+    if (distance <= FOG_RANGE_1) {
+        return 255;  // 100% visibility
+    } else if (distance <= FOG_RANGE_2) {
+        return 153;  // 60% visibility (255 * 0.6)
+    } else if (distance <= FOG_RANGE_3) {
+        return 102;  // 40% visibility (255 * 0.4)
+    } else if (distance <= FOG_RANGE_4) {
+        return 51;   // 20% visibility (255 * 0.2)
+    } else {
+        return 0;    // Invisible beyond FOG_RANGE_4
+    }
+}
+
+// ========================
+// PERFORMANCE: Cached Fog Meshes
+// ========================
+
+// ALGORITHM:
+// The fogged background and the fog overlay are grids of flat-colored squares
+// whose alpha depends only on the distance from the square's centre to the
+// player. Each layer is kept as one sf::VertexArray of world-aligned quads:
+// - Quad positions are laid out only when the view crosses a chunk boundary
+//   (the covered column/row range changes)
+// - When the player moves, the fog band of every quad is recomputed and only
+//   quads whose band changed get their 4 vertex colors rewritten
+// - A frame draws each layer with a single call
+//
+// PERFORMANCE:
+// Replaces building and drawing one sf::RectangleShape per chunk every frame
+// (~1400 background + ~250 overlay shapes at 1920x1080) with two draw calls.
+class FogMesh {
+public:
+    // darken: false = color fades out with distance (background),
+    //         true = black fades in with distance (overlay)
+    FogMesh(float chunkSize, sf::Color color, bool darken)
+        : chunkSize_(chunkSize), color_(color), darken_(darken) {
+        vertices_.setPrimitiveType(sf::Quads);
+    }
+    
+    // Bring the mesh up to date for the world region [minX, maxX) x [minY, maxY)
+    // and the player's position. Returns the number of quads recolored.
+    size_t update(float minX, float minY, float maxX, float maxY, sf::Vector2f playerPosition) {
+        int firstCol = static_cast<int>(std::floor(minX / chunkSize_));
+        int firstRow = static_cast<int>(std::floor(minY / chunkSize_));
+        int cols = std::max(0, static_cast<int>(std::ceil(maxX / chunkSize_)) - firstCol);
+        int rows = std::max(0, static_cast<int>(std::ceil(maxY / chunkSize_)) - firstRow);
+        
+        bool relaid = false;
+        if (firstCol != firstCol_ || firstRow != firstRow_ || cols != cols_ || rows != rows_) {
+            layout(firstCol, firstRow, cols, rows);
+            relaid = true;
+        }
+        
+        if (!relaid && playerPosition.x == lastPlayerPos_.x && playerPosition.y == lastPlayerPos_.y) {
+            return 0;
+        }
+        lastPlayerPos_ = playerPosition;
+        
+        size_t recolored = 0;
+        for (int c = 0; c < cols_; c++) {
+            float dx = (firstCol_ + c + 0.5f) * chunkSize_ - playerPosition.x;
+            for (int r = 0; r < rows_; r++) {
+                float dy = (firstRow_ + r + 0.5f) * chunkSize_ - playerPosition.y;
+                sf::Uint8 alpha = calculateFogAlpha(std::sqrt(dx * dx + dy * dy));
+                
+                size_t quad = static_cast<size_t>(c) * rows_ + r;
+                if (!relaid && alpha == quadAlpha_[quad]) continue;
+                quadAlpha_[quad] = alpha;
+                
+                sf::Color fogged(color_.r, color_.g, color_.b, darken_ ? 255 - alpha : alpha);
+                for (size_t v = quad * 4; v < quad * 4 + 4; v++) {
+                    vertices_[v].color = fogged;
+                }
+                recolored++;
+            }
+        }
+        return recolored;
+    }
+    
+    void draw(sf::RenderTarget& target) const {
+        target.draw(vertices_);
+    }
+    
+private:
+    // Lay out cols x rows quads starting at chunk (firstCol, firstRow)
+    void layout(int firstCol, int firstRow, int cols, int rows) {
+        firstCol_ = firstCol;
+        firstRow_ = firstRow;
+        cols_ = cols;
+        rows_ = rows;
+        vertices_.resize(static_cast<size_t>(cols) * rows * 4);
+        quadAlpha_.assign(static_cast<size_t>(cols) * rows, 0);
+        
+        for (int c = 0; c < cols; c++) {
+            float left = (firstCol + c) * chunkSize_;
+            for (int r = 0; r < rows; r++) {
+                float top = (firstRow + r) * chunkSize_;
+                size_t v = (static_cast<size_t>(c) * rows + r) * 4;
+                vertices_[v].position = sf::Vector2f(left, top);
+                vertices_[v + 1].position = sf::Vector2f(left + chunkSize_, top);
+                vertices_[v + 2].position = sf::Vector2f(left + chunkSize_, top + chunkSize_);
+                vertices_[v + 3].position = sf::Vector2f(left, top + chunkSize_);
+            }
+        }
+    }
+    
+    float chunkSize_;
+    sf::Color color_;
+    bool darken_;
+    sf::VertexArray vertices_;
+    std::vector<sf::Uint8> quadAlpha_;   // calculateFogAlpha value each quad shows
+    int firstCol_ = 0;
+    int firstRow_ = 0;
+    int cols_ = -1;                      // -1: nothing laid out yet
+    int rows_ = -1;
+    sf::Vector2f lastPlayerPos_;
+};
+
+// ========================
+// Reference: Per-Chunk Fog (previous renderers, one shape per chunk)
+// ========================
+
+// Number of shapes the previous renderFoggedBackground and renderFogOverlay
+// built and drew (one window.draw each) for this view
+int legacyFogShapes(sf::Vector2f viewCenter, sf::Vector2f viewSize) {
+    int shapes = 0;
+    auto layer = [&](float minX, float minY, float maxX, float maxY, float chunkSize) {
+        for (float x = minX; x < maxX; x += chunkSize) {
+            for (float y = minY; y < maxY; y += chunkSize) {
+                shapes++;
+            }
+        }
+    };
+    float padding = 200.0f;
+    layer(std::max(0.0f, viewCenter.x - viewSize.x / 2.0f - padding), std::max(0.0f, viewCenter.y - viewSize.y / 2.0f - padding),
+          std::min(MAP_SIZE, viewCenter.x + viewSize.x / 2.0f + padding), std::min(MAP_SIZE, viewCenter.y + viewSize.y / 2.0f + padding), 50.0f);
+    layer(viewCenter.x - viewSize.x / 2.0f, viewCenter.y - viewSize.y / 2.0f,
+          viewCenter.x + viewSize.x / 2.0f, viewCenter.y + viewSize.y / 2.0f, 100.0f);
+    return shapes;
+}
+
+// ========================
+// Helpers
+// ========================
+
+const sf::Color BACKGROUND_COLOR(136, 101, 56);
+
+// Background bounds as renderFoggedBackground computes them
+void backgroundBounds(sf::Vector2f viewCenter, sf::Vector2f viewSize, float& minX, float& minY, float& maxX, float& maxY) {
+    float padding = 200.0f;
+    minX = std::max(0.0f, viewCenter.x - viewSize.x / 2.0f - padding);
+    maxX = std::min(MAP_SIZE, viewCenter.x + viewSize.x / 2.0f + padding);
+    minY = std::max(0.0f, viewCenter.y - viewSize.y / 2.0f - padding);
+    maxY = std::min(MAP_SIZE, viewCenter.y + viewSize.y / 2.0f + padding);
+}
+
+const sf::VertexArray& meshVertices(const FogMesh& mesh) {
+    sf::RenderTarget target;
+    mesh.draw(target);
+    return *target.last;
+}
+
+// Every quad is chunk-sized, world-aligned and colored with the fog band of its centre
+void checkQuads(const sf::VertexArray& vertices, float chunkSize, sf::Color color, bool darken, sf::Vector2f player) {
+    ASSERT_TRUE(vertices.getVertexCount() % 4 == 0);
+    for (size_t v = 0; v < vertices.getVertexCount(); v += 4) {
+        const sf::Vertex& topLeft = vertices[v];
+        ASSERT_NEAR(chunkSize, vertices[v + 2].position.x - topLeft.position.x, 0.001f);
+        ASSERT_NEAR(chunkSize, vertices[v + 2].position.y - topLeft.position.y, 0.001f);
+        ASSERT_NEAR(0.0f, std::fmod(topLeft.position.x, chunkSize), 0.001f);
+        
+        float dx = topLeft.position.x + chunkSize / 2.0f - player.x;
+        float dy = topLeft.position.y + chunkSize / 2.0f - player.y;
+        sf::Uint8 alpha = calculateFogAlpha(std::sqrt(dx * dx + dy * dy));
+        for (size_t k = v; k < v + 4; k++) {
+            ASSERT_EQ(color.r, vertices[k].color.r);
+            ASSERT_EQ(color.b, vertices[k].color.b);
+            ASSERT_EQ(darken ? 255 - alpha : alpha, vertices[k].color.a);
+        }
+    }
+}
+
+// Covered region of the mesh: [minX, maxX) x [minY, maxY)
+void meshBounds(const sf::VertexArray& vertices, float& minX, float& minY, float& maxX, float& maxY) {
+    minX = minY = 1e9f;
+    maxX = maxY = -1e9f;
+    for (size_t v = 0; v < vertices.getVertexCount(); v++) {
+        minX = std::min(minX, vertices[v].position.x);
+        minY = std::min(minY, vertices[v].position.y);
+        maxX = std::max(maxX, vertices[v].position.x);
+        maxY = std::max(maxY, vertices[v].position.y);
+    }
+}
+
+// ========================
+// Tests
+// ========================
+
+TEST(BackgroundShowsFogBands) {
+    FogMesh mesh(50.0f, BACKGROUND_COLOR, false);
+    sf::Vector2f player(1234.0f, 2345.0f);
+    float minX, minY, maxX, maxY;
+    backgroundBounds(player, sf::Vector2f(1920.0f, 1080.0f), minX, minY, maxX, maxY);
+    mesh.update(minX, minY, maxX, maxY, player);
+    checkQuads(meshVertices(mesh), 50.0f, BACKGROUND_COLOR, false, player);
+}
+
+TEST(OverlayDarkensWithDistance) {
+    FogMesh mesh(100.0f, sf::Color(0, 0, 0), true);
+    sf::Vector2f player(3000.0f, 700.0f);
+    mesh.update(player.x - 960.0f, player.y - 540.0f, player.x + 960.0f, player.y + 540.0f, player);
+    const sf::VertexArray& vertices = meshVertices(mesh);
+    checkQuads(vertices, 100.0f, sf::Color(0, 0, 0), true, player);
+    
+    // Fully clear at the player, fully dark in the corners
+    bool clear = false, dark = false;
+    for (size_t v = 0; v < vertices.getVertexCount(); v++) {
+        clear = clear || vertices[v].color.a == 0;
+        dark = dark || vertices[v].color.a == 255;
+    }
+    ASSERT_TRUE(clear && dark);
+}
+
+TEST(MeshCoversView) {
+    std::mt19937 gen(4);
+    std::uniform_real_distribution<float> posDist(0.0f, MAP_SIZE);
+    FogMesh background(50.0f, BACKGROUND_COLOR, false);
+    FogMesh overlay(100.0f, sf::Color(0, 0, 0), true);
+    for (int n = 0; n < 500; n++) {
+        sf::Vector2f center(posDist(gen), posDist(gen));
+        float minX, minY, maxX, maxY;
+        backgroundBounds(center, sf::Vector2f(1920.0f, 1080.0f), minX, minY, maxX, maxY);
+        background.update(minX, minY, maxX, maxY, center);
+        float coverMinX, coverMinY, coverMaxX, coverMaxY;
+        meshBounds(meshVertices(background), coverMinX, coverMinY, coverMaxX, coverMaxY);
+        ASSERT_TRUE(coverMinX <= minX && coverMinY <= minY && coverMaxX >= maxX && coverMaxY >= maxY);
+        ASSERT_TRUE(coverMinX > minX - 50.0f && coverMaxX < maxX + 50.0f);
+        // Clamped bounds stay inside the map
+        ASSERT_TRUE(coverMinX >= 0.0f && coverMaxX <= MAP_SIZE && coverMinY >= 0.0f && coverMaxY <= MAP_SIZE);
+        
+        overlay.update(center.x - 960.0f, center.y - 540.0f, center.x + 960.0f, center.y + 540.0f, center);
+        meshBounds(meshVertices(overlay), coverMinX, coverMinY, coverMaxX, coverMaxY);
+        ASSERT_TRUE(coverMinX <= center.x - 960.0f && coverMaxX >= center.x + 960.0f);
+        ASSERT_TRUE(coverMinY <= center.y - 540.0f && coverMaxY >= center.y + 540.0f);
+    }
+}
+
+TEST(IncrementalMatchesFreshMesh) {
+    FogMesh walking(50.0f, BACKGROUND_COLOR, false);
+    sf::Vector2f player(800.0f, 2500.0f);
+    for (int frame = 0; frame < 400; frame++) {
+        player.x += 3.5f;
+        player.y += std::sin(frame / 25.0f) * 4.0f;
+        float minX, minY, maxX, maxY;
+        backgroundBounds(player, sf::Vector2f(1280.0f, 720.0f), minX, minY, maxX, maxY);
+        walking.update(minX, minY, maxX, maxY, player);
+        
+        FogMesh fresh(50.0f, BACKGROUND_COLOR, false);
+        fresh.update(minX, minY, maxX, maxY, player);
+        const sf::VertexArray& a = meshVertices(walking);
+        const sf::VertexArray& b = meshVertices(fresh);
+        ASSERT_EQ(b.getVertexCount(), a.getVertexCount());
+        for (size_t v = 0; v < a.getVertexCount(); v++) {
+            ASSERT_NEAR(b[v].position.x, a[v].position.x, 0.001f);
+            ASSERT_NEAR(b[v].position.y, a[v].position.y, 0.001f);
+            ASSERT_EQ(b[v].color.a, a[v].color.a);
+        }
+    }
+}
+
+TEST(StillPlayerCostsNothing) {
+    FogMesh mesh(100.0f, sf::Color(0, 0, 0), true);
+    sf::Vector2f player(2550.0f, 2550.0f);
+    size_t first = mesh.update(1590.0f, 2010.0f, 3510.0f, 3090.0f, player);
+    ASSERT_TRUE(first > 0);
+    ASSERT_EQ(0, static_cast<int>(mesh.update(1590.0f, 2010.0f, 3510.0f, 3090.0f, player)));
+    
+    // Panning inside the same chunk range does not re-lay the quads either
+    ASSERT_EQ(0, static_cast<int>(mesh.update(1550.0f, 2001.0f, 3550.0f, 3099.0f, player)));
+    
+    // A small step recolors only quads whose band changed
+    size_t step = mesh.update(1590.0f, 2010.0f, 3510.0f, 3090.0f, sf::Vector2f(2553.0f, 2550.0f));
+    ASSERT_TRUE(step < first / 4);
+}
+
+// ========================
+// Benchmark
+// ========================
+
+// Shapes built and drawn per frame before vs draw calls and CPU time now
+void benchmarkFogMeshes(float viewW, float viewH) {
+    const int FRAMES = 300;
+    sf::Vector2f viewSize(viewW, viewH);
+    std::vector<sf::Vector2f> path;
+    for (int frame = 0; frame < FRAMES; ++frame) {
+        float t = frame / 60.0f;
+        path.push_back(sf::Vector2f(1200.0f + frame * 3.5f, 2550.0f + std::sin(t) * 150.0f));
+    }
+    
+    long long shapes = 0;
+    for (const sf::Vector2f& p : path) {
+        shapes += legacyFogShapes(p, viewSize);
+    }
+    
+    FogMesh background(50.0f, BACKGROUND_COLOR, false);
+    FogMesh overlay(100.0f, sf::Color(0, 0, 0), true);
+    sf::RenderTarget target;
+    size_t recolored = 0;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (const sf::Vector2f& p : path) {
+        float minX, minY, maxX, maxY;
+        backgroundBounds(p, viewSize, minX, minY, maxX, maxY);
+        recolored += background.update(minX, minY, maxX, maxY, p);
+        background.draw(target);
+        recolored += overlay.update(p.x - viewW / 2.0f, p.y - viewH / 2.0f, p.x + viewW / 2.0f, p.y + viewH / 2.0f, p);
+        overlay.draw(target);
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    double meshUs = std::chrono::duration<double, std::micro>(t1 - t0).count() / FRAMES;
+    
+    std::cout << std::setw(6) << static_cast<int>(viewW) << "x" << std::setw(5) << std::left << static_cast<int>(viewH)
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(16) << static_cast<double>(shapes) / FRAMES
+              << std::setw(13) << static_cast<double>(target.drawCalls) / FRAMES
+              << std::setw(18) << static_cast<double>(recolored) / FRAMES
+              << std::setw(15) << meshUs << std::endl;
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Zero Ground Cached Fog Mesh Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "--- Fog Mesh Tests ---" << std::endl;
+    RUN_TEST(BackgroundShowsFogBands);
+    RUN_TEST(OverlayDarkensWithDistance);
+    RUN_TEST(MeshCoversView);
+    RUN_TEST(IncrementalMatchesFreshMesh);
+    RUN_TEST(StillPlayerCostsNothing);
+
+    std::cout << std::endl;
+    std::cout << "--- Fog Layers per Frame (walking, 300 frames) ---" << std::endl;
+    std::cout << std::setw(12) << "View" << std::setw(16) << "Shapes before" << std::setw(13) << "Draw calls"
+              << std::setw(18) << "Quads recolored" << std::setw(15) << "Update (us)" << std::endl;
+    benchmarkFogMeshes(800.0f, 600.0f);
+    benchmarkFogMeshes(1920.0f, 1080.0f);
+    benchmarkFogMeshes(2560.0f, 1440.0f);
+
+    // Print summary
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Test Summary" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Total tests: " << totalTests << std::endl;
+    std::cout << "Passed: " << passedTests << std::endl;
+    std::cout << "Failed: " << failedTests << std::endl;
+    std::cout << std::endl;
+
+    if (failedTests == 0) {
+        std::cout << "✓ All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "✗ Some tests failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,1176 @@
+// Input Prediction Tests and Benchmark for Zero Ground
+// Checks the sequenced input commands that replaced client-reported positions:
+// the input and input ack wire layouts, the server's input queue (repeats
+// dropped, simulation paced at INPUT_RATE so extra commands gain nothing) and
+// the client's prediction against the server over a simulated link - no
+// corrections without loss, none when redundancy covers lost datagrams, and
+// exact convergence after real divergence or a server-side teleport.
+// Then times a reconciliation and compares upstream bandwidth.
+//
+// Code under test is copied from Zero_Ground.cpp and Zero_Ground_client.cpp;
+// the few SFML types it touches are replaced by minimal stand-ins, and the
+// weapon table by its movement speeds. Build with /O2 (or -O2).
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <array>
+#include <deque>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+#if defined(_MSC_VER)
+#include <intrin.h>  // __popcnt64
+#endif
+
+// ========================
+// Test Framework Macros
+// ========================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "Running test: " << #name << "..."; \
+    try { \
+        test_##name(); \
+        std::cout << " PASSED" << std::endl; \
+        passedTests++; \
+    } catch (const std::exception& e) { \
+        std::cout << " FAILED: " << e.what() << std::endl; \
+        failedTests++; \
+    } \
+    totalTests++; \
+} while(0)
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: " << #condition << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_NEAR(expected, actual, epsilon) do { \
+    if (std::abs((expected) - (actual)) > (epsilon)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << (expected) << " but got " << (actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(expected, actual) do { \
+    if ((expected) != (actual)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << static_cast<int>(expected) << " but got " << static_cast<int>(actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+// Test counters
+int totalTests = 0;
+int passedTests = 0;
+int failedTests = 0;
+
+
+// ========================
+// Structures (copied from main code)
+// ========================
+
+// Minimal stand-ins for the SFML types used by the grid code
+namespace sf {
+struct Vector2f {
+    float x = 0.0f;
+    float y = 0.0f;
+    Vector2f() {}
+    Vector2f(float x_, float y_) : x(x_), y(y_) {}
+};
+struct Vector2i {
+    int x = 0;
+    int y = 0;
+    Vector2i() {}
+    Vector2i(int x_, int y_) : x(x_), y(y_) {}
+    bool operator==(const Vector2i& other) const { return x == other.x && y == other.y; }
+};
+struct FloatRect {
+    float left = 0.0f, top = 0.0f, width = 0.0f, height = 0.0f;
+    FloatRect(float l, float t, float w, float h) : left(l), top(t), width(w), height(h) {}
+    bool intersects(const FloatRect& other) const {
+        float interLeft = std::max(left, other.left);
+        float interTop = std::max(top, other.top);
+        float interRight = std::min(left + width, other.left + other.width);
+        float interBottom = std::min(top + height, other.top + other.height);
+        return interLeft < interRight && interTop < interBottom;
+    }
+};
+}
+
+const float PLAYER_SIZE = 30.0f;
+
+const float MAP_SIZE = 5100.0f;
+const float CELL_SIZE = 100.0f;
+const int GRID_SIZE = 51;
+const float WALL_WIDTH = 12.0f;
+const float WALL_LENGTH = 100.0f;
+
+enum class WallType : uint8_t {
+    None = 0,
+    Concrete = 1,
+    Wood = 2
+};
+// Movement speeds of the weapon table (Player::getMovementSpeed() without a
+// weapon, then Weapon::USP..M40), in place of the Weapon structs
+float inputMovementSpeed(uint8_t weaponCode) {
+    static const float speeds[] = { 3.0f, 2.5f, 2.5f, 2.5f, 2.5f, 2.0f, 1.8f, 1.6f, 1.1f, 1.0f, 1.2f };
+    return weaponCode < sizeof(speeds) / sizeof(speeds[0]) ? speeds[weaponCode] : speeds[0];
+}
+
+// ========================
+// Code Under Test (copied from Zero_Ground.cpp and Zero_Ground_client.cpp)
+// ========================
+
+const uint8_t WIRE_VERSION = 3;                 // Version 2 sent client positions instead of inputs
+const size_t WIRE_HEADER_BYTES = 5;
+const size_t WIRE_MESSAGE_HEADER_BYTES = 3;
+const size_t MAX_DATAGRAM_BYTES = 1200;         // Stays below a typical 1500 byte MTU
+const uint32_t NO_SNAPSHOT_ACK = 0xFFFFFFFF;    // Input message ackTick before the first snapshot
+
+// Little-endian field access; payloads are unaligned, so go through bytes
+inline void storeU16(uint8_t* p, uint16_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+}
+
+inline void storeU32(uint8_t* p, uint32_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+    p[2] = static_cast<uint8_t>(value >> 16);
+    p[3] = static_cast<uint8_t>(value >> 24);
+}
+
+inline void storeF32(uint8_t* p, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    storeU32(p, bits);
+}
+
+inline uint16_t loadU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t loadU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline float loadF32(const uint8_t* p) {
+    uint32_t bits = loadU32(p);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// ------------------------
+// Input Message
+// ------------------------
+// playerId:8, ackTick:32, firstSequence:32, count:8,
+// then count * (buttons:8, aim:16) with sequences firstSequence, firstSequence + 1, ...
+//
+// The client samples its controls INPUT_RATE times per second into sequenced
+// commands and sends the newest MAX_INPUT_COMMANDS with every datagram, so a lost
+// datagram is covered by the next one. The server simulates the movement itself
+// (see InputQueue) and never takes a position from the client.
+
+const float INPUT_RATE = 60.0f;                  // Commands per second (movement speeds are per 1/60 s)
+const float INPUT_STEP = 1.0f / INPUT_RATE;      // Simulated time per command
+const size_t MAX_INPUT_COMMANDS = 8;             // Newest commands repeated in every datagram
+const size_t INPUT_MESSAGE_HEADER_BYTES = 10;
+const size_t INPUT_COMMAND_BYTES = 3;
+const size_t MAX_INPUT_MESSAGE_BYTES = INPUT_MESSAGE_HEADER_BYTES + MAX_INPUT_COMMANDS * INPUT_COMMAND_BYTES;
+
+// Low nibble of InputCommand::buttons; the high nibble is the active weapon
+// (Weapon::Type + 1, 0 = no weapon), which decides the movement speed
+const uint8_t INPUT_UP = 0x01;
+const uint8_t INPUT_DOWN = 0x02;
+const uint8_t INPUT_LEFT = 0x04;
+const uint8_t INPUT_RIGHT = 0x08;
+
+// One sampled frame of client controls
+struct InputCommand {
+    uint32_t sequence = 0;  // Client input tick, +1 per command
+    uint8_t buttons = 0;    // INPUT_* bits | weapon code << 4
+    uint16_t aim = 0;       // Rotation, 1/65536 of a turn
+};
+
+inline uint8_t inputWeaponCode(uint8_t buttons) {
+    return static_cast<uint8_t>(buttons >> 4);
+}
+
+inline uint16_t quantizeAim(float degrees) {
+    float turns = degrees / 360.0f;
+    turns -= std::floor(turns);
+    return static_cast<uint16_t>(static_cast<uint32_t>(std::lround(turns * 65536.0f)) & 0xFFFF);
+}
+
+inline float dequantizeAim(uint16_t aim) {
+    return aim * (360.0f / 65536.0f);
+}
+
+// Write the input payload; count must be 1..MAX_INPUT_COMMANDS with consecutive sequences
+// Returns: payload length in bytes
+size_t writeInputMessage(uint8_t* out, uint8_t playerId, uint32_t ackTick, const InputCommand* commands, size_t count) {
+    out[0] = playerId;
+    storeU32(out + 1, ackTick);
+    storeU32(out + 5, commands[0].sequence);
+    out[9] = static_cast<uint8_t>(count);
+    uint8_t* p = out + INPUT_MESSAGE_HEADER_BYTES;
+    for (size_t i = 0; i < count; ++i, p += INPUT_COMMAND_BYTES) {
+        p[0] = commands[i].buttons;
+        storeU16(p + 1, commands[i].aim);
+    }
+    return INPUT_MESSAGE_HEADER_BYTES + count * INPUT_COMMAND_BYTES;
+}
+
+// Reads a validated input payload in place (no copy)
+class InputMessageView {
+public:
+    InputMessageView(const uint8_t* payload, size_t length) : p_(payload), length_(length) {}
+    
+    uint8_t playerId() const { return p_[0]; }
+    uint32_t ackTick() const { return loadU32(p_ + 1); }
+    uint32_t firstSequence() const { return loadU32(p_ + 5); }
+    
+    // Commands actually present (the count field is checked against the length)
+    size_t count() const {
+        return std::min<size_t>(p_[9], (length_ - INPUT_MESSAGE_HEADER_BYTES) / INPUT_COMMAND_BYTES);
+    }
+    
+    InputCommand command(size_t index) const {
+        const uint8_t* p = p_ + INPUT_MESSAGE_HEADER_BYTES + index * INPUT_COMMAND_BYTES;
+        InputCommand command;
+        command.sequence = firstSequence() + static_cast<uint32_t>(index);
+        command.buttons = p[0];
+        command.aim = loadU16(p + 1);
+        return command;
+    }
+    
+private:
+    const uint8_t* p_;
+    size_t length_;
+};
+
+// ------------------------
+// Input Ack Message
+// ------------------------
+// sequence:32, x:f32, y:f32
+//
+// Sent to each client with its snapshot: the last input command the server
+// simulated for that client and the exact position it ended at. The client
+// rewinds its prediction to it and replays the newer commands (see InputPredictor).
+
+const size_t INPUT_ACK_MESSAGE_BYTES = 12;
+
+void writeInputAckMessage(uint8_t* out, uint32_t sequence, float x, float y) {
+    storeU32(out, sequence);
+    storeF32(out + 4, x);
+    storeF32(out + 8, y);
+}
+
+// Reads a validated input ack payload in place (no copy)
+class InputAckMessageView {
+public:
+    explicit InputAckMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint32_t sequence() const { return loadU32(p_); }
+    float x() const { return loadF32(p_ + 4); }
+    float y() const { return loadF32(p_ + 8); }
+    
+private:
+    const uint8_t* p_;
+};
+
+// Per-player buffer of received input commands waiting to be simulated
+//
+// Clients repeat their newest commands in every datagram, so receive() keeps only
+// sequences newer than any seen before (duplicates and reordered datagrams are
+// dropped). Commands lost for good are simply skipped; the InputAck tells the
+// client which command the server is at and its prediction is corrected.
+//
+// ALGORITHM:
+// Commands are simulated at the rate the client sampled them: every tick adds
+// deltaTime * INPUT_RATE commands of credit, capped at MAX_CREDIT, and each
+// simulated command spends one. Commands arriving in a 20 Hz batch are simulated
+// as soon as they arrive, but a client sending more than INPUT_RATE commands per
+// second (fast clock, speed hack) only fills the queue - the server sets the pace.
+//
+// PERFORMANCE:
+// Fixed ring of CAPACITY commands, no allocation; an idle player costs one
+// comparison per tick.
+class InputQueue {
+public:
+    static const size_t CAPACITY = 16;          // ~0.27 s of commands; older ones are dropped when full
+    static constexpr float MAX_CREDIT = 15.0f;  // Commands (0.25 s): catch-up burst after a stall
+    
+    // Queue one received command
+    // Returns: false for a duplicate or stale sequence
+    bool receive(const InputCommand& command) {
+        if (received_ && command.sequence <= newestSequence_) {
+            return false;
+        }
+        if (count_ == CAPACITY) {
+            head_ = (head_ + 1) % CAPACITY;
+            count_--;
+        }
+        commands_[(head_ + count_) % CAPACITY] = command;
+        count_++;
+        newestSequence_ = command.sequence;
+        received_ = true;
+        return true;
+    }
+    
+    // Simulate the commands this tick's credit allows, oldest first
+    // Returns: number of commands passed to apply(const InputCommand&)
+    template <typename ApplyFn>
+    size_t consume(float deltaTime, ApplyFn apply) {
+        // Tick deltas are not exact multiples of INPUT_STEP; the epsilon keeps a
+        // 60 Hz server from always running one tick behind on rounding
+        const float epsilon = 0.001f;
+        credit_ = std::min(credit_ + deltaTime * INPUT_RATE, MAX_CREDIT);
+        
+        size_t simulated = 0;
+        while (count_ > 0 && credit_ >= 1.0f - epsilon) {
+            const InputCommand& command = commands_[head_];
+            apply(command);
+            lastSimulated_ = command.sequence;
+            simulatedAny_ = true;
+            head_ = (head_ + 1) % CAPACITY;
+            count_--;
+            credit_ -= 1.0f;
+            simulated++;
+        }
+        return simulated;
+    }
+    
+    // Whether any command has been simulated (only then is there something to acknowledge)
+    bool hasSimulated() const { return simulatedAny_; }
+    
+    // Sequence of the newest simulated command
+    uint32_t lastSimulated() const { return lastSimulated_; }
+    
+    size_t pending() const { return count_; }
+    
+private:
+    std::array<InputCommand, CAPACITY> commands_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    uint32_t newestSequence_ = 0;
+    bool received_ = false;
+    uint32_t lastSimulated_ = 0;
+    bool simulatedAny_ = false;
+    float credit_ = 0.0f;
+};
+
+// Number of set bits
+inline int popCount(uint64_t mask) {
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(mask));
+#else
+    return __builtin_popcountll(mask);
+#endif
+}
+
+// Map walls stored on the cell edges they occupy
+//
+// A wall lies on the boundary between two cells, so it is stored once per edge
+// rather than once per cell side: the right wall of (i, j) and the left wall of
+// (i + 1, j) are the same edge and can no longer disagree. Two bit-planes hold
+// the horizontal edges (top of cell (i, j), lines j = 0..GRID_SIZE) and the
+// vertical edges (left of cell (i, j), lines i = 0..GRID_SIZE), 2 bits per edge
+// holding the WallType value, 32 edges per 64-bit word. Queries outside the map
+// return WallType::None. Walls are centered on their edge (WALL_WIDTH/2 on each side).
+//
+// PERFORMANCE: 2 x 83 words = 1,328 bytes for the whole map instead of 10 KB of
+// per-cell sides, so it stays in L1 and is sent to clients as one span; wall
+// counts take one popcount per 32 edges.
+class CellGrid {
+public:
+    static constexpr int EDGES_PER_PLANE = (GRID_SIZE + 1) * GRID_SIZE;
+    static constexpr int EDGES_PER_WORD = 32;
+    static constexpr int WORDS_PER_PLANE = (EDGES_PER_PLANE + EDGES_PER_WORD - 1) / EDGES_PER_WORD;
+    static constexpr int WORD_COUNT = 2 * WORDS_PER_PLANE;
+    static constexpr size_t BYTE_SIZE = WORD_COUNT * sizeof(uint64_t);  // Serialized map size
+    
+    CellGrid() { clear(); }
+    
+    // Wall on the horizontal edge along the top of cell (i, j), j in [0, GRID_SIZE]
+    WallType horizontal(int i, int j) const {
+        if (i < 0 || i >= GRID_SIZE || j < 0 || j > GRID_SIZE) return WallType::None;
+        return get(HORIZONTAL, j * GRID_SIZE + i);
+    }
+    
+    // Wall on the vertical edge along the left of cell (i, j), i in [0, GRID_SIZE]
+    WallType vertical(int i, int j) const {
+        if (i < 0 || i > GRID_SIZE || j < 0 || j >= GRID_SIZE) return WallType::None;
+        return get(VERTICAL, i * GRID_SIZE + j);
+    }
+    
+    void setHorizontal(int i, int j, WallType type) {
+        if (i < 0 || i >= GRID_SIZE || j < 0 || j > GRID_SIZE) return;
+        set(HORIZONTAL, j * GRID_SIZE + i, type);
+    }
+    
+    void setVertical(int i, int j, WallType type) {
+        if (i < 0 || i > GRID_SIZE || j < 0 || j >= GRID_SIZE) return;
+        set(VERTICAL, i * GRID_SIZE + j, type);
+    }
+    
+    // Wall on one side of cell (i, j): 0 = top, 1 = right, 2 = bottom, 3 = left
+    WallType wall(int i, int j, int side) const {
+        switch (side) {
+            case 0: return horizontal(i, j);
+            case 1: return vertical(i + 1, j);
+            case 2: return horizontal(i, j + 1);
+            default: return vertical(i, j);
+        }
+    }
+    
+    void setWall(int i, int j, int side, WallType type) {
+        switch (side) {
+            case 0: setHorizontal(i, j, type); break;
+            case 1: setVertical(i + 1, j, type); break;
+            case 2: setHorizontal(i, j + 1, type); break;
+            default: setVertical(i, j, type); break;
+        }
+    }
+    
+    // Number of walls, a word (32 edges) at a time
+    size_t countWalls() const {
+        size_t count = 0;
+        for (uint64_t word : words_) {
+            count += popCount((word | (word >> 1)) & LOW_BITS);
+        }
+        return count;
+    }
+    
+    // Number of walls of one type (Concrete or Wood)
+    size_t countWalls(WallType type) const {
+        size_t count = 0;
+        for (uint64_t word : words_) {
+            uint64_t low = word & LOW_BITS;
+            uint64_t high = (word >> 1) & LOW_BITS;
+            count += popCount(type == WallType::Wood ? (high & ~low) : (low & ~high));
+        }
+        return count;
+    }
+    
+    // Remove every wall
+    void clear() { words_.fill(0); }
+    
+    // Clear the bit pairs that encode no wall (the value 3 and the unused tail of
+    // each plane), so nothing received from the network can corrupt the map
+    void sanitize() {
+        const int tailEdges = EDGES_PER_PLANE % EDGES_PER_WORD;
+        const uint64_t tailMask = (tailEdges == 0) ? ~0ULL : (1ULL << (tailEdges * 2)) - 1;
+        for (int w = 0; w < WORD_COUNT; w++) {
+            uint64_t invalid = words_[w] & (words_[w] >> 1) & LOW_BITS;
+            words_[w] &= ~(invalid * 3);
+            if (w % WORDS_PER_PLANE == WORDS_PER_PLANE - 1) words_[w] &= tailMask;
+        }
+    }
+    
+    // Raw storage, WORD_COUNT words: the horizontal plane, then the vertical plane
+    const uint64_t* data() const { return words_.data(); }
+    uint64_t* data() { return words_.data(); }
+    
+private:
+    static constexpr int HORIZONTAL = 0;
+    static constexpr int VERTICAL = 1;
+    static constexpr uint64_t LOW_BITS = 0x5555555555555555ULL;  // Low bit of every edge
+    
+    WallType get(int plane, int edge) const {
+        uint64_t word = words_[plane * WORDS_PER_PLANE + edge / EDGES_PER_WORD];
+        return static_cast<WallType>((word >> (edge % EDGES_PER_WORD * 2)) & 3);
+    }
+    
+    void set(int plane, int edge, WallType type) {
+        uint64_t& word = words_[plane * WORDS_PER_PLANE + edge / EDGES_PER_WORD];
+        const int shift = edge % EDGES_PER_WORD * 2;
+        word = (word & ~(3ULL << shift)) | (static_cast<uint64_t>(type) << shift);
+    }
+    
+    std::array<uint64_t, WORD_COUNT> words_;
+};
+
+// Generate map using probabilistic algorithm
+// Only cells where (i+j)%2==1 can have walls
+// Probabilities: 60% - 1 wall, 25% - 2 walls, 15% - 0 walls
+// Wall types: 70% concrete, 30% wood
+// A wall on a side shared with a neighbour that already has one there replaces it
+void generateMap(CellGrid& grid, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> probDist(0, 99);  // 0-99 for percentages
+    std::uniform_int_distribution<int> sideDist(0, 3);   // 0-3 for sides
+    std::uniform_int_distribution<int> typeDist(0, 99);  // 0-99 for wall type
+    
+    for (int i = 0; i < GRID_SIZE; i++) {
+        for (int j = 0; j < GRID_SIZE; j++) {
+            // Check condition: only cells where (i+j)%2==1 can generate walls
+            if ((i + j) % 2 == 1) {
+                int probability = probDist(gen);
+                
+                if (probability < 60) {
+                    // 60% probability - create one wall on a random side
+                    int side = sideDist(gen);
+                    // Determine wall type: 70% concrete, 30% wood
+                    WallType type = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    grid.setWall(i, j, side, type);
+                }
+                else if (probability < 85) {
+                    // 25% probability (60-84) - create two walls on different sides
+                    int side1 = sideDist(gen);
+                    int side2 = sideDist(gen);
+                    
+                    // Ensure the two sides are different
+                    while (side2 == side1) {
+                        side2 = sideDist(gen);
+                    }
+                    
+                    // Each wall gets its own type
+                    WallType type1 = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    WallType type2 = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    grid.setWall(i, j, side1, type1);
+                    grid.setWall(i, j, side2, type2);
+                }
+                // 15% probability (85-99) - no walls (do nothing)
+            }
+        }
+    }
+}
+
+// Helper function to check if a position collides with walls
+bool checkCollision(sf::Vector2f pos, const CellGrid& grid) {
+    sf::FloatRect playerRect(
+        pos.x - PLAYER_SIZE / 2.0f,
+        pos.y - PLAYER_SIZE / 2.0f,
+        PLAYER_SIZE,
+        PLAYER_SIZE
+    );
+    
+    // Only the edges whose wall can overlap the player are tested: horizontal edges
+    // on the lines within WALL_WIDTH/2 of the player's top..bottom, vertical edges on
+    // the lines within WALL_WIDTH/2 of its left..right; usually one or two of each
+    const float half = WALL_WIDTH / 2.0f;
+    const float right = playerRect.left + playerRect.width;
+    const float bottom = playerRect.top + playerRect.height;
+    const int cellMinX = static_cast<int>(std::floor(playerRect.left / CELL_SIZE));
+    const int cellMaxX = static_cast<int>(std::floor(right / CELL_SIZE));
+    const int cellMinY = static_cast<int>(std::floor(playerRect.top / CELL_SIZE));
+    const int cellMaxY = static_cast<int>(std::floor(bottom / CELL_SIZE));
+    
+    const int lineMinY = static_cast<int>(std::ceil((playerRect.top - half) / CELL_SIZE));
+    const int lineMaxY = static_cast<int>(std::floor((bottom + half) / CELL_SIZE));
+    for (int j = lineMinY; j <= lineMaxY; j++) {
+        for (int i = cellMinX; i <= cellMaxX; i++) {
+            if (grid.horizontal(i, j) != WallType::None) {
+                sf::FloatRect wallRect(i * CELL_SIZE, j * CELL_SIZE - half, WALL_LENGTH, WALL_WIDTH);
+                if (playerRect.intersects(wallRect)) return true;
+            }
+        }
+    }
+    
+    const int lineMinX = static_cast<int>(std::ceil((playerRect.left - half) / CELL_SIZE));
+    const int lineMaxX = static_cast<int>(std::floor((right + half) / CELL_SIZE));
+    for (int i = lineMinX; i <= lineMaxX; i++) {
+        for (int j = cellMinY; j <= cellMaxY; j++) {
+            if (grid.vertical(i, j) != WallType::None) {
+                sf::FloatRect wallRect(i * CELL_SIZE - half, j * CELL_SIZE, WALL_WIDTH, WALL_LENGTH);
+                if (playerRect.intersects(wallRect)) return true;
+            }
+        }
+    }
+    
+    return false;
+}
+
+// Resolve collision with wall sliding
+// This function implements smooth wall sliding when player moves diagonally into a wall
+//
+// ALGORITHM:
+// 1. Check if new position collides
+// 2. If no collision, return new position
+// 3. If collision, try sliding along X axis (keep Y from newPos, X from oldPos)
+// 4. If X-slide works, return that position
+// 5. If X-slide fails, try sliding along Y axis (keep X from newPos, Y from oldPos)
+// 6. If Y-slide works, return that position
+// 7. If both fail, return old position (stuck against corner)
+//
+// SLIDING BEHAVIOR:
+// - When moving diagonally into a horizontal wall, player slides horizontally
+// - When moving diagonally into a vertical wall, player slides vertically
+// - This creates smooth, intuitive movement along walls
+// - No more getting stuck when pressing two keys at once
+//
+// PERFORMANCE:
+// - Maximum 3 collision checks per frame (newPos, slideX, slideY)
+// - Each check examines the 2-4 edges the player box can overlap
+// - Target: < 0.3ms per collision resolution
+sf::Vector2f resolveCollisionCellBased(sf::Vector2f oldPos, sf::Vector2f newPos, const CellGrid& grid) {
+    // Step 1: Check if new position collides
+    if (!checkCollision(newPos, grid)) {
+        // No collision, clamp to map boundaries and return
+        newPos.x = std::max(PLAYER_SIZE / 2.0f, std::min(newPos.x, MAP_SIZE - PLAYER_SIZE / 2.0f));
+        newPos.y = std::max(PLAYER_SIZE / 2.0f, std::min(newPos.y, MAP_SIZE - PLAYER_SIZE / 2.0f));
+        return newPos;
+    }
+    
+    // Step 2: Collision detected, try sliding along X axis
+    // Keep the new X position, but use old Y position
+    sf::Vector2f slideX(newPos.x, oldPos.y);
+    if (!checkCollision(slideX, grid)) {
+        // X-axis slide works! Player slides horizontally along the wall
+        slideX.x = std::max(PLAYER_SIZE / 2.0f, std::min(slideX.x, MAP_SIZE - PLAYER_SIZE / 2.0f));
+        slideX.y = std::max(PLAYER_SIZE / 2.0f, std::min(slideX.y, MAP_SIZE - PLAYER_SIZE / 2.0f));
+        return slideX;
+    }
+    
+    // Step 3: X-axis slide failed, try sliding along Y axis
+    // Keep the new Y position, but use old X position
+    sf::Vector2f slideY(oldPos.x, newPos.y);
+    if (!checkCollision(slideY, grid)) {
+        // Y-axis slide works! Player slides vertically along the wall
+        slideY.x = std::max(PLAYER_SIZE / 2.0f, std::min(slideY.x, MAP_SIZE - PLAYER_SIZE / 2.0f));
+        slideY.y = std::max(PLAYER_SIZE / 2.0f, std::min(slideY.y, MAP_SIZE - PLAYER_SIZE / 2.0f));
+        return slideY;
+    }
+    
+    // Step 4: Both slides failed (stuck in corner), return old position
+    return oldPos;
+}
+
+// Simulate one input command: move by its buttons for INPUT_STEP, then resolve walls
+// The server and the client's prediction both run this, so replaying the same
+// commands from the same position always ends at the same place.
+sf::Vector2f applyInputCommand(sf::Vector2f position, uint8_t buttons, const CellGrid& grid) {
+    if ((buttons & (INPUT_UP | INPUT_DOWN | INPUT_LEFT | INPUT_RIGHT)) == 0) {
+        return position;
+    }
+    
+    // Speeds are pixels per 1/60 s
+    const float step = inputMovementSpeed(inputWeaponCode(buttons)) * INPUT_STEP * 60.0f;
+    sf::Vector2f target = position;
+    if (buttons & INPUT_UP) target.y -= step;
+    if (buttons & INPUT_DOWN) target.y += step;
+    if (buttons & INPUT_LEFT) target.x -= step;
+    if (buttons & INPUT_RIGHT) target.x += step;
+    
+    return resolveCollisionCellBased(position, target, grid);
+}
+// Client-side prediction with server reconciliation
+//
+// Every sampled command moves the local player immediately (no round trip before
+// the player sees the result) and is kept until the server acknowledges it. Each
+// InputAck carries the last command the server simulated and the position that
+// left the player at: reconcile() restarts from there and replays the commands
+// the server has not reached yet. Both sides run applyInputCommand, so for an
+// undisturbed stream the replay ends exactly where the prediction already was;
+// only lost commands, respawns and hits on the server move the player.
+//
+// PERFORMANCE:
+// Fixed ring of CAPACITY commands, no allocation. A reconciliation replays the
+// unacknowledged commands (~RTT * INPUT_RATE, 6 at 100 ms) once per ack (20 Hz).
+class InputPredictor {
+public:
+    static const size_t CAPACITY = 64;  // ~1 s of commands; older unacknowledged ones are dropped
+    
+    // Record a new command (the sequence is assigned here) and predict it
+    // Returns: the position after the command
+    sf::Vector2f predict(sf::Vector2f position, uint8_t buttons, uint16_t aim, const CellGrid& grid) {
+        if (count_ == CAPACITY) {
+            head_ = (head_ + 1) % CAPACITY;
+            count_--;
+        }
+        InputCommand& command = commands_[(head_ + count_) % CAPACITY];
+        command.sequence = nextSequence_++;
+        command.buttons = buttons;
+        command.aim = aim;
+        count_++;
+        return applyInputCommand(position, buttons, grid);
+    }
+    
+    // Store the server's acknowledgement for the next reconcile()
+    // Acks older than the newest one received (reordered datagrams) are ignored
+    void acknowledge(uint32_t sequence, float x, float y) {
+        if (hasAck_ && sequence <= ackSequence_) {
+            return;
+        }
+        ackSequence_ = sequence;
+        ackPosition_ = sf::Vector2f(x, y);
+        hasAck_ = true;
+        ackPending_ = true;
+    }
+    
+    // Rewind to the acknowledged position and replay the unacknowledged commands
+    // Returns: true (and the corrected position) if a new ack was applied
+    bool reconcile(sf::Vector2f& position, const CellGrid& grid) {
+        if (!ackPending_) {
+            return false;
+        }
+        ackPending_ = false;
+        
+        while (count_ > 0 && commands_[head_].sequence <= ackSequence_) {
+            head_ = (head_ + 1) % CAPACITY;
+            count_--;
+        }
+        
+        position = ackPosition_;
+        for (size_t i = 0; i < count_; ++i) {
+            position = applyInputCommand(position, commands_[(head_ + i) % CAPACITY].buttons, grid);
+        }
+        return true;
+    }
+    
+    // Copy the newest unacknowledged commands, oldest first, for sending
+    // Returns: number of commands copied (at most maxCount)
+    size_t unacknowledged(InputCommand* out, size_t maxCount) const {
+        const size_t count = std::min(count_, maxCount);
+        const size_t first = count_ - count;
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = commands_[(head_ + first + i) % CAPACITY];
+        }
+        return count;
+    }
+    
+    size_t pending() const { return count_; }
+    
+private:
+    std::array<InputCommand, CAPACITY> commands_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    uint32_t nextSequence_ = 0;
+    uint32_t ackSequence_ = 0;
+    sf::Vector2f ackPosition_;
+    bool hasAck_ = false;
+    bool ackPending_ = false;
+};
+
+// ========================
+// Helpers
+// ========================
+
+const uint8_t MOVE_BUTTONS[] = {
+    0, INPUT_UP, INPUT_DOWN, INPUT_LEFT, INPUT_RIGHT,
+    INPUT_UP | INPUT_LEFT, INPUT_UP | INPUT_RIGHT, INPUT_DOWN | INPUT_LEFT, INPUT_DOWN | INPUT_RIGHT
+};
+
+// Client and server of one player over a simulated link, both stepped at 60 Hz
+//
+// The client samples one command per frame and sends the newest MAX_INPUT_COMMANDS
+// unacknowledged ones every sendEvery frames; the server simulates them through
+// an InputQueue and acks every sendEvery frames. Datagrams arrive delayFrames
+// later unless the drop functions say otherwise.
+struct LinkSimulation {
+    struct Datagram {
+        int arrival;
+        std::vector<uint8_t> payload;
+    };
+    
+    const CellGrid& grid;
+    int delayFrames = 3;
+    int sendEvery = 3;
+    std::function<bool(int)> dropInput = [](int) { return false; };  // By input datagram index
+    std::function<bool(int)> dropAck = [](int) { return false; };    // By ack index
+    
+    InputPredictor predictor;
+    sf::Vector2f clientPos;
+    InputQueue queue;
+    sf::Vector2f serverPos;
+    
+    std::deque<Datagram> toServer;
+    std::deque<Datagram> toClient;
+    int frame = 0;
+    int inputsSent = 0;
+    int acksSent = 0;
+    int corrections = 0;
+    float maxCorrection = 0.0f;
+    
+    LinkSimulation(const CellGrid& g, sf::Vector2f spawn) : grid(g), clientPos(spawn), serverPos(spawn) {}
+    
+    void step(uint8_t buttons) {
+        // Client: sample and predict
+        clientPos = predictor.predict(clientPos, buttons, quantizeAim(frame * 3.0f), grid);
+        if (frame % sendEvery == 0) {
+            InputCommand commands[MAX_INPUT_COMMANDS];
+            size_t count = predictor.unacknowledged(commands, MAX_INPUT_COMMANDS);
+            if (count > 0 && !dropInput(inputsSent)) {
+                Datagram datagram{ frame + delayFrames, std::vector<uint8_t>(MAX_INPUT_MESSAGE_BYTES) };
+                datagram.payload.resize(writeInputMessage(datagram.payload.data(), 1, NO_SNAPSHOT_ACK, commands, count));
+                toServer.push_back(datagram);
+            }
+            inputsSent++;
+        }
+        
+        // Server: receive, simulate one tick, ack
+        while (!toServer.empty() && toServer.front().arrival <= frame) {
+            const InputMessageView input(toServer.front().payload.data(), toServer.front().payload.size());
+            for (size_t i = 0; i < input.count(); ++i) {
+                queue.receive(input.command(i));
+            }
+            toServer.pop_front();
+        }
+        queue.consume(INPUT_STEP, [&](const InputCommand& command) {
+            serverPos = applyInputCommand(serverPos, command.buttons, grid);
+        });
+        if (frame % sendEvery == 0 && queue.hasSimulated()) {
+            if (!dropAck(acksSent)) {
+                Datagram datagram{ frame + delayFrames, std::vector<uint8_t>(INPUT_ACK_MESSAGE_BYTES) };
+                writeInputAckMessage(datagram.payload.data(), queue.lastSimulated(), serverPos.x, serverPos.y);
+                toClient.push_back(datagram);
+            }
+            acksSent++;
+        }
+        
+        // Client: apply acks before the next sample
+        while (!toClient.empty() && toClient.front().arrival <= frame) {
+            const InputAckMessageView ack(toClient.front().payload.data());
+            predictor.acknowledge(ack.sequence(), ack.x(), ack.y());
+            toClient.pop_front();
+        }
+        sf::Vector2f corrected = clientPos;
+        if (predictor.reconcile(corrected, grid)) {
+            float error = std::hypot(corrected.x - clientPos.x, corrected.y - clientPos.y);
+            if (error > 0.0f) {
+                corrections++;
+                maxCorrection = std::max(maxCorrection, error);
+            }
+            clientPos = corrected;
+        }
+        frame++;
+    }
+    
+    // Keep pressing random directions (held for a few frames, like a player)
+    void walk(int frames, std::mt19937& rng) {
+        std::uniform_int_distribution<int> pick(0, 8);
+        std::uniform_int_distribution<int> hold(5, 40);
+        uint8_t buttons = 0;
+        int held = 0;
+        for (int f = 0; f < frames; ++f) {
+            if (held-- <= 0) {
+                buttons = MOVE_BUTTONS[pick(rng)] | static_cast<uint8_t>(((rng() % 11)) << 4);
+                held = hold(rng);
+            }
+            step(buttons);
+        }
+    }
+    
+    // Stand still until every command is simulated and acknowledged
+    void settle() {
+        for (int f = 0; f < 60; ++f) step(0);
+    }
+};
+
+CellGrid makeGrid(unsigned seed) {
+    CellGrid grid;
+    generateMap(grid, seed);
+    return grid;
+}
+
+// Centre of the spawn cell used by the server
+const sf::Vector2f SPAWN(250.0f, 250.0f);
+
+// ========================
+// Tests
+// ========================
+
+TEST(InputMessageRoundTrip) {
+    InputCommand commands[5];
+    for (int i = 0; i < 5; ++i) {
+        commands[i].sequence = 1000 + i;
+        commands[i].buttons = static_cast<uint8_t>(INPUT_UP | ((i + 1) << 4));
+        commands[i].aim = static_cast<uint16_t>(i * 12345);
+    }
+    uint8_t payload[MAX_INPUT_MESSAGE_BYTES];
+    size_t length = writeInputMessage(payload, 7, 4242, commands, 5);
+    ASSERT_EQ(INPUT_MESSAGE_HEADER_BYTES + 5 * INPUT_COMMAND_BYTES, length);
+    
+    const InputMessageView view(payload, length);
+    ASSERT_EQ(7, view.playerId());
+    ASSERT_TRUE(view.ackTick() == 4242u);
+    ASSERT_EQ(5u, view.count());
+    for (size_t i = 0; i < 5; ++i) {
+        InputCommand command = view.command(i);
+        ASSERT_TRUE(command.sequence == commands[i].sequence);
+        ASSERT_EQ(commands[i].buttons, command.buttons);
+        ASSERT_TRUE(command.aim == commands[i].aim);
+        ASSERT_EQ(i + 1, inputWeaponCode(command.buttons));
+    }
+    
+    // A count field larger than the payload is clipped to the commands present
+    payload[9] = 200;
+    ASSERT_EQ(5u, InputMessageView(payload, length).count());
+}
+
+TEST(InputAckRoundTrip) {
+    uint8_t payload[INPUT_ACK_MESSAGE_BYTES];
+    writeInputAckMessage(payload, 987654, 1234.5f, 4321.25f);
+    const InputAckMessageView view(payload);
+    ASSERT_TRUE(view.sequence() == 987654u);
+    ASSERT_TRUE(view.x() == 1234.5f);
+    ASSERT_TRUE(view.y() == 4321.25f);
+}
+
+TEST(AimQuantization) {
+    const float resolution = 360.0f / 65536.0f;
+    for (float degrees = -180.0f; degrees < 360.0f; degrees += 7.3f) {
+        float wrapped = degrees < 0.0f ? degrees + 360.0f : degrees;
+        float restored = dequantizeAim(quantizeAim(degrees));
+        float error = std::fabs(restored - wrapped);
+        ASSERT_TRUE(std::min(error, 360.0f - error) <= resolution);
+    }
+    ASSERT_TRUE(quantizeAim(360.0f) == 0);
+}
+
+TEST(QueueDropsRepeatedCommands) {
+    InputQueue queue;
+    int accepted = 0;
+    // Two datagrams overlapping by five commands, then the first one again
+    for (uint32_t s = 1; s <= 8; ++s) accepted += queue.receive(InputCommand{ s, 0, 0 });
+    for (uint32_t s = 4; s <= 11; ++s) accepted += queue.receive(InputCommand{ s, 0, 0 });
+    for (uint32_t s = 1; s <= 8; ++s) accepted += queue.receive(InputCommand{ s, 0, 0 });
+    ASSERT_EQ(11, accepted);
+    ASSERT_EQ(11u, queue.pending());
+    
+    // Simulated in order
+    std::vector<uint32_t> order;
+    queue.consume(1.0f, [&](const InputCommand& command) { order.push_back(command.sequence); });
+    ASSERT_EQ(11u, order.size());
+    for (size_t i = 0; i < order.size(); ++i) ASSERT_TRUE(order[i] == i + 1);
+    ASSERT_TRUE(queue.lastSimulated() == 11u);
+}
+
+TEST(QueueSimulatesAtInputRate) {
+    // 240 Hz server: one command every four ticks once the credit is spent
+    InputQueue queue;
+    for (uint32_t s = 0; s < 16; ++s) queue.receive(InputCommand{ s, 0, 0 });
+    size_t simulated = 0;
+    for (int tick = 0; tick < 16; ++tick) {
+        simulated += queue.consume(1.0f / 240.0f, [](const InputCommand&) {});
+    }
+    ASSERT_EQ(4u, simulated);
+    
+    // After a stall the credit allows a burst of at most MAX_CREDIT commands
+    InputQueue stalled;
+    stalled.consume(2.0f, [](const InputCommand&) {});
+    for (uint32_t s = 0; s < 16; ++s) stalled.receive(InputCommand{ s, 0, 0 });
+    ASSERT_EQ(static_cast<size_t>(InputQueue::MAX_CREDIT), stalled.consume(1.0f / 240.0f, [](const InputCommand&) {}));
+}
+
+TEST(ExtraCommandsGainNoSpeed) {
+    // A client sampling twice per frame (fast clock or speed hack), holding right
+    CellGrid empty;
+    InputQueue queue;
+    sf::Vector2f pos(500.0f, 500.0f);
+    uint32_t sequence = 0;
+    for (int frame = 0; frame < 120; ++frame) {
+        for (int k = 0; k < 2; ++k) queue.receive(InputCommand{ sequence++, INPUT_RIGHT, 0 });
+        queue.consume(INPUT_STEP, [&](const InputCommand& command) {
+            pos = applyInputCommand(pos, command.buttons, empty);
+        });
+    }
+    // Two seconds at 3 px per command and 60 commands per second
+    const float honest = 2.0f * INPUT_RATE * 3.0f;
+    ASSERT_TRUE(pos.x - 500.0f <= honest + 1.0f);
+    ASSERT_TRUE(pos.x - 500.0f >= honest - 3.0f * 2.0f);
+    // The queue stays bounded: the surplus is dropped, not banked
+    ASSERT_TRUE(queue.pending() <= InputQueue::CAPACITY);
+}
+
+TEST(PredictionMatchesServerWithoutLoss) {
+    CellGrid grid = makeGrid(21);
+    LinkSimulation link(grid, SPAWN);
+    std::mt19937 rng(1);
+    link.walk(60 * 20, rng);
+    link.settle();
+    ASSERT_EQ(0, link.corrections);
+    ASSERT_TRUE(link.clientPos.x == link.serverPos.x && link.clientPos.y == link.serverPos.y);
+    // The walk really went places (and into walls)
+    ASSERT_TRUE(std::hypot(link.serverPos.x - SPAWN.x, link.serverPos.y - SPAWN.y) > 50.0f);
+    // Only the commands still in flight are kept
+    ASSERT_TRUE(link.predictor.pending() <= static_cast<size_t>(2 * (link.delayFrames + link.sendEvery)));
+}
+
+TEST(RedundancyCoversSingleLosses) {
+    CellGrid grid = makeGrid(22);
+    LinkSimulation link(grid, SPAWN);
+    link.delayFrames = 5;
+    link.dropInput = [](int index) { return index % 4 == 1; };
+    link.dropAck = [](int index) { return index % 3 == 2; };
+    std::mt19937 rng(2);
+    link.walk(60 * 20, rng);
+    link.settle();
+    ASSERT_EQ(0, link.corrections);
+    ASSERT_TRUE(link.clientPos.x == link.serverPos.x && link.clientPos.y == link.serverPos.y);
+}
+
+TEST(ReconcileConvergesAfterBurstLoss) {
+    CellGrid empty;
+    LinkSimulation link(empty, sf::Vector2f(1000.0f, 1000.0f));
+    // Four datagrams in a row lost: the fifth repeats only the newest eight of
+    // the fifteen commands since the last delivered one, seven never arrive
+    link.dropInput = [](int index) { return index >= 20 && index < 24; };
+    for (int f = 0; f < 120; ++f) link.step(INPUT_RIGHT);
+    link.settle();
+    const int lost = 5 * link.sendEvery - static_cast<int>(MAX_INPUT_COMMANDS);
+    ASSERT_TRUE(link.corrections > 0);
+    ASSERT_TRUE(link.maxCorrection <= lost * 3.0f + 0.01f);
+    ASSERT_TRUE(link.clientPos.x == link.serverPos.x && link.clientPos.y == link.serverPos.y);
+    // The server never moved the player for the lost commands
+    ASSERT_NEAR(1000.0f + (120 - lost) * 3.0f, link.serverPos.x, 0.01f);
+}
+
+TEST(ServerTeleportReachesClient) {
+    CellGrid empty;
+    LinkSimulation link(empty, sf::Vector2f(1000.0f, 1000.0f));
+    for (int f = 0; f < 60; ++f) link.step(INPUT_DOWN);
+    
+    // Respawn on the server while the client keeps walking
+    link.serverPos = sf::Vector2f(4000.0f, 4000.0f);
+    for (int f = 0; f < 30; ++f) link.step(INPUT_DOWN);
+    ASSERT_TRUE(link.corrections == 1);
+    ASSERT_TRUE(std::fabs(link.clientPos.x - 4000.0f) < 0.01f);
+    // Commands still in flight at the teleport are simulated after it
+    const int inFlight = link.delayFrames + link.sendEvery;
+    ASSERT_TRUE(link.clientPos.y > 4000.0f && link.clientPos.y < 4000.0f + (30 + inFlight) * 3.0f + 0.01f);
+    link.settle();
+    ASSERT_TRUE(link.clientPos.x == link.serverPos.x && link.clientPos.y == link.serverPos.y);
+}
+
+TEST(PredictorKeepsNewestWhenFull) {
+    CellGrid empty;
+    InputPredictor predictor;
+    sf::Vector2f pos(1000.0f, 1000.0f);
+    for (size_t i = 0; i < InputPredictor::CAPACITY + 10; ++i) {
+        pos = predictor.predict(pos, INPUT_RIGHT, 0, empty);
+    }
+    ASSERT_EQ(InputPredictor::CAPACITY, predictor.pending());
+    
+    InputCommand commands[MAX_INPUT_COMMANDS];
+    ASSERT_EQ(MAX_INPUT_COMMANDS, predictor.unacknowledged(commands, MAX_INPUT_COMMANDS));
+    ASSERT_TRUE(commands[MAX_INPUT_COMMANDS - 1].sequence == InputPredictor::CAPACITY + 9);
+    for (size_t i = 1; i < MAX_INPUT_COMMANDS; ++i) {
+        ASSERT_TRUE(commands[i].sequence == commands[i - 1].sequence + 1);
+    }
+    
+    // A stale ack is ignored once a newer one arrived
+    predictor.acknowledge(70, 2000.0f, 2000.0f);
+    predictor.acknowledge(60, 3000.0f, 3000.0f);
+    sf::Vector2f corrected;
+    ASSERT_TRUE(predictor.reconcile(corrected, empty));
+    ASSERT_NEAR(2000.0f + 3 * 3.0f, corrected.x, 0.01f);
+    ASSERT_EQ(3u, predictor.pending());
+    ASSERT_TRUE(!predictor.reconcile(corrected, empty));
+}
+
+// ========================
+// Benchmark
+// ========================
+
+template <typename F>
+double timeNs(int iterations, F&& body) {
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (int k = 0; k < iterations; k++) body(k);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::nano>(end - begin).count() / iterations;
+}
+
+void benchmarkPrediction() {
+    CellGrid grid = makeGrid(21);
+    std::mt19937 rng(3);
+    volatile float sink = 0.0f;
+    
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::setw(24) << "Unacked commands" << std::setw(18) << "Reconcile (ns)" << std::endl;
+    for (size_t pending : { 6, 12, 30 }) {
+        InputPredictor prepared;
+        sf::Vector2f pos = SPAWN;
+        for (size_t i = 0; i < InputPredictor::CAPACITY; ++i) {
+            pos = prepared.predict(pos, MOVE_BUTTONS[rng() % 9], 0, grid);
+        }
+        prepared.acknowledge(static_cast<uint32_t>(InputPredictor::CAPACITY - pending - 1), SPAWN.x, SPAWN.y);
+        
+        // A fresh copy per run (an applied ack is not applied again); the copy is timed separately
+        InputPredictor predictor;
+        double copyNs = timeNs(100000, [&](int) {
+            predictor = prepared;
+            sink = sink + static_cast<float>(predictor.pending());
+        });
+        double ns = timeNs(100000, [&](int) {
+            predictor = prepared;
+            sf::Vector2f corrected;
+            predictor.reconcile(corrected, grid);
+            sink = sink + corrected.x;
+        }) - copyNs;
+        std::cout << std::setw(24) << pending << std::setw(18) << ns << std::endl;
+    }
+    
+    // Upstream bytes per second at 20 datagrams per second (header + message header + payload)
+    const size_t overhead = WIRE_HEADER_BYTES + WIRE_MESSAGE_HEADER_BYTES;
+    const size_t positionBytes = overhead + 26;  // Previous PositionPacket message
+    const size_t inputBytes = overhead + MAX_INPUT_MESSAGE_BYTES;
+    const size_t ackBytes = WIRE_MESSAGE_HEADER_BYTES + INPUT_ACK_MESSAGE_BYTES;
+    std::cout << std::setw(24) << "Client -> server (B/s)" << std::setw(18) << positionBytes * 20
+              << " position, " << inputBytes * 20 << " input" << std::endl;
+    std::cout << std::setw(24) << "Server -> client (B/s)" << std::setw(18) << ackBytes * 20
+              << " input ack (added to snapshots)" << std::endl;
+}
+
+// ========================
+// Main Test Runner
+// ========================
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Zero Ground Input Prediction Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "--- Input Command Tests ---" << std::endl;
+    RUN_TEST(InputMessageRoundTrip);
+    RUN_TEST(InputAckRoundTrip);
+    RUN_TEST(AimQuantization);
+    RUN_TEST(QueueDropsRepeatedCommands);
+    RUN_TEST(QueueSimulatesAtInputRate);
+    RUN_TEST(ExtraCommandsGainNoSpeed);
+    RUN_TEST(PredictionMatchesServerWithoutLoss);
+    RUN_TEST(RedundancyCoversSingleLosses);
+    RUN_TEST(ReconcileConvergesAfterBurstLoss);
+    RUN_TEST(ServerTeleportReachesClient);
+    RUN_TEST(PredictorKeepsNewestWhenFull);
+
+    std::cout << std::endl;
+    std::cout << "--- Reconciliation Cost and Bandwidth ---" << std::endl;
+    benchmarkPrediction();
+
+    // Print summary
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Test Summary" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Total tests: " << totalTests << std::endl;
+    std::cout << "Passed: " << passedTests << std::endl;
+    std::cout << "Failed: " << failedTests << std::endl;
+    std::cout << std::endl;
+
+    if (failedTests == 0) {
+        std::cout << "✓ All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "✗ Some tests failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,430 @@
+// Lag Compensation Tests for Zero Ground
+// Tests the per-player position history ring buffer and the rewound bullet
+// hit test: a client shooting at where it saw a moving target (one snapshot
+// behind the server) must hit on the server as well.
+//
+// PositionHistory, computeRewindTicks and Bullet::sweptCircleHit are copied
+// from Zero_Ground.cpp; the tick loop mirrors updateServerSimulation().
+// Build with /O2 (or -O2).
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <array>
+#include <map>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+
+// ========================
+// Test Framework Macros
+// ========================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "Running test: " << #name << "..."; \
+    try { \
+        test_##name(); \
+        std::cout << " PASSED" << std::endl; \
+        passedTests++; \
+    } catch (const std::exception& e) { \
+        std::cout << " FAILED: " << e.what() << std::endl; \
+        failedTests++; \
+    } \
+    totalTests++; \
+} while(0)
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: " << #condition << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_NEAR(expected, actual, epsilon) do { \
+    if (std::abs((expected) - (actual)) > (epsilon)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << (expected) << " but got " << (actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(expected, actual) do { \
+    if ((expected) != (actual)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << static_cast<int>(expected) << " but got " << static_cast<int>(actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+// Test counters
+int totalTests = 0;
+int passedTests = 0;
+int failedTests = 0;
+
+// ========================
+// Structures (copied from main code)
+// ========================
+
+const float PLAYER_HIT_RADIUS = 15.0f;
+
+struct Player {
+    uint32_t id = 0;
+    float x = 0.0f;
+    float y = 0.0f;
+    float previousX = 0.0f;
+    float previousY = 0.0f;
+    bool isAlive = true;
+};
+
+// Where a player was during one simulation tick
+// prev -> current is exactly the motion the swept bullet test used on that tick
+struct PositionSample {
+    uint32_t tick = 0;
+    float prevX = 0.0f;
+    float prevY = 0.0f;
+    float x = 0.0f;
+    float y = 0.0f;
+    bool isAlive = false;
+};
+
+// Per-player ring buffer of the last HISTORY_SIZE tick samples
+//
+// A client sees other players as they were in the latest snapshot it received,
+// i.e. some ticks in the past. Its shots carry that snapshot's tick (ShotPacket::viewTick)
+// and the server tests the bullet against targets rewound by the same number of
+// ticks, so a shot that hit on the shooter's screen also hits on the server.
+//
+// ALGORITHM:
+// One sample is recorded per executed tick, so the slot for a tick is simply
+// tick % HISTORY_SIZE; at() checks the stored tick to reject overwritten or
+// never-recorded slots. Lookups are O(1) and the buffer never allocates.
+class PositionHistory {
+public:
+    static const uint32_t HISTORY_SIZE = 64;  // > LAG_COMPENSATION_MAX_REWIND at 240 Hz
+    
+    void record(uint32_t tick, const Player& player) {
+        PositionSample& sample = samples_[tick % HISTORY_SIZE];
+        sample.tick = tick;
+        sample.prevX = player.previousX;
+        sample.prevY = player.previousY;
+        sample.x = player.x;
+        sample.y = player.y;
+        sample.isAlive = player.isAlive;
+        recorded_ = true;
+    }
+    
+    // Sample recorded on the given tick, or nullptr if it is not in the buffer
+    const PositionSample* at(uint32_t tick) const {
+        const PositionSample& sample = samples_[tick % HISTORY_SIZE];
+        if (!recorded_ || sample.tick != tick) {
+            return nullptr;
+        }
+        return &sample;
+    }
+    
+private:
+    std::array<PositionSample, HISTORY_SIZE> samples_;
+    bool recorded_ = false;  // Tick 0 must not match default-constructed samples
+};
+
+// Convert a client's view tick into a rewind distance in ticks
+// A client that saw the last completed tick (currentTick - 1) needs no rewind: its
+// bullet's first step plays against the motion of the tick being simulated now.
+// Future or missing view ticks (e.g. before the first snapshot) also mean no rewind.
+uint16_t computeRewindTicks(uint32_t viewTick, uint32_t currentTick, uint32_t maxRewindTicks) {
+    if (viewTick == 0 || viewTick >= currentTick) {
+        return 0;
+    }
+    return static_cast<uint16_t>(std::min(currentTick - 1 - viewTick, maxRewindTicks));
+}
+
+struct Bullet {
+    // Continuous bullet-vs-player test over one simulation step.
+    // The bullet moves (bx0, by0) -> (bx1, by1) while the player's center moves
+    // (cx0, cy0) -> (cx1, cy1) over the same step. Returns true if the bullet comes
+    // within radius of the center, with toi the time of impact in [0, 1].
+    //
+    // ALGORITHM:
+    // Work in the player's frame: the relative position is d + t * m with
+    // d = bullet0 - center0 and m = bulletMotion - playerMotion. Solve
+    // |d + t * m|^2 = radius^2 for the smaller root; starting inside gives toi = 0.
+    //
+    // Unlike checkPlayerCollision (end position only) this cannot tunnel: a
+    // 900 px/s bullet moves 90 px per tick at 10 Hz, six times the 15 px radius.
+    static bool sweptCircleHit(float bx0, float by0, float bx1, float by1,
+                               float cx0, float cy0, float cx1, float cy1,
+                               float radius, float& toi) {
+        const float dx = bx0 - cx0;
+        const float dy = by0 - cy0;
+        const float c = dx * dx + dy * dy - radius * radius;
+        if (c <= 0.0f) {
+            toi = 0.0f;  // Already overlapping at the start of the step
+            return true;
+        }
+        
+        const float mx = (bx1 - bx0) - (cx1 - cx0);
+        const float my = (by1 - by0) - (cy1 - cy0);
+        const float a = mx * mx + my * my;
+        const float b = mx * dx + my * dy;  // Half of the usual b
+        if (a <= 0.0f || b >= 0.0f) return false;  // Not moving closer
+        
+        const float discriminant = b * b - a * c;
+        if (discriminant < 0.0f) return false;  // Closest approach stays outside
+        
+        const float t = (-b - std::sqrt(discriminant)) / a;
+        if (t > 1.0f) return false;  // Reaches the player after this step
+        
+        toi = t;
+        return true;
+    }
+};
+
+// ========================
+// Simulation (mirrors updateServerSimulation)
+// ========================
+
+struct SimBullet {
+    uint32_t ownerId = 0;
+    float x = 0.0f, y = 0.0f;
+    float prevX = 0.0f, prevY = 0.0f;
+    float vx = 0.0f, vy = 0.0f;
+    uint16_t rewindTicks = 0;
+    bool alive = true;
+};
+
+struct World {
+    uint32_t tick = 0;
+    std::map<uint32_t, Player> players;
+    std::map<uint32_t, float> velocityY;  // Targets run along y at constant speed
+    std::map<uint32_t, PositionHistory> histories;
+    std::vector<SimBullet> bullets;
+    std::map<uint32_t, int> hits;
+
+    // One server tick: move, record history, advance bullets and test hits
+    void step(float dt) {
+        for (auto& pair : players) {
+            Player& p = pair.second;
+            p.previousX = p.x;
+            p.previousY = p.y;
+            p.y += velocityY[pair.first] * dt;
+        }
+        for (auto& pair : players) {
+            histories[pair.first].record(tick, pair.second);
+        }
+
+        for (SimBullet& b : bullets) {
+            if (!b.alive) continue;
+            b.prevX = b.x;
+            b.prevY = b.y;
+            b.x += b.vx * dt;
+            b.y += b.vy * dt;
+
+            for (auto& pair : players) {
+                Player& player = pair.second;
+                if (player.id == b.ownerId || !player.isAlive) continue;
+
+                float px0 = player.previousX, py0 = player.previousY;
+                float px1 = player.x, py1 = player.y;
+                if (b.rewindTicks > 0 && b.rewindTicks <= tick) {
+                    const PositionSample* sample = histories[pair.first].at(tick - b.rewindTicks);
+                    if (sample) {
+                        if (!sample->isAlive) continue;
+                        px0 = sample->prevX;
+                        py0 = sample->prevY;
+                        px1 = sample->x;
+                        py1 = sample->y;
+                    }
+                }
+
+                float toi;
+                if (Bullet::sweptCircleHit(b.prevX, b.prevY, b.x, b.y, px0, py0, px1, py1, PLAYER_HIT_RADIUS, toi)) {
+                    hits[player.id]++;
+                    b.alive = false;
+                    break;
+                }
+            }
+        }
+        tick++;
+    }
+};
+
+Player makePlayer(uint32_t id, float x, float y) {
+    Player p;
+    p.id = id;
+    p.x = p.previousX = x;
+    p.y = p.previousY = y;
+    return p;
+}
+
+// Shooter at (1000, 1000) fires at a target running down the screen at 300 px/s.
+// The shooter's view is latencyTicks behind the server; it aims at where it saw the target.
+int runLaggedShot(int tickRate, uint32_t latencyTicks, bool compensate) {
+    const float dt = 1.0f / tickRate;
+    World world;
+    world.players[1] = makePlayer(1, 1000.0f, 1000.0f);
+    world.players[2] = makePlayer(2, 1600.0f, 800.0f);
+    world.velocityY[2] = 300.0f;
+
+    // Run long enough to have history to rewind into
+    for (int i = 0; i < tickRate / 2; ++i) world.step(dt);
+
+    // The server is about to simulate fireTick; the shooter saw latencyTicks before the last one
+    const uint32_t fireTick = world.tick;
+    const uint32_t viewTick = fireTick - 1 - latencyTicks;
+    const PositionSample* seen = world.histories[2].at(viewTick);
+    if (!seen) throw std::runtime_error("view tick not in history");
+
+    // Aim ahead of the target as the shooter would (it only knows the old position and velocity)
+    const float bulletSpeed = 2000.0f;
+    float dx = seen->x - 1000.0f;
+    float dy = seen->y - 1000.0f;
+    float lead = std::sqrt(dx * dx + dy * dy) / bulletSpeed;
+    dy += 300.0f * lead;
+    float len = std::sqrt(dx * dx + dy * dy);
+
+    SimBullet b;
+    b.ownerId = 1;
+    b.x = b.prevX = 1000.0f;
+    b.y = b.prevY = 1000.0f;
+    b.vx = dx / len * bulletSpeed;
+    b.vy = dy / len * bulletSpeed;
+    b.rewindTicks = compensate ? computeRewindTicks(viewTick, fireTick, PositionHistory::HISTORY_SIZE - 1) : 0;
+    world.bullets.push_back(b);
+
+    for (int i = 0; i < tickRate; ++i) world.step(dt);
+    return world.hits[2];
+}
+
+// ========================
+// Tests
+// ========================
+
+TEST(RecordAndLookup) {
+    PositionHistory history;
+    Player p = makePlayer(1, 0.0f, 0.0f);
+    for (uint32_t tick = 0; tick < 10; ++tick) {
+        p.previousX = p.x;
+        p.x = static_cast<float>(tick) * 10.0f;
+        history.record(tick, p);
+    }
+    const PositionSample* sample = history.at(5);
+    ASSERT_TRUE(sample != nullptr);
+    ASSERT_NEAR(50.0f, sample->x, 1e-6f);
+    ASSERT_NEAR(40.0f, sample->prevX, 1e-6f);
+    ASSERT_TRUE(history.at(10) == nullptr);
+    ASSERT_TRUE(history.at(9) != nullptr);
+}
+
+TEST(EmptyHistoryHasNoTickZero) {
+    PositionHistory history;
+    ASSERT_TRUE(history.at(0) == nullptr);
+    ASSERT_TRUE(history.at(PositionHistory::HISTORY_SIZE) == nullptr);
+}
+
+TEST(RingBufferOverwritesOldTicks) {
+    PositionHistory history;
+    Player p = makePlayer(1, 0.0f, 0.0f);
+    for (uint32_t tick = 0; tick <= 100; ++tick) {
+        p.x = static_cast<float>(tick);
+        history.record(tick, p);
+    }
+    const uint32_t oldest = 100 - PositionHistory::HISTORY_SIZE + 1;
+    ASSERT_TRUE(history.at(oldest - 1) == nullptr);
+    ASSERT_TRUE(history.at(oldest) != nullptr);
+    ASSERT_NEAR(static_cast<float>(oldest), history.at(oldest)->x, 1e-6f);
+    ASSERT_NEAR(100.0f, history.at(100)->x, 1e-6f);
+}
+
+TEST(RewindTicksAreClamped) {
+    ASSERT_TRUE(computeRewindTicks(0, 500, 15) == 0);     // No snapshot yet
+    ASSERT_TRUE(computeRewindTicks(600, 500, 15) == 0);   // View from the future
+    ASSERT_TRUE(computeRewindTicks(499, 500, 15) == 0);   // Saw the last completed tick
+    ASSERT_TRUE(computeRewindTicks(493, 500, 15) == 6);
+    ASSERT_TRUE(computeRewindTicks(100, 500, 15) == 15);  // Lagging client is clamped
+}
+
+// Without compensation a shot aimed at a 100 ms old view of a running target misses
+TEST(LaggedShotMissesWithoutRewind) {
+    ASSERT_TRUE(runLaggedShot(60, 6, false) == 0);
+}
+
+TEST(LaggedShotHitsWithRewind) {
+    for (int rate : { 20, 60, 128 }) {
+        for (uint32_t latencyTicks : { 1u, 3u, 6u, 12u }) {
+            // Keep within the 0.25 s window the server allows
+            if (latencyTicks > static_cast<uint32_t>(0.25f * rate)) continue;
+            ASSERT_TRUE(runLaggedShot(rate, latencyTicks, true) == 1);
+        }
+    }
+}
+
+TEST(NoRewindWhenClientIsCurrent) {
+    ASSERT_TRUE(runLaggedShot(60, 0, true) == 1);
+}
+
+// A target that was dead at the shooter's view tick cannot be hit by that shot
+TEST(DeadAtViewTickIsNotHit) {
+    const float dt = 1.0f / 60.0f;
+    World world;
+    world.players[1] = makePlayer(1, 1000.0f, 1000.0f);
+    world.players[2] = makePlayer(2, 1200.0f, 1000.0f);
+    world.players[2].isAlive = false;
+    for (int i = 0; i < 10; ++i) world.step(dt);
+    world.players[2].isAlive = true;  // Respawned in place
+    world.step(dt);
+
+    SimBullet b;
+    b.ownerId = 1;
+    b.x = b.prevX = 1000.0f;
+    b.y = b.prevY = 1000.0f;
+    b.vx = 2000.0f;
+    b.rewindTicks = 5;
+    world.bullets.push_back(b);
+    world.step(dt);
+    world.step(dt);
+    world.step(dt);
+    ASSERT_TRUE(world.hits[2] == 0);
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Zero Ground Lag Compensation Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "--- Position History Tests ---" << std::endl;
+    RUN_TEST(RecordAndLookup);
+    RUN_TEST(EmptyHistoryHasNoTickZero);
+    RUN_TEST(RingBufferOverwritesOldTicks);
+    RUN_TEST(RewindTicksAreClamped);
+
+    std::cout << std::endl;
+    std::cout << "--- Rewound Hit Tests ---" << std::endl;
+    RUN_TEST(LaggedShotMissesWithoutRewind);
+    RUN_TEST(LaggedShotHitsWithRewind);
+    RUN_TEST(NoRewindWhenClientIsCurrent);
+    RUN_TEST(DeadAtViewTickIsNotHit);
+
+    // Print summary
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Test Summary" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Total tests: " << totalTests << std::endl;
+    std::cout << "Passed: " << passedTests << std::endl;
+    std::cout << "Failed: " << failedTests << std::endl;
+    std::cout << std::endl;
+
+    if (failedTests == 0) {
+        std::cout << "✓ All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "✗ Some tests failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,1687 @@
+// Link Quality Tests and Benchmark for Zero Ground
+// Checks the per-connection latency and loss statistics: the link report in the
+// input message, sequence gap, reordering and duplicate counting, the RTT
+// estimator, RTT samples from snapshot acks minus the client's ack delay, the
+// downstream loss reports (16-bit wraparound, reordered reports) and the report
+// windows. Then plays a server and a client over simulated links and compares
+// the estimates with the real latency and loss.
+//
+// Code under test is copied from Zero_Ground_client.cpp (the wire code, which the
+// server shares) and Zero_Ground.cpp (LinkQuality). Build with /O2 (or -O2).
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <array>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+// ========================
+// Test Framework Macros
+// ========================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "Running test: " << #name << "..."; \
+    try { \
+        test_##name(); \
+        std::cout << " PASSED" << std::endl; \
+        passedTests++; \
+    } catch (const std::exception& e) { \
+        std::cout << " FAILED: " << e.what() << std::endl; \
+        failedTests++; \
+    } \
+    totalTests++; \
+} while(0)
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: " << #condition << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_NEAR(expected, actual, epsilon) do { \
+    if (std::abs((expected) - (actual)) > (epsilon)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << (expected) << " but got " << (actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(expected, actual) do { \
+    if ((expected) != (actual)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << static_cast<int>(expected) << " but got " << static_cast<int>(actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+// Test counters
+int totalTests = 0;
+int passedTests = 0;
+int failedTests = 0;
+
+
+// ========================
+// Code Under Test (copied from Zero_Ground_client.cpp and Zero_Ground.cpp)
+// ========================
+
+enum class AmmoType : uint8_t {
+    AMMO_9x18 = 0,    // Pistol ammo
+    AMMO_5_45x39 = 1, // Rifle ammo
+    AMMO_7_62x54 = 2  // Sniper ammo
+};
+
+// Requirement 4.1-4.5: Purchase validation and transaction
+struct PurchasePacket {
+    uint8_t playerId;
+    uint8_t weaponType;        // Weapon::Type enum value, 255 = buying ammo
+    uint8_t ammoType = 255;    // AmmoType enum value, 255 = buying a weapon
+};
+
+// Inventory update packet (server → buyer)
+// Sent in answer to every purchase to confirm or undo it and synchronize the balance
+struct InventoryPacket {
+    uint8_t playerId;
+    uint8_t slot;        // Which slot changed (0-3), 255 = none
+    uint8_t weaponType;  // Weapon::Type enum value, 255 = empty slot
+    bool accepted;       // False if the server refused the purchase
+    int newMoneyBalance;
+};
+
+// Requirement 7.6: Shot packet (client → server → all clients)
+// Sent when player fires weapon
+struct ShotPacket {
+    uint8_t playerId;
+    float x, y;          // Shot origin position
+    float dirX, dirY;    // Normalized direction vector
+    uint8_t weaponType;  // Weapon::Type enum value
+    float bulletSpeed;   // Bullet speed for this weapon
+    float damage;        // Damage for this weapon
+    float range;         // Range for this weapon
+    uint32_t viewTick;   // Tick of the latest server snapshot the shooter had (lag compensation)
+};
+
+// Requirement 10.4: Hit packet (server → all clients)
+// Sent when bullet hits a player
+struct HitPacket {
+    uint8_t shooterId;   // Player who fired the bullet
+    uint8_t victimId;    // Player who was hit
+    float damage;        // Damage dealt
+    float hitX, hitY;    // Position where hit occurred
+    bool wasKill;        // True if this hit killed the victim
+};
+
+const size_t MAX_SNAPSHOT_BYTES = 1192;         // Leaves room for the wire headers in one datagram
+const uint32_t NO_SNAPSHOT_ACK = 0xFFFFFFFF;    // Input message ackTick before the first snapshot
+
+const uint8_t WIRE_VERSION = 5;                 // Version 4 input messages had no link report
+const size_t WIRE_HEADER_BYTES = 5;
+const size_t WIRE_MESSAGE_HEADER_BYTES = 3;
+const size_t MAX_DATAGRAM_BYTES = 1200;         // Stays below a typical 1500 byte MTU
+static_assert(MAX_SNAPSHOT_BYTES + WIRE_HEADER_BYTES + WIRE_MESSAGE_HEADER_BYTES <= MAX_DATAGRAM_BYTES,
+              "A full snapshot must fit in one datagram");
+
+enum class WireMessageType : uint8_t {
+    Input = 1,     // Client -> server: sequenced InputCommands and snapshot ack
+    Shot = 2,      // Both directions: ShotPacket
+    Hit = 3,          // Server -> client, reliable only: HitPacket
+    Snapshot = 4,     // Server -> client: writeSnapshot() payload
+    InputAck = 5,     // Server -> client: last simulated input and resulting position
+    Purchase = 6,     // Client -> server, reliable only: PurchasePacket
+    Inventory = 7,    // Server -> client, reliable only: InventoryPacket
+    Reliable = 8,     // Both directions: one of the above, sequenced (see ReliableChannel)
+    ReliableAck = 9   // Both directions: which Reliable messages arrived
+};
+const size_t WIRE_MESSAGE_TYPE_COUNT = 10;      // Type 0 is never valid
+
+// Little-endian field access; payloads are unaligned, so go through bytes
+inline void storeU16(uint8_t* p, uint16_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+}
+
+inline void storeU32(uint8_t* p, uint32_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+    p[2] = static_cast<uint8_t>(value >> 16);
+    p[3] = static_cast<uint8_t>(value >> 24);
+}
+
+inline void storeF32(uint8_t* p, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    storeU32(p, bits);
+}
+
+inline uint16_t loadU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t loadU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline float loadF32(const uint8_t* p) {
+    uint32_t bits = loadU32(p);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// ------------------------
+// Input Message
+// ------------------------
+// playerId:8, ackTick:32, ackDelay:16, lostDatagrams:16, firstSequence:32, count:8,
+// then count * (buttons:8, aim:16) with sequences firstSequence, firstSequence + 1, ...
+//
+// The client samples its controls INPUT_RATE times per second into sequenced
+// commands and sends the newest MAX_INPUT_COMMANDS with every datagram, so a lost
+// datagram is covered by the next one. The server simulates the movement itself
+// (see InputQueue) and never takes a position from the client.
+// ackDelay (ms the client held the ackTick snapshot before this send) and
+// lostDatagrams (running count of missing server sequence numbers, mod 65536)
+// are the client's link report: the server derives RTT and downstream loss from them.
+
+const float INPUT_RATE = 60.0f;                  // Commands per second (movement speeds are per 1/60 s)
+const float INPUT_STEP = 1.0f / INPUT_RATE;      // Simulated time per command
+const size_t MAX_INPUT_COMMANDS = 8;             // Newest commands repeated in every datagram
+const size_t INPUT_MESSAGE_HEADER_BYTES = 14;
+const size_t INPUT_COMMAND_BYTES = 3;
+const size_t MAX_INPUT_MESSAGE_BYTES = INPUT_MESSAGE_HEADER_BYTES + MAX_INPUT_COMMANDS * INPUT_COMMAND_BYTES;
+
+// Low nibble of InputCommand::buttons; the high nibble is the active weapon
+// (Weapon::Type + 1, 0 = no weapon), which decides the movement speed
+const uint16_t NO_ACK_DELAY = 0xFFFF;            // ackDelay before the first snapshot
+
+const uint8_t INPUT_UP = 0x01;
+const uint8_t INPUT_DOWN = 0x02;
+const uint8_t INPUT_LEFT = 0x04;
+const uint8_t INPUT_RIGHT = 0x08;
+
+// One sampled frame of client controls
+struct InputCommand {
+    uint32_t sequence = 0;  // Client input tick, +1 per command
+    uint8_t buttons = 0;    // INPUT_* bits | weapon code << 4
+    uint16_t aim = 0;       // Rotation, 1/65536 of a turn
+};
+
+// Client's view of the server -> client link, sent with every input message
+struct InputLinkReport {
+    uint16_t ackDelay = NO_ACK_DELAY;  // ms, see above
+    uint16_t lostDatagrams = 0;
+};
+
+inline uint8_t inputWeaponCode(uint8_t buttons) {
+    return static_cast<uint8_t>(buttons >> 4);
+}
+
+inline uint16_t quantizeAim(float degrees) {
+    float turns = degrees / 360.0f;
+    turns -= std::floor(turns);
+    return static_cast<uint16_t>(static_cast<uint32_t>(std::lround(turns * 65536.0f)) & 0xFFFF);
+}
+
+inline float dequantizeAim(uint16_t aim) {
+    return aim * (360.0f / 65536.0f);
+}
+
+// Write the input payload; count must be 1..MAX_INPUT_COMMANDS with consecutive sequences
+// Returns: payload length in bytes
+size_t writeInputMessage(uint8_t* out, uint8_t playerId, uint32_t ackTick, const InputLinkReport& link,
+                         const InputCommand* commands, size_t count) {
+    out[0] = playerId;
+    storeU32(out + 1, ackTick);
+    storeU16(out + 5, link.ackDelay);
+    storeU16(out + 7, link.lostDatagrams);
+    storeU32(out + 9, commands[0].sequence);
+    out[13] = static_cast<uint8_t>(count);
+    uint8_t* p = out + INPUT_MESSAGE_HEADER_BYTES;
+    for (size_t i = 0; i < count; ++i, p += INPUT_COMMAND_BYTES) {
+        p[0] = commands[i].buttons;
+        storeU16(p + 1, commands[i].aim);
+    }
+    return INPUT_MESSAGE_HEADER_BYTES + count * INPUT_COMMAND_BYTES;
+}
+
+// Reads a validated input payload in place (no copy)
+class InputMessageView {
+public:
+    InputMessageView(const uint8_t* payload, size_t length) : p_(payload), length_(length) {}
+    
+    uint8_t playerId() const { return p_[0]; }
+    uint32_t ackTick() const { return loadU32(p_ + 1); }
+    uint16_t ackDelay() const { return loadU16(p_ + 5); }
+    uint16_t lostDatagrams() const { return loadU16(p_ + 7); }
+    uint32_t firstSequence() const { return loadU32(p_ + 9); }
+    
+    // Commands actually present (the count field is checked against the length)
+    size_t count() const {
+        return std::min<size_t>(p_[13], (length_ - INPUT_MESSAGE_HEADER_BYTES) / INPUT_COMMAND_BYTES);
+    }
+    
+    InputCommand command(size_t index) const {
+        const uint8_t* p = p_ + INPUT_MESSAGE_HEADER_BYTES + index * INPUT_COMMAND_BYTES;
+        InputCommand command;
+        command.sequence = firstSequence() + static_cast<uint32_t>(index);
+        command.buttons = p[0];
+        command.aim = loadU16(p + 1);
+        return command;
+    }
+    
+private:
+    const uint8_t* p_;
+    size_t length_;
+};
+
+// ------------------------
+// Shot Message
+// ------------------------
+// playerId:8, x:f32, y:f32, dirX:f32, dirY:f32, weaponType:8,
+// bulletSpeed:f32, damage:f32, range:f32, viewTick:32
+
+const size_t SHOT_MESSAGE_BYTES = 34;
+
+void writeShotMessage(uint8_t* out, const ShotPacket& packet) {
+    out[0] = packet.playerId;
+    storeF32(out + 1, packet.x);
+    storeF32(out + 5, packet.y);
+    storeF32(out + 9, packet.dirX);
+    storeF32(out + 13, packet.dirY);
+    out[17] = packet.weaponType;
+    storeF32(out + 18, packet.bulletSpeed);
+    storeF32(out + 22, packet.damage);
+    storeF32(out + 26, packet.range);
+    storeU32(out + 30, packet.viewTick);
+}
+
+// Reads a validated shot payload in place (no copy)
+class ShotMessageView {
+public:
+    explicit ShotMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint8_t playerId() const { return p_[0]; }
+    float x() const { return loadF32(p_ + 1); }
+    float y() const { return loadF32(p_ + 5); }
+    float dirX() const { return loadF32(p_ + 9); }
+    float dirY() const { return loadF32(p_ + 13); }
+    uint8_t weaponType() const { return p_[17]; }
+    float bulletSpeed() const { return loadF32(p_ + 18); }
+    float damage() const { return loadF32(p_ + 22); }
+    float range() const { return loadF32(p_ + 26); }
+    uint32_t viewTick() const { return loadU32(p_ + 30); }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Hit Message
+// ------------------------
+// shooterId:8, victimId:8, damage:f32, hitX:f32, hitY:f32, wasKill:8
+
+const size_t HIT_MESSAGE_BYTES = 15;
+
+void writeHitMessage(uint8_t* out, const HitPacket& packet) {
+    out[0] = packet.shooterId;
+    out[1] = packet.victimId;
+    storeF32(out + 2, packet.damage);
+    storeF32(out + 6, packet.hitX);
+    storeF32(out + 10, packet.hitY);
+    out[14] = packet.wasKill ? 1 : 0;
+}
+
+// Reads a validated hit payload in place (no copy)
+class HitMessageView {
+public:
+    explicit HitMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint8_t shooterId() const { return p_[0]; }
+    uint8_t victimId() const { return p_[1]; }
+    float damage() const { return loadF32(p_ + 2); }
+    float hitX() const { return loadF32(p_ + 6); }
+    float hitY() const { return loadF32(p_ + 10); }
+    bool wasKill() const { return p_[14] != 0; }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Input Ack Message
+// ------------------------
+// sequence:32, x:f32, y:f32
+//
+// Sent to each client with its snapshot: the last input command the server
+// simulated for that client and the exact position it ended at. The client
+// rewinds its prediction to it and replays the newer commands (see InputPredictor).
+
+const size_t INPUT_ACK_MESSAGE_BYTES = 12;
+
+void writeInputAckMessage(uint8_t* out, uint32_t sequence, float x, float y) {
+    storeU32(out, sequence);
+    storeF32(out + 4, x);
+    storeF32(out + 8, y);
+}
+
+// Reads a validated input ack payload in place (no copy)
+class InputAckMessageView {
+public:
+    explicit InputAckMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint32_t sequence() const { return loadU32(p_); }
+    float x() const { return loadF32(p_ + 4); }
+    float y() const { return loadF32(p_ + 8); }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Purchase Message
+// ------------------------
+// playerId:8, weaponType:8, ammoType:8
+//
+// One shop purchase (client -> server, reliable). Exactly one of weaponType and
+// ammoType names an item; the other is PURCHASE_NONE.
+
+const size_t PURCHASE_MESSAGE_BYTES = 3;
+const uint8_t PURCHASE_NONE = 255;
+
+void writePurchaseMessage(uint8_t* out, const PurchasePacket& packet) {
+    out[0] = packet.playerId;
+    out[1] = packet.weaponType;
+    out[2] = packet.ammoType;
+}
+
+// Reads a validated purchase payload in place (no copy)
+class PurchaseMessageView {
+public:
+    explicit PurchaseMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint8_t playerId() const { return p_[0]; }
+    uint8_t weaponType() const { return p_[1]; }
+    uint8_t ammoType() const { return p_[2]; }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Inventory Message
+// ------------------------
+// playerId:8, slot:8, weaponType:8, accepted:8, newMoneyBalance:32
+//
+// The server's answer to one purchase (server -> buyer, reliable, same order as
+// the purchases). slot and weaponType are PURCHASE_NONE unless a weapon was added.
+
+const size_t INVENTORY_MESSAGE_BYTES = 8;
+
+void writeInventoryMessage(uint8_t* out, const InventoryPacket& packet) {
+    out[0] = packet.playerId;
+    out[1] = packet.slot;
+    out[2] = packet.weaponType;
+    out[3] = packet.accepted ? 1 : 0;
+    storeU32(out + 4, static_cast<uint32_t>(packet.newMoneyBalance));
+}
+
+// Reads a validated inventory payload in place (no copy)
+class InventoryMessageView {
+public:
+    explicit InventoryMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint8_t playerId() const { return p_[0]; }
+    uint8_t slot() const { return p_[1]; }
+    uint8_t weaponType() const { return p_[2]; }
+    bool accepted() const { return p_[3] != 0; }
+    int newMoneyBalance() const { return static_cast<int32_t>(loadU32(p_ + 4)); }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Reliable Message
+// ------------------------
+// id:16, type:8, then the payload of the wrapped message
+//
+// Purchases, inventory updates and hits must arrive exactly once and in order.
+// Instead of a second (TCP) connection, which would stall behind every lost
+// segment, they are wrapped in Reliable messages and ride on the same datagrams
+// as snapshots and inputs; ReliableChannel numbers, acknowledges, resends and
+// reorders them, and nothing unreliable ever waits for them.
+
+const size_t RELIABLE_MESSAGE_HEADER_BYTES = 3;
+const size_t MAX_RELIABLE_BODY_BYTES = 32;
+
+void writeReliableMessage(uint8_t* out, uint16_t id, uint8_t type, const uint8_t* body, size_t length) {
+    storeU16(out, id);
+    out[2] = type;
+    std::memcpy(out + RELIABLE_MESSAGE_HEADER_BYTES, body, length);
+}
+
+// Reads a validated reliable payload in place (no copy)
+class ReliableMessageView {
+public:
+    ReliableMessageView(const uint8_t* payload, size_t length) : p_(payload), length_(length) {}
+    
+    uint16_t id() const { return loadU16(p_); }
+    uint8_t type() const { return p_[2]; }
+    const uint8_t* body() const { return p_ + RELIABLE_MESSAGE_HEADER_BYTES; }
+    size_t bodyLength() const { return length_ - RELIABLE_MESSAGE_HEADER_BYTES; }
+    
+private:
+    const uint8_t* p_;
+    size_t length_;
+};
+
+// ------------------------
+// Reliable Ack Message
+// ------------------------
+// nextExpected:16, received:32
+//
+// nextExpected is the first reliable id not received yet (all older ones arrived);
+// bit i of received is set when id nextExpected + 1 + i is already buffered.
+
+const size_t RELIABLE_ACK_MESSAGE_BYTES = 6;
+
+void writeReliableAckMessage(uint8_t* out, uint16_t nextExpected, uint32_t received) {
+    storeU16(out, nextExpected);
+    storeU32(out + 2, received);
+}
+
+// Reads a validated reliable ack payload in place (no copy)
+class ReliableAckMessageView {
+public:
+    explicit ReliableAckMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint16_t nextExpected() const { return loadU16(p_); }
+    uint32_t received() const { return loadU32(p_ + 2); }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Decoding
+// ------------------------
+
+// Allowed payload length per message type, indexed by WireMessageType
+struct WireMessageSpec {
+    const char* name;
+    size_t minLength;
+    size_t maxLength;
+};
+
+const WireMessageSpec WIRE_MESSAGE_SPECS[WIRE_MESSAGE_TYPE_COUNT] = {
+    { "invalid", 1, 0 },  // Empty range: never accepted
+    { "input", INPUT_MESSAGE_HEADER_BYTES + INPUT_COMMAND_BYTES, MAX_INPUT_MESSAGE_BYTES },
+    { "shot", SHOT_MESSAGE_BYTES, SHOT_MESSAGE_BYTES },
+    { "hit", HIT_MESSAGE_BYTES, HIT_MESSAGE_BYTES },
+    { "snapshot", 1, MAX_SNAPSHOT_BYTES },
+    { "input ack", INPUT_ACK_MESSAGE_BYTES, INPUT_ACK_MESSAGE_BYTES },
+    { "purchase", PURCHASE_MESSAGE_BYTES, PURCHASE_MESSAGE_BYTES },
+    { "inventory", INVENTORY_MESSAGE_BYTES, INVENTORY_MESSAGE_BYTES },
+    { "reliable", RELIABLE_MESSAGE_HEADER_BYTES, RELIABLE_MESSAGE_HEADER_BYTES + MAX_RELIABLE_BODY_BYTES },
+    { "reliable ack", RELIABLE_ACK_MESSAGE_BYTES, RELIABLE_ACK_MESSAGE_BYTES }
+};
+
+enum class WireStatus {
+    Ok,
+    Truncated,    // Header or message runs past the end of the datagram
+    BadVersion,   // Sender speaks another protocol version
+    UnknownType,  // Type not in the table or not accepted by this receiver
+    BadLength     // Payload length outside the type's allowed range
+};
+
+// Message handler: payload points into the receive buffer and has been bounds-checked
+template <typename Context>
+using WireHandler = void (*)(const uint8_t* payload, size_t length, Context& context);
+
+// Read the datagram header
+// Returns: Ok and the sequence, or why the datagram was rejected
+inline WireStatus readWireHeader(const uint8_t* data, size_t size, uint32_t& sequence) {
+    if (size < WIRE_HEADER_BYTES) {
+        return WireStatus::Truncated;
+    }
+    if (data[0] != WIRE_VERSION) {
+        return WireStatus::BadVersion;
+    }
+    sequence = loadU32(data + 1);
+    return WireStatus::Ok;
+}
+
+// Validate a whole datagram in place, then dispatch each message to handlers[type]
+// Parameters:
+//   data, size - The received datagram (never copied)
+//   handlers - Handler per WireMessageType; null rejects that type
+//   context - Passed through to the handlers
+//   sequence - Receives the datagram sequence number
+// Returns: Ok if every message was dispatched; otherwise nothing was dispatched
+//
+// PERFORMANCE:
+// Type lookup is an array index and each message is checked once against the
+// spec table, so decoding is O(1) per message with no allocation. Validating
+// the whole datagram before dispatching means a malformed tail can't leave a
+// half-applied datagram behind.
+template <typename Context>
+WireStatus decodeDatagram(const uint8_t* data, size_t size, const WireHandler<Context>* handlers,
+                          Context& context, uint32_t& sequence) {
+    WireStatus status = readWireHeader(data, size, sequence);
+    if (status != WireStatus::Ok) {
+        return status;
+    }
+    
+    // Pass 1: bounds and type checks
+    size_t pos = WIRE_HEADER_BYTES;
+    while (pos < size) {
+        if (size - pos < WIRE_MESSAGE_HEADER_BYTES) {
+            return WireStatus::Truncated;
+        }
+        uint8_t type = data[pos];
+        size_t length = loadU16(data + pos + 1);
+        if (type >= WIRE_MESSAGE_TYPE_COUNT || handlers[type] == nullptr) {
+            return WireStatus::UnknownType;
+        }
+        if (length < WIRE_MESSAGE_SPECS[type].minLength || length > WIRE_MESSAGE_SPECS[type].maxLength) {
+            return WireStatus::BadLength;
+        }
+        pos += WIRE_MESSAGE_HEADER_BYTES;
+        if (size - pos < length) {
+            return WireStatus::Truncated;
+        }
+        pos += length;
+    }
+    
+    // Pass 2: dispatch
+    pos = WIRE_HEADER_BYTES;
+    while (pos < size) {
+        uint8_t type = data[pos];
+        size_t length = loadU16(data + pos + 1);
+        pos += WIRE_MESSAGE_HEADER_BYTES;
+        handlers[type](data + pos, length, context);
+        pos += length;
+    }
+    return WireStatus::Ok;
+}
+
+// Validate and dispatch one message that did not come straight from decodeDatagram
+// (the payload of a Reliable message, delivered once it is in order)
+// Returns: Ok if the handler was called
+template <typename Context>
+WireStatus dispatchWireMessage(uint8_t type, const uint8_t* payload, size_t length,
+                               const WireHandler<Context>* handlers, Context& context) {
+    if (type >= WIRE_MESSAGE_TYPE_COUNT || handlers[type] == nullptr) {
+        return WireStatus::UnknownType;
+    }
+    if (length < WIRE_MESSAGE_SPECS[type].minLength || length > WIRE_MESSAGE_SPECS[type].maxLength) {
+        return WireStatus::BadLength;
+    }
+    handlers[type](payload, length, context);
+    return WireStatus::Ok;
+}
+
+inline const char* wireStatusName(WireStatus status) {
+    switch (status) {
+        case WireStatus::Ok: return "ok";
+        case WireStatus::Truncated: return "truncated";
+        case WireStatus::BadVersion: return "wrong protocol version";
+        case WireStatus::UnknownType: return "unexpected message type";
+        case WireStatus::BadLength: return "bad message length";
+    }
+    return "unknown";
+}
+
+// ------------------------
+// Encoding
+// ------------------------
+
+// Builds the datagrams for one recipient
+// Completed datagrams are handed to the sink (data, size, message count);
+// call flush() once all messages have been appended.
+class DatagramBuilder {
+public:
+    using Sink = std::function<void(const uint8_t*, size_t, size_t)>;
+    
+    // firstSequence - Sequence number of the first datagram this builder sends
+    DatagramBuilder(Sink sink, uint32_t firstSequence)
+        : sink_(std::move(sink)), nextSequence_(firstSequence) {
+        buffer_[0] = WIRE_VERSION;
+    }
+    
+    // Reserve room for one message, flushing the current datagram first if it would not fit
+    // Returns: where to write the payload (exactly length bytes), or null if the
+    // message is too large for any datagram
+    uint8_t* reserve(WireMessageType type, size_t length) {
+        const size_t needed = WIRE_MESSAGE_HEADER_BYTES + length;
+        if (WIRE_HEADER_BYTES + needed > MAX_DATAGRAM_BYTES) {
+            return nullptr;
+        }
+        if (used_ + needed > MAX_DATAGRAM_BYTES) {
+            flush();
+        }
+        
+        buffer_[used_] = static_cast<uint8_t>(type);
+        storeU16(buffer_ + used_ + 1, static_cast<uint16_t>(length));
+        uint8_t* payload = buffer_ + used_ + WIRE_MESSAGE_HEADER_BYTES;
+        used_ += needed;
+        messageCount_++;
+        return payload;
+    }
+    
+    // Append a pre-encoded payload (e.g. a snapshot)
+    bool append(WireMessageType type, const uint8_t* payload, size_t length) {
+        uint8_t* out = reserve(type, length);
+        if (out == nullptr) {
+            return false;
+        }
+        std::memcpy(out, payload, length);
+        return true;
+    }
+    
+    // commands - Consecutive commands, oldest first (at most MAX_INPUT_COMMANDS are sent: the newest)
+    bool appendInput(uint8_t playerId, uint32_t ackTick, const InputLinkReport& link,
+                     const InputCommand* commands, size_t count) {
+        if (count == 0) {
+            return false;
+        }
+        if (count > MAX_INPUT_COMMANDS) {
+            commands += count - MAX_INPUT_COMMANDS;
+            count = MAX_INPUT_COMMANDS;
+        }
+        uint8_t* out = reserve(WireMessageType::Input, INPUT_MESSAGE_HEADER_BYTES + count * INPUT_COMMAND_BYTES);
+        if (out) writeInputMessage(out, playerId, ackTick, link, commands, count);
+        return out != nullptr;
+    }
+    
+    bool appendShot(const ShotPacket& packet) {
+        uint8_t* out = reserve(WireMessageType::Shot, SHOT_MESSAGE_BYTES);
+        if (out) writeShotMessage(out, packet);
+        return out != nullptr;
+    }
+    
+    bool appendHit(const HitPacket& packet) {
+        uint8_t* out = reserve(WireMessageType::Hit, HIT_MESSAGE_BYTES);
+        if (out) writeHitMessage(out, packet);
+        return out != nullptr;
+    }
+    
+    bool appendInputAck(uint32_t sequence, float x, float y) {
+        uint8_t* out = reserve(WireMessageType::InputAck, INPUT_ACK_MESSAGE_BYTES);
+        if (out) writeInputAckMessage(out, sequence, x, y);
+        return out != nullptr;
+    }
+    
+    // Hand the pending datagram to the sink (no-op when nothing is pending)
+    void flush() {
+        if (messageCount_ == 0) {
+            return;
+        }
+        storeU32(buffer_ + 1, nextSequence_++);
+        sink_(buffer_, used_, messageCount_);
+        datagramsSent_++;
+        used_ = WIRE_HEADER_BYTES;
+        messageCount_ = 0;
+    }
+    
+    size_t datagramsSent() const { return datagramsSent_; }
+    
+    // Sequence number the next datagram will carry
+    uint32_t nextSequence() const { return nextSequence_; }
+    
+private:
+    Sink sink_;
+    uint8_t buffer_[MAX_DATAGRAM_BYTES];
+    size_t used_ = WIRE_HEADER_BYTES;
+    size_t messageCount_ = 0;
+    size_t datagramsSent_ = 0;
+    uint32_t nextSequence_;
+};
+
+// ------------------------
+// Link Statistics
+// ------------------------
+
+// Smoothed round-trip time and its mean deviation (RFC 6298)
+// The deviation is the RTT jitter: how far single samples stray from the mean
+class RttEstimator {
+public:
+    void sample(float rtt) {
+        if (!hasSample_) {
+            smoothed_ = rtt;
+            variance_ = rtt * 0.5f;
+            hasSample_ = true;
+            return;
+        }
+        variance_ = 0.75f * variance_ + 0.25f * std::fabs(smoothed_ - rtt);
+        smoothed_ = 0.875f * smoothed_ + 0.125f * rtt;
+    }
+    
+    bool hasSample() const { return hasSample_; }
+    float smoothed() const { return smoothed_; }
+    float variance() const { return variance_; }
+    
+private:
+    bool hasSample_ = false;
+    float smoothed_ = 0.0f;
+    float variance_ = 0.0f;
+};
+
+// Loss and reordering of one incoming datagram stream, from its wire sequence numbers
+//
+// ALGORITHM:
+// A jump past the newest sequence counts the skipped ones as lost; a bit mask of
+// the last 64 sequences remembers which arrived, so a late datagram inside that
+// window is taken back from the loss count (out of order) and a repeated one is
+// a duplicate. Datagrams older than the window stay counted as lost - for a
+// real-time stream they are. Sequences before the first one received were never
+// counted as lost, so a late one only arrives out of order.
+class SequenceTracker {
+public:
+    // Take the sequence of one received datagram
+    // Returns: true if it is the newest so far
+    bool onDatagram(uint32_t sequence) {
+        if (!started_) {
+            started_ = true;
+            first_ = sequence;
+            newest_ = sequence;
+            seen_ = 1;
+            received_++;
+            return true;
+        }
+        if (sequence > newest_) {
+            const uint32_t skipped = sequence - newest_ - 1;
+            lost_ += skipped;
+            seen_ = (skipped >= 63) ? 1 : (seen_ << (skipped + 1)) | 1;
+            newest_ = sequence;
+            received_++;
+            return true;
+        }
+        
+        const uint32_t age = newest_ - sequence;
+        if (age < 64 && ((seen_ >> age) & 1)) {
+            duplicates_++;
+            return false;
+        }
+        if (age < 64) {
+            seen_ |= uint64_t(1) << age;
+            if (sequence > first_) {
+                lost_--;
+            }
+        }
+        outOfOrder_++;
+        received_++;
+        return false;
+    }
+    
+    uint64_t received() const { return received_; }      // Distinct datagrams
+    uint64_t lost() const { return lost_; }              // Missing sequence numbers
+    uint64_t outOfOrder() const { return outOfOrder_; }  // Arrived after a newer one
+    uint64_t duplicates() const { return duplicates_; }
+    
+private:
+    bool started_ = false;
+    uint32_t first_ = 0;   // Gaps are only counted after this one
+    uint32_t newest_ = 0;
+    uint64_t seen_ = 0;  // Bit i: newest_ - i arrived
+    uint64_t received_ = 0;
+    uint64_t lost_ = 0;
+    uint64_t outOfOrder_ = 0;
+    uint64_t duplicates_ = 0;
+};
+
+// ------------------------
+// Reliable Channel
+// ------------------------
+
+// Reliable, ordered message stream to one peer, carried on the unreliable datagrams
+//
+// ALGORITHM:
+// Sending: every message gets the next 16-bit id and stays queued until the peer
+// acknowledges it. write() appends the pending ack plus every message that was
+// never sent or whose resend timeout expired. Only WINDOW ids past the oldest
+// unacknowledged one are in flight, so everything the peer can have buffered
+// fits in the 32-bit ack mask. The timeout is smoothed RTT + 4 x RTT variance
+// (RFC 6298), sampled only from messages acknowledged after their first send
+// (Karn). A message that needs a second resend doubles it until the next
+// sample, so a sudden RTT rise can't cause endless spurious resends, while
+// single losses on a link that keeps answering are resent one timeout apart.
+// Receiving: messages ahead of the next expected id wait in WINDOW slots until
+// the gap is filled, then deliver() releases them in id order. Duplicates are
+// dropped but re-arm the ack, so a lost ack is repeated by the next datagram.
+//
+// PERFORMANCE:
+// Fixed rings indexed by id (both sizes divide 65536, so wraparound is free), no
+// allocation. The ack costs 9 bytes and only goes out after something arrived;
+// a lost message delays only the reliable messages behind it, never snapshots
+// or inputs.
+class ReliableChannel {
+public:
+    static const uint16_t WINDOW = 32;              // Ids in flight / buffered ahead of the gap
+    static const uint16_t QUEUE_CAPACITY = 128;     // Queued outgoing messages (in flight + waiting)
+    static constexpr float INITIAL_TIMEOUT = 0.2f;  // Resend timeout before the first RTT sample
+    static constexpr float MIN_TIMEOUT = 0.05f;     // Below this the peer's ack delay causes spurious resends
+    static constexpr float MAX_TIMEOUT = 1.0f;      // Cap for the backed-off timeout
+    static const int MAX_BACKOFF = 5;               // Doublings without an RTT sample
+    
+    // Queue a message for reliable delivery
+    // Returns: false if the body is too large or the queue is full (peer not acknowledging)
+    bool send(WireMessageType type, const uint8_t* body, size_t length) {
+        if (length > MAX_RELIABLE_BODY_BYTES || queued() == QUEUE_CAPACITY) {
+            return false;
+        }
+        Outgoing& message = outgoing_[nextSendId_ % QUEUE_CAPACITY];
+        message.type = static_cast<uint8_t>(type);
+        message.length = static_cast<uint8_t>(length);
+        std::memcpy(message.body, body, length);
+        message.sends = 0;
+        message.acked = false;
+        nextSendId_++;
+        return true;
+    }
+    
+    // Returns: true if write() would append anything at this time
+    bool wantsToSend(float now) const {
+        if (ackPending_) {
+            return true;
+        }
+        const uint16_t end = inFlightEnd();
+        for (uint16_t id = oldestUnacked_; id != end; ++id) {
+            const Outgoing& message = outgoing_[id % QUEUE_CAPACITY];
+            if (!message.acked && (message.sends == 0 || now - message.sentAt >= resendTimeout())) {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    // Append the pending ack and every message due for (re)sending
+    void write(DatagramBuilder& builder, float now) {
+        if (ackPending_) {
+            uint8_t* out = builder.reserve(WireMessageType::ReliableAck, RELIABLE_ACK_MESSAGE_BYTES);
+            if (out) {
+                writeReliableAckMessage(out, nextReceiveId_, receivedMask());
+                ackPending_ = false;
+            }
+        }
+        
+        const uint16_t end = inFlightEnd();
+        const float timeout = resendTimeout();
+        bool resentAgain = false;
+        for (uint16_t id = oldestUnacked_; id != end; ++id) {
+            Outgoing& message = outgoing_[id % QUEUE_CAPACITY];
+            if (message.acked || (message.sends > 0 && now - message.sentAt < timeout)) {
+                continue;
+            }
+            uint8_t* out = builder.reserve(WireMessageType::Reliable, RELIABLE_MESSAGE_HEADER_BYTES + message.length);
+            if (!out) {
+                continue;
+            }
+            writeReliableMessage(out, id, message.type, message.body, message.length);
+            if (message.sends > 0) {
+                resends_++;
+                resentAgain = resentAgain || message.sends > 1;
+            }
+            if (message.sends < 255) {
+                message.sends++;
+            }
+            message.sentAt = now;
+        }
+        if (resentAgain && backoff_ < MAX_BACKOFF) {
+            backoff_++;
+        }
+    }
+    
+    // Take the peer's ack (see the Reliable Ack Message layout)
+    void onAck(uint16_t nextExpected, uint32_t received, float now) {
+        // An ack for ids we never sent is stale or forged
+        if (before(nextSendId_, nextExpected)) {
+            return;
+        }
+        
+        const uint16_t end = inFlightEnd();
+        for (uint16_t id = oldestUnacked_; id != end; ++id) {
+            Outgoing& message = outgoing_[id % QUEUE_CAPACITY];
+            if (message.acked || message.sends == 0) {
+                continue;
+            }
+            const uint16_t bit = static_cast<uint16_t>(id - nextExpected - 1);
+            if (!before(id, nextExpected) && !(bit < 32 && ((received >> bit) & 1))) {
+                continue;
+            }
+            message.acked = true;
+            // A resent message's ack may answer any of its copies: no sample
+            if (message.sends == 1) {
+                sampleRtt(now - message.sentAt);
+            }
+        }
+        
+        while (oldestUnacked_ != nextSendId_ && outgoing_[oldestUnacked_ % QUEUE_CAPACITY].acked) {
+            oldestUnacked_++;
+        }
+    }
+    
+    // Take one received message; call deliver() afterwards
+    // Returns: false for a duplicate or an id outside the receive window
+    bool receive(uint16_t id, uint8_t type, const uint8_t* body, size_t length) {
+        ackPending_ = true;
+        if (before(id, nextReceiveId_) || static_cast<uint16_t>(id - nextReceiveId_) >= WINDOW ||
+            length > MAX_RELIABLE_BODY_BYTES) {
+            duplicates_++;
+            return false;
+        }
+        Incoming& slot = incoming_[id % WINDOW];
+        if (slot.present) {
+            duplicates_++;
+            return false;
+        }
+        slot.present = true;
+        slot.type = type;
+        slot.length = static_cast<uint8_t>(length);
+        std::memcpy(slot.body, body, length);
+        return true;
+    }
+    
+    // Hand every message that is now in order to fn(type, body, length), oldest first
+    // fn may send() on this channel
+    template <typename Fn>
+    void deliver(Fn&& fn) {
+        while (incoming_[nextReceiveId_ % WINDOW].present) {
+            Incoming& slot = incoming_[nextReceiveId_ % WINDOW];
+            slot.present = false;
+            nextReceiveId_++;
+            fn(slot.type, static_cast<const uint8_t*>(slot.body), static_cast<size_t>(slot.length));
+        }
+    }
+    
+    // Resend timeout from the RTT estimate, before backoff
+    float timeout() const {
+        if (!rtt_.hasSample()) {
+            return INITIAL_TIMEOUT;
+        }
+        return std::min(MAX_TIMEOUT, std::max(MIN_TIMEOUT, rtt_.smoothed() + 4.0f * rtt_.variance()));
+    }
+    
+    bool hasRttSample() const { return rtt_.hasSample(); }
+    float smoothedRtt() const { return rtt_.smoothed(); }
+    float rttVariance() const { return rtt_.variance(); }
+    size_t resends() const { return resends_; }
+    size_t duplicates() const { return duplicates_; }
+    
+    // Messages sent or waiting to be sent that the peer has not acknowledged
+    uint16_t queued() const { return static_cast<uint16_t>(nextSendId_ - oldestUnacked_); }
+    
+private:
+    struct Outgoing {
+        uint8_t type = 0;
+        uint8_t length = 0;
+        uint8_t sends = 0;     // 0 = never sent
+        bool acked = false;
+        float sentAt = 0.0f;   // Time of the latest send
+        uint8_t body[MAX_RELIABLE_BODY_BYTES];
+    };
+    
+    struct Incoming {
+        bool present = false;
+        uint8_t type = 0;
+        uint8_t length = 0;
+        uint8_t body[MAX_RELIABLE_BODY_BYTES];
+    };
+    
+    // Serial number order: a comes before b (valid while they are < 32768 apart)
+    static bool before(uint16_t a, uint16_t b) {
+        return static_cast<int16_t>(static_cast<uint16_t>(a - b)) < 0;
+    }
+    
+    // One past the newest id that may be in flight
+    uint16_t inFlightEnd() const {
+        return queued() > WINDOW ? static_cast<uint16_t>(oldestUnacked_ + WINDOW) : nextSendId_;
+    }
+    
+    float resendTimeout() const {
+        return std::min(MAX_TIMEOUT, timeout() * static_cast<float>(1u << backoff_));
+    }
+    
+    uint32_t receivedMask() const {
+        uint32_t mask = 0;
+        for (uint16_t i = 0; i + 1 < WINDOW; ++i) {
+            if (incoming_[static_cast<uint16_t>(nextReceiveId_ + 1 + i) % WINDOW].present) {
+                mask |= uint32_t(1) << i;
+            }
+        }
+        return mask;
+    }
+    
+    void sampleRtt(float rtt) {
+        backoff_ = 0;
+        rtt_.sample(rtt);
+    }
+    
+    std::array<Outgoing, QUEUE_CAPACITY> outgoing_;
+    std::array<Incoming, WINDOW> incoming_;
+    uint16_t nextSendId_ = 0;
+    uint16_t oldestUnacked_ = 0;
+    uint16_t nextReceiveId_ = 0;
+    bool ackPending_ = false;
+    int backoff_ = 0;
+    RttEstimator rtt_;
+    size_t resends_ = 0;
+    size_t duplicates_ = 0;
+};
+
+// One client connection over the last report window (see LinkQuality)
+// Upstream is client -> server, downstream server -> client
+struct ConnectionReport {
+    uint32_t playerId = 0;
+    bool hasRtt = false;
+    float rtt = 0.0f;             // Smoothed, seconds
+    float rttJitter = 0.0f;       // Mean deviation, seconds
+    uint64_t upstreamReceived = 0;
+    int64_t upstreamLost = 0;     // Late datagrams may make a window negative
+    uint64_t upstreamOutOfOrder = 0;
+    uint64_t upstreamDuplicates = 0;
+    uint64_t downstreamSent = 0;
+    int64_t downstreamLost = 0;   // As reported by the client
+    uint64_t reliableResends = 0;
+};
+
+// Latency and loss of one client connection, for the performance report
+//
+// ALGORITHM:
+// RTT: the send time of the last SENT_SNAPSHOTS snapshots is kept. The client
+// acknowledges the newest snapshot in every input message together with how
+// long it held it (ackDelay), so arrival - send - ackDelay is one round trip
+// without the client's 20 Hz send phase in it. Each tick is sampled once, from
+// the first input message acknowledging it, and smoothed by RttEstimator.
+// Upstream loss: gaps in the client's wire sequence (SequenceTracker).
+// Downstream loss: the client's running count of missing server sequence
+// numbers; its 16-bit differences are summed, so reordered reports cancel out.
+//
+// PERFORMANCE:
+// Fixed arrays, no allocation; a snapshot ack scans SENT_SNAPSHOTS entries.
+class LinkQuality {
+public:
+    static const size_t SENT_SNAPSHOTS = 32;  // 1.6 s at 20 Hz; older acks give no sample
+    
+    LinkQuality() {
+        for (SentSnapshot& sent : sent_) {
+            sent.tick = NO_SNAPSHOT_ACK;
+        }
+    }
+    
+    // A snapshot for tick went out at now (networkClock)
+    void onSnapshotSent(uint32_t tick, float now) {
+        sent_[sentCount_ % SENT_SNAPSHOTS] = SentSnapshot{ tick, now };
+        sentCount_++;
+    }
+    
+    // An input message that arrived at receivedAt acknowledged tick, held ackDelay ms
+    void onSnapshotAck(uint32_t tick, uint16_t ackDelay, float receivedAt) {
+        if (ackDelay == NO_ACK_DELAY || (sampledAny_ && tick <= lastSampledTick_)) {
+            return;
+        }
+        for (const SentSnapshot& sent : sent_) {
+            if (sent.tick == tick) {
+                rtt_.sample(std::max(0.0f, receivedAt - sent.sentAt - ackDelay * 0.001f));
+                lastSampledTick_ = tick;
+                sampledAny_ = true;
+                return;
+            }
+        }
+    }
+    
+    // Wire sequence of a datagram from the client
+    void onDatagram(uint32_t sequence) {
+        upstream_.onDatagram(sequence);
+    }
+    
+    void onDatagramsSent(uint32_t count) {
+        downstreamSent_ += count;
+    }
+    
+    // The client's count of missing server sequence numbers (input message lostDatagrams)
+    void onDownstreamReport(uint16_t lostDatagrams) {
+        downstreamLost_ += static_cast<int16_t>(static_cast<uint16_t>(lostDatagrams - lastLostReport_));
+        lastLostReport_ = lostDatagrams;
+    }
+    
+    const RttEstimator& rtt() const { return rtt_; }
+    const SequenceTracker& upstream() const { return upstream_; }
+    uint64_t downstreamSent() const { return downstreamSent_; }
+    int64_t downstreamLost() const { return downstreamLost_; }
+    
+    // Counters since the previous call, plus the current RTT estimate
+    ConnectionReport takeReport(uint32_t playerId, uint64_t reliableResends) {
+        ConnectionReport report;
+        report.playerId = playerId;
+        report.hasRtt = rtt_.hasSample();
+        report.rtt = rtt_.smoothed();
+        report.rttJitter = rtt_.variance();
+        report.upstreamReceived = upstream_.received() - reported_.upstreamReceived;
+        report.upstreamLost = static_cast<int64_t>(upstream_.lost()) - reported_.upstreamLost;
+        report.upstreamOutOfOrder = upstream_.outOfOrder() - reported_.upstreamOutOfOrder;
+        report.upstreamDuplicates = upstream_.duplicates() - reported_.upstreamDuplicates;
+        report.downstreamSent = downstreamSent_ - reported_.downstreamSent;
+        report.downstreamLost = downstreamLost_ - reported_.downstreamLost;
+        report.reliableResends = reliableResends - reported_.reliableResends;
+        
+        reported_.upstreamReceived = upstream_.received();
+        reported_.upstreamLost = static_cast<int64_t>(upstream_.lost());
+        reported_.upstreamOutOfOrder = upstream_.outOfOrder();
+        reported_.upstreamDuplicates = upstream_.duplicates();
+        reported_.downstreamSent = downstreamSent_;
+        reported_.downstreamLost = downstreamLost_;
+        reported_.reliableResends = reliableResends;
+        return report;
+    }
+    
+private:
+    struct SentSnapshot {
+        uint32_t tick;
+        float sentAt;
+    };
+    
+    std::array<SentSnapshot, SENT_SNAPSHOTS> sent_;
+    size_t sentCount_ = 0;
+    uint32_t lastSampledTick_ = 0;
+    bool sampledAny_ = false;
+    RttEstimator rtt_;
+    SequenceTracker upstream_;
+    uint64_t downstreamSent_ = 0;
+    int64_t downstreamLost_ = 0;
+    uint16_t lastLostReport_ = 0;
+    ConnectionReport reported_;  // Totals at the previous takeReport()
+};
+
+// ========================
+// Helpers
+// ========================
+
+// Encode an input message with a link report and read it back
+InputMessageView roundTripInput(uint8_t* buffer, uint32_t ackTick, const InputLinkReport& link) {
+    InputCommand commands[2];
+    commands[0].sequence = 41;
+    commands[0].buttons = INPUT_UP;
+    commands[1].sequence = 42;
+    commands[1].buttons = INPUT_LEFT;
+    commands[1].aim = 0x4000;
+    const size_t length = writeInputMessage(buffer, 7, ackTick, link, commands, 2);
+    return InputMessageView(buffer, length);
+}
+
+struct SimulatedLink {
+    float latency = 0.04f;  // Seconds, one way
+    float jitter = 0.0f;    // Extra delay, uniform in [0, jitter] (reorders datagrams)
+    float loss = 0.0f;      // Probability a datagram is lost
+};
+
+// Datagram on its way: wire sequence plus the fields the receiver looks at
+struct InFlight {
+    float arrival;
+    uint32_t sequence;
+    uint32_t tick;               // Server -> client: snapshot tick
+    std::vector<uint8_t> input;  // Client -> server: input message payload
+};
+
+struct SimulationResult {
+    float trueRtt = 0.0f;      // 2 x (latency + mean jitter)
+    float estimate = 0.0f;     // LinkQuality smoothed RTT at the end
+    float jitter = 0.0f;       // LinkQuality RTT deviation at the end
+    float naive = 0.0f;        // Mean of arrival - send, ignoring the ack delay
+    float upstreamLoss = 0.0f;
+    float downstreamLoss = 0.0f;
+    float trueUpstreamLoss = 0.0f;
+    float trueDownstreamLoss = 0.0f;
+    uint64_t outOfOrder = 0;
+};
+
+// Server at 60 Hz sending 20 Hz snapshots; client looping as udpThread does:
+// every ~10 ms (sleep overshoot drifts it against the server) it sends an input
+// message if 50 ms have passed since the last one, then receives one datagram
+SimulationResult simulate(const SimulatedLink& link, float seconds, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    LinkQuality quality;
+    SequenceTracker downstream;
+    std::vector<InFlight> toClient;
+    std::vector<InFlight> toServer;
+    std::vector<float> sentAt;  // By snapshot tick
+    uint32_t serverSequence = 0;
+    uint32_t clientSequence = 0;
+    uint32_t ackTick = NO_SNAPSHOT_ACK;
+    float ackReceivedAt = 0.0f;
+    size_t upstreamDropped = 0;
+    size_t downstreamDropped = 0;
+    double naiveSum = 0.0;
+    size_t naiveCount = 0;
+    uint32_t lastNaiveTick = NO_SNAPSHOT_ACK;
+    
+    auto byArrival = [](const InFlight& a, const InFlight& b) { return a.arrival < b.arrival; };
+    const float step = 0.0005f;
+    float nextLoop = 0.01f * unit(rng);
+    float lastSend = -1.0f;
+    uint32_t tick = 0;
+    
+    for (float now = 0.0f; now < seconds; now += step) {
+        // Server tick: snapshot every third tick
+        while (tick / 60.0f <= now) {
+            if (tick % 3 == 0) {
+                const float sendTime = tick / 60.0f;
+                sentAt.resize(tick + 1, 0.0f);
+                sentAt[tick] = sendTime;
+                quality.onSnapshotSent(tick, sendTime);
+                quality.onDatagramsSent(1);
+                if (unit(rng) < link.loss) {
+                    downstreamDropped++;
+                } else {
+                    toClient.push_back({ sendTime + link.latency + link.jitter * unit(rng), serverSequence, tick, {} });
+                }
+                serverSequence++;
+            }
+            tick++;
+        }
+        
+        // Server listener: datagrams are stamped on arrival
+        std::sort(toServer.begin(), toServer.end(), byArrival);
+        while (!toServer.empty() && toServer.front().arrival <= now) {
+            const InFlight& datagram = toServer.front();
+            const InputMessageView input(datagram.input.data(), datagram.input.size());
+            quality.onDatagram(datagram.sequence);
+            if (input.ackTick() != NO_SNAPSHOT_ACK) {
+                quality.onSnapshotAck(input.ackTick(), input.ackDelay(), datagram.arrival);
+                if (input.ackTick() != lastNaiveTick) {
+                    naiveSum += datagram.arrival - sentAt[input.ackTick()];
+                    naiveCount++;
+                    lastNaiveTick = input.ackTick();
+                }
+            }
+            quality.onDownstreamReport(input.lostDatagrams());
+            toServer.erase(toServer.begin());
+        }
+        
+        if (now < nextLoop) {
+            continue;
+        }
+        nextLoop = now + 0.01f + 0.001f * unit(rng);
+        
+        // Client input send (same link report as udpThread)
+        if (now - lastSend >= 0.05f) {
+            lastSend = now;
+            InputLinkReport report;
+            if (ackTick != NO_SNAPSHOT_ACK) {
+                const float held = std::max(0.0f, now - ackReceivedAt);
+                report.ackDelay = static_cast<uint16_t>(std::min(65534.0f, std::round(held * 1000.0f)));
+            }
+            report.lostDatagrams = static_cast<uint16_t>(downstream.lost());
+            InputCommand command;
+            command.sequence = clientSequence;
+            std::vector<uint8_t> payload(MAX_INPUT_MESSAGE_BYTES);
+            payload.resize(writeInputMessage(payload.data(), 1, ackTick, report, &command, 1));
+            if (unit(rng) < link.loss) {
+                upstreamDropped++;
+            } else {
+                toServer.push_back({ now + link.latency + link.jitter * unit(rng), clientSequence, 0, payload });
+            }
+            clientSequence++;
+        }
+        
+        // Client receive: one datagram per loop
+        std::sort(toClient.begin(), toClient.end(), byArrival);
+        if (!toClient.empty() && toClient.front().arrival <= now) {
+            downstream.onDatagram(toClient.front().sequence);
+            if (ackTick == NO_SNAPSHOT_ACK || toClient.front().tick > ackTick) {
+                ackTick = toClient.front().tick;
+                ackReceivedAt = now;
+            }
+            toClient.erase(toClient.begin());
+        }
+    }
+    
+    SimulationResult result;
+    result.trueRtt = 2.0f * (link.latency + link.jitter * 0.5f);
+    result.estimate = quality.rtt().smoothed();
+    result.jitter = quality.rtt().variance();
+    result.naive = naiveCount > 0 ? static_cast<float>(naiveSum / naiveCount) : 0.0f;
+    const SequenceTracker& upstream = quality.upstream();
+    result.upstreamLoss = static_cast<float>(upstream.lost()) / (upstream.received() + upstream.lost());
+    result.downstreamLoss = static_cast<float>(quality.downstreamLost()) / quality.downstreamSent();
+    result.trueUpstreamLoss = static_cast<float>(upstreamDropped) / clientSequence;
+    result.trueDownstreamLoss = static_cast<float>(downstreamDropped) / serverSequence;
+    result.outOfOrder = upstream.outOfOrder();
+    return result;
+}
+
+// ========================
+// Tests
+// ========================
+
+TEST(InputMessageCarriesLinkReport) {
+    uint8_t buffer[MAX_INPUT_MESSAGE_BYTES];
+    InputLinkReport link;
+    link.ackDelay = 37;
+    link.lostDatagrams = 65535;
+    const InputMessageView input = roundTripInput(buffer, 1234, link);
+    ASSERT_EQ(7, input.playerId());
+    ASSERT_TRUE(input.ackTick() == 1234);
+    ASSERT_EQ(37, input.ackDelay());
+    ASSERT_EQ(65535, input.lostDatagrams());
+    ASSERT_EQ(2, input.count());
+    ASSERT_TRUE(input.command(1).sequence == 42);
+    ASSERT_EQ(INPUT_LEFT, input.command(1).buttons);
+    ASSERT_EQ(0x4000, input.command(1).aim);
+    
+    // Defaults before the first snapshot
+    const InputMessageView first = roundTripInput(buffer, NO_SNAPSHOT_ACK, InputLinkReport());
+    ASSERT_EQ(NO_ACK_DELAY, first.ackDelay());
+    ASSERT_EQ(0, first.lostDatagrams());
+}
+
+TEST(SequenceGapsReorderingAndDuplicates) {
+    SequenceTracker tracker;
+    const uint32_t order[] = { 0, 1, 2, 5 };
+    for (uint32_t sequence : order) ASSERT_TRUE(tracker.onDatagram(sequence));
+    ASSERT_EQ(2, tracker.lost());
+    
+    // 4 arrives late: no longer lost, but out of order
+    ASSERT_TRUE(!tracker.onDatagram(4));
+    ASSERT_EQ(1, tracker.lost());
+    ASSERT_EQ(1, tracker.outOfOrder());
+    
+    // Repeats are duplicates, whether they were the newest or late
+    ASSERT_TRUE(!tracker.onDatagram(4));
+    ASSERT_TRUE(!tracker.onDatagram(5));
+    ASSERT_EQ(2, tracker.duplicates());
+    
+    ASSERT_TRUE(!tracker.onDatagram(3));
+    ASSERT_EQ(0, tracker.lost());
+    ASSERT_EQ(2, tracker.outOfOrder());
+    ASSERT_EQ(6, tracker.received());
+}
+
+TEST(SequenceFirstTwoOutOfOrder) {
+    SequenceTracker tracker;
+    ASSERT_TRUE(tracker.onDatagram(11));
+    
+    // 10 was sent first but arrives second: never counted as lost, so nothing to take back
+    ASSERT_TRUE(!tracker.onDatagram(10));
+    ASSERT_EQ(0, tracker.lost());
+    ASSERT_EQ(1, tracker.outOfOrder());
+    ASSERT_EQ(2, tracker.received());
+    ASSERT_TRUE(!tracker.onDatagram(10));
+    ASSERT_EQ(1, tracker.duplicates());
+    
+    // Gaps after the first one still count
+    ASSERT_TRUE(tracker.onDatagram(14));
+    ASSERT_EQ(2, tracker.lost());
+    ASSERT_TRUE(!tracker.onDatagram(12));
+    ASSERT_EQ(1, tracker.lost());
+    ASSERT_TRUE(!tracker.onDatagram(9));
+    ASSERT_EQ(1, tracker.lost());
+    ASSERT_EQ(3, tracker.outOfOrder());
+}
+
+TEST(SequenceWindowIs64) {
+    SequenceTracker tracker;
+    tracker.onDatagram(0);
+    tracker.onDatagram(100);
+    ASSERT_EQ(99, tracker.lost());
+    
+    // 37 is the oldest sequence the mask still covers
+    tracker.onDatagram(37);
+    ASSERT_EQ(98, tracker.lost());
+    
+    // Older than the window: late, but stays counted as lost
+    tracker.onDatagram(36);
+    ASSERT_EQ(98, tracker.lost());
+    ASSERT_EQ(2, tracker.outOfOrder());
+    
+    // Small steps shift the mask: 100 is still known after 63 more
+    for (uint32_t sequence = 101; sequence <= 163; ++sequence) tracker.onDatagram(sequence);
+    tracker.onDatagram(100);
+    ASSERT_EQ(1, tracker.duplicates());
+    ASSERT_EQ(98, tracker.lost());
+}
+
+TEST(RttEstimatorSmoothsAndMeasuresJitter) {
+    RttEstimator rtt;
+    ASSERT_TRUE(!rtt.hasSample());
+    rtt.sample(0.1f);
+    ASSERT_TRUE(rtt.hasSample());
+    ASSERT_NEAR(0.1f, rtt.smoothed(), 1e-6f);
+    ASSERT_NEAR(0.05f, rtt.variance(), 1e-6f);
+    
+    // Alternating 40 and 60 ms: mean 50 ms, deviation 10 ms
+    for (int i = 0; i < 200; ++i) rtt.sample(i % 2 ? 0.04f : 0.06f);
+    ASSERT_NEAR(0.05f, rtt.smoothed(), 0.002f);
+    ASSERT_NEAR(0.01f, rtt.variance(), 0.001f);
+}
+
+TEST(RttSampleSubtractsAckDelay) {
+    LinkQuality quality;
+    quality.onSnapshotSent(30, 1.0f);
+    quality.onSnapshotSent(33, 1.05f);
+    
+    // Before the first snapshot arrived there is nothing to measure
+    quality.onSnapshotAck(30, NO_ACK_DELAY, 1.2f);
+    ASSERT_TRUE(!quality.rtt().hasSample());
+    
+    // Held 30 ms by the client: 70 ms round trip
+    quality.onSnapshotAck(30, 30, 1.1f);
+    ASSERT_TRUE(quality.rtt().hasSample());
+    ASSERT_NEAR(0.07f, quality.rtt().smoothed(), 1e-5f);
+    
+    // Later acks of the same or an older tick give no sample
+    quality.onSnapshotAck(30, 80, 1.15f);
+    quality.onSnapshotAck(30, 0, 1.5f);
+    ASSERT_NEAR(0.07f, quality.rtt().smoothed(), 1e-5f);
+    
+    // Unknown ticks neither
+    quality.onSnapshotAck(31, 0, 1.5f);
+    ASSERT_NEAR(0.07f, quality.rtt().smoothed(), 1e-5f);
+    
+    quality.onSnapshotAck(33, 10, 1.14f);
+    ASSERT_NEAR(0.875f * 0.07f + 0.125f * 0.08f, quality.rtt().smoothed(), 1e-5f);
+    
+    // A delay longer than the round trip (clock rounding) clamps to zero
+    quality.onSnapshotSent(36, 2.0f);
+    quality.onSnapshotAck(36, 500, 2.1f);
+    ASSERT_TRUE(quality.rtt().smoothed() < 0.0725f);
+}
+
+TEST(OldSnapshotsAreForgotten) {
+    LinkQuality quality;
+    for (uint32_t tick = 0; tick < LinkQuality::SENT_SNAPSHOTS + 1; ++tick) {
+        quality.onSnapshotSent(tick * 3, tick * 0.05f);
+    }
+    quality.onSnapshotAck(0, 0, 10.0f);
+    ASSERT_TRUE(!quality.rtt().hasSample());
+    quality.onSnapshotAck(3, 0, 0.2f);
+    ASSERT_NEAR(0.15f, quality.rtt().smoothed(), 1e-5f);
+}
+
+TEST(DownstreamReportsWrapAndReorder) {
+    LinkQuality quality;
+    quality.onDownstreamReport(5);
+    quality.onDownstreamReport(3);  // Older report arriving late
+    quality.onDownstreamReport(7);
+    ASSERT_EQ(7, quality.downstreamLost());
+    
+    // Counter wraps at 65536
+    quality.onDownstreamReport(30000);
+    quality.onDownstreamReport(60000);
+    quality.onDownstreamReport(65530);
+    ASSERT_EQ(65530, quality.downstreamLost());
+    quality.onDownstreamReport(4);
+    ASSERT_EQ(65540, quality.downstreamLost());
+}
+
+TEST(ReportsCoverOneWindow) {
+    LinkQuality quality;
+    for (uint32_t sequence = 0; sequence < 20; ++sequence) {
+        if (sequence != 7) quality.onDatagram(sequence);
+    }
+    quality.onDatagramsSent(20);
+    quality.onDownstreamReport(2);
+    quality.onSnapshotSent(3, 0.0f);
+    quality.onSnapshotAck(3, 10, 0.06f);
+    
+    ConnectionReport first = quality.takeReport(4, 3);
+    ASSERT_EQ(4, first.playerId);
+    ASSERT_TRUE(first.hasRtt);
+    ASSERT_NEAR(0.05f, first.rtt, 1e-5f);
+    ASSERT_EQ(19, first.upstreamReceived);
+    ASSERT_EQ(1, first.upstreamLost);
+    ASSERT_EQ(20, first.downstreamSent);
+    ASSERT_EQ(2, first.downstreamLost);
+    ASSERT_EQ(3, first.reliableResends);
+    
+    // 7 turns up in the next window: that window's loss goes negative
+    quality.onDatagram(7);
+    quality.onDatagram(20);
+    quality.onDatagramsSent(5);
+    ConnectionReport second = quality.takeReport(4, 5);
+    ASSERT_EQ(2, second.upstreamReceived);
+    ASSERT_TRUE(second.upstreamLost == -1);
+    ASSERT_EQ(1, second.upstreamOutOfOrder);
+    ASSERT_EQ(5, second.downstreamSent);
+    ASSERT_EQ(0, second.downstreamLost);
+    ASSERT_EQ(2, second.reliableResends);
+}
+
+TEST(EstimatesMatchSimulatedLink) {
+    SimulatedLink link;
+    link.latency = 0.04f;
+    SimulationResult clean = simulate(link, 30.0f, 5);
+    // The client's ~10 ms receive loop is part of the measured round trip
+    ASSERT_TRUE(clean.estimate >= clean.trueRtt - 0.002f);
+    ASSERT_TRUE(clean.estimate <= clean.trueRtt + 0.012f);
+    // Without the ack delay the wait for the client's next send adds ~25 ms
+    ASSERT_TRUE(clean.naive > clean.estimate + 0.015f);
+    ASSERT_EQ(0, clean.outOfOrder);
+    ASSERT_NEAR(0.0f, clean.upstreamLoss, 1e-6f);
+    ASSERT_NEAR(0.0f, clean.downstreamLoss, 1e-6f);
+    
+    // Jitter beyond the 50 ms send interval reorders datagrams
+    link.jitter = 0.08f;
+    link.loss = 0.1f;
+    SimulationResult lossy = simulate(link, 120.0f, 6);
+    ASSERT_NEAR(lossy.trueUpstreamLoss, lossy.upstreamLoss, 0.005f);
+    ASSERT_NEAR(lossy.trueDownstreamLoss, lossy.downstreamLoss, 0.005f);
+    ASSERT_TRUE(lossy.outOfOrder > 0);
+    ASSERT_TRUE(std::fabs(lossy.estimate - lossy.trueRtt) < 0.025f);
+    ASSERT_TRUE(lossy.jitter > 0.005f);
+}
+
+// ========================
+// Benchmark
+// ========================
+
+template <typename F>
+double timeNs(int iterations, F&& body) {
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (int k = 0; k < iterations; k++) body(k);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::nano>(end - begin).count() / iterations;
+}
+
+void benchmarkEstimates() {
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::setw(9) << "One-way" << std::setw(9) << "Jitter" << std::setw(7) << "Loss"
+              << std::setw(11) << "True RTT" << std::setw(11) << "Estimate" << std::setw(10) << "Dev"
+              << std::setw(10) << "Naive" << std::setw(15) << "Up loss" << std::setw(15) << "Down loss" << std::endl;
+    const float latencies[] = { 0.02f, 0.05f, 0.1f };
+    const float jitters[] = { 0.0f, 0.02f };
+    const float losses[] = { 0.0f, 0.05f };
+    for (float latency : latencies) {
+        for (float jitter : jitters) {
+            for (float loss : losses) {
+                SimulatedLink link;
+                link.latency = latency;
+                link.jitter = jitter;
+                link.loss = loss;
+                SimulationResult r = simulate(link, 60.0f, 11);
+                std::ostringstream up;
+                up << std::fixed << std::setprecision(1) << r.upstreamLoss * 100.0f << "/" << r.trueUpstreamLoss * 100.0f << "%";
+                std::ostringstream down;
+                down << std::fixed << std::setprecision(1) << r.downstreamLoss * 100.0f << "/" << r.trueDownstreamLoss * 100.0f << "%";
+                std::cout << std::setw(7) << latency * 1000.0f << "ms" << std::setw(7) << jitter * 1000.0f << "ms"
+                          << std::setw(6) << loss * 100.0f << "%" << std::setw(9) << r.trueRtt * 1000.0f << "ms"
+                          << std::setw(9) << r.estimate * 1000.0f << "ms" << std::setw(8) << r.jitter * 1000.0f << "ms"
+                          << std::setw(8) << r.naive * 1000.0f << "ms" << std::setw(15) << up.str()
+                          << std::setw(15) << down.str() << std::endl;
+            }
+        }
+    }
+    std::cout << "Estimate includes the client's ~10 ms receive loop (~5 ms); Naive ignores the ack delay;" << std::endl;
+    std::cout << "loss columns are measured/actual over 60 s" << std::endl;
+    
+    // CPU cost of the bookkeeping per received input message
+    LinkQuality quality;
+    volatile float sink = 0.0f;
+    double ns = timeNs(1000000, [&](int k) {
+        const uint32_t tick = static_cast<uint32_t>(k) * 3;
+        quality.onSnapshotSent(tick, k * 0.05f);
+        quality.onDatagram(static_cast<uint32_t>(k));
+        quality.onSnapshotAck(tick, 10, k * 0.05f + 0.06f);
+        quality.onDownstreamReport(static_cast<uint16_t>(k / 50));
+        sink = quality.rtt().smoothed();
+    });
+    (void)sink;
+    std::cout << "Per input message (sequence, snapshot send + ack, loss report): " << std::setprecision(0) << ns << " ns" << std::endl;
+}
+
+// ========================
+// Main Test Runner
+// ========================
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Zero Ground Link Quality Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "--- Link Quality Tests ---" << std::endl;
+    RUN_TEST(InputMessageCarriesLinkReport);
+    RUN_TEST(SequenceGapsReorderingAndDuplicates);
+    RUN_TEST(SequenceFirstTwoOutOfOrder);
+    RUN_TEST(SequenceWindowIs64);
+    RUN_TEST(RttEstimatorSmoothsAndMeasuresJitter);
+    RUN_TEST(RttSampleSubtractsAckDelay);
+    RUN_TEST(OldSnapshotsAreForgotten);
+    RUN_TEST(DownstreamReportsWrapAndReorder);
+    RUN_TEST(ReportsCoverOneWindow);
+    RUN_TEST(EstimatesMatchSimulatedLink);
+
+    std::cout << std::endl;
+    std::cout << "--- RTT and Loss Estimates over Simulated Links (20 Hz snapshots and inputs) ---" << std::endl;
+    benchmarkEstimates();
+
+    // Print summary
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Test Summary" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Total tests: " << totalTests << std::endl;
+    std::cout << "Passed: " << passedTests << std::endl;
+    std::cout << "Failed: " << failedTests << std::endl;
+    std::cout << std::endl;
+
+    if (failedTests == 0) {
+        std::cout << "✓ All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "✗ Some tests failed!" << std::endl;
+        return 1;
+    }
+}
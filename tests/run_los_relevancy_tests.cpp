@@ -0,0 +1,719 @@
+// Line-of-Sight Relevancy Tests and Benchmark for Zero Ground
+// Checks that LineOfSightRelevancy hides players behind concrete walls (but not
+// wood), keeps them for the hysteresis window, re-traces only pairs whose ends
+// moved, and respects the per-tick budget. The benchmark replays moving players
+// on a generated map and reports the share of in-range players culled and the
+// per-tick cost with and without the cache.
+//
+// Code under test is copied from Zero_Ground.cpp. Build with /O2 (or -O2).
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <array>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <cstdint>
+
+// ========================
+// Test Framework Macros
+// ========================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "Running test: " << #name << "..."; \
+    try { \
+        test_##name(); \
+        std::cout << " PASSED" << std::endl; \
+        passedTests++; \
+    } catch (const std::exception& e) { \
+        std::cout << " FAILED: " << e.what() << std::endl; \
+        failedTests++; \
+    } \
+    totalTests++; \
+} while(0)
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: " << #condition << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_NEAR(expected, actual, epsilon) do { \
+    if (std::abs((expected) - (actual)) > (epsilon)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << (expected) << " but got " << (actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(expected, actual) do { \
+    if ((expected) != (actual)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << static_cast<int>(expected) << " but got " << static_cast<int>(actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+// Test counters
+int totalTests = 0;
+int passedTests = 0;
+int failedTests = 0;
+
+
+// ========================
+// Code Under Test (copied from Zero_Ground.cpp)
+// ========================
+
+const float MAP_SIZE = 5100.0f;
+const float CELL_SIZE = 100.0f;
+const int GRID_SIZE = 51;
+const float WALL_WIDTH = 12.0f;
+const float WALL_LENGTH = 100.0f;
+const uint32_t MAX_PLAYERS = 64;
+
+enum class WallType : uint8_t {
+    None = 0,
+    Concrete = 1,
+    Wood = 2
+};
+
+struct Cell {
+    WallType topWall = WallType::None;
+    WallType rightWall = WallType::None;
+    WallType bottomWall = WallType::None;
+    WallType leftWall = WallType::None;
+};
+
+struct WallHit {
+    WallType type = WallType::None;
+    float t = 1.0f;
+};
+
+typedef std::vector<std::vector<Cell>> Grid;
+
+void setWall(Cell& cell, int side, WallType type) {
+    switch (side) {
+        case 0: cell.topWall = type; break;
+        case 1: cell.rightWall = type; break;
+        case 2: cell.bottomWall = type; break;
+        case 3: cell.leftWall = type; break;
+    }
+}
+
+// Same generator as the server, seeded for reproducible runs
+void generateMap(std::vector<std::vector<Cell>>& grid, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> probDist(0, 99);  // 0-99 for percentages
+    std::uniform_int_distribution<int> sideDist(0, 3);   // 0-3 for sides
+    std::uniform_int_distribution<int> typeDist(0, 99);  // 0-99 for wall type
+    
+    for (int i = 0; i < GRID_SIZE; i++) {
+        for (int j = 0; j < GRID_SIZE; j++) {
+            // Check condition: only cells where (i+j)%2==1 can generate walls
+            if ((i + j) % 2 == 1) {
+                int probability = probDist(gen);
+                
+                if (probability < 60) {
+                    // 60% probability - create one wall on a random side
+                    int side = sideDist(gen);
+                    // Determine wall type: 70% concrete, 30% wood
+                    WallType type = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    setWall(grid[i][j], side, type);
+                }
+                else if (probability < 85) {
+                    // 25% probability (60-84) - create two walls on different sides
+                    int side1 = sideDist(gen);
+                    int side2 = sideDist(gen);
+                    
+                    // Ensure the two sides are different
+                    while (side2 == side1) {
+                        side2 = sideDist(gen);
+                    }
+                    
+                    // Each wall gets its own type
+                    WallType type1 = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    WallType type2 = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    setWall(grid[i][j], side1, type1);
+                    setWall(grid[i][j], side2, type2);
+                }
+                // 15% probability (85-99) - no walls (do nothing)
+            }
+        }
+    }
+}
+
+struct Bullet {
+    // Slab test: does the segment (x1, y1) + t * (dx, dy), t in [0, 1], touch the rectangle?
+    // On success tEntry is the first t inside the rectangle (0 if the segment starts inside)
+    static bool segmentEntersRect(float x1, float y1, float dx, float dy,
+                                  float rectX, float rectY, float rectW, float rectH,
+                                  float& tEntry) {
+        float tMin = 0.0f;
+        float tMax = 1.0f;
+        
+        const float origin[2] = { x1, y1 };
+        const float dir[2] = { dx, dy };
+        const float lo[2] = { rectX, rectY };
+        const float hi[2] = { rectX + rectW, rectY + rectH };
+        
+        for (int axis = 0; axis < 2; ++axis) {
+            if (dir[axis] == 0.0f) {
+                // Parallel to this slab: must already be inside it
+                if (origin[axis] < lo[axis] || origin[axis] > hi[axis]) return false;
+                continue;
+            }
+            float t1 = (lo[axis] - origin[axis]) / dir[axis];
+            float t2 = (hi[axis] - origin[axis]) / dir[axis];
+            if (t1 > t2) std::swap(t1, t2);
+            tMin = std::max(tMin, t1);
+            tMax = std::min(tMax, t2);
+            if (tMin > tMax) return false;
+        }
+        
+        tEntry = tMin;
+        return true;
+    }
+    
+    // Amanda-Woo grid traversal: walk only the cells the segment (x1, y1) -> (x2, y2)
+    // actually crosses and return the wall it enters first, with its entry parameter t.
+    //
+    // ALGORITHM:
+    // - Start in the cell containing (x1, y1); tMaxX/tMaxY are the t values at which
+    //   the segment crosses the next vertical/horizontal cell boundary, tDeltaX/tDeltaY
+    //   the t needed to cross a whole cell. Always step across the nearer boundary.
+    // - Walls are centered on cell boundaries and stick WALL_WIDTH/2 into both cells,
+    //   so each visited cell tests the walls on its four boundaries, whichever side
+    //   of the boundary (this cell or the neighbour) owns them.
+    // - Every wall touching a later cell is entered at t >= the current cell's exit t,
+    //   so the walk stops as soon as the best hit lies inside the current cell.
+    //
+    // PERFORMANCE: visits |dCellX| + |dCellY| + 1 cells (usually 1-2 per tick at
+    // bullet speeds) instead of the (dCellX + 3) * (dCellY + 3) bounding box scanned
+    // before, and only runs the slab test on walls that exist.
+    //
+    // concreteOnly ignores wood walls (line-of-sight checks, see LineOfSightRelevancy)
+    static WallHit traceCellWallsDDA(const std::vector<std::vector<Cell>>& grid,
+                                     float x1, float y1, float x2, float y2, bool concreteOnly = false) {
+        WallHit best;
+        const float dx = x2 - x1;
+        const float dy = y2 - y1;
+        
+        // Wall owned by cell (i, j) on the given side, None outside the grid
+        auto wallAt = [&grid](int i, int j, int side) -> WallType {
+            if (i < 0 || i >= GRID_SIZE || j < 0 || j >= GRID_SIZE) return WallType::None;
+            const Cell& cell = grid[i][j];
+            switch (side) {
+                case 0: return cell.topWall;
+                case 1: return cell.rightWall;
+                case 2: return cell.bottomWall;
+                default: return cell.leftWall;
+            }
+        };
+        
+        auto testWall = [&](WallType type, float rectX, float rectY, float rectW, float rectH) {
+            if (type == WallType::None || (concreteOnly && type != WallType::Concrete)) return;
+            float t;
+            if (segmentEntersRect(x1, y1, dx, dy, rectX, rectY, rectW, rectH, t) &&
+                (best.type == WallType::None || t < best.t)) {
+                best.type = type;
+                best.t = t;
+            }
+        };
+        
+        // Test the walls on all four boundaries of cell (i, j)
+        auto testCellBoundaries = [&](int i, int j) {
+            const float cellWorldX = i * CELL_SIZE;
+            const float cellWorldY = j * CELL_SIZE;
+            const float half = WALL_WIDTH / 2.0f;
+            
+            // Top boundary: this cell's top wall or the upper neighbour's bottom wall
+            testWall(wallAt(i, j, 0), cellWorldX, cellWorldY - half, WALL_LENGTH, WALL_WIDTH);
+            testWall(wallAt(i, j - 1, 2), cellWorldX, cellWorldY - half, WALL_LENGTH, WALL_WIDTH);
+            // Right boundary
+            testWall(wallAt(i, j, 1), cellWorldX + CELL_SIZE - half, cellWorldY, WALL_WIDTH, WALL_LENGTH);
+            testWall(wallAt(i + 1, j, 3), cellWorldX + CELL_SIZE - half, cellWorldY, WALL_WIDTH, WALL_LENGTH);
+            // Bottom boundary
+            testWall(wallAt(i, j, 2), cellWorldX, cellWorldY + CELL_SIZE - half, WALL_LENGTH, WALL_WIDTH);
+            testWall(wallAt(i, j + 1, 0), cellWorldX, cellWorldY + CELL_SIZE - half, WALL_LENGTH, WALL_WIDTH);
+            // Left boundary
+            testWall(wallAt(i, j, 3), cellWorldX - half, cellWorldY, WALL_WIDTH, WALL_LENGTH);
+            testWall(wallAt(i - 1, j, 1), cellWorldX - half, cellWorldY, WALL_WIDTH, WALL_LENGTH);
+        };
+        
+        int cellX = static_cast<int>(std::floor(x1 / CELL_SIZE));
+        int cellY = static_cast<int>(std::floor(y1 / CELL_SIZE));
+        const int endCellX = static_cast<int>(std::floor(x2 / CELL_SIZE));
+        const int endCellY = static_cast<int>(std::floor(y2 / CELL_SIZE));
+        
+        const int stepX = (dx > 0.0f) ? 1 : (dx < 0.0f ? -1 : 0);
+        const int stepY = (dy > 0.0f) ? 1 : (dy < 0.0f ? -1 : 0);
+        const float inf = std::numeric_limits<float>::infinity();
+        
+        float tMaxX = inf, tDeltaX = inf;
+        if (stepX != 0) {
+            float boundaryX = (cellX + (stepX > 0 ? 1 : 0)) * CELL_SIZE;
+            tMaxX = (boundaryX - x1) / dx;
+            tDeltaX = CELL_SIZE / std::abs(dx);
+        }
+        float tMaxY = inf, tDeltaY = inf;
+        if (stepY != 0) {
+            float boundaryY = (cellY + (stepY > 0 ? 1 : 0)) * CELL_SIZE;
+            tMaxY = (boundaryY - y1) / dy;
+            tDeltaY = CELL_SIZE / std::abs(dy);
+        }
+        
+        // Exact number of boundary crossings; also bounds the loop against rounding
+        int remainingSteps = std::abs(endCellX - cellX) + std::abs(endCellY - cellY);
+        
+        while (true) {
+            testCellBoundaries(cellX, cellY);
+            
+            const float tExit = std::min(tMaxX, tMaxY);
+            if (best.type != WallType::None && best.t <= tExit) break;
+            if (remainingSteps-- <= 0) break;
+            
+            if (tMaxX < tMaxY) {
+                cellX += stepX;
+                tMaxX += tDeltaX;
+            } else {
+                cellY += stepY;
+                tMaxY += tDeltaY;
+            }
+        }
+        
+        return best;
+    }
+};
+
+// Players hidden behind concrete walls are not replicated to a client: it saves
+// the bandwidth and a modified client cannot draw them through walls.
+const float LOS_HIDE_GRACE = 0.5f;           // Seconds a player that went out of sight is still sent
+const float LOS_TARGET_MARGIN = 40.0f;       // Side rays aim this far beside the target's center
+const float LOS_RECHECK_DISTANCE = 25.0f;    // Movement (per axis, px) that invalidates a cached result
+const int LOS_MAX_PAIR_CHECKS_PER_TICK = 512;
+
+// True if no concrete wall blocks the segment (wood does not block sight)
+inline bool concreteLineOfSight(const std::vector<std::vector<Cell>>& grid, float x1, float y1, float x2, float y2) {
+    return Bullet::traceCellWallsDDA(grid, x1, y1, x2, y2, true).type == WallType::None;
+}
+
+// Whether a viewer at (vx, vy) can see any part of a target at (tx, ty)
+// Tests the center ray and two rays LOS_TARGET_MARGIN to either side of the
+// target, so players peeking around a corner are sent before their center is
+// visible (the client's fog and the 20 Hz snapshot delay need that slack).
+// Returns: visibility; rays counts the traversals used (1-3)
+inline bool targetVisible(const std::vector<std::vector<Cell>>& grid, float vx, float vy, float tx, float ty,
+                          int& rays) {
+    rays = 1;
+    if (concreteLineOfSight(grid, vx, vy, tx, ty)) {
+        return true;
+    }
+    
+    const float dx = tx - vx;
+    const float dy = ty - vy;
+    const float length = std::sqrt(dx * dx + dy * dy);
+    if (length < 0.001f) {
+        return true;
+    }
+    const float px = -dy / length * LOS_TARGET_MARGIN;
+    const float py = dx / length * LOS_TARGET_MARGIN;
+    
+    rays = 2;
+    if (concreteLineOfSight(grid, vx, vy, tx + px, ty + py)) {
+        return true;
+    }
+    rays = 3;
+    return concreteLineOfSight(grid, vx, vy, tx - px, ty - py);
+}
+
+// Per viewer/target pair visibility cache with hysteresis
+//
+// ALGORITHM:
+// - A pair is re-traced only when the viewer or the target moved into another
+//   LOS_RECHECK_DISTANCE square since the last trace (the map never changes), so
+//   standing players cost nothing after the first tick.
+// - At most LOS_MAX_PAIR_CHECKS_PER_TICK pairs are re-traced per call to
+//   beginTick(); pairs over the budget keep their cached result until a later tick.
+//   Pairs never traced are treated as visible.
+// - Hysteresis: a target stays relevant for graceTicks after it was last seen,
+//   so players flickering along wall edges don't pop in and out. Becoming
+//   visible takes effect immediately.
+//
+// PERFORMANCE: each trace is 1-3 grid traversals (Bullet::traceCellWallsDDA),
+// O(cells crossed); with the cache, per-tick cost scales with how many players
+// moved, not with players^2.
+class LineOfSightRelevancy {
+public:
+    // Start a snapshot tick: resets the re-trace budget
+    void beginTick() {
+        budget_ = LOS_MAX_PAIR_CHECKS_PER_TICK;
+        raysThisTick_ = 0;
+    }
+    
+    // Whether the target should be replicated to the viewer this tick
+    bool isRelevant(const std::vector<std::vector<Cell>>& grid, uint32_t viewerId, float vx, float vy,
+                    uint32_t targetId, float tx, float ty, uint32_t tickNumber, uint32_t graceTicks) {
+        PairState& pair = pairs_[viewerId * MAX_PLAYERS + targetId];
+        const int32_t viewerKey = positionKey(vx, vy);
+        const int32_t targetKey = positionKey(tx, ty);
+        
+        const bool stale = (pair.viewerKey != viewerKey || pair.targetKey != targetKey);
+        if (stale && budget_ > 0) {
+            budget_--;
+            int rays = 0;
+            pair.visible = targetVisible(grid, vx, vy, tx, ty, rays);
+            pair.viewerKey = viewerKey;
+            pair.targetKey = targetKey;
+            raysThisTick_ += rays;
+        }
+        
+        if (pair.viewerKey == NO_KEY || pair.visible) {
+            pair.lastVisibleTick = tickNumber;
+            pair.seen = true;
+            return true;
+        }
+        return pair.seen && tickNumber - pair.lastVisibleTick <= graceTicks;
+    }
+    
+    // Drop every pair the player is part of, as viewer or target
+    // Call when the player leaves: its ID may be reused by a new player
+    void forgetPlayer(uint32_t playerId) {
+        if (playerId >= MAX_PLAYERS) {
+            return;
+        }
+        for (uint32_t other = 0; other < MAX_PLAYERS; ++other) {
+            pairs_[playerId * MAX_PLAYERS + other] = PairState();
+            pairs_[other * MAX_PLAYERS + playerId] = PairState();
+        }
+    }
+    
+    // Grid traversals used since beginTick()
+    int raysThisTick() const { return raysThisTick_; }
+    
+private:
+    static constexpr int32_t NO_KEY = -1;
+    
+    struct PairState {
+        int32_t viewerKey = NO_KEY;  // positionKey() of both ends at the last trace
+        int32_t targetKey = NO_KEY;
+        bool visible = true;
+        bool seen = false;
+        uint32_t lastVisibleTick = 0;
+    };
+    
+    static int32_t positionKey(float x, float y) {
+        const int32_t kx = static_cast<int32_t>(std::max(0.0f, x) / LOS_RECHECK_DISTANCE);
+        const int32_t ky = static_cast<int32_t>(std::max(0.0f, y) / LOS_RECHECK_DISTANCE);
+        return (kx << 12) | (ky & 0xFFF);
+    }
+    
+    std::array<PairState, MAX_PLAYERS * MAX_PLAYERS> pairs_;
+    int budget_ = LOS_MAX_PAIR_CHECKS_PER_TICK;
+    int raysThisTick_ = 0;
+};
+
+// ========================
+// Test Helpers
+// ========================
+
+typedef std::vector<std::vector<Cell>> Grid;
+
+Grid emptyGrid() {
+    return Grid(GRID_SIZE, std::vector<Cell>(GRID_SIZE));
+}
+
+// Vertical wall on the right side of cells (i, jFrom..jTo)
+void verticalWall(Grid& grid, int i, int jFrom, int jTo, WallType type) {
+    for (int j = jFrom; j <= jTo; ++j) {
+        grid[i][j].rightWall = type;
+    }
+}
+
+const uint32_t GRACE_TICKS = 30;  // LOS_HIDE_GRACE at 60 Hz
+
+// ========================
+// Line-of-Sight Tests
+// ========================
+
+TEST(OpenFieldIsVisible) {
+    Grid grid = emptyGrid();
+    LineOfSightRelevancy relevancy;
+    relevancy.beginTick();
+    ASSERT_TRUE(relevancy.isRelevant(grid, 0, 1050.0f, 1050.0f, 1, 1850.0f, 1450.0f, 1, GRACE_TICKS));
+    ASSERT_EQ(1, relevancy.raysThisTick());
+}
+
+TEST(ConcreteWallOccludes) {
+    Grid grid = emptyGrid();
+    verticalWall(grid, 14, 5, 15, WallType::Concrete);  // wall at x = 1500, y 500..1600
+    int rays = 0;
+    ASSERT_TRUE(!targetVisible(grid, 1050.0f, 1050.0f, 1950.0f, 1050.0f, rays));
+    ASSERT_EQ(3, rays);
+    
+    LineOfSightRelevancy relevancy;
+    relevancy.beginTick();
+    ASSERT_TRUE(!relevancy.isRelevant(grid, 0, 1050.0f, 1050.0f, 1, 1950.0f, 1050.0f, 1, GRACE_TICKS));
+}
+
+TEST(WoodWallDoesNotOcclude) {
+    Grid grid = emptyGrid();
+    verticalWall(grid, 14, 5, 15, WallType::Wood);
+    LineOfSightRelevancy relevancy;
+    relevancy.beginTick();
+    ASSERT_TRUE(relevancy.isRelevant(grid, 0, 1050.0f, 1050.0f, 1, 1950.0f, 1050.0f, 1, GRACE_TICKS));
+}
+
+TEST(PeekingAroundCornerIsVisible) {
+    Grid grid = emptyGrid();
+    verticalWall(grid, 14, 5, 10, WallType::Concrete);  // wall ends at y = 1100
+    // Center ray hits the wall end, the side ray passes below it
+    int rays = 0;
+    ASSERT_TRUE(!concreteLineOfSight(grid, 1050.0f, 1050.0f, 1950.0f, 1130.0f));
+    ASSERT_TRUE(targetVisible(grid, 1050.0f, 1050.0f, 1950.0f, 1130.0f, rays));
+    ASSERT_TRUE(rays > 1);
+}
+
+TEST(HiddenPlayerKeptForGraceWindow) {
+    Grid grid = emptyGrid();
+    verticalWall(grid, 14, 5, 15, WallType::Concrete);
+    LineOfSightRelevancy relevancy;
+    
+    // Visible above the wall at tick 1
+    relevancy.beginTick();
+    ASSERT_TRUE(relevancy.isRelevant(grid, 0, 1050.0f, 300.0f, 1, 1950.0f, 300.0f, 1, GRACE_TICKS));
+    
+    // Steps behind the wall: still sent until the grace window runs out
+    for (uint32_t tick = 2; tick <= 1 + GRACE_TICKS; ++tick) {
+        relevancy.beginTick();
+        ASSERT_TRUE(relevancy.isRelevant(grid, 0, 1050.0f, 1050.0f, 1, 1950.0f, 1050.0f, tick, GRACE_TICKS));
+    }
+    relevancy.beginTick();
+    ASSERT_TRUE(!relevancy.isRelevant(grid, 0, 1050.0f, 1050.0f, 1, 1950.0f, 1050.0f, 2 + GRACE_TICKS, GRACE_TICKS));
+}
+
+TEST(ReappearingPlayerIsSentImmediately) {
+    Grid grid = emptyGrid();
+    verticalWall(grid, 14, 5, 15, WallType::Concrete);
+    LineOfSightRelevancy relevancy;
+    relevancy.beginTick();
+    ASSERT_TRUE(!relevancy.isRelevant(grid, 0, 1050.0f, 1050.0f, 1, 1950.0f, 1050.0f, 100, GRACE_TICKS));
+    relevancy.beginTick();
+    ASSERT_TRUE(relevancy.isRelevant(grid, 0, 1050.0f, 1050.0f, 1, 1050.0f, 1900.0f, 101, GRACE_TICKS));
+}
+
+TEST(StillPairsAreNotRetraced) {
+    Grid grid = emptyGrid();
+    verticalWall(grid, 14, 5, 15, WallType::Concrete);
+    LineOfSightRelevancy relevancy;
+    relevancy.beginTick();
+    relevancy.isRelevant(grid, 0, 1050.0f, 1050.0f, 1, 1950.0f, 1050.0f, 1, GRACE_TICKS);
+    ASSERT_EQ(3, relevancy.raysThisTick());
+    
+    // Moving inside the same recheck square reuses the cached result
+    relevancy.beginTick();
+    ASSERT_TRUE(!relevancy.isRelevant(grid, 0, 1052.0f, 1058.0f, 1, 1953.0f, 1061.0f, 2, 0));
+    ASSERT_EQ(0, relevancy.raysThisTick());
+    
+    // Crossing into another square traces again
+    relevancy.beginTick();
+    relevancy.isRelevant(grid, 0, 1050.0f, 1050.0f, 1, 1950.0f, 1090.0f, 3, 0);
+    ASSERT_TRUE(relevancy.raysThisTick() > 0);
+}
+
+TEST(LeavingPlayerIsForgotten) {
+    Grid grid = emptyGrid();
+    verticalWall(grid, 14, 5, 15, WallType::Concrete);
+    LineOfSightRelevancy relevancy;
+    
+    // Players 0 and 1 see each other at tick 1, then 1 leaves
+    relevancy.beginTick();
+    ASSERT_TRUE(relevancy.isRelevant(grid, 0, 1050.0f, 300.0f, 1, 1950.0f, 300.0f, 1, GRACE_TICKS));
+    ASSERT_TRUE(relevancy.isRelevant(grid, 1, 1950.0f, 300.0f, 0, 1050.0f, 300.0f, 1, GRACE_TICKS));
+    relevancy.forgetPlayer(1);
+    
+    // A new player 1 joins behind the wall: no grace window inherited from the old one
+    relevancy.beginTick();
+    ASSERT_TRUE(!relevancy.isRelevant(grid, 0, 1050.0f, 1050.0f, 1, 1950.0f, 1050.0f, 2, GRACE_TICKS));
+    ASSERT_TRUE(!relevancy.isRelevant(grid, 1, 1950.0f, 1050.0f, 0, 1050.0f, 1050.0f, 2, GRACE_TICKS));
+    
+    // Cached traces are dropped too: the same positions are traced again
+    relevancy.forgetPlayer(1);
+    relevancy.beginTick();
+    ASSERT_TRUE(!relevancy.isRelevant(grid, 0, 1050.0f, 1050.0f, 1, 1950.0f, 1050.0f, 3, 0));
+    ASSERT_EQ(3, relevancy.raysThisTick());
+    
+    // Pairs without the player keep their state
+    relevancy.beginTick();
+    relevancy.isRelevant(grid, 2, 1050.0f, 1050.0f, 3, 1950.0f, 1050.0f, 4, 0);
+    relevancy.forgetPlayer(1);
+    relevancy.beginTick();
+    relevancy.isRelevant(grid, 2, 1050.0f, 1050.0f, 3, 1950.0f, 1050.0f, 5, 0);
+    ASSERT_EQ(0, relevancy.raysThisTick());
+}
+
+TEST(BudgetLimitsTracesPerTick) {
+    Grid grid = emptyGrid();
+    LineOfSightRelevancy relevancy;
+    relevancy.beginTick();
+    int pairs = 0;
+    for (uint32_t viewer = 0; viewer < MAX_PLAYERS; ++viewer) {
+        for (uint32_t target = 0; target < MAX_PLAYERS; ++target) {
+            if (viewer == target) continue;
+            // Never traced pairs over the budget count as visible
+            ASSERT_TRUE(relevancy.isRelevant(grid, viewer, 100.0f + viewer * 30.0f, 500.0f,
+                                             target, 100.0f + target * 30.0f, 900.0f, 1, GRACE_TICKS));
+            pairs++;
+        }
+    }
+    ASSERT_TRUE(pairs > LOS_MAX_PAIR_CHECKS_PER_TICK);
+    ASSERT_EQ(LOS_MAX_PAIR_CHECKS_PER_TICK, relevancy.raysThisTick());
+}
+
+// ========================
+// Benchmark
+// ========================
+
+// Players wander on a generated map; every snapshot tick each player checks
+// every other player within the culling radius
+void benchmarkRelevancy(int playerCount) {
+    const int TICKS = 200;
+    const float CULLING_RADIUS = 1500.0f;
+    const float SPEED = 15.0f;  // px per 20 Hz snapshot tick (5 px per 60 Hz step, 3/4 of players move)
+    Grid grid = emptyGrid();
+    generateMap(grid, 42);
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> posDist(100.0f, MAP_SIZE - 100.0f);
+    std::uniform_real_distribution<float> angleDist(0.0f, 6.2831853f);
+    
+    std::vector<float> xs(playerCount), ys(playerCount), dirs(playerCount);
+    for (int p = 0; p < playerCount; ++p) {
+        xs[p] = posDist(gen);
+        ys[p] = posDist(gen);
+        dirs[p] = angleDist(gen);
+    }
+    // Record the trajectories first so both variants replay the same ticks
+    std::vector<float> frames;
+    for (int tick = 0; tick < TICKS; ++tick) {
+        for (int p = 0; p < playerCount; ++p) {
+            if (p % 4 != 0) {
+                if (gen() % 20 == 0) dirs[p] = angleDist(gen);
+                xs[p] = std::min(MAP_SIZE - 50.0f, std::max(50.0f, xs[p] + std::cos(dirs[p]) * SPEED));
+                ys[p] = std::min(MAP_SIZE - 50.0f, std::max(50.0f, ys[p] + std::sin(dirs[p]) * SPEED));
+            }
+            frames.push_back(xs[p]);
+            frames.push_back(ys[p]);
+        }
+    }
+    
+    size_t candidates = 0;
+    size_t occluded = 0;
+    long long cachedRays = 0;
+    LineOfSightRelevancy relevancy;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int tick = 0; tick < TICKS; ++tick) {
+        const float* f = &frames[tick * playerCount * 2];
+        relevancy.beginTick();
+        for (int v = 0; v < playerCount; ++v) {
+            for (int t = 0; t < playerCount; ++t) {
+                if (v == t) continue;
+                float dx = f[t * 2] - f[v * 2];
+                float dy = f[t * 2 + 1] - f[v * 2 + 1];
+                if (dx * dx + dy * dy > CULLING_RADIUS * CULLING_RADIUS) continue;
+                candidates++;
+                if (!relevancy.isRelevant(grid, v, f[v * 2], f[v * 2 + 1], t, f[t * 2], f[t * 2 + 1],
+                                          tick, 10)) {
+                    occluded++;
+                }
+            }
+        }
+        cachedRays += relevancy.raysThisTick();
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    
+    long long uncachedRays = 0;
+    size_t uncachedOccluded = 0;
+    for (int tick = 0; tick < TICKS; ++tick) {
+        const float* f = &frames[tick * playerCount * 2];
+        for (int v = 0; v < playerCount; ++v) {
+            for (int t = 0; t < playerCount; ++t) {
+                if (v == t) continue;
+                float dx = f[t * 2] - f[v * 2];
+                float dy = f[t * 2 + 1] - f[v * 2 + 1];
+                if (dx * dx + dy * dy > CULLING_RADIUS * CULLING_RADIUS) continue;
+                int rays = 0;
+                if (!targetVisible(grid, f[v * 2], f[v * 2 + 1], f[t * 2], f[t * 2 + 1], rays)) {
+                    uncachedOccluded++;
+                }
+                uncachedRays += rays;
+            }
+        }
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    
+    double cachedUs = std::chrono::duration<double, std::micro>(t1 - t0).count() / TICKS;
+    double uncachedUs = std::chrono::duration<double, std::micro>(t2 - t1).count() / TICKS;
+    std::cout << std::setw(8) << playerCount
+              << std::setw(12) << candidates / TICKS
+              << std::setw(10) << std::fixed << std::setprecision(1)
+              << (candidates ? 100.0 * occluded / candidates : 0.0) << "%"
+              << std::setw(12) << uncachedRays / TICKS
+              << std::setw(12) << cachedRays / TICKS
+              << std::setw(14) << std::setprecision(1) << uncachedUs
+              << std::setw(14) << cachedUs
+              << std::endl;
+    (void)uncachedOccluded;
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Zero Ground Line-of-Sight Relevancy Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "--- Line-of-Sight Tests ---" << std::endl;
+    RUN_TEST(OpenFieldIsVisible);
+    RUN_TEST(ConcreteWallOccludes);
+    RUN_TEST(WoodWallDoesNotOcclude);
+    RUN_TEST(PeekingAroundCornerIsVisible);
+    RUN_TEST(HiddenPlayerKeptForGraceWindow);
+    RUN_TEST(ReappearingPlayerIsSentImmediately);
+    RUN_TEST(StillPairsAreNotRetraced);
+    RUN_TEST(LeavingPlayerIsForgotten);
+    RUN_TEST(BudgetLimitsTracesPerTick);
+
+    std::cout << std::endl;
+    std::cout << "--- Cost per Snapshot Tick (200 ticks, culling radius 1500) ---" << std::endl;
+    std::cout << std::setw(8) << "Players" << std::setw(12) << "In range" << std::setw(11) << "Occluded"
+              << std::setw(12) << "Rays (raw)" << std::setw(12) << "Rays (LOS)"
+              << std::setw(14) << "Raw (us)" << std::setw(14) << "Cached (us)" << std::endl;
+    for (int playerCount : { 16, 32, 64 }) {
+        benchmarkRelevancy(playerCount);
+    }
+
+    // Print summary
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Test Summary" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Total tests: " << totalTests << std::endl;
+    std::cout << "Passed: " << passedTests << std::endl;
+    std::cout << "Failed: " << failedTests << std::endl;
+    std::cout << std::endl;
+
+    if (failedTests == 0) {
+        std::cout << "✓ All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "✗ Some tests failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,920 @@
+// Packet Batch Tests and Benchmark for Zero Ground
+// Builds wire protocol datagrams with DatagramBuilder, validates and dispatches
+// them with the table-driven decodeDatagram, counts datagrams and wire bytes
+// per client against the previous one-raw-struct-per-datagram sends, and times
+// decoding per message.
+//
+// The wire protocol is copied from Zero_Ground.cpp (identical in the client).
+// Build with /O2 (or -O2).
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+
+// ========================
+// Test Framework Macros
+// ========================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "Running test: " << #name << "..."; \
+    try { \
+        test_##name(); \
+        std::cout << " PASSED" << std::endl; \
+        passedTests++; \
+    } catch (const std::exception& e) { \
+        std::cout << " FAILED: " << e.what() << std::endl; \
+        failedTests++; \
+    } \
+    totalTests++; \
+} while(0)
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: " << #condition << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_NEAR(expected, actual, epsilon) do { \
+    if (std::abs((expected) - (actual)) > (epsilon)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << (expected) << " but got " << (actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(expected, actual) do { \
+    if ((expected) != (actual)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << static_cast<int>(expected) << " but got " << static_cast<int>(actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+// Test counters
+int totalTests = 0;
+int passedTests = 0;
+int failedTests = 0;
+
+// ========================
+// Code Under Test (copied from main code)
+// ========================
+
+// Packets carried in batches (identical in server and client)
+struct ShotPacket {
+    uint8_t playerId;
+    float x, y;          // Shot origin position
+    float dirX, dirY;    // Normalized direction vector
+    uint8_t weaponType;  // Weapon::Type enum value
+    float bulletSpeed;   // Bullet speed for this weapon
+    float damage;        // Damage for this weapon
+    float range;         // Range for this weapon
+    uint32_t viewTick;   // Tick of the latest server snapshot the shooter had (lag compensation)
+};
+
+struct HitPacket {
+    uint8_t shooterId;   // Player who fired the bullet
+    uint8_t victimId;    // Player who was hit
+    float damage;        // Damage dealt
+    float hitX, hitY;    // Position where hit occurred
+    bool wasKill;        // True if this hit killed the victim
+};
+
+const size_t MAX_SNAPSHOT_BYTES = 1192;         // Leaves room for the wire headers in one datagram
+
+// PositionPacket as in the main code
+struct PositionPacket {
+    float x = 0.0f;
+    float y = 0.0f;
+    float rotation = 0.0f;  // Player rotation angle in degrees
+    float health = 100.0f;
+    bool isAlive = true;
+    uint32_t frameID = 0;
+    uint8_t playerId = 0;
+    uint32_t ackTick = 0xFFFFFFFF;  // Client -> server: newest snapshot tick received (NO_SNAPSHOT_ACK = none)
+};
+
+const uint8_t WIRE_VERSION = 2;                 // Version 1 sent raw structs told apart by size
+const size_t WIRE_HEADER_BYTES = 5;
+const size_t WIRE_MESSAGE_HEADER_BYTES = 3;
+const size_t MAX_DATAGRAM_BYTES = 1200;         // Stays below a typical 1500 byte MTU
+static_assert(MAX_SNAPSHOT_BYTES + WIRE_HEADER_BYTES + WIRE_MESSAGE_HEADER_BYTES <= MAX_DATAGRAM_BYTES,
+              "A full snapshot must fit in one datagram");
+
+enum class WireMessageType : uint8_t {
+    Position = 1,  // Client -> server: PositionPacket
+    Shot = 2,      // Both directions: ShotPacket
+    Hit = 3,       // Server -> client: HitPacket
+    Snapshot = 4   // Server -> client: writeSnapshot() payload
+};
+const size_t WIRE_MESSAGE_TYPE_COUNT = 5;       // Type 0 is never valid
+
+// Little-endian field access; payloads are unaligned, so go through bytes
+inline void storeU16(uint8_t* p, uint16_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+}
+
+inline void storeU32(uint8_t* p, uint32_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+    p[2] = static_cast<uint8_t>(value >> 16);
+    p[3] = static_cast<uint8_t>(value >> 24);
+}
+
+inline void storeF32(uint8_t* p, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    storeU32(p, bits);
+}
+
+inline uint16_t loadU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t loadU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline float loadF32(const uint8_t* p) {
+    uint32_t bits = loadU32(p);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// ------------------------
+// Position Message
+// ------------------------
+// playerId:8, x:f32, y:f32, rotation:f32, health:f32, isAlive:8, frameID:32, ackTick:32
+
+const size_t POSITION_MESSAGE_BYTES = 26;
+
+void writePositionMessage(uint8_t* out, const PositionPacket& packet) {
+    out[0] = packet.playerId;
+    storeF32(out + 1, packet.x);
+    storeF32(out + 5, packet.y);
+    storeF32(out + 9, packet.rotation);
+    storeF32(out + 13, packet.health);
+    out[17] = packet.isAlive ? 1 : 0;
+    storeU32(out + 18, packet.frameID);
+    storeU32(out + 22, packet.ackTick);
+}
+
+// Reads a validated position payload in place (no copy)
+class PositionMessageView {
+public:
+    explicit PositionMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint8_t playerId() const { return p_[0]; }
+    float x() const { return loadF32(p_ + 1); }
+    float y() const { return loadF32(p_ + 5); }
+    float rotation() const { return loadF32(p_ + 9); }
+    float health() const { return loadF32(p_ + 13); }
+    bool isAlive() const { return p_[17] != 0; }
+    uint32_t frameID() const { return loadU32(p_ + 18); }
+    uint32_t ackTick() const { return loadU32(p_ + 22); }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Shot Message
+// ------------------------
+// playerId:8, x:f32, y:f32, dirX:f32, dirY:f32, weaponType:8,
+// bulletSpeed:f32, damage:f32, range:f32, viewTick:32
+
+const size_t SHOT_MESSAGE_BYTES = 34;
+
+void writeShotMessage(uint8_t* out, const ShotPacket& packet) {
+    out[0] = packet.playerId;
+    storeF32(out + 1, packet.x);
+    storeF32(out + 5, packet.y);
+    storeF32(out + 9, packet.dirX);
+    storeF32(out + 13, packet.dirY);
+    out[17] = packet.weaponType;
+    storeF32(out + 18, packet.bulletSpeed);
+    storeF32(out + 22, packet.damage);
+    storeF32(out + 26, packet.range);
+    storeU32(out + 30, packet.viewTick);
+}
+
+// Reads a validated shot payload in place (no copy)
+class ShotMessageView {
+public:
+    explicit ShotMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint8_t playerId() const { return p_[0]; }
+    float x() const { return loadF32(p_ + 1); }
+    float y() const { return loadF32(p_ + 5); }
+    float dirX() const { return loadF32(p_ + 9); }
+    float dirY() const { return loadF32(p_ + 13); }
+    uint8_t weaponType() const { return p_[17]; }
+    float bulletSpeed() const { return loadF32(p_ + 18); }
+    float damage() const { return loadF32(p_ + 22); }
+    float range() const { return loadF32(p_ + 26); }
+    uint32_t viewTick() const { return loadU32(p_ + 30); }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Hit Message
+// ------------------------
+// shooterId:8, victimId:8, damage:f32, hitX:f32, hitY:f32, wasKill:8
+
+const size_t HIT_MESSAGE_BYTES = 15;
+
+void writeHitMessage(uint8_t* out, const HitPacket& packet) {
+    out[0] = packet.shooterId;
+    out[1] = packet.victimId;
+    storeF32(out + 2, packet.damage);
+    storeF32(out + 6, packet.hitX);
+    storeF32(out + 10, packet.hitY);
+    out[14] = packet.wasKill ? 1 : 0;
+}
+
+// Reads a validated hit payload in place (no copy)
+class HitMessageView {
+public:
+    explicit HitMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint8_t shooterId() const { return p_[0]; }
+    uint8_t victimId() const { return p_[1]; }
+    float damage() const { return loadF32(p_ + 2); }
+    float hitX() const { return loadF32(p_ + 6); }
+    float hitY() const { return loadF32(p_ + 10); }
+    bool wasKill() const { return p_[14] != 0; }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Decoding
+// ------------------------
+
+// Allowed payload length per message type, indexed by WireMessageType
+struct WireMessageSpec {
+    const char* name;
+    size_t minLength;
+    size_t maxLength;
+};
+
+const WireMessageSpec WIRE_MESSAGE_SPECS[WIRE_MESSAGE_TYPE_COUNT] = {
+    { "invalid", 1, 0 },  // Empty range: never accepted
+    { "position", POSITION_MESSAGE_BYTES, POSITION_MESSAGE_BYTES },
+    { "shot", SHOT_MESSAGE_BYTES, SHOT_MESSAGE_BYTES },
+    { "hit", HIT_MESSAGE_BYTES, HIT_MESSAGE_BYTES },
+    { "snapshot", 1, MAX_SNAPSHOT_BYTES }
+};
+
+enum class WireStatus {
+    Ok,
+    Truncated,    // Header or message runs past the end of the datagram
+    BadVersion,   // Sender speaks another protocol version
+    UnknownType,  // Type not in the table or not accepted by this receiver
+    BadLength     // Payload length outside the type's allowed range
+};
+
+// Message handler: payload points into the receive buffer and has been bounds-checked
+template <typename Context>
+using WireHandler = void (*)(const uint8_t* payload, size_t length, Context& context);
+
+// Read the datagram header
+// Returns: Ok and the sequence, or why the datagram was rejected
+inline WireStatus readWireHeader(const uint8_t* data, size_t size, uint32_t& sequence) {
+    if (size < WIRE_HEADER_BYTES) {
+        return WireStatus::Truncated;
+    }
+    if (data[0] != WIRE_VERSION) {
+        return WireStatus::BadVersion;
+    }
+    sequence = loadU32(data + 1);
+    return WireStatus::Ok;
+}
+
+// Validate a whole datagram in place, then dispatch each message to handlers[type]
+// Parameters:
+//   data, size - The received datagram (never copied)
+//   handlers - Handler per WireMessageType; null rejects that type
+//   context - Passed through to the handlers
+//   sequence - Receives the datagram sequence number
+// Returns: Ok if every message was dispatched; otherwise nothing was dispatched
+//
+// PERFORMANCE:
+// Type lookup is an array index and each message is checked once against the
+// spec table, so decoding is O(1) per message with no allocation. Validating
+// the whole datagram before dispatching means a malformed tail can't leave a
+// half-applied datagram behind.
+template <typename Context>
+WireStatus decodeDatagram(const uint8_t* data, size_t size, const WireHandler<Context>* handlers,
+                          Context& context, uint32_t& sequence) {
+    WireStatus status = readWireHeader(data, size, sequence);
+    if (status != WireStatus::Ok) {
+        return status;
+    }
+    
+    // Pass 1: bounds and type checks
+    size_t pos = WIRE_HEADER_BYTES;
+    while (pos < size) {
+        if (size - pos < WIRE_MESSAGE_HEADER_BYTES) {
+            return WireStatus::Truncated;
+        }
+        uint8_t type = data[pos];
+        size_t length = loadU16(data + pos + 1);
+        if (type >= WIRE_MESSAGE_TYPE_COUNT || handlers[type] == nullptr) {
+            return WireStatus::UnknownType;
+        }
+        if (length < WIRE_MESSAGE_SPECS[type].minLength || length > WIRE_MESSAGE_SPECS[type].maxLength) {
+            return WireStatus::BadLength;
+        }
+        pos += WIRE_MESSAGE_HEADER_BYTES;
+        if (size - pos < length) {
+            return WireStatus::Truncated;
+        }
+        pos += length;
+    }
+    
+    // Pass 2: dispatch
+    pos = WIRE_HEADER_BYTES;
+    while (pos < size) {
+        uint8_t type = data[pos];
+        size_t length = loadU16(data + pos + 1);
+        pos += WIRE_MESSAGE_HEADER_BYTES;
+        handlers[type](data + pos, length, context);
+        pos += length;
+    }
+    return WireStatus::Ok;
+}
+
+inline const char* wireStatusName(WireStatus status) {
+    switch (status) {
+        case WireStatus::Ok: return "ok";
+        case WireStatus::Truncated: return "truncated";
+        case WireStatus::BadVersion: return "wrong protocol version";
+        case WireStatus::UnknownType: return "unexpected message type";
+        case WireStatus::BadLength: return "bad message length";
+    }
+    return "unknown";
+}
+
+// ------------------------
+// Encoding
+// ------------------------
+
+// Builds the datagrams for one recipient
+// Completed datagrams are handed to the sink (data, size, message count);
+// call flush() once all messages have been appended.
+class DatagramBuilder {
+public:
+    using Sink = std::function<void(const uint8_t*, size_t, size_t)>;
+    
+    // firstSequence - Sequence number of the first datagram this builder sends
+    DatagramBuilder(Sink sink, uint32_t firstSequence)
+        : sink_(std::move(sink)), nextSequence_(firstSequence) {
+        buffer_[0] = WIRE_VERSION;
+    }
+    
+    // Reserve room for one message, flushing the current datagram first if it would not fit
+    // Returns: where to write the payload (exactly length bytes), or null if the
+    // message is too large for any datagram
+    uint8_t* reserve(WireMessageType type, size_t length) {
+        const size_t needed = WIRE_MESSAGE_HEADER_BYTES + length;
+        if (WIRE_HEADER_BYTES + needed > MAX_DATAGRAM_BYTES) {
+            return nullptr;
+        }
+        if (used_ + needed > MAX_DATAGRAM_BYTES) {
+            flush();
+        }
+        
+        buffer_[used_] = static_cast<uint8_t>(type);
+        storeU16(buffer_ + used_ + 1, static_cast<uint16_t>(length));
+        uint8_t* payload = buffer_ + used_ + WIRE_MESSAGE_HEADER_BYTES;
+        used_ += needed;
+        messageCount_++;
+        return payload;
+    }
+    
+    // Append a pre-encoded payload (e.g. a snapshot)
+    bool append(WireMessageType type, const uint8_t* payload, size_t length) {
+        uint8_t* out = reserve(type, length);
+        if (out == nullptr) {
+            return false;
+        }
+        std::memcpy(out, payload, length);
+        return true;
+    }
+    
+    bool appendPosition(const PositionPacket& packet) {
+        uint8_t* out = reserve(WireMessageType::Position, POSITION_MESSAGE_BYTES);
+        if (out) writePositionMessage(out, packet);
+        return out != nullptr;
+    }
+    
+    bool appendShot(const ShotPacket& packet) {
+        uint8_t* out = reserve(WireMessageType::Shot, SHOT_MESSAGE_BYTES);
+        if (out) writeShotMessage(out, packet);
+        return out != nullptr;
+    }
+    
+    bool appendHit(const HitPacket& packet) {
+        uint8_t* out = reserve(WireMessageType::Hit, HIT_MESSAGE_BYTES);
+        if (out) writeHitMessage(out, packet);
+        return out != nullptr;
+    }
+    
+    // Hand the pending datagram to the sink (no-op when nothing is pending)
+    void flush() {
+        if (messageCount_ == 0) {
+            return;
+        }
+        storeU32(buffer_ + 1, nextSequence_++);
+        sink_(buffer_, used_, messageCount_);
+        datagramsSent_++;
+        used_ = WIRE_HEADER_BYTES;
+        messageCount_ = 0;
+    }
+    
+    size_t datagramsSent() const { return datagramsSent_; }
+    
+    // Sequence number the next datagram will carry
+    uint32_t nextSequence() const { return nextSequence_; }
+    
+private:
+    Sink sink_;
+    uint8_t buffer_[MAX_DATAGRAM_BYTES];
+    size_t used_ = WIRE_HEADER_BYTES;
+    size_t messageCount_ = 0;
+    size_t datagramsSent_ = 0;
+    uint32_t nextSequence_;
+};
+
+// ========================
+// Test Helpers
+// ========================
+
+// Captures what a DatagramBuilder would have sent
+struct CapturedDatagrams {
+    std::vector<std::vector<uint8_t>> datagrams;
+    std::vector<size_t> messageCounts;
+    
+    DatagramBuilder::Sink sink() {
+        return [this](const uint8_t* data, size_t size, size_t messageCount) {
+            datagrams.emplace_back(data, data + size);
+            messageCounts.push_back(messageCount);
+        };
+    }
+};
+
+// Records every dispatched message (payload pointers stay in the datagram)
+struct RecordingContext {
+    std::vector<WireMessageType> types;
+    std::vector<const uint8_t*> payloads;
+    std::vector<size_t> lengths;
+};
+
+void recordMessage(WireMessageType type, const uint8_t* payload, size_t length, RecordingContext& context) {
+    context.types.push_back(type);
+    context.payloads.push_back(payload);
+    context.lengths.push_back(length);
+}
+
+void recordPosition(const uint8_t* payload, size_t length, RecordingContext& context) {
+    recordMessage(WireMessageType::Position, payload, length, context);
+}
+void recordShot(const uint8_t* payload, size_t length, RecordingContext& context) {
+    recordMessage(WireMessageType::Shot, payload, length, context);
+}
+void recordHit(const uint8_t* payload, size_t length, RecordingContext& context) {
+    recordMessage(WireMessageType::Hit, payload, length, context);
+}
+void recordSnapshot(const uint8_t* payload, size_t length, RecordingContext& context) {
+    recordMessage(WireMessageType::Snapshot, payload, length, context);
+}
+
+// Server -> client table (as in Zero_Ground_client.cpp)
+const WireHandler<RecordingContext> CLIENT_HANDLERS[WIRE_MESSAGE_TYPE_COUNT] = {
+    nullptr, nullptr, recordShot, recordHit, recordSnapshot
+};
+
+// Client -> server table (as in Zero_Ground.cpp)
+const WireHandler<RecordingContext> SERVER_HANDLERS[WIRE_MESSAGE_TYPE_COUNT] = {
+    nullptr, recordPosition, recordShot, nullptr, nullptr
+};
+
+ShotPacket makeShot(uint8_t playerId, float x) {
+    ShotPacket shot{};
+    shot.playerId = playerId;
+    shot.x = x;
+    shot.y = x * 0.5f;
+    shot.dirX = 0.6f;
+    shot.dirY = -0.8f;
+    shot.weaponType = 2;
+    shot.bulletSpeed = 1500.0f;
+    shot.damage = 25.0f;
+    shot.range = 800.0f;
+    shot.viewTick = 0x12345678;
+    return shot;
+}
+
+HitPacket makeHit(uint8_t shooterId, uint8_t victimId) {
+    HitPacket hit{};
+    hit.shooterId = shooterId;
+    hit.victimId = victimId;
+    hit.damage = 25.0f;
+    hit.hitX = 100.0f;
+    hit.hitY = 200.0f;
+    hit.wasKill = true;
+    return hit;
+}
+
+// ========================
+// Tests
+// ========================
+
+// A tick's snapshot, shots and hits leave as one datagram and decode in order
+TEST(OneDatagramPerTick) {
+    CapturedDatagrams captured;
+    DatagramBuilder builder(captured.sink(), 7);
+    
+    std::vector<uint8_t> snapshot(300, 0xAB);
+    ASSERT_TRUE(builder.append(WireMessageType::Snapshot, snapshot.data(), snapshot.size()));
+    ASSERT_TRUE(builder.appendShot(makeShot(3, 1000.0f)));
+    ASSERT_TRUE(builder.appendHit(makeHit(3, 7)));
+    builder.flush();
+    
+    ASSERT_EQ(1, captured.datagrams.size());
+    ASSERT_EQ(3, captured.messageCounts[0]);
+    ASSERT_EQ(WIRE_HEADER_BYTES + 3 * WIRE_MESSAGE_HEADER_BYTES + snapshot.size() + SHOT_MESSAGE_BYTES +
+              HIT_MESSAGE_BYTES, captured.datagrams[0].size());
+    ASSERT_EQ(WIRE_VERSION, captured.datagrams[0][0]);
+    
+    const std::vector<uint8_t>& datagram = captured.datagrams[0];
+    RecordingContext context;
+    uint32_t sequence = 0;
+    ASSERT_TRUE(decodeDatagram(datagram.data(), datagram.size(), CLIENT_HANDLERS, context, sequence) ==
+                WireStatus::Ok);
+    ASSERT_EQ(7, sequence);
+    ASSERT_EQ(3, context.types.size());
+    ASSERT_TRUE(context.types[0] == WireMessageType::Snapshot);
+    ASSERT_TRUE(std::memcmp(context.payloads[0], snapshot.data(), snapshot.size()) == 0);
+    ASSERT_TRUE(context.types[1] == WireMessageType::Shot);
+    ASSERT_TRUE(context.types[2] == WireMessageType::Hit);
+    
+    // Payloads are read in place, inside the receive buffer
+    for (const uint8_t* payload : context.payloads) {
+        ASSERT_TRUE(payload > datagram.data() && payload < datagram.data() + datagram.size());
+    }
+    
+    HitMessageView hit(context.payloads[2]);
+    ASSERT_EQ(3, hit.shooterId());
+    ASSERT_EQ(7, hit.victimId());
+    ASSERT_NEAR(200.0f, hit.hitY(), 0.0f);
+    ASSERT_TRUE(hit.wasKill());
+}
+
+// Explicit layouts: every field round-trips bit-exactly and the wire sizes do
+// not depend on struct padding
+TEST(MessageLayoutsRoundTrip) {
+    ASSERT_TRUE(sizeof(ShotPacket) != SHOT_MESSAGE_BYTES);  // Padding never reaches the wire
+    
+    PositionPacket position;
+    position.x = 1234.5f;
+    position.y = 4321.25f;
+    position.rotation = -90.5f;
+    position.health = 37.0f;
+    position.isAlive = false;
+    position.frameID = 0xA1B2C3D4;
+    position.playerId = 63;
+    position.ackTick = 0xFFFFFFFF;
+    uint8_t positionBytes[POSITION_MESSAGE_BYTES];
+    writePositionMessage(positionBytes, position);
+    PositionMessageView positionView(positionBytes);
+    ASSERT_EQ(63, positionView.playerId());
+    ASSERT_NEAR(1234.5f, positionView.x(), 0.0f);
+    ASSERT_NEAR(4321.25f, positionView.y(), 0.0f);
+    ASSERT_NEAR(-90.5f, positionView.rotation(), 0.0f);
+    ASSERT_NEAR(37.0f, positionView.health(), 0.0f);
+    ASSERT_TRUE(!positionView.isAlive());
+    ASSERT_TRUE(positionView.frameID() == 0xA1B2C3D4);
+    ASSERT_TRUE(positionView.ackTick() == 0xFFFFFFFF);
+    
+    // Little-endian regardless of the host
+    ASSERT_EQ(0xD4, positionBytes[18]);
+    ASSERT_EQ(0xA1, positionBytes[21]);
+    
+    ShotPacket shot = makeShot(5, 2500.75f);
+    uint8_t shotBytes[SHOT_MESSAGE_BYTES];
+    writeShotMessage(shotBytes, shot);
+    ShotMessageView shotView(shotBytes);
+    ASSERT_EQ(5, shotView.playerId());
+    ASSERT_NEAR(2500.75f, shotView.x(), 0.0f);
+    ASSERT_NEAR(1250.375f, shotView.y(), 0.0f);
+    ASSERT_NEAR(0.6f, shotView.dirX(), 0.0f);
+    ASSERT_NEAR(-0.8f, shotView.dirY(), 0.0f);
+    ASSERT_EQ(2, shotView.weaponType());
+    ASSERT_NEAR(1500.0f, shotView.bulletSpeed(), 0.0f);
+    ASSERT_NEAR(25.0f, shotView.damage(), 0.0f);
+    ASSERT_NEAR(800.0f, shotView.range(), 0.0f);
+    ASSERT_TRUE(shotView.viewTick() == 0x12345678);
+    
+    HitPacket hit = makeHit(9, 10);
+    hit.wasKill = false;
+    uint8_t hitBytes[HIT_MESSAGE_BYTES];
+    writeHitMessage(hitBytes, hit);
+    HitMessageView hitView(hitBytes);
+    ASSERT_EQ(9, hitView.shooterId());
+    ASSERT_EQ(10, hitView.victimId());
+    ASSERT_NEAR(25.0f, hitView.damage(), 0.0f);
+    ASSERT_NEAR(100.0f, hitView.hitX(), 0.0f);
+    ASSERT_TRUE(!hitView.wasKill());
+}
+
+// Nothing pending: flush sends nothing and does not use up a sequence number
+TEST(EmptyFlushSendsNothing) {
+    CapturedDatagrams captured;
+    DatagramBuilder builder(captured.sink(), 100);
+    builder.flush();
+    builder.flush();
+    ASSERT_EQ(0, captured.datagrams.size());
+    ASSERT_EQ(0, builder.datagramsSent());
+    ASSERT_EQ(100, builder.nextSequence());
+}
+
+// Too many messages for one MTU: split between messages, never inside one,
+// with consecutive sequence numbers
+TEST(OverflowStartsNewDatagram) {
+    CapturedDatagrams captured;
+    DatagramBuilder builder(captured.sink(), 0);
+    
+    const int shotCount = 200;
+    for (int i = 0; i < shotCount; ++i) {
+        ASSERT_TRUE(builder.appendShot(makeShot(static_cast<uint8_t>(i % 64), static_cast<float>(i))));
+    }
+    builder.flush();
+    
+    const size_t perMessage = WIRE_MESSAGE_HEADER_BYTES + SHOT_MESSAGE_BYTES;
+    const size_t perDatagram = (MAX_DATAGRAM_BYTES - WIRE_HEADER_BYTES) / perMessage;
+    const size_t expectedDatagrams = (shotCount + perDatagram - 1) / perDatagram;
+    ASSERT_EQ(expectedDatagrams, captured.datagrams.size());
+    ASSERT_EQ(expectedDatagrams, builder.nextSequence());
+    
+    // Every shot arrives exactly once and in order
+    int next = 0;
+    for (size_t i = 0; i < captured.datagrams.size(); ++i) {
+        const std::vector<uint8_t>& datagram = captured.datagrams[i];
+        ASSERT_TRUE(datagram.size() <= MAX_DATAGRAM_BYTES);
+        
+        RecordingContext context;
+        uint32_t sequence = 0;
+        ASSERT_TRUE(decodeDatagram(datagram.data(), datagram.size(), SERVER_HANDLERS, context, sequence) ==
+                    WireStatus::Ok);
+        ASSERT_EQ(i, sequence);
+        for (const uint8_t* payload : context.payloads) {
+            ASSERT_NEAR(static_cast<float>(next), ShotMessageView(payload).x(), 0.0f);
+            next++;
+        }
+    }
+    ASSERT_EQ(shotCount, next);
+}
+
+// A maximum size snapshot always fits; anything larger than a datagram is refused
+TEST(MessageSizeLimits) {
+    CapturedDatagrams captured;
+    DatagramBuilder builder(captured.sink(), 0);
+    
+    // A shot first, then a full snapshot: the snapshot moves to a second datagram
+    std::vector<uint8_t> snapshot(MAX_SNAPSHOT_BYTES, 0x5A);
+    ASSERT_TRUE(builder.appendShot(makeShot(1, 10.0f)));
+    ASSERT_TRUE(builder.append(WireMessageType::Snapshot, snapshot.data(), snapshot.size()));
+    builder.flush();
+    ASSERT_EQ(2, captured.datagrams.size());
+    ASSERT_TRUE(captured.datagrams[1].size() <= MAX_DATAGRAM_BYTES);
+    
+    std::vector<uint8_t> oversized(MAX_DATAGRAM_BYTES, 0);
+    ASSERT_TRUE(!builder.append(WireMessageType::Snapshot, oversized.data(), oversized.size()));
+    builder.flush();
+    ASSERT_EQ(2, captured.datagrams.size());
+}
+
+// Malformed datagrams are rejected as a whole: no handler runs
+TEST(MalformedDatagramsRejected) {
+    CapturedDatagrams captured;
+    DatagramBuilder builder(captured.sink(), 0);
+    ASSERT_TRUE(builder.appendShot(makeShot(1, 10.0f)));
+    ASSERT_TRUE(builder.appendHit(makeHit(1, 2)));
+    builder.flush();
+    const std::vector<uint8_t> good = captured.datagrams[0];
+    
+    auto decode = [](const std::vector<uint8_t>& datagram, size_t size, RecordingContext& context) {
+        uint32_t sequence = 0;
+        return decodeDatagram(datagram.data(), size, CLIENT_HANDLERS, context, sequence);
+    };
+    
+    RecordingContext context;
+    ASSERT_TRUE(decode(good, good.size(), context) == WireStatus::Ok);
+    ASSERT_EQ(2, context.types.size());
+    
+    // Old raw-struct packet / other protocol version
+    std::vector<uint8_t> version = good;
+    version[0] = 1;
+    RecordingContext versionContext;
+    ASSERT_TRUE(decode(version, version.size(), versionContext) == WireStatus::BadVersion);
+    
+    // Header cut short
+    RecordingContext headerContext;
+    ASSERT_TRUE(decode(good, WIRE_HEADER_BYTES - 1, headerContext) == WireStatus::Truncated);
+    
+    // Second message cut short: the valid first message must not be dispatched either
+    RecordingContext tailContext;
+    ASSERT_TRUE(decode(good, good.size() - 1, tailContext) == WireStatus::Truncated);
+    ASSERT_EQ(0, tailContext.types.size());
+    
+    // Message header cut short
+    RecordingContext messageHeaderContext;
+    ASSERT_TRUE(decode(good, WIRE_HEADER_BYTES + 2, messageHeaderContext) == WireStatus::Truncated);
+    
+    // Shot with the wrong length (e.g. a padded struct sent raw)
+    std::vector<uint8_t> length = good;
+    storeU16(length.data() + WIRE_HEADER_BYTES + 1, static_cast<uint16_t>(SHOT_MESSAGE_BYTES + 6));
+    RecordingContext lengthContext;
+    ASSERT_TRUE(decode(length, length.size(), lengthContext) == WireStatus::BadLength);
+    
+    // Unknown type, and a type this receiver does not accept
+    std::vector<uint8_t> unknown = good;
+    unknown[WIRE_HEADER_BYTES] = 200;
+    RecordingContext unknownContext;
+    ASSERT_TRUE(decode(unknown, unknown.size(), unknownContext) == WireStatus::UnknownType);
+    
+    std::vector<uint8_t> wrongDirection = good;
+    wrongDirection[WIRE_HEADER_BYTES] = static_cast<uint8_t>(WireMessageType::Position);
+    RecordingContext directionContext;
+    ASSERT_TRUE(decode(wrongDirection, wrongDirection.size(), directionContext) == WireStatus::UnknownType);
+    
+    ASSERT_EQ(0, versionContext.types.size() + headerContext.types.size() + messageHeaderContext.types.size() +
+                 lengthContext.types.size() + unknownContext.types.size() + directionContext.types.size());
+}
+
+// ========================
+// Benchmark
+// ========================
+
+const size_t UDP_IP_HEADER_BYTES = 28;  // IPv4 (20) + UDP (8) per datagram
+
+// Datagrams and wire bytes per client for one second of a busy match:
+// 64 Hz ticks, snapshots every 3rd tick (~20 Hz), shotsPerTick shots and
+// hitsPerTick hits broadcast to every client each tick.
+// "Unbatched" is the previous format: one raw struct per datagram.
+void benchmarkBatching(int shotsPerTick, int hitsPerTick) {
+    const int tickRate = 64;
+    const int snapshotInterval = 3;
+    const size_t snapshotBytes = 180;  // Typical delta snapshot for 32 players
+    std::vector<uint8_t> snapshot(snapshotBytes, 0x11);
+    ShotPacket shot = makeShot(5, 300.0f);
+    HitPacket hit = makeHit(5, 9);
+    
+    // Unbatched: every message is its own datagram
+    size_t unbatchedDatagrams = 0;
+    size_t unbatchedBytes = 0;
+    for (int tick = 0; tick < tickRate; ++tick) {
+        if (tick % snapshotInterval == 0) {
+            unbatchedDatagrams++;
+            unbatchedBytes += snapshotBytes + UDP_IP_HEADER_BYTES;
+        }
+        unbatchedDatagrams += shotsPerTick + hitsPerTick;
+        unbatchedBytes += shotsPerTick * (sizeof(ShotPacket) + UDP_IP_HEADER_BYTES) +
+                          hitsPerTick * (sizeof(HitPacket) + UDP_IP_HEADER_BYTES);
+    }
+    
+    // Batched
+    size_t batchedBytes = 0;
+    DatagramBuilder builder([&](const uint8_t*, size_t size, size_t) {
+        batchedBytes += size + UDP_IP_HEADER_BYTES;
+    }, 0);
+    for (int tick = 0; tick < tickRate; ++tick) {
+        if (tick % snapshotInterval == 0) {
+            builder.append(WireMessageType::Snapshot, snapshot.data(), snapshot.size());
+        }
+        for (int i = 0; i < shotsPerTick; ++i) {
+            builder.appendShot(shot);
+        }
+        for (int i = 0; i < hitsPerTick; ++i) {
+            builder.appendHit(hit);
+        }
+        builder.flush();
+    }
+    size_t batchedDatagrams = builder.datagramsSent();
+    
+    std::cout << std::setw(6) << shotsPerTick << std::setw(6) << hitsPerTick
+              << std::setw(14) << unbatchedDatagrams << std::setw(14) << batchedDatagrams
+              << std::setw(14) << unbatchedBytes << std::setw(14) << batchedBytes
+              << std::setw(12) << std::fixed << std::setprecision(1)
+              << static_cast<float>(unbatchedDatagrams) / std::max<size_t>(1, batchedDatagrams) << "x" << std::endl;
+}
+
+// Decode cost per message for a full datagram of shots and hits
+struct SumContext {
+    float sum = 0.0f;
+};
+
+void sumShot(const uint8_t* payload, size_t, SumContext& context) {
+    context.sum += ShotMessageView(payload).x();
+}
+void sumHit(const uint8_t* payload, size_t, SumContext& context) {
+    context.sum += HitMessageView(payload).damage();
+}
+
+void benchmarkDecode() {
+    const WireHandler<SumContext> handlers[WIRE_MESSAGE_TYPE_COUNT] = { nullptr, nullptr, sumShot, sumHit, nullptr };
+    
+    std::vector<uint8_t> datagram;
+    size_t messageCount = 0;
+    DatagramBuilder builder([&](const uint8_t* data, size_t size, size_t count) {
+        if (datagram.empty()) {
+            datagram.assign(data, data + size);
+            messageCount = count;
+        }
+    }, 0);
+    for (int i = 0; i < 64; ++i) {
+        builder.appendShot(makeShot(1, static_cast<float>(i)));
+        builder.appendHit(makeHit(1, 2));
+    }
+    builder.flush();
+    
+    const int iterations = 200000;
+    SumContext context;
+    uint32_t sequence = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        decodeDatagram(datagram.data(), datagram.size(), handlers, context, sequence);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    
+    std::cout << messageCount << " messages per " << datagram.size() << " byte datagram: "
+              << std::fixed << std::setprecision(2) << ns / (static_cast<double>(iterations) * messageCount)
+              << " ns per message (checksum " << context.sum << ")" << std::endl;
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Zero Ground Packet Batch Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "--- Wire Protocol Tests ---" << std::endl;
+    RUN_TEST(OneDatagramPerTick);
+    RUN_TEST(MessageLayoutsRoundTrip);
+    RUN_TEST(EmptyFlushSendsNothing);
+    RUN_TEST(OverflowStartsNewDatagram);
+    RUN_TEST(MessageSizeLimits);
+    RUN_TEST(MalformedDatagramsRejected);
+
+    std::cout << std::endl;
+    std::cout << "--- Datagrams per Client per Second (64 Hz ticks, 20 Hz snapshots) ---" << std::endl;
+    std::cout << std::setw(6) << "Shots" << std::setw(6) << "Hits" << std::setw(14) << "Unbatched" << std::setw(14)
+              << "Batched" << std::setw(14) << "Unbatched B" << std::setw(14) << "Batched B" << std::setw(13)
+              << "Sends" << std::endl;
+    benchmarkBatching(0, 0);
+    benchmarkBatching(1, 0);
+    benchmarkBatching(4, 1);
+    benchmarkBatching(16, 4);
+    benchmarkBatching(64, 8);
+
+    std::cout << std::endl;
+    std::cout << "--- Validated Decode Cost ---" << std::endl;
+    benchmarkDecode();
+
+    // Print summary
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Test Summary" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Total tests: " << totalTests << std::endl;
+    std::cout << "Passed: " << passedTests << std::endl;
+    std::cout << "Failed: " << failedTests << std::endl;
+    std::cout << std::endl;
+
+    if (failedTests == 0) {
+        std::cout << "✓ All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "✗ Some tests failed!" << std::endl;
+        return 1;
+    }
+}
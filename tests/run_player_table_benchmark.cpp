@@ -0,0 +1,405 @@
+// Player Table Simulation Tests and Benchmark for Zero Ground
+// Validates the N-player authoritative tick (hit detection, kill rewards, respawn)
+// and measures tick cost vs player count (2..64 players)
+//
+// The simulation code below is copied from Zero_Ground.cpp (updateServerSimulation,
+// applyBulletHit) without SFML, networking, walls or floating texts.
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+
+// ========================
+// Test Framework Macros
+// ========================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "Running test: " << #name << "..."; \
+    try { \
+        test_##name(); \
+        std::cout << " PASSED" << std::endl; \
+        passedTests++; \
+    } catch (const std::exception& e) { \
+        std::cout << " FAILED: " << e.what() << std::endl; \
+        failedTests++; \
+    } \
+    totalTests++; \
+} while(0)
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: " << #condition << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(condition) ASSERT_TRUE(!(condition))
+
+#define ASSERT_NEAR(expected, actual, epsilon) do { \
+    if (std::abs((expected) - (actual)) > (epsilon)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << (expected) << " but got " << (actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+// Test counters
+int totalTests = 0;
+int passedTests = 0;
+int failedTests = 0;
+
+// ========================
+// Minimal Structures (copied from main code)
+// ========================
+
+const float MAP_SIZE = 5100.0f;
+const uint32_t HOST_PLAYER_ID = 0;
+const uint32_t MAX_PLAYERS = 64;
+const float PLAYER_HIT_RADIUS = 15.0f;
+const float RESPAWN_DELAY = 5.0f;
+
+struct Player {
+    uint32_t id = 0;
+    float x = 0.0f;
+    float y = 0.0f;
+    float previousX = 0.0f;
+    float previousY = 0.0f;
+    float health = 100.0f;
+    int score = 0;
+    bool isAlive = true;
+    int money = 50000;
+    float targetX = 0.0f;
+    float targetY = 0.0f;
+    bool waitingRespawn = false;
+    float respawnCountdown = 0.0f;
+};
+
+struct Bullet {
+    float x = 0.0f;
+    float y = 0.0f;
+    float vx = 0.0f;
+    float vy = 0.0f;
+    float damage = 0.0f;
+    float range = 0.0f;
+    uint8_t ownerId = 0;
+
+    void update(float deltaTime) {
+        x += vx * deltaTime;
+        y += vy * deltaTime;
+        range -= std::sqrt(vx * vx + vy * vy) * deltaTime;
+    }
+
+    bool shouldRemove() const {
+        return range <= 0.0f;
+    }
+
+    bool checkPlayerCollision(float playerX, float playerY, float playerRadius) const {
+        float dx = x - playerX;
+        float dy = y - playerY;
+        return dx * dx + dy * dy <= playerRadius * playerRadius;
+    }
+};
+
+struct HitPacket {
+    uint8_t shooterId;
+    uint8_t victimId;
+    float damage;
+    bool wasKill;
+};
+
+std::mt19937 rng(12345);
+
+// Spawn without walls: random position (distance rule does not matter for these tests)
+void spawnPlayer(Player& player) {
+    std::uniform_real_distribution<float> dist(100.0f, MAP_SIZE - 100.0f);
+    player.x = player.previousX = player.targetX = dist(rng);
+    player.y = player.previousY = player.targetY = dist(rng);
+}
+
+HitPacket applyBulletHit(Bullet& bullet, Player& victim, std::map<uint32_t, Player>& players) {
+    victim.health -= bullet.damage;
+    if (victim.health < 0.0f) victim.health = 0.0f;
+    bullet.range = 0.0f;
+
+    bool wasKill = false;
+    if (victim.health <= 0.0f) {
+        victim.isAlive = false;
+        victim.waitingRespawn = true;
+        victim.respawnCountdown = RESPAWN_DELAY;
+        wasKill = true;
+
+        auto killer = players.find(bullet.ownerId);
+        if (killer != players.end()) {
+            killer->second.money += 5000;
+            killer->second.score += 1;
+        }
+    }
+
+    HitPacket hitPacket;
+    hitPacket.shooterId = bullet.ownerId;
+    hitPacket.victimId = static_cast<uint8_t>(victim.id);
+    hitPacket.damage = bullet.damage;
+    hitPacket.wasKill = wasKill;
+    return hitPacket;
+}
+
+// One authoritative tick over the player table
+std::vector<HitPacket> simulateTick(float deltaTime, std::map<uint32_t, Player>& players, std::vector<Bullet>& bullets) {
+    std::vector<HitPacket> hitPackets;
+
+    float clientAlpha = std::min(1.0f, deltaTime * 15.0f);
+    for (auto& pair : players) {
+        Player& player = pair.second;
+        if (player.id == HOST_PLAYER_ID) continue;
+        player.previousX = player.x;
+        player.previousY = player.y;
+        player.x += (player.targetX - player.x) * clientAlpha;
+        player.y += (player.targetY - player.y) * clientAlpha;
+    }
+
+    for (auto& bullet : bullets) {
+        bullet.update(deltaTime);
+    }
+
+    for (auto& bullet : bullets) {
+        if (bullet.range <= 0.0f) continue;
+        for (auto& pair : players) {
+            Player& victim = pair.second;
+            if (victim.id == bullet.ownerId || !victim.isAlive) continue;
+            if (bullet.checkPlayerCollision(victim.x, victim.y, PLAYER_HIT_RADIUS)) {
+                hitPackets.push_back(applyBulletHit(bullet, victim, players));
+                break;
+            }
+        }
+    }
+
+    bullets.erase(std::remove_if(bullets.begin(), bullets.end(),
+        [](const Bullet& b) {
+            return b.shouldRemove() || b.x < 0.0f || b.x > MAP_SIZE || b.y < 0.0f || b.y > MAP_SIZE;
+        }), bullets.end());
+
+    for (auto& pair : players) {
+        Player& player = pair.second;
+        if (!player.waitingRespawn) continue;
+        player.respawnCountdown -= deltaTime;
+        if (player.respawnCountdown > 0.0f) continue;
+        player.health = 100.0f;
+        player.isAlive = true;
+        player.waitingRespawn = false;
+        spawnPlayer(player);
+    }
+
+    return hitPackets;
+}
+
+std::map<uint32_t, Player> makePlayers(uint32_t count) {
+    std::map<uint32_t, Player> players;
+    for (uint32_t id = 0; id < count; ++id) {
+        Player player;
+        player.id = id;
+        spawnPlayer(player);
+        players[id] = player;
+    }
+    return players;
+}
+
+Bullet makeBullet(uint8_t ownerId, float x, float y, float vx, float vy, float damage = 25.0f) {
+    Bullet bullet;
+    bullet.ownerId = ownerId;
+    bullet.x = x;
+    bullet.y = y;
+    bullet.vx = vx;
+    bullet.vy = vy;
+    bullet.damage = damage;
+    bullet.range = 1000.0f;
+    return bullet;
+}
+
+// ========================
+// Player Table Tests
+// ========================
+
+// Any player in the table can be hit, not just the host/client pair
+TEST(HitAppliesToAnyPlayerInTable) {
+    auto players = makePlayers(16);
+    Player& victim = players[11];
+    std::vector<Bullet> bullets = { makeBullet(3, victim.x - 20.0f, victim.y, 600.0f, 0.0f) };
+
+    auto hits = simulateTick(1.0f / 60.0f, players, bullets);
+
+    ASSERT_TRUE(hits.size() == 1);
+    ASSERT_TRUE(hits[0].victimId == 11);
+    ASSERT_TRUE(hits[0].shooterId == 3);
+    ASSERT_NEAR(75.0f, players[11].health, 0.001f);
+    ASSERT_TRUE(bullets.empty());
+}
+
+// Bullets never hit their owner
+TEST(BulletDoesNotHitOwner) {
+    auto players = makePlayers(4);
+    Player& owner = players[2];
+    std::vector<Bullet> bullets = { makeBullet(2, owner.x, owner.y, 0.0f, 0.0f) };
+    bullets[0].vx = 1.0f; // Stay inside the owner for the whole tick
+
+    // Keep everyone else far away from the owner
+    for (auto& pair : players) {
+        if (pair.first != 2) {
+            pair.second.x = pair.second.targetX = owner.x + 500.0f;
+        }
+    }
+
+    auto hits = simulateTick(1.0f / 60.0f, players, bullets);
+
+    ASSERT_TRUE(hits.empty());
+    ASSERT_NEAR(100.0f, players[2].health, 0.001f);
+}
+
+// A kill credits the shooter with $5000 and +1 score
+TEST(KillCreditsShooter) {
+    auto players = makePlayers(8);
+    Player& victim = players[5];
+    victim.health = 10.0f;
+    int moneyBefore = players[7].money;
+    std::vector<Bullet> bullets = { makeBullet(7, victim.x, victim.y - 10.0f, 0.0f, 60.0f) };
+
+    auto hits = simulateTick(1.0f / 60.0f, players, bullets);
+
+    ASSERT_TRUE(hits.size() == 1 && hits[0].wasKill);
+    ASSERT_FALSE(players[5].isAlive);
+    ASSERT_TRUE(players[5].waitingRespawn);
+    ASSERT_TRUE(players[7].money == moneyBefore + 5000);
+    ASSERT_TRUE(players[7].score == 1);
+}
+
+// Dead players respawn with full health after RESPAWN_DELAY of simulation time
+TEST(RespawnAfterDelay) {
+    auto players = makePlayers(2);
+    players[1].health = 0.0f;
+    players[1].isAlive = false;
+    players[1].waitingRespawn = true;
+    players[1].respawnCountdown = RESPAWN_DELAY;
+    std::vector<Bullet> bullets;
+
+    const float dt = 1.0f / 60.0f;
+    int ticks = 0;
+    while (!players[1].isAlive && ticks < 1000) {
+        simulateTick(dt, players, bullets);
+        ticks++;
+    }
+
+    ASSERT_TRUE(players[1].isAlive);
+    ASSERT_NEAR(100.0f, players[1].health, 0.001f);
+    ASSERT_NEAR(RESPAWN_DELAY, ticks * dt, dt * 1.5f);
+}
+
+// A bullet hits at most one player even when several overlap
+TEST(BulletHitsOnlyOnePlayer) {
+    auto players = makePlayers(4);
+    for (auto& pair : players) {
+        pair.second.x = pair.second.targetX = 1000.0f;
+        pair.second.y = pair.second.targetY = 1000.0f;
+    }
+    std::vector<Bullet> bullets = { makeBullet(0, 1000.0f, 1000.0f, 1.0f, 0.0f) };
+
+    auto hits = simulateTick(1.0f / 60.0f, players, bullets);
+
+    ASSERT_TRUE(hits.size() == 1);
+}
+
+// ========================
+// Tick Cost Benchmark
+// ========================
+
+// Average tick cost with every player firing ~2 bullets per second
+void benchmarkTickCost(uint32_t playerCount) {
+    auto players = makePlayers(playerCount);
+    std::vector<Bullet> bullets;
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+    std::uniform_real_distribution<float> jitter(-40.0f, 40.0f);
+
+    const float dt = 1.0f / 60.0f;
+    const int TICKS = 600; // 10 seconds of game time
+    double totalMs = 0.0;
+    double maxMs = 0.0;
+    size_t peakBullets = 0;
+
+    for (int tick = 0; tick < TICKS; ++tick) {
+        // Clients wander and shoot
+        for (auto& pair : players) {
+            Player& player = pair.second;
+            player.targetX = std::max(100.0f, std::min(MAP_SIZE - 100.0f, player.targetX + jitter(rng)));
+            player.targetY = std::max(100.0f, std::min(MAP_SIZE - 100.0f, player.targetY + jitter(rng)));
+            if (player.isAlive && (tick + player.id) % 30 == 0) {
+                float a = angle(rng);
+                bullets.push_back(makeBullet(static_cast<uint8_t>(player.id), player.x, player.y,
+                                             std::cos(a) * 600.0f, std::sin(a) * 600.0f, 15.0f));
+            }
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        simulateTick(dt, players, bullets);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        totalMs += ms;
+        maxMs = std::max(maxMs, ms);
+        peakBullets = std::max(peakBullets, bullets.size());
+    }
+
+    std::cout << std::setw(8) << playerCount
+              << std::setw(14) << std::fixed << std::setprecision(4) << (totalMs / TICKS)
+              << std::setw(14) << maxMs
+              << std::setw(14) << peakBullets << std::endl;
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Zero Ground Player Table Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "--- Player Table Simulation Tests ---" << std::endl;
+    RUN_TEST(HitAppliesToAnyPlayerInTable);
+    RUN_TEST(BulletDoesNotHitOwner);
+    RUN_TEST(KillCreditsShooter);
+    RUN_TEST(RespawnAfterDelay);
+    RUN_TEST(BulletHitsOnlyOnePlayer);
+
+    std::cout << std::endl;
+    std::cout << "--- Tick Cost vs Player Count (60 Hz, 600 ticks) ---" << std::endl;
+    std::cout << std::setw(8) << "Players" << std::setw(14) << "Avg (ms)"
+              << std::setw(14) << "Max (ms)" << std::setw(14) << "Bullets" << std::endl;
+    for (uint32_t count : { 2u, 8u, 16u, 32u, MAX_PLAYERS }) {
+        benchmarkTickCost(count);
+    }
+    std::cout << "Tick budget at 60 Hz: 16.67ms" << std::endl;
+
+    // Print summary
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Test Summary" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Total tests: " << totalTests << std::endl;
+    std::cout << "Passed: " << passedTests << std::endl;
+    std::cout << "Failed: " << failedTests << std::endl;
+    std::cout << std::endl;
+
+    if (failedTests == 0) {
+        std::cout << "✓ All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "✗ Some tests failed!" << std::endl;
+        return 1;
+    }
+}
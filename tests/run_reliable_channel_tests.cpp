@@ -0,0 +1,1484 @@
+// Reliable Channel Tests and Benchmark for Zero Ground
+// Checks the reliable, ordered message stream that carries hits, purchases and
+// inventory updates over the unreliable datagrams: the purchase, inventory,
+// reliable and reliable ack layouts, in-order delivery with duplicates dropped,
+// the ack mask, resend timeouts from the RTT estimate (with backoff and Karn's
+// rule), the in-flight window and 16-bit id wraparound. Then plays two peers
+// over simulated links with delay, jitter, reordering and loss and reports how
+// late reliable messages arrive and how many bytes the resends cost.
+//
+// Code under test is copied from Zero_Ground_client.cpp (the server has the
+// same wire code). Build with /O2 (or -O2).
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <array>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+// ========================
+// Test Framework Macros
+// ========================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "Running test: " << #name << "..."; \
+    try { \
+        test_##name(); \
+        std::cout << " PASSED" << std::endl; \
+        passedTests++; \
+    } catch (const std::exception& e) { \
+        std::cout << " FAILED: " << e.what() << std::endl; \
+        failedTests++; \
+    } \
+    totalTests++; \
+} while(0)
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: " << #condition << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_NEAR(expected, actual, epsilon) do { \
+    if (std::abs((expected) - (actual)) > (epsilon)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << (expected) << " but got " << (actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(expected, actual) do { \
+    if ((expected) != (actual)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << static_cast<int>(expected) << " but got " << static_cast<int>(actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+// Test counters
+int totalTests = 0;
+int passedTests = 0;
+int failedTests = 0;
+
+
+// ========================
+// Code Under Test (copied from Zero_Ground_client.cpp)
+// ========================
+
+enum class AmmoType : uint8_t {
+    AMMO_9x18 = 0,    // Pistol ammo
+    AMMO_5_45x39 = 1, // Rifle ammo
+    AMMO_7_62x54 = 2  // Sniper ammo
+};
+
+// Requirement 4.1-4.5: Purchase validation and transaction
+struct PurchasePacket {
+    uint8_t playerId;
+    uint8_t weaponType;        // Weapon::Type enum value, 255 = buying ammo
+    uint8_t ammoType = 255;    // AmmoType enum value, 255 = buying a weapon
+};
+
+// Inventory update packet (server → buyer)
+// Sent in answer to every purchase to confirm or undo it and synchronize the balance
+struct InventoryPacket {
+    uint8_t playerId;
+    uint8_t slot;        // Which slot changed (0-3), 255 = none
+    uint8_t weaponType;  // Weapon::Type enum value, 255 = empty slot
+    bool accepted;       // False if the server refused the purchase
+    int newMoneyBalance;
+};
+
+// Requirement 7.6: Shot packet (client → server → all clients)
+// Sent when player fires weapon
+struct ShotPacket {
+    uint8_t playerId;
+    float x, y;          // Shot origin position
+    float dirX, dirY;    // Normalized direction vector
+    uint8_t weaponType;  // Weapon::Type enum value
+    float bulletSpeed;   // Bullet speed for this weapon
+    float damage;        // Damage for this weapon
+    float range;         // Range for this weapon
+    uint32_t viewTick;   // Tick of the latest server snapshot the shooter had (lag compensation)
+};
+
+// Requirement 10.4: Hit packet (server → all clients)
+// Sent when bullet hits a player
+struct HitPacket {
+    uint8_t shooterId;   // Player who fired the bullet
+    uint8_t victimId;    // Player who was hit
+    float damage;        // Damage dealt
+    float hitX, hitY;    // Position where hit occurred
+    bool wasKill;        // True if this hit killed the victim
+};
+
+const size_t MAX_SNAPSHOT_BYTES = 1192;         // Leaves room for the wire headers in one datagram
+
+const uint8_t WIRE_VERSION = 4;                 // Version 3 sent hits unreliably and had no purchases
+const size_t WIRE_HEADER_BYTES = 5;
+const size_t WIRE_MESSAGE_HEADER_BYTES = 3;
+const size_t MAX_DATAGRAM_BYTES = 1200;         // Stays below a typical 1500 byte MTU
+static_assert(MAX_SNAPSHOT_BYTES + WIRE_HEADER_BYTES + WIRE_MESSAGE_HEADER_BYTES <= MAX_DATAGRAM_BYTES,
+              "A full snapshot must fit in one datagram");
+
+enum class WireMessageType : uint8_t {
+    Input = 1,     // Client -> server: sequenced InputCommands and snapshot ack
+    Shot = 2,      // Both directions: ShotPacket
+    Hit = 3,          // Server -> client, reliable only: HitPacket
+    Snapshot = 4,     // Server -> client: writeSnapshot() payload
+    InputAck = 5,     // Server -> client: last simulated input and resulting position
+    Purchase = 6,     // Client -> server, reliable only: PurchasePacket
+    Inventory = 7,    // Server -> client, reliable only: InventoryPacket
+    Reliable = 8,     // Both directions: one of the above, sequenced (see ReliableChannel)
+    ReliableAck = 9   // Both directions: which Reliable messages arrived
+};
+const size_t WIRE_MESSAGE_TYPE_COUNT = 10;      // Type 0 is never valid
+
+// Little-endian field access; payloads are unaligned, so go through bytes
+inline void storeU16(uint8_t* p, uint16_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+}
+
+inline void storeU32(uint8_t* p, uint32_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+    p[2] = static_cast<uint8_t>(value >> 16);
+    p[3] = static_cast<uint8_t>(value >> 24);
+}
+
+inline void storeF32(uint8_t* p, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    storeU32(p, bits);
+}
+
+inline uint16_t loadU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t loadU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline float loadF32(const uint8_t* p) {
+    uint32_t bits = loadU32(p);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// ------------------------
+// Input Message
+// ------------------------
+// playerId:8, ackTick:32, firstSequence:32, count:8,
+// then count * (buttons:8, aim:16) with sequences firstSequence, firstSequence + 1, ...
+//
+// The client samples its controls INPUT_RATE times per second into sequenced
+// commands and sends the newest MAX_INPUT_COMMANDS with every datagram, so a lost
+// datagram is covered by the next one. The server simulates the movement itself
+// (see InputQueue) and never takes a position from the client.
+
+const float INPUT_RATE = 60.0f;                  // Commands per second (movement speeds are per 1/60 s)
+const float INPUT_STEP = 1.0f / INPUT_RATE;      // Simulated time per command
+const size_t MAX_INPUT_COMMANDS = 8;             // Newest commands repeated in every datagram
+const size_t INPUT_MESSAGE_HEADER_BYTES = 10;
+const size_t INPUT_COMMAND_BYTES = 3;
+const size_t MAX_INPUT_MESSAGE_BYTES = INPUT_MESSAGE_HEADER_BYTES + MAX_INPUT_COMMANDS * INPUT_COMMAND_BYTES;
+
+// Low nibble of InputCommand::buttons; the high nibble is the active weapon
+// (Weapon::Type + 1, 0 = no weapon), which decides the movement speed
+const uint8_t INPUT_UP = 0x01;
+const uint8_t INPUT_DOWN = 0x02;
+const uint8_t INPUT_LEFT = 0x04;
+const uint8_t INPUT_RIGHT = 0x08;
+
+// One sampled frame of client controls
+struct InputCommand {
+    uint32_t sequence = 0;  // Client input tick, +1 per command
+    uint8_t buttons = 0;    // INPUT_* bits | weapon code << 4
+    uint16_t aim = 0;       // Rotation, 1/65536 of a turn
+};
+
+inline uint8_t inputWeaponCode(uint8_t buttons) {
+    return static_cast<uint8_t>(buttons >> 4);
+}
+
+inline uint16_t quantizeAim(float degrees) {
+    float turns = degrees / 360.0f;
+    turns -= std::floor(turns);
+    return static_cast<uint16_t>(static_cast<uint32_t>(std::lround(turns * 65536.0f)) & 0xFFFF);
+}
+
+inline float dequantizeAim(uint16_t aim) {
+    return aim * (360.0f / 65536.0f);
+}
+
+// Write the input payload; count must be 1..MAX_INPUT_COMMANDS with consecutive sequences
+// Returns: payload length in bytes
+size_t writeInputMessage(uint8_t* out, uint8_t playerId, uint32_t ackTick, const InputCommand* commands, size_t count) {
+    out[0] = playerId;
+    storeU32(out + 1, ackTick);
+    storeU32(out + 5, commands[0].sequence);
+    out[9] = static_cast<uint8_t>(count);
+    uint8_t* p = out + INPUT_MESSAGE_HEADER_BYTES;
+    for (size_t i = 0; i < count; ++i, p += INPUT_COMMAND_BYTES) {
+        p[0] = commands[i].buttons;
+        storeU16(p + 1, commands[i].aim);
+    }
+    return INPUT_MESSAGE_HEADER_BYTES + count * INPUT_COMMAND_BYTES;
+}
+
+// Reads a validated input payload in place (no copy)
+class InputMessageView {
+public:
+    InputMessageView(const uint8_t* payload, size_t length) : p_(payload), length_(length) {}
+    
+    uint8_t playerId() const { return p_[0]; }
+    uint32_t ackTick() const { return loadU32(p_ + 1); }
+    uint32_t firstSequence() const { return loadU32(p_ + 5); }
+    
+    // Commands actually present (the count field is checked against the length)
+    size_t count() const {
+        return std::min<size_t>(p_[9], (length_ - INPUT_MESSAGE_HEADER_BYTES) / INPUT_COMMAND_BYTES);
+    }
+    
+    InputCommand command(size_t index) const {
+        const uint8_t* p = p_ + INPUT_MESSAGE_HEADER_BYTES + index * INPUT_COMMAND_BYTES;
+        InputCommand command;
+        command.sequence = firstSequence() + static_cast<uint32_t>(index);
+        command.buttons = p[0];
+        command.aim = loadU16(p + 1);
+        return command;
+    }
+    
+private:
+    const uint8_t* p_;
+    size_t length_;
+};
+
+// ------------------------
+// Shot Message
+// ------------------------
+// playerId:8, x:f32, y:f32, dirX:f32, dirY:f32, weaponType:8,
+// bulletSpeed:f32, damage:f32, range:f32, viewTick:32
+
+const size_t SHOT_MESSAGE_BYTES = 34;
+
+void writeShotMessage(uint8_t* out, const ShotPacket& packet) {
+    out[0] = packet.playerId;
+    storeF32(out + 1, packet.x);
+    storeF32(out + 5, packet.y);
+    storeF32(out + 9, packet.dirX);
+    storeF32(out + 13, packet.dirY);
+    out[17] = packet.weaponType;
+    storeF32(out + 18, packet.bulletSpeed);
+    storeF32(out + 22, packet.damage);
+    storeF32(out + 26, packet.range);
+    storeU32(out + 30, packet.viewTick);
+}
+
+// Reads a validated shot payload in place (no copy)
+class ShotMessageView {
+public:
+    explicit ShotMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint8_t playerId() const { return p_[0]; }
+    float x() const { return loadF32(p_ + 1); }
+    float y() const { return loadF32(p_ + 5); }
+    float dirX() const { return loadF32(p_ + 9); }
+    float dirY() const { return loadF32(p_ + 13); }
+    uint8_t weaponType() const { return p_[17]; }
+    float bulletSpeed() const { return loadF32(p_ + 18); }
+    float damage() const { return loadF32(p_ + 22); }
+    float range() const { return loadF32(p_ + 26); }
+    uint32_t viewTick() const { return loadU32(p_ + 30); }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Hit Message
+// ------------------------
+// shooterId:8, victimId:8, damage:f32, hitX:f32, hitY:f32, wasKill:8
+
+const size_t HIT_MESSAGE_BYTES = 15;
+
+void writeHitMessage(uint8_t* out, const HitPacket& packet) {
+    out[0] = packet.shooterId;
+    out[1] = packet.victimId;
+    storeF32(out + 2, packet.damage);
+    storeF32(out + 6, packet.hitX);
+    storeF32(out + 10, packet.hitY);
+    out[14] = packet.wasKill ? 1 : 0;
+}
+
+// Reads a validated hit payload in place (no copy)
+class HitMessageView {
+public:
+    explicit HitMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint8_t shooterId() const { return p_[0]; }
+    uint8_t victimId() const { return p_[1]; }
+    float damage() const { return loadF32(p_ + 2); }
+    float hitX() const { return loadF32(p_ + 6); }
+    float hitY() const { return loadF32(p_ + 10); }
+    bool wasKill() const { return p_[14] != 0; }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Input Ack Message
+// ------------------------
+// sequence:32, x:f32, y:f32
+//
+// Sent to each client with its snapshot: the last input command the server
+// simulated for that client and the exact position it ended at. The client
+// rewinds its prediction to it and replays the newer commands (see InputPredictor).
+
+const size_t INPUT_ACK_MESSAGE_BYTES = 12;
+
+void writeInputAckMessage(uint8_t* out, uint32_t sequence, float x, float y) {
+    storeU32(out, sequence);
+    storeF32(out + 4, x);
+    storeF32(out + 8, y);
+}
+
+// Reads a validated input ack payload in place (no copy)
+class InputAckMessageView {
+public:
+    explicit InputAckMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint32_t sequence() const { return loadU32(p_); }
+    float x() const { return loadF32(p_ + 4); }
+    float y() const { return loadF32(p_ + 8); }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Purchase Message
+// ------------------------
+// playerId:8, weaponType:8, ammoType:8
+//
+// One shop purchase (client -> server, reliable). Exactly one of weaponType and
+// ammoType names an item; the other is PURCHASE_NONE.
+
+const size_t PURCHASE_MESSAGE_BYTES = 3;
+const uint8_t PURCHASE_NONE = 255;
+
+void writePurchaseMessage(uint8_t* out, const PurchasePacket& packet) {
+    out[0] = packet.playerId;
+    out[1] = packet.weaponType;
+    out[2] = packet.ammoType;
+}
+
+// Reads a validated purchase payload in place (no copy)
+class PurchaseMessageView {
+public:
+    explicit PurchaseMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint8_t playerId() const { return p_[0]; }
+    uint8_t weaponType() const { return p_[1]; }
+    uint8_t ammoType() const { return p_[2]; }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Inventory Message
+// ------------------------
+// playerId:8, slot:8, weaponType:8, accepted:8, newMoneyBalance:32
+//
+// The server's answer to one purchase (server -> buyer, reliable, same order as
+// the purchases). slot and weaponType are PURCHASE_NONE unless a weapon was added.
+
+const size_t INVENTORY_MESSAGE_BYTES = 8;
+
+void writeInventoryMessage(uint8_t* out, const InventoryPacket& packet) {
+    out[0] = packet.playerId;
+    out[1] = packet.slot;
+    out[2] = packet.weaponType;
+    out[3] = packet.accepted ? 1 : 0;
+    storeU32(out + 4, static_cast<uint32_t>(packet.newMoneyBalance));
+}
+
+// Reads a validated inventory payload in place (no copy)
+class InventoryMessageView {
+public:
+    explicit InventoryMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint8_t playerId() const { return p_[0]; }
+    uint8_t slot() const { return p_[1]; }
+    uint8_t weaponType() const { return p_[2]; }
+    bool accepted() const { return p_[3] != 0; }
+    int newMoneyBalance() const { return static_cast<int32_t>(loadU32(p_ + 4)); }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Reliable Message
+// ------------------------
+// id:16, type:8, then the payload of the wrapped message
+//
+// Purchases, inventory updates and hits must arrive exactly once and in order.
+// Instead of a second (TCP) connection, which would stall behind every lost
+// segment, they are wrapped in Reliable messages and ride on the same datagrams
+// as snapshots and inputs; ReliableChannel numbers, acknowledges, resends and
+// reorders them, and nothing unreliable ever waits for them.
+
+const size_t RELIABLE_MESSAGE_HEADER_BYTES = 3;
+const size_t MAX_RELIABLE_BODY_BYTES = 32;
+
+void writeReliableMessage(uint8_t* out, uint16_t id, uint8_t type, const uint8_t* body, size_t length) {
+    storeU16(out, id);
+    out[2] = type;
+    std::memcpy(out + RELIABLE_MESSAGE_HEADER_BYTES, body, length);
+}
+
+// Reads a validated reliable payload in place (no copy)
+class ReliableMessageView {
+public:
+    ReliableMessageView(const uint8_t* payload, size_t length) : p_(payload), length_(length) {}
+    
+    uint16_t id() const { return loadU16(p_); }
+    uint8_t type() const { return p_[2]; }
+    const uint8_t* body() const { return p_ + RELIABLE_MESSAGE_HEADER_BYTES; }
+    size_t bodyLength() const { return length_ - RELIABLE_MESSAGE_HEADER_BYTES; }
+    
+private:
+    const uint8_t* p_;
+    size_t length_;
+};
+
+// ------------------------
+// Reliable Ack Message
+// ------------------------
+// nextExpected:16, received:32
+//
+// nextExpected is the first reliable id not received yet (all older ones arrived);
+// bit i of received is set when id nextExpected + 1 + i is already buffered.
+
+const size_t RELIABLE_ACK_MESSAGE_BYTES = 6;
+
+void writeReliableAckMessage(uint8_t* out, uint16_t nextExpected, uint32_t received) {
+    storeU16(out, nextExpected);
+    storeU32(out + 2, received);
+}
+
+// Reads a validated reliable ack payload in place (no copy)
+class ReliableAckMessageView {
+public:
+    explicit ReliableAckMessageView(const uint8_t* payload) : p_(payload) {}
+    
+    uint16_t nextExpected() const { return loadU16(p_); }
+    uint32_t received() const { return loadU32(p_ + 2); }
+    
+private:
+    const uint8_t* p_;
+};
+
+// ------------------------
+// Decoding
+// ------------------------
+
+// Allowed payload length per message type, indexed by WireMessageType
+struct WireMessageSpec {
+    const char* name;
+    size_t minLength;
+    size_t maxLength;
+};
+
+const WireMessageSpec WIRE_MESSAGE_SPECS[WIRE_MESSAGE_TYPE_COUNT] = {
+    { "invalid", 1, 0 },  // Empty range: never accepted
+    { "input", INPUT_MESSAGE_HEADER_BYTES + INPUT_COMMAND_BYTES, MAX_INPUT_MESSAGE_BYTES },
+    { "shot", SHOT_MESSAGE_BYTES, SHOT_MESSAGE_BYTES },
+    { "hit", HIT_MESSAGE_BYTES, HIT_MESSAGE_BYTES },
+    { "snapshot", 1, MAX_SNAPSHOT_BYTES },
+    { "input ack", INPUT_ACK_MESSAGE_BYTES, INPUT_ACK_MESSAGE_BYTES },
+    { "purchase", PURCHASE_MESSAGE_BYTES, PURCHASE_MESSAGE_BYTES },
+    { "inventory", INVENTORY_MESSAGE_BYTES, INVENTORY_MESSAGE_BYTES },
+    { "reliable", RELIABLE_MESSAGE_HEADER_BYTES, RELIABLE_MESSAGE_HEADER_BYTES + MAX_RELIABLE_BODY_BYTES },
+    { "reliable ack", RELIABLE_ACK_MESSAGE_BYTES, RELIABLE_ACK_MESSAGE_BYTES }
+};
+
+enum class WireStatus {
+    Ok,
+    Truncated,    // Header or message runs past the end of the datagram
+    BadVersion,   // Sender speaks another protocol version
+    UnknownType,  // Type not in the table or not accepted by this receiver
+    BadLength     // Payload length outside the type's allowed range
+};
+
+// Message handler: payload points into the receive buffer and has been bounds-checked
+template <typename Context>
+using WireHandler = void (*)(const uint8_t* payload, size_t length, Context& context);
+
+// Read the datagram header
+// Returns: Ok and the sequence, or why the datagram was rejected
+inline WireStatus readWireHeader(const uint8_t* data, size_t size, uint32_t& sequence) {
+    if (size < WIRE_HEADER_BYTES) {
+        return WireStatus::Truncated;
+    }
+    if (data[0] != WIRE_VERSION) {
+        return WireStatus::BadVersion;
+    }
+    sequence = loadU32(data + 1);
+    return WireStatus::Ok;
+}
+
+// Validate a whole datagram in place, then dispatch each message to handlers[type]
+// Parameters:
+//   data, size - The received datagram (never copied)
+//   handlers - Handler per WireMessageType; null rejects that type
+//   context - Passed through to the handlers
+//   sequence - Receives the datagram sequence number
+// Returns: Ok if every message was dispatched; otherwise nothing was dispatched
+//
+// PERFORMANCE:
+// Type lookup is an array index and each message is checked once against the
+// spec table, so decoding is O(1) per message with no allocation. Validating
+// the whole datagram before dispatching means a malformed tail can't leave a
+// half-applied datagram behind.
+template <typename Context>
+WireStatus decodeDatagram(const uint8_t* data, size_t size, const WireHandler<Context>* handlers,
+                          Context& context, uint32_t& sequence) {
+    WireStatus status = readWireHeader(data, size, sequence);
+    if (status != WireStatus::Ok) {
+        return status;
+    }
+    
+    // Pass 1: bounds and type checks
+    size_t pos = WIRE_HEADER_BYTES;
+    while (pos < size) {
+        if (size - pos < WIRE_MESSAGE_HEADER_BYTES) {
+            return WireStatus::Truncated;
+        }
+        uint8_t type = data[pos];
+        size_t length = loadU16(data + pos + 1);
+        if (type >= WIRE_MESSAGE_TYPE_COUNT || handlers[type] == nullptr) {
+            return WireStatus::UnknownType;
+        }
+        if (length < WIRE_MESSAGE_SPECS[type].minLength || length > WIRE_MESSAGE_SPECS[type].maxLength) {
+            return WireStatus::BadLength;
+        }
+        pos += WIRE_MESSAGE_HEADER_BYTES;
+        if (size - pos < length) {
+            return WireStatus::Truncated;
+        }
+        pos += length;
+    }
+    
+    // Pass 2: dispatch
+    pos = WIRE_HEADER_BYTES;
+    while (pos < size) {
+        uint8_t type = data[pos];
+        size_t length = loadU16(data + pos + 1);
+        pos += WIRE_MESSAGE_HEADER_BYTES;
+        handlers[type](data + pos, length, context);
+        pos += length;
+    }
+    return WireStatus::Ok;
+}
+
+// Validate and dispatch one message that did not come straight from decodeDatagram
+// (the payload of a Reliable message, delivered once it is in order)
+// Returns: Ok if the handler was called
+template <typename Context>
+WireStatus dispatchWireMessage(uint8_t type, const uint8_t* payload, size_t length,
+                               const WireHandler<Context>* handlers, Context& context) {
+    if (type >= WIRE_MESSAGE_TYPE_COUNT || handlers[type] == nullptr) {
+        return WireStatus::UnknownType;
+    }
+    if (length < WIRE_MESSAGE_SPECS[type].minLength || length > WIRE_MESSAGE_SPECS[type].maxLength) {
+        return WireStatus::BadLength;
+    }
+    handlers[type](payload, length, context);
+    return WireStatus::Ok;
+}
+
+inline const char* wireStatusName(WireStatus status) {
+    switch (status) {
+        case WireStatus::Ok: return "ok";
+        case WireStatus::Truncated: return "truncated";
+        case WireStatus::BadVersion: return "wrong protocol version";
+        case WireStatus::UnknownType: return "unexpected message type";
+        case WireStatus::BadLength: return "bad message length";
+    }
+    return "unknown";
+}
+
+// ------------------------
+// Encoding
+// ------------------------
+
+// Builds the datagrams for one recipient
+// Completed datagrams are handed to the sink (data, size, message count);
+// call flush() once all messages have been appended.
+class DatagramBuilder {
+public:
+    using Sink = std::function<void(const uint8_t*, size_t, size_t)>;
+    
+    // firstSequence - Sequence number of the first datagram this builder sends
+    DatagramBuilder(Sink sink, uint32_t firstSequence)
+        : sink_(std::move(sink)), nextSequence_(firstSequence) {
+        buffer_[0] = WIRE_VERSION;
+    }
+    
+    // Reserve room for one message, flushing the current datagram first if it would not fit
+    // Returns: where to write the payload (exactly length bytes), or null if the
+    // message is too large for any datagram
+    uint8_t* reserve(WireMessageType type, size_t length) {
+        const size_t needed = WIRE_MESSAGE_HEADER_BYTES + length;
+        if (WIRE_HEADER_BYTES + needed > MAX_DATAGRAM_BYTES) {
+            return nullptr;
+        }
+        if (used_ + needed > MAX_DATAGRAM_BYTES) {
+            flush();
+        }
+        
+        buffer_[used_] = static_cast<uint8_t>(type);
+        storeU16(buffer_ + used_ + 1, static_cast<uint16_t>(length));
+        uint8_t* payload = buffer_ + used_ + WIRE_MESSAGE_HEADER_BYTES;
+        used_ += needed;
+        messageCount_++;
+        return payload;
+    }
+    
+    // Append a pre-encoded payload (e.g. a snapshot)
+    bool append(WireMessageType type, const uint8_t* payload, size_t length) {
+        uint8_t* out = reserve(type, length);
+        if (out == nullptr) {
+            return false;
+        }
+        std::memcpy(out, payload, length);
+        return true;
+    }
+    
+    // commands - Consecutive commands, oldest first (at most MAX_INPUT_COMMANDS are sent: the newest)
+    bool appendInput(uint8_t playerId, uint32_t ackTick, const InputCommand* commands, size_t count) {
+        if (count == 0) {
+            return false;
+        }
+        if (count > MAX_INPUT_COMMANDS) {
+            commands += count - MAX_INPUT_COMMANDS;
+            count = MAX_INPUT_COMMANDS;
+        }
+        uint8_t* out = reserve(WireMessageType::Input, INPUT_MESSAGE_HEADER_BYTES + count * INPUT_COMMAND_BYTES);
+        if (out) writeInputMessage(out, playerId, ackTick, commands, count);
+        return out != nullptr;
+    }
+    
+    bool appendShot(const ShotPacket& packet) {
+        uint8_t* out = reserve(WireMessageType::Shot, SHOT_MESSAGE_BYTES);
+        if (out) writeShotMessage(out, packet);
+        return out != nullptr;
+    }
+    
+    bool appendHit(const HitPacket& packet) {
+        uint8_t* out = reserve(WireMessageType::Hit, HIT_MESSAGE_BYTES);
+        if (out) writeHitMessage(out, packet);
+        return out != nullptr;
+    }
+    
+    bool appendInputAck(uint32_t sequence, float x, float y) {
+        uint8_t* out = reserve(WireMessageType::InputAck, INPUT_ACK_MESSAGE_BYTES);
+        if (out) writeInputAckMessage(out, sequence, x, y);
+        return out != nullptr;
+    }
+    
+    // Hand the pending datagram to the sink (no-op when nothing is pending)
+    void flush() {
+        if (messageCount_ == 0) {
+            return;
+        }
+        storeU32(buffer_ + 1, nextSequence_++);
+        sink_(buffer_, used_, messageCount_);
+        datagramsSent_++;
+        used_ = WIRE_HEADER_BYTES;
+        messageCount_ = 0;
+    }
+    
+    size_t datagramsSent() const { return datagramsSent_; }
+    
+    // Sequence number the next datagram will carry
+    uint32_t nextSequence() const { return nextSequence_; }
+    
+private:
+    Sink sink_;
+    uint8_t buffer_[MAX_DATAGRAM_BYTES];
+    size_t used_ = WIRE_HEADER_BYTES;
+    size_t messageCount_ = 0;
+    size_t datagramsSent_ = 0;
+    uint32_t nextSequence_;
+};
+
+// ------------------------
+// Reliable Channel
+// ------------------------
+
+// Reliable, ordered message stream to one peer, carried on the unreliable datagrams
+//
+// ALGORITHM:
+// Sending: every message gets the next 16-bit id and stays queued until the peer
+// acknowledges it. write() appends the pending ack plus every message that was
+// never sent or whose resend timeout expired. Only WINDOW ids past the oldest
+// unacknowledged one are in flight, so everything the peer can have buffered
+// fits in the 32-bit ack mask. The timeout is smoothed RTT + 4 x RTT variance
+// (RFC 6298), sampled only from messages acknowledged after their first send
+// (Karn). A message that needs a second resend doubles it until the next
+// sample, so a sudden RTT rise can't cause endless spurious resends, while
+// single losses on a link that keeps answering are resent one timeout apart.
+// Receiving: messages ahead of the next expected id wait in WINDOW slots until
+// the gap is filled, then deliver() releases them in id order. Duplicates are
+// dropped but re-arm the ack, so a lost ack is repeated by the next datagram.
+//
+// PERFORMANCE:
+// Fixed rings indexed by id (both sizes divide 65536, so wraparound is free), no
+// allocation. The ack costs 9 bytes and only goes out after something arrived;
+// a lost message delays only the reliable messages behind it, never snapshots
+// or inputs.
+class ReliableChannel {
+public:
+    static const uint16_t WINDOW = 32;              // Ids in flight / buffered ahead of the gap
+    static const uint16_t QUEUE_CAPACITY = 128;     // Queued outgoing messages (in flight + waiting)
+    static constexpr float INITIAL_TIMEOUT = 0.2f;  // Resend timeout before the first RTT sample
+    static constexpr float MIN_TIMEOUT = 0.05f;     // Below this the peer's ack delay causes spurious resends
+    static constexpr float MAX_TIMEOUT = 1.0f;      // Cap for the backed-off timeout
+    static const int MAX_BACKOFF = 5;               // Doublings without an RTT sample
+    
+    // Queue a message for reliable delivery
+    // Returns: false if the body is too large or the queue is full (peer not acknowledging)
+    bool send(WireMessageType type, const uint8_t* body, size_t length) {
+        if (length > MAX_RELIABLE_BODY_BYTES || queued() == QUEUE_CAPACITY) {
+            return false;
+        }
+        Outgoing& message = outgoing_[nextSendId_ % QUEUE_CAPACITY];
+        message.type = static_cast<uint8_t>(type);
+        message.length = static_cast<uint8_t>(length);
+        std::memcpy(message.body, body, length);
+        message.sends = 0;
+        message.acked = false;
+        nextSendId_++;
+        return true;
+    }
+    
+    // Returns: true if write() would append anything at this time
+    bool wantsToSend(float now) const {
+        if (ackPending_) {
+            return true;
+        }
+        const uint16_t end = inFlightEnd();
+        for (uint16_t id = oldestUnacked_; id != end; ++id) {
+            const Outgoing& message = outgoing_[id % QUEUE_CAPACITY];
+            if (!message.acked && (message.sends == 0 || now - message.sentAt >= resendTimeout())) {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    // Append the pending ack and every message due for (re)sending
+    void write(DatagramBuilder& builder, float now) {
+        if (ackPending_) {
+            uint8_t* out = builder.reserve(WireMessageType::ReliableAck, RELIABLE_ACK_MESSAGE_BYTES);
+            if (out) {
+                writeReliableAckMessage(out, nextReceiveId_, receivedMask());
+                ackPending_ = false;
+            }
+        }
+        
+        const uint16_t end = inFlightEnd();
+        const float timeout = resendTimeout();
+        bool resentAgain = false;
+        for (uint16_t id = oldestUnacked_; id != end; ++id) {
+            Outgoing& message = outgoing_[id % QUEUE_CAPACITY];
+            if (message.acked || (message.sends > 0 && now - message.sentAt < timeout)) {
+                continue;
+            }
+            uint8_t* out = builder.reserve(WireMessageType::Reliable, RELIABLE_MESSAGE_HEADER_BYTES + message.length);
+            if (!out) {
+                continue;
+            }
+            writeReliableMessage(out, id, message.type, message.body, message.length);
+            if (message.sends > 0) {
+                resends_++;
+                resentAgain = resentAgain || message.sends > 1;
+            }
+            if (message.sends < 255) {
+                message.sends++;
+            }
+            message.sentAt = now;
+        }
+        if (resentAgain && backoff_ < MAX_BACKOFF) {
+            backoff_++;
+        }
+    }
+    
+    // Take the peer's ack (see the Reliable Ack Message layout)
+    void onAck(uint16_t nextExpected, uint32_t received, float now) {
+        // An ack for ids we never sent is stale or forged
+        if (before(nextSendId_, nextExpected)) {
+            return;
+        }
+        
+        const uint16_t end = inFlightEnd();
+        for (uint16_t id = oldestUnacked_; id != end; ++id) {
+            Outgoing& message = outgoing_[id % QUEUE_CAPACITY];
+            if (message.acked || message.sends == 0) {
+                continue;
+            }
+            const uint16_t bit = static_cast<uint16_t>(id - nextExpected - 1);
+            if (!before(id, nextExpected) && !(bit < 32 && ((received >> bit) & 1))) {
+                continue;
+            }
+            message.acked = true;
+            // A resent message's ack may answer any of its copies: no sample
+            if (message.sends == 1) {
+                sampleRtt(now - message.sentAt);
+            }
+        }
+        
+        while (oldestUnacked_ != nextSendId_ && outgoing_[oldestUnacked_ % QUEUE_CAPACITY].acked) {
+            oldestUnacked_++;
+        }
+    }
+    
+    // Take one received message; call deliver() afterwards
+    // Returns: false for a duplicate or an id outside the receive window
+    bool receive(uint16_t id, uint8_t type, const uint8_t* body, size_t length) {
+        ackPending_ = true;
+        if (before(id, nextReceiveId_) || static_cast<uint16_t>(id - nextReceiveId_) >= WINDOW ||
+            length > MAX_RELIABLE_BODY_BYTES) {
+            duplicates_++;
+            return false;
+        }
+        Incoming& slot = incoming_[id % WINDOW];
+        if (slot.present) {
+            duplicates_++;
+            return false;
+        }
+        slot.present = true;
+        slot.type = type;
+        slot.length = static_cast<uint8_t>(length);
+        std::memcpy(slot.body, body, length);
+        return true;
+    }
+    
+    // Hand every message that is now in order to fn(type, body, length), oldest first
+    // fn may send() on this channel
+    template <typename Fn>
+    void deliver(Fn&& fn) {
+        while (incoming_[nextReceiveId_ % WINDOW].present) {
+            Incoming& slot = incoming_[nextReceiveId_ % WINDOW];
+            slot.present = false;
+            nextReceiveId_++;
+            fn(slot.type, static_cast<const uint8_t*>(slot.body), static_cast<size_t>(slot.length));
+        }
+    }
+    
+    // Resend timeout from the RTT estimate, before backoff
+    float timeout() const {
+        if (!hasRttSample_) {
+            return INITIAL_TIMEOUT;
+        }
+        return std::min(MAX_TIMEOUT, std::max(MIN_TIMEOUT, smoothedRtt_ + 4.0f * rttVariance_));
+    }
+    
+    bool hasRttSample() const { return hasRttSample_; }
+    float smoothedRtt() const { return smoothedRtt_; }
+    float rttVariance() const { return rttVariance_; }
+    size_t resends() const { return resends_; }
+    size_t duplicates() const { return duplicates_; }
+    
+    // Messages sent or waiting to be sent that the peer has not acknowledged
+    uint16_t queued() const { return static_cast<uint16_t>(nextSendId_ - oldestUnacked_); }
+    
+private:
+    struct Outgoing {
+        uint8_t type = 0;
+        uint8_t length = 0;
+        uint8_t sends = 0;     // 0 = never sent
+        bool acked = false;
+        float sentAt = 0.0f;   // Time of the latest send
+        uint8_t body[MAX_RELIABLE_BODY_BYTES];
+    };
+    
+    struct Incoming {
+        bool present = false;
+        uint8_t type = 0;
+        uint8_t length = 0;
+        uint8_t body[MAX_RELIABLE_BODY_BYTES];
+    };
+    
+    // Serial number order: a comes before b (valid while they are < 32768 apart)
+    static bool before(uint16_t a, uint16_t b) {
+        return static_cast<int16_t>(static_cast<uint16_t>(a - b)) < 0;
+    }
+    
+    // One past the newest id that may be in flight
+    uint16_t inFlightEnd() const {
+        return queued() > WINDOW ? static_cast<uint16_t>(oldestUnacked_ + WINDOW) : nextSendId_;
+    }
+    
+    float resendTimeout() const {
+        return std::min(MAX_TIMEOUT, timeout() * static_cast<float>(1u << backoff_));
+    }
+    
+    uint32_t receivedMask() const {
+        uint32_t mask = 0;
+        for (uint16_t i = 0; i + 1 < WINDOW; ++i) {
+            if (incoming_[static_cast<uint16_t>(nextReceiveId_ + 1 + i) % WINDOW].present) {
+                mask |= uint32_t(1) << i;
+            }
+        }
+        return mask;
+    }
+    
+    void sampleRtt(float rtt) {
+        backoff_ = 0;
+        if (!hasRttSample_) {
+            smoothedRtt_ = rtt;
+            rttVariance_ = rtt * 0.5f;
+            hasRttSample_ = true;
+            return;
+        }
+        rttVariance_ = 0.75f * rttVariance_ + 0.25f * std::fabs(smoothedRtt_ - rtt);
+        smoothedRtt_ = 0.875f * smoothedRtt_ + 0.125f * rtt;
+    }
+    
+    std::array<Outgoing, QUEUE_CAPACITY> outgoing_;
+    std::array<Incoming, WINDOW> incoming_;
+    uint16_t nextSendId_ = 0;
+    uint16_t oldestUnacked_ = 0;
+    uint16_t nextReceiveId_ = 0;
+    bool ackPending_ = false;
+    bool hasRttSample_ = false;
+    int backoff_ = 0;
+    float smoothedRtt_ = 0.0f;
+    float rttVariance_ = 0.0f;
+    size_t resends_ = 0;
+    size_t duplicates_ = 0;
+};
+
+// ========================
+// Helpers
+// ========================
+
+// One end of a connection: its reliable channel plus what it has delivered
+struct Peer {
+    ReliableChannel channel;
+    uint32_t sequence = 0;
+    std::vector<uint32_t> delivered;     // Message numbers, in delivery order
+    std::vector<float> deliveredAt;
+    float now = 0.0f;
+};
+
+HitPacket numberedHit(uint32_t number) {
+    HitPacket hit;
+    hit.shooterId = 1;
+    hit.victimId = 2;
+    hit.damage = static_cast<float>(number);
+    hit.hitX = 0.0f;
+    hit.hitY = 0.0f;
+    hit.wasKill = false;
+    return hit;
+}
+
+bool sendNumbered(ReliableChannel& channel, uint32_t number) {
+    uint8_t body[HIT_MESSAGE_BYTES];
+    writeHitMessage(body, numberedHit(number));
+    return channel.send(WireMessageType::Hit, body, sizeof(body));
+}
+
+void handleDeliveredHit(const uint8_t* payload, size_t, Peer& peer) {
+    peer.delivered.push_back(static_cast<uint32_t>(HitMessageView(payload).damage()));
+    peer.deliveredAt.push_back(peer.now);
+}
+
+const WireHandler<Peer> PEER_RELIABLE_HANDLERS[WIRE_MESSAGE_TYPE_COUNT] = {
+    nullptr, nullptr, nullptr, handleDeliveredHit, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr
+};
+
+void handlePeerReliable(const uint8_t* payload, size_t length, Peer& peer) {
+    const ReliableMessageView message(payload, length);
+    peer.channel.receive(message.id(), message.type(), message.body(), message.bodyLength());
+    peer.channel.deliver([&](uint8_t type, const uint8_t* body, size_t bodyLength) {
+        if (dispatchWireMessage(type, body, bodyLength, PEER_RELIABLE_HANDLERS, peer) != WireStatus::Ok) {
+            throw std::runtime_error("Delivered message rejected");
+        }
+    });
+}
+
+void handlePeerAck(const uint8_t* payload, size_t, Peer& peer) {
+    const ReliableAckMessageView ack(payload);
+    peer.channel.onAck(ack.nextExpected(), ack.received(), peer.now);
+}
+
+const WireHandler<Peer> PEER_HANDLERS[WIRE_MESSAGE_TYPE_COUNT] = {
+    nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, handlePeerReliable, handlePeerAck
+};
+
+// Datagrams on their way, with the time they arrive
+struct InFlight {
+    float arrival;
+    std::vector<uint8_t> data;
+};
+
+struct LinkProfile {
+    float latency = 0.03f;   // Seconds, one way
+    float jitter = 0.0f;     // Extra delay, uniform in [0, jitter] (reorders datagrams)
+    float loss = 0.0f;       // Probability a datagram is lost
+};
+
+struct LinkStats {
+    size_t sent = 0;
+    size_t delivered = 0;
+    double latencySum = 0.0;
+    float latencyMax = 0.0f;
+    std::vector<float> latencies;
+    size_t bytes = 0;
+    size_t resends = 0;
+    size_t duplicates = 0;
+    bool inOrder = true;
+    
+    double meanLatency() const { return latencies.empty() ? 0.0 : latencySum / latencies.size(); }
+    float percentile(double p) const {
+        std::vector<float> sorted = latencies;
+        std::sort(sorted.begin(), sorted.end());
+        return sorted.empty() ? 0.0f : sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()))];
+    }
+};
+
+// Send `messages` numbered messages from a to b (a few per tick, in bursts) while
+// both peers tick at 60 Hz and write whenever their channel wants to
+LinkStats runLink(const LinkProfile& link, uint32_t messages, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    Peer a;
+    Peer b;
+    std::vector<InFlight> toA;
+    std::vector<InFlight> toB;
+    std::vector<float> sentAt;
+    LinkStats stats;
+    
+    auto transmit = [&](Peer& from, std::vector<InFlight>& queue) {
+        if (!from.channel.wantsToSend(from.now)) return;
+        DatagramBuilder builder([&](const uint8_t* data, size_t size, size_t) {
+            stats.bytes += size + 28;  // IP + UDP headers
+            if (unit(rng) < link.loss) return;
+            queue.push_back({ from.now + link.latency + link.jitter * unit(rng), std::vector<uint8_t>(data, data + size) });
+        }, from.sequence);
+        from.channel.write(builder, from.now);
+        builder.flush();
+        from.sequence = builder.nextSequence();
+    };
+    auto receive = [&](Peer& to, std::vector<InFlight>& queue) {
+        std::sort(queue.begin(), queue.end(), [](const InFlight& x, const InFlight& y) { return x.arrival < y.arrival; });
+        size_t arrived = 0;
+        while (arrived < queue.size() && queue[arrived].arrival <= to.now) {
+            uint32_t sequence = 0;
+            if (decodeDatagram(queue[arrived].data.data(), queue[arrived].data.size(), PEER_HANDLERS, to, sequence) != WireStatus::Ok) {
+                throw std::runtime_error("Datagram rejected");
+            }
+            arrived++;
+        }
+        queue.erase(queue.begin(), queue.begin() + arrived);
+    };
+    
+    const float tick = 1.0f / 60.0f;
+    uint32_t next = 0;
+    for (int step = 0; step < 60 * 600 && b.delivered.size() < messages; ++step) {
+        a.now = b.now = step * tick;
+        receive(a, toA);
+        receive(b, toB);
+        
+        // Bursts of up to 4 messages every few ticks (a fight: several hits at once)
+        if (next < messages && step % 3 == 0) {
+            uint32_t burst = 1 + rng() % 4;
+            for (uint32_t i = 0; i < burst && next < messages; ++i) {
+                if (!sendNumbered(a.channel, next)) break;
+                sentAt.push_back(a.now);
+                next++;
+            }
+        }
+        transmit(a, toB);
+        transmit(b, toA);
+    }
+    
+    stats.sent = next;
+    stats.delivered = b.delivered.size();
+    for (size_t i = 0; i < b.delivered.size(); ++i) {
+        if (b.delivered[i] != i) stats.inOrder = false;
+        const float latency = b.deliveredAt[i] - sentAt[b.delivered[i]];
+        stats.latencies.push_back(latency);
+        stats.latencySum += latency;
+        stats.latencyMax = std::max(stats.latencyMax, latency);
+    }
+    stats.resends = a.channel.resends();
+    stats.duplicates = b.channel.duplicates();
+    return stats;
+}
+
+// Write one datagram from a channel and hand its messages to the handlers
+size_t exchange(ReliableChannel& from, float now, Peer& to) {
+    size_t reliableMessages = 0;
+    DatagramBuilder builder([&](const uint8_t* data, size_t size, size_t count) {
+        uint32_t sequence = 0;
+        to.now = now;
+        if (decodeDatagram(data, size, PEER_HANDLERS, to, sequence) != WireStatus::Ok) {
+            throw std::runtime_error("Datagram rejected");
+        }
+        reliableMessages += count;
+    }, 0);
+    from.write(builder, now);
+    builder.flush();
+    return reliableMessages;
+}
+
+// Count the Reliable messages (not acks) one write() would produce
+size_t countWritten(ReliableChannel& channel, float now) {
+    size_t count = 0;
+    DatagramBuilder builder([&](const uint8_t* data, size_t size, size_t) {
+        size_t pos = WIRE_HEADER_BYTES;
+        while (pos < size) {
+            if (data[pos] == static_cast<uint8_t>(WireMessageType::Reliable)) count++;
+            pos += WIRE_MESSAGE_HEADER_BYTES + loadU16(data + pos + 1);
+        }
+    }, 0);
+    channel.write(builder, now);
+    builder.flush();
+    return count;
+}
+
+// ========================
+// Tests
+// ========================
+
+TEST(MessageLayouts) {
+    uint8_t buffer[64];
+    
+    PurchasePacket purchase;
+    purchase.playerId = 3;
+    purchase.weaponType = PURCHASE_NONE;
+    purchase.ammoType = static_cast<uint8_t>(AmmoType::AMMO_5_45x39);
+    writePurchaseMessage(buffer, purchase);
+    PurchaseMessageView purchaseView(buffer);
+    ASSERT_EQ(3, purchaseView.playerId());
+    ASSERT_EQ(PURCHASE_NONE, purchaseView.weaponType());
+    ASSERT_EQ(1, purchaseView.ammoType());
+    
+    InventoryPacket inventory;
+    inventory.playerId = 3;
+    inventory.slot = 2;
+    inventory.weaponType = 6;
+    inventory.accepted = true;
+    inventory.newMoneyBalance = -250;
+    writeInventoryMessage(buffer, inventory);
+    InventoryMessageView inventoryView(buffer);
+    ASSERT_EQ(2, inventoryView.slot());
+    ASSERT_EQ(6, inventoryView.weaponType());
+    ASSERT_TRUE(inventoryView.accepted());
+    ASSERT_TRUE(inventoryView.newMoneyBalance() == -250);
+    
+    const uint8_t body[3] = { 7, 8, 9 };
+    writeReliableMessage(buffer, 0xBEEF, static_cast<uint8_t>(WireMessageType::Purchase), body, sizeof(body));
+    ReliableMessageView reliableView(buffer, RELIABLE_MESSAGE_HEADER_BYTES + sizeof(body));
+    ASSERT_TRUE(reliableView.id() == 0xBEEF);
+    ASSERT_EQ(static_cast<uint8_t>(WireMessageType::Purchase), reliableView.type());
+    ASSERT_EQ(3, reliableView.bodyLength());
+    ASSERT_EQ(9, reliableView.body()[2]);
+    
+    writeReliableAckMessage(buffer, 0x1234, 0x80000001u);
+    ReliableAckMessageView ackView(buffer);
+    ASSERT_TRUE(ackView.nextExpected() == 0x1234);
+    ASSERT_TRUE(ackView.received() == 0x80000001u);
+}
+
+TEST(DispatchChecksWrappedMessages) {
+    Peer peer;
+    uint8_t body[HIT_MESSAGE_BYTES];
+    writeHitMessage(body, numberedHit(5));
+    ASSERT_TRUE(dispatchWireMessage(static_cast<uint8_t>(WireMessageType::Hit), body, sizeof(body),
+                                    PEER_RELIABLE_HANDLERS, peer) == WireStatus::Ok);
+    ASSERT_TRUE(dispatchWireMessage(static_cast<uint8_t>(WireMessageType::Hit), body, sizeof(body) - 1,
+                                    PEER_RELIABLE_HANDLERS, peer) == WireStatus::BadLength);
+    ASSERT_TRUE(dispatchWireMessage(static_cast<uint8_t>(WireMessageType::Snapshot), body, sizeof(body),
+                                    PEER_RELIABLE_HANDLERS, peer) == WireStatus::UnknownType);
+    ASSERT_TRUE(dispatchWireMessage(200, body, sizeof(body), PEER_RELIABLE_HANDLERS, peer) == WireStatus::UnknownType);
+    ASSERT_EQ(1, peer.delivered.size());
+}
+
+TEST(DeliversInOrderExactlyOnce) {
+    ReliableChannel channel;
+    uint8_t body[HIT_MESSAGE_BYTES];
+    
+    // Ids arrive as 2, 0, 2, 1, 0: delivered as 0, 1, 2
+    Peer peer;
+    const uint16_t order[] = { 2, 0, 2, 1, 0 };
+    for (uint16_t id : order) {
+        writeHitMessage(body, numberedHit(id));
+        peer.channel.receive(id, static_cast<uint8_t>(WireMessageType::Hit), body, sizeof(body));
+        peer.channel.deliver([&](uint8_t type, const uint8_t* b, size_t length) {
+            dispatchWireMessage(type, b, length, PEER_RELIABLE_HANDLERS, peer);
+        });
+        if (id == 2 && peer.delivered.empty()) {
+            // Nothing before the gap is filled
+            ASSERT_EQ(0, peer.delivered.size());
+        }
+    }
+    ASSERT_EQ(3, peer.delivered.size());
+    for (uint32_t i = 0; i < 3; ++i) ASSERT_EQ(i, peer.delivered[i]);
+    ASSERT_EQ(2, peer.channel.duplicates());
+}
+
+TEST(AckMaskCoversBufferedIds) {
+    Peer receiver;
+    uint8_t body[HIT_MESSAGE_BYTES] = {};
+    const uint16_t ids[] = { 0, 2, 5 };
+    for (uint16_t id : ids) {
+        receiver.channel.receive(id, static_cast<uint8_t>(WireMessageType::Hit), body, sizeof(body));
+    }
+    receiver.channel.deliver([](uint8_t, const uint8_t*, size_t) {});
+    
+    uint16_t nextExpected = 0;
+    uint32_t mask = 0;
+    DatagramBuilder builder([&](const uint8_t* data, size_t, size_t) {
+        ASSERT_EQ(static_cast<uint8_t>(WireMessageType::ReliableAck), data[WIRE_HEADER_BYTES]);
+        ReliableAckMessageView ack(data + WIRE_HEADER_BYTES + WIRE_MESSAGE_HEADER_BYTES);
+        nextExpected = ack.nextExpected();
+        mask = ack.received();
+    }, 0);
+    receiver.channel.write(builder, 0.0f);
+    builder.flush();
+    ASSERT_EQ(1, nextExpected);
+    ASSERT_TRUE(mask == ((1u << 0) | (1u << 3)));  // Ids 2 and 5
+    
+    // The ack is sent once; a duplicate arms it again
+    ASSERT_TRUE(!receiver.channel.wantsToSend(0.0f));
+    receiver.channel.receive(0, static_cast<uint8_t>(WireMessageType::Hit), body, sizeof(body));
+    ASSERT_TRUE(receiver.channel.wantsToSend(0.0f));
+}
+
+TEST(SelectiveAckReleasesOnlyReceived) {
+    ReliableChannel sender;
+    for (uint32_t i = 0; i < 6; ++i) sendNumbered(sender, i);
+    ASSERT_EQ(6, countWritten(sender, 0.0f));
+    
+    // Peer got 0, 1, 3 and 5: only 2 and 4 are resent
+    sender.onAck(2, (1u << 0) | (1u << 2), 0.05f);
+    ASSERT_EQ(4, sender.queued());  // 2..5 still queued (oldest unacknowledged is 2)
+    ASSERT_EQ(0, countWritten(sender, 0.06f));
+    ASSERT_EQ(2, countWritten(sender, 1.0f));
+    ASSERT_EQ(2, sender.resends());
+    
+    sender.onAck(6, 0, 1.05f);
+    ASSERT_EQ(0, sender.queued());
+    ASSERT_TRUE(!sender.wantsToSend(5.0f));
+    
+    // Acks for ids never sent are ignored
+    sender.onAck(40, 0, 5.0f);
+    sendNumbered(sender, 6);
+    ASSERT_EQ(1, countWritten(sender, 5.0f));
+}
+
+TEST(ResendTimeoutFollowsRtt) {
+    ReliableChannel sender;
+    ASSERT_NEAR(ReliableChannel::INITIAL_TIMEOUT, sender.timeout(), 1e-6f);
+    
+    // Steady 80 ms round trips
+    float now = 0.0f;
+    for (uint32_t i = 0; i < 40; ++i) {
+        sendNumbered(sender, i);
+        countWritten(sender, now);
+        now += 0.08f;
+        sender.onAck(static_cast<uint16_t>(i + 1), 0, now);
+    }
+    ASSERT_NEAR(0.08f, sender.smoothedRtt(), 0.001f);
+    ASSERT_TRUE(sender.rttVariance() < 0.002f);
+    ASSERT_NEAR(sender.smoothedRtt() + 4.0f * sender.rttVariance(), sender.timeout(), 1e-5f);
+    
+    // A lost message is resent one timeout later; once a resend is lost as
+    // well, the timeout doubles until the next RTT sample
+    sendNumbered(sender, 40);
+    const float sent = now;
+    ASSERT_EQ(1, countWritten(sender, sent));
+    const float timeout = sender.timeout();
+    ASSERT_EQ(0, countWritten(sender, sent + timeout * 0.95f));
+    const float resent = sent + timeout * 1.05f;
+    ASSERT_EQ(1, countWritten(sender, resent));
+    const float resentAgain = resent + timeout * 1.05f;
+    ASSERT_EQ(1, countWritten(sender, resentAgain));
+    ASSERT_EQ(0, countWritten(sender, resentAgain + timeout * 1.95f));
+    ASSERT_EQ(1, countWritten(sender, resentAgain + timeout * 2.05f));
+    
+    // Karn: the ack of a resent message does not move the estimate
+    const float rtt = sender.smoothedRtt();
+    sender.onAck(41, 0, sent + 10.0f);
+    ASSERT_NEAR(rtt, sender.smoothedRtt(), 1e-6f);
+}
+
+TEST(WindowBoundsMessagesInFlight) {
+    ReliableChannel sender;
+    for (uint32_t i = 0; i < 40; ++i) ASSERT_TRUE(sendNumbered(sender, i));
+    ASSERT_EQ(ReliableChannel::WINDOW, countWritten(sender, 0.0f));
+    
+    // Acknowledging the first 10 lets the remaining 8 go out
+    sender.onAck(10, 0, 0.05f);
+    ASSERT_EQ(8, countWritten(sender, 0.05f));
+    
+    // A full queue refuses new messages instead of dropping old ones
+    ReliableChannel stalled;
+    for (uint32_t i = 0; i < ReliableChannel::QUEUE_CAPACITY; ++i) ASSERT_TRUE(sendNumbered(stalled, i));
+    ASSERT_TRUE(!sendNumbered(stalled, 999));
+}
+
+TEST(IdsWrapAround) {
+    // 70,000 messages over a perfect link: ids wrap past 65535 without a hitch
+    Peer receiver;
+    Peer senderPeer;
+    float now = 0.0f;
+    uint32_t sent = 0;
+    while (receiver.delivered.size() < 70000) {
+        for (int i = 0; i < 20 && sent < 70000; ++i) sendNumbered(senderPeer.channel, sent++);
+        now += 0.01f;
+        exchange(senderPeer.channel, now, receiver);
+        exchange(receiver.channel, now, senderPeer);
+    }
+    ASSERT_EQ(0, senderPeer.channel.queued());
+    for (uint32_t i = 0; i < 70000; i += 997) ASSERT_TRUE(receiver.delivered[i] == i);
+    ASSERT_TRUE(receiver.delivered.back() == 69999);
+    ASSERT_EQ(0, senderPeer.channel.resends());
+}
+
+TEST(LossyLinkDeliversEverythingInOrder) {
+    LinkProfile link;
+    link.latency = 0.04f;
+    link.jitter = 0.03f;
+    link.loss = 0.2f;
+    LinkStats stats = runLink(link, 2000, 3);
+    ASSERT_EQ(2000, stats.delivered);
+    ASSERT_TRUE(stats.inOrder);
+    ASSERT_TRUE(stats.resends > 0);
+}
+
+TEST(CleanLinkDeliversInOneTrip) {
+    LinkProfile link;
+    link.latency = 0.04f;
+    LinkStats stats = runLink(link, 1000, 4);
+    ASSERT_EQ(1000, stats.delivered);
+    ASSERT_TRUE(stats.inOrder);
+    ASSERT_EQ(0, stats.resends);
+    // Sent on the tick they were queued, delivered on the tick they arrive
+    ASSERT_TRUE(stats.latencyMax < 0.04f + 1.0f / 60.0f + 0.001f);
+}
+
+// ========================
+// Benchmark
+// ========================
+
+template <typename F>
+double timeNs(int iterations, F&& body) {
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (int k = 0; k < iterations; k++) body(k);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::nano>(end - begin).count() / iterations;
+}
+
+void benchmarkLinks() {
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::setw(7) << "Loss" << std::setw(9) << "Jitter" << std::setw(12) << "Mean ms"
+              << std::setw(10) << "p99 ms" << std::setw(10) << "Max ms" << std::setw(10) << "Resent"
+              << std::setw(14) << "Bytes/msg" << std::endl;
+    const float losses[] = { 0.0f, 0.02f, 0.05f, 0.2f };
+    for (float loss : losses) {
+        LinkProfile link;
+        link.latency = 0.04f;
+        link.jitter = 0.02f;
+        link.loss = loss;
+        LinkStats stats = runLink(link, 5000, 21);
+        std::cout << std::setw(6) << loss * 100.0f << "%" << std::setw(7) << link.jitter * 1000.0f << "ms"
+                  << std::setw(12) << stats.meanLatency() * 1000.0 << std::setw(10) << stats.percentile(0.99) * 1000.0f
+                  << std::setw(10) << stats.latencyMax * 1000.0f
+                  << std::setw(9) << 100.0 * stats.resends / stats.sent << "%"
+                  << std::setw(14) << static_cast<double>(stats.bytes) / stats.sent
+                  << (stats.inOrder && stats.delivered == stats.sent ? "" : "  (INCOMPLETE)") << std::endl;
+    }
+    std::cout << "One-way latency is 40-60 ms; the hit payload is " << HIT_MESSAGE_BYTES << " bytes" << std::endl;
+    
+    // CPU cost per message: send, write, receive + deliver, ack
+    Peer receiver;
+    Peer senderPeer;
+    uint32_t sent = 0;
+    double ns = timeNs(20000, [&](int k) {
+        for (int i = 0; i < 4; ++i) sendNumbered(senderPeer.channel, sent++);
+        const float now = k * 0.01f;
+        exchange(senderPeer.channel, now, receiver);
+        exchange(receiver.channel, now, senderPeer);
+    }) / 4.0;
+    std::cout << "Per message (send, write, receive, deliver, ack): " << std::setprecision(0) << ns << " ns" << std::endl;
+}
+
+// ========================
+// Main Test Runner
+// ========================
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Zero Ground Reliable Channel Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "--- Reliable Channel Tests ---" << std::endl;
+    RUN_TEST(MessageLayouts);
+    RUN_TEST(DispatchChecksWrappedMessages);
+    RUN_TEST(DeliversInOrderExactlyOnce);
+    RUN_TEST(AckMaskCoversBufferedIds);
+    RUN_TEST(SelectiveAckReleasesOnlyReceived);
+    RUN_TEST(ResendTimeoutFollowsRtt);
+    RUN_TEST(WindowBoundsMessagesInFlight);
+    RUN_TEST(IdsWrapAround);
+    RUN_TEST(LossyLinkDeliversEverythingInOrder);
+    RUN_TEST(CleanLinkDeliversInOneTrip);
+
+    std::cout << std::endl;
+    std::cout << "--- Delivery Latency over Simulated Links (60 Hz, 40 ms + jitter) ---" << std::endl;
+    benchmarkLinks();
+
+    // Print summary
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Test Summary" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Total tests: " << totalTests << std::endl;
+    std::cout << "Passed: " << passedTests << std::endl;
+    std::cout << "Failed: " << failedTests << std::endl;
+    std::cout << std::endl;
+
+    if (failedTests == 0) {
+        std::cout << "✓ All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "✗ Some tests failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,304 @@
+// Server Command Line Tests for Zero Ground
+// Checks parseCommandLine(): --headless, --tick-rate and --snapshot-rate in both
+// the --name=N and --name N forms, out-of-range, non-numeric and missing values
+// keeping the current rate with a warning, and unknown options being reported.
+//
+// ErrorHandler is replaced by a stand-in that records warnings.
+// Code under test is copied from Zero_Ground.cpp.
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+// ========================
+// Test Framework Macros
+// ========================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "Running test: " << #name << "..."; \
+    try { \
+        test_##name(); \
+        std::cout << " PASSED" << std::endl; \
+        passedTests++; \
+    } catch (const std::exception& e) { \
+        std::cout << " FAILED: " << e.what() << std::endl; \
+        failedTests++; \
+    } \
+    totalTests++; \
+} while(0)
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: " << #condition << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_NEAR(expected, actual, epsilon) do { \
+    if (std::abs((expected) - (actual)) > (epsilon)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << (expected) << " but got " << (actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(expected, actual) do { \
+    if ((expected) != (actual)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << static_cast<int>(expected) << " but got " << static_cast<int>(actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+// Test counters
+int totalTests = 0;
+int passedTests = 0;
+int failedTests = 0;
+
+
+// ========================
+// Stand-ins
+// ========================
+
+// Records warnings so tests can check what was reported
+struct ErrorHandler {
+    static std::vector<std::string> warnings;
+    static void logInfo(const std::string&) {}
+    static void logWarning(const std::string& message) { warnings.push_back(message); }
+};
+std::vector<std::string> ErrorHandler::warnings;
+
+// ========================
+// Code Under Test (copied from Zero_Ground.cpp)
+// ========================
+
+// Dedicated server mode (--headless): no window, no host player
+bool headlessMode = false;
+
+// Authoritative simulation tick rate in Hz (--tick-rate=N, 10..240)
+// Snapshots are sent at serverSnapshotRate regardless of the tick rate
+int serverTickRate = 60;
+
+// Snapshot send rate in Hz (--snapshot-rate=N, 5..60); clients interpolate
+// with a delay adapted to it, so lower rates trade latency for bandwidth
+int serverSnapshotRate = 20;
+
+// Apply the command line options to headlessMode, serverTickRate and
+// serverSnapshotRate. Invalid values and unknown options are logged as
+// warnings and keep the current value
+void parseCommandLine(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--headless") {
+            headlessMode = true;
+        } else if (arg.rfind("--tick-rate", 0) == 0) {
+            // Accept both --tick-rate=N and --tick-rate N
+            std::string value;
+            if (arg.size() > 12 && arg[11] == '=') {
+                value = arg.substr(12);
+            } else if (arg.size() == 11 && i + 1 < argc) {
+                value = argv[++i];
+            }
+            
+            int rate = std::atoi(value.c_str());
+            if (rate >= 10 && rate <= 240) {
+                serverTickRate = rate;
+            } else {
+                ErrorHandler::logWarning("Invalid tick rate '" + value + "' (expected 10-240), using " +
+                                         std::to_string(serverTickRate) + " Hz");
+            }
+        } else if (arg.rfind("--snapshot-rate", 0) == 0) {
+            // Accept both --snapshot-rate=N and --snapshot-rate N
+            std::string value;
+            if (arg.size() > 16 && arg[15] == '=') {
+                value = arg.substr(16);
+            } else if (arg.size() == 15 && i + 1 < argc) {
+                value = argv[++i];
+            }
+            
+            int rate = std::atoi(value.c_str());
+            if (rate >= 5 && rate <= 60) {
+                serverSnapshotRate = rate;
+            } else {
+                ErrorHandler::logWarning("Invalid snapshot rate '" + value + "' (expected 5-60), using " +
+                                         std::to_string(serverSnapshotRate) + " Hz");
+            }
+        } else {
+            ErrorHandler::logWarning("Unknown command line option: " + arg);
+        }
+    }
+}
+
+// ========================
+// Test Helpers
+// ========================
+
+// Run parseCommandLine() on "Zero_Ground.exe <args>" from the default settings
+void parse(const std::vector<std::string>& args) {
+    headlessMode = false;
+    serverTickRate = 60;
+    serverSnapshotRate = 20;
+    ErrorHandler::warnings.clear();
+    
+    std::vector<std::string> storage;
+    storage.push_back("Zero_Ground.exe");
+    storage.insert(storage.end(), args.begin(), args.end());
+    std::vector<char*> argv;
+    for (std::string& arg : storage) {
+        argv.push_back(&arg[0]);
+    }
+    argv.push_back(nullptr);
+    parseCommandLine(static_cast<int>(storage.size()), argv.data());
+}
+
+bool warned(const std::string& text) {
+    for (const std::string& warning : ErrorHandler::warnings) {
+        if (warning.find(text) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ========================
+// Command Line Tests
+// ========================
+
+TEST(NoOptionsKeepDefaults) {
+    parse({});
+    
+    ASSERT_TRUE(!headlessMode);
+    ASSERT_EQ(60, serverTickRate);
+    ASSERT_EQ(20, serverSnapshotRate);
+    ASSERT_EQ(0, static_cast<int>(ErrorHandler::warnings.size()));
+}
+
+TEST(HeadlessFlag) {
+    parse({"--headless"});
+    
+    ASSERT_TRUE(headlessMode);
+    ASSERT_EQ(60, serverTickRate);
+    ASSERT_EQ(0, static_cast<int>(ErrorHandler::warnings.size()));
+}
+
+TEST(TickRateBothForms) {
+    parse({"--tick-rate=128"});
+    ASSERT_EQ(128, serverTickRate);
+    ASSERT_EQ(0, static_cast<int>(ErrorHandler::warnings.size()));
+    
+    parse({"--tick-rate", "30"});
+    ASSERT_EQ(30, serverTickRate);
+    ASSERT_EQ(0, static_cast<int>(ErrorHandler::warnings.size()));
+    
+    // Range limits are inclusive
+    parse({"--tick-rate=10"});
+    ASSERT_EQ(10, serverTickRate);
+    parse({"--tick-rate=240"});
+    ASSERT_EQ(240, serverTickRate);
+}
+
+TEST(InvalidTickRateKeepsDefault) {
+    const char* values[] = { "5", "9", "241", "0", "-60", "abc", "" };
+    for (const char* value : values) {
+        parse({std::string("--tick-rate=") + value});
+        ASSERT_EQ(60, serverTickRate);
+        ASSERT_EQ(1, static_cast<int>(ErrorHandler::warnings.size()));
+        ASSERT_TRUE(warned(std::string("Invalid tick rate '") + value + "' (expected 10-240), using 60 Hz"));
+    }
+}
+
+TEST(MissingTickRateValueWarns) {
+    parse({"--tick-rate"});
+    
+    ASSERT_EQ(60, serverTickRate);
+    ASSERT_TRUE(warned("Invalid tick rate ''"));
+}
+
+TEST(TickRateValueIsNotReadAsAnOption) {
+    // The separate value is consumed, so it is not reported as unknown
+    parse({"--tick-rate", "128", "--headless"});
+    
+    ASSERT_EQ(128, serverTickRate);
+    ASSERT_TRUE(headlessMode);
+    ASSERT_EQ(0, static_cast<int>(ErrorHandler::warnings.size()));
+}
+
+TEST(SnapshotRateBothForms) {
+    parse({"--snapshot-rate=30"});
+    ASSERT_EQ(30, serverSnapshotRate);
+    
+    parse({"--snapshot-rate", "10"});
+    ASSERT_EQ(10, serverSnapshotRate);
+    ASSERT_EQ(0, static_cast<int>(ErrorHandler::warnings.size()));
+    
+    parse({"--snapshot-rate=4"});
+    ASSERT_EQ(20, serverSnapshotRate);
+    ASSERT_TRUE(warned("Invalid snapshot rate '4' (expected 5-60), using 20 Hz"));
+    
+    parse({"--snapshot-rate=61"});
+    ASSERT_EQ(20, serverSnapshotRate);
+    ASSERT_EQ(1, static_cast<int>(ErrorHandler::warnings.size()));
+}
+
+TEST(AllOptionsTogether) {
+    parse({"--headless", "--tick-rate=128", "--snapshot-rate", "30"});
+    
+    ASSERT_TRUE(headlessMode);
+    ASSERT_EQ(128, serverTickRate);
+    ASSERT_EQ(30, serverSnapshotRate);
+    ASSERT_EQ(0, static_cast<int>(ErrorHandler::warnings.size()));
+}
+
+TEST(UnknownOptionWarns) {
+    parse({"--fullscreen", "--headless"});
+    
+    ASSERT_TRUE(headlessMode);
+    ASSERT_EQ(1, static_cast<int>(ErrorHandler::warnings.size()));
+    ASSERT_TRUE(warned("Unknown command line option: --fullscreen"));
+}
+
+// ========================
+// Main Test Runner
+// ========================
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Zero Ground Server Command Line Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "--- Command Line Tests ---" << std::endl;
+    RUN_TEST(NoOptionsKeepDefaults);
+    RUN_TEST(HeadlessFlag);
+    RUN_TEST(TickRateBothForms);
+    RUN_TEST(InvalidTickRateKeepsDefault);
+    RUN_TEST(MissingTickRateValueWarns);
+    RUN_TEST(TickRateValueIsNotReadAsAnOption);
+    RUN_TEST(SnapshotRateBothForms);
+    RUN_TEST(AllOptionsTogether);
+    RUN_TEST(UnknownOptionWarns);
+
+    // Print summary
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Test Summary" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Total tests: " << totalTests << std::endl;
+    std::cout << "Passed: " << passedTests << std::endl;
+    std::cout << "Failed: " << failedTests << std::endl;
+    std::cout << std::endl;
+
+    if (failedTests == 0) {
+        std::cout << "✓ All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "✗ Some tests failed!" << std::endl;
+        return 1;
+    }
+}
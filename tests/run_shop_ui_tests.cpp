@@ -0,0 +1,2025 @@
+// Retained Shop UI Tests and Benchmark for Zero Ground
+// Checks the retained-mode shop layer against the immediate-mode shop it
+// replaces: same catalog text, status strings and panel tints, hover under the
+// open animation's scale, money and status updates only when they change.
+// Also compares text layouts, draw calls, glyphs rasterized and CPU time per
+// frame with the shop opening, open (steady, with tooltip, while buying) and
+// closed.
+//
+// Code under test is copied from Zero_Ground.cpp; the SFML types it touches are
+// replaced by stand-ins that count text layouts and draw calls and do SFML's
+// per-character glyph layout. Build with /O2 (or -O2).
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <array>
+#include <map>
+#include <memory>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <limits>
+#include <functional>
+#include <stdexcept>
+#include <cstdint>
+
+// ========================
+// Test Framework Macros
+// ========================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "Running test: " << #name << "..."; \
+    try { \
+        test_##name(); \
+        std::cout << " PASSED" << std::endl; \
+        passedTests++; \
+    } catch (const std::exception& e) { \
+        std::cout << " FAILED: " << e.what() << std::endl; \
+        failedTests++; \
+    } \
+    totalTests++; \
+} while(0)
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: " << #condition << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_NEAR(expected, actual, epsilon) do { \
+    if (std::abs((expected) - (actual)) > (epsilon)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << (expected) << " but got " << (actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(expected, actual) do { \
+    if ((expected) != (actual)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << static_cast<int>(expected) << " but got " << static_cast<int>(actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+// Test counters
+int totalTests = 0;
+int passedTests = 0;
+int failedTests = 0;
+
+
+// ========================
+// Code Under Test (copied from Zero_Ground.cpp)
+// ========================
+
+// Stand-ins for the SFML types used by the shop UI. sf::Text counts string
+// assignments: each one is a glyph layout in SFML.
+long long g_textLayouts = 0;
+long long g_textObjects = 0;
+long long g_drawCalls = 0;
+long long g_glyphsRasterized = 0;
+
+namespace sf {
+typedef uint8_t Uint8;
+struct Vector2f {
+    float x = 0.0f;
+    float y = 0.0f;
+    Vector2f() {}
+    Vector2f(float x_, float y_) : x(x_), y(y_) {}
+};
+struct Vector2u {
+    unsigned x = 0;
+    unsigned y = 0;
+    Vector2u() {}
+    Vector2u(unsigned x_, unsigned y_) : x(x_), y(y_) {}
+};
+struct Vector2i {
+    int x = 0;
+    int y = 0;
+};
+struct FloatRect {
+    float left = 0.0f, top = 0.0f, width = 0.0f, height = 0.0f;
+    FloatRect() {}
+    FloatRect(float l, float t, float w, float h) : left(l), top(t), width(w), height(h) {}
+    bool contains(float x, float y) const { return x >= left && x < left + width && y >= top && y < top + height; }
+    bool contains(Vector2f p) const { return contains(p.x, p.y); }
+};
+struct Color {
+    Uint8 r = 0, g = 0, b = 0, a = 255;
+    Color() {}
+    Color(Uint8 r_, Uint8 g_, Uint8 b_, Uint8 a_ = 255) : r(r_), g(g_), b(b_), a(a_) {}
+    static const Color White, Green, Red, Yellow, Transparent;
+};
+const Color Color::White(255, 255, 255);
+const Color Color::Green(0, 255, 0);
+const Color Color::Red(255, 0, 0);
+const Color Color::Yellow(255, 255, 0);
+const Color Color::Transparent(0, 0, 0, 0);
+class Time {
+public:
+    float asSeconds() const { return 0.0f; }
+};
+class Clock {
+public:
+    Time getElapsedTime() const { return Time(); }
+    Time restart() { return Time(); }
+};
+// Glyph layout as in SFML 2.6: a text rebuilds its vertices on the next draw
+// or bounds query after its string, size or style changed. Per character that
+// is a kerning lookup (both characters' glyph indices and hinting deltas, then
+// the pair's kerning), a glyph lookup in the page for the character size and
+// one quad. A new fill color is written into every vertex. Font does those
+// lookups on a synthetic glyph table, so the CPU times include the work SFML
+// does per layout; rasterizing a glyph on first use is counted, not timed.
+struct Vertex {
+    Vector2f position;
+    Color color;
+    Vector2f texCoords;
+};
+struct Glyph {
+    float advance = 0.0f;
+    int lsbDelta = 0;
+    int rsbDelta = 0;
+    FloatRect bounds;
+    FloatRect textureRect;
+};
+class Font {
+public:
+    Font() {
+        for (uint32_t c = 32; c < 256; ++c) {
+            charmap_[c] = c - 29;
+        }
+        const std::string kerned = "AFLPTVWYfrvy";
+        for (char first : kerned) {
+            for (uint32_t second = 'a'; second <= 'z'; ++second) {
+                kerning_[(uint64_t(charmap_[static_cast<uint8_t>(first)]) << 32) | charmap_[second]] = -40;
+            }
+        }
+    }
+    
+    const Glyph& getGlyph(uint32_t codePoint, unsigned size, bool bold) const {
+        Page& page = pages_[size];
+        const uint64_t key = (uint64_t(bold) << 32) | glyphIndex(codePoint);
+        auto found = page.find(key);
+        if (found != page.end()) {
+            return found->second;
+        }
+        g_glyphsRasterized++;
+        Glyph glyph;
+        glyph.advance = std::round(size * (0.45f + (codePoint % 7) * 0.03f));
+        glyph.lsbDelta = static_cast<int>(codePoint % 3);
+        glyph.rsbDelta = static_cast<int>(codePoint % 5);
+        glyph.bounds = FloatRect(1.0f, -0.7f * size, glyph.advance - 2.0f, 0.7f * size);
+        glyph.textureRect = FloatRect(static_cast<float>(page.size() * size), 0.0f, glyph.advance, static_cast<float>(size));
+        return page.emplace(key, glyph).first->second;
+    }
+    
+    float getKerning(uint32_t first, uint32_t second, unsigned size, bool bold) const {
+        if (first == 0 || second == 0) {
+            return 0.0f;
+        }
+        const uint32_t index1 = glyphIndex(first);
+        const uint32_t index2 = glyphIndex(second);
+        const float firstRsbDelta = static_cast<float>(getGlyph(first, size, bold).rsbDelta);
+        const float secondLsbDelta = static_cast<float>(getGlyph(second, size, bold).lsbDelta);
+        auto kerning = kerning_.find((uint64_t(index1) << 32) | index2);
+        const float pairKerning = kerning != kerning_.end() ? static_cast<float>(kerning->second * static_cast<int>(size)) : 0.0f;
+        return std::floor((secondLsbDelta - firstRsbDelta + pairKerning + 32) / 64.0f);
+    }
+    
+    float getLineSpacing(unsigned size) const { return std::round(size * 1.15f); }
+    
+private:
+    typedef std::map<uint64_t, Glyph> Page;
+    
+    uint32_t glyphIndex(uint32_t codePoint) const {
+        auto found = charmap_.find(codePoint);
+        return found != charmap_.end() ? found->second : 0;
+    }
+    
+    mutable std::map<unsigned, Page> pages_;
+    std::map<uint32_t, uint32_t> charmap_;
+    std::map<uint64_t, int> kerning_;
+};
+// Scale + translation is all the shop uses
+class Transform {
+public:
+    Transform& translate(float x, float y) { tx_ += sx_ * x; ty_ += sy_ * y; return *this; }
+    Transform& translate(const Vector2f& v) { return translate(v.x, v.y); }
+    Transform& scale(float x, float y) { sx_ *= x; sy_ *= y; return *this; }
+    Transform getInverse() const {
+        Transform inverse;
+        inverse.sx_ = 1.0f / sx_;
+        inverse.sy_ = 1.0f / sy_;
+        inverse.tx_ = -tx_ / sx_;
+        inverse.ty_ = -ty_ / sy_;
+        return inverse;
+    }
+    Vector2f transformPoint(float x, float y) const { return Vector2f(sx_ * x + tx_, sy_ * y + ty_); }
+private:
+    float sx_ = 1.0f, sy_ = 1.0f, tx_ = 0.0f, ty_ = 0.0f;
+};
+struct RenderStates {
+    RenderStates() {}
+    RenderStates(const Transform& transform_) : transform(transform_) {}
+    Transform transform;
+};
+class Transformable {
+public:
+    void setPosition(float x, float y) { position_ = Vector2f(x, y); }
+    void setPosition(Vector2f position) { position_ = position; }
+    Vector2f getPosition() const { return position_; }
+private:
+    Vector2f position_;
+};
+class Text : public Transformable {
+public:
+    enum Style { Regular = 0, Bold = 1 };
+    Text() { g_textObjects++; }
+    Text(const Text& other) = default;
+    Text& operator=(const Text& other) = default;
+    void setFont(const Font& font) {
+        if (font_ != &font) {
+            font_ = &font;
+            geometryNeedUpdate_ = true;
+        }
+    }
+    void setString(const std::string& string) { string_ = string; g_textLayouts++; geometryNeedUpdate_ = true; }
+    void setCharacterSize(unsigned size) {
+        if (size_ != size) {
+            size_ = size;
+            geometryNeedUpdate_ = true;
+        }
+    }
+    void setFillColor(Color color) {
+        if (color.r == color_.r && color.g == color_.g && color.b == color_.b && color.a == color_.a) {
+            return;
+        }
+        color_ = color;
+        if (!geometryNeedUpdate_) {
+            for (Vertex& vertex : vertices_) {
+                vertex.color = color;
+            }
+        }
+    }
+    void setStyle(unsigned style) {
+        if (style_ != style) {
+            style_ = style;
+            geometryNeedUpdate_ = true;
+        }
+    }
+    const std::string& getString() const { return string_; }
+    unsigned getCharacterSize() const { return size_; }
+    Color getFillColor() const { return color_; }
+    // Layout-independent bounds keep the expected positions simple; the query
+    // still pays for the geometry as in SFML
+    FloatRect getLocalBounds() const {
+        ensureGeometryUpdate();
+        return FloatRect(0.0f, 0.0f, string_.size() * size_ * 0.5f, static_cast<float>(size_));
+    }
+    
+    void ensureGeometryUpdate() const {
+        if (font_ == nullptr || !geometryNeedUpdate_) {
+            return;
+        }
+        geometryNeedUpdate_ = false;
+        vertices_.clear();
+        bounds_ = FloatRect();
+        if (string_.empty()) {
+            return;
+        }
+        
+        const bool bold = (style_ & Bold) != 0;
+        const float whitespaceWidth = font_->getGlyph(' ', size_, bold).advance;
+        const float lineSpacing = font_->getLineSpacing(size_);
+        float x = 0.0f;
+        float y = static_cast<float>(size_);
+        float minX = static_cast<float>(size_), minY = static_cast<float>(size_), maxX = 0.0f, maxY = 0.0f;
+        uint32_t prevChar = 0;
+        for (unsigned char c : string_) {
+            const uint32_t curChar = c;
+            if (curChar == '\r') {
+                continue;
+            }
+            x += font_->getKerning(prevChar, curChar, size_, bold);
+            prevChar = curChar;
+            
+            if (curChar == ' ' || curChar == '\n' || curChar == '\t') {
+                minX = std::min(minX, x);
+                minY = std::min(minY, y);
+                if (curChar == ' ') {
+                    x += whitespaceWidth;
+                } else if (curChar == '\t') {
+                    x += whitespaceWidth * 4;
+                } else {
+                    y += lineSpacing;
+                    x = 0.0f;
+                }
+                maxX = std::max(maxX, x);
+                maxY = std::max(maxY, y);
+                continue;
+            }
+            
+            const Glyph& glyph = font_->getGlyph(curChar, size_, bold);
+            const float left = x + glyph.bounds.left;
+            const float top = y + glyph.bounds.top;
+            const float right = left + glyph.bounds.width;
+            const float bottom = top + glyph.bounds.height;
+            const float u1 = glyph.textureRect.left;
+            const float v1 = glyph.textureRect.top;
+            const float u2 = u1 + glyph.textureRect.width;
+            const float v2 = v1 + glyph.textureRect.height;
+            vertices_.push_back({ Vector2f(left, top), color_, Vector2f(u1, v1) });
+            vertices_.push_back({ Vector2f(right, top), color_, Vector2f(u2, v1) });
+            vertices_.push_back({ Vector2f(left, bottom), color_, Vector2f(u1, v2) });
+            vertices_.push_back({ Vector2f(left, bottom), color_, Vector2f(u1, v2) });
+            vertices_.push_back({ Vector2f(right, top), color_, Vector2f(u2, v1) });
+            vertices_.push_back({ Vector2f(right, bottom), color_, Vector2f(u2, v2) });
+            
+            minX = std::min(minX, left);
+            maxX = std::max(maxX, right);
+            minY = std::min(minY, top);
+            maxY = std::max(maxY, bottom);
+            x += glyph.advance;
+        }
+        bounds_ = FloatRect(minX, minY, maxX - minX, maxY - minY);
+    }
+    
+private:
+    std::string string_;
+    unsigned size_ = 30;
+    unsigned style_ = Regular;
+    Color color_;
+    const Font* font_ = nullptr;
+    mutable std::vector<Vertex> vertices_;
+    mutable FloatRect bounds_;
+    mutable bool geometryNeedUpdate_ = true;
+};
+class RectangleShape : public Transformable {
+public:
+    RectangleShape() {}
+    RectangleShape(Vector2f size) : size_(size) {}
+    void setSize(Vector2f size) { size_ = size; }
+    Vector2f getSize() const { return size_; }
+    void setFillColor(Color color) { fill_ = color; }
+    void setOutlineColor(Color color) { outline_ = color; }
+    void setOutlineThickness(float) {}
+    Color getFillColor() const { return fill_; }
+    Color getOutlineColor() const { return outline_; }
+private:
+    Vector2f size_;
+    Color fill_;
+    Color outline_;
+};
+class RenderWindow {
+public:
+    Vector2u getSize() const { return size; }
+    void draw(const Text& text, const RenderStates& = RenderStates()) {
+        text.ensureGeometryUpdate();
+        g_drawCalls++;
+        lastTexts.push_back(text.getString());
+    }
+    void draw(const RectangleShape&, const RenderStates& = RenderStates()) { g_drawCalls++; }
+    Vector2u size = Vector2u(1920, 1080);
+    std::vector<std::string> lastTexts;
+};
+namespace Mouse {
+Vector2i position;
+inline Vector2i getPosition(const RenderWindow&) { return position; }
+}
+}
+
+// Player fields the shop reads (trimmed from Zero_Ground.cpp)
+struct Weapon;
+
+struct Player {
+    uint32_t id = 0;
+    std::array<Weapon*, 4> inventory = {nullptr, nullptr, nullptr, nullptr};
+    int money = 50000;    // Starting money
+    int pistolAmmo = 60;
+    int rifleAmmo = 90;
+    int sniperAmmo = 20;
+    
+    bool hasInventorySpace() const {
+        for (int i = 0; i < 4; i++) {
+            if (inventory[i] == nullptr) return true;
+        }
+        return false;
+    }
+};
+
+// ========================
+// Ammo System Data Structures
+// ========================
+
+enum class AmmoType : uint8_t {
+    AMMO_9x18 = 0,    // Pistol ammo
+    AMMO_5_45x39 = 1, // Rifle ammo
+    AMMO_7_62x54 = 2  // Sniper ammo
+};
+
+struct AmmoItem {
+    AmmoType type;
+    std::string name;
+    int price;
+    int quantity;
+    
+    static AmmoItem* create(AmmoType type) {
+        AmmoItem* ammo = new AmmoItem();
+        ammo->type = type;
+        
+        switch (type) {
+            case AmmoType::AMMO_9x18:
+                ammo->name = "Bullets 9x18";
+                ammo->price = 100;
+                ammo->quantity = 10;
+                break;
+            case AmmoType::AMMO_5_45x39:
+                ammo->name = "Bullets 5,45x39";
+                ammo->price = 150;
+                ammo->quantity = 30;
+                break;
+            case AmmoType::AMMO_7_62x54:
+                ammo->name = "Bullets 7,62x54";
+                ammo->price = 200;
+                ammo->quantity = 5;
+                break;
+        }
+        
+        return ammo;
+    }
+};
+
+// ========================
+// Weapon System Data Structures
+// ========================
+
+struct Weapon {
+    enum Type {
+        USP = 0, GLOCK = 1, FIVESEVEN = 2, R8 = 3,      // Pistols
+        GALIL = 4, M4 = 5, AK47 = 6,                     // Rifles
+        M10 = 7, AWP = 8, M40 = 9                        // Snipers
+    };
+    
+    // Get ammo type for this weapon
+    AmmoType getAmmoType() const {
+        if (type == USP || type == GLOCK || type == FIVESEVEN || type == R8) {
+            return AmmoType::AMMO_9x18;  // Pistols use 9x18
+        } else if (type == GALIL || type == M4 || type == AK47) {
+            return AmmoType::AMMO_5_45x39;  // Rifles use 5.45x39
+        } else {
+            return AmmoType::AMMO_7_62x54;  // Snipers use 7.62x54
+        }
+    }
+    
+    Type type;
+    std::string name;
+    int price;
+    int magazineSize;
+    int currentAmmo;
+    float damage;
+    float range;              // Effective range in pixels
+    float bulletSpeed;        // Pixels per second
+    float reloadTime;         // Seconds
+    float movementSpeed;      // Player speed modifier
+    float fireRate;           // Shots per second (for automatic weapons)
+    sf::Clock lastShotTime;   // For fire rate limiting
+    bool isReloading;
+    sf::Clock reloadClock;
+    
+    // Get pointer to player's ammo pool for this weapon type
+    int* getAmmoPool(Player* player) {
+        AmmoType ammoType = getAmmoType();
+        switch (ammoType) {
+            case AmmoType::AMMO_9x18: return &player->pistolAmmo;
+            case AmmoType::AMMO_5_45x39: return &player->rifleAmmo;
+            case AmmoType::AMMO_7_62x54: return &player->sniperAmmo;
+        }
+        return nullptr;
+    }
+    
+    // Factory method to create weapons with proper stats
+    static Weapon* create(Type type) {
+        Weapon* w = new Weapon();
+        w->type = type;
+        w->isReloading = false;
+        w->currentAmmo = 0;  // Will be set below
+        
+        switch (type) {
+            case USP:
+                w->name = "USP";
+                w->price = 0;
+                w->magazineSize = 12;
+                w->damage = 15.0f;
+                w->range = 250.0f;
+                w->bulletSpeed = 600.0f;
+                w->reloadTime = 2.0f;
+                w->movementSpeed = 2.5f;
+                w->fireRate = 0.0f;  // Не автоматическое
+                break;
+            case GLOCK:
+                w->name = "Glock-18";
+                w->price = 1000;
+                w->magazineSize = 20;
+                w->damage = 10.0f;
+                w->range = 300.0f;
+                w->bulletSpeed = 600.0f;
+                w->reloadTime = 2.0f;
+                w->movementSpeed = 2.5f;
+                w->fireRate = 0.0f;  // Не автоматическое
+                break;
+            case FIVESEVEN:
+                w->name = "Five-SeveN";
+                w->price = 2500;
+                w->magazineSize = 20;
+                w->damage = 10.0f;
+                w->range = 400.0f;
+                w->bulletSpeed = 800.0f;
+                w->reloadTime = 2.0f;
+                w->movementSpeed = 2.5f;
+                w->fireRate = 0.0f;  // Не автоматическое
+                break;
+            case R8:
+                w->name = "R8 Revolver";
+                w->price = 4250;
+                w->magazineSize = 8;
+                w->damage = 50.0f;
+                w->range = 200.0f;
+                w->bulletSpeed = 700.0f;
+                w->reloadTime = 5.0f;
+                w->movementSpeed = 2.5f;
+                w->fireRate = 0.0f;  // Не автоматическое
+                break;
+            case GALIL:
+                w->name = "Galil AR";
+                w->price = 10000;
+                w->magazineSize = 35;
+                w->damage = 25.0f;
+                w->range = 450.0f;
+                w->bulletSpeed = 900.0f;
+                w->reloadTime = 3.0f;
+                w->movementSpeed = 2.0f;
+                w->fireRate = 10.0f;  // 10 выстрелов в секунду
+                break;
+            case M4:
+                w->name = "M4";
+                w->price = 15000;
+                w->magazineSize = 30;
+                w->damage = 30.0f;
+                w->range = 425.0f;
+                w->bulletSpeed = 850.0f;
+                w->reloadTime = 3.0f;
+                w->movementSpeed = 1.8f;
+                w->fireRate = 10.0f;  // 10 выстрелов в секунду
+                break;
+            case AK47:
+                w->name = "AK-47";
+                w->price = 17500;
+                w->magazineSize = 25;
+                w->damage = 35.0f;
+                w->range = 450.0f;
+                w->bulletSpeed = 900.0f;
+                w->reloadTime = 3.0f;
+                w->movementSpeed = 1.6f;
+                w->fireRate = 10.0f;  // 10 выстрелов в секунду
+                break;
+            case M10:
+                w->name = "M10";
+                w->price = 20000;
+                w->magazineSize = 5;
+                w->damage = 50.0f;
+                w->range = 1000.0f;
+                w->bulletSpeed = 2000.0f;
+                w->reloadTime = 4.0f;
+                w->movementSpeed = 1.1f;
+                w->fireRate = 0.0f;  // Не автоматическое
+                break;
+            case AWP:
+                w->name = "AWP";
+                w->price = 25000;
+                w->magazineSize = 1;
+                w->damage = 100.0f;
+                w->range = 1000.0f;
+                w->bulletSpeed = 2000.0f;
+                w->reloadTime = 1.5f;
+                w->movementSpeed = 1.0f;
+                w->fireRate = 0.0f;  // Не автоматическое
+                break;
+            case M40:
+                w->name = "M40";
+                w->price = 22000;
+                w->magazineSize = 1;
+                w->damage = 99.0f;
+                w->range = 2000.0f;
+                w->bulletSpeed = 4000.0f;
+                w->reloadTime = 1.5f;
+                w->movementSpeed = 1.2f;
+                w->fireRate = 0.0f;  // Не автоматическое
+                break;
+        }
+        
+        // Initialize with full magazine
+        w->currentAmmo = w->magazineSize;
+        
+        return w;
+    }
+    
+    bool canFire() const {
+        return !isReloading && currentAmmo > 0;
+    }
+    
+    bool isAutomatic() const {
+        return fireRate > 0.0f;
+    }
+    
+    bool canFireAutomatic() const {
+        if (!canFire() || !isAutomatic()) return false;
+        float timeSinceLastShot = lastShotTime.getElapsedTime().asSeconds();
+        float fireInterval = 1.0f / fireRate;
+        return timeSinceLastShot >= fireInterval;
+    }
+    
+    void startReload(Player* player) {
+        int* ammoPool = getAmmoPool(player);
+        if (ammoPool && *ammoPool > 0 && currentAmmo < magazineSize) {
+            isReloading = true;
+            reloadClock.restart();
+        }
+    }
+    
+    void updateReload(Player* player) {
+        if (isReloading && reloadClock.getElapsedTime().asSeconds() >= reloadTime) {
+            int* ammoPool = getAmmoPool(player);
+            if (ammoPool) {
+                // Transfer ammo from shared pool to magazine
+                int ammoNeeded = magazineSize - currentAmmo;
+                int ammoToTransfer = std::min(ammoNeeded, *ammoPool);
+                currentAmmo += ammoToTransfer;
+                *ammoPool -= ammoToTransfer;
+            }
+            isReloading = false;
+        }
+    }
+    
+    void fire() {
+        if (canFire()) {
+            currentAmmo--;
+            lastShotTime.restart();
+        }
+    }
+};
+
+// ========================
+// Purchase Status System
+// ========================
+
+// Enum for purchase status
+// Requirement 3.5: Show purchase status
+enum class PurchaseStatus {
+    Purchasable,
+    InsufficientFunds,
+    InventoryFull
+};
+
+// Calculate purchase status for a player and weapon
+// Requirement 3.5: Purchase status calculation
+PurchaseStatus calculatePurchaseStatus(const Player& player, const Weapon* weapon) {
+    // Check if inventory is full
+    if (!player.hasInventorySpace()) {
+        return PurchaseStatus::InventoryFull;
+    }
+    
+    // Check if player has sufficient funds
+    if (player.money < weapon->price) {
+        return PurchaseStatus::InsufficientFunds;
+    }
+    
+    // Player can purchase
+    return PurchaseStatus::Purchasable;
+}
+
+// Get purchase status text
+std::string getPurchaseStatusText(PurchaseStatus status, int weaponPrice) {
+    switch (status) {
+        case PurchaseStatus::Purchasable:
+            return "Can purchase";
+        case PurchaseStatus::InsufficientFunds:
+            return "Insufficient funds. Required: $" + std::to_string(weaponPrice);
+        case PurchaseStatus::InventoryFull:
+            return "Inventory full. Free a slot to purchase.";
+        default:
+            return "";
+    }
+}
+
+// Get purchase status color
+sf::Color getPurchaseStatusColor(PurchaseStatus status) {
+    switch (status) {
+        case PurchaseStatus::Purchasable:
+            return sf::Color::Green;
+        case PurchaseStatus::InsufficientFunds:
+            return sf::Color::Red;
+        case PurchaseStatus::InventoryFull:
+            return sf::Color::Yellow;
+        default:
+            return sf::Color::White;
+    }
+}
+
+// ========================
+// Shop UI Rendering System
+// ========================
+
+// PERFORMANCE: Retained-mode shop UI
+// The shop used to rebuild every sf::Text, formatted string and catalog
+// Weapon/AmmoItem each frame while open. ShopUILayer builds them once per
+// window size and font, at full scale, and per frame only:
+// - rewrites the money string when the balance changed
+// - rewrites a row's status string and panel colors when its status changed
+// - refades colors while the open animation runs
+// The open animation scales the whole layout about the panel centre with a
+// render transform instead of re-laying the text at every scale. Tooltip text
+// is built once per catalog entry, on first hover.
+class ShopUILayer {
+public:
+    // Render shop UI with four columns (three for weapons, one for ammo)
+    // Requirements: 3.2, 3.3, 3.4, 3.5
+    void render(sf::RenderWindow& window, const Player& player, const sf::Font& font, float animationProgress) {
+        sf::Vector2u windowSize = window.getSize();
+        if (font_ != &font || windowSize.x != windowSize_.x || windowSize.y != windowSize_.y) {
+            build(windowSize, font);
+        }
+        
+        // Smooth easing function (ease-out cubic)
+        float easedProgress = 1.0f - std::pow(1.0f - animationProgress, 3.0f);
+        
+        // Scale animation: 70% to 100% about the panel centre
+        float scale = 0.7f + easedProgress * 0.3f;
+        sf::Transform transform;
+        transform.translate(center_).scale(scale, scale).translate(-center_.x, -center_.y);
+        
+        if (easedProgress != fade_) {
+            fade_ = easedProgress;
+            applyFade();
+        }
+        
+        // Dynamic fields: money and per-row purchase status
+        if (player.money != shownMoney_) {
+            shownMoney_ = player.money;
+            money_.text.setString("Money: $" + std::to_string(player.money));
+        }
+        for (Column& column : columns_) {
+            for (CatalogRow& row : column.rows) {
+                int state = row.weapon ? static_cast<int>(calculatePurchaseStatus(player, row.weapon.get()))
+                                       : ammoState(player, *row.ammo);
+                if (state != row.shownState) {
+                    row.shownState = state;
+                    setRowState(row, state);
+                }
+            }
+        }
+        
+        // Hover test in layout space (undo the animation scale)
+        sf::Vector2i mousePixelPos = sf::Mouse::getPosition(window);
+        sf::Vector2f mouseLayout = transform.getInverse().transformPoint(
+            static_cast<float>(mousePixelPos.x), static_cast<float>(mousePixelPos.y));
+        CatalogRow* hoveredRow = nullptr;
+        
+        // Draw semi-transparent background overlay
+        window.draw(overlay_.shape);
+        
+        sf::RenderStates states(transform);
+        window.draw(panel_.shape, states);
+        window.draw(title_.text, states);
+        window.draw(money_.text, states);
+        
+        for (Column& column : columns_) {
+            window.draw(column.background.shape, states);
+            window.draw(column.title.text, states);
+            for (CatalogRow& row : column.rows) {
+                window.draw(row.panel.shape, states);
+                window.draw(row.name.text, states);
+                window.draw(row.price.text, states);
+                window.draw(row.details.text, states);
+                window.draw(row.status.text, states);
+                if (row.bounds.contains(mouseLayout)) {
+                    hoveredRow = &row;
+                }
+            }
+        }
+        
+        // Render tooltips at the very end to ensure they're on top of all other UI elements
+        if (hoveredRow != nullptr) {
+            if (!hoveredRow->tooltip) {
+                hoveredRow->tooltip = hoveredRow->weapon ? buildWeaponTooltip(*hoveredRow->weapon)
+                                                         : buildAmmoTooltip(*hoveredRow->ammo);
+            }
+            drawTooltip(window, *hoveredRow->tooltip,
+                        static_cast<float>(mousePixelPos.x), static_cast<float>(mousePixelPos.y));
+        }
+    }
+    
+private:
+    struct FadedText {
+        sf::Text text;
+        sf::Color color;    // Color when fully faded in
+    };
+    
+    struct FadedRect {
+        sf::RectangleShape shape;
+        sf::Color fill;     // Colors when fully faded in
+        sf::Color outline;
+    };
+    
+    // Tooltip geometry relative to its top-left corner
+    struct Tooltip {
+        sf::RectangleShape background;
+        sf::RectangleShape separator;
+        std::vector<sf::Text> texts;
+    };
+    
+    // One catalog entry: a weapon or an ammo type
+    struct CatalogRow {
+        std::unique_ptr<Weapon> weapon;
+        std::unique_ptr<AmmoItem> ammo;
+        FadedRect panel;
+        FadedText name;
+        FadedText price;
+        FadedText details;
+        FadedText status;
+        sf::FloatRect bounds;               // Panel rectangle at full scale
+        int shownState = -1;                // Status currently shown, -1 = none yet
+        std::unique_ptr<Tooltip> tooltip;   // Built on first hover
+    };
+    
+    struct Column {
+        FadedRect background;
+        FadedText title;
+        std::vector<CatalogRow> rows;
+    };
+    
+    // Lay the shop out at full scale for this window size
+    void build(sf::Vector2u windowSize, const sf::Font& font) {
+        font_ = &font;
+        windowSize_ = windowSize;
+        fade_ = -1.0f;
+        shownMoney_ = std::numeric_limits<int>::min();
+        
+        // Shop UI dimensions - increased width for 4 columns
+        const float UI_WIDTH = 1300.0f;
+        const float UI_HEIGHT = 700.0f;
+        const float UI_X = (windowSize.x - UI_WIDTH) / 2.0f;
+        const float UI_Y = (windowSize.y - UI_HEIGHT) / 2.0f;
+        center_ = sf::Vector2f(UI_X + UI_WIDTH / 2.0f, UI_Y + UI_HEIGHT / 2.0f);
+        
+        initRect(overlay_, sf::Vector2f(0.0f, 0.0f), sf::Vector2f(windowSize.x, windowSize.y),
+                 sf::Color(0, 0, 0, 180), sf::Color::Transparent, 0.0f);
+        initRect(panel_, sf::Vector2f(UI_X, UI_Y), sf::Vector2f(UI_WIDTH, UI_HEIGHT),
+                 sf::Color(40, 40, 40, 230), sf::Color(100, 100, 100), 3.0f);
+        
+        initText(title_, "WEAPON SHOP", 40, sf::Color(255, 255, 255), 0.0f, UI_Y + 20.0f);
+        centerText(title_.text, UI_X, UI_WIDTH);
+        initText(money_, "", 28, sf::Color(100, 255, 100), UI_X + 20.0f, UI_Y + 70.0f);
+        
+        // Column dimensions - now 4 columns
+        const float COLUMN_WIDTH = (UI_WIDTH - 100.0f) / 4.0f;
+        const float COLUMN_HEIGHT = UI_HEIGHT - 150.0f;
+        const float COLUMN_Y = UI_Y + 120.0f;
+        const float COLUMN_PADDING = 20.0f;
+        const float ROW_HEIGHT = 110.0f;
+        const float ROW_PADDING = 10.0f;
+        
+        // Requirement 3.3: Three weapon categories + one ammo category
+        struct WeaponCategory {
+            std::string name;
+            std::vector<Weapon::Type> weapons;
+        };
+        std::vector<WeaponCategory> categories = {
+            {"Pistols", {Weapon::USP, Weapon::GLOCK, Weapon::FIVESEVEN, Weapon::R8}},
+            {"Rifles", {Weapon::GALIL, Weapon::M4, Weapon::AK47}},
+            {"Snipers", {Weapon::M10, Weapon::AWP, Weapon::M40}}
+        };
+        std::vector<AmmoType> ammoTypes = {
+            AmmoType::AMMO_9x18,
+            AmmoType::AMMO_5_45x39,
+            AmmoType::AMMO_7_62x54
+        };
+        
+        for (size_t col = 0; col < columns_.size(); col++) {
+            Column& column = columns_[col];
+            column.rows.clear();
+            float columnX = UI_X + 20.0f + col * (COLUMN_WIDTH + COLUMN_PADDING);
+            initRect(column.background, sf::Vector2f(columnX, COLUMN_Y), sf::Vector2f(COLUMN_WIDTH, COLUMN_HEIGHT),
+                     sf::Color(30, 30, 30, 230), sf::Color(80, 80, 80), 2.0f);
+            initText(column.title, col < categories.size() ? categories[col].name : "Ammo", 26,
+                     sf::Color(255, 200, 100), 0.0f, COLUMN_Y + 10.0f);
+            centerText(column.title.text, columnX, COLUMN_WIDTH);
+            
+            size_t rowCount = col < categories.size() ? categories[col].weapons.size() : ammoTypes.size();
+            column.rows.resize(rowCount);
+            float rowY = COLUMN_Y + 50.0f;
+            for (size_t r = 0; r < rowCount; r++) {
+                CatalogRow& row = column.rows[r];
+                row.bounds = sf::FloatRect(columnX + 10.0f, rowY, COLUMN_WIDTH - 20.0f, ROW_HEIGHT);
+                initRect(row.panel, sf::Vector2f(row.bounds.left, row.bounds.top), sf::Vector2f(row.bounds.width, row.bounds.height),
+                         sf::Color(50, 50, 50, 230), sf::Color(100, 100, 100), 1.0f);
+                
+                float textX = columnX + 15.0f;
+                if (col < categories.size()) {
+                    // Requirement 3.4: Display weapon name, price, damage and magazine size
+                    row.weapon.reset(Weapon::create(categories[col].weapons[r]));
+                    const Weapon& weapon = *row.weapon;
+                    std::ostringstream statsStream;
+                    statsStream << "Damage: " << static_cast<int>(weapon.damage) << "\n";
+                    statsStream << "Magazine: " << weapon.magazineSize;
+                    initText(row.name, weapon.name, 20, sf::Color(255, 255, 255), textX, rowY + 5.0f);
+                    initText(row.price, "$" + std::to_string(weapon.price), 18, sf::Color(255, 215, 0), textX, rowY + 28.0f);
+                    initText(row.details, statsStream.str(), 16, sf::Color(200, 200, 200), textX, rowY + 50.0f);
+                    initText(row.status, "", 14, sf::Color::White, textX, rowY + 90.0f);
+                } else {
+                    row.ammo.reset(AmmoItem::create(ammoTypes[r]));
+                    const AmmoItem& ammo = *row.ammo;
+                    initText(row.name, ammo.name, 18, sf::Color(255, 255, 255), textX, rowY + 5.0f);
+                    initText(row.price, "$" + std::to_string(ammo.price), 18, sf::Color(255, 215, 0), textX, rowY + 28.0f);
+                    initText(row.details, "Quantity: " + std::to_string(ammo.quantity), 16, sf::Color(200, 200, 200), textX, rowY + 50.0f);
+                    initText(row.status, "", 14, sf::Color::White, textX, rowY + 75.0f);
+                }
+                rowY += ROW_HEIGHT + ROW_PADDING;
+            }
+        }
+    }
+    
+    // Ammo row status: 0 can purchase, 1 no compatible weapon, 2 insufficient funds
+    static int ammoState(const Player& player, const AmmoItem& ammo) {
+        bool hasCompatibleWeapon = false;
+        for (int i = 0; i < 4; i++) {
+            if (player.inventory[i] != nullptr && player.inventory[i]->getAmmoType() == ammo.type) {
+                hasCompatibleWeapon = true;
+                break;
+            }
+        }
+        if (!hasCompatibleWeapon) return 1;
+        if (player.money < ammo.price) return 2;
+        return 0;
+    }
+    
+    // Requirement 3.5: Show purchase status (text, text color, panel tint)
+    void setRowState(CatalogRow& row, int state) {
+        bool purchasable;
+        if (row.weapon) {
+            PurchaseStatus status = static_cast<PurchaseStatus>(state);
+            purchasable = (status == PurchaseStatus::Purchasable);
+            row.status.text.setString(getPurchaseStatusText(status, row.weapon->price));
+            row.status.color = getPurchaseStatusColor(status);
+        } else {
+            purchasable = (state == 0);
+            row.status.text.setString(state == 1 ? "No compatible weapon" : state == 2 ? "Insufficient funds" : "Can purchase");
+            row.status.color = purchasable ? sf::Color(100, 255, 100) : sf::Color(255, 100, 100);
+        }
+        
+        if (purchasable) {
+            row.panel.fill = sf::Color(50, 70, 50, 230);      // Green tint
+            row.panel.outline = sf::Color(100, 200, 100);
+        } else {
+            row.panel.fill = sf::Color(50, 50, 50, 230);      // Gray
+            row.panel.outline = sf::Color(100, 100, 100);
+        }
+        fadeText(row.status);
+        fadeRect(row.panel);
+    }
+    
+    void applyFade() {
+        fadeRect(overlay_);
+        fadeRect(panel_);
+        fadeText(title_);
+        fadeText(money_);
+        for (Column& column : columns_) {
+            fadeRect(column.background);
+            fadeText(column.title);
+            for (CatalogRow& row : column.rows) {
+                fadeRect(row.panel);
+                fadeText(row.name);
+                fadeText(row.price);
+                fadeText(row.details);
+                fadeText(row.status);
+            }
+        }
+    }
+    
+    sf::Color faded(sf::Color color) const {
+        return sf::Color(color.r, color.g, color.b, static_cast<sf::Uint8>(fade_ * color.a));
+    }
+    
+    void fadeText(FadedText& text) const {
+        text.text.setFillColor(faded(text.color));
+    }
+    
+    void fadeRect(FadedRect& rect) const {
+        rect.shape.setFillColor(faded(rect.fill));
+        rect.shape.setOutlineColor(faded(rect.outline));
+    }
+    
+    void initText(FadedText& text, const std::string& string, unsigned int size, sf::Color color, float x, float y) const {
+        text.text.setFont(*font_);
+        text.text.setString(string);
+        text.text.setCharacterSize(size);
+        text.text.setPosition(x, y);
+        text.color = color;
+    }
+    
+    static void initRect(FadedRect& rect, sf::Vector2f position, sf::Vector2f size,
+                         sf::Color fill, sf::Color outline, float outlineThickness) {
+        rect.shape.setSize(size);
+        rect.shape.setPosition(position);
+        rect.shape.setOutlineThickness(outlineThickness);
+        rect.fill = fill;
+        rect.outline = outline;
+    }
+    
+    // Center horizontally within [left, left + width]
+    static void centerText(sf::Text& text, float left, float width) {
+        sf::FloatRect bounds = text.getLocalBounds();
+        text.setPosition(left + (width - bounds.width) / 2.0f - bounds.left, text.getPosition().y);
+    }
+    
+    // Tooltip layouts: built once per catalog entry at the origin, drawn translated
+    std::unique_ptr<Tooltip> newTooltip(float width, float height) const {
+        const float PADDING = 15.0f;
+        std::unique_ptr<Tooltip> tooltip(new Tooltip());
+        tooltip->background.setSize(sf::Vector2f(width, height));
+        tooltip->background.setFillColor(sf::Color(20, 20, 20, 240));
+        tooltip->background.setOutlineColor(sf::Color(255, 215, 0));  // Gold border
+        tooltip->background.setOutlineThickness(2.0f);
+        tooltip->separator.setSize(sf::Vector2f(width - 2 * PADDING, 1.0f));
+        tooltip->separator.setPosition(PADDING, PADDING + 65.0f);
+        tooltip->separator.setFillColor(sf::Color(100, 100, 100));
+        return tooltip;
+    }
+    
+    void addTooltipText(Tooltip& tooltip, const std::string& string, unsigned int size, sf::Color color,
+                        float x, float y, bool bold = false) const {
+        sf::Text text;
+        text.setFont(*font_);
+        text.setString(string);
+        text.setCharacterSize(size);
+        text.setFillColor(color);
+        if (bold) text.setStyle(sf::Text::Bold);
+        text.setPosition(x, y);
+        tooltip.texts.push_back(text);
+    }
+    
+    // Weapon tooltip with full stats
+    std::unique_ptr<Tooltip> buildWeaponTooltip(const Weapon& weapon) const {
+        const float PADDING = 15.0f;
+        std::unique_ptr<Tooltip> tooltip = newTooltip(320.0f, 290.0f);
+        addTooltipText(*tooltip, weapon.name, 24, sf::Color(255, 215, 0), PADDING, PADDING, true);
+        addTooltipText(*tooltip, "Price: $" + std::to_string(weapon.price), 20, sf::Color(100, 255, 100), PADDING, PADDING + 35.0f);
+        
+        // Stats - format floats properly
+        std::ostringstream reloadStream, moveStream;
+        reloadStream << std::fixed << std::setprecision(1) << weapon.reloadTime;
+        moveStream << std::fixed << std::setprecision(1) << weapon.movementSpeed;
+        
+        std::vector<std::pair<std::string, std::string>> stats = {
+            {"Damage:", std::to_string(static_cast<int>(weapon.damage))},
+            {"Magazine:", std::to_string(weapon.magazineSize)},
+            {"Range:", std::to_string(static_cast<int>(weapon.range)) + " px"},
+            {"Bullet Speed:", std::to_string(static_cast<int>(weapon.bulletSpeed)) + " px/s"},
+            {"Reload Time:", reloadStream.str() + " s"},
+            {"Movement Speed:", moveStream.str()},
+            {"Fire Mode:", weapon.isAutomatic() ? "Automatic (" + std::to_string(static_cast<int>(weapon.fireRate)) + " rps)" : "Semi-Auto"}
+        };
+        
+        float textY = PADDING + 75.0f;
+        for (const auto& stat : stats) {
+            addTooltipText(*tooltip, stat.first, 16, sf::Color(200, 200, 200), PADDING, textY);
+            addTooltipText(*tooltip, stat.second, 16, sf::Color::White, PADDING + 150.0f, textY, true);
+            textY += 22.0f;
+        }
+        return tooltip;
+    }
+    
+    // Ammo tooltip with full information
+    std::unique_ptr<Tooltip> buildAmmoTooltip(const AmmoItem& ammo) const {
+        const float PADDING = 15.0f;
+        std::unique_ptr<Tooltip> tooltip = newTooltip(320.0f, 220.0f);
+        addTooltipText(*tooltip, ammo.name, 24, sf::Color(255, 215, 0), PADDING, PADDING, true);
+        addTooltipText(*tooltip, "Price: $" + std::to_string(ammo.price), 20, sf::Color(100, 255, 100), PADDING, PADDING + 35.0f);
+        addTooltipText(*tooltip, "Quantity: " + std::to_string(ammo.quantity) + " rounds", 18, sf::Color::White, PADDING, PADDING + 75.0f);
+        addTooltipText(*tooltip, "Compatible with:", 18, sf::Color(200, 200, 200), PADDING, PADDING + 105.0f);
+        
+        // List compatible weapon types
+        std::string weaponList;
+        switch (ammo.type) {
+            case AmmoType::AMMO_9x18:
+                weaponList = "-> Pistols:\n  USP, Glock-18,\n  Five-SeveN, R8 Revolver";
+                break;
+            case AmmoType::AMMO_5_45x39:
+                weaponList = "-> Rifles:\n  Galil AR, M4, AK-47";
+                break;
+            case AmmoType::AMMO_7_62x54:
+                weaponList = "-> Sniper Rifles:\n  M10, AWP, M40";
+                break;
+        }
+        addTooltipText(*tooltip, weaponList, 16, sf::Color(150, 200, 255), PADDING, PADDING + 130.0f);  // Light blue
+        return tooltip;
+    }
+    
+    // Position tooltip near mouse, but keep it on screen
+    void drawTooltip(sf::RenderWindow& window, const Tooltip& tooltip, float mouseX, float mouseY) const {
+        // Reserve space for UI elements at bottom (150px for "Press B" and "E - inventory")
+        const float BOTTOM_UI_RESERVE = 150.0f;
+        sf::Vector2f size = tooltip.background.getSize();
+        
+        float tooltipX = mouseX + 20.0f;
+        float tooltipY = mouseY + 20.0f;
+        
+        // Adjust if tooltip goes off screen
+        if (tooltipX + size.x > windowSize_.x - 10.0f) {
+            tooltipX = mouseX - size.x - 20.0f;
+        }
+        if (tooltipY + size.y > windowSize_.y - BOTTOM_UI_RESERVE) {
+            // Position above cursor if would overlap bottom UI
+            tooltipY = mouseY - size.y - 20.0f;
+        }
+        if (tooltipX < 10.0f) tooltipX = 10.0f;
+        if (tooltipY < 10.0f) tooltipY = 10.0f;
+        
+        sf::RenderStates states;
+        states.transform.translate(tooltipX, tooltipY);
+        window.draw(tooltip.background, states);
+        window.draw(tooltip.separator, states);
+        for (const sf::Text& text : tooltip.texts) {
+            window.draw(text, states);
+        }
+    }
+    
+    const sf::Font* font_ = nullptr;
+    sf::Vector2u windowSize_;
+    sf::Vector2f center_;                // Panel centre, the animation's scale origin
+    float fade_ = -1.0f;                 // easedProgress the colors were faded to
+    int shownMoney_ = 0;
+    FadedRect overlay_;
+    FadedRect panel_;
+    FadedText title_;
+    FadedText money_;
+    std::array<Column, 4> columns_;      // Pistols, Rifles, Snipers, Ammo
+};
+
+// ========================
+// Reference: Immediate-Mode Shop (previous renderShopUI and tooltips)
+// ========================
+
+// Render weapon tooltip with full stats
+// Render ammo tooltip with full information
+void legacyRenderAmmoTooltip(sf::RenderWindow& window, const AmmoItem* ammo, float mouseX, float mouseY, const sf::Font& font) {
+    sf::Vector2u windowSize = window.getSize();
+    
+    // Tooltip dimensions
+    const float TOOLTIP_WIDTH = 320.0f;
+    const float TOOLTIP_HEIGHT = 220.0f;
+    const float PADDING = 15.0f;
+    
+    // Position tooltip near mouse, but keep it on screen
+    const float BOTTOM_UI_RESERVE = 150.0f;
+    
+    float tooltipX = mouseX + 20.0f;
+    float tooltipY = mouseY + 20.0f;
+    
+    // Adjust if tooltip goes off screen
+    if (tooltipX + TOOLTIP_WIDTH > windowSize.x - 10.0f) {
+        tooltipX = mouseX - TOOLTIP_WIDTH - 20.0f;
+    }
+    if (tooltipY + TOOLTIP_HEIGHT > windowSize.y - BOTTOM_UI_RESERVE) {
+        tooltipY = mouseY - TOOLTIP_HEIGHT - 20.0f;
+    }
+    if (tooltipX < 10.0f) tooltipX = 10.0f;
+    if (tooltipY < 10.0f) tooltipY = 10.0f;
+    
+    // Draw tooltip background
+    sf::RectangleShape tooltipBg(sf::Vector2f(TOOLTIP_WIDTH, TOOLTIP_HEIGHT));
+    tooltipBg.setPosition(tooltipX, tooltipY);
+    tooltipBg.setFillColor(sf::Color(20, 20, 20, 240));
+    tooltipBg.setOutlineColor(sf::Color(255, 215, 0));  // Gold border
+    tooltipBg.setOutlineThickness(2.0f);
+    window.draw(tooltipBg);
+    
+    float textY = tooltipY + PADDING;
+    
+    // Ammo name (title)
+    sf::Text nameText;
+    nameText.setFont(font);
+    nameText.setString(ammo->name);
+    nameText.setCharacterSize(24);
+    nameText.setFillColor(sf::Color(255, 215, 0));  // Gold
+    nameText.setStyle(sf::Text::Bold);
+    nameText.setPosition(tooltipX + PADDING, textY);
+    window.draw(nameText);
+    textY += 35.0f;
+    
+    // Price
+    sf::Text priceText;
+    priceText.setFont(font);
+    priceText.setString("Price: $" + std::to_string(ammo->price));
+    priceText.setCharacterSize(20);
+    priceText.setFillColor(sf::Color(100, 255, 100));  // Light green
+    priceText.setPosition(tooltipX + PADDING, textY);
+    window.draw(priceText);
+    textY += 30.0f;
+    
+    // Separator line
+    sf::RectangleShape separator(sf::Vector2f(TOOLTIP_WIDTH - 2 * PADDING, 1.0f));
+    separator.setPosition(tooltipX + PADDING, textY);
+    separator.setFillColor(sf::Color(100, 100, 100));
+    window.draw(separator);
+    textY += 10.0f;
+    
+    // Quantity per purchase
+    sf::Text quantityText;
+    quantityText.setFont(font);
+    quantityText.setString("Quantity: " + std::to_string(ammo->quantity) + " rounds");
+    quantityText.setCharacterSize(18);
+    quantityText.setFillColor(sf::Color::White);
+    quantityText.setPosition(tooltipX + PADDING, textY);
+    window.draw(quantityText);
+    textY += 30.0f;
+    
+    // Compatible weapons section
+    sf::Text compatibleLabel;
+    compatibleLabel.setFont(font);
+    compatibleLabel.setString("Compatible with:");
+    compatibleLabel.setCharacterSize(18);
+    compatibleLabel.setFillColor(sf::Color(200, 200, 200));
+    compatibleLabel.setPosition(tooltipX + PADDING, textY);
+    window.draw(compatibleLabel);
+    textY += 25.0f;
+    
+    // List compatible weapon types
+    std::string weaponList;
+    switch (ammo->type) {
+        case AmmoType::AMMO_9x18:
+            weaponList = "-> Pistols:\n  USP, Glock-18,\n  Five-SeveN, R8 Revolver";
+            break;
+        case AmmoType::AMMO_5_45x39:
+            weaponList = "-> Rifles:\n  Galil AR, M4, AK-47";
+            break;
+        case AmmoType::AMMO_7_62x54:
+            weaponList = "-> Sniper Rifles:\n  M10, AWP, M40";
+            break;
+    }
+    
+    sf::Text weaponListText;
+    weaponListText.setFont(font);
+    weaponListText.setString(weaponList);
+    weaponListText.setCharacterSize(16);
+    weaponListText.setFillColor(sf::Color(150, 200, 255));  // Light blue
+    weaponListText.setPosition(tooltipX + PADDING, textY);
+    window.draw(weaponListText);
+}
+
+void legacyRenderWeaponTooltip(sf::RenderWindow& window, const Weapon* weapon, float mouseX, float mouseY, const sf::Font& font) {
+    sf::Vector2u windowSize = window.getSize();
+    
+    // Tooltip dimensions
+    const float TOOLTIP_WIDTH = 320.0f;  // Увеличено с 300 до 320 для лучшей читаемости
+    const float TOOLTIP_HEIGHT = 290.0f;  // Высота для всех характеристик
+    const float PADDING = 15.0f;
+    
+    // Position tooltip near mouse, but keep it on screen
+    // Reserve space for UI elements at bottom (150px for "Press B" and "E - inventory")
+    const float BOTTOM_UI_RESERVE = 150.0f;
+    
+    float tooltipX = mouseX + 20.0f;
+    float tooltipY = mouseY + 20.0f;
+    
+    // Adjust if tooltip goes off screen
+    if (tooltipX + TOOLTIP_WIDTH > windowSize.x - 10.0f) {
+        tooltipX = mouseX - TOOLTIP_WIDTH - 20.0f;
+    }
+    if (tooltipY + TOOLTIP_HEIGHT > windowSize.y - BOTTOM_UI_RESERVE) {
+        // Position above cursor if would overlap bottom UI
+        tooltipY = mouseY - TOOLTIP_HEIGHT - 20.0f;
+    }
+    if (tooltipX < 10.0f) tooltipX = 10.0f;
+    if (tooltipY < 10.0f) tooltipY = 10.0f;
+    
+    // Draw tooltip background
+    sf::RectangleShape tooltipBg(sf::Vector2f(TOOLTIP_WIDTH, TOOLTIP_HEIGHT));
+    tooltipBg.setPosition(tooltipX, tooltipY);
+    tooltipBg.setFillColor(sf::Color(20, 20, 20, 240));
+    tooltipBg.setOutlineColor(sf::Color(255, 215, 0));  // Gold border
+    tooltipBg.setOutlineThickness(2.0f);
+    window.draw(tooltipBg);
+    
+    float textY = tooltipY + PADDING;
+    
+    // Weapon name (title)
+    sf::Text nameText;
+    nameText.setFont(font);
+    nameText.setString(weapon->name);
+    nameText.setCharacterSize(24);
+    nameText.setFillColor(sf::Color(255, 215, 0));  // Gold
+    nameText.setStyle(sf::Text::Bold);
+    nameText.setPosition(tooltipX + PADDING, textY);
+    window.draw(nameText);
+    textY += 35.0f;
+    
+    // Price
+    sf::Text priceText;
+    priceText.setFont(font);
+    priceText.setString("Price: $" + std::to_string(weapon->price));
+    priceText.setCharacterSize(20);
+    priceText.setFillColor(sf::Color(100, 255, 100));  // Light green
+    priceText.setPosition(tooltipX + PADDING, textY);
+    window.draw(priceText);
+    textY += 30.0f;
+    
+    // Separator line
+    sf::RectangleShape separator(sf::Vector2f(TOOLTIP_WIDTH - 2 * PADDING, 1.0f));
+    separator.setPosition(tooltipX + PADDING, textY);
+    separator.setFillColor(sf::Color(100, 100, 100));
+    window.draw(separator);
+    textY += 10.0f;
+    
+    // Stats - format floats properly
+    std::ostringstream reloadStream, moveStream;
+    reloadStream << std::fixed << std::setprecision(1) << weapon->reloadTime;
+    moveStream << std::fixed << std::setprecision(1) << weapon->movementSpeed;
+    
+    std::vector<std::pair<std::string, std::string>> stats = {
+        {"Damage:", std::to_string(static_cast<int>(weapon->damage))},
+        {"Magazine:", std::to_string(weapon->magazineSize)},
+        {"Range:", std::to_string(static_cast<int>(weapon->range)) + " px"},
+        {"Bullet Speed:", std::to_string(static_cast<int>(weapon->bulletSpeed)) + " px/s"},
+        {"Reload Time:", reloadStream.str() + " s"},
+        {"Movement Speed:", moveStream.str()},
+        {"Fire Mode:", weapon->isAutomatic() ? "Automatic (" + std::to_string(static_cast<int>(weapon->fireRate)) + " rps)" : "Semi-Auto"}
+    };
+    
+    for (const auto& stat : stats) {
+        sf::Text statLabel;
+        statLabel.setFont(font);
+        statLabel.setString(stat.first);
+        statLabel.setCharacterSize(16);
+        statLabel.setFillColor(sf::Color(200, 200, 200));
+        statLabel.setPosition(tooltipX + PADDING, textY);
+        window.draw(statLabel);
+        
+        sf::Text statValue;
+        statValue.setFont(font);
+        statValue.setString(stat.second);
+        statValue.setCharacterSize(16);
+        statValue.setFillColor(sf::Color::White);
+        statValue.setStyle(sf::Text::Bold);
+        statValue.setPosition(tooltipX + PADDING + 150.0f, textY);
+        window.draw(statValue);
+        
+        textY += 22.0f;
+    }
+}
+
+// Render shop UI with four columns (three for weapons, one for ammo)
+// Requirements: 3.2, 3.3, 3.4, 3.5
+void legacyRenderShopUI(sf::RenderWindow& window, const Player& player, const sf::Font& font, float animationProgress) {
+    sf::Vector2u windowSize = window.getSize();
+    
+    // Shop UI dimensions - increased width for 4 columns
+    const float UI_WIDTH = 1300.0f;
+    const float UI_HEIGHT = 700.0f;
+    const float UI_X = (windowSize.x - UI_WIDTH) / 2.0f;
+    const float UI_Y = (windowSize.y - UI_HEIGHT) / 2.0f;
+    
+    // Smooth easing function (ease-out cubic)
+    float easedProgress = 1.0f - std::pow(1.0f - animationProgress, 3.0f);
+    
+    // Scale animation
+    float scale = 0.7f + easedProgress * 0.3f;  // Scale from 70% to 100%
+    float scaledWidth = UI_WIDTH * scale;
+    float scaledHeight = UI_HEIGHT * scale;
+    float scaledX = UI_X + (UI_WIDTH - scaledWidth) / 2.0f;
+    float scaledY = UI_Y + (UI_HEIGHT - scaledHeight) / 2.0f;
+    
+    // Alpha for fade-in
+    sf::Uint8 alpha = static_cast<sf::Uint8>(easedProgress * 230);
+    
+    // Draw semi-transparent background overlay
+    sf::RectangleShape overlay(sf::Vector2f(windowSize.x, windowSize.y));
+    overlay.setFillColor(sf::Color(0, 0, 0, static_cast<sf::Uint8>(easedProgress * 180)));
+    window.draw(overlay);
+    
+    // Draw main shop panel
+    sf::RectangleShape shopPanel(sf::Vector2f(scaledWidth, scaledHeight));
+    shopPanel.setPosition(scaledX, scaledY);
+    shopPanel.setFillColor(sf::Color(40, 40, 40, alpha));
+    shopPanel.setOutlineColor(sf::Color(100, 100, 100, static_cast<sf::Uint8>(easedProgress * 255)));
+    shopPanel.setOutlineThickness(3.0f);
+    window.draw(shopPanel);
+    
+    // Draw title
+    sf::Text titleText;
+    titleText.setFont(font);
+    titleText.setString("WEAPON SHOP");
+    titleText.setCharacterSize(static_cast<unsigned int>(40 * scale));
+    titleText.setFillColor(sf::Color(255, 255, 255, static_cast<sf::Uint8>(easedProgress * 255)));
+    sf::FloatRect titleBounds = titleText.getLocalBounds();
+    titleText.setPosition(
+        scaledX + (scaledWidth - titleBounds.width) / 2.0f - titleBounds.left,
+        scaledY + 20.0f * scale
+    );
+    window.draw(titleText);
+    
+    // Draw player money
+    sf::Text moneyText;
+    moneyText.setFont(font);
+    moneyText.setString("Money: $" + std::to_string(player.money));
+    moneyText.setCharacterSize(static_cast<unsigned int>(28 * scale));
+    moneyText.setFillColor(sf::Color(100, 255, 100, static_cast<sf::Uint8>(easedProgress * 255)));
+    moneyText.setPosition(scaledX + 20.0f * scale, scaledY + 70.0f * scale);
+    window.draw(moneyText);
+    
+    // Column dimensions - now 4 columns
+    const float COLUMN_WIDTH = (scaledWidth - 100.0f * scale) / 4.0f;
+    const float COLUMN_HEIGHT = scaledHeight - 150.0f * scale;
+    const float COLUMN_Y = scaledY + 120.0f * scale;
+    const float COLUMN_PADDING = 20.0f * scale;
+    
+    // Define weapon categories
+    // Requirement 3.3: Three weapon categories + one ammo category
+    struct WeaponCategory {
+        std::string name;
+        std::vector<Weapon::Type> weapons;
+    };
+    
+    std::vector<WeaponCategory> categories = {
+        {"Pistols", {Weapon::USP, Weapon::GLOCK, Weapon::FIVESEVEN, Weapon::R8}},
+        {"Rifles", {Weapon::GALIL, Weapon::M4, Weapon::AK47}},
+        {"Snipers", {Weapon::M10, Weapon::AWP, Weapon::M40}}
+    };
+    
+    // Define ammo types
+    std::vector<AmmoType> ammoTypes = {
+        AmmoType::AMMO_9x18,
+        AmmoType::AMMO_5_45x39,
+        AmmoType::AMMO_7_62x54
+    };
+    
+    // Variables to store hovered weapon for tooltip rendering at the end
+    Weapon* hoveredWeapon = nullptr;
+    AmmoItem* hoveredAmmo = nullptr;
+    float hoveredMouseX = 0.0f;
+    float hoveredMouseY = 0.0f;
+    
+    // Draw each column
+    for (size_t col = 0; col < categories.size(); col++) {
+        float columnX = scaledX + 20.0f * scale + col * (COLUMN_WIDTH + COLUMN_PADDING);
+        
+        // Draw column background
+        sf::RectangleShape columnBg(sf::Vector2f(COLUMN_WIDTH, COLUMN_HEIGHT));
+        columnBg.setPosition(columnX, COLUMN_Y);
+        columnBg.setFillColor(sf::Color(30, 30, 30, alpha));
+        columnBg.setOutlineColor(sf::Color(80, 80, 80, static_cast<sf::Uint8>(easedProgress * 255)));
+        columnBg.setOutlineThickness(2.0f);
+        window.draw(columnBg);
+        
+        // Draw column title
+        sf::Text columnTitle;
+        columnTitle.setFont(font);
+        columnTitle.setString(categories[col].name);
+        columnTitle.setCharacterSize(static_cast<unsigned int>(26 * scale));
+        columnTitle.setFillColor(sf::Color(255, 200, 100, static_cast<sf::Uint8>(easedProgress * 255)));
+        sf::FloatRect columnTitleBounds = columnTitle.getLocalBounds();
+        columnTitle.setPosition(
+            columnX + (COLUMN_WIDTH - columnTitleBounds.width) / 2.0f - columnTitleBounds.left,
+            COLUMN_Y + 10.0f * scale
+        );
+        window.draw(columnTitle);
+        
+        // Draw weapons in this column
+        float weaponY = COLUMN_Y + 50.0f * scale;
+        const float WEAPON_HEIGHT = 110.0f * scale;
+        const float WEAPON_PADDING = 10.0f * scale;
+        
+        for (Weapon::Type weaponType : categories[col].weapons) {
+            // Create weapon to get stats
+            Weapon* weapon = Weapon::create(weaponType);
+            
+            // Calculate purchase status
+            // Requirement 3.5: Show purchase status
+            PurchaseStatus status = calculatePurchaseStatus(player, weapon);
+            
+            // Draw weapon panel
+            sf::RectangleShape weaponPanel(sf::Vector2f(COLUMN_WIDTH - 20.0f * scale, WEAPON_HEIGHT));
+            weaponPanel.setPosition(columnX + 10.0f * scale, weaponY);
+            
+            // Color based on purchase status
+            if (status == PurchaseStatus::Purchasable) {
+                weaponPanel.setFillColor(sf::Color(50, 70, 50, alpha));  // Green tint
+                weaponPanel.setOutlineColor(sf::Color(100, 200, 100, static_cast<sf::Uint8>(easedProgress * 255)));
+            } else {
+                weaponPanel.setFillColor(sf::Color(50, 50, 50, alpha));  // Gray
+                weaponPanel.setOutlineColor(sf::Color(100, 100, 100, static_cast<sf::Uint8>(easedProgress * 255)));
+            }
+            weaponPanel.setOutlineThickness(1.0f);
+            window.draw(weaponPanel);
+            
+            // Draw weapon name
+            // Requirement 3.4: Display weapon name
+            sf::Text weaponName;
+            weaponName.setFont(font);
+            weaponName.setString(weapon->name);
+            weaponName.setCharacterSize(static_cast<unsigned int>(20 * scale));
+            weaponName.setFillColor(sf::Color(255, 255, 255, static_cast<sf::Uint8>(easedProgress * 255)));
+            weaponName.setPosition(columnX + 15.0f * scale, weaponY + 5.0f * scale);
+            window.draw(weaponName);
+            
+            // Draw weapon price
+            // Requirement 3.4: Display price
+            sf::Text weaponPrice;
+            weaponPrice.setFont(font);
+            weaponPrice.setString("$" + std::to_string(weapon->price));
+            weaponPrice.setCharacterSize(static_cast<unsigned int>(18 * scale));
+            weaponPrice.setFillColor(sf::Color(255, 215, 0, static_cast<sf::Uint8>(easedProgress * 255)));  // Gold color
+            weaponPrice.setPosition(columnX + 15.0f * scale, weaponY + 28.0f * scale);
+            window.draw(weaponPrice);
+            
+            // Draw weapon stats
+            // Requirement 3.4: Display damage and magazine size
+            sf::Text weaponStats;
+            weaponStats.setFont(font);
+            std::ostringstream statsStream;
+            statsStream << "Damage: " << static_cast<int>(weapon->damage) << "\n";
+            statsStream << "Magazine: " << weapon->magazineSize;
+            weaponStats.setString(statsStream.str());
+            weaponStats.setCharacterSize(static_cast<unsigned int>(16 * scale));
+            weaponStats.setFillColor(sf::Color(200, 200, 200, static_cast<sf::Uint8>(easedProgress * 255)));
+            weaponStats.setPosition(columnX + 15.0f * scale, weaponY + 50.0f * scale);
+            window.draw(weaponStats);
+            
+            // Draw purchase status
+            // Requirement 3.5: Show purchase status
+            sf::Text statusText;
+            statusText.setFont(font);
+            statusText.setString(getPurchaseStatusText(status, weapon->price));
+            statusText.setCharacterSize(static_cast<unsigned int>(14 * scale));
+            sf::Color statusColor = getPurchaseStatusColor(status);
+            statusText.setFillColor(sf::Color(statusColor.r, statusColor.g, statusColor.b, static_cast<sf::Uint8>(easedProgress * 255)));
+            statusText.setPosition(columnX + 15.0f * scale, weaponY + 90.0f * scale);
+            window.draw(statusText);
+            
+            // Check if mouse is hovering over this weapon slot
+            sf::Vector2i mousePixelPos = sf::Mouse::getPosition(window);
+            sf::FloatRect weaponBounds(
+                columnX + 10.0f * scale,
+                weaponY,
+                COLUMN_WIDTH - 20.0f * scale,
+                WEAPON_HEIGHT
+            );
+            
+            // If hovering, store weapon for tooltip rendering at the end
+            if (weaponBounds.contains(static_cast<float>(mousePixelPos.x), static_cast<float>(mousePixelPos.y))) {
+                // Delete previous hovered weapon if exists
+                if (hoveredWeapon != nullptr) {
+                    delete hoveredWeapon;
+                }
+                // Store this weapon for tooltip (don't delete it yet)
+                hoveredWeapon = weapon;
+                hoveredMouseX = static_cast<float>(mousePixelPos.x);
+                hoveredMouseY = static_cast<float>(mousePixelPos.y);
+            } else {
+                // Not hovering, delete weapon as usual
+                delete weapon;
+            }
+            
+            weaponY += WEAPON_HEIGHT + WEAPON_PADDING;
+        }
+    }
+    
+    // Draw ammo column (4th column)
+    {
+        float columnX = scaledX + 20.0f * scale + 3 * (COLUMN_WIDTH + COLUMN_PADDING);
+        
+        // Draw column background
+        sf::RectangleShape columnBg(sf::Vector2f(COLUMN_WIDTH, COLUMN_HEIGHT));
+        columnBg.setPosition(columnX, COLUMN_Y);
+        columnBg.setFillColor(sf::Color(30, 30, 30, alpha));
+        columnBg.setOutlineColor(sf::Color(80, 80, 80, static_cast<sf::Uint8>(easedProgress * 255)));
+        columnBg.setOutlineThickness(2.0f);
+        window.draw(columnBg);
+        
+        // Draw column title
+        sf::Text columnTitle;
+        columnTitle.setFont(font);
+        columnTitle.setString("Ammo");
+        columnTitle.setCharacterSize(static_cast<unsigned int>(26 * scale));
+        columnTitle.setFillColor(sf::Color(255, 200, 100, static_cast<sf::Uint8>(easedProgress * 255)));
+        sf::FloatRect columnTitleBounds = columnTitle.getLocalBounds();
+        columnTitle.setPosition(
+            columnX + (COLUMN_WIDTH - columnTitleBounds.width) / 2.0f - columnTitleBounds.left,
+            COLUMN_Y + 10.0f * scale
+        );
+        window.draw(columnTitle);
+        
+        // Draw ammo items
+        float ammoY = COLUMN_Y + 50.0f * scale;
+        const float AMMO_HEIGHT = 110.0f * scale;
+        const float AMMO_PADDING = 10.0f * scale;
+        
+        for (AmmoType ammoType : ammoTypes) {
+            // Create ammo item to get stats
+            AmmoItem* ammo = AmmoItem::create(ammoType);
+            
+            // Check if player has weapon for this ammo type
+            bool hasCompatibleWeapon = false;
+            for (int i = 0; i < 4; i++) {
+                if (player.inventory[i] != nullptr) {
+                    if (player.inventory[i]->getAmmoType() == ammoType) {
+                        hasCompatibleWeapon = true;
+                        break;
+                    }
+                }
+            }
+            
+            // Check if player has enough money
+            bool canAfford = player.money >= ammo->price;
+            
+            // Draw ammo panel
+            sf::RectangleShape ammoPanel(sf::Vector2f(COLUMN_WIDTH - 20.0f * scale, AMMO_HEIGHT));
+            ammoPanel.setPosition(columnX + 10.0f * scale, ammoY);
+            
+            // Color based on purchase status
+            if (hasCompatibleWeapon && canAfford) {
+                ammoPanel.setFillColor(sf::Color(50, 70, 50, alpha));  // Green tint
+                ammoPanel.setOutlineColor(sf::Color(100, 200, 100, static_cast<sf::Uint8>(easedProgress * 255)));
+            } else {
+                ammoPanel.setFillColor(sf::Color(50, 50, 50, alpha));  // Gray
+                ammoPanel.setOutlineColor(sf::Color(100, 100, 100, static_cast<sf::Uint8>(easedProgress * 255)));
+            }
+            ammoPanel.setOutlineThickness(1.0f);
+            window.draw(ammoPanel);
+            
+            // Draw ammo name
+            sf::Text ammoName;
+            ammoName.setFont(font);
+            ammoName.setString(ammo->name);
+            ammoName.setCharacterSize(static_cast<unsigned int>(18 * scale));
+            ammoName.setFillColor(sf::Color(255, 255, 255, static_cast<sf::Uint8>(easedProgress * 255)));
+            ammoName.setPosition(columnX + 15.0f * scale, ammoY + 5.0f * scale);
+            window.draw(ammoName);
+            
+            // Draw ammo price
+            sf::Text ammoPrice;
+            ammoPrice.setFont(font);
+            ammoPrice.setString("$" + std::to_string(ammo->price));
+            ammoPrice.setCharacterSize(static_cast<unsigned int>(18 * scale));
+            ammoPrice.setFillColor(sf::Color(255, 215, 0, static_cast<sf::Uint8>(easedProgress * 255)));
+            ammoPrice.setPosition(columnX + 15.0f * scale, ammoY + 28.0f * scale);
+            window.draw(ammoPrice);
+            
+            // Draw ammo quantity
+            sf::Text ammoQuantity;
+            ammoQuantity.setFont(font);
+            ammoQuantity.setString("Quantity: " + std::to_string(ammo->quantity));
+            ammoQuantity.setCharacterSize(static_cast<unsigned int>(16 * scale));
+            ammoQuantity.setFillColor(sf::Color(200, 200, 200, static_cast<sf::Uint8>(easedProgress * 255)));
+            ammoQuantity.setPosition(columnX + 15.0f * scale, ammoY + 50.0f * scale);
+            window.draw(ammoQuantity);
+            
+            // Draw purchase status
+            sf::Text statusText;
+            statusText.setFont(font);
+            if (!hasCompatibleWeapon) {
+                statusText.setString("No compatible weapon");
+                statusText.setFillColor(sf::Color(255, 100, 100, static_cast<sf::Uint8>(easedProgress * 255)));
+            } else if (!canAfford) {
+                statusText.setString("Insufficient funds");
+                statusText.setFillColor(sf::Color(255, 100, 100, static_cast<sf::Uint8>(easedProgress * 255)));
+            } else {
+                statusText.setString("Can purchase");
+                statusText.setFillColor(sf::Color(100, 255, 100, static_cast<sf::Uint8>(easedProgress * 255)));
+            }
+            statusText.setCharacterSize(static_cast<unsigned int>(14 * scale));
+            statusText.setPosition(columnX + 15.0f * scale, ammoY + 75.0f * scale);
+            window.draw(statusText);
+            
+            // Check if mouse is hovering over this ammo slot
+            sf::Vector2i mousePixelPos = sf::Mouse::getPosition(window);
+            sf::FloatRect ammoBounds(
+                columnX + 10.0f * scale,
+                ammoY,
+                COLUMN_WIDTH - 20.0f * scale,
+                AMMO_HEIGHT
+            );
+            
+            // If hovering, store ammo for tooltip rendering at the end
+            if (ammoBounds.contains(static_cast<float>(mousePixelPos.x), static_cast<float>(mousePixelPos.y))) {
+                // Delete previous hovered ammo if exists
+                if (hoveredAmmo != nullptr) {
+                    delete hoveredAmmo;
+                }
+                // Store this ammo for tooltip (don't delete it yet)
+                hoveredAmmo = ammo;
+                hoveredMouseX = static_cast<float>(mousePixelPos.x);
+                hoveredMouseY = static_cast<float>(mousePixelPos.y);
+            } else {
+                // Not hovering, delete ammo as usual
+                delete ammo;
+            }
+            
+            ammoY += AMMO_HEIGHT + AMMO_PADDING;
+        }
+    }
+    
+    // Render tooltips at the very end to ensure they're on top of all other UI elements
+    if (hoveredWeapon != nullptr) {
+        legacyRenderWeaponTooltip(window, hoveredWeapon, hoveredMouseX, hoveredMouseY, font);
+        delete hoveredWeapon;  // Clean up after rendering
+    }
+    
+    if (hoveredAmmo != nullptr) {
+        legacyRenderAmmoTooltip(window, hoveredAmmo, hoveredMouseX, hoveredMouseY, font);
+        delete hoveredAmmo;  // Clean up after rendering
+    }
+}
+
+// ========================
+// Helpers
+// ========================
+
+const sf::Font g_font;
+
+// Texts drawn by one frame of the retained layer and of the legacy shop
+std::vector<std::string> retainedFrame(ShopUILayer& layer, sf::RenderWindow& window, const Player& player, float progress) {
+    window.lastTexts.clear();
+    layer.render(window, player, g_font, progress);
+    return window.lastTexts;
+}
+
+std::vector<std::string> legacyFrame(sf::RenderWindow& window, const Player& player, float progress) {
+    window.lastTexts.clear();
+    legacyRenderShopUI(window, player, g_font, progress);
+    return window.lastTexts;
+}
+
+void assertSameTexts(const std::vector<std::string>& expected, const std::vector<std::string>& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        if (expected[i] != actual[i]) {
+            throw std::runtime_error("text " + std::to_string(i) + ": expected \"" + expected[i] + "\" but got \"" + actual[i] + "\"");
+        }
+    }
+}
+
+// Screen position of the centre of a catalog row at the given open progress
+sf::Vector2i rowCenter(sf::Vector2u windowSize, int column, int row, float progress) {
+    const float UI_WIDTH = 1300.0f;
+    const float UI_HEIGHT = 700.0f;
+    float easedProgress = 1.0f - std::pow(1.0f - progress, 3.0f);
+    float scale = 0.7f + easedProgress * 0.3f;
+    float centerX = (windowSize.x - UI_WIDTH) / 2.0f + UI_WIDTH / 2.0f;
+    float centerY = (windowSize.y - UI_HEIGHT) / 2.0f + UI_HEIGHT / 2.0f;
+    float columnWidth = (UI_WIDTH - 100.0f) / 4.0f;
+    float x = (windowSize.x - UI_WIDTH) / 2.0f + 20.0f + column * (columnWidth + 20.0f) + columnWidth / 2.0f;
+    float y = (windowSize.y - UI_HEIGHT) / 2.0f + 170.0f + row * 120.0f + 55.0f;
+    sf::Vector2i point;
+    point.x = static_cast<int>(centerX + (x - centerX) * scale);
+    point.y = static_cast<int>(centerY + (y - centerY) * scale);
+    return point;
+}
+
+void moveMouseAway() {
+    sf::Mouse::position.x = -100;
+    sf::Mouse::position.y = -100;
+}
+
+// ========================
+// Tests
+// ========================
+
+TEST(CatalogMatchesLegacy) {
+    moveMouseAway();
+    sf::RenderWindow window;
+    ShopUILayer layer;
+    Player player;
+    for (float progress : {0.1f, 0.5f, 1.0f}) {
+        assertSameTexts(legacyFrame(window, player, progress), retainedFrame(layer, window, player, progress));
+    }
+}
+
+TEST(StatusFollowsPlayer) {
+    moveMouseAway();
+    sf::RenderWindow window;
+    ShopUILayer layer;
+    Player player;
+    std::vector<std::unique_ptr<Weapon>> owned;
+    
+    player.money = 12000;   // Some rifles and all snipers become unaffordable
+    assertSameTexts(legacyFrame(window, player, 1.0f), retainedFrame(layer, window, player, 1.0f));
+    
+    owned.emplace_back(Weapon::create(Weapon::AK47));
+    player.inventory[0] = owned.back().get();   // Rifle ammo becomes purchasable
+    assertSameTexts(legacyFrame(window, player, 1.0f), retainedFrame(layer, window, player, 1.0f));
+    
+    player.money = 120;     // Only the cheapest ammo is affordable
+    assertSameTexts(legacyFrame(window, player, 1.0f), retainedFrame(layer, window, player, 1.0f));
+    
+    for (int slot = 1; slot < 4; slot++) {
+        owned.emplace_back(Weapon::create(Weapon::USP));
+        player.inventory[slot] = owned.back().get();
+    }
+    player.money = 50000;   // Inventory full
+    assertSameTexts(legacyFrame(window, player, 1.0f), retainedFrame(layer, window, player, 1.0f));
+}
+
+TEST(SteadyFrameHasNoLayouts) {
+    moveMouseAway();
+    sf::RenderWindow window;
+    ShopUILayer layer;
+    Player player;
+    retainedFrame(layer, window, player, 1.0f);
+    long long layouts = g_textLayouts;
+    long long objects = g_textObjects;
+    for (int frame = 0; frame < 10; frame++) {
+        retainedFrame(layer, window, player, 1.0f);
+    }
+    ASSERT_EQ(0, static_cast<int>(g_textLayouts - layouts));
+    ASSERT_EQ(0, static_cast<int>(g_textObjects - objects));
+}
+
+TEST(OnlyChangedFieldsRelaid) {
+    moveMouseAway();
+    sf::RenderWindow window;
+    ShopUILayer layer;
+    Player player;
+    retainedFrame(layer, window, player, 1.0f);
+    
+    // Money changes, every status stays the same: only the money line
+    long long layouts = g_textLayouts;
+    player.money = 49000;
+    retainedFrame(layer, window, player, 1.0f);
+    ASSERT_EQ(1, static_cast<int>(g_textLayouts - layouts));
+    
+    // M10, M40 and AWP (20000-25000) become unaffordable: money + 3 statuses
+    layouts = g_textLayouts;
+    player.money = 19000;
+    retainedFrame(layer, window, player, 1.0f);
+    ASSERT_EQ(4, static_cast<int>(g_textLayouts - layouts));
+}
+
+TEST(HoverUnderAnimationScale) {
+    sf::RenderWindow window;
+    ShopUILayer layer;
+    Player player;
+    for (float progress : {0.2f, 0.6f, 1.0f}) {
+        for (int column = 0; column < 4; column++) {
+            sf::Mouse::position = rowCenter(window.size, column, 1, progress);
+            std::vector<std::string> legacy = legacyFrame(window, player, progress);
+            std::vector<std::string> retained = retainedFrame(layer, window, player, progress);
+            assertSameTexts(legacy, retained);
+            ASSERT_TRUE(retained.size() > 60);   // Tooltip texts follow the catalog
+        }
+    }
+}
+
+TEST(TooltipBuiltOnce) {
+    sf::RenderWindow window;
+    ShopUILayer layer;
+    Player player;
+    sf::Mouse::position = rowCenter(window.size, 2, 0, 1.0f);
+    retainedFrame(layer, window, player, 1.0f);
+    long long layouts = g_textLayouts;
+    sf::Mouse::position.x += 5;   // Tooltip follows the mouse without re-laying text
+    retainedFrame(layer, window, player, 1.0f);
+    ASSERT_EQ(0, static_cast<int>(g_textLayouts - layouts));
+}
+
+TEST(ResizeRebuildsLayout) {
+    moveMouseAway();
+    sf::RenderWindow window;
+    ShopUILayer layer;
+    Player player;
+    retainedFrame(layer, window, player, 1.0f);
+    window.size = sf::Vector2u(1600, 900);
+    long long layouts = g_textLayouts;
+    assertSameTexts(legacyFrame(window, player, 1.0f), retainedFrame(layer, window, player, 1.0f));
+    ASSERT_TRUE(g_textLayouts - layouts > 60);
+    sf::Mouse::position = rowCenter(window.size, 3, 2, 1.0f);
+    assertSameTexts(legacyFrame(window, player, 1.0f), retainedFrame(layer, window, player, 1.0f));
+}
+
+// ========================
+// Benchmark
+// ========================
+
+// Per-frame cost of one shop scenario for the legacy and retained shop
+// Neither runs while the shop is closed, so each open row is what the shop adds
+// to the frame time. Opening replays the 0.3 s open animation (18 frames at
+// 60 FPS). Each shop gets a fresh font: glyphs rasterized counts every glyph
+// the scenario needed for the first time, warm-up included.
+void benchmarkScenario(const std::string& label, bool shopOpen, bool hover, bool buying, bool opening) {
+    const int FRAMES = 2000;
+    const int OPEN_FRAMES = 18;
+    sf::RenderWindow window;
+    Player player;
+    if (hover) {
+        sf::Mouse::position = rowCenter(window.size, 1, 2, 1.0f);
+    } else {
+        moveMouseAway();
+    }
+    
+    struct Result {
+        double us = 0.0;
+        double layouts = 0.0;
+        double draws = 0.0;
+        long long glyphs = 0;
+    };
+    auto run = [&](const std::function<void(float)>& frame) {
+        Result result;
+        player.money = 50000;
+        long long glyphs0 = g_glyphsRasterized;
+        if (shopOpen) {
+            frame(opening ? 1.0f / OPEN_FRAMES : 1.0f);  // Warm up (the retained layer builds here)
+        }
+        long long layouts0 = g_textLayouts;
+        long long draws0 = g_drawCalls;
+        auto t0 = std::chrono::high_resolution_clock::now();
+        for (int n = 0; n < FRAMES; n++) {
+            if (buying) player.money -= 7;
+            if (shopOpen) frame(opening ? static_cast<float>(n % OPEN_FRAMES + 1) / OPEN_FRAMES : 1.0f);
+        }
+        auto t1 = std::chrono::high_resolution_clock::now();
+        result.us = std::chrono::duration<double, std::micro>(t1 - t0).count() / FRAMES;
+        result.layouts = static_cast<double>(g_textLayouts - layouts0) / FRAMES;
+        result.draws = static_cast<double>(g_drawCalls - draws0) / FRAMES;
+        result.glyphs = g_glyphsRasterized - glyphs0;
+        return result;
+    };
+    
+    sf::Font legacyFont;
+    Result legacy = run([&](float progress) {
+        window.lastTexts.clear();
+        legacyRenderShopUI(window, player, legacyFont, progress);
+    });
+    ShopUILayer layer;
+    sf::Font retainedFont;
+    Result retained = run([&](float progress) {
+        window.lastTexts.clear();
+        layer.render(window, player, retainedFont, progress);
+    });
+    
+    std::cout << std::left << std::setw(22) << label << std::right << std::fixed << std::setprecision(1)
+              << std::setw(9) << legacy.layouts << " /" << std::setw(6) << retained.layouts
+              << std::setw(9) << legacy.draws << " /" << std::setw(6) << retained.draws
+              << std::setw(9) << legacy.glyphs << " /" << std::setw(6) << retained.glyphs
+              << std::setprecision(2) << std::setw(11) << legacy.us << " /" << std::setw(6) << retained.us << std::endl;
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Zero Ground Retained Shop UI Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "--- Shop UI Tests ---" << std::endl;
+    RUN_TEST(CatalogMatchesLegacy);
+    RUN_TEST(StatusFollowsPlayer);
+    RUN_TEST(SteadyFrameHasNoLayouts);
+    RUN_TEST(OnlyChangedFieldsRelaid);
+    RUN_TEST(HoverUnderAnimationScale);
+    RUN_TEST(TooltipBuiltOnce);
+    RUN_TEST(ResizeRebuildsLayout);
+
+    std::cout << std::endl;
+    std::cout << "--- Shop UI per Frame, legacy / retained (2000 frames) ---" << std::endl;
+    std::cout << "(CPU includes glyph layout; GPU time and glyph rasterization are not measured)" << std::endl;
+    std::cout << std::left << std::setw(22) << "Scenario" << std::right << std::setw(17) << "Text layouts"
+              << std::setw(17) << "Draw calls" << std::setw(17) << "Glyphs raster." << std::setw(18) << "CPU (us)" << std::endl;
+    benchmarkScenario("Shop closed", false, false, false, false);
+    benchmarkScenario("Shop opening", true, false, false, true);
+    benchmarkScenario("Shop open", true, false, false, false);
+    benchmarkScenario("Shop open + tooltip", true, true, false, false);
+    benchmarkScenario("Shop open, buying", true, false, true, false);
+
+    // Print summary
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Test Summary" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Total tests: " << totalTests << std::endl;
+    std::cout << "Passed: " << passedTests << std::endl;
+    std::cout << "Failed: " << failedTests << std::endl;
+    std::cout << std::endl;
+
+    if (failedTests == 0) {
+        std::cout << "✓ All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "✗ Some tests failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,673 @@
+// Snapshot Codec Tests and Bandwidth Benchmark for Zero Ground
+// Round-trips quantized, delta-compressed snapshots through BitWriter/BitReader
+// and compares snapshot sizes with the previous one-PositionPacket-per-player
+// format for 8, 32 and 64 moving players.
+//
+// The codec is copied from Zero_Ground.cpp (identical in the client).
+// Build with /O2 (or -O2).
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+
+// ========================
+// Test Framework Macros
+// ========================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "Running test: " << #name << "..."; \
+    try { \
+        test_##name(); \
+        std::cout << " PASSED" << std::endl; \
+        passedTests++; \
+    } catch (const std::exception& e) { \
+        std::cout << " FAILED: " << e.what() << std::endl; \
+        failedTests++; \
+    } \
+    totalTests++; \
+} while(0)
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: " << #condition << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_NEAR(expected, actual, epsilon) do { \
+    if (std::abs((expected) - (actual)) > (epsilon)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << (expected) << " but got " << (actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(expected, actual) do { \
+    if ((expected) != (actual)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << static_cast<int>(expected) << " but got " << static_cast<int>(actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+// Test counters
+int totalTests = 0;
+int passedTests = 0;
+int failedTests = 0;
+
+// ========================
+// Code Under Test (copied from main code)
+// ========================
+
+const float MAP_SIZE = 5100.0f;
+
+// Previous per-player packet, for size comparison
+struct PositionPacket {
+    float x = 0.0f;
+    float y = 0.0f;
+    float rotation = 0.0f;
+    float health = 100.0f;
+    bool isAlive = true;
+    uint32_t frameID = 0;
+    uint8_t playerId = 0;
+    uint32_t ackTick = 0xFFFFFFFF;
+};
+
+// Player state as carried in snapshots, quantized to the map and byte ranges
+struct QuantizedPlayerState {
+    uint8_t id = 0;
+    uint16_t x = 0;         // 0..65535 over 0..MAP_SIZE (~0.08 px)
+    uint16_t y = 0;
+    uint16_t rotation = 0;  // 0..511 over 0..360 degrees (~0.7 degrees)
+    uint8_t health = 0;     // Whole hit points, clamped to 0..255
+    bool isAlive = false;
+};
+
+const uint8_t SNAPSHOT_MARKER = 0xD5;           // First byte of a snapshot datagram (shot/hit packets start with a player ID < 64)
+const int SNAPSHOT_ID_BITS = 6;                 // MAX_PLAYERS = 64
+const int SNAPSHOT_COUNT_BITS = 7;              // 0..64 players
+const int SNAPSHOT_POSITION_BITS = 16;
+const int SNAPSHOT_SMALL_DELTA_BITS = 10;       // Signed, +-511 units (~40 px) covers normal movement
+const int SNAPSHOT_ROTATION_BITS = 9;
+const int SNAPSHOT_HEALTH_BITS = 8;
+const int SNAPSHOT_BASELINE_BITS = 16;          // Baseline is sent as a tick offset
+const uint32_t SNAPSHOT_HISTORY_SIZE = 32;      // Snapshots kept as delta baselines (1.6 s at 20 Hz)
+const size_t MAX_SNAPSHOT_BYTES = 1200;         // Stays below a typical 1500 byte MTU
+const uint32_t NO_SNAPSHOT_ACK = 0xFFFFFFFF;    // PositionPacket::ackTick before the first snapshot
+
+uint16_t quantizePosition(float value) {
+    float clamped = std::max(0.0f, std::min(MAP_SIZE, value));
+    return static_cast<uint16_t>(std::lround(clamped / MAP_SIZE * 65535.0f));
+}
+
+float dequantizePosition(uint16_t value) {
+    return value * (MAP_SIZE / 65535.0f);
+}
+
+uint16_t quantizeRotation(float degrees) {
+    float wrapped = std::fmod(degrees, 360.0f);
+    if (wrapped < 0.0f) wrapped += 360.0f;
+    const uint32_t steps = 1u << SNAPSHOT_ROTATION_BITS;
+    return static_cast<uint16_t>(static_cast<uint32_t>(std::lround(wrapped / 360.0f * steps)) & (steps - 1));
+}
+
+float dequantizeRotation(uint16_t value) {
+    return value * (360.0f / (1u << SNAPSHOT_ROTATION_BITS));
+}
+
+QuantizedPlayerState quantizePlayerState(uint32_t id, float x, float y, float rotation, float health, bool isAlive) {
+    QuantizedPlayerState state;
+    state.id = static_cast<uint8_t>(id);
+    state.x = quantizePosition(x);
+    state.y = quantizePosition(y);
+    state.rotation = quantizeRotation(rotation);
+    state.health = static_cast<uint8_t>(std::max(0L, std::min(255L, std::lround(health))));
+    state.isAlive = isAlive;
+    return state;
+}
+
+// Appends values of 1-32 bits to a fixed buffer, least significant bit first
+// Writing past the end sets overflowed() instead of growing the buffer
+class BitWriter {
+public:
+    BitWriter(uint8_t* buffer, size_t capacity) : buffer_(buffer), capacity_(capacity), bitPos_(0), overflowed_(false) {
+        std::memset(buffer_, 0, capacity_);
+    }
+    
+    void write(uint32_t value, int bits) {
+        if (bitPos_ + bits > capacity_ * 8) {
+            overflowed_ = true;
+            return;
+        }
+        for (int i = 0; i < bits; ++i) {
+            if (value & (1u << i)) {
+                buffer_[bitPos_ >> 3] |= static_cast<uint8_t>(1u << (bitPos_ & 7));
+            }
+            bitPos_++;
+        }
+    }
+    
+    void writeBool(bool value) { write(value ? 1u : 0u, 1); }
+    
+    size_t bytesWritten() const { return (bitPos_ + 7) / 8; }
+    bool overflowed() const { return overflowed_; }
+    
+private:
+    uint8_t* buffer_;
+    size_t capacity_;
+    size_t bitPos_;
+    bool overflowed_;
+};
+
+// Reads values written by BitWriter straight from the receive buffer
+// Reading past the end returns 0 and sets failed(); callers check once at the end
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size) : data_(data), size_(size), bitPos_(0), failed_(false) {}
+    
+    uint32_t read(int bits) {
+        if (bitPos_ + bits > size_ * 8) {
+            failed_ = true;
+            return 0;
+        }
+        uint32_t value = 0;
+        for (int i = 0; i < bits; ++i) {
+            if (data_[bitPos_ >> 3] & (1u << (bitPos_ & 7))) {
+                value |= (1u << i);
+            }
+            bitPos_++;
+        }
+        return value;
+    }
+    
+    bool readBool() { return read(1) != 0; }
+    
+    bool failed() const { return failed_; }
+    
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t bitPos_;
+    bool failed_;
+};
+
+// Recently sent (server, per client) or received (client) snapshots, usable as delta baselines
+// Slots are reused round-robin so the tick spacing between snapshots does not matter
+class SnapshotHistory {
+public:
+    void store(uint32_t tick, const std::vector<QuantizedPlayerState>& players) {
+        Entry& entry = entries_[next_];
+        entry.tick = tick;
+        entry.valid = true;
+        entry.players = players;  // Reuses the slot's capacity
+        next_ = (next_ + 1) % SNAPSHOT_HISTORY_SIZE;
+    }
+    
+    const std::vector<QuantizedPlayerState>* find(uint32_t tick) const {
+        for (const Entry& entry : entries_) {
+            if (entry.valid && entry.tick == tick) {
+                return &entry.players;
+            }
+        }
+        return nullptr;
+    }
+    
+private:
+    struct Entry {
+        uint32_t tick = 0;
+        bool valid = false;
+        std::vector<QuantizedPlayerState> players;  // Sorted by id
+    };
+    std::array<Entry, SNAPSHOT_HISTORY_SIZE> entries_;
+    uint32_t next_ = 0;
+};
+
+// Position field: unchanged (1 bit), small signed delta (12 bits) or full value (18 bits)
+inline void writePositionDelta(BitWriter& writer, uint16_t value, uint16_t base) {
+    int delta = static_cast<int>(value) - static_cast<int>(base);
+    const int smallLimit = 1 << (SNAPSHOT_SMALL_DELTA_BITS - 1);
+    writer.writeBool(delta != 0);
+    if (delta == 0) return;
+    bool small = delta >= -smallLimit && delta < smallLimit;
+    writer.writeBool(small);
+    if (small) {
+        writer.write(static_cast<uint32_t>(delta) & ((1u << SNAPSHOT_SMALL_DELTA_BITS) - 1), SNAPSHOT_SMALL_DELTA_BITS);
+    } else {
+        writer.write(value, SNAPSHOT_POSITION_BITS);
+    }
+}
+
+inline uint16_t readPositionDelta(BitReader& reader, uint16_t base) {
+    if (!reader.readBool()) return base;
+    if (!reader.readBool()) return static_cast<uint16_t>(reader.read(SNAPSHOT_POSITION_BITS));
+    uint32_t raw = reader.read(SNAPSHOT_SMALL_DELTA_BITS);
+    int delta = static_cast<int>(raw);
+    if (raw & (1u << (SNAPSHOT_SMALL_DELTA_BITS - 1))) {
+        delta -= (1 << SNAPSHOT_SMALL_DELTA_BITS);  // Sign-extend
+    }
+    return static_cast<uint16_t>(static_cast<int>(base) + delta);
+}
+
+// Encode one snapshot
+// Parameters:
+//   writer - Output buffer
+//   tick - Server tick of this snapshot
+//   players - States to send, sorted by id
+//   baseline - Snapshot the client acknowledged (nullptr = full snapshot)
+//   baselineTick - Tick of baseline, at most 65535 ticks old
+//
+// FORMAT (bit-packed, LSB first):
+//   marker:8  tick:32  hasBaseline:1  [tick - baselineTick:16]  count:7
+//   per player: id:6, then
+//     not in baseline: x:16 y:16 rotation:9 health:8 alive:1
+//     in baseline:     x:delta y:delta [changed:1 rotation:9] [changed:1 health:8] alive:1
+//   Players missing from a snapshot are not visible to the client (culled or gone).
+//
+// PERFORMANCE: a PositionPacket per player costs 32 bytes; a full entry is
+// 56 bits and an idle player in a delta snapshot is 11 bits (~23x smaller).
+void writeSnapshot(BitWriter& writer, uint32_t tick, const std::vector<QuantizedPlayerState>& players,
+                   const std::vector<QuantizedPlayerState>* baseline, uint32_t baselineTick) {
+    writer.write(SNAPSHOT_MARKER, 8);
+    writer.write(tick, 32);
+    writer.writeBool(baseline != nullptr);
+    if (baseline) {
+        writer.write(tick - baselineTick, SNAPSHOT_BASELINE_BITS);
+    }
+    writer.write(static_cast<uint32_t>(players.size()), SNAPSHOT_COUNT_BITS);
+    
+    size_t b = 0;  // Both lists are sorted by id: merge instead of searching
+    for (const QuantizedPlayerState& state : players) {
+        writer.write(state.id, SNAPSHOT_ID_BITS);
+        
+        const QuantizedPlayerState* base = nullptr;
+        if (baseline) {
+            while (b < baseline->size() && (*baseline)[b].id < state.id) b++;
+            if (b < baseline->size() && (*baseline)[b].id == state.id) base = &(*baseline)[b];
+        }
+        
+        if (base) {
+            writePositionDelta(writer, state.x, base->x);
+            writePositionDelta(writer, state.y, base->y);
+            writer.writeBool(state.rotation != base->rotation);
+            if (state.rotation != base->rotation) writer.write(state.rotation, SNAPSHOT_ROTATION_BITS);
+            writer.writeBool(state.health != base->health);
+            if (state.health != base->health) writer.write(state.health, SNAPSHOT_HEALTH_BITS);
+        } else {
+            writer.write(state.x, SNAPSHOT_POSITION_BITS);
+            writer.write(state.y, SNAPSHOT_POSITION_BITS);
+            writer.write(state.rotation, SNAPSHOT_ROTATION_BITS);
+            writer.write(state.health, SNAPSHOT_HEALTH_BITS);
+        }
+        writer.writeBool(state.isAlive);
+    }
+}
+
+// Decode one snapshot in place from the receive buffer
+// Parameters:
+//   data, size - Received datagram
+//   history - Previously decoded snapshots (delta baselines)
+//   tick - Out: server tick of the snapshot
+//   players - Out: decoded states, sorted by id
+// Returns: false if the datagram is malformed/truncated or its baseline is unknown
+bool readSnapshot(const uint8_t* data, size_t size, const SnapshotHistory& history,
+                  uint32_t& tick, std::vector<QuantizedPlayerState>& players) {
+    BitReader reader(data, size);
+    if (reader.read(8) != SNAPSHOT_MARKER) return false;
+    tick = reader.read(32);
+    
+    const std::vector<QuantizedPlayerState>* baseline = nullptr;
+    if (reader.readBool()) {
+        uint32_t baselineTick = tick - reader.read(SNAPSHOT_BASELINE_BITS);
+        baseline = history.find(baselineTick);
+        if (!baseline) return false;  // Baseline already evicted (or never received)
+    }
+    
+    uint32_t count = reader.read(SNAPSHOT_COUNT_BITS);
+    if (reader.failed() || count > (1u << SNAPSHOT_ID_BITS)) return false;
+    
+    players.clear();
+    size_t b = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        QuantizedPlayerState state;
+        state.id = static_cast<uint8_t>(reader.read(SNAPSHOT_ID_BITS));
+        if (!players.empty() && state.id <= players.back().id) return false;  // Must be strictly sorted
+        
+        const QuantizedPlayerState* base = nullptr;
+        if (baseline) {
+            while (b < baseline->size() && (*baseline)[b].id < state.id) b++;
+            if (b < baseline->size() && (*baseline)[b].id == state.id) base = &(*baseline)[b];
+        }
+        
+        if (base) {
+            state.x = readPositionDelta(reader, base->x);
+            state.y = readPositionDelta(reader, base->y);
+            state.rotation = reader.readBool() ? static_cast<uint16_t>(reader.read(SNAPSHOT_ROTATION_BITS)) : base->rotation;
+            state.health = reader.readBool() ? static_cast<uint8_t>(reader.read(SNAPSHOT_HEALTH_BITS)) : base->health;
+        } else {
+            state.x = static_cast<uint16_t>(reader.read(SNAPSHOT_POSITION_BITS));
+            state.y = static_cast<uint16_t>(reader.read(SNAPSHOT_POSITION_BITS));
+            state.rotation = static_cast<uint16_t>(reader.read(SNAPSHOT_ROTATION_BITS));
+            state.health = static_cast<uint8_t>(reader.read(SNAPSHOT_HEALTH_BITS));
+        }
+        state.isAlive = reader.readBool();
+        players.push_back(state);
+    }
+    
+    return !reader.failed();
+}
+
+// ========================
+// Helpers
+// ========================
+
+struct SimPlayer {
+    uint32_t id;
+    float x, y, vx, vy, rotation, health;
+    bool isAlive;
+};
+
+std::vector<SimPlayer> makePlayers(int count, std::mt19937& gen) {
+    std::uniform_real_distribution<float> pos(100.0f, MAP_SIZE - 100.0f);
+    std::uniform_real_distribution<float> vel(-1.0f, 1.0f);
+    std::vector<SimPlayer> players;
+    for (int i = 0; i < count; ++i) {
+        // Roughly half the players stand still at any time
+        bool moving = (i % 2) == 0;
+        players.push_back({ static_cast<uint32_t>(i), pos(gen), pos(gen),
+                            moving ? vel(gen) * 180.0f : 0.0f, moving ? vel(gen) * 180.0f : 0.0f,
+                            static_cast<float>(i * 37 % 360), 100.0f, true });
+    }
+    return players;
+}
+
+std::vector<QuantizedPlayerState> quantizeAll(const std::vector<SimPlayer>& players) {
+    std::vector<QuantizedPlayerState> states;
+    for (const SimPlayer& p : players) {
+        states.push_back(quantizePlayerState(p.id, p.x, p.y, p.rotation, p.health, p.isAlive));
+    }
+    return states;
+}
+
+bool sameStates(const std::vector<QuantizedPlayerState>& a, const std::vector<QuantizedPlayerState>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].id != b[i].id || a[i].x != b[i].x || a[i].y != b[i].y || a[i].rotation != b[i].rotation ||
+            a[i].health != b[i].health || a[i].isAlive != b[i].isAlive) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ========================
+// Tests
+// ========================
+
+TEST(BitWriterReaderRoundTrip) {
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<int> widthDist(1, 32);
+    std::vector<std::pair<uint32_t, int>> values;
+    uint8_t buffer[4096];
+    BitWriter writer(buffer, sizeof(buffer));
+    for (int i = 0; i < 500; ++i) {
+        int bits = widthDist(gen);
+        uint32_t value = static_cast<uint32_t>(gen()) & (bits == 32 ? 0xFFFFFFFFu : ((1u << bits) - 1));
+        values.push_back({ value, bits });
+        writer.write(value, bits);
+    }
+    ASSERT_TRUE(!writer.overflowed());
+
+    BitReader reader(buffer, writer.bytesWritten());
+    for (const auto& v : values) {
+        ASSERT_TRUE(reader.read(v.second) == v.first);
+    }
+    ASSERT_TRUE(!reader.failed());
+    reader.read(8);
+    ASSERT_TRUE(reader.failed());  // Past the end
+}
+
+TEST(WriterOverflowIsReported) {
+    uint8_t buffer[2];
+    BitWriter writer(buffer, sizeof(buffer));
+    writer.write(0xFFFF, 16);
+    ASSERT_TRUE(!writer.overflowed());
+    writer.write(1, 1);
+    ASSERT_TRUE(writer.overflowed());
+}
+
+TEST(QuantizationError) {
+    for (float v = 0.0f; v <= MAP_SIZE; v += 13.37f) {
+        ASSERT_NEAR(v, dequantizePosition(quantizePosition(v)), MAP_SIZE / 65535.0f);
+    }
+    ASSERT_TRUE(quantizePosition(-50.0f) == 0);
+    ASSERT_TRUE(quantizePosition(MAP_SIZE + 50.0f) == 65535);
+    for (float r = -720.0f; r <= 720.0f; r += 7.3f) {
+        float wrapped = std::fmod(r, 360.0f);
+        if (wrapped < 0.0f) wrapped += 360.0f;
+        float back = dequantizeRotation(quantizeRotation(r));
+        float diff = std::abs(back - wrapped);
+        diff = std::min(diff, 360.0f - diff);
+        ASSERT_TRUE(diff <= 360.0f / 512.0f);
+    }
+    QuantizedPlayerState state = quantizePlayerState(5, 10.0f, 20.0f, 0.0f, 73.6f, true);
+    ASSERT_TRUE(state.health == 74);
+    ASSERT_TRUE(quantizePlayerState(5, 0.0f, 0.0f, 0.0f, -10.0f, false).health == 0);
+}
+
+TEST(FullSnapshotRoundTrip) {
+    std::mt19937 gen(5);
+    auto states = quantizeAll(makePlayers(64, gen));
+    uint8_t buffer[MAX_SNAPSHOT_BYTES];
+    BitWriter writer(buffer, sizeof(buffer));
+    writeSnapshot(writer, 1234, states, nullptr, 0);
+    ASSERT_TRUE(!writer.overflowed());
+
+    SnapshotHistory history;
+    uint32_t tick = 0;
+    std::vector<QuantizedPlayerState> decoded;
+    ASSERT_TRUE(readSnapshot(buffer, writer.bytesWritten(), history, tick, decoded));
+    ASSERT_TRUE(tick == 1234);
+    ASSERT_TRUE(sameStates(states, decoded));
+}
+
+TEST(DeltaSnapshotsTrackMovingPlayers) {
+    std::mt19937 gen(7);
+    auto players = makePlayers(32, gen);
+    SnapshotHistory serverHistory, clientHistory;
+    uint8_t buffer[MAX_SNAPSHOT_BYTES];
+    uint32_t ack = NO_SNAPSHOT_ACK;
+
+    for (uint32_t tick = 0; tick < 600; tick += 3) {
+        for (SimPlayer& p : players) {
+            p.x = std::max(0.0f, std::min(MAP_SIZE, p.x + p.vx * 0.05f));
+            p.y = std::max(0.0f, std::min(MAP_SIZE, p.y + p.vy * 0.05f));
+            p.rotation += 3.0f;
+        }
+        // Occasionally a big jump (respawn) and a health change
+        if (tick % 60 == 0) {
+            players[3].x = MAP_SIZE - players[3].x;
+            players[5].health -= 10.0f;
+        }
+        auto states = quantizeAll(players);
+
+        const std::vector<QuantizedPlayerState>* baseline = (ack != NO_SNAPSHOT_ACK) ? serverHistory.find(ack) : nullptr;
+        BitWriter writer(buffer, sizeof(buffer));
+        writeSnapshot(writer, tick, states, baseline, ack);
+        serverHistory.store(tick, states);
+
+        uint32_t decodedTick = 0;
+        std::vector<QuantizedPlayerState> decoded;
+        ASSERT_TRUE(readSnapshot(buffer, writer.bytesWritten(), clientHistory, decodedTick, decoded));
+        ASSERT_TRUE(decodedTick == tick);
+        ASSERT_TRUE(sameStates(states, decoded));
+        clientHistory.store(decodedTick, decoded);
+
+        // Client acks with one snapshot of delay (the ack is in flight)
+        if (tick >= 3) ack = tick - 3;
+    }
+}
+
+TEST(PlayersJoiningAndLeaving) {
+    std::mt19937 gen(11);
+    auto players = makePlayers(10, gen);
+    auto first = quantizeAll(players);
+    uint8_t buffer[MAX_SNAPSHOT_BYTES];
+
+    SnapshotHistory clientHistory;
+    BitWriter w1(buffer, sizeof(buffer));
+    writeSnapshot(w1, 100, first, nullptr, 0);
+    uint32_t tick;
+    std::vector<QuantizedPlayerState> decoded;
+    ASSERT_TRUE(readSnapshot(buffer, w1.bytesWritten(), clientHistory, tick, decoded));
+    clientHistory.store(tick, decoded);
+
+    // Drop players 2 and 7 (culled/left), add 40 and 41 (new), keep the rest
+    std::vector<QuantizedPlayerState> second;
+    for (const auto& s : first) {
+        if (s.id != 2 && s.id != 7) second.push_back(s);
+    }
+    second.push_back(quantizePlayerState(40, 100.0f, 200.0f, 90.0f, 100.0f, true));
+    second.push_back(quantizePlayerState(41, 300.0f, 400.0f, 180.0f, 50.0f, false));
+
+    BitWriter w2(buffer, sizeof(buffer));
+    writeSnapshot(w2, 103, second, &first, 100);
+    ASSERT_TRUE(readSnapshot(buffer, w2.bytesWritten(), clientHistory, tick, decoded));
+    ASSERT_TRUE(sameStates(second, decoded));
+}
+
+TEST(MalformedSnapshotsRejected) {
+    std::mt19937 gen(13);
+    auto states = quantizeAll(makePlayers(20, gen));
+    uint8_t buffer[MAX_SNAPSHOT_BYTES];
+    BitWriter writer(buffer, sizeof(buffer));
+    writeSnapshot(writer, 50, states, nullptr, 0);
+
+    SnapshotHistory history;
+    uint32_t tick;
+    std::vector<QuantizedPlayerState> decoded;
+
+    // Every truncation fails cleanly
+    for (size_t size = 0; size < writer.bytesWritten(); ++size) {
+        ASSERT_TRUE(!readSnapshot(buffer, size, history, tick, decoded));
+    }
+
+    // Wrong marker
+    uint8_t corrupt[MAX_SNAPSHOT_BYTES];
+    std::memcpy(corrupt, buffer, writer.bytesWritten());
+    corrupt[0] = 0x01;
+    ASSERT_TRUE(!readSnapshot(corrupt, writer.bytesWritten(), history, tick, decoded));
+
+    // Delta against a baseline the client never received
+    BitWriter deltaWriter(buffer, sizeof(buffer));
+    writeSnapshot(deltaWriter, 53, states, &states, 50);
+    ASSERT_TRUE(!readSnapshot(buffer, deltaWriter.bytesWritten(), history, tick, decoded));
+}
+
+TEST(IdlePlayersCostElevenBits) {
+    std::mt19937 gen(17);
+    auto states = quantizeAll(makePlayers(64, gen));
+    uint8_t buffer[MAX_SNAPSHOT_BYTES];
+    BitWriter writer(buffer, sizeof(buffer));
+    writeSnapshot(writer, 10, states, &states, 7);
+    // Header 8 + 32 + 1 + 16 + 7 bits, then 11 bits per unchanged player
+    ASSERT_TRUE(writer.bytesWritten() == (64 + 64 * 11 + 7) / 8);
+}
+
+// ========================
+// Bandwidth Benchmark
+// ========================
+
+// Bytes per snapshot for one client at 20 Hz with a 100 ms ack delay
+void benchmarkBandwidth(int playerCount) {
+    std::mt19937 gen(playerCount);
+    auto players = makePlayers(playerCount, gen);
+    SnapshotHistory history;
+    uint8_t buffer[MAX_SNAPSHOT_BYTES];
+    size_t fullBytes = 0, deltaBytes = 0;
+    int snapshots = 0;
+
+    for (uint32_t tick = 0; tick < 1200; tick += 3) {
+        for (SimPlayer& p : players) {
+            p.x = std::max(0.0f, std::min(MAP_SIZE, p.x + p.vx * 0.05f));
+            p.y = std::max(0.0f, std::min(MAP_SIZE, p.y + p.vy * 0.05f));
+            if (p.vx != 0.0f) p.rotation += 2.0f;
+        }
+        auto states = quantizeAll(players);
+
+        BitWriter full(buffer, sizeof(buffer));
+        writeSnapshot(full, tick, states, nullptr, 0);
+        fullBytes += full.bytesWritten();
+
+        uint32_t ack = tick >= 6 ? tick - 6 : 0;
+        const std::vector<QuantizedPlayerState>* baseline = history.find(ack);
+        BitWriter delta(buffer, sizeof(buffer));
+        writeSnapshot(delta, tick, states, baseline, ack);
+        deltaBytes += delta.bytesWritten();
+        history.store(tick, states);
+        snapshots++;
+    }
+
+    size_t rawBytes = playerCount * sizeof(PositionPacket);
+    double full = static_cast<double>(fullBytes) / snapshots;
+    double delta = static_cast<double>(deltaBytes) / snapshots;
+    std::cout << std::setw(10) << playerCount
+              << std::setw(14) << rawBytes
+              << std::setw(14) << std::fixed << std::setprecision(1) << full
+              << std::setw(14) << delta
+              << std::setw(12) << std::setprecision(1) << (rawBytes / delta) << "x"
+              << std::setw(14) << std::setprecision(0) << (delta * 20.0) << std::endl;
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Zero Ground Snapshot Codec Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "--- Snapshot Codec Tests ---" << std::endl;
+    RUN_TEST(BitWriterReaderRoundTrip);
+    RUN_TEST(WriterOverflowIsReported);
+    RUN_TEST(QuantizationError);
+    RUN_TEST(FullSnapshotRoundTrip);
+    RUN_TEST(DeltaSnapshotsTrackMovingPlayers);
+    RUN_TEST(PlayersJoiningAndLeaving);
+    RUN_TEST(MalformedSnapshotsRejected);
+    RUN_TEST(IdlePlayersCostElevenBits);
+
+    std::cout << std::endl;
+    std::cout << "--- Bytes per Snapshot (one client, half the players moving) ---" << std::endl;
+    std::cout << std::setw(10) << "Players" << std::setw(14) << "Packets" << std::setw(14) << "Full"
+              << std::setw(14) << "Delta" << std::setw(13) << "Ratio" << std::setw(14) << "Delta B/s" << std::endl;
+    for (int count : { 8, 32, 64 }) {
+        benchmarkBandwidth(count);
+    }
+
+    // Print summary
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Test Summary" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Total tests: " << totalTests << std::endl;
+    std::cout << "Passed: " << passedTests << std::endl;
+    std::cout << "Failed: " << failedTests << std::endl;
+    std::cout << std::endl;
+
+    if (failedTests == 0) {
+        std::cout << "✓ All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "✗ Some tests failed!" << std::endl;
+        return 1;
+    }
+}
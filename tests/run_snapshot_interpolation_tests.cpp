@@ -0,0 +1,673 @@
+// Snapshot Interpolation Tests and Benchmark for Zero Ground
+// Checks the client's tick-indexed snapshot buffer (interpolation between the
+// snapshots around the render tick, shortest-arc rotation, bounded
+// extrapolation, no sliding on teleports) and the adaptive delay (clock offset
+// from arrivals, delay following snapshot spacing and jitter). Then plays a
+// moving player over simulated links with jitter, loss and reordering at 20 and
+// 10 Hz and compares the rendered motion with the previous lerp toward the
+// newest snapshot.
+//
+// Code under test is copied from Zero_Ground_client.cpp. Build with /O2 (or -O2).
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <array>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+
+// ========================
+// Test Framework Macros
+// ========================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "Running test: " << #name << "..."; \
+    try { \
+        test_##name(); \
+        std::cout << " PASSED" << std::endl; \
+        passedTests++; \
+    } catch (const std::exception& e) { \
+        std::cout << " FAILED: " << e.what() << std::endl; \
+        failedTests++; \
+    } \
+    totalTests++; \
+} while(0)
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: " << #condition << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_NEAR(expected, actual, epsilon) do { \
+    if (std::abs((expected) - (actual)) > (epsilon)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << (expected) << " but got " << (actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(expected, actual) do { \
+    if ((expected) != (actual)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << static_cast<int>(expected) << " but got " << static_cast<int>(actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+// Test counters
+int totalTests = 0;
+int passedTests = 0;
+int failedTests = 0;
+
+
+// ========================
+// Code Under Test (copied from Zero_Ground_client.cpp)
+// ========================
+
+// State of one remote player in one snapshot
+struct EntityState {
+    float x = 0.0f;
+    float y = 0.0f;
+    float rotation = 0.0f;  // Degrees
+    bool isAlive = true;
+};
+
+// Maps server ticks to local time and picks the delayed render time
+//
+// Remote players are drawn where they were interpDelay seconds ago on the
+// server's timeline, so there are normally two snapshots around the render
+// time to interpolate between, whatever the frame rate.
+//
+// ALGORITHM:
+// - Clock offset: each snapshot gives arrival - tick * tickDuration. The
+//   offset follows the earliest arrivals (a lower value is taken at once,
+//   a higher one only by slow drift), so it tracks an on-time packet.
+// - Jitter: how late snapshots arrive relative to that offset, smoothed with
+//   a fast rise and a slow decay, so one late packet widens the margin at once
+//   and a calm link narrows it again over a few seconds.
+// - Delay target: measured snapshot spacing + 1.5 * jitter + a small margin,
+//   clamped to [MIN_DELAY, MAX_DELAY]. The delay moves toward the target by at
+//   most DELAY_SLEW seconds per second, so the remote players speed up or slow
+//   down by a few percent instead of jumping.
+class SnapshotClock {
+public:
+    static constexpr float MIN_DELAY = 0.03f;    // Seconds
+    static constexpr float MAX_DELAY = 0.3f;
+    static constexpr float SAFETY_MARGIN = 0.005f;
+    static constexpr float DELAY_SLEW = 0.1f;    // Delay change per second of play
+    static constexpr float OFFSET_DRIFT = 0.002f;
+    
+    void setTickRate(float ticksPerSecond) {
+        tickDuration_ = 1.0 / ticksPerSecond;
+    }
+    
+    // Record the arrival of the newest snapshot
+    // now - local time in seconds (same clock as advance())
+    void onSnapshot(uint32_t tick, float now) {
+        const double serverTime = tick * tickDuration_;
+        const double offset = now - serverTime;
+        
+        if (!synced_) {
+            offset_ = offset;
+            lastTick_ = tick;
+            synced_ = true;
+            return;
+        }
+        
+        if (offset < offset_) {
+            offset_ = offset;
+        } else {
+            offset_ += (offset - offset_) * OFFSET_DRIFT;
+        }
+        
+        const float lateness = static_cast<float>(offset - offset_);
+        jitter_ += (lateness - jitter_) * (lateness > jitter_ ? 0.25f : 0.02f);
+        
+        if (tick > lastTick_) {
+            const float spacing = static_cast<float>((tick - lastTick_) * tickDuration_);
+            spacing_ = spacing_ == 0.0f ? spacing : spacing_ + (spacing - spacing_) * 0.1f;
+            lastTick_ = tick;
+        }
+    }
+    
+    // Move the delay toward its target and return the render time in (fractional) ticks
+    double advance(float now, float deltaTime) {
+        const float target = targetDelay();
+        const float maxStep = DELAY_SLEW * deltaTime;
+        if (delay_ == 0.0f) {
+            delay_ = target;
+        } else {
+            delay_ += std::max(-maxStep, std::min(maxStep, target - delay_));
+        }
+        return (now - offset_ - delay_) / tickDuration_;
+    }
+    
+    float targetDelay() const {
+        return std::max(MIN_DELAY, std::min(MAX_DELAY, spacing_ + 1.5f * jitter_ + SAFETY_MARGIN));
+    }
+    
+    bool synced() const { return synced_; }
+    float delay() const { return delay_; }
+    float jitter() const { return jitter_; }
+    double tickDuration() const { return tickDuration_; }
+    
+private:
+    double tickDuration_ = 1.0 / 60.0;
+    double offset_ = 0.0;       // Local arrival time minus server time of an on-time snapshot
+    uint32_t lastTick_ = 0;
+    float spacing_ = 0.0f;      // Seconds between consecutive snapshots
+    float jitter_ = 0.0f;       // Smoothed lateness in seconds
+    float delay_ = 0.0f;        // Current interpolation delay in seconds
+    bool synced_ = false;
+};
+
+// Recent snapshot states of one remote player, ordered by server tick
+//
+// sample() interpolates between the two states around the render tick. Past
+// the newest state (late or lost snapshots) it extrapolates along the last
+// velocity for at most maxExtrapolationTicks, then holds, so a lost packet
+// costs a small overshoot instead of a freeze followed by a jump.
+//
+// PERFORMANCE:
+// Fixed ring of CAPACITY states, no allocation; a lookup scans back from the
+// newest state, which with a ~100 ms delay is two or three steps.
+class SnapshotTrack {
+public:
+    static const size_t CAPACITY = 16;  // 0.8 s at 20 Hz
+    
+    // Moves larger than this between two snapshots are teleports (respawn): no sliding across the map
+    static constexpr float TELEPORT_DISTANCE = 200.0f;
+    
+    enum class Result { Empty, Interpolated, Extrapolated, Held };
+    
+    // Add the state of a snapshot; ticks not newer than the newest state are ignored
+    void push(uint32_t tick, const EntityState& state) {
+        if (count_ > 0 && tick <= ticks_[newestIndex()]) {
+            return;
+        }
+        const size_t index = (head_ + count_) % CAPACITY;
+        if (count_ == CAPACITY) {
+            head_ = (head_ + 1) % CAPACITY;
+        } else {
+            count_++;
+        }
+        ticks_[index] = tick;
+        states_[index] = state;
+    }
+    
+    Result sample(double renderTick, double maxExtrapolationTicks, EntityState& out) const {
+        if (count_ == 0) {
+            return Result::Empty;
+        }
+        
+        const size_t newest = newestIndex();
+        if (renderTick >= ticks_[newest]) {
+            out = states_[newest];
+            if (count_ < 2) {
+                return Result::Held;
+            }
+            const size_t previous = (newest + CAPACITY - 1) % CAPACITY;
+            const EntityState& from = states_[previous];
+            const double span = static_cast<double>(ticks_[newest] - ticks_[previous]);
+            const double ahead = std::min(renderTick - ticks_[newest], maxExtrapolationTicks);
+            if (ahead <= 0.0 || !from.isAlive || !out.isAlive || isTeleport(from, out)) {
+                return Result::Held;
+            }
+            const float t = static_cast<float>(ahead / span);
+            out.x += (out.x - from.x) * t;
+            out.y += (out.y - from.y) * t;
+            return Result::Extrapolated;
+        }
+        
+        // Newest state at or before the render tick, then blend toward its successor
+        for (size_t back = 1; back < count_; ++back) {
+            const size_t index = (newest + CAPACITY - back) % CAPACITY;
+            if (ticks_[index] > renderTick) {
+                continue;
+            }
+            const size_t next = (index + 1) % CAPACITY;
+            const EntityState& from = states_[index];
+            const EntityState& to = states_[next];
+            out = from;
+            if (isTeleport(from, to)) {
+                return Result::Interpolated;
+            }
+            const float t = static_cast<float>((renderTick - ticks_[index]) / static_cast<double>(ticks_[next] - ticks_[index]));
+            out.x = from.x + (to.x - from.x) * t;
+            out.y = from.y + (to.y - from.y) * t;
+            float turn = std::fmod(to.rotation - from.rotation + 540.0f, 360.0f) - 180.0f;  // Shortest arc
+            out.rotation = from.rotation + turn * t;
+            return Result::Interpolated;
+        }
+        
+        // Older than everything buffered
+        out = states_[head_];
+        return Result::Held;
+    }
+    
+    size_t size() const { return count_; }
+    
+private:
+    size_t newestIndex() const { return (head_ + count_ - 1) % CAPACITY; }
+    
+    static bool isTeleport(const EntityState& from, const EntityState& to) {
+        const float dx = to.x - from.x;
+        const float dy = to.y - from.y;
+        return dx * dx + dy * dy > TELEPORT_DISTANCE * TELEPORT_DISTANCE;
+    }
+    
+    std::array<uint32_t, CAPACITY> ticks_;
+    std::array<EntityState, CAPACITY> states_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+};
+
+// Seconds a remote player keeps moving past its newest snapshot before it is held
+const float MAX_EXTRAPOLATION = 0.1f;
+
+// ========================
+// Helpers
+// ========================
+
+const float TICK_RATE = 60.0f;
+const double TICK = 1.0 / TICK_RATE;
+
+// Ground truth: a player circling at 180 px/s (3 px per 1/60 s, the base speed)
+EntityState truthAt(double serverTime) {
+    const double radius = 400.0;
+    const double angle = serverTime * 180.0 / radius;
+    EntityState state;
+    state.x = static_cast<float>(2550.0 + radius * std::cos(angle));
+    state.y = static_cast<float>(2550.0 + radius * std::sin(angle));
+    state.rotation = static_cast<float>(std::fmod(angle * 180.0 / 3.14159265 + 90.0, 360.0));
+    return state;
+}
+
+// Previous client behaviour: chase the newest snapshot with a frame-rate dependent lerp
+struct LegacyLerp {
+    bool placed = false;
+    EntityState pos;
+    EntityState target;
+    uint32_t newestTick = 0;
+    
+    void onSnapshot(uint32_t tick, const EntityState& state) {
+        if (placed && tick <= newestTick) return;  // Older snapshots were dropped
+        if (!placed) pos = state;
+        placed = true;
+        newestTick = tick;
+        target = state;
+    }
+    
+    void frame(float deltaTime) {
+        float alpha = std::min(1.0f, deltaTime * 15.0f);
+        pos.x += (target.x - pos.x) * alpha;
+        pos.y += (target.y - pos.y) * alpha;
+    }
+};
+
+struct LinkProfile {
+    int snapshotRate = 20;
+    float latency = 0.04f;    // Seconds, one way
+    float jitter = 0.0f;      // Extra delay, uniform in [0, jitter]
+    float loss = 0.0f;        // Probability a snapshot is lost
+};
+
+struct PlaybackStats {
+    size_t frames = 0;
+    size_t interpolated = 0;
+    size_t extrapolated = 0;
+    double speedErrorSq = 0.0;        // Rendered speed vs true 180 px/s
+    double legacySpeedErrorSq = 0.0;
+    float finalDelay = 0.0f;
+    float finalJitter = 0.0f;
+    
+    double speedRms() const { return std::sqrt(speedErrorSq / frames); }
+    double legacySpeedRms() const { return std::sqrt(legacySpeedErrorSq / frames); }
+    double interpolatedShare() const { return 100.0 * interpolated / frames; }
+    double extrapolatedShare() const { return 100.0 * extrapolated / frames; }
+};
+
+// Play `seconds` of the circling player to a client rendering at ~144 fps
+// (frame times vary +-30%); the first two seconds only warm up the estimators
+PlaybackStats playback(const LinkProfile& link, double seconds, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    
+    // Snapshots in arrival order
+    struct Arrival { double time; uint32_t tick; };
+    std::vector<Arrival> arrivals;
+    const uint32_t interval = static_cast<uint32_t>(std::lround(TICK_RATE / link.snapshotRate));
+    const double clientClockOffset = 1000.0;  // Client clock is unrelated to the server's
+    for (uint32_t tick = 10; tick * TICK < seconds + 1.0; tick += interval) {
+        if (unit(rng) < link.loss) continue;
+        arrivals.push_back({ tick * TICK + clientClockOffset + link.latency + link.jitter * unit(rng), tick });
+    }
+    std::sort(arrivals.begin(), arrivals.end(), [](const Arrival& a, const Arrival& b) { return a.time < b.time; });
+    
+    SnapshotClock clock;
+    clock.setTickRate(TICK_RATE);
+    SnapshotTrack track;
+    LegacyLerp legacy;
+    uint32_t newestApplied = 0;
+    
+    PlaybackStats stats;
+    size_t next = 0;
+    double now = clientClockOffset;
+    EntityState previous;
+    EntityState legacyPrevious;
+    bool havePrevious = false;
+    while (now < clientClockOffset + seconds) {
+        const float deltaTime = static_cast<float>((1.0 / 144.0) * (0.7 + 0.6 * unit(rng)));
+        now += deltaTime;
+        
+        // The client applies only snapshots newer than the newest one (see applySnapshotMessage)
+        while (next < arrivals.size() && arrivals[next].time <= now) {
+            const uint32_t tick = arrivals[next].tick;
+            if (newestApplied == 0 || tick > newestApplied) {
+                newestApplied = tick;
+                clock.onSnapshot(tick, static_cast<float>(arrivals[next].time - clientClockOffset));
+                track.push(tick, truthAt(tick * TICK));
+            }
+            legacy.onSnapshot(tick, truthAt(tick * TICK));
+            next++;
+        }
+        if (!clock.synced()) continue;
+        
+        const double renderTick = clock.advance(static_cast<float>(now - clientClockOffset), deltaTime);
+        EntityState rendered;
+        SnapshotTrack::Result result = track.sample(renderTick, MAX_EXTRAPOLATION / clock.tickDuration(), rendered);
+        legacy.frame(deltaTime);
+        
+        if (havePrevious && now - clientClockOffset > 2.0) {
+            const double speed = std::hypot(rendered.x - previous.x, rendered.y - previous.y) / deltaTime;
+            const double legacySpeed = std::hypot(legacy.pos.x - legacyPrevious.x, legacy.pos.y - legacyPrevious.y) / deltaTime;
+            stats.speedErrorSq += (speed - 180.0) * (speed - 180.0);
+            stats.legacySpeedErrorSq += (legacySpeed - 180.0) * (legacySpeed - 180.0);
+            stats.frames++;
+            if (result == SnapshotTrack::Result::Interpolated) stats.interpolated++;
+            if (result == SnapshotTrack::Result::Extrapolated) stats.extrapolated++;
+        }
+        previous = rendered;
+        legacyPrevious = legacy.pos;
+        havePrevious = true;
+    }
+    stats.finalDelay = clock.delay();
+    stats.finalJitter = clock.jitter();
+    return stats;
+}
+
+EntityState at(float x, float y, float rotation = 0.0f) {
+    EntityState state;
+    state.x = x;
+    state.y = y;
+    state.rotation = rotation;
+    return state;
+}
+
+// ========================
+// Tests
+// ========================
+
+TEST(TrackInterpolatesBetweenTicks) {
+    SnapshotTrack track;
+    track.push(30, at(100.0f, 100.0f, 350.0f));
+    track.push(33, at(130.0f, 100.0f, 10.0f));
+    track.push(36, at(130.0f, 160.0f, 20.0f));
+    
+    EntityState out;
+    ASSERT_TRUE(track.sample(31.5, 6.0, out) == SnapshotTrack::Result::Interpolated);
+    ASSERT_NEAR(115.0f, out.x, 0.001f);
+    ASSERT_NEAR(100.0f, out.y, 0.001f);
+    // 350 -> 10 turns through 0, not back through 180
+    ASSERT_NEAR(360.0f, out.rotation, 0.001f);
+    
+    ASSERT_TRUE(track.sample(35.0, 6.0, out) == SnapshotTrack::Result::Interpolated);
+    ASSERT_NEAR(130.0f, out.x, 0.001f);
+    ASSERT_NEAR(140.0f, out.y, 0.001f);
+    
+    // Exactly on a snapshot tick
+    ASSERT_TRUE(track.sample(33.0, 6.0, out) == SnapshotTrack::Result::Interpolated);
+    ASSERT_NEAR(130.0f, out.x, 0.001f);
+    ASSERT_NEAR(100.0f, out.y, 0.001f);
+}
+
+TEST(TrackExtrapolatesThenHolds) {
+    SnapshotTrack track;
+    track.push(30, at(100.0f, 100.0f));
+    track.push(33, at(109.0f, 100.0f));
+    
+    EntityState out;
+    ASSERT_TRUE(track.sample(34.0, 6.0, out) == SnapshotTrack::Result::Extrapolated);
+    ASSERT_NEAR(112.0f, out.x, 0.001f);
+    
+    // Capped at six ticks past the newest snapshot
+    ASSERT_TRUE(track.sample(60.0, 6.0, out) == SnapshotTrack::Result::Extrapolated);
+    ASSERT_NEAR(127.0f, out.x, 0.001f);
+    
+    // No extrapolation allowed: hold the newest state
+    ASSERT_TRUE(track.sample(40.0, 0.0, out) == SnapshotTrack::Result::Held);
+    ASSERT_NEAR(109.0f, out.x, 0.001f);
+    
+    // Before the oldest snapshot: hold the oldest
+    ASSERT_TRUE(track.sample(10.0, 6.0, out) == SnapshotTrack::Result::Held);
+    ASSERT_NEAR(100.0f, out.x, 0.001f);
+    
+    SnapshotTrack empty;
+    ASSERT_TRUE(empty.sample(10.0, 6.0, out) == SnapshotTrack::Result::Empty);
+}
+
+TEST(TrackDoesNotSlideOnTeleport) {
+    SnapshotTrack track;
+    track.push(30, at(100.0f, 100.0f));
+    track.push(33, at(4000.0f, 4000.0f));  // Respawn
+    
+    EntityState out;
+    track.sample(32.0, 6.0, out);
+    ASSERT_NEAR(100.0f, out.x, 0.001f);
+    ASSERT_TRUE(track.sample(35.0, 6.0, out) == SnapshotTrack::Result::Held);
+    ASSERT_NEAR(4000.0f, out.x, 0.001f);
+    
+    // Dead players are not extrapolated either
+    SnapshotTrack dying;
+    dying.push(30, at(100.0f, 100.0f));
+    EntityState dead = at(103.0f, 100.0f);
+    dead.isAlive = false;
+    dying.push(33, dead);
+    ASSERT_TRUE(dying.sample(36.0, 6.0, out) == SnapshotTrack::Result::Held);
+    ASSERT_TRUE(!out.isAlive);
+}
+
+TEST(TrackKeepsNewestInOrder) {
+    SnapshotTrack track;
+    for (uint32_t tick = 0; tick < 100; tick += 3) {
+        track.push(tick, at(static_cast<float>(tick), 0.0f));
+    }
+    ASSERT_EQ(SnapshotTrack::CAPACITY, track.size());
+    
+    // Reordered or repeated snapshots are ignored
+    track.push(90, at(-1.0f, 0.0f));
+    track.push(99, at(-1.0f, 0.0f));
+    EntityState out;
+    ASSERT_TRUE(track.sample(91.5, 6.0, out) == SnapshotTrack::Result::Interpolated);
+    ASSERT_NEAR(91.5f, out.x, 0.001f);
+}
+
+TEST(DelayFollowsSnapshotSpacing) {
+    // Steady 20 Hz snapshots with constant latency
+    SnapshotClock clock;
+    clock.setTickRate(TICK_RATE);
+    for (uint32_t tick = 0; tick < 600; tick += 3) {
+        clock.onSnapshot(tick, static_cast<float>(5.0 + tick * TICK + 0.08));
+    }
+    ASSERT_NEAR(0.0f, clock.jitter(), 0.0005f);
+    ASSERT_NEAR(0.05f + SnapshotClock::SAFETY_MARGIN, clock.targetDelay(), 0.0005f);
+    
+    // Render tick = latest server tick the clock implies minus the delay
+    const float now = static_cast<float>(5.0 + 597 * TICK + 0.08);
+    const double renderTick = clock.advance(now, 0.0f);
+    ASSERT_NEAR(597.0 - clock.delay() * TICK_RATE, renderTick, 0.01);
+}
+
+TEST(DelayAdaptsToJitter) {
+    SnapshotClock clock;
+    clock.setTickRate(TICK_RATE);
+    std::mt19937 rng(4);
+    std::uniform_real_distribution<float> jitter(0.0f, 0.04f);
+    uint32_t tick = 0;
+    double now = 0.0;
+    auto run = [&](float maxJitter, int seconds) {
+        for (int i = 0; i < seconds * 20; ++i, tick += 3) {
+            clock.onSnapshot(tick, static_cast<float>(tick * TICK + 0.05 + maxJitter * jitter(rng) / 0.04f));
+            for (int f = 0; f < 3; ++f) {
+                now += 1.0 / 60.0;
+                clock.advance(static_cast<float>(now), 1.0f / 60.0f);
+            }
+        }
+    };
+    
+    run(0.0f, 5);
+    const float calmDelay = clock.delay();
+    run(0.04f, 10);
+    const float jitteryDelay = clock.delay();
+    ASSERT_TRUE(jitteryDelay > calmDelay + 0.015f);
+    ASSERT_TRUE(jitteryDelay <= SnapshotClock::MAX_DELAY);
+    
+    // A calm link brings the delay back down, slowly
+    run(0.0f, 10);
+    ASSERT_TRUE(clock.delay() < calmDelay + 0.005f);
+}
+
+TEST(DelayMovesGradually) {
+    SnapshotClock clock;
+    clock.setTickRate(TICK_RATE);
+    clock.onSnapshot(0, 0.0f);
+    clock.onSnapshot(3, 0.05f);
+    clock.advance(0.05f, 0.0f);
+    const float before = clock.delay();
+    
+    // One very late snapshot raises the target at once, the delay follows at DELAY_SLEW
+    clock.onSnapshot(6, 0.25f);
+    ASSERT_TRUE(clock.targetDelay() > before + 0.05f);
+    clock.advance(0.26f, 0.01f);
+    ASSERT_NEAR(before + SnapshotClock::DELAY_SLEW * 0.01f, clock.delay(), 0.0001f);
+}
+
+TEST(SmoothMotionUnderJitterAndLoss) {
+    LinkProfile link;
+    link.jitter = 0.03f;
+    link.loss = 0.05f;
+    PlaybackStats stats = playback(link, 30.0, 7);
+    ASSERT_TRUE(stats.interpolatedShare() > 97.0);
+    ASSERT_TRUE(stats.speedRms() < 10.0);
+    ASSERT_TRUE(stats.speedRms() * 5.0 < stats.legacySpeedRms());
+}
+
+TEST(SmoothMotionAtTenHertz) {
+    LinkProfile link;
+    link.snapshotRate = 10;
+    link.jitter = 0.02f;
+    link.loss = 0.02f;
+    PlaybackStats stats = playback(link, 30.0, 8);
+    ASSERT_TRUE(stats.interpolatedShare() > 97.0);
+    ASSERT_TRUE(stats.speedRms() < 10.0);
+    ASSERT_TRUE(stats.finalDelay > 0.1f);
+}
+
+// ========================
+// Benchmark
+// ========================
+
+template <typename F>
+double timeNs(int iterations, F&& body) {
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (int k = 0; k < iterations; k++) body(k);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::nano>(end - begin).count() / iterations;
+}
+
+void benchmarkPlayback() {
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::setw(6) << "Rate" << std::setw(9) << "Jitter" << std::setw(7) << "Loss"
+              << std::setw(11) << "Delay ms" << std::setw(9) << "Interp%" << std::setw(9) << "Extrap%"
+              << std::setw(17) << "Speed err (px/s)" << std::setw(11) << "Old lerp" << std::endl;
+    const int rates[] = { 20, 10 };
+    const float jitters[] = { 0.0f, 0.02f, 0.05f };
+    for (int rate : rates) {
+        for (float jitter : jitters) {
+            LinkProfile link;
+            link.snapshotRate = rate;
+            link.jitter = jitter;
+            link.loss = 0.05f;
+            PlaybackStats stats = playback(link, 30.0, 11);
+            std::cout << std::setw(4) << rate << "Hz" << std::setw(7) << jitter * 1000.0f << "ms"
+                      << std::setw(6) << 5.0f << "%" << std::setw(11) << stats.finalDelay * 1000.0f
+                      << std::setw(9) << stats.interpolatedShare() << std::setw(9) << stats.extrapolatedShare()
+                      << std::setw(17) << stats.speedRms() << std::setw(11) << stats.legacySpeedRms() << std::endl;
+        }
+    }
+    
+    // Per remote player per frame
+    SnapshotTrack track;
+    for (uint32_t tick = 0; tick < 48; tick += 3) track.push(tick, truthAt(tick * TICK));
+    volatile float sink = 0.0f;
+    double ns = timeNs(2000000, [&](int k) {
+        EntityState out;
+        track.sample(38.0 + (k & 7) * 0.1, 6.0, out);
+        sink = sink + out.x;
+    });
+    std::cout << "SnapshotTrack::sample: " << std::setprecision(1) << ns << " ns" << std::endl;
+}
+
+// ========================
+// Main Test Runner
+// ========================
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Zero Ground Snapshot Interpolation Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "--- Snapshot Interpolation Tests ---" << std::endl;
+    RUN_TEST(TrackInterpolatesBetweenTicks);
+    RUN_TEST(TrackExtrapolatesThenHolds);
+    RUN_TEST(TrackDoesNotSlideOnTeleport);
+    RUN_TEST(TrackKeepsNewestInOrder);
+    RUN_TEST(DelayFollowsSnapshotSpacing);
+    RUN_TEST(DelayAdaptsToJitter);
+    RUN_TEST(DelayMovesGradually);
+    RUN_TEST(SmoothMotionUnderJitterAndLoss);
+    RUN_TEST(SmoothMotionAtTenHertz);
+
+    std::cout << std::endl;
+    std::cout << "--- Rendered Motion (buffered interpolation vs old lerp) ---" << std::endl;
+    benchmarkPlayback();
+
+    // Print summary
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Test Summary" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Total tests: " << totalTests << std::endl;
+    std::cout << "Passed: " << passedTests << std::endl;
+    std::cout << "Failed: " << failedTests << std::endl;
+    std::cout << std::endl;
+
+    if (failedTests == 0) {
+        std::cout << "✓ All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "✗ Some tests failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,591 @@
+// Swept Collision Tests for Zero Ground
+// Deterministic regression tests for continuous bullet-vs-player hits at low
+// tick rates. The per-bullet resolution step mirrors updateServerSimulation():
+// wall traversal and swept-circle player tests both return a time of impact
+// and the earliest event wins.
+//
+// Bullet::sweptCircleHit and Bullet::traceCellWallsDDA are copied from
+// Zero_Ground.cpp. Build with /O2 (or -O2).
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <random>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <cstdint>
+
+// ========================
+// Test Framework Macros
+// ========================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "Running test: " << #name << "..."; \
+    try { \
+        test_##name(); \
+        std::cout << " PASSED" << std::endl; \
+        passedTests++; \
+    } catch (const std::exception& e) { \
+        std::cout << " FAILED: " << e.what() << std::endl; \
+        failedTests++; \
+    } \
+    totalTests++; \
+} while(0)
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: " << #condition << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_NEAR(expected, actual, epsilon) do { \
+    if (std::abs((expected) - (actual)) > (epsilon)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << (expected) << " but got " << (actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(expected, actual) do { \
+    if ((expected) != (actual)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << static_cast<int>(expected) << " but got " << static_cast<int>(actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+// Test counters
+int totalTests = 0;
+int passedTests = 0;
+int failedTests = 0;
+
+// ========================
+// Structures (copied from main code)
+// ========================
+
+const float CELL_SIZE = 100.0f;
+const int GRID_SIZE = 51;
+const float WALL_WIDTH = 12.0f;
+const float WALL_LENGTH = 100.0f;
+const float PLAYER_HIT_RADIUS = 15.0f;
+
+enum class WallType : uint8_t {
+    None = 0,
+    Concrete = 1,
+    Wood = 2
+};
+
+struct Cell {
+    WallType topWall = WallType::None;
+    WallType rightWall = WallType::None;
+    WallType bottomWall = WallType::None;
+    WallType leftWall = WallType::None;
+};
+
+struct WallHit {
+    WallType type = WallType::None;
+    float t = 1.0f;
+};
+
+typedef std::vector<std::vector<Cell>> Grid;
+
+struct Bullet {
+    // Slab test: does the segment (x1, y1) + t * (dx, dy), t in [0, 1], touch the rectangle?
+    // On success tEntry is the first t inside the rectangle (0 if the segment starts inside)
+    static bool segmentEntersRect(float x1, float y1, float dx, float dy,
+                                  float rectX, float rectY, float rectW, float rectH,
+                                  float& tEntry) {
+        float tMin = 0.0f;
+        float tMax = 1.0f;
+        
+        const float origin[2] = { x1, y1 };
+        const float dir[2] = { dx, dy };
+        const float lo[2] = { rectX, rectY };
+        const float hi[2] = { rectX + rectW, rectY + rectH };
+        
+        for (int axis = 0; axis < 2; ++axis) {
+            if (dir[axis] == 0.0f) {
+                // Parallel to this slab: must already be inside it
+                if (origin[axis] < lo[axis] || origin[axis] > hi[axis]) return false;
+                continue;
+            }
+            float t1 = (lo[axis] - origin[axis]) / dir[axis];
+            float t2 = (hi[axis] - origin[axis]) / dir[axis];
+            if (t1 > t2) std::swap(t1, t2);
+            tMin = std::max(tMin, t1);
+            tMax = std::min(tMax, t2);
+            if (tMin > tMax) return false;
+        }
+        
+        tEntry = tMin;
+        return true;
+    }
+    
+    // Amanda-Woo grid traversal: walk only the cells the segment (x1, y1) -> (x2, y2)
+    // actually crosses and return the wall it enters first, with its entry parameter t.
+    //
+    // ALGORITHM:
+    // - Start in the cell containing (x1, y1); tMaxX/tMaxY are the t values at which
+    //   the segment crosses the next vertical/horizontal cell boundary, tDeltaX/tDeltaY
+    //   the t needed to cross a whole cell. Always step across the nearer boundary.
+    // - Walls are centered on cell boundaries and stick WALL_WIDTH/2 into both cells,
+    //   so each visited cell tests the walls on its four boundaries, whichever side
+    //   of the boundary (this cell or the neighbour) owns them.
+    // - Every wall touching a later cell is entered at t >= the current cell's exit t,
+    //   so the walk stops as soon as the best hit lies inside the current cell.
+    //
+    // PERFORMANCE: visits |dCellX| + |dCellY| + 1 cells (usually 1-2 per tick at
+    // bullet speeds) instead of the (dCellX + 3) * (dCellY + 3) bounding box scanned
+    // before, and only runs the slab test on walls that exist.
+    static WallHit traceCellWallsDDA(const std::vector<std::vector<Cell>>& grid,
+                                     float x1, float y1, float x2, float y2) {
+        WallHit best;
+        const float dx = x2 - x1;
+        const float dy = y2 - y1;
+        
+        // Wall owned by cell (i, j) on the given side, None outside the grid
+        auto wallAt = [&grid](int i, int j, int side) -> WallType {
+            if (i < 0 || i >= GRID_SIZE || j < 0 || j >= GRID_SIZE) return WallType::None;
+            const Cell& cell = grid[i][j];
+            switch (side) {
+                case 0: return cell.topWall;
+                case 1: return cell.rightWall;
+                case 2: return cell.bottomWall;
+                default: return cell.leftWall;
+            }
+        };
+        
+        auto testWall = [&](WallType type, float rectX, float rectY, float rectW, float rectH) {
+            if (type == WallType::None) return;
+            float t;
+            if (segmentEntersRect(x1, y1, dx, dy, rectX, rectY, rectW, rectH, t) &&
+                (best.type == WallType::None || t < best.t)) {
+                best.type = type;
+                best.t = t;
+            }
+        };
+        
+        // Test the walls on all four boundaries of cell (i, j)
+        auto testCellBoundaries = [&](int i, int j) {
+            const float cellWorldX = i * CELL_SIZE;
+            const float cellWorldY = j * CELL_SIZE;
+            const float half = WALL_WIDTH / 2.0f;
+            
+            // Top boundary: this cell's top wall or the upper neighbour's bottom wall
+            testWall(wallAt(i, j, 0), cellWorldX, cellWorldY - half, WALL_LENGTH, WALL_WIDTH);
+            testWall(wallAt(i, j - 1, 2), cellWorldX, cellWorldY - half, WALL_LENGTH, WALL_WIDTH);
+            // Right boundary
+            testWall(wallAt(i, j, 1), cellWorldX + CELL_SIZE - half, cellWorldY, WALL_WIDTH, WALL_LENGTH);
+            testWall(wallAt(i + 1, j, 3), cellWorldX + CELL_SIZE - half, cellWorldY, WALL_WIDTH, WALL_LENGTH);
+            // Bottom boundary
+            testWall(wallAt(i, j, 2), cellWorldX, cellWorldY + CELL_SIZE - half, WALL_LENGTH, WALL_WIDTH);
+            testWall(wallAt(i, j + 1, 0), cellWorldX, cellWorldY + CELL_SIZE - half, WALL_LENGTH, WALL_WIDTH);
+            // Left boundary
+            testWall(wallAt(i, j, 3), cellWorldX - half, cellWorldY, WALL_WIDTH, WALL_LENGTH);
+            testWall(wallAt(i - 1, j, 1), cellWorldX - half, cellWorldY, WALL_WIDTH, WALL_LENGTH);
+        };
+        
+        int cellX = static_cast<int>(std::floor(x1 / CELL_SIZE));
+        int cellY = static_cast<int>(std::floor(y1 / CELL_SIZE));
+        const int endCellX = static_cast<int>(std::floor(x2 / CELL_SIZE));
+        const int endCellY = static_cast<int>(std::floor(y2 / CELL_SIZE));
+        
+        const int stepX = (dx > 0.0f) ? 1 : (dx < 0.0f ? -1 : 0);
+        const int stepY = (dy > 0.0f) ? 1 : (dy < 0.0f ? -1 : 0);
+        const float inf = std::numeric_limits<float>::infinity();
+        
+        float tMaxX = inf, tDeltaX = inf;
+        if (stepX != 0) {
+            float boundaryX = (cellX + (stepX > 0 ? 1 : 0)) * CELL_SIZE;
+            tMaxX = (boundaryX - x1) / dx;
+            tDeltaX = CELL_SIZE / std::abs(dx);
+        }
+        float tMaxY = inf, tDeltaY = inf;
+        if (stepY != 0) {
+            float boundaryY = (cellY + (stepY > 0 ? 1 : 0)) * CELL_SIZE;
+            tMaxY = (boundaryY - y1) / dy;
+            tDeltaY = CELL_SIZE / std::abs(dy);
+        }
+        
+        // Exact number of boundary crossings; also bounds the loop against rounding
+        int remainingSteps = std::abs(endCellX - cellX) + std::abs(endCellY - cellY);
+        
+        while (true) {
+            testCellBoundaries(cellX, cellY);
+            
+            const float tExit = std::min(tMaxX, tMaxY);
+            if (best.type != WallType::None && best.t <= tExit) break;
+            if (remainingSteps-- <= 0) break;
+            
+            if (tMaxX < tMaxY) {
+                cellX += stepX;
+                tMaxX += tDeltaX;
+            } else {
+                cellY += stepY;
+                tMaxY += tDeltaY;
+            }
+        }
+        
+        return best;
+    }
+    
+    // Continuous bullet-vs-player test over one simulation step.
+    // The bullet moves (bx0, by0) -> (bx1, by1) while the player's center moves
+    // (cx0, cy0) -> (cx1, cy1) over the same step. Returns true if the bullet comes
+    // within radius of the center, with toi the time of impact in [0, 1].
+    //
+    // ALGORITHM:
+    // Work in the player's frame: the relative position is d + t * m with
+    // d = bullet0 - center0 and m = bulletMotion - playerMotion. Solve
+    // |d + t * m|^2 = radius^2 for the smaller root; starting inside gives toi = 0.
+    //
+    // Unlike checkPlayerCollision (end position only) this cannot tunnel: a
+    // 900 px/s bullet moves 90 px per tick at 10 Hz, six times the 15 px radius.
+    static bool sweptCircleHit(float bx0, float by0, float bx1, float by1,
+                               float cx0, float cy0, float cx1, float cy1,
+                               float radius, float& toi) {
+        const float dx = bx0 - cx0;
+        const float dy = by0 - cy0;
+        const float c = dx * dx + dy * dy - radius * radius;
+        if (c <= 0.0f) {
+            toi = 0.0f;  // Already overlapping at the start of the step
+            return true;
+        }
+        
+        const float mx = (bx1 - bx0) - (cx1 - cx0);
+        const float my = (by1 - by0) - (cy1 - cy0);
+        const float a = mx * mx + my * my;
+        const float b = mx * dx + my * dy;  // Half of the usual b
+        if (a <= 0.0f || b >= 0.0f) return false;  // Not moving closer
+        
+        const float discriminant = b * b - a * c;
+        if (discriminant < 0.0f) return false;  // Closest approach stays outside
+        
+        const float t = (-b - std::sqrt(discriminant)) / a;
+        if (t > 1.0f) return false;  // Reaches the player after this step
+        
+        toi = t;
+        return true;
+    }
+};
+
+// ========================
+// Simulation Step (mirrors the bullet loop in updateServerSimulation)
+// ========================
+
+struct SimPlayer {
+    uint32_t id = 0;
+    float x = 0.0f, y = 0.0f;
+    float previousX = 0.0f, previousY = 0.0f;
+    float vx = 0.0f, vy = 0.0f;  // Constant velocity for the test
+    bool isAlive = true;
+    int hitsTaken = 0;
+};
+
+struct SimBullet {
+    uint8_t ownerId = 0;
+    float x = 0.0f, y = 0.0f;
+    float prevX = 0.0f, prevY = 0.0f;
+    float vx = 0.0f, vy = 0.0f;
+    float range = 10000.0f;
+    uint32_t victimId = 0;  // Set when the bullet hits a player
+};
+
+enum class HitMode { Swept, EndPoint };
+
+// Advance players and bullets by one tick and resolve hits
+void simulateTick(float dt, std::map<uint32_t, SimPlayer>& players, std::vector<SimBullet>& bullets,
+                  const Grid& grid, HitMode mode) {
+    for (auto& pair : players) {
+        SimPlayer& p = pair.second;
+        p.previousX = p.x;
+        p.previousY = p.y;
+        p.x += p.vx * dt;
+        p.y += p.vy * dt;
+    }
+
+    for (SimBullet& b : bullets) {
+        if (b.range <= 0.0f) continue;
+        b.prevX = b.x;
+        b.prevY = b.y;
+        b.x += b.vx * dt;
+        b.y += b.vy * dt;
+
+        WallHit wallHit = Bullet::traceCellWallsDDA(grid, b.prevX, b.prevY, b.x, b.y);
+
+        SimPlayer* victim = nullptr;
+        float victimToi = 1.0f;
+        for (auto& pair : players) {
+            SimPlayer& player = pair.second;
+            if (player.id == b.ownerId || !player.isAlive) continue;
+
+            float toi = 1.0f;
+            bool hit;
+            if (mode == HitMode::Swept) {
+                hit = Bullet::sweptCircleHit(b.prevX, b.prevY, b.x, b.y,
+                                             player.previousX, player.previousY, player.x, player.y,
+                                             PLAYER_HIT_RADIUS, toi);
+            } else {
+                // Previous point-in-circle test at the end position
+                float dx = b.x - player.x;
+                float dy = b.y - player.y;
+                hit = dx * dx + dy * dy <= PLAYER_HIT_RADIUS * PLAYER_HIT_RADIUS;
+            }
+            if (hit && (victim == nullptr || toi < victimToi)) {
+                victim = &player;
+                victimToi = toi;
+            }
+        }
+
+        if (victim != nullptr && (wallHit.type != WallType::Concrete || victimToi <= wallHit.t)) {
+            victim->hitsTaken++;
+            b.victimId = victim->id;
+            b.range = 0.0f;
+        } else if (wallHit.type == WallType::Concrete) {
+            b.range = 0.0f;
+        }
+    }
+}
+
+// Fire one bullet from the owner at (x, y) with velocity (vx, vy) and run for the given time
+std::map<uint32_t, SimPlayer> runScenario(int tickRate, std::map<uint32_t, SimPlayer> players,
+                                          float x, float y, float vx, float vy, float seconds,
+                                          const Grid& grid, HitMode mode, uint32_t* victimId = nullptr) {
+    std::vector<SimBullet> bullets(1);
+    bullets[0].ownerId = 0;
+    bullets[0].x = bullets[0].prevX = x;
+    bullets[0].y = bullets[0].prevY = y;
+    bullets[0].vx = vx;
+    bullets[0].vy = vy;
+
+    const float dt = 1.0f / tickRate;
+    const int ticks = static_cast<int>(std::ceil(seconds * tickRate));
+    for (int tick = 0; tick < ticks; ++tick) {
+        simulateTick(dt, players, bullets, grid, mode);
+    }
+    if (victimId) *victimId = bullets[0].victimId;
+    return players;
+}
+
+SimPlayer makePlayer(uint32_t id, float x, float y, float vx = 0.0f, float vy = 0.0f) {
+    SimPlayer p;
+    p.id = id;
+    p.x = p.previousX = x;
+    p.y = p.previousY = y;
+    p.vx = vx;
+    p.vy = vy;
+    return p;
+}
+
+Grid emptyGrid() {
+    return Grid(GRID_SIZE, std::vector<Cell>(GRID_SIZE));
+}
+
+// ========================
+// Tests
+// ========================
+
+// Stationary target, 900 px/s rifle bullet: 90 px per tick at 10 Hz
+TEST(NoTunnelingAtLowTickRates) {
+    Grid grid = emptyGrid();
+    for (int rate : { 10, 20, 30, 60, 120 }) {
+        std::map<uint32_t, SimPlayer> players;
+        players[0] = makePlayer(0, 1000.0f, 1000.0f);
+        players[1] = makePlayer(1, 1500.0f, 1004.0f);
+        auto result = runScenario(rate, players, 1000.0f, 1000.0f, 900.0f, 0.0f, 1.0f, grid, HitMode::Swept);
+        ASSERT_TRUE(result[1].hitsTaken == 1);
+    }
+}
+
+// Documents the bug being fixed: the end-position test misses the same shot at 10 Hz
+TEST(EndPointTestTunnelsAtTenHz) {
+    Grid grid = emptyGrid();
+    std::map<uint32_t, SimPlayer> players;
+    players[0] = makePlayer(0, 1000.0f, 1000.0f);
+    players[1] = makePlayer(1, 1500.0f, 1004.0f);
+    auto result = runScenario(10, players, 1000.0f, 1000.0f, 900.0f, 0.0f, 1.0f, grid, HitMode::EndPoint);
+    ASSERT_TRUE(result[1].hitsTaken == 0);
+}
+
+// Sniper bullets (4000 px/s) move 66 px per tick even at 60 Hz
+TEST(FastBulletHitsAtSixtyHz) {
+    Grid grid = emptyGrid();
+    std::map<uint32_t, SimPlayer> players;
+    players[0] = makePlayer(0, 500.0f, 500.0f);
+    players[1] = makePlayer(1, 1530.0f, 510.0f);
+    auto swept = runScenario(60, players, 500.0f, 500.0f, 4000.0f, 0.0f, 0.5f, grid, HitMode::Swept);
+    ASSERT_TRUE(swept[1].hitsTaken == 1);
+}
+
+// Target running across the line of fire
+TEST(MovingTargetCrossingPath) {
+    Grid grid = emptyGrid();
+    for (int rate : { 10, 20, 60 }) {
+        std::map<uint32_t, SimPlayer> players;
+        players[0] = makePlayer(0, 1000.0f, 2000.0f);
+        // Crosses y = 2000 at x = 1450 after 0.5 s, when the bullet gets there
+        players[1] = makePlayer(1, 1450.0f, 1900.0f, 0.0f, 200.0f);
+        auto result = runScenario(rate, players, 1000.0f, 2000.0f, 900.0f, 0.0f, 1.0f, grid, HitMode::Swept);
+        ASSERT_TRUE(result[1].hitsTaken == 1);
+    }
+}
+
+// A bullet passing just outside the radius never hits
+TEST(NearMissDoesNotHit) {
+    Grid grid = emptyGrid();
+    for (int rate : { 10, 20, 60 }) {
+        std::map<uint32_t, SimPlayer> players;
+        players[0] = makePlayer(0, 1000.0f, 1000.0f);
+        players[1] = makePlayer(1, 1400.0f, 1015.5f);
+        auto result = runScenario(rate, players, 1000.0f, 1000.0f, 900.0f, 0.0f, 1.0f, grid, HitMode::Swept);
+        ASSERT_TRUE(result[1].hitsTaken == 0);
+    }
+}
+
+// Two targets inside the same 10 Hz step: the nearer one is hit
+TEST(EarliestPlayerWins) {
+    Grid grid = emptyGrid();
+    std::map<uint32_t, SimPlayer> players;
+    players[0] = makePlayer(0, 1000.0f, 1000.0f);
+    players[1] = makePlayer(1, 1170.0f, 1000.0f);  // Farther, lower id
+    players[2] = makePlayer(2, 1120.0f, 1000.0f);
+    uint32_t victimId = 0;
+    auto result = runScenario(10, players, 1000.0f, 1000.0f, 900.0f, 0.0f, 0.2f, grid, HitMode::Swept, &victimId);
+    ASSERT_TRUE(victimId == 2);
+    ASSERT_TRUE(result[1].hitsTaken == 0);
+    ASSERT_TRUE(result[2].hitsTaken == 1);
+}
+
+// Concrete wall between shooter and target inside one step blocks the shot
+TEST(ConcreteWallBeforePlayerBlocks) {
+    Grid grid = emptyGrid();
+    grid[10][10].rightWall = WallType::Concrete;  // Wall at x = 1094..1106
+    std::map<uint32_t, SimPlayer> players;
+    players[0] = makePlayer(0, 1050.0f, 1050.0f);
+    players[1] = makePlayer(1, 1125.0f, 1050.0f);  // Just behind the wall
+    auto result = runScenario(10, players, 1050.0f, 1050.0f, 900.0f, 0.0f, 0.5f, grid, HitMode::Swept);
+    ASSERT_TRUE(result[1].hitsTaken == 0);
+}
+
+// Target in front of a concrete wall in the same step is hit
+TEST(PlayerBeforeConcreteWallIsHit) {
+    Grid grid = emptyGrid();
+    grid[10][10].rightWall = WallType::Concrete;
+    std::map<uint32_t, SimPlayer> players;
+    players[0] = makePlayer(0, 1000.0f, 1050.0f);
+    players[1] = makePlayer(1, 1070.0f, 1050.0f);  // In front of the wall
+    auto result = runScenario(10, players, 1000.0f, 1050.0f, 900.0f, 0.0f, 0.5f, grid, HitMode::Swept);
+    ASSERT_TRUE(result[1].hitsTaken == 1);
+}
+
+// Wooden walls slow bullets but do not stop them
+TEST(WoodWallDoesNotBlock) {
+    Grid grid = emptyGrid();
+    grid[10][10].rightWall = WallType::Wood;
+    std::map<uint32_t, SimPlayer> players;
+    players[0] = makePlayer(0, 1050.0f, 1050.0f);
+    players[1] = makePlayer(1, 1125.0f, 1050.0f);
+    auto result = runScenario(10, players, 1050.0f, 1050.0f, 900.0f, 0.0f, 0.5f, grid, HitMode::Swept);
+    ASSERT_TRUE(result[1].hitsTaken == 1);
+}
+
+TEST(TimeOfImpact) {
+    float toi = -1.0f;
+    // Head-on: bullet 0 -> 100 on x, player at 50: touches at x = 35
+    ASSERT_TRUE(Bullet::sweptCircleHit(0.0f, 0.0f, 100.0f, 0.0f, 50.0f, 0.0f, 50.0f, 0.0f, 15.0f, toi));
+    ASSERT_NEAR(0.35f, toi, 1e-5f);
+    // Player walking into the bullet halves the closing distance
+    ASSERT_TRUE(Bullet::sweptCircleHit(0.0f, 0.0f, 100.0f, 0.0f, 115.0f, 0.0f, 15.0f, 0.0f, 15.0f, toi));
+    ASSERT_NEAR(0.5f, toi, 1e-5f);
+    // Starting inside
+    ASSERT_TRUE(Bullet::sweptCircleHit(5.0f, 0.0f, 100.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 15.0f, toi));
+    ASSERT_NEAR(0.0f, toi, 1e-6f);
+    // Moving away, out of reach, and moving in lockstep
+    ASSERT_TRUE(!Bullet::sweptCircleHit(20.0f, 0.0f, 100.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 15.0f, toi));
+    ASSERT_TRUE(!Bullet::sweptCircleHit(0.0f, 0.0f, 10.0f, 0.0f, 50.0f, 0.0f, 50.0f, 0.0f, 15.0f, toi));
+    ASSERT_TRUE(!Bullet::sweptCircleHit(0.0f, 0.0f, 10.0f, 0.0f, 50.0f, 0.0f, 60.0f, 0.0f, 15.0f, toi));
+}
+
+// Random deterministic cases against a finely sub-stepped reference
+TEST(MatchesSubsteppedReference) {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> pos(-150.0f, 150.0f);
+    const int SUBSTEPS = 4000;
+    int hits = 0;
+    for (int n = 0; n < 20000; ++n) {
+        float bx0 = pos(gen), by0 = pos(gen), bx1 = pos(gen), by1 = pos(gen);
+        float cx0 = pos(gen) * 0.3f, cy0 = pos(gen) * 0.3f;
+        float cx1 = cx0 + pos(gen) * 0.1f, cy1 = cy0 + pos(gen) * 0.1f;
+
+        float toi = 1.0f;
+        bool swept = Bullet::sweptCircleHit(bx0, by0, bx1, by1, cx0, cy0, cx1, cy1, PLAYER_HIT_RADIUS, toi);
+
+        float refToi = -1.0f;
+        float closestSq = std::numeric_limits<float>::max();
+        for (int s = 0; s <= SUBSTEPS; ++s) {
+            float t = static_cast<float>(s) / SUBSTEPS;
+            float dx = (bx0 + (bx1 - bx0) * t) - (cx0 + (cx1 - cx0) * t);
+            float dy = (by0 + (by1 - by0) * t) - (cy0 + (cy1 - cy0) * t);
+            float distSq = dx * dx + dy * dy;
+            closestSq = std::min(closestSq, distSq);
+            if (refToi < 0.0f && distSq <= PLAYER_HIT_RADIUS * PLAYER_HIT_RADIUS) refToi = t;
+        }
+
+        // Skip grazing cases the sampling cannot resolve
+        float closest = std::sqrt(closestSq);
+        if (std::abs(closest - PLAYER_HIT_RADIUS) < 0.05f) continue;
+
+        ASSERT_TRUE(swept == (refToi >= 0.0f));
+        if (swept) {
+            ASSERT_NEAR(refToi, toi, 2.0f / SUBSTEPS);
+            hits++;
+        }
+    }
+    ASSERT_TRUE(hits > 100);
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Zero Ground Swept Collision Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "--- Swept Collision Tests ---" << std::endl;
+    RUN_TEST(NoTunnelingAtLowTickRates);
+    RUN_TEST(EndPointTestTunnelsAtTenHz);
+    RUN_TEST(FastBulletHitsAtSixtyHz);
+    RUN_TEST(MovingTargetCrossingPath);
+    RUN_TEST(NearMissDoesNotHit);
+    RUN_TEST(EarliestPlayerWins);
+    RUN_TEST(ConcreteWallBeforePlayerBlocks);
+    RUN_TEST(PlayerBeforeConcreteWallIsHit);
+    RUN_TEST(WoodWallDoesNotBlock);
+    RUN_TEST(TimeOfImpact);
+    RUN_TEST(MatchesSubsteppedReference);
+
+    // Print summary
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Test Summary" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Total tests: " << totalTests << std::endl;
+    std::cout << "Passed: " << passedTests << std::endl;
+    std::cout << "Failed: " << failedTests << std::endl;
+    std::cout << std::endl;
+
+    if (failedTests == 0) {
+        std::cout << "✓ All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "✗ Some tests failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,477 @@
+// Tick Scheduler Tests and Benchmark for Zero Ground
+// Checks the fixed-timestep scheduler that drives the server simulation: one
+// tick per deadline on time, absolute deadlines that don't drift, catching up
+// on ticks that are due after a slow tick, the MAX_CATCH_UP_TICKS cap with the
+// skipped ticks counted and the schedule rebased, overrun reporting, and the
+// snapshot interval that keeps snapshots at the snapshot rate for any tick
+// rate. The tests run on a simulated clock; the benchmark runs the scheduler on
+// the real clock and reports how late ticks start at 20-128 Hz.
+//
+// SFML's clock, time and sleep are replaced by stand-ins.
+// Code under test is copied from Zero_Ground.cpp. Build with /O2 (or -O2).
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+
+// ========================
+// Test Framework Macros
+// ========================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "Running test: " << #name << "..."; \
+    try { \
+        test_##name(); \
+        std::cout << " PASSED" << std::endl; \
+        passedTests++; \
+    } catch (const std::exception& e) { \
+        std::cout << " FAILED: " << e.what() << std::endl; \
+        failedTests++; \
+    } \
+    totalTests++; \
+} while(0)
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: " << #condition << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_NEAR(expected, actual, epsilon) do { \
+    if (std::abs((expected) - (actual)) > (epsilon)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << (expected) << " but got " << (actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(expected, actual) do { \
+    if ((expected) != (actual)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << static_cast<int>(expected) << " but got " << static_cast<int>(actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+// Test counters
+int totalTests = 0;
+int passedTests = 0;
+int failedTests = 0;
+
+
+// ========================
+// Simulated Clock
+// ========================
+
+// With realTime off every clock reads simMicros, which only the tests and
+// sf::sleep advance - plus CLOCK_READ_MICROS per read, so spin loops finish
+bool realTime = false;
+int64_t simMicros = 0;
+const int64_t CLOCK_READ_MICROS = 1;
+
+// Minimal stand-ins for the SFML types the scheduler uses
+namespace sf {
+class Time {
+public:
+    Time() {}
+    float asSeconds() const { return micros_ / 1000000.0f; }
+    int64_t asMicroseconds() const { return micros_; }
+    static Time fromMicros(int64_t micros) { Time t; t.micros_ = micros; return t; }
+    static const Time Zero;
+    
+    Time operator+(Time other) const { return fromMicros(micros_ + other.micros_); }
+    Time operator-(Time other) const { return fromMicros(micros_ - other.micros_); }
+    Time operator*(float factor) const { return fromMicros(static_cast<int64_t>(micros_ * factor)); }
+    Time& operator+=(Time other) { micros_ += other.micros_; return *this; }
+    bool operator<(Time other) const { return micros_ < other.micros_; }
+    bool operator>(Time other) const { return micros_ > other.micros_; }
+private:
+    int64_t micros_ = 0;
+};
+const Time Time::Zero;
+
+inline Time microseconds(int64_t amount) { return Time::fromMicros(amount); }
+inline Time milliseconds(int32_t amount) { return Time::fromMicros(static_cast<int64_t>(amount) * 1000); }
+
+inline int64_t nowMicros() {
+    if (realTime) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    simMicros += CLOCK_READ_MICROS;
+    return simMicros;
+}
+
+class Clock {
+public:
+    Clock() : start_(nowMicros()) {}
+    Time getElapsedTime() const { return Time::fromMicros(nowMicros() - start_); }
+private:
+    int64_t start_;
+};
+
+inline void sleep(Time duration) {
+    if (realTime) {
+        std::this_thread::sleep_for(std::chrono::microseconds(duration.asMicroseconds()));
+    } else {
+        simMicros += duration.asMicroseconds();
+    }
+}
+}
+
+// ========================
+// Code Under Test (copied from Zero_Ground.cpp)
+// ========================
+
+// Drives the authoritative simulation at a constant tick rate
+//
+// ALGORITHM:
+// 1. Every tick has an absolute deadline: start + tickNumber * tickPeriod
+//    (deadlines never drift, unlike sleeping a fixed amount after each tick)
+// 2. waitForNextTick() sleeps until SPIN_THRESHOLD before the deadline, then
+//    yields in a short spin loop - sf::sleep() on Windows has ~1-2ms granularity,
+//    so sleeping the whole interval would make 128 Hz ticks jitter by 15-25%
+// 3. If the simulation fell behind, the due ticks are returned so the caller
+//    can catch up, up to MAX_CATCH_UP_TICKS per wakeup. Anything beyond that is
+//    counted as skipped and the schedule is rebased to "now" (no spiral of death)
+//
+// PERFORMANCE:
+// - Idle CPU: ~SPIN_THRESHOLD / tickPeriod of one core (about 12% at 60 Hz)
+// - Every tick advances the world by exactly getTickDelta() seconds
+class TickScheduler {
+public:
+    static const int MAX_CATCH_UP_TICKS = 5;
+    
+    explicit TickScheduler(int tickRate)
+        : tickRate_(tickRate),
+          tickPeriod_(sf::microseconds(1000000 / tickRate)),
+          nextTickTime_(sf::Time::Zero),
+          tickNumber_(0),
+          skippedTicks_(0) {}
+    
+    // Block until at least one tick is due
+    // Returns: number of ticks to run now (1..MAX_CATCH_UP_TICKS)
+    int waitForNextTick() {
+        const sf::Time SPIN_THRESHOLD = sf::milliseconds(2);
+        
+        sf::Time now = clock_.getElapsedTime();
+        if (now < nextTickTime_) {
+            sf::Time remaining = nextTickTime_ - now;
+            if (remaining > SPIN_THRESHOLD) {
+                sf::sleep(remaining - SPIN_THRESHOLD);
+            }
+            while (clock_.getElapsedTime() < nextTickTime_) {
+                std::this_thread::yield();
+            }
+            now = clock_.getElapsedTime();
+        }
+        
+        // Count every deadline that has passed
+        int dueTicks = static_cast<int>((now - nextTickTime_).asMicroseconds() / tickPeriod_.asMicroseconds()) + 1;
+        
+        if (dueTicks > MAX_CATCH_UP_TICKS) {
+            skippedTicks_ += dueTicks - MAX_CATCH_UP_TICKS;
+            dueTicks = MAX_CATCH_UP_TICKS;
+            // Rebase: the next deadline is one period after the ticks we do run
+            nextTickTime_ = now - tickPeriod_ * static_cast<float>(MAX_CATCH_UP_TICKS - 1);
+        }
+        
+        return dueTicks;
+    }
+    
+    // Mark the start of a tick (call once per due tick)
+    void beginTick() {
+        tickStart_ = clock_.getElapsedTime();
+    }
+    
+    // Mark the end of a tick and advance the schedule
+    // Returns: true if the tick took longer than its budget (overrun)
+    bool endTick() {
+        lastTickCost_ = clock_.getElapsedTime() - tickStart_;
+        nextTickTime_ += tickPeriod_;
+        tickNumber_++;
+        return lastTickCost_ > tickPeriod_;
+    }
+    
+    // Take the number of ticks skipped since the last call
+    int takeSkippedTicks() {
+        int skipped = skippedTicks_;
+        skippedTicks_ = 0;
+        return skipped;
+    }
+    
+    float getTickDelta() const { return tickPeriod_.asSeconds(); }
+    int getTickRate() const { return tickRate_; }
+    uint32_t getTickNumber() const { return tickNumber_; }
+    sf::Time getLastTickCost() const { return lastTickCost_; }
+
+private:
+    sf::Clock clock_;
+    int tickRate_;
+    sf::Time tickPeriod_;
+    sf::Time nextTickTime_;
+    sf::Time tickStart_;
+    sf::Time lastTickCost_;
+    uint32_t tickNumber_;
+    int skippedTicks_;
+};
+
+// Ticks between snapshots, so snapshots go out at about snapshotRate whatever
+// the tick rate (bandwidth does not grow with it)
+// Returns: at least 1 - below the snapshot rate every tick sends one
+inline uint32_t snapshotIntervalTicks(int tickRate, int snapshotRate) {
+    return static_cast<uint32_t>(
+        std::max(1, static_cast<int>(std::lround(tickRate / static_cast<float>(snapshotRate)))));
+}
+
+// ========================
+// Test Helpers
+// ========================
+
+const int64_t PERIOD_60HZ = 1000000 / 60;
+
+// Start a test on a fresh simulated clock
+void resetClock() {
+    realTime = false;
+    simMicros = 0;
+}
+
+// Run one due tick the way simulationLoop does, taking costMicros
+// Returns: endTick()'s overrun flag
+bool runTick(TickScheduler& scheduler, int64_t costMicros) {
+    scheduler.beginTick();
+    simMicros += costMicros;
+    return scheduler.endTick();
+}
+
+// ========================
+// Tick Scheduler Tests
+// ========================
+
+TEST(TickDeltaMatchesRate) {
+    resetClock();
+    TickScheduler at60(60);
+    TickScheduler at128(128);
+    
+    ASSERT_EQ(60, at60.getTickRate());
+    ASSERT_NEAR(1.0f / 60.0f, at60.getTickDelta(), 1e-6f);
+    ASSERT_EQ(128, at128.getTickRate());
+    ASSERT_NEAR(1.0f / 128.0f, at128.getTickDelta(), 1e-6f);
+}
+
+TEST(OnTimeTicksRunOneAtATimeWithoutDrift) {
+    resetClock();
+    TickScheduler scheduler(60);
+    
+    // Ten seconds of ticks that take a fraction of the period: every wakeup
+    // runs one tick, within a few microseconds of its absolute deadline
+    for (int64_t tick = 0; tick < 600; tick++) {
+        ASSERT_EQ(1, scheduler.waitForNextTick());
+        ASSERT_TRUE(simMicros >= tick * PERIOD_60HZ);
+        ASSERT_TRUE(simMicros < tick * PERIOD_60HZ + 50);
+        ASSERT_TRUE(!runTick(scheduler, 3000));
+    }
+    
+    ASSERT_EQ(600, static_cast<int>(scheduler.getTickNumber()));
+    ASSERT_EQ(0, scheduler.takeSkippedTicks());
+}
+
+TEST(LateTicksAreCaughtUp) {
+    resetClock();
+    TickScheduler scheduler(60);
+    
+    // A 3.5-period tick misses the deadlines at 1, 2 and 3 periods
+    ASSERT_EQ(1, scheduler.waitForNextTick());
+    ASSERT_TRUE(runTick(scheduler, PERIOD_60HZ * 7 / 2));
+    
+    int dueTicks = scheduler.waitForNextTick();
+    ASSERT_EQ(3, dueTicks);
+    for (int i = 0; i < dueTicks; ++i) {
+        runTick(scheduler, 100);
+    }
+    
+    // Caught up: back on the original schedule, nothing skipped
+    ASSERT_EQ(1, scheduler.waitForNextTick());
+    ASSERT_TRUE(simMicros >= 4 * PERIOD_60HZ);
+    ASSERT_TRUE(simMicros < 4 * PERIOD_60HZ + 50);
+    ASSERT_EQ(4, static_cast<int>(scheduler.getTickNumber()));
+    ASSERT_EQ(0, scheduler.takeSkippedTicks());
+}
+
+TEST(CatchUpIsCappedPerWakeup) {
+    resetClock();
+    TickScheduler scheduler(60);
+    
+    // A 20-period stall leaves 20 deadlines due; only MAX_CATCH_UP_TICKS run
+    ASSERT_EQ(1, scheduler.waitForNextTick());
+    runTick(scheduler, PERIOD_60HZ * 20 + 100);
+    
+    int dueTicks = scheduler.waitForNextTick();
+    const int64_t stallEnd = simMicros;
+    ASSERT_EQ(TickScheduler::MAX_CATCH_UP_TICKS, dueTicks);
+    ASSERT_EQ(20 - TickScheduler::MAX_CATCH_UP_TICKS, scheduler.takeSkippedTicks());
+    ASSERT_EQ(0, scheduler.takeSkippedTicks());
+    for (int i = 0; i < dueTicks; ++i) {
+        runTick(scheduler, 0);
+    }
+    
+    // Rebased: the next deadline is one period after the stall, not a burst of
+    // the skipped ticks
+    ASSERT_EQ(1, scheduler.waitForNextTick());
+    ASSERT_TRUE(simMicros >= stallEnd + PERIOD_60HZ);
+    ASSERT_TRUE(simMicros < stallEnd + PERIOD_60HZ + 50);
+    runTick(scheduler, 0);
+    ASSERT_EQ(1, scheduler.waitForNextTick());
+    ASSERT_EQ(0, scheduler.takeSkippedTicks());
+}
+
+TEST(OverrunIsReported) {
+    resetClock();
+    TickScheduler scheduler(60);
+    
+    scheduler.waitForNextTick();
+    ASSERT_TRUE(runTick(scheduler, PERIOD_60HZ * 6 / 5));
+    ASSERT_TRUE(scheduler.getLastTickCost().asMicroseconds() >= PERIOD_60HZ * 6 / 5);
+    
+    scheduler.waitForNextTick();
+    ASSERT_TRUE(!runTick(scheduler, PERIOD_60HZ / 2));
+    ASSERT_TRUE(scheduler.getLastTickCost().asMicroseconds() < PERIOD_60HZ);
+}
+
+TEST(SnapshotIntervalKeepsSnapshotRate) {
+    ASSERT_EQ(3, static_cast<int>(snapshotIntervalTicks(60, 20)));
+    ASSERT_EQ(6, static_cast<int>(snapshotIntervalTicks(128, 20)));
+    ASSERT_EQ(2, static_cast<int>(snapshotIntervalTicks(30, 20)));
+    ASSERT_EQ(1, static_cast<int>(snapshotIntervalTicks(20, 20)));
+    ASSERT_EQ(4, static_cast<int>(snapshotIntervalTicks(240, 60)));
+    // Below the snapshot rate every tick sends one
+    ASSERT_EQ(1, static_cast<int>(snapshotIntervalTicks(10, 20)));
+    
+    // Across every accepted rate pair, snapshots stay within rounding of the
+    // snapshot rate instead of scaling with the tick rate
+    for (int tickRate = 10; tickRate <= 240; tickRate++) {
+        for (int snapshotRate = 5; snapshotRate <= std::min(60, tickRate); snapshotRate++) {
+            uint32_t interval = snapshotIntervalTicks(tickRate, snapshotRate);
+            float sent = tickRate / static_cast<float>(interval);
+            ASSERT_TRUE(sent >= snapshotRate * 0.75f - 1e-3f);
+            ASSERT_TRUE(sent <= snapshotRate * 1.5f + 1e-3f);
+        }
+    }
+}
+
+TEST(SnapshotsFollowTheScheduledTicks) {
+    resetClock();
+    TickScheduler scheduler(128);
+    const uint32_t interval = snapshotIntervalTicks(scheduler.getTickRate(), 20);
+    
+    // One second at 128 Hz, with a stall halfway: snapshots are picked by tick
+    // number as in runServerTick, so catch-up ticks keep the cadence
+    int snapshots = 0;
+    while (scheduler.getTickNumber() < 128) {
+        int dueTicks = scheduler.waitForNextTick();
+        for (int i = 0; i < dueTicks && scheduler.getTickNumber() < 128; ++i) {
+            if (scheduler.getTickNumber() % interval == 0) {
+                snapshots++;
+            }
+            runTick(scheduler, scheduler.getTickNumber() == 64 ? 30000 : 500);
+        }
+    }
+    
+    ASSERT_EQ(22, snapshots);  // Ticks 0, 6, ..., 126
+    ASSERT_EQ(0, scheduler.takeSkippedTicks());
+}
+
+// ========================
+// Real-Clock Benchmark
+// ========================
+
+// Run the scheduler on the real clock for a second and report how late ticks
+// start relative to their absolute deadlines
+void benchmarkTickRate(int tickRate) {
+    realTime = true;
+    TickScheduler scheduler(tickRate);
+    const int64_t period = 1000000 / tickRate;
+    const int64_t origin = sf::nowMicros();
+    
+    int wakeups = 0;
+    int64_t totalLate = 0;
+    int64_t maxLate = 0;
+    while (static_cast<int>(scheduler.getTickNumber()) < tickRate) {
+        int dueTicks = scheduler.waitForNextTick();
+        wakeups++;
+        // Lateness of the first due tick (later ones in a batch are catch-up)
+        int64_t late = sf::nowMicros() - origin - static_cast<int64_t>(scheduler.getTickNumber()) * period;
+        totalLate += std::max<int64_t>(0, late);
+        maxLate = std::max(maxLate, late);
+        for (int i = 0; i < dueTicks; ++i) {
+            scheduler.beginTick();
+            scheduler.endTick();
+        }
+    }
+    
+    std::cout << std::left << std::setw(12) << (std::to_string(tickRate) + " Hz") << std::right
+              << std::setw(10) << scheduler.getTickNumber()
+              << std::setw(10) << wakeups
+              << std::setw(14) << std::fixed << std::setprecision(1) << (totalLate / static_cast<double>(wakeups)) << " us"
+              << std::setw(12) << maxLate << " us"
+              << std::setw(10) << scheduler.takeSkippedTicks() << std::endl;
+    realTime = false;
+}
+
+// ========================
+// Main Test Runner
+// ========================
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Zero Ground Tick Scheduler Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "--- Tick Scheduler Tests ---" << std::endl;
+    RUN_TEST(TickDeltaMatchesRate);
+    RUN_TEST(OnTimeTicksRunOneAtATimeWithoutDrift);
+    RUN_TEST(LateTicksAreCaughtUp);
+    RUN_TEST(CatchUpIsCappedPerWakeup);
+    RUN_TEST(OverrunIsReported);
+    RUN_TEST(SnapshotIntervalKeepsSnapshotRate);
+    RUN_TEST(SnapshotsFollowTheScheduledTicks);
+
+    std::cout << std::endl;
+    std::cout << "--- Real-Clock Tick Timing (1 second each) ---" << std::endl;
+    std::cout << std::left << std::setw(12) << "Rate" << std::right
+              << std::setw(10) << "Ticks" << std::setw(10) << "Wakeups"
+              << std::setw(17) << "Mean late" << std::setw(15) << "Max late" << std::setw(10) << "Skipped" << std::endl;
+    benchmarkTickRate(20);
+    benchmarkTickRate(60);
+    benchmarkTickRate(128);
+
+    // Print summary
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Test Summary" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Total tests: " << totalTests << std::endl;
+    std::cout << "Passed: " << passedTests << std::endl;
+    std::cout << "Failed: " << failedTests << std::endl;
+    std::cout << std::endl;
+
+    if (failedTests == 0) {
+        std::cout << "✓ All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "✗ Some tests failed!" << std::endl;
+        return 1;
+    }
+}
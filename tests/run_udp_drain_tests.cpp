@@ -0,0 +1,551 @@
+// UDP Drain Tests and Benchmark for Zero Ground
+// Checks the UDP listener's receive path: one wakeup drains every queued
+// datagram, a socket error keeps what was already received, and the kernel drop
+// counter is read from /proc/net/udp rows - including malformed and truncated
+// rows, which are skipped. Then compares the drain loop with the old
+// one-datagram-per-10-ms loop under load.
+//
+// SFML's UdpSocket is replaced by an in-memory queue.
+// Code under test is copied from Zero_Ground.cpp. Build with /O2 (or -O2).
+
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <deque>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+// ========================
+// Test Framework Macros
+// ========================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "Running test: " << #name << "..."; \
+    try { \
+        test_##name(); \
+        std::cout << " PASSED" << std::endl; \
+        passedTests++; \
+    } catch (const std::exception& e) { \
+        std::cout << " FAILED: " << e.what() << std::endl; \
+        failedTests++; \
+    } \
+    totalTests++; \
+} while(0)
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: " << #condition << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_NEAR(expected, actual, epsilon) do { \
+    if (std::abs((expected) - (actual)) > (epsilon)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << (expected) << " but got " << (actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(expected, actual) do { \
+    if ((expected) != (actual)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << static_cast<int>(expected) << " but got " << static_cast<int>(actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+// Test counters
+int totalTests = 0;
+int passedTests = 0;
+int failedTests = 0;
+
+
+// ========================
+// Simulated Socket
+// ========================
+
+double simTime = 0.0;  // Seconds, advanced by the tests
+
+// Minimal stand-ins for the SFML types the receive path uses
+namespace sf {
+class Time {
+public:
+    float asSeconds() const { return seconds_; }
+    static Time fromSeconds(float s) { Time t; t.seconds_ = s; return t; }
+private:
+    float seconds_ = 0.0f;
+};
+
+class Clock {
+public:
+    Time getElapsedTime() const { return Time::fromSeconds(static_cast<float>(simTime)); }
+};
+
+class IpAddress {
+public:
+    IpAddress() {}
+    explicit IpAddress(uint32_t address) : address_(address) {}
+    uint32_t toInteger() const { return address_; }
+private:
+    uint32_t address_ = 0;
+};
+
+class Socket {
+public:
+    enum Status { Done, NotReady, Partial, Disconnected, Error };
+};
+
+// Datagrams waiting in the socket's receive buffer; an entry with error set
+// makes receive() fail once instead
+class UdpSocket : public Socket {
+public:
+    struct Queued {
+        std::vector<uint8_t> bytes;
+        uint32_t sender = 0;
+        unsigned short port = 0;
+        bool error = false;
+    };
+    
+    Status receive(void* data, std::size_t size, std::size_t& received, IpAddress& sender, unsigned short& port) {
+        received = 0;
+        if (queue.empty()) {
+            return NotReady;
+        }
+        Queued next = queue.front();
+        queue.pop_front();
+        if (next.error) {
+            return Error;
+        }
+        received = std::min(size, next.bytes.size());
+        std::memcpy(data, next.bytes.data(), received);
+        sender = IpAddress(next.sender);
+        port = next.port;
+        return Done;
+    }
+    
+    std::deque<Queued> queue;
+};
+}
+
+sf::Clock networkClock;
+
+const size_t MAX_DATAGRAM_BYTES = 1200;  // From the wire protocol section
+
+// ========================
+// Code Under Test (copied from Zero_Ground.cpp)
+// ========================
+
+// Raw datagram received by the UDP listener thread
+// The listener only receives and queues; all game state changes happen on the
+// simulation tick (see runServerTick) so inputs are applied in a deterministic order.
+struct InboundDatagram {
+    sf::IpAddress sender;
+    unsigned short senderPort = 0;
+    std::size_t size = 0;
+    float receivedAt = 0.0f;  // networkClock time (RTT samples)
+    uint8_t data[MAX_DATAGRAM_BYTES];  // DatagramBuilder starts a new datagram before exceeding this
+};
+
+// Parse one row of /proc/net/udp:
+// "sl local_address rem_address st tx_queue:rx_queue tr:tm->when retrnsmt uid timeout inode ref pointer drops"
+// Returns: true with drops set if the row is well formed and bound to localPort;
+// malformed or truncated rows return false (the file can change while it is read)
+bool parseUdpDropsLine(const std::string& line, unsigned short localPort, long long& drops) {
+    std::istringstream fields(line);
+    std::string slot, localAddress, field, lastField;
+    if (!(fields >> slot >> localAddress)) {
+        return false;
+    }
+    
+    size_t colon = localAddress.find(':');
+    if (colon == std::string::npos || colon + 1 >= localAddress.size()) {
+        return false;
+    }
+    const char* portText = localAddress.c_str() + colon + 1;
+    char* end = nullptr;
+    unsigned long port = std::strtoul(portText, &end, 16);
+    if (end == portText || *end != '\0' || port != localPort) {
+        return false;
+    }
+    
+    // drops is the last of 13 columns
+    int columns = 2;
+    while (fields >> field) {
+        lastField = field;
+        columns++;
+    }
+    if (columns < 13) {
+        return false;
+    }
+    end = nullptr;
+    long long value = std::strtoll(lastField.c_str(), &end, 10);
+    if (end == lastField.c_str() || *end != '\0' || value < 0) {
+        return false;
+    }
+    drops = value;
+    return true;
+}
+
+// Find the drop counter of localPort in a /proc/net/udp style table
+// Returns: the first well-formed row's drops, or -1 if there is none
+long long findUdpDrops(std::istream& table, unsigned short localPort) {
+    std::string line;
+    std::getline(table, line); // Skip header
+    while (std::getline(table, line)) {
+        long long drops = 0;
+        if (parseUdpDropsLine(line, localPort, drops)) {
+            return drops;
+        }
+    }
+    return -1;
+}
+
+// Read the kernel's receive-drop counter for a local UDP port
+// Returns: cumulative drops since the socket was created, or -1 if the platform
+// does not expose a per-socket counter (Windows only has system-wide UDP stats)
+long long readKernelUdpDrops(unsigned short localPort) {
+#ifdef __linux__
+    std::ifstream procFile("/proc/net/udp");
+    if (!procFile) {
+        return -1;
+    }
+    return findUdpDrops(procFile, localPort);
+#else
+    (void)localPort;
+    return -1;
+#endif
+}
+
+// Receive every datagram already queued on a non-blocking socket into batch
+// Returns: false if the socket reported an error; the datagrams after it are
+// picked up on the next wakeup
+bool drainUdpSocket(sf::UdpSocket& socket, std::vector<InboundDatagram>& batch) {
+    while (true) {
+        InboundDatagram datagram;
+        sf::Socket::Status status = socket.receive(datagram.data, sizeof(datagram.data), datagram.size,
+                                                   datagram.sender, datagram.senderPort);
+        
+        if (status == sf::Socket::NotReady) {
+            return true;
+        }
+        if (status != sf::Socket::Done) {
+            return false;
+        }
+        
+        // Stamped here, not on the tick: the tick wait would add up to a tick to every RTT sample
+        datagram.receivedAt = networkClock.getElapsedTime().asSeconds();
+        batch.push_back(datagram);
+    }
+}
+
+// ========================
+// Helpers
+// ========================
+
+void queueDatagram(sf::UdpSocket& socket, uint8_t first, size_t size, uint32_t sender = 0x0A000001) {
+    sf::UdpSocket::Queued queued;
+    queued.bytes.assign(size, 0);
+    queued.bytes[0] = first;
+    queued.sender = sender;
+    queued.port = 53002;
+    socket.queue.push_back(queued);
+}
+
+void queueError(sf::UdpSocket& socket) {
+    sf::UdpSocket::Queued queued;
+    queued.error = true;
+    socket.queue.push_back(queued);
+}
+
+const char* PROC_HEADER =
+    "   sl  local_address rem_address   st tx_queue rx_queue tr tm->when retrnsmt   uid  timeout inode ref pointer drops";
+
+// A /proc/net/udp row for a socket bound to port with the given drop count
+std::string procRow(int slot, unsigned short port, long long drops) {
+    std::ostringstream row;
+    row << std::setw(5) << slot << ": 00000000:" << std::uppercase << std::hex << std::setw(4)
+        << std::setfill('0') << port << std::dec << std::setfill(' ')
+        << " 00000000:0000 07 00000000:00000000 00:00000000 00000000  1000        0 "
+        << (40000 + slot) << " 2 0000000000000000 " << drops;
+    return row.str();
+}
+
+long long dropsIn(const std::vector<std::string>& rows, unsigned short port) {
+    std::stringstream table;
+    table << PROC_HEADER << "\n";
+    for (const std::string& row : rows) {
+        table << row << "\n";
+    }
+    return findUdpDrops(table, port);
+}
+
+// ========================
+// Tests
+// ========================
+
+TEST(DrainTakesEveryQueuedDatagram) {
+    sf::UdpSocket socket;
+    for (int i = 0; i < 50; ++i) {
+        queueDatagram(socket, static_cast<uint8_t>(i), 10 + i);
+    }
+    simTime = 2.5;
+    std::vector<InboundDatagram> batch;
+    
+    ASSERT_TRUE(drainUdpSocket(socket, batch));
+    ASSERT_EQ(50, static_cast<int>(batch.size()));
+    ASSERT_TRUE(socket.queue.empty());
+    for (int i = 0; i < 50; ++i) {
+        ASSERT_EQ(i, batch[i].data[0]);
+        ASSERT_EQ(10 + i, static_cast<int>(batch[i].size));
+        ASSERT_EQ(53002, batch[i].senderPort);
+        ASSERT_NEAR(2.5f, batch[i].receivedAt, 1e-6f);
+    }
+}
+
+TEST(DrainOfEmptySocketReturnsNothing) {
+    sf::UdpSocket socket;
+    std::vector<InboundDatagram> batch;
+    ASSERT_TRUE(drainUdpSocket(socket, batch));
+    ASSERT_TRUE(batch.empty());
+}
+
+TEST(DrainAppendsToTheBatch) {
+    sf::UdpSocket socket;
+    std::vector<InboundDatagram> batch(3);
+    queueDatagram(socket, 7, 20);
+    ASSERT_TRUE(drainUdpSocket(socket, batch));
+    ASSERT_EQ(4, static_cast<int>(batch.size()));
+    ASSERT_EQ(7, batch[3].data[0]);
+}
+
+TEST(SocketErrorKeepsReceivedDatagramsAndTheRest) {
+    sf::UdpSocket socket;
+    queueDatagram(socket, 1, 12);
+    queueDatagram(socket, 2, 12);
+    queueError(socket);
+    queueDatagram(socket, 3, 12);
+    std::vector<InboundDatagram> batch;
+    
+    ASSERT_TRUE(!drainUdpSocket(socket, batch));
+    ASSERT_EQ(2, static_cast<int>(batch.size()));
+    ASSERT_EQ(1, static_cast<int>(socket.queue.size()));
+    
+    // Next wakeup
+    batch.clear();
+    ASSERT_TRUE(drainUdpSocket(socket, batch));
+    ASSERT_EQ(1, static_cast<int>(batch.size()));
+    ASSERT_EQ(3, batch[0].data[0]);
+}
+
+TEST(OversizedDatagramIsTruncatedToTheBuffer) {
+    sf::UdpSocket socket;
+    queueDatagram(socket, 9, 1500);
+    std::vector<InboundDatagram> batch;
+    ASSERT_TRUE(drainUdpSocket(socket, batch));
+    ASSERT_EQ(static_cast<int>(sizeof(batch[0].data)), static_cast<int>(batch[0].size));
+}
+
+TEST(ProcRowOfThePortGivesItsDrops) {
+    long long drops = -1;
+    ASSERT_TRUE(parseUdpDropsLine(procRow(12, 53001, 17), 53001, drops));
+    ASSERT_EQ(17, static_cast<int>(drops));
+    ASSERT_TRUE(!parseUdpDropsLine(procRow(12, 53002, 17), 53001, drops));
+    
+    ASSERT_EQ(0, static_cast<int>(dropsIn({ procRow(1, 53002, 5), procRow(2, 53001, 0) }, 53001)));
+    ASSERT_EQ(-1, static_cast<int>(dropsIn({ procRow(1, 53002, 5) }, 53001)));
+    ASSERT_EQ(-1, static_cast<int>(dropsIn({}, 53001)));
+}
+
+TEST(LargeDropCountsFitInLongLong) {
+    long long drops = 0;
+    ASSERT_TRUE(parseUdpDropsLine(procRow(3, 53001, 5000000000LL), 53001, drops));
+    ASSERT_TRUE(drops == 5000000000LL);
+}
+
+TEST(MalformedRowsAreSkipped) {
+    const std::string good = procRow(9, 53001, 42);
+    const std::vector<std::string> bad = {
+        "",
+        "   4:",
+        "   4: 00000000",                                                    // No port
+        "   4: 00000000:",                                                   // Empty port
+        "   4: 00000000:ZZZZ 00000000:0000 07",                              // Port not hex
+        "   4: 00000000:CF49",                                               // Right port, truncated
+        good.substr(0, good.size() - 3),                                     // Cut inside the columns
+        procRow(5, 53001, 42).replace(procRow(5, 53001, 42).size() - 2, 2, "x1"),  // Drops not a number
+        procRow(6, 53001, -3),                                               // Negative drops
+        "   7: 00000000:CF49 00000000:0000 07 00000000:00000000 00:00000000 00000000  1000        0 1 2 0000000000000000 99999999999999999999999",
+    };
+    for (const std::string& row : bad) {
+        long long drops = -7;
+        ASSERT_TRUE(!parseUdpDropsLine(row, 53001, drops));
+        ASSERT_EQ(-7, static_cast<int>(drops));
+    }
+    
+    // Bad rows before the real one do not hide it
+    std::vector<std::string> rows = bad;
+    rows.push_back(good);
+    ASSERT_EQ(42, static_cast<int>(dropsIn(rows, 53001)));
+}
+
+TEST(KernelCounterIsReadableOrReportedMissing) {
+    long long drops = readKernelUdpDrops(1);  // Port 1 is never bound here
+    ASSERT_EQ(-1, static_cast<int>(drops));
+}
+
+// ========================
+// Benchmark
+// ========================
+
+template <typename F>
+double timeNs(int iterations, F&& body) {
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (int k = 0; k < iterations; k++) body(k);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::nano>(end - begin).count() / iterations;
+}
+
+struct LoadResult {
+    size_t delivered = 0;
+    size_t dropped = 0;   // Socket buffer full
+    double maxQueueAge = 0.0;
+};
+
+// rate datagrams/s arrive evenly for seconds; the socket buffer holds bufferDatagrams.
+// drain: every 1 ms wakeup empties the socket (the selector wakes on arrival);
+// otherwise one datagram is taken, then the loop sleeps 10 ms (the old listener)
+LoadResult simulateListener(double rate, double seconds, size_t bufferDatagrams, bool drain) {
+    sf::UdpSocket socket;
+    std::deque<double> arrivals;
+    LoadResult result;
+    double nextArrival = 0.0;
+    double nextWakeup = 0.0;
+    std::vector<InboundDatagram> batch;
+    for (simTime = 0.0; simTime < seconds; simTime += 0.0005) {
+        while (nextArrival <= simTime) {
+            if (socket.queue.size() < bufferDatagrams) {
+                queueDatagram(socket, 0, 24);
+                arrivals.push_back(nextArrival);
+            } else {
+                result.dropped++;
+            }
+            nextArrival += 1.0 / rate;
+        }
+        if (simTime < nextWakeup) {
+            continue;
+        }
+        batch.clear();
+        if (drain) {
+            drainUdpSocket(socket, batch);
+            nextWakeup = simTime + 0.001;
+        } else {
+            std::size_t size = 0;
+            InboundDatagram datagram;
+            if (socket.receive(datagram.data, sizeof(datagram.data), size, datagram.sender, datagram.senderPort) == sf::Socket::Done) {
+                batch.push_back(datagram);
+            }
+            nextWakeup = simTime + 0.010;
+        }
+        for (size_t i = 0; i < batch.size(); ++i) {
+            result.maxQueueAge = std::max(result.maxQueueAge, simTime - arrivals.front());
+            arrivals.pop_front();
+        }
+        result.delivered += batch.size();
+    }
+    return result;
+}
+
+void benchmarkDrain() {
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::setw(14) << "Datagrams/s" << std::setw(10) << "Loop" << std::setw(12) << "Delivered"
+              << std::setw(10) << "Dropped" << std::setw(14) << "Max delay" << std::endl;
+    const double rates[] = { 80.0, 400.0, 3840.0 };  // 4 players, 20 players, 64 players at 60 Hz
+    for (double rate : rates) {
+        for (int drain = 0; drain < 2; ++drain) {
+            LoadResult r = simulateListener(rate, 5.0, 256, drain == 1);
+            std::cout << std::setw(14) << rate << std::setw(10) << (drain ? "drain" : "old")
+                      << std::setw(12) << r.delivered << std::setw(10) << r.dropped
+                      << std::setw(11) << r.maxQueueAge * 1000.0 << " ms" << std::endl;
+        }
+    }
+    std::cout << "5 s of evenly spaced arrivals, 256-datagram socket buffer" << std::endl;
+    
+    // CPU cost of the drain loop per datagram (stub socket, so mostly the copy into the batch)
+    sf::UdpSocket socket;
+    std::vector<InboundDatagram> batch;
+    batch.reserve(256);
+    double ns = timeNs(20000, [&](int) {
+        for (int i = 0; i < 64; ++i) {
+            queueDatagram(socket, 1, 40);
+        }
+        batch.clear();
+        drainUdpSocket(socket, batch);
+    }) / 64.0;
+    std::cout << "Drain, per datagram (incl. queueing it in the stub): " << std::setprecision(0) << ns << " ns" << std::endl;
+    
+    // Parsing a busy /proc/net/udp (300 sockets) once per second
+    std::vector<std::string> rows;
+    for (int i = 0; i < 300; ++i) {
+        rows.push_back(procRow(i, static_cast<unsigned short>(40000 + i), i));
+    }
+    rows.push_back(procRow(300, 53001, 12));
+    volatile long long sink = 0;
+    double parseUs = timeNs(200, [&](int) { sink = dropsIn(rows, 53001); }) / 1000.0;
+    (void)sink;
+    std::cout << "Drop counter lookup in a 300-socket table: " << std::setprecision(1) << parseUs << " us" << std::endl;
+}
+
+// ========================
+// Main Test Runner
+// ========================
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Zero Ground UDP Drain Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "--- UDP Drain Tests ---" << std::endl;
+    RUN_TEST(DrainTakesEveryQueuedDatagram);
+    RUN_TEST(DrainOfEmptySocketReturnsNothing);
+    RUN_TEST(DrainAppendsToTheBatch);
+    RUN_TEST(SocketErrorKeepsReceivedDatagramsAndTheRest);
+    RUN_TEST(OversizedDatagramIsTruncatedToTheBuffer);
+    RUN_TEST(ProcRowOfThePortGivesItsDrops);
+    RUN_TEST(LargeDropCountsFitInLongLong);
+    RUN_TEST(MalformedRowsAreSkipped);
+    RUN_TEST(KernelCounterIsReadableOrReportedMissing);
+
+    std::cout << std::endl;
+    std::cout << "--- Listener Loop under Load (simulated time) ---" << std::endl;
+    benchmarkDrain();
+
+    // Print summary
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Test Summary" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Total tests: " << totalTests << std::endl;
+    std::cout << "Passed: " << passedTests << std::endl;
+    std::cout << "Failed: " << failedTests << std::endl;
+    std::cout << std::endl;
+
+    if (failedTests == 0) {
+        std::cout << "✓ All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "✗ Some tests failed!" << std::endl;
+        return 1;
+    }
+}
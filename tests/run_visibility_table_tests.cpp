@@ -0,0 +1,733 @@
+// Visibility Table (PVS) Tests and Benchmark for Zero Ground
+// Checks the client's cell-to-cell visibility table against the exact wall
+// traversal on a generated map and times the table build, a lookup and the
+// exact test it stands in for. The fog field uses the table as its broad
+// phase (see run_fog_field_tests.cpp).
+//
+// Code under test is copied from Zero_Ground_client.cpp (sf::Vector2f is
+// replaced by a plain struct). Build with /O2 (or -O2).
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <array>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <cstdint>
+
+// ========================
+// Test Framework Macros
+// ========================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "Running test: " << #name << "..."; \
+    try { \
+        test_##name(); \
+        std::cout << " PASSED" << std::endl; \
+        passedTests++; \
+    } catch (const std::exception& e) { \
+        std::cout << " FAILED: " << e.what() << std::endl; \
+        failedTests++; \
+    } \
+    totalTests++; \
+} while(0)
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: " << #condition << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_NEAR(expected, actual, epsilon) do { \
+    if (std::abs((expected) - (actual)) > (epsilon)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << (expected) << " but got " << (actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(expected, actual) do { \
+    if ((expected) != (actual)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << static_cast<int>(expected) << " but got " << static_cast<int>(actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+// Test counters
+int totalTests = 0;
+int passedTests = 0;
+int failedTests = 0;
+
+
+// ========================
+// Code Under Test (copied from Zero_Ground_client.cpp)
+// ========================
+
+// Minimal stand-in for sf::Vector2f
+namespace sf {
+struct Vector2f {
+    float x = 0.0f;
+    float y = 0.0f;
+    Vector2f() {}
+    Vector2f(float x_, float y_) : x(x_), y(y_) {}
+};
+}
+
+const float MAP_SIZE = 5100.0f;
+const float CELL_SIZE = 100.0f;
+const int GRID_SIZE = 51;
+const float WALL_WIDTH = 12.0f;
+
+// Wall types
+enum class WallType : uint8_t {
+    None = 0,      // No wall
+    Concrete = 1,  // Concrete wall (gray)
+    Wood = 2       // Wooden wall (brown)
+};
+
+// Number of set bits
+inline int popCount(uint64_t mask) {
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(mask));
+#else
+    return __builtin_popcountll(mask);
+#endif
+}
+
+// Map walls stored on the cell edges they occupy
+//
+// A wall lies on the boundary between two cells, so it is stored once per edge
+// rather than once per cell side: the right wall of (i, j) and the left wall of
+// (i + 1, j) are the same edge and can no longer disagree. Two bit-planes hold
+// the horizontal edges (top of cell (i, j), lines j = 0..GRID_SIZE) and the
+// vertical edges (left of cell (i, j), lines i = 0..GRID_SIZE), 2 bits per edge
+// holding the WallType value, 32 edges per 64-bit word. Queries outside the map
+// return WallType::None. Walls are centered on their edge (WALL_WIDTH/2 on each side).
+//
+// PERFORMANCE: 2 x 83 words = 1,328 bytes for the whole map instead of 10 KB of
+// per-cell sides, so it stays in L1 and is sent to clients as one span; wall
+// counts take one popcount per 32 edges.
+class CellGrid {
+public:
+    static constexpr int EDGES_PER_PLANE = (GRID_SIZE + 1) * GRID_SIZE;
+    static constexpr int EDGES_PER_WORD = 32;
+    static constexpr int WORDS_PER_PLANE = (EDGES_PER_PLANE + EDGES_PER_WORD - 1) / EDGES_PER_WORD;
+    static constexpr int WORD_COUNT = 2 * WORDS_PER_PLANE;
+    static constexpr size_t BYTE_SIZE = WORD_COUNT * sizeof(uint64_t);  // Serialized map size
+    
+    CellGrid() { clear(); }
+    
+    // Wall on the horizontal edge along the top of cell (i, j), j in [0, GRID_SIZE]
+    WallType horizontal(int i, int j) const {
+        if (i < 0 || i >= GRID_SIZE || j < 0 || j > GRID_SIZE) return WallType::None;
+        return get(HORIZONTAL, j * GRID_SIZE + i);
+    }
+    
+    // Wall on the vertical edge along the left of cell (i, j), i in [0, GRID_SIZE]
+    WallType vertical(int i, int j) const {
+        if (i < 0 || i > GRID_SIZE || j < 0 || j >= GRID_SIZE) return WallType::None;
+        return get(VERTICAL, i * GRID_SIZE + j);
+    }
+    
+    void setHorizontal(int i, int j, WallType type) {
+        if (i < 0 || i >= GRID_SIZE || j < 0 || j > GRID_SIZE) return;
+        set(HORIZONTAL, j * GRID_SIZE + i, type);
+    }
+    
+    void setVertical(int i, int j, WallType type) {
+        if (i < 0 || i > GRID_SIZE || j < 0 || j >= GRID_SIZE) return;
+        set(VERTICAL, i * GRID_SIZE + j, type);
+    }
+    
+    // Wall on one side of cell (i, j): 0 = top, 1 = right, 2 = bottom, 3 = left
+    WallType wall(int i, int j, int side) const {
+        switch (side) {
+            case 0: return horizontal(i, j);
+            case 1: return vertical(i + 1, j);
+            case 2: return horizontal(i, j + 1);
+            default: return vertical(i, j);
+        }
+    }
+    
+    void setWall(int i, int j, int side, WallType type) {
+        switch (side) {
+            case 0: setHorizontal(i, j, type); break;
+            case 1: setVertical(i + 1, j, type); break;
+            case 2: setHorizontal(i, j + 1, type); break;
+            default: setVertical(i, j, type); break;
+        }
+    }
+    
+    // Number of walls, a word (32 edges) at a time
+    size_t countWalls() const {
+        size_t count = 0;
+        for (uint64_t word : words_) {
+            count += popCount((word | (word >> 1)) & LOW_BITS);
+        }
+        return count;
+    }
+    
+    // Number of walls of one type (Concrete or Wood)
+    size_t countWalls(WallType type) const {
+        size_t count = 0;
+        for (uint64_t word : words_) {
+            uint64_t low = word & LOW_BITS;
+            uint64_t high = (word >> 1) & LOW_BITS;
+            count += popCount(type == WallType::Wood ? (high & ~low) : (low & ~high));
+        }
+        return count;
+    }
+    
+    // Remove every wall
+    void clear() { words_.fill(0); }
+    
+    // Clear the bit pairs that encode no wall (the value 3 and the unused tail of
+    // each plane), so nothing received from the network can corrupt the map
+    void sanitize() {
+        const int tailEdges = EDGES_PER_PLANE % EDGES_PER_WORD;
+        const uint64_t tailMask = (tailEdges == 0) ? ~0ULL : (1ULL << (tailEdges * 2)) - 1;
+        for (int w = 0; w < WORD_COUNT; w++) {
+            uint64_t invalid = words_[w] & (words_[w] >> 1) & LOW_BITS;
+            words_[w] &= ~(invalid * 3);
+            if (w % WORDS_PER_PLANE == WORDS_PER_PLANE - 1) words_[w] &= tailMask;
+        }
+    }
+    
+    // Raw storage, WORD_COUNT words: the horizontal plane, then the vertical plane
+    const uint64_t* data() const { return words_.data(); }
+    uint64_t* data() { return words_.data(); }
+    
+private:
+    static constexpr int HORIZONTAL = 0;
+    static constexpr int VERTICAL = 1;
+    static constexpr uint64_t LOW_BITS = 0x5555555555555555ULL;  // Low bit of every edge
+    
+    WallType get(int plane, int edge) const {
+        uint64_t word = words_[plane * WORDS_PER_PLANE + edge / EDGES_PER_WORD];
+        return static_cast<WallType>((word >> (edge % EDGES_PER_WORD * 2)) & 3);
+    }
+    
+    void set(int plane, int edge, WallType type) {
+        uint64_t& word = words_[plane * WORDS_PER_PLANE + edge / EDGES_PER_WORD];
+        const int shift = edge % EDGES_PER_WORD * 2;
+        word = (word & ~(3ULL << shift)) | (static_cast<uint64_t>(type) << shift);
+    }
+    
+    std::array<uint64_t, WORD_COUNT> words_;
+};
+
+// Generate map using probabilistic algorithm
+// Only cells where (i+j)%2==1 can have walls
+// Probabilities: 60% - 1 wall, 25% - 2 walls, 15% - 0 walls
+// Wall types: 70% concrete, 30% wood
+// A wall on a side shared with a neighbour that already has one there replaces it
+void generateMap(CellGrid& grid, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> probDist(0, 99);  // 0-99 for percentages
+    std::uniform_int_distribution<int> sideDist(0, 3);   // 0-3 for sides
+    std::uniform_int_distribution<int> typeDist(0, 99);  // 0-99 for wall type
+    
+    for (int i = 0; i < GRID_SIZE; i++) {
+        for (int j = 0; j < GRID_SIZE; j++) {
+            // Check condition: only cells where (i+j)%2==1 can generate walls
+            if ((i + j) % 2 == 1) {
+                int probability = probDist(gen);
+                
+                if (probability < 60) {
+                    // 60% probability - create one wall on a random side
+                    int side = sideDist(gen);
+                    // Determine wall type: 70% concrete, 30% wood
+                    WallType type = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    grid.setWall(i, j, side, type);
+                }
+                else if (probability < 85) {
+                    // 25% probability (60-84) - create two walls on different sides
+                    int side1 = sideDist(gen);
+                    int side2 = sideDist(gen);
+                    
+                    // Ensure the two sides are different
+                    while (side2 == side1) {
+                        side2 = sideDist(gen);
+                    }
+                    
+                    // Each wall gets its own type
+                    WallType type1 = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    WallType type2 = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    grid.setWall(i, j, side1, type1);
+                    grid.setWall(i, j, side2, type2);
+                }
+                // 15% probability (85-99) - no walls (do nothing)
+            }
+        }
+    }
+}
+
+// Slab test: does the segment (x1, y1) + t * (dx, dy), t in [0, 1], touch the rectangle?
+inline bool segmentTouchesRect(float x1, float y1, float dx, float dy,
+                               float rectX, float rectY, float rectW, float rectH) {
+    float tMin = 0.0f;
+    float tMax = 1.0f;
+    
+    const float origin[2] = { x1, y1 };
+    const float dir[2] = { dx, dy };
+    const float lo[2] = { rectX, rectY };
+    const float hi[2] = { rectX + rectW, rectY + rectH };
+    
+    for (int axis = 0; axis < 2; ++axis) {
+        if (dir[axis] == 0.0f) {
+            // Parallel to this slab: must already be inside it
+            if (origin[axis] < lo[axis] || origin[axis] > hi[axis]) return false;
+            continue;
+        }
+        float t1 = (lo[axis] - origin[axis]) / dir[axis];
+        float t2 = (hi[axis] - origin[axis]) / dir[axis];
+        if (t1 > t2) std::swap(t1, t2);
+        tMin = std::max(tMin, t1);
+        tMax = std::min(tMax, t2);
+        if (tMin > tMax) return false;
+    }
+    return true;
+}
+
+// Exact wall test: does the segment (x1, y1) -> (x2, y2) touch any wall?
+//
+// ALGORITHM: Amanda-Woo grid traversal (same walk as the server's
+// Bullet::traceCellWallsDDA); every visited cell tests the four edges around
+// it and the walk stops at the first hit.
+//
+// PERFORMANCE: visits |dCellX| + |dCellY| + 1 cells and tests only walls that
+// exist, instead of checking nine cells every 3 pixels along the segment.
+bool segmentHitsWall(const CellGrid& grid, float x1, float y1, float x2, float y2) {
+    const float dx = x2 - x1;
+    const float dy = y2 - y1;
+    const float half = WALL_WIDTH / 2.0f;
+    
+    // Walls on the four edges around cell (i, j)
+    auto cellBoundariesHit = [&](int i, int j) {
+        const float cellWorldX = i * CELL_SIZE;
+        const float cellWorldY = j * CELL_SIZE;
+        if (grid.horizontal(i, j) != WallType::None &&
+            segmentTouchesRect(x1, y1, dx, dy, cellWorldX, cellWorldY - half, CELL_SIZE, WALL_WIDTH)) return true;
+        if (grid.vertical(i + 1, j) != WallType::None &&
+            segmentTouchesRect(x1, y1, dx, dy, cellWorldX + CELL_SIZE - half, cellWorldY, WALL_WIDTH, CELL_SIZE)) return true;
+        if (grid.horizontal(i, j + 1) != WallType::None &&
+            segmentTouchesRect(x1, y1, dx, dy, cellWorldX, cellWorldY + CELL_SIZE - half, CELL_SIZE, WALL_WIDTH)) return true;
+        if (grid.vertical(i, j) != WallType::None &&
+            segmentTouchesRect(x1, y1, dx, dy, cellWorldX - half, cellWorldY, WALL_WIDTH, CELL_SIZE)) return true;
+        return false;
+    };
+    
+    int cellX = static_cast<int>(std::floor(x1 / CELL_SIZE));
+    int cellY = static_cast<int>(std::floor(y1 / CELL_SIZE));
+    const int endCellX = static_cast<int>(std::floor(x2 / CELL_SIZE));
+    const int endCellY = static_cast<int>(std::floor(y2 / CELL_SIZE));
+    
+    const int stepX = (dx > 0.0f) ? 1 : (dx < 0.0f ? -1 : 0);
+    const int stepY = (dy > 0.0f) ? 1 : (dy < 0.0f ? -1 : 0);
+    const float inf = std::numeric_limits<float>::infinity();
+    
+    float tMaxX = inf, tDeltaX = inf;
+    if (stepX != 0) {
+        tMaxX = ((cellX + (stepX > 0 ? 1 : 0)) * CELL_SIZE - x1) / dx;
+        tDeltaX = CELL_SIZE / std::abs(dx);
+    }
+    float tMaxY = inf, tDeltaY = inf;
+    if (stepY != 0) {
+        tMaxY = ((cellY + (stepY > 0 ? 1 : 0)) * CELL_SIZE - y1) / dy;
+        tDeltaY = CELL_SIZE / std::abs(dy);
+    }
+    
+    // Exact number of boundary crossings; also bounds the loop against rounding
+    int remainingSteps = std::abs(endCellX - cellX) + std::abs(endCellY - cellY);
+    
+    while (true) {
+        if (cellBoundariesHit(cellX, cellY)) return true;
+        if (remainingSteps-- <= 0) return false;
+        
+        if (tMaxX < tMaxY) {
+            cellX += stepX;
+            tMaxX += tDeltaX;
+        } else {
+            cellY += stepY;
+            tMaxY += tDeltaY;
+        }
+    }
+}
+
+// Check if there's a clear line of sight between two points (no walls blocking)
+// Returns true if visible, false if blocked by walls
+// Exact: used for players, bullets and shops (the fog uses FogVisibilityField)
+bool hasLineOfSight(sf::Vector2f from, sf::Vector2f to, const CellGrid& grid) {
+    float dx = to.x - from.x;
+    float dy = to.y - from.y;
+    if (dx * dx + dy * dy < 0.01f) return true; // Same position
+    
+    // Out of bounds = blocked
+    if (from.x < 0.0f || from.x >= MAP_SIZE || from.y < 0.0f || from.y >= MAP_SIZE ||
+        to.x < 0.0f || to.x >= MAP_SIZE || to.y < 0.0f || to.y >= MAP_SIZE) {
+        return false;
+    }
+    
+    return !segmentHitsWall(grid, from.x, from.y, to.x, to.y);
+}
+
+// ========================
+// PERFORMANCE: Potentially Visible Set
+// ========================
+
+// Line of sight between two points is mostly decided per pair of cells: a table
+// built once per map records, for every cell and every cell within PVS_RADIUS,
+// whether all of the target cell is visible, none of it is, or it depends on
+// where in the cells the two points are.
+const int PVS_RADIUS = 12;  // Cells in each direction; covers the view plus fog padding
+const int PVS_SPAN = 2 * PVS_RADIUS + 1;
+const int PVS_OFFSETS = PVS_SPAN * PVS_SPAN;
+const float PVS_SAMPLE_INSET = WALL_WIDTH / 2.0f + 2.0f;  // Keeps sample points clear of boundary walls
+
+// How much of cell B can be seen from cell A
+enum class CellVisibility : uint8_t {
+    Hidden,   // No point of B is visible from any point of A
+    Visible,  // Every point of B is visible from every point of A
+    Partial   // Depends on the points
+};
+
+// Cell-to-cell visibility for the current map (two bits per cell pair)
+//
+// ALGORITHM:
+// - Each cell is sampled at its four corners (inset past the boundary walls)
+//   and its center. A pair is Visible if all 25 rays between the samples are
+//   clear, Hidden if all are blocked, Partial otherwise.
+// - Walls are 100 px long, so a wall between two cells that are not Partial
+//   almost never slips between the sampled rays; for points inside the inset
+//   squares Visible pairs match the exact test, and Hidden pairs disagree with it
+//   for well under 0.1% of point pairs (narrow gaps between walls).
+// - Visibility is symmetric: each pair is traced once and stored for both cells.
+//
+// PERFORMANCE: queries are two bit reads. The table is 2 bits x 625 offsets per
+// cell (~400 KB for 51x51) and is built once when the map arrives.
+class VisibilityTable {
+public:
+    // Classify every cell pair within PVS_RADIUS of each other
+    void build(const CellGrid& grid) {
+        const size_t words = (static_cast<size_t>(GRID_SIZE) * GRID_SIZE * PVS_OFFSETS + 63) / 64;
+        visible_.assign(words, 0);
+        hidden_.assign(words, 0);
+        
+        for (int ax = 0; ax < GRID_SIZE; ++ax) {
+            for (int ay = 0; ay < GRID_SIZE; ++ay) {
+                // Second half of the offsets only; the mirrored pair gets the same result
+                for (int offset = PVS_OFFSETS / 2; offset < PVS_OFFSETS; ++offset) {
+                    const int bx = ax + offset % PVS_SPAN - PVS_RADIUS;
+                    const int by = ay + offset / PVS_SPAN - PVS_RADIUS;
+                    if (bx < 0 || bx >= GRID_SIZE || by < 0 || by >= GRID_SIZE) continue;
+                    
+                    CellVisibility result = classifyPair(grid, ax, ay, bx, by);
+                    store(ax, ay, offset, result);
+                    store(bx, by, PVS_OFFSETS - 1 - offset, result);
+                }
+            }
+        }
+        built_ = true;
+    }
+    
+    // Visibility of cell (bx, by) from cell (ax, ay); Partial if out of range or not built
+    CellVisibility query(int ax, int ay, int bx, int by) const {
+        const int ox = bx - ax + PVS_RADIUS;
+        const int oy = by - ay + PVS_RADIUS;
+        if (!built_ || ox < 0 || ox >= PVS_SPAN || oy < 0 || oy >= PVS_SPAN ||
+            ax < 0 || ax >= GRID_SIZE || ay < 0 || ay >= GRID_SIZE ||
+            bx < 0 || bx >= GRID_SIZE || by < 0 || by >= GRID_SIZE) {
+            return CellVisibility::Partial;
+        }
+        const size_t bit = index(ax, ay, oy * PVS_SPAN + ox);
+        if ((visible_[bit >> 6] >> (bit & 63)) & 1) return CellVisibility::Visible;
+        if ((hidden_[bit >> 6] >> (bit & 63)) & 1) return CellVisibility::Hidden;
+        return CellVisibility::Partial;
+    }
+    
+    bool isBuilt() const { return built_; }
+    
+private:
+    static size_t index(int x, int y, int offset) {
+        return (static_cast<size_t>(x) * GRID_SIZE + y) * PVS_OFFSETS + offset;
+    }
+    
+    void store(int x, int y, int offset, CellVisibility result) {
+        const size_t bit = index(x, y, offset);
+        if (result == CellVisibility::Visible) visible_[bit >> 6] |= uint64_t(1) << (bit & 63);
+        if (result == CellVisibility::Hidden) hidden_[bit >> 6] |= uint64_t(1) << (bit & 63);
+    }
+    
+    static CellVisibility classifyPair(const CellGrid& grid, int ax, int ay, int bx, int by) {
+        float axs[5], ays[5], bxs[5], bys[5];
+        samplePoints(ax, ay, axs, ays);
+        samplePoints(bx, by, bxs, bys);
+        
+        bool anyClear = false;
+        bool anyBlocked = false;
+        for (int a = 0; a < 5; ++a) {
+            for (int b = 0; b < 5; ++b) {
+                if (segmentHitsWall(grid, axs[a], ays[a], bxs[b], bys[b])) {
+                    anyBlocked = true;
+                } else {
+                    anyClear = true;
+                }
+                if (anyClear && anyBlocked) return CellVisibility::Partial;
+            }
+        }
+        return anyClear ? CellVisibility::Visible : CellVisibility::Hidden;
+    }
+    
+    // Center first: it is the ray most likely to disagree with the corners
+    static void samplePoints(int x, int y, float* xs, float* ys) {
+        const float lo = PVS_SAMPLE_INSET;
+        const float hi = CELL_SIZE - PVS_SAMPLE_INSET;
+        const float ox[5] = { CELL_SIZE / 2.0f, lo, hi, lo, hi };
+        const float oy[5] = { CELL_SIZE / 2.0f, lo, lo, hi, hi };
+        for (int k = 0; k < 5; ++k) {
+            xs[k] = x * CELL_SIZE + ox[k];
+            ys[k] = y * CELL_SIZE + oy[k];
+        }
+    }
+    
+    std::vector<uint64_t> visible_;
+    std::vector<uint64_t> hidden_;
+    bool built_ = false;
+};
+
+// Cell visibility for the current map, rebuilt by receiveMapFromServer
+VisibilityTable g_visibilityTable;
+
+// ========================
+// Test Helpers
+// ========================
+
+CellGrid makeMap(unsigned seed) {
+    CellGrid grid;
+    generateMap(grid, seed);
+    return grid;
+}
+
+// Random point away from the cell edges (where players stand: walls stick
+// WALL_WIDTH / 2 into the cells and players are wider than that)
+sf::Vector2f insetPoint(std::mt19937& gen) {
+    std::uniform_int_distribution<int> cellDist(0, GRID_SIZE - 1);
+    std::uniform_real_distribution<float> offsetDist(PVS_SAMPLE_INSET, CELL_SIZE - PVS_SAMPLE_INSET);
+    return sf::Vector2f(cellDist(gen) * CELL_SIZE + offsetDist(gen), cellDist(gen) * CELL_SIZE + offsetDist(gen));
+}
+
+// Second point within the fog range of the first
+sf::Vector2f nearbyInsetPoint(std::mt19937& gen, sf::Vector2f from) {
+    std::uniform_real_distribution<float> offsetDist(-1200.0f, 1200.0f);
+    while (true) {
+        sf::Vector2f to(from.x + offsetDist(gen), from.y + offsetDist(gen) * 0.66f);
+        float fx = std::fmod(to.x, CELL_SIZE);
+        float fy = std::fmod(to.y, CELL_SIZE);
+        if (to.x >= 0.0f && to.x < MAP_SIZE && to.y >= 0.0f && to.y < MAP_SIZE &&
+            fx >= PVS_SAMPLE_INSET && fx <= CELL_SIZE - PVS_SAMPLE_INSET &&
+            fy >= PVS_SAMPLE_INSET && fy <= CELL_SIZE - PVS_SAMPLE_INSET) {
+            return to;
+        }
+    }
+}
+
+CellVisibility queryPoints(const VisibilityTable& table, sf::Vector2f a, sf::Vector2f b) {
+    return table.query(static_cast<int>(a.x / CELL_SIZE), static_cast<int>(a.y / CELL_SIZE),
+                       static_cast<int>(b.x / CELL_SIZE), static_cast<int>(b.y / CELL_SIZE));
+}
+
+// ========================
+// Visibility Table Tests
+// ========================
+
+TEST(EmptyMapIsFullyVisible) {
+    CellGrid grid;
+    VisibilityTable table;
+    table.build(grid);
+    for (int bx = 10; bx <= 10 + PVS_RADIUS; ++bx) {
+        for (int by = 20 - PVS_RADIUS; by <= 20 + PVS_RADIUS; ++by) {
+            ASSERT_TRUE(table.query(10, 20, bx, by) == CellVisibility::Visible);
+        }
+    }
+}
+
+TEST(LongWallHidesFarSide) {
+    CellGrid grid;
+    for (int j = 0; j < GRID_SIZE; ++j) {
+        grid.setWall(20, j, 1, WallType::Concrete);  // x = 2100 from top to bottom
+    }
+    VisibilityTable table;
+    table.build(grid);
+    ASSERT_TRUE(table.query(18, 25, 23, 25) == CellVisibility::Hidden);
+    ASSERT_TRUE(table.query(23, 30, 19, 22) == CellVisibility::Hidden);
+    ASSERT_TRUE(table.query(18, 25, 20, 28) == CellVisibility::Visible);
+    
+    // Cells touching the wall see it from their own side only
+    ASSERT_TRUE(table.query(20, 25, 21, 25) == CellVisibility::Hidden);
+}
+
+TEST(WallEndIsPartial) {
+    CellGrid grid;
+    for (int j = 0; j <= 25; ++j) {
+        grid.setWall(20, j, 1, WallType::Wood);  // x = 2100, ends at y = 2600
+    }
+    VisibilityTable table;
+    table.build(grid);
+    ASSERT_TRUE(table.query(18, 24, 23, 27) == CellVisibility::Partial);
+    ASSERT_TRUE(table.query(18, 20, 23, 20) == CellVisibility::Hidden);
+}
+
+TEST(SameCellIsVisible) {
+    CellGrid grid = makeMap(42);
+    VisibilityTable table;
+    table.build(grid);
+    for (int x = 0; x < GRID_SIZE; ++x) {
+        for (int y = 0; y < GRID_SIZE; ++y) {
+            ASSERT_TRUE(table.query(x, y, x, y) == CellVisibility::Visible);
+        }
+    }
+}
+
+TEST(QueriesAreSymmetric) {
+    CellGrid grid = makeMap(42);
+    VisibilityTable table;
+    table.build(grid);
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<int> cellDist(0, GRID_SIZE - 1);
+    std::uniform_int_distribution<int> offsetDist(-PVS_RADIUS, PVS_RADIUS);
+    for (int n = 0; n < 20000; ++n) {
+        int ax = cellDist(gen), ay = cellDist(gen);
+        int bx = ax + offsetDist(gen), by = ay + offsetDist(gen);
+        ASSERT_TRUE(table.query(ax, ay, bx, by) == table.query(bx, by, ax, ay));
+    }
+}
+
+TEST(OutOfRangeOrUnbuiltIsPartial) {
+    CellGrid grid = makeMap(42);
+    VisibilityTable table;
+    ASSERT_TRUE(!table.isBuilt());
+    ASSERT_TRUE(table.query(10, 10, 11, 10) == CellVisibility::Partial);
+    table.build(grid);
+    ASSERT_TRUE(table.isBuilt());
+    ASSERT_TRUE(table.query(10, 10, 10 + PVS_RADIUS + 1, 10) == CellVisibility::Partial);
+    ASSERT_TRUE(table.query(0, 0, -1, 0) == CellVisibility::Partial);
+    ASSERT_TRUE(table.query(GRID_SIZE - 1, 5, GRID_SIZE, 5) == CellVisibility::Partial);
+}
+
+TEST(AgreesWithExactTest) {
+    CellGrid grid = makeMap(42);
+    VisibilityTable table;
+    table.build(grid);
+    std::mt19937 gen(11);
+    const int SAMPLES = 200000;
+    int visibleWrong = 0;
+    int hiddenWrong = 0;
+    int decided = 0;
+    for (int n = 0; n < SAMPLES; ++n) {
+        sf::Vector2f a = insetPoint(gen);
+        sf::Vector2f b = nearbyInsetPoint(gen, a);
+        CellVisibility visibility = queryPoints(table, a, b);
+        bool exact = hasLineOfSight(a, b, grid);
+        if (visibility != CellVisibility::Partial) decided++;
+        if (visibility == CellVisibility::Visible && !exact) visibleWrong++;
+        if (visibility == CellVisibility::Hidden && exact) hiddenWrong++;
+    }
+    ASSERT_EQ(0, visibleWrong);
+    ASSERT_TRUE(hiddenWrong * 1000 < SAMPLES);  // < 0.1%
+    ASSERT_TRUE(decided * 2 > SAMPLES);         // Most pairs are decided by the table alone
+}
+
+// ========================
+// Benchmark
+// ========================
+
+void benchmarkTable() {
+    CellGrid grid = makeMap(42);
+    VisibilityTable table;
+    auto b0 = std::chrono::high_resolution_clock::now();
+    table.build(grid);
+    auto b1 = std::chrono::high_resolution_clock::now();
+    std::cout << "Table build: " << std::fixed << std::setprecision(0)
+              << std::chrono::duration<double, std::milli>(b1 - b0).count() << " ms" << std::endl;
+    
+    // Share of each class over all pairs in range
+    size_t counts[3] = { 0, 0, 0 };
+    for (int ax = 0; ax < GRID_SIZE; ++ax) {
+        for (int ay = 0; ay < GRID_SIZE; ++ay) {
+            for (int bx = ax - PVS_RADIUS; bx <= ax + PVS_RADIUS; ++bx) {
+                for (int by = ay - PVS_RADIUS; by <= ay + PVS_RADIUS; ++by) {
+                    if (bx < 0 || bx >= GRID_SIZE || by < 0 || by >= GRID_SIZE) continue;
+                    counts[static_cast<int>(table.query(ax, ay, bx, by))]++;
+                }
+            }
+        }
+    }
+    const double pairs = static_cast<double>(counts[0] + counts[1] + counts[2]);
+    std::cout << std::setprecision(1) << "Cell pairs: " << 100.0 * counts[1] / pairs << "% Visible, "
+              << 100.0 * counts[0] / pairs << "% Hidden, " << 100.0 * counts[2] / pairs << "% Partial" << std::endl;
+    
+    std::mt19937 gen(9);
+    std::vector<sf::Vector2f> from, to;
+    for (int n = 0; n < 100000; ++n) {
+        from.push_back(insetPoint(gen));
+        to.push_back(nearbyInsetPoint(gen, from.back()));
+    }
+    int sink = 0;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (size_t n = 0; n < from.size(); ++n) sink += static_cast<int>(queryPoints(table, from[n], to[n]));
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (size_t n = 0; n < from.size(); ++n) sink += hasLineOfSight(from[n], to[n], grid) ? 1 : 0;
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout << "Per point pair up to 1200 px apart: table lookup "
+              << std::chrono::duration<double, std::nano>(t1 - t0).count() / from.size() << " ns, exact traversal "
+              << std::chrono::duration<double, std::nano>(t2 - t1).count() / from.size() << " ns"
+              << " (" << sink % 2 << ")" << std::endl;
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Zero Ground Visibility Table Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "--- Visibility Table Tests ---" << std::endl;
+    RUN_TEST(EmptyMapIsFullyVisible);
+    RUN_TEST(LongWallHidesFarSide);
+    RUN_TEST(WallEndIsPartial);
+    RUN_TEST(SameCellIsVisible);
+    RUN_TEST(QueriesAreSymmetric);
+    RUN_TEST(OutOfRangeOrUnbuiltIsPartial);
+    RUN_TEST(AgreesWithExactTest);
+
+    std::cout << std::endl;
+    std::cout << "--- Table Build and Lookup Cost ---" << std::endl;
+    benchmarkTable();
+
+    // Print summary
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Test Summary" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Total tests: " << totalTests << std::endl;
+    std::cout << "Passed: " << passedTests << std::endl;
+    std::cout << "Failed: " << failedTests << std::endl;
+    std::cout << std::endl;
+
+    if (failedTests == 0) {
+        std::cout << "✓ All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "✗ Some tests failed!" << std::endl;
+        return 1;
+    }
+}
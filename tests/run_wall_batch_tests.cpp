@@ -0,0 +1,869 @@
+// Batched Wall Rendering Tests and Benchmark for Zero Ground
+// Checks that the chunked wall batches reproduce the per-wall renderer: the
+// same rounded rectangles at the same places, the same fog alpha per wall, no
+// visible wall left out of the drawn chunks. Also counts draw calls per frame
+// against one draw per wall while walking, for several view sizes.
+//
+// Code under test is copied from Zero_Ground.cpp; the SFML types it touches are
+// replaced by minimal stand-ins that record draw calls. Build with /O2 (or -O2).
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <cstdint>
+
+// ========================
+// Test Framework Macros
+// ========================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "Running test: " << #name << "..."; \
+    try { \
+        test_##name(); \
+        std::cout << " PASSED" << std::endl; \
+        passedTests++; \
+    } catch (const std::exception& e) { \
+        std::cout << " FAILED: " << e.what() << std::endl; \
+        failedTests++; \
+    } \
+    totalTests++; \
+} while(0)
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: " << #condition << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_NEAR(expected, actual, epsilon) do { \
+    if (std::abs((expected) - (actual)) > (epsilon)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << (expected) << " but got " << (actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(expected, actual) do { \
+    if ((expected) != (actual)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << static_cast<int>(expected) << " but got " << static_cast<int>(actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+// Test counters
+int totalTests = 0;
+int passedTests = 0;
+int failedTests = 0;
+
+
+// ========================
+// Code Under Test (copied from Zero_Ground.cpp)
+// ========================
+
+// Minimal stand-ins for the SFML types used by the wall renderer
+namespace sf {
+typedef uint8_t Uint8;
+struct Vector2f {
+    float x = 0.0f;
+    float y = 0.0f;
+    Vector2f() {}
+    Vector2f(float x_, float y_) : x(x_), y(y_) {}
+};
+inline Vector2f operator+(const Vector2f& a, const Vector2f& b) { return Vector2f(a.x + b.x, a.y + b.y); }
+struct Color {
+    Uint8 r = 0, g = 0, b = 0, a = 255;
+    Color() {}
+    Color(Uint8 r_, Uint8 g_, Uint8 b_, Uint8 a_ = 255) : r(r_), g(g_), b(b_), a(a_) {}
+};
+struct Vertex {
+    Vector2f position;
+    Color color;
+    Vector2f texCoords;
+    Vertex() {}
+    Vertex(Vector2f p, Color c, Vector2f t) : position(p), color(c), texCoords(t) {}
+};
+enum PrimitiveType { Triangles };
+class ConvexShape {
+public:
+    void setPointCount(size_t count) { points_.resize(count); }
+    void setPoint(size_t index, Vector2f point) { points_[index] = point; }
+    size_t getPointCount() const { return points_.size(); }
+    Vector2f getPoint(size_t index) const { return points_[index]; }
+private:
+    std::vector<Vector2f> points_;
+};
+class VertexBuffer {
+public:
+    enum Usage { Stream, Dynamic, Static };
+    VertexBuffer(PrimitiveType, Usage) {}
+    static bool isAvailable() { return available; }
+    bool create(size_t count) { vertices.resize(count); return true; }
+    bool update(const Vertex* data) { vertices.assign(data, data + vertices.size()); return true; }
+    std::vector<Vertex> vertices;
+    static inline bool available = true;
+};
+namespace Glsl {
+typedef Vector2f Vec2;
+struct Vec4 {
+    float x, y, z, w;
+    Vec4(float x_, float y_, float z_, float w_) : x(x_), y(y_), z(z_), w(w_) {}
+};
+}
+class Shader {
+public:
+    static bool isAvailable() { return available; }
+    bool loadFromMemory(const std::string&, const std::string&) { return true; }
+    void setUniform(const std::string& name, const Glsl::Vec2& value) { if (name == "player") player = value; }
+    void setUniform(const std::string&, const Glsl::Vec4& value) { ranges = value; }
+    Vector2f player;
+    Glsl::Vec4 ranges{0.0f, 0.0f, 0.0f, 0.0f};
+    static inline bool available = true;
+};
+struct RenderStates {
+    RenderStates(const Shader* shader_) : shader(shader_) {}
+    const Shader* shader = nullptr;
+};
+// Records every draw call; vertices are captured so tests can inspect them
+class RenderTarget {
+public:
+    void draw(const VertexBuffer& buffer, const RenderStates& states) {
+        drawCalls++;
+        lastShader = states.shader;
+        drawn.insert(drawn.end(), buffer.vertices.begin(), buffer.vertices.end());
+    }
+    void draw(const Vertex* vertices, size_t count, PrimitiveType) {
+        drawCalls++;
+        lastShader = nullptr;
+        drawn.insert(drawn.end(), vertices, vertices + count);
+    }
+    int drawCalls = 0;
+    const Shader* lastShader = nullptr;
+    std::vector<Vertex> drawn;
+};
+}
+
+const float MAP_SIZE = 5100.0f;
+const float CELL_SIZE = 100.0f;
+const int GRID_SIZE = 51;
+const float WALL_WIDTH = 12.0f;
+const float WALL_LENGTH = 100.0f;
+
+enum class WallType : uint8_t {
+    None = 0,
+    Concrete = 1,
+    Wood = 2
+};
+
+struct Cell {
+    WallType topWall = WallType::None;
+    WallType rightWall = WallType::None;
+    WallType bottomWall = WallType::None;
+    WallType leftWall = WallType::None;
+};
+
+typedef std::vector<std::vector<Cell>> Grid;
+
+void setWall(Cell& cell, int side, WallType type) {
+    switch (side) {
+        case 0: cell.topWall = type; break;
+        case 1: cell.rightWall = type; break;
+        case 2: cell.bottomWall = type; break;
+        case 3: cell.leftWall = type; break;
+    }
+}
+
+// Same generator as the server, seeded for reproducible runs
+void generateMap(std::vector<std::vector<Cell>>& grid, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> probDist(0, 99);  // 0-99 for percentages
+    std::uniform_int_distribution<int> sideDist(0, 3);   // 0-3 for sides
+    std::uniform_int_distribution<int> typeDist(0, 99);  // 0-99 for wall type
+    
+    for (int i = 0; i < GRID_SIZE; i++) {
+        for (int j = 0; j < GRID_SIZE; j++) {
+            // Check condition: only cells where (i+j)%2==1 can generate walls
+            if ((i + j) % 2 == 1) {
+                int probability = probDist(gen);
+                
+                if (probability < 60) {
+                    // 60% probability - create one wall on a random side
+                    int side = sideDist(gen);
+                    // Determine wall type: 70% concrete, 30% wood
+                    WallType type = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    setWall(grid[i][j], side, type);
+                }
+                else if (probability < 85) {
+                    // 25% probability (60-84) - create two walls on different sides
+                    int side1 = sideDist(gen);
+                    int side2 = sideDist(gen);
+                    
+                    // Ensure the two sides are different
+                    while (side2 == side1) {
+                        side2 = sideDist(gen);
+                    }
+                    
+                    // Each wall gets its own type
+                    WallType type1 = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    WallType type2 = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    setWall(grid[i][j], side1, type1);
+                    setWall(grid[i][j], side2, type2);
+                }
+                // 15% probability (85-99) - no walls (do nothing)
+            }
+        }
+    }
+}
+
+// Fog of War visibility ranges
+const float FOG_RANGE_1 = 210.0f;   // 100% visibility
+const float FOG_RANGE_2 = 510.0f;   // 60% visibility
+const float FOG_RANGE_3 = 930.0f;   // 40% visibility
+const float FOG_RANGE_4 = 1020.0f;  // 20% visibility
+
+// ========================
+// Fog of War System
+// ========================
+
+// Calculate alpha (transparency) based on distance from player
+// Returns value from 0 (invisible) to 255 (fully visible)
+sf::Uint8 calculateFogAlpha(float distance) {
+    if (distance <= FOG_RANGE_1) {
+        return 255;  // 100% visibility
+    } else if (distance <= FOG_RANGE_2) {
+        return 153;  // 60% visibility (255 * 0.6)
+    } else if (distance <= FOG_RANGE_3) {
+        return 102;  // 40% visibility (255 * 0.4)
+    } else if (distance <= FOG_RANGE_4) {
+        return 51;   // 20% visibility (255 * 0.2)
+    } else {
+        return 0;    // Invisible beyond FOG_RANGE_4
+    }
+}
+
+// Create a rounded rectangle shape
+// Parameters:
+//   size - Size of the rectangle (width, height)
+//   radius - Radius of the rounded corners
+//   pointCount - Number of points per corner (higher = smoother, default = 8)
+// Returns: ConvexShape representing a rounded rectangle
+sf::ConvexShape createRoundedRectangle(sf::Vector2f size, float radius, unsigned int pointCount = 8) {
+    // Clamp radius to not exceed half of the smaller dimension
+    radius = std::min(radius, std::min(size.x, size.y) / 2.0f);
+    
+    // Total points: 4 corners * pointCount points per corner
+    sf::ConvexShape shape;
+    shape.setPointCount(pointCount * 4);
+    
+    // Helper lambda to add corner points
+    auto addCorner = [&](unsigned int startIndex, sf::Vector2f center, float startAngle) {
+        for (unsigned int i = 0; i < pointCount; ++i) {
+            float angle = startAngle + (i * 90.0f / (pointCount - 1)) * 3.14159f / 180.0f;
+            float x = center.x + radius * std::cos(angle);
+            float y = center.y + radius * std::sin(angle);
+            shape.setPoint(startIndex + i, sf::Vector2f(x, y));
+        }
+    };
+    
+    // Top-left corner (180° to 270°)
+    addCorner(0, sf::Vector2f(radius, radius), 180.0f);
+    
+    // Top-right corner (270° to 360°)
+    addCorner(pointCount, sf::Vector2f(size.x - radius, radius), 270.0f);
+    
+    // Bottom-right corner (0° to 90°)
+    addCorner(pointCount * 2, sf::Vector2f(size.x - radius, size.y - radius), 0.0f);
+    
+    // Bottom-left corner (90° to 180°)
+    addCorner(pointCount * 3, sf::Vector2f(radius, size.y - radius), 90.0f);
+    
+    return shape;
+}
+
+// ========================
+// PERFORMANCE: Batched Wall Rendering
+// ========================
+
+// ALGORITHM:
+// Walls never move once the map exists, so they are baked a single time into
+// static vertex buffers, one per WALL_CHUNK_CELLS x WALL_CHUNK_CELLS block of
+// cells. Each wall becomes the same rounded rectangle createRoundedRectangle
+// builds, triangulated as a fan. A frame then draws one buffer per chunk that
+// overlaps the view instead of one ConvexShape per wall.
+//
+// FOG TINT:
+// Every vertex carries the centre of its wall in texCoords. The vertex shader
+// measures the distance from that centre to the player and picks the same
+// band as calculateFogAlpha, so a wall keeps a single tint exactly as before.
+// Without shader or vertex buffer support the chunks stay plain vertex arrays
+// and the alpha is rewritten on the CPU, only for walls whose band changed.
+//
+// PERFORMANCE:
+// A 1920x1080 view overlaps about a dozen chunks, so several hundred draw
+// calls per frame become at most a dozen; chunks beyond FOG_RANGE_4 are
+// skipped outright.
+const int WALL_CHUNK_CELLS = 8;
+const int WALL_CHUNKS_PER_SIDE = (GRID_SIZE + WALL_CHUNK_CELLS - 1) / WALL_CHUNK_CELLS;
+const float WALL_CORNER_RADIUS = 3.0f;
+const unsigned int WALL_CORNER_POINTS = 8;
+const size_t WALL_VERTEX_COUNT = (WALL_CORNER_POINTS * 4 - 2) * 3;
+
+const char* const WALL_FOG_VERTEX_SHADER =
+    "uniform vec2 player;\n"
+    "uniform vec4 fogRanges;\n"
+    "void main() {\n"
+    "    gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;\n"
+    "    float d = distance(gl_MultiTexCoord0.xy, player);\n"
+    "    float a = d <= fogRanges.x ? 1.0 : d <= fogRanges.y ? 0.6 : d <= fogRanges.z ? 0.4 : d <= fogRanges.w ? 0.2 : 0.0;\n"
+    "    gl_FrontColor = vec4(gl_Color.rgb, a);\n"
+    "}\n";
+
+const char* const WALL_FOG_FRAGMENT_SHADER =
+    "void main() {\n"
+    "    gl_FragColor = gl_Color;\n"
+    "}\n";
+
+class WallRenderer {
+public:
+    // Drop the baked chunks; they are rebuilt from the grid on the next draw
+    void invalidate() { built_ = false; }
+    
+    // Draw every chunk that overlaps [minX, maxX] x [minY, maxY] and has walls
+    // within fog range of the player. Must run on the thread that owns the GL
+    // context. Returns the number of draw calls issued.
+    int draw(sf::RenderTarget& target, sf::Vector2f playerPosition,
+             const std::vector<std::vector<Cell>>& grid,
+             float minX, float minY, float maxX, float maxY) {
+        if (!built_) {
+            build(grid);
+        }
+        
+        if (useShader_) {
+            fogShader_->setUniform("player", sf::Glsl::Vec2(playerPosition));
+        }
+        
+        int drawCalls = 0;
+        for (Chunk& chunk : chunks_) {
+            if (chunk.wallCount == 0) continue;
+            
+            // View culling: wall geometry reaches WALL_WIDTH / 2 past the cells
+            const float reach = WALL_WIDTH / 2.0f;
+            if (chunk.maxX + reach < minX || chunk.minX - reach > maxX ||
+                chunk.maxY + reach < minY || chunk.minY - reach > maxY) {
+                continue;
+            }
+            
+            // Fog culling: every wall centre lies inside the chunk's cells
+            float dx = std::max({chunk.minX - playerPosition.x, 0.0f, playerPosition.x - chunk.maxX});
+            float dy = std::max({chunk.minY - playerPosition.y, 0.0f, playerPosition.y - chunk.maxY});
+            if (dx * dx + dy * dy > FOG_RANGE_4 * FOG_RANGE_4) continue;
+            
+            if (useShader_) {
+                target.draw(chunk.buffer, fogShader_.get());
+            } else {
+                applyCpuFog(chunk, playerPosition);
+                target.draw(chunk.vertices.data(), chunk.vertices.size(), sf::Triangles);
+            }
+            drawCalls++;
+        }
+        return drawCalls;
+    }
+    
+private:
+    struct Chunk {
+        float minX = 0.0f, minY = 0.0f, maxX = 0.0f, maxY = 0.0f;  // World bounds of the chunk's cells
+        size_t wallCount = 0;
+        std::vector<sf::Vertex> vertices;    // Kept only for the CPU fallback
+        std::vector<sf::Uint8> wallAlpha;    // CPU fallback: alpha each wall was last tinted with
+        sf::VertexBuffer buffer{sf::Triangles, sf::VertexBuffer::Static};
+    };
+    
+    void build(const std::vector<std::vector<Cell>>& grid) {
+        built_ = true;
+        
+        if (!shaderLoaded_ && sf::Shader::isAvailable() && sf::VertexBuffer::isAvailable()) {
+            shaderLoaded_ = true;
+            fogShader_ = std::make_unique<sf::Shader>();
+            shaderUsable_ = fogShader_->loadFromMemory(WALL_FOG_VERTEX_SHADER, WALL_FOG_FRAGMENT_SHADER);
+            if (shaderUsable_) {
+                fogShader_->setUniform("fogRanges", sf::Glsl::Vec4(FOG_RANGE_1, FOG_RANGE_2, FOG_RANGE_3, FOG_RANGE_4));
+            }
+        }
+        useShader_ = shaderUsable_;
+        
+        sf::ConvexShape horizontalWall = createRoundedRectangle(sf::Vector2f(WALL_LENGTH, WALL_WIDTH), WALL_CORNER_RADIUS, WALL_CORNER_POINTS);
+        sf::ConvexShape verticalWall = createRoundedRectangle(sf::Vector2f(WALL_WIDTH, WALL_LENGTH), WALL_CORNER_RADIUS, WALL_CORNER_POINTS);
+        
+        chunks_.assign(WALL_CHUNKS_PER_SIDE * WALL_CHUNKS_PER_SIDE, Chunk());
+        size_t totalWalls = 0;
+        
+        for (int cx = 0; cx < WALL_CHUNKS_PER_SIDE; cx++) {
+            for (int cy = 0; cy < WALL_CHUNKS_PER_SIDE; cy++) {
+                Chunk& chunk = chunks_[cx * WALL_CHUNKS_PER_SIDE + cy];
+                int startX = cx * WALL_CHUNK_CELLS;
+                int startY = cy * WALL_CHUNK_CELLS;
+                int endX = std::min(GRID_SIZE, startX + WALL_CHUNK_CELLS);
+                int endY = std::min(GRID_SIZE, startY + WALL_CHUNK_CELLS);
+                chunk.minX = startX * CELL_SIZE;
+                chunk.minY = startY * CELL_SIZE;
+                chunk.maxX = endX * CELL_SIZE;
+                chunk.maxY = endY * CELL_SIZE;
+                
+                // Same placement as the per-wall renderer; walls shared by two
+                // cells are baked twice so the blended look is unchanged
+                for (int i = startX; i < endX; i++) {
+                    for (int j = startY; j < endY; j++) {
+                        float x = i * CELL_SIZE;
+                        float y = j * CELL_SIZE;
+                        const Cell& cell = grid[i][j];
+                        bakeWall(chunk, horizontalWall, cell.topWall,
+                                 sf::Vector2f(x, y - WALL_WIDTH / 2.0f), sf::Vector2f(x + WALL_LENGTH / 2.0f, y));
+                        bakeWall(chunk, verticalWall, cell.rightWall,
+                                 sf::Vector2f(x + CELL_SIZE - WALL_WIDTH / 2.0f, y), sf::Vector2f(x + CELL_SIZE, y + WALL_LENGTH / 2.0f));
+                        bakeWall(chunk, horizontalWall, cell.bottomWall,
+                                 sf::Vector2f(x, y + CELL_SIZE - WALL_WIDTH / 2.0f), sf::Vector2f(x + WALL_LENGTH / 2.0f, y + CELL_SIZE));
+                        bakeWall(chunk, verticalWall, cell.leftWall,
+                                 sf::Vector2f(x - WALL_WIDTH / 2.0f, y), sf::Vector2f(x, y + WALL_LENGTH / 2.0f));
+                    }
+                }
+                totalWalls += chunk.wallCount;
+                
+                if (useShader_ && chunk.wallCount > 0) {
+                    if (chunk.buffer.create(chunk.vertices.size()) && chunk.buffer.update(chunk.vertices.data())) {
+                        std::vector<sf::Vertex>().swap(chunk.vertices);
+                    } else {
+                        useShader_ = false;
+                    }
+                }
+            }
+        }
+        
+        // A failed upload leaves some chunks without a CPU copy: rebake them all
+        if (shaderUsable_ && !useShader_) {
+            shaderUsable_ = false;
+            build(grid);
+            return;
+        }
+        
+        for (Chunk& chunk : chunks_) {
+            chunk.wallAlpha.assign(chunk.wallCount, 255);
+        }
+        
+        std::cout << "[INFO] Walls baked: " << totalWalls << " walls in " << chunks_.size()
+                  << " chunks (" << (useShader_ ? "shader fog tint" : "CPU fog tint") << ")" << std::endl;
+    }
+    
+    // Append one wall as a triangle fan over the rounded rectangle's outline
+    static void bakeWall(Chunk& chunk, const sf::ConvexShape& shape, WallType type,
+                         sf::Vector2f position, sf::Vector2f center) {
+        if (type == WallType::None) return;
+        
+        sf::Color color = (type == WallType::Concrete) ? sf::Color(150, 150, 150) : sf::Color(139, 90, 43);
+        size_t pointCount = shape.getPointCount();
+        sf::Vector2f first = position + shape.getPoint(0);
+        for (size_t k = 1; k + 1 < pointCount; k++) {
+            chunk.vertices.push_back(sf::Vertex(first, color, center));
+            chunk.vertices.push_back(sf::Vertex(position + shape.getPoint(k), color, center));
+            chunk.vertices.push_back(sf::Vertex(position + shape.getPoint(k + 1), color, center));
+        }
+        chunk.wallCount++;
+    }
+    
+    // CPU fallback: retint only the walls whose fog band changed
+    static void applyCpuFog(Chunk& chunk, sf::Vector2f playerPosition) {
+        for (size_t w = 0; w < chunk.wallCount; w++) {
+            sf::Vertex* wall = &chunk.vertices[w * WALL_VERTEX_COUNT];
+            float dx = wall->texCoords.x - playerPosition.x;
+            float dy = wall->texCoords.y - playerPosition.y;
+            sf::Uint8 alpha = calculateFogAlpha(std::sqrt(dx * dx + dy * dy));
+            if (alpha == chunk.wallAlpha[w]) continue;
+            
+            chunk.wallAlpha[w] = alpha;
+            for (size_t v = 0; v < WALL_VERTEX_COUNT; v++) {
+                wall[v].color.a = alpha;
+            }
+        }
+    }
+    
+    std::vector<Chunk> chunks_;
+    std::unique_ptr<sf::Shader> fogShader_;  // Created lazily: needs a GL context
+    bool shaderLoaded_ = false;
+    bool shaderUsable_ = false;
+    bool useShader_ = false;
+    bool built_ = false;
+};
+
+// Global batched wall renderer (render thread only)
+WallRenderer g_wallRenderer;
+
+// ========================
+// Reference: Per-Wall Renderer (previous renderVisibleWalls, one draw per wall)
+// ========================
+
+struct LegacyWall {
+    sf::Vector2f position;  // Top-left corner of the wall rectangle
+    sf::Vector2f size;
+    sf::Vector2f center;    // Point the fog distance is measured from
+    sf::Uint8 alpha;
+};
+
+// Walls the previous renderer drew for this view, in its order
+std::vector<LegacyWall> legacyDrawnWalls(const Grid& grid, sf::Vector2f playerPosition,
+                                         float minX, float minY, float maxX, float maxY) {
+    int startX = std::max(0, static_cast<int>(minX / CELL_SIZE));
+    int startY = std::max(0, static_cast<int>(minY / CELL_SIZE));
+    int endX = std::min(GRID_SIZE - 1, static_cast<int>(maxX / CELL_SIZE));
+    int endY = std::min(GRID_SIZE - 1, static_cast<int>(maxY / CELL_SIZE));
+    sf::Vector2f horizontal(WALL_LENGTH, WALL_WIDTH);
+    sf::Vector2f vertical(WALL_WIDTH, WALL_LENGTH);
+    
+    std::vector<LegacyWall> walls;
+    auto add = [&](WallType type, sf::Vector2f position, sf::Vector2f size, sf::Vector2f center) {
+        if (type == WallType::None) return;
+        float dx = center.x - playerPosition.x;
+        float dy = center.y - playerPosition.y;
+        sf::Uint8 alpha = calculateFogAlpha(std::sqrt(dx * dx + dy * dy));
+        if (alpha > 0) walls.push_back({position, size, center, alpha});
+    };
+    for (int i = startX; i <= endX; i++) {
+        for (int j = startY; j <= endY; j++) {
+            float x = i * CELL_SIZE;
+            float y = j * CELL_SIZE;
+            add(grid[i][j].topWall, sf::Vector2f(x, y - WALL_WIDTH / 2.0f), horizontal, sf::Vector2f(x + WALL_LENGTH / 2.0f, y));
+            add(grid[i][j].rightWall, sf::Vector2f(x + CELL_SIZE - WALL_WIDTH / 2.0f, y), vertical, sf::Vector2f(x + CELL_SIZE, y + WALL_LENGTH / 2.0f));
+            add(grid[i][j].bottomWall, sf::Vector2f(x, y + CELL_SIZE - WALL_WIDTH / 2.0f), horizontal, sf::Vector2f(x + WALL_LENGTH / 2.0f, y + CELL_SIZE));
+            add(grid[i][j].leftWall, sf::Vector2f(x - WALL_WIDTH / 2.0f, y), vertical, sf::Vector2f(x, y + WALL_LENGTH / 2.0f));
+        }
+    }
+    return walls;
+}
+
+// ========================
+// Helpers
+// ========================
+
+Grid makeMap(unsigned seed) {
+    Grid grid(GRID_SIZE, std::vector<Cell>(GRID_SIZE));
+    generateMap(grid, seed);
+    return grid;
+}
+
+// World bounds of a view centred on the player, with the renderer's 2-cell padding
+void viewBounds(sf::Vector2f player, float viewW, float viewH, float& minX, float& minY, float& maxX, float& maxY) {
+    float padding = CELL_SIZE * 2.0f;
+    minX = player.x - viewW / 2.0f - padding;
+    maxX = player.x + viewW / 2.0f + padding;
+    minY = player.y - viewH / 2.0f - padding;
+    maxY = player.y + viewH / 2.0f + padding;
+}
+
+int countWallSides(const Grid& grid) {
+    int count = 0;
+    for (const auto& column : grid) {
+        for (const Cell& cell : column) {
+            count += (cell.topWall != WallType::None) + (cell.rightWall != WallType::None) +
+                     (cell.bottomWall != WallType::None) + (cell.leftWall != WallType::None);
+        }
+    }
+    return count;
+}
+
+// One baked wall as seen in the drawn vertices
+struct DrawnWall {
+    float minX, minY, maxX, maxY;
+    sf::Uint8 alpha;
+    bool uniformAlpha;
+};
+
+// Split drawn vertices into walls (WALL_VERTEX_COUNT each), keyed by wall centre
+// and top-left corner so walls shared by two cells stay distinct entries
+std::multimap<std::pair<float, float>, DrawnWall> splitWalls(const std::vector<sf::Vertex>& drawn) {
+    std::multimap<std::pair<float, float>, DrawnWall> walls;
+    for (size_t start = 0; start + WALL_VERTEX_COUNT <= drawn.size(); start += WALL_VERTEX_COUNT) {
+        DrawnWall wall{1e9f, 1e9f, -1e9f, -1e9f, drawn[start].color.a, true};
+        for (size_t v = start; v < start + WALL_VERTEX_COUNT; v++) {
+            wall.minX = std::min(wall.minX, drawn[v].position.x);
+            wall.minY = std::min(wall.minY, drawn[v].position.y);
+            wall.maxX = std::max(wall.maxX, drawn[v].position.x);
+            wall.maxY = std::max(wall.maxY, drawn[v].position.y);
+            if (drawn[v].color.a != wall.alpha) wall.uniformAlpha = false;
+            if (drawn[v].texCoords.x != drawn[start].texCoords.x || drawn[v].texCoords.y != drawn[start].texCoords.y) {
+                throw std::runtime_error("vertex group mixes two walls");
+            }
+        }
+        walls.insert({{drawn[start].texCoords.x, drawn[start].texCoords.y}, wall});
+    }
+    return walls;
+}
+
+// Find a drawn wall with this centre whose rectangle matches the legacy one
+const DrawnWall* findWall(const std::multimap<std::pair<float, float>, DrawnWall>& walls, const LegacyWall& legacy) {
+    auto range = walls.equal_range({legacy.center.x, legacy.center.y});
+    for (auto it = range.first; it != range.second; ++it) {
+        const DrawnWall& wall = it->second;
+        if (std::abs(wall.minX - legacy.position.x) < 0.01f && std::abs(wall.minY - legacy.position.y) < 0.01f &&
+            std::abs(wall.maxX - (legacy.position.x + legacy.size.x)) < 0.01f &&
+            std::abs(wall.maxY - (legacy.position.y + legacy.size.y)) < 0.01f) {
+            return &wall;
+        }
+    }
+    return nullptr;
+}
+
+void useCpuFallback(bool fallback) {
+    sf::Shader::available = !fallback;
+    sf::VertexBuffer::available = !fallback;
+}
+
+// ========================
+// Tests
+// ========================
+
+TEST(EveryWallBakedOnce) {
+    useCpuFallback(true);
+    Grid grid = makeMap(42);
+    WallRenderer renderer;
+    
+    // Stand in the middle of every chunk so fog culling never hides one
+    std::multimap<std::pair<float, float>, DrawnWall> all;
+    for (int cx = 0; cx < WALL_CHUNKS_PER_SIDE; cx++) {
+        for (int cy = 0; cy < WALL_CHUNKS_PER_SIDE; cy++) {
+            sf::RenderTarget target;
+            float centerX = (cx + 0.5f) * WALL_CHUNK_CELLS * CELL_SIZE;
+            float centerY = (cy + 0.5f) * WALL_CHUNK_CELLS * CELL_SIZE;
+            float half = WALL_CHUNK_CELLS * CELL_SIZE * 0.5f;
+            float inset = WALL_WIDTH;  // Stay clear of the neighbours' overhanging walls
+            renderer.draw(target, sf::Vector2f(centerX, centerY), grid,
+                          centerX - half + inset, centerY - half + inset, centerX + half - inset, centerY + half - inset);
+            ASSERT_EQ(1, target.drawCalls);
+            auto walls = splitWalls(target.drawn);
+            all.insert(walls.begin(), walls.end());
+        }
+    }
+    ASSERT_EQ(countWallSides(grid), static_cast<int>(all.size()));
+    
+    // And each one is the legacy rectangle at the legacy position
+    std::vector<LegacyWall> legacy = legacyDrawnWalls(grid, sf::Vector2f(MAP_SIZE / 2.0f, MAP_SIZE / 2.0f),
+                                                      0.0f, 0.0f, MAP_SIZE, MAP_SIZE);
+    for (const LegacyWall& wall : legacy) {
+        ASSERT_TRUE(findWall(all, wall) != nullptr);
+    }
+}
+
+TEST(RoundedOutlineMatchesShape) {
+    useCpuFallback(true);
+    Grid grid(GRID_SIZE, std::vector<Cell>(GRID_SIZE));
+    grid[3][3].topWall = WallType::Wood;
+    WallRenderer renderer;
+    sf::RenderTarget target;
+    renderer.draw(target, sf::Vector2f(350.0f, 350.0f), grid, 0.0f, 0.0f, 800.0f, 800.0f);
+    ASSERT_EQ(static_cast<int>(WALL_VERTEX_COUNT), static_cast<int>(target.drawn.size()));
+    
+    // Every outline point of the rounded rectangle appears in the fan
+    sf::ConvexShape shape = createRoundedRectangle(sf::Vector2f(WALL_LENGTH, WALL_WIDTH), WALL_CORNER_RADIUS, WALL_CORNER_POINTS);
+    for (size_t k = 0; k < shape.getPointCount(); k++) {
+        sf::Vector2f expected = sf::Vector2f(300.0f, 300.0f - WALL_WIDTH / 2.0f) + shape.getPoint(k);
+        bool found = false;
+        for (const sf::Vertex& vertex : target.drawn) {
+            if (std::abs(vertex.position.x - expected.x) < 0.001f && std::abs(vertex.position.y - expected.y) < 0.001f) {
+                found = true;
+                break;
+            }
+        }
+        ASSERT_TRUE(found);
+    }
+    ASSERT_EQ(139, target.drawn[0].color.r);
+    ASSERT_EQ(90, target.drawn[0].color.g);
+}
+
+TEST(DrawnChunksCoverLegacyWalls) {
+    useCpuFallback(true);
+    Grid grid = makeMap(7);
+    WallRenderer renderer;
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<float> posDist(50.0f, MAP_SIZE - 50.0f);
+    for (int n = 0; n < 200; n++) {
+        sf::Vector2f player(posDist(gen), posDist(gen));
+        float minX, minY, maxX, maxY;
+        viewBounds(player, 1920.0f, 1080.0f, minX, minY, maxX, maxY);
+        sf::RenderTarget target;
+        renderer.draw(target, player, grid, minX, minY, maxX, maxY);
+        auto drawn = splitWalls(target.drawn);
+        for (const LegacyWall& wall : legacyDrawnWalls(grid, player, minX, minY, maxX, maxY)) {
+            const DrawnWall* match = findWall(drawn, wall);
+            ASSERT_TRUE(match != nullptr);
+            ASSERT_EQ(wall.alpha, match->alpha);
+        }
+    }
+}
+
+TEST(CpuFogMatchesFreshTint) {
+    useCpuFallback(true);
+    Grid grid = makeMap(11);
+    WallRenderer renderer;
+    
+    // Walk, so most frames retint only the walls whose band changed
+    sf::Vector2f player(1200.0f, 2500.0f);
+    for (int frame = 0; frame < 400; frame++) {
+        player.x += 4.0f;
+        player.y += std::sin(frame / 30.0f) * 5.0f;
+        float minX, minY, maxX, maxY;
+        viewBounds(player, 1280.0f, 720.0f, minX, minY, maxX, maxY);
+        sf::RenderTarget target;
+        renderer.draw(target, player, grid, minX, minY, maxX, maxY);
+        for (const auto& entry : splitWalls(target.drawn)) {
+            float dx = entry.first.first - player.x;
+            float dy = entry.first.second - player.y;
+            ASSERT_TRUE(entry.second.uniformAlpha);
+            ASSERT_EQ(calculateFogAlpha(std::sqrt(dx * dx + dy * dy)), entry.second.alpha);
+        }
+    }
+}
+
+TEST(ShaderPathUploadsOnce) {
+    useCpuFallback(false);
+    Grid grid = makeMap(42);
+    WallRenderer renderer;
+    sf::Vector2f player(2550.0f, 2550.0f);
+    float minX, minY, maxX, maxY;
+    viewBounds(player, 1920.0f, 1080.0f, minX, minY, maxX, maxY);
+    sf::RenderTarget target;
+    int drawCalls = renderer.draw(target, player, grid, minX, minY, maxX, maxY);
+    ASSERT_EQ(drawCalls, target.drawCalls);
+    ASSERT_TRUE(target.lastShader != nullptr);
+    ASSERT_NEAR(player.x, target.lastShader->player.x, 0.001f);
+    ASSERT_NEAR(FOG_RANGE_4, target.lastShader->ranges.w, 0.001f);
+    
+    // Buffers hold full-alpha base colours; the shader applies the fog band
+    auto drawn = splitWalls(target.drawn);
+    for (const auto& entry : drawn) {
+        ASSERT_EQ(255, entry.second.alpha);
+    }
+    for (const LegacyWall& wall : legacyDrawnWalls(grid, player, minX, minY, maxX, maxY)) {
+        ASSERT_TRUE(findWall(drawn, wall) != nullptr);
+    }
+}
+
+TEST(InvalidateRebakes) {
+    useCpuFallback(true);
+    Grid grid(GRID_SIZE, std::vector<Cell>(GRID_SIZE));
+    grid[10][10].leftWall = WallType::Concrete;
+    WallRenderer renderer;
+    sf::RenderTarget first;
+    renderer.draw(first, sf::Vector2f(1050.0f, 1050.0f), grid, 500.0f, 500.0f, 1600.0f, 1600.0f);
+    ASSERT_EQ(static_cast<int>(WALL_VERTEX_COUNT), static_cast<int>(first.drawn.size()));
+    
+    // Baked once: changing the grid alone does not change what is drawn
+    grid[11][10].leftWall = WallType::Concrete;
+    sf::RenderTarget stale;
+    renderer.draw(stale, sf::Vector2f(1050.0f, 1050.0f), grid, 500.0f, 500.0f, 1600.0f, 1600.0f);
+    ASSERT_EQ(static_cast<int>(WALL_VERTEX_COUNT), static_cast<int>(stale.drawn.size()));
+    
+    renderer.invalidate();
+    sf::RenderTarget rebuilt;
+    renderer.draw(rebuilt, sf::Vector2f(1050.0f, 1050.0f), grid, 500.0f, 500.0f, 1600.0f, 1600.0f);
+    ASSERT_EQ(static_cast<int>(WALL_VERTEX_COUNT * 2), static_cast<int>(rebuilt.drawn.size()));
+}
+
+TEST(FarChunksSkipped) {
+    useCpuFallback(true);
+    Grid grid(GRID_SIZE, std::vector<Cell>(GRID_SIZE));
+    grid[40][40].topWall = WallType::Concrete;
+    WallRenderer renderer;
+    sf::RenderTarget target;
+    // The chunk is in view but every wall in it is beyond FOG_RANGE_4
+    int drawCalls = renderer.draw(target, sf::Vector2f(500.0f, 500.0f), grid, 0.0f, 0.0f, MAP_SIZE, MAP_SIZE);
+    ASSERT_EQ(0, drawCalls);
+}
+
+// ========================
+// Benchmark
+// ========================
+
+// Draw calls per frame while walking: one per wall before, one per chunk now
+void benchmarkDrawCalls(float viewW, float viewH) {
+    const int FRAMES = 300;
+    Grid grid = makeMap(42);
+    useCpuFallback(true);
+    WallRenderer renderer;
+    
+    long long legacyCalls = 0;
+    long long batchedCalls = 0;
+    double cpuUs = 0.0;
+    sf::Vector2f start(600.0f, 2550.0f);
+    for (int frame = 0; frame < FRAMES; ++frame) {
+        float t = frame / 60.0f;
+        sf::Vector2f player(start.x + frame * 12.0f, start.y + std::sin(t) * 300.0f);
+        float minX, minY, maxX, maxY;
+        viewBounds(player, viewW, viewH, minX, minY, maxX, maxY);
+        legacyCalls += legacyDrawnWalls(grid, player, minX, minY, maxX, maxY).size();
+        
+        sf::RenderTarget target;
+        target.drawn.reserve(1 << 16);
+        auto t0 = std::chrono::high_resolution_clock::now();
+        batchedCalls += renderer.draw(target, player, grid, minX, minY, maxX, maxY);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        cpuUs += std::chrono::duration<double, std::micro>(t1 - t0).count();
+    }
+    
+    std::cout << std::setw(6) << static_cast<int>(viewW) << "x" << std::setw(5) << std::left << static_cast<int>(viewH)
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(18) << static_cast<double>(legacyCalls) / FRAMES
+              << std::setw(19) << static_cast<double>(batchedCalls) / FRAMES
+              << std::setw(20) << cpuUs / FRAMES << std::endl;
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Zero Ground Batched Wall Rendering Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "--- Wall Batch Tests ---" << std::endl;
+    RUN_TEST(EveryWallBakedOnce);
+    RUN_TEST(RoundedOutlineMatchesShape);
+    RUN_TEST(DrawnChunksCoverLegacyWalls);
+    RUN_TEST(CpuFogMatchesFreshTint);
+    RUN_TEST(ShaderPathUploadsOnce);
+    RUN_TEST(InvalidateRebakes);
+    RUN_TEST(FarChunksSkipped);
+
+    std::cout << std::endl;
+    std::cout << "--- Draw Calls per Frame (walking, 300 frames) ---" << std::endl;
+    std::cout << std::setw(12) << "View" << std::setw(18) << "Per-wall draws" << std::setw(19) << "Batched draws"
+              << std::setw(20) << "CPU fallback (us)" << std::endl;
+    benchmarkDrawCalls(800.0f, 600.0f);
+    benchmarkDrawCalls(1920.0f, 1080.0f);
+    benchmarkDrawCalls(2560.0f, 1440.0f);
+
+    // Print summary
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Test Summary" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Total tests: " << totalTests << std::endl;
+    std::cout << "Passed: " << passedTests << std::endl;
+    std::cout << "Failed: " << failedTests << std::endl;
+    std::cout << std::endl;
+
+    if (failedTests == 0) {
+        std::cout << "✓ All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "✗ Some tests failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,1066 @@
+// Wall Edge Store Tests and Benchmark for Zero Ground
+// Checks the edge bit-plane CellGrid against the per-cell wall sides it
+// replaced: the same walls for the same generated map (a boundary is a wall if
+// either cell had one there), word-wide wall counts, player collision, BFS path
+// validation with walls blocking both ways, and the 1.3 KB serialized map with
+// invalid bits cleared on receive. Then times the queries on both layouts.
+//
+// Code under test is copied from Zero_Ground.cpp and Zero_Ground_client.cpp;
+// the few SFML types it touches are replaced by minimal stand-ins.
+// Build with /O2 (or -O2).
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <array>
+#include <queue>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>  // __popcnt64
+#endif
+
+// ========================
+// Test Framework Macros
+// ========================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "Running test: " << #name << "..."; \
+    try { \
+        test_##name(); \
+        std::cout << " PASSED" << std::endl; \
+        passedTests++; \
+    } catch (const std::exception& e) { \
+        std::cout << " FAILED: " << e.what() << std::endl; \
+        failedTests++; \
+    } \
+    totalTests++; \
+} while(0)
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: " << #condition << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_NEAR(expected, actual, epsilon) do { \
+    if (std::abs((expected) - (actual)) > (epsilon)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << (expected) << " but got " << (actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(expected, actual) do { \
+    if ((expected) != (actual)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << static_cast<int>(expected) << " but got " << static_cast<int>(actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+// Test counters
+int totalTests = 0;
+int passedTests = 0;
+int failedTests = 0;
+
+
+// ========================
+// Structures (copied from main code)
+// ========================
+
+// Minimal stand-ins for the SFML types used by the grid code
+namespace sf {
+struct Vector2f {
+    float x = 0.0f;
+    float y = 0.0f;
+    Vector2f() {}
+    Vector2f(float x_, float y_) : x(x_), y(y_) {}
+};
+struct Vector2i {
+    int x = 0;
+    int y = 0;
+    Vector2i() {}
+    Vector2i(int x_, int y_) : x(x_), y(y_) {}
+    bool operator==(const Vector2i& other) const { return x == other.x && y == other.y; }
+};
+struct FloatRect {
+    float left = 0.0f, top = 0.0f, width = 0.0f, height = 0.0f;
+    FloatRect(float l, float t, float w, float h) : left(l), top(t), width(w), height(h) {}
+    bool intersects(const FloatRect& other) const {
+        float interLeft = std::max(left, other.left);
+        float interTop = std::max(top, other.top);
+        float interRight = std::min(left + width, other.left + other.width);
+        float interBottom = std::min(top + height, other.top + other.height);
+        return interLeft < interRight && interTop < interBottom;
+    }
+};
+}
+
+const float PLAYER_SIZE = 30.0f;
+
+const float MAP_SIZE = 5100.0f;
+const float CELL_SIZE = 100.0f;
+const int GRID_SIZE = 51;
+const float WALL_WIDTH = 12.0f;
+const float WALL_LENGTH = 100.0f;
+
+enum class WallType : uint8_t {
+    None = 0,
+    Concrete = 1,
+    Wood = 2
+};
+
+struct Cell {
+    WallType topWall = WallType::None;
+    WallType rightWall = WallType::None;
+    WallType bottomWall = WallType::None;
+    WallType leftWall = WallType::None;
+};
+
+void setWall(Cell& cell, int side, WallType type) {
+    switch (side) {
+        case 0: cell.topWall = type; break;
+        case 1: cell.rightWall = type; break;
+        case 2: cell.bottomWall = type; break;
+        case 3: cell.leftWall = type; break;
+    }
+}
+
+// Previous per-cell generator, seeded for reproducible runs
+void generateMap(std::vector<std::vector<Cell>>& grid, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> probDist(0, 99);  // 0-99 for percentages
+    std::uniform_int_distribution<int> sideDist(0, 3);   // 0-3 for sides
+    std::uniform_int_distribution<int> typeDist(0, 99);  // 0-99 for wall type
+    
+    for (int i = 0; i < GRID_SIZE; i++) {
+        for (int j = 0; j < GRID_SIZE; j++) {
+            // Check condition: only cells where (i+j)%2==1 can generate walls
+            if ((i + j) % 2 == 1) {
+                int probability = probDist(gen);
+                
+                if (probability < 60) {
+                    // 60% probability - create one wall on a random side
+                    int side = sideDist(gen);
+                    // Determine wall type: 70% concrete, 30% wood
+                    WallType type = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    setWall(grid[i][j], side, type);
+                }
+                else if (probability < 85) {
+                    // 25% probability (60-84) - create two walls on different sides
+                    int side1 = sideDist(gen);
+                    int side2 = sideDist(gen);
+                    
+                    // Ensure the two sides are different
+                    while (side2 == side1) {
+                        side2 = sideDist(gen);
+                    }
+                    
+                    // Each wall gets its own type
+                    WallType type1 = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    WallType type2 = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    setWall(grid[i][j], side1, type1);
+                    setWall(grid[i][j], side2, type2);
+                }
+                // 15% probability (85-99) - no walls (do nothing)
+            }
+        }
+    }
+}
+
+// ========================
+// Previous per-cell wall queries, for comparison
+// ========================
+
+bool legacyCanMove(sf::Vector2i from, sf::Vector2i to, const std::vector<std::vector<Cell>>& grid) {
+    // Calculate direction of movement
+    int dx = to.x - from.x;
+    int dy = to.y - from.y;
+    
+    // Check walls based on direction
+    if (dx == 1) {
+        // Moving right: check if there's a right wall in the 'from' cell
+        return grid[from.x][from.y].rightWall == WallType::None;
+    }
+    else if (dx == -1) {
+        // Moving left: check if there's a left wall in the 'from' cell
+        return grid[from.x][from.y].leftWall == WallType::None;
+    }
+    else if (dy == 1) {
+        // Moving down: check if there's a bottom wall in the 'from' cell
+        return grid[from.x][from.y].bottomWall == WallType::None;
+    }
+    else if (dy == -1) {
+        // Moving up: check if there's a top wall in the 'from' cell
+        return grid[from.x][from.y].topWall == WallType::None;
+    }
+    
+    // No movement or invalid movement
+    return false;
+}
+
+bool legacyIsPathExists(sf::Vector2i start, sf::Vector2i end, const std::vector<std::vector<Cell>>& grid) {
+    // Create visited array to track explored cells
+    std::vector<std::vector<bool>> visited(GRID_SIZE, std::vector<bool>(GRID_SIZE, false));
+    
+    // Queue for BFS traversal
+    std::queue<sf::Vector2i> queue;
+    
+    // Convert world coordinates to grid cell coordinates
+    sf::Vector2i startCell(static_cast<int>(start.x / CELL_SIZE), static_cast<int>(start.y / CELL_SIZE));
+    sf::Vector2i endCell(static_cast<int>(end.x / CELL_SIZE), static_cast<int>(end.y / CELL_SIZE));
+    
+    // Clamp to valid grid bounds to prevent out-of-bounds access
+    startCell.x = std::max(0, std::min(GRID_SIZE - 1, startCell.x));
+    startCell.y = std::max(0, std::min(GRID_SIZE - 1, startCell.y));
+    endCell.x = std::max(0, std::min(GRID_SIZE - 1, endCell.x));
+    endCell.y = std::max(0, std::min(GRID_SIZE - 1, endCell.y));
+    
+    // Initialize BFS: add start cell to queue and mark as visited
+    queue.push(startCell);
+    visited[startCell.x][startCell.y] = true;
+    
+    // Direction vectors for 4-directional movement (up, right, down, left)
+    const int dx[] = {0, 1, 0, -1};
+    const int dy[] = {-1, 0, 1, 0};
+    
+    // BFS main loop: explore all reachable cells
+    while (!queue.empty()) {
+        sf::Vector2i current = queue.front();
+        queue.pop();
+        
+        // Success: we reached the destination
+        if (current == endCell) {
+            return true;
+        }
+        
+        // Explore all 4 adjacent cells
+        for (int i = 0; i < 4; ++i) {
+            int nx = current.x + dx[i];
+            int ny = current.y + dy[i];
+            
+            // Check if neighbor is valid: within bounds and not visited
+            if (nx >= 0 && nx < GRID_SIZE && ny >= 0 && ny < GRID_SIZE && !visited[nx][ny]) {
+                // Check if we can move from current cell to neighbor cell (no wall blocking)
+                sf::Vector2i neighbor(nx, ny);
+                if (legacyCanMove(current, neighbor, grid)) {
+                    visited[nx][ny] = true;
+                    queue.push(neighbor);
+                }
+            }
+        }
+    }
+    
+    // Failed: no path exists between start and end
+    return false;
+}
+
+bool legacyCheckCollision(sf::Vector2f pos, const std::vector<std::vector<Cell>>& grid) {
+    sf::FloatRect playerRect(
+        pos.x - PLAYER_SIZE / 2.0f,
+        pos.y - PLAYER_SIZE / 2.0f,
+        PLAYER_SIZE,
+        PLAYER_SIZE
+    );
+    
+    int playerCellX = static_cast<int>(pos.x / CELL_SIZE);
+    int playerCellY = static_cast<int>(pos.y / CELL_SIZE);
+    
+    int startX = std::max(0, playerCellX - 1);
+    int startY = std::max(0, playerCellY - 1);
+    int endX = std::min(GRID_SIZE - 1, playerCellX + 1);
+    int endY = std::min(GRID_SIZE - 1, playerCellY + 1);
+    
+    for (int i = startX; i <= endX; i++) {
+        for (int j = startY; j <= endY; j++) {
+            float x = i * CELL_SIZE;
+            float y = j * CELL_SIZE;
+            
+            if (grid[i][j].topWall != WallType::None) {
+                sf::FloatRect wallRect(x, y - WALL_WIDTH / 2.0f, WALL_LENGTH, WALL_WIDTH);
+                if (playerRect.intersects(wallRect)) return true;
+            }
+            
+            if (grid[i][j].rightWall != WallType::None) {
+                sf::FloatRect wallRect(x + CELL_SIZE - WALL_WIDTH / 2.0f, y, WALL_WIDTH, WALL_LENGTH);
+                if (playerRect.intersects(wallRect)) return true;
+            }
+            
+            if (grid[i][j].bottomWall != WallType::None) {
+                sf::FloatRect wallRect(x, y + CELL_SIZE - WALL_WIDTH / 2.0f, WALL_LENGTH, WALL_WIDTH);
+                if (playerRect.intersects(wallRect)) return true;
+            }
+            
+            if (grid[i][j].leftWall != WallType::None) {
+                sf::FloatRect wallRect(x - WALL_WIDTH / 2.0f, y, WALL_WIDTH, WALL_LENGTH);
+                if (playerRect.intersects(wallRect)) return true;
+            }
+        }
+    }
+    
+    return false;
+}
+
+// ========================
+// Code Under Test (copied from Zero_Ground.cpp and Zero_Ground_client.cpp)
+// ========================
+
+// Number of set bits
+inline int popCount(uint64_t mask) {
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(mask));
+#else
+    return __builtin_popcountll(mask);
+#endif
+}
+
+// Map walls stored on the cell edges they occupy
+//
+// A wall lies on the boundary between two cells, so it is stored once per edge
+// rather than once per cell side: the right wall of (i, j) and the left wall of
+// (i + 1, j) are the same edge and can no longer disagree. Two bit-planes hold
+// the horizontal edges (top of cell (i, j), lines j = 0..GRID_SIZE) and the
+// vertical edges (left of cell (i, j), lines i = 0..GRID_SIZE), 2 bits per edge
+// holding the WallType value, 32 edges per 64-bit word. Queries outside the map
+// return WallType::None. Walls are centered on their edge (WALL_WIDTH/2 on each side).
+//
+// PERFORMANCE: 2 x 83 words = 1,328 bytes for the whole map instead of 10 KB of
+// per-cell sides, so it stays in L1 and is sent to clients as one span; wall
+// counts take one popcount per 32 edges.
+class CellGrid {
+public:
+    static constexpr int EDGES_PER_PLANE = (GRID_SIZE + 1) * GRID_SIZE;
+    static constexpr int EDGES_PER_WORD = 32;
+    static constexpr int WORDS_PER_PLANE = (EDGES_PER_PLANE + EDGES_PER_WORD - 1) / EDGES_PER_WORD;
+    static constexpr int WORD_COUNT = 2 * WORDS_PER_PLANE;
+    static constexpr size_t BYTE_SIZE = WORD_COUNT * sizeof(uint64_t);  // Serialized map size
+    
+    CellGrid() { clear(); }
+    
+    // Wall on the horizontal edge along the top of cell (i, j), j in [0, GRID_SIZE]
+    WallType horizontal(int i, int j) const {
+        if (i < 0 || i >= GRID_SIZE || j < 0 || j > GRID_SIZE) return WallType::None;
+        return get(HORIZONTAL, j * GRID_SIZE + i);
+    }
+    
+    // Wall on the vertical edge along the left of cell (i, j), i in [0, GRID_SIZE]
+    WallType vertical(int i, int j) const {
+        if (i < 0 || i > GRID_SIZE || j < 0 || j >= GRID_SIZE) return WallType::None;
+        return get(VERTICAL, i * GRID_SIZE + j);
+    }
+    
+    void setHorizontal(int i, int j, WallType type) {
+        if (i < 0 || i >= GRID_SIZE || j < 0 || j > GRID_SIZE) return;
+        set(HORIZONTAL, j * GRID_SIZE + i, type);
+    }
+    
+    void setVertical(int i, int j, WallType type) {
+        if (i < 0 || i > GRID_SIZE || j < 0 || j >= GRID_SIZE) return;
+        set(VERTICAL, i * GRID_SIZE + j, type);
+    }
+    
+    // Wall on one side of cell (i, j): 0 = top, 1 = right, 2 = bottom, 3 = left
+    WallType wall(int i, int j, int side) const {
+        switch (side) {
+            case 0: return horizontal(i, j);
+            case 1: return vertical(i + 1, j);
+            case 2: return horizontal(i, j + 1);
+            default: return vertical(i, j);
+        }
+    }
+    
+    void setWall(int i, int j, int side, WallType type) {
+        switch (side) {
+            case 0: setHorizontal(i, j, type); break;
+            case 1: setVertical(i + 1, j, type); break;
+            case 2: setHorizontal(i, j + 1, type); break;
+            default: setVertical(i, j, type); break;
+        }
+    }
+    
+    // Number of walls, a word (32 edges) at a time
+    size_t countWalls() const {
+        size_t count = 0;
+        for (uint64_t word : words_) {
+            count += popCount((word | (word >> 1)) & LOW_BITS);
+        }
+        return count;
+    }
+    
+    // Number of walls of one type (Concrete or Wood)
+    size_t countWalls(WallType type) const {
+        size_t count = 0;
+        for (uint64_t word : words_) {
+            uint64_t low = word & LOW_BITS;
+            uint64_t high = (word >> 1) & LOW_BITS;
+            count += popCount(type == WallType::Wood ? (high & ~low) : (low & ~high));
+        }
+        return count;
+    }
+    
+    // Remove every wall
+    void clear() { words_.fill(0); }
+    
+    // Clear the bit pairs that encode no wall (the value 3 and the unused tail of
+    // each plane), so nothing received from the network can corrupt the map
+    void sanitize() {
+        const int tailEdges = EDGES_PER_PLANE % EDGES_PER_WORD;
+        const uint64_t tailMask = (tailEdges == 0) ? ~0ULL : (1ULL << (tailEdges * 2)) - 1;
+        for (int w = 0; w < WORD_COUNT; w++) {
+            uint64_t invalid = words_[w] & (words_[w] >> 1) & LOW_BITS;
+            words_[w] &= ~(invalid * 3);
+            if (w % WORDS_PER_PLANE == WORDS_PER_PLANE - 1) words_[w] &= tailMask;
+        }
+    }
+    
+    // Raw storage, WORD_COUNT words: the horizontal plane, then the vertical plane
+    const uint64_t* data() const { return words_.data(); }
+    uint64_t* data() { return words_.data(); }
+    
+private:
+    static constexpr int HORIZONTAL = 0;
+    static constexpr int VERTICAL = 1;
+    static constexpr uint64_t LOW_BITS = 0x5555555555555555ULL;  // Low bit of every edge
+    
+    WallType get(int plane, int edge) const {
+        uint64_t word = words_[plane * WORDS_PER_PLANE + edge / EDGES_PER_WORD];
+        return static_cast<WallType>((word >> (edge % EDGES_PER_WORD * 2)) & 3);
+    }
+    
+    void set(int plane, int edge, WallType type) {
+        uint64_t& word = words_[plane * WORDS_PER_PLANE + edge / EDGES_PER_WORD];
+        const int shift = edge % EDGES_PER_WORD * 2;
+        word = (word & ~(3ULL << shift)) | (static_cast<uint64_t>(type) << shift);
+    }
+    
+    std::array<uint64_t, WORD_COUNT> words_;
+};
+
+// Generate map using probabilistic algorithm
+// Only cells where (i+j)%2==1 can have walls
+// Probabilities: 60% - 1 wall, 25% - 2 walls, 15% - 0 walls
+// Wall types: 70% concrete, 30% wood
+// A wall on a side shared with a neighbour that already has one there replaces it
+void generateMap(CellGrid& grid, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> probDist(0, 99);  // 0-99 for percentages
+    std::uniform_int_distribution<int> sideDist(0, 3);   // 0-3 for sides
+    std::uniform_int_distribution<int> typeDist(0, 99);  // 0-99 for wall type
+    
+    for (int i = 0; i < GRID_SIZE; i++) {
+        for (int j = 0; j < GRID_SIZE; j++) {
+            // Check condition: only cells where (i+j)%2==1 can generate walls
+            if ((i + j) % 2 == 1) {
+                int probability = probDist(gen);
+                
+                if (probability < 60) {
+                    // 60% probability - create one wall on a random side
+                    int side = sideDist(gen);
+                    // Determine wall type: 70% concrete, 30% wood
+                    WallType type = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    grid.setWall(i, j, side, type);
+                }
+                else if (probability < 85) {
+                    // 25% probability (60-84) - create two walls on different sides
+                    int side1 = sideDist(gen);
+                    int side2 = sideDist(gen);
+                    
+                    // Ensure the two sides are different
+                    while (side2 == side1) {
+                        side2 = sideDist(gen);
+                    }
+                    
+                    // Each wall gets its own type
+                    WallType type1 = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    WallType type2 = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    grid.setWall(i, j, side1, type1);
+                    grid.setWall(i, j, side2, type2);
+                }
+                // 15% probability (85-99) - no walls (do nothing)
+            }
+        }
+    }
+}
+
+// Check if movement is possible from one cell to another
+// Parameters:
+//   from - Starting cell coordinates
+//   to - Destination cell coordinates
+//   grid - The map grid containing wall information
+// Returns: true if movement is possible (no wall blocking), false otherwise
+bool canMove(sf::Vector2i from, sf::Vector2i to, const CellGrid& grid) {
+    // Calculate direction of movement
+    int dx = to.x - from.x;
+    int dy = to.y - from.y;
+    
+    // Check walls based on direction
+    if (dx == 1) {
+        // Moving right: check the edge between the two cells
+        return grid.vertical(from.x + 1, from.y) == WallType::None;
+    }
+    else if (dx == -1) {
+        // Moving left: check the edge between the two cells
+        return grid.vertical(from.x, from.y) == WallType::None;
+    }
+    else if (dy == 1) {
+        // Moving down: check the edge between the two cells
+        return grid.horizontal(from.x, from.y + 1) == WallType::None;
+    }
+    else if (dy == -1) {
+        // Moving up: check the edge between the two cells
+        return grid.horizontal(from.x, from.y) == WallType::None;
+    }
+    
+    // No movement or invalid movement
+    return false;
+}
+
+// BFS algorithm to check if a path exists between two points
+// Parameters:
+//   start - Starting position in world coordinates (pixels)
+//   end - Ending position in world coordinates (pixels)
+//   grid - The map grid containing wall information
+// Returns: true if a path exists, false otherwise
+//
+// BREADTH-FIRST SEARCH (BFS) ALGORITHM EXPLANATION:
+// BFS explores all neighbors at the current depth before moving to the next depth level.
+// It guarantees finding a path if one exists.
+//
+// How it works for the cell-based map:
+// 1. Convert world coordinates to grid cell coordinates
+// 2. Start from the starting cell
+// 3. Explore all adjacent cells (up, down, left, right) that are reachable (no walls blocking)
+// 4. Mark each visited cell to avoid revisiting
+// 5. Continue until we reach the end cell or exhaust all paths
+// 6. If we reach the end, a path exists
+//
+// Performance: O(n) where n = number of grid cells (167x167 = 27,889 cells max)
+// Typical runtime: < 10ms for most maps
+bool isPathExists(sf::Vector2i start, sf::Vector2i end, const CellGrid& grid) {
+    // Visited flags with a border of cells around the map that start out visited,
+    // so neighbours never need a bounds check
+    const int stride = GRID_SIZE + 2;
+    std::vector<uint8_t> visited(stride * stride, 0);
+    auto visitedIndex = [stride](int x, int y) { return (x + 1) * stride + (y + 1); };
+    for (int k = -1; k <= GRID_SIZE; k++) {
+        visited[visitedIndex(-1, k)] = 1;
+        visited[visitedIndex(GRID_SIZE, k)] = 1;
+        visited[visitedIndex(k, -1)] = 1;
+        visited[visitedIndex(k, GRID_SIZE)] = 1;
+    }
+    
+    // Queue for BFS traversal
+    std::queue<sf::Vector2i> queue;
+    
+    // Convert world coordinates to grid cell coordinates
+    sf::Vector2i startCell(static_cast<int>(start.x / CELL_SIZE), static_cast<int>(start.y / CELL_SIZE));
+    sf::Vector2i endCell(static_cast<int>(end.x / CELL_SIZE), static_cast<int>(end.y / CELL_SIZE));
+    
+    // Clamp to valid grid bounds to prevent out-of-bounds access
+    startCell.x = std::max(0, std::min(GRID_SIZE - 1, startCell.x));
+    startCell.y = std::max(0, std::min(GRID_SIZE - 1, startCell.y));
+    endCell.x = std::max(0, std::min(GRID_SIZE - 1, endCell.x));
+    endCell.y = std::max(0, std::min(GRID_SIZE - 1, endCell.y));
+    
+    // Initialize BFS: add start cell to queue and mark as visited
+    queue.push(startCell);
+    visited[visitedIndex(startCell.x, startCell.y)] = 1;
+    
+    // Direction vectors for 4-directional movement (up, right, down, left)
+    const int dx[] = {0, 1, 0, -1};
+    const int dy[] = {-1, 0, 1, 0};
+    
+    // BFS main loop: explore all reachable cells
+    while (!queue.empty()) {
+        sf::Vector2i current = queue.front();
+        queue.pop();
+        
+        // Success: we reached the destination
+        if (current == endCell) {
+            return true;
+        }
+        
+        // Explore all 4 adjacent cells
+        for (int i = 0; i < 4; ++i) {
+            int nx = current.x + dx[i];
+            int ny = current.y + dy[i];
+            
+            // Check if neighbor is not visited (border cells count as visited)
+            if (!visited[visitedIndex(nx, ny)]) {
+                // Check if we can move from current cell to neighbor cell (no wall blocking)
+                sf::Vector2i neighbor(nx, ny);
+                if (canMove(current, neighbor, grid)) {
+                    visited[visitedIndex(nx, ny)] = 1;
+                    queue.push(neighbor);
+                }
+            }
+        }
+    }
+    
+    // Failed: no path exists between start and end
+    return false;
+}
+
+// Helper function to check if a position collides with walls
+bool checkCollision(sf::Vector2f pos, const CellGrid& grid) {
+    sf::FloatRect playerRect(
+        pos.x - PLAYER_SIZE / 2.0f,
+        pos.y - PLAYER_SIZE / 2.0f,
+        PLAYER_SIZE,
+        PLAYER_SIZE
+    );
+    
+    // Only the edges whose wall can overlap the player are tested: horizontal edges
+    // on the lines within WALL_WIDTH/2 of the player's top..bottom, vertical edges on
+    // the lines within WALL_WIDTH/2 of its left..right; usually one or two of each
+    const float half = WALL_WIDTH / 2.0f;
+    const float right = playerRect.left + playerRect.width;
+    const float bottom = playerRect.top + playerRect.height;
+    const int cellMinX = static_cast<int>(std::floor(playerRect.left / CELL_SIZE));
+    const int cellMaxX = static_cast<int>(std::floor(right / CELL_SIZE));
+    const int cellMinY = static_cast<int>(std::floor(playerRect.top / CELL_SIZE));
+    const int cellMaxY = static_cast<int>(std::floor(bottom / CELL_SIZE));
+    
+    const int lineMinY = static_cast<int>(std::ceil((playerRect.top - half) / CELL_SIZE));
+    const int lineMaxY = static_cast<int>(std::floor((bottom + half) / CELL_SIZE));
+    for (int j = lineMinY; j <= lineMaxY; j++) {
+        for (int i = cellMinX; i <= cellMaxX; i++) {
+            if (grid.horizontal(i, j) != WallType::None) {
+                sf::FloatRect wallRect(i * CELL_SIZE, j * CELL_SIZE - half, WALL_LENGTH, WALL_WIDTH);
+                if (playerRect.intersects(wallRect)) return true;
+            }
+        }
+    }
+    
+    const int lineMinX = static_cast<int>(std::ceil((playerRect.left - half) / CELL_SIZE));
+    const int lineMaxX = static_cast<int>(std::floor((right + half) / CELL_SIZE));
+    for (int i = lineMinX; i <= lineMaxX; i++) {
+        for (int j = cellMinY; j <= cellMaxY; j++) {
+            if (grid.vertical(i, j) != WallType::None) {
+                sf::FloatRect wallRect(i * CELL_SIZE - half, j * CELL_SIZE, WALL_WIDTH, WALL_LENGTH);
+                if (playerRect.intersects(wallRect)) return true;
+            }
+        }
+    }
+    
+    return false;
+}
+
+// Serialize the cell-based grid map into a byte buffer for network transmission
+// Parameters:
+//   grid - The cell grid to serialize
+//   buffer - Output buffer to store serialized data
+//
+// SERIALIZATION FORMAT:
+// The grid is serialized as the two edge bit-planes backing CellGrid: the
+// horizontal plane, then the vertical plane, CellGrid::WORDS_PER_PLANE 64-bit
+// words each, 2 bits per edge. Total size: 2 x 83 x 8 = 1,328 bytes (~1.3 KB)
+//
+// ALGORITHM:
+// 1. Resize buffer to fit the entire grid
+// 2. Copy the grid storage into the buffer with a single std::memcpy
+//
+// PERFORMANCE:
+// - One memory copy of ~1.3 KB
+// - Network transmission time: ~10-50ms depending on connection
+void serializeMap(const CellGrid& grid, std::vector<char>& buffer) {
+    // Calculate total size needed for serialization
+    size_t totalSize = CellGrid::BYTE_SIZE;
+    
+    // Resize buffer to fit all data
+    buffer.resize(totalSize);
+    
+    // The grid is one contiguous array of words, so it is copied as a single span
+    std::memcpy(buffer.data(), grid.data(), totalSize);
+    
+    std::cout << "[INFO] Map serialized: " << totalSize << " bytes (" 
+              << (totalSize / 1024) << " KB)" << std::endl;
+}
+
+// Deserialize map data from byte buffer into grid
+// Parameters:
+//   buffer - Byte buffer containing serialized grid data
+//   grid - The grid to populate with deserialized data
+//
+// PROTOCOL:
+// The buffer contains the server's CellGrid storage: the horizontal edge plane,
+// then the vertical edge plane, CellGrid::WORDS_PER_PLANE 64-bit words each,
+// 2 bits per edge. Total size: 2 x 83 x 8 = 1,328 bytes (~1.3 KB)
+//
+// ALGORITHM:
+// 1. Copy the buffer into the grid storage with a single std::memcpy
+// 2. Clear the bit pairs that encode no wall, so the received data cannot corrupt the map
+void deserializeMap(const std::vector<char>& buffer, CellGrid& grid) {
+    // Calculate expected size
+    size_t expectedSize = CellGrid::BYTE_SIZE;
+    
+    if (buffer.size() != expectedSize) {
+        std::cerr << "[ERROR] Buffer size mismatch in deserializeMap: expected " 
+                  << expectedSize << " bytes, got " << buffer.size() << " bytes" << std::endl;
+        return;
+    }
+    
+    // The grid is one contiguous array of words, so it is filled as a single span
+    std::memcpy(grid.data(), buffer.data(), expectedSize);
+    grid.sanitize();
+    
+    std::cout << "[INFO] Map deserialized: " << buffer.size() << " bytes (" 
+              << (buffer.size() / 1024) << " KB)" << std::endl;
+}
+
+// ========================
+// Helpers
+// ========================
+
+typedef std::vector<std::vector<Cell>> Grid;
+
+WallType sideOf(const Cell& cell, int side) {
+    switch (side) {
+        case 0: return cell.topWall;
+        case 1: return cell.rightWall;
+        case 2: return cell.bottomWall;
+        default: return cell.leftWall;
+    }
+}
+
+// Walls on the boundary between (i, j) and its neighbour across `side`, from
+// both cells' point of view (None for cells outside the map)
+void boundarySides(const Grid& grid, int i, int j, int side, WallType& own, WallType& other) {
+    const int di[4] = { 0, 1, 0, -1 };
+    const int dj[4] = { -1, 0, 1, 0 };
+    own = sideOf(grid[i][j], side);
+    int ni = i + di[side];
+    int nj = j + dj[side];
+    other = (ni >= 0 && ni < GRID_SIZE && nj >= 0 && nj < GRID_SIZE) ? sideOf(grid[ni][nj], (side + 2) % 4) : WallType::None;
+}
+
+// Copy each wall to the neighbour's matching side, so per-cell queries see
+// every wall from both cells like the edge store does
+Grid symmetrize(const Grid& grid) {
+    Grid result = grid;
+    for (int i = 0; i < GRID_SIZE; i++) {
+        for (int j = 0; j < GRID_SIZE; j++) {
+            for (int side = 0; side < 4; side++) {
+                WallType own, other;
+                boundarySides(grid, i, j, side, own, other);
+                if (own == WallType::None && other != WallType::None) setWall(result[i][j], side, other);
+            }
+        }
+    }
+    return result;
+}
+
+// ========================
+// Tests
+// ========================
+
+TEST(StoreIsTwoPackedPlanes) {
+    ASSERT_EQ((GRID_SIZE + 1) * GRID_SIZE, CellGrid::EDGES_PER_PLANE);
+    ASSERT_EQ(83, CellGrid::WORDS_PER_PLANE);
+    ASSERT_TRUE(CellGrid::BYTE_SIZE == 1328);
+    ASSERT_TRUE(sizeof(CellGrid) == CellGrid::BYTE_SIZE);
+}
+
+TEST(SharedBoundaryIsOneEdge) {
+    CellGrid grid;
+    grid.setWall(10, 20, 1, WallType::Concrete);
+    ASSERT_EQ(WallType::Concrete, grid.wall(11, 20, 3));
+    ASSERT_EQ(WallType::Concrete, grid.vertical(11, 20));
+    grid.setWall(11, 20, 3, WallType::Wood);
+    ASSERT_EQ(WallType::Wood, grid.wall(10, 20, 1));
+    grid.setWall(5, 6, 2, WallType::Wood);
+    ASSERT_EQ(WallType::Wood, grid.wall(5, 7, 0));
+    ASSERT_EQ(WallType::Wood, grid.horizontal(5, 7));
+    grid.setWall(5, 7, 0, WallType::None);
+    ASSERT_EQ(WallType::None, grid.wall(5, 6, 2));
+    
+    // Edges along the map border exist, everything beyond reads as None
+    grid.setWall(0, 0, 0, WallType::Concrete);
+    grid.setWall(GRID_SIZE - 1, GRID_SIZE - 1, 1, WallType::Concrete);
+    ASSERT_EQ(WallType::Concrete, grid.horizontal(0, 0));
+    ASSERT_EQ(WallType::Concrete, grid.vertical(GRID_SIZE, GRID_SIZE - 1));
+    ASSERT_EQ(WallType::None, grid.horizontal(-1, 0));
+    ASSERT_EQ(WallType::None, grid.horizontal(0, GRID_SIZE + 1));
+    ASSERT_EQ(WallType::None, grid.vertical(GRID_SIZE + 1, 0));
+    ASSERT_EQ(WallType::None, grid.wall(-5, 3, 1));
+    grid.setVertical(GRID_SIZE + 1, 0, WallType::Wood);  // Ignored
+    ASSERT_EQ(3u, grid.countWalls());
+}
+
+TEST(SameWallsAsPerCellSides) {
+    for (unsigned seed = 1; seed <= 20; seed++) {
+        Grid nested(GRID_SIZE, std::vector<Cell>(GRID_SIZE));
+        CellGrid edges;
+        generateMap(nested, seed);
+        generateMap(edges, seed);
+        for (int i = 0; i < GRID_SIZE; i++) {
+            for (int j = 0; j < GRID_SIZE; j++) {
+                for (int side = 0; side < 4; side++) {
+                    WallType own, other;
+                    boundarySides(nested, i, j, side, own, other);
+                    WallType edge = edges.wall(i, j, side);
+                    // A wall wherever either cell had one, of one of their types
+                    ASSERT_EQ(own != WallType::None || other != WallType::None, edge != WallType::None);
+                    if (edge != WallType::None) ASSERT_TRUE(edge == own || edge == other);
+                }
+            }
+        }
+    }
+}
+
+TEST(WordCountsMatchEdgeByEdge) {
+    for (unsigned seed = 1; seed <= 20; seed++) {
+        CellGrid grid;
+        generateMap(grid, seed);
+        size_t walls = 0, concrete = 0, wood = 0;
+        for (int i = 0; i <= GRID_SIZE; i++) {
+            for (int j = 0; j <= GRID_SIZE; j++) {
+                for (WallType type : { grid.horizontal(i, j), grid.vertical(i, j) }) {
+                    if (type != WallType::None) walls++;
+                    if (type == WallType::Concrete) concrete++;
+                    if (type == WallType::Wood) wood++;
+                }
+            }
+        }
+        ASSERT_TRUE(walls > 0);
+        ASSERT_EQ(walls, grid.countWalls());
+        ASSERT_EQ(concrete, grid.countWalls(WallType::Concrete));
+        ASSERT_EQ(wood, grid.countWalls(WallType::Wood));
+    }
+}
+
+TEST(CollisionMatchesPerCellScan) {
+    std::mt19937 rng(7);
+    // Includes positions just outside the map, as resolveCollisionCellBased checks
+    // the unclamped target position
+    std::uniform_real_distribution<float> coord(-40.0f, MAP_SIZE + 40.0f);
+    int hits = 0;
+    for (unsigned seed = 1; seed <= 10; seed++) {
+        Grid nested(GRID_SIZE, std::vector<Cell>(GRID_SIZE));
+        CellGrid edges;
+        generateMap(nested, seed);
+        generateMap(edges, seed);
+        for (int k = 0; k < 20000; k++) {
+            sf::Vector2f pos(coord(rng), coord(rng));
+            bool expected = legacyCheckCollision(pos, nested);
+            ASSERT_EQ(expected, checkCollision(pos, edges));
+            if (expected) hits++;
+        }
+        // Positions right next to walls, where the edge range matters
+        for (int i = 0; i < GRID_SIZE; i++) {
+            for (float offset : { -21.0f, -20.9f, 0.0f, 20.9f, 21.0f }) {
+                sf::Vector2f pos(i * CELL_SIZE + offset, coord(rng));
+                ASSERT_EQ(legacyCheckCollision(pos, nested), checkCollision(pos, edges));
+                sf::Vector2f flipped(pos.y, pos.x);
+                ASSERT_EQ(legacyCheckCollision(flipped, nested), checkCollision(flipped, edges));
+            }
+        }
+    }
+    ASSERT_TRUE(hits > 0);
+}
+
+TEST(WallsBlockPathsBothWays) {
+    // A wall owned by the left cell used to block only moves out of that cell
+    CellGrid grid;
+    grid.setWall(10, 10, 1, WallType::Wood);
+    ASSERT_TRUE(!canMove(sf::Vector2i(10, 10), sf::Vector2i(11, 10), grid));
+    ASSERT_TRUE(!canMove(sf::Vector2i(11, 10), sf::Vector2i(10, 10), grid));
+    ASSERT_TRUE(canMove(sf::Vector2i(11, 10), sf::Vector2i(12, 10), grid));
+    
+    Grid nested(GRID_SIZE, std::vector<Cell>(GRID_SIZE));
+    setWall(nested[10][10], 1, WallType::Wood);
+    ASSERT_TRUE(legacyCanMove(sf::Vector2i(11, 10), sf::Vector2i(10, 10), nested));
+}
+
+TEST(PathExistsMatchesSymmetricWalls) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> coord(-200, static_cast<int>(MAP_SIZE) + 200);
+    int reachable = 0;
+    int unreachable = 0;
+    for (unsigned seed = 1; seed <= 40; seed++) {
+        Grid nested(GRID_SIZE, std::vector<Cell>(GRID_SIZE));
+        CellGrid edges;
+        generateMap(nested, seed);
+        generateMap(edges, seed);
+        // Extra random walls so that paths also fail
+        std::mt19937 extra(seed);
+        for (int k = 0; k < 1200 * static_cast<int>(seed % 3); k++) {
+            int i = extra() % GRID_SIZE, j = extra() % GRID_SIZE, side = extra() % 4;
+            setWall(nested[i][j], side, WallType::Concrete);
+            edges.setWall(i, j, side, WallType::Concrete);
+        }
+        Grid symmetric = symmetrize(nested);
+        for (int k = 0; k < 20; k++) {
+            sf::Vector2i start(coord(rng), coord(rng));
+            sf::Vector2i end(coord(rng), coord(rng));
+            bool expected = legacyIsPathExists(start, end, symmetric);
+            ASSERT_EQ(expected, isPathExists(start, end, edges));
+            (expected ? reachable : unreachable)++;
+        }
+    }
+    ASSERT_TRUE(reachable > 0 && unreachable > 0);
+}
+
+TEST(SerializeRoundTrip) {
+    CellGrid source;
+    generateMap(source, 99);
+    std::vector<char> buffer;
+    serializeMap(source, buffer);
+    ASSERT_TRUE(buffer.size() == 1328);
+    
+    CellGrid received;
+    deserializeMap(buffer, received);
+    ASSERT_TRUE(std::memcmp(received.data(), source.data(), CellGrid::BYTE_SIZE) == 0);
+}
+
+TEST(DeserializeClearsInvalidBits) {
+    CellGrid grid;
+    // Every bit pair 3: not a wall type, and the plane tails are set too
+    std::vector<char> buffer(CellGrid::BYTE_SIZE, static_cast<char>(0xFF));
+    deserializeMap(buffer, grid);
+    ASSERT_EQ(0u, grid.countWalls());
+    
+    // Every bit pair 1: concrete on every edge, nothing in the tails
+    std::fill(buffer.begin(), buffer.end(), static_cast<char>(0x55));
+    deserializeMap(buffer, grid);
+    ASSERT_TRUE(grid.countWalls() == 2 * static_cast<size_t>(CellGrid::EDGES_PER_PLANE));
+    ASSERT_TRUE(grid.countWalls(WallType::Concrete) == grid.countWalls());
+    ASSERT_EQ(WallType::None, grid.horizontal(GRID_SIZE, 0));
+}
+
+TEST(DeserializeRejectsWrongSize) {
+    CellGrid grid;
+    // The previous per-cell format is refused, the grid is left untouched
+    std::vector<char> buffer((GRID_SIZE + 2) * (GRID_SIZE + 2) * sizeof(Cell), static_cast<char>(1));
+    deserializeMap(buffer, grid);
+    ASSERT_EQ(0u, grid.countWalls());
+}
+
+// ========================
+// Benchmark
+// ========================
+
+template <typename F>
+double timeNs(int iterations, F&& body) {
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (int k = 0; k < iterations; k++) body(k);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::nano>(end - begin).count() / iterations;
+}
+
+size_t legacyCountWalls(const Grid& grid) {
+    size_t wallCount = 0;
+    for (int i = 0; i < GRID_SIZE; i++) {
+        for (int j = 0; j < GRID_SIZE; j++) {
+            if (grid[i][j].topWall != WallType::None) wallCount++;
+            if (grid[i][j].rightWall != WallType::None) wallCount++;
+            if (grid[i][j].bottomWall != WallType::None) wallCount++;
+            if (grid[i][j].leftWall != WallType::None) wallCount++;
+        }
+    }
+    return wallCount;
+}
+
+void benchmarkQueries() {
+    Grid nested(GRID_SIZE, std::vector<Cell>(GRID_SIZE));
+    CellGrid edges;
+    generateMap(nested, 1234);
+    generateMap(edges, 1234);
+    Grid symmetric = symmetrize(nested);
+    
+    volatile size_t sink = 0;
+    
+    // Player collision at random positions
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> coord(0.0f, MAP_SIZE);
+    std::vector<sf::Vector2f> positions(4096);
+    for (auto& p : positions) p = sf::Vector2f(coord(rng), coord(rng));
+    const int collisionIterations = 2000000;
+    double legacyCollision = timeNs(collisionIterations, [&](int k) {
+        sink = sink + legacyCheckCollision(positions[k & 4095], nested);
+    });
+    double edgeCollision = timeNs(collisionIterations, [&](int k) {
+        sink = sink + checkCollision(positions[k & 4095], edges);
+    });
+    
+    // BFS across the map, as generateValidMap does between the spawn points
+    const sf::Vector2i start(250, 4750);
+    const sf::Vector2i end(4750, 250);
+    const int bfsIterations = 2000;
+    double legacyBfs = timeNs(bfsIterations, [&](int) { sink = sink + legacyIsPathExists(start, end, symmetric); });
+    double edgeBfs = timeNs(bfsIterations, [&](int) { sink = sink + isPathExists(start, end, edges); });
+    
+    // Wall count, as the client's performance monitor does every frame
+    const int countIterations = 20000;
+    double legacyCount = timeNs(countIterations, [&](int) { sink = sink + legacyCountWalls(nested); });
+    double edgeCount = timeNs(countIterations, [&](int) { sink = sink + edges.countWalls(); });
+    
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::setw(18) << "Query" << std::setw(16) << "Per cell (ns)"
+              << std::setw(13) << "Edges (ns)" << std::setw(11) << "Speedup" << std::endl;
+    std::cout << std::setw(18) << "checkCollision" << std::setw(16) << legacyCollision
+              << std::setw(13) << edgeCollision << std::setw(10) << (legacyCollision / edgeCollision) << "x" << std::endl;
+    std::cout << std::setw(18) << "isPathExists" << std::setw(16) << legacyBfs
+              << std::setw(13) << edgeBfs << std::setw(10) << (legacyBfs / edgeBfs) << "x" << std::endl;
+    std::cout << std::setw(18) << "countWalls" << std::setw(16) << legacyCount
+              << std::setw(13) << edgeCount << std::setw(10) << (legacyCount / edgeCount) << "x" << std::endl;
+    std::cout << std::setw(18) << "Map bytes" << std::setw(16) << GRID_SIZE * GRID_SIZE * sizeof(Cell)
+              << std::setw(13) << CellGrid::BYTE_SIZE << std::endl;
+}
+
+// ========================
+// Main Test Runner
+// ========================
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Zero Ground Wall Edge Store Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "--- Wall Edge Store Tests ---" << std::endl;
+    RUN_TEST(StoreIsTwoPackedPlanes);
+    RUN_TEST(SharedBoundaryIsOneEdge);
+    RUN_TEST(SameWallsAsPerCellSides);
+    RUN_TEST(WordCountsMatchEdgeByEdge);
+    RUN_TEST(CollisionMatchesPerCellScan);
+    RUN_TEST(WallsBlockPathsBothWays);
+    RUN_TEST(PathExistsMatchesSymmetricWalls);
+    RUN_TEST(SerializeRoundTrip);
+    RUN_TEST(DeserializeClearsInvalidBits);
+    RUN_TEST(DeserializeRejectsWrongSize);
+
+    std::cout << std::endl;
+    std::cout << "--- Query Cost (per-cell sides vs edge bit-planes) ---" << std::endl;
+    benchmarkQueries();
+
+    // Print summary
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Test Summary" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Total tests: " << totalTests << std::endl;
+    std::cout << "Passed: " << passedTests << std::endl;
+    std::cout << "Failed: " << failedTests << std::endl;
+    std::cout << std::endl;
+
+    if (failedTests == 0) {
+        std::cout << "✓ All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "✗ Some tests failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,661 @@
+// Wall Traversal Tests and Microbenchmark for Zero Ground
+// Property test for the Amanda-Woo grid traversal (Bullet::traceCellWallsDDA)
+// against the previous bounding-box scan on random segments, plus timings.
+//
+// The legacy scan returns the first wall in cell scan order, the traversal
+// returns the wall the segment enters first. Both must agree on whether a
+// wall is hit; the wall type must agree whenever every wall the segment
+// touches has the same type, and otherwise the traversal must return the
+// nearest one (checked against a brute-force search over the whole grid).
+//
+// Code under test is copied from Zero_Ground.cpp. Build with /O2 (or -O2).
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <cstdint>
+
+// ========================
+// Test Framework Macros
+// ========================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "Running test: " << #name << "..."; \
+    try { \
+        test_##name(); \
+        std::cout << " PASSED" << std::endl; \
+        passedTests++; \
+    } catch (const std::exception& e) { \
+        std::cout << " FAILED: " << e.what() << std::endl; \
+        failedTests++; \
+    } \
+    totalTests++; \
+} while(0)
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: " << #condition << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_NEAR(expected, actual, epsilon) do { \
+    if (std::abs((expected) - (actual)) > (epsilon)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << (expected) << " but got " << (actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(expected, actual) do { \
+    if ((expected) != (actual)) { \
+        std::ostringstream oss; \
+        oss << "Assertion failed: expected " << static_cast<int>(expected) << " but got " << static_cast<int>(actual) << " at line " << __LINE__; \
+        throw std::runtime_error(oss.str()); \
+    } \
+} while(0)
+
+// Test counters
+int totalTests = 0;
+int passedTests = 0;
+int failedTests = 0;
+
+// ========================
+// Structures (copied from main code)
+// ========================
+
+const float MAP_SIZE = 5100.0f;
+const float CELL_SIZE = 100.0f;
+const int GRID_SIZE = 51;
+const float WALL_WIDTH = 12.0f;
+const float WALL_LENGTH = 100.0f;
+
+enum class WallType : uint8_t {
+    None = 0,
+    Concrete = 1,
+    Wood = 2
+};
+
+struct Cell {
+    WallType topWall = WallType::None;
+    WallType rightWall = WallType::None;
+    WallType bottomWall = WallType::None;
+    WallType leftWall = WallType::None;
+};
+
+struct WallHit {
+    WallType type = WallType::None;
+    float t = 1.0f;
+};
+
+typedef std::vector<std::vector<Cell>> Grid;
+
+void setWall(Cell& cell, int side, WallType type) {
+    switch (side) {
+        case 0: cell.topWall = type; break;
+        case 1: cell.rightWall = type; break;
+        case 2: cell.bottomWall = type; break;
+        case 3: cell.leftWall = type; break;
+    }
+}
+
+// Same generator as the server, seeded for reproducible runs
+void generateMap(std::vector<std::vector<Cell>>& grid, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> probDist(0, 99);  // 0-99 for percentages
+    std::uniform_int_distribution<int> sideDist(0, 3);   // 0-3 for sides
+    std::uniform_int_distribution<int> typeDist(0, 99);  // 0-99 for wall type
+    
+    for (int i = 0; i < GRID_SIZE; i++) {
+        for (int j = 0; j < GRID_SIZE; j++) {
+            // Check condition: only cells where (i+j)%2==1 can generate walls
+            if ((i + j) % 2 == 1) {
+                int probability = probDist(gen);
+                
+                if (probability < 60) {
+                    // 60% probability - create one wall on a random side
+                    int side = sideDist(gen);
+                    // Determine wall type: 70% concrete, 30% wood
+                    WallType type = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    setWall(grid[i][j], side, type);
+                }
+                else if (probability < 85) {
+                    // 25% probability (60-84) - create two walls on different sides
+                    int side1 = sideDist(gen);
+                    int side2 = sideDist(gen);
+                    
+                    // Ensure the two sides are different
+                    while (side2 == side1) {
+                        side2 = sideDist(gen);
+                    }
+                    
+                    // Each wall gets its own type
+                    WallType type1 = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    WallType type2 = (typeDist(gen) < 70) ? WallType::Concrete : WallType::Wood;
+                    setWall(grid[i][j], side1, type1);
+                    setWall(grid[i][j], side2, type2);
+                }
+                // 15% probability (85-99) - no walls (do nothing)
+            }
+        }
+    }
+}
+
+// ========================
+// Code Under Test (copied from Bullet in Zero_Ground.cpp)
+// ========================
+
+struct Bullet {
+    // Helper function to check if a line segment intersects with a rectangle
+    static bool lineIntersectsRect(float x1, float y1, float x2, float y2, 
+                                   float rectX, float rectY, float rectW, float rectH) {
+        // Check if either endpoint is inside the rectangle
+        if ((x1 >= rectX && x1 <= rectX + rectW && y1 >= rectY && y1 <= rectY + rectH) ||
+            (x2 >= rectX && x2 <= rectX + rectW && y2 >= rectY && y2 <= rectY + rectH)) {
+            return true;
+        }
+        
+        // Check if line intersects any of the four edges of the rectangle
+        // Using line-line intersection algorithm
+        auto lineIntersectsLine = [](float x1, float y1, float x2, float y2,
+                                     float x3, float y3, float x4, float y4) -> bool {
+            float denom = (x1 - x2) * (y3 - y4) - (y1 - y2) * (x3 - x4);
+            if (std::abs(denom) < 0.0001f) return false; // Parallel lines
+            
+            float t = ((x1 - x3) * (y3 - y4) - (y1 - y3) * (x3 - x4)) / denom;
+            float u = -((x1 - x2) * (y1 - y3) - (y1 - y2) * (x1 - x3)) / denom;
+            
+            return (t >= 0.0f && t <= 1.0f && u >= 0.0f && u <= 1.0f);
+        };
+        
+        // Check intersection with all four edges
+        // Top edge
+        if (lineIntersectsLine(x1, y1, x2, y2, rectX, rectY, rectX + rectW, rectY)) return true;
+        // Right edge
+        if (lineIntersectsLine(x1, y1, x2, y2, rectX + rectW, rectY, rectX + rectW, rectY + rectH)) return true;
+        // Bottom edge
+        if (lineIntersectsLine(x1, y1, x2, y2, rectX, rectY + rectH, rectX + rectW, rectY + rectH)) return true;
+        // Left edge
+        if (lineIntersectsLine(x1, y1, x2, y2, rectX, rectY, rectX, rectY + rectH)) return true;
+        
+        return false;
+    }
+    
+    // Previous bounding-box scan
+    static WallType legacyTraceCellWalls(const std::vector<std::vector<Cell>>& grid,
+                                         float prevX, float prevY, float x, float y) {
+        // Calculate which cells the bullet trajectory passes through
+        int cellX1 = static_cast<int>(prevX / CELL_SIZE);
+        int cellY1 = static_cast<int>(prevY / CELL_SIZE);
+        int cellX2 = static_cast<int>(x / CELL_SIZE);
+        int cellY2 = static_cast<int>(y / CELL_SIZE);
+        
+        // Determine the range of cells to check
+        int minCellX = std::max(0, std::min(cellX1, cellX2) - 1);
+        int maxCellX = std::min(GRID_SIZE - 1, std::max(cellX1, cellX2) + 1);
+        int minCellY = std::max(0, std::min(cellY1, cellY2) - 1);
+        int maxCellY = std::min(GRID_SIZE - 1, std::max(cellY1, cellY2) + 1);
+        
+        // Check all cells along the trajectory
+        for (int i = minCellX; i <= maxCellX; i++) {
+            for (int j = minCellY; j <= maxCellY; j++) {
+                float cellWorldX = i * CELL_SIZE;
+                float cellWorldY = j * CELL_SIZE;
+                
+                // Check top wall
+                if (grid[i][j].topWall != WallType::None) {
+                    float wallX = cellWorldX;
+                    float wallY = cellWorldY - WALL_WIDTH / 2.0f;
+                    if (lineIntersectsRect(prevX, prevY, x, y, wallX, wallY, WALL_LENGTH, WALL_WIDTH)) {
+                        return grid[i][j].topWall;
+                    }
+                }
+                
+                // Check right wall
+                if (grid[i][j].rightWall != WallType::None) {
+                    float wallX = cellWorldX + CELL_SIZE - WALL_WIDTH / 2.0f;
+                    float wallY = cellWorldY;
+                    if (lineIntersectsRect(prevX, prevY, x, y, wallX, wallY, WALL_WIDTH, WALL_LENGTH)) {
+                        return grid[i][j].rightWall;
+                    }
+                }
+                
+                // Check bottom wall
+                if (grid[i][j].bottomWall != WallType::None) {
+                    float wallX = cellWorldX;
+                    float wallY = cellWorldY + CELL_SIZE - WALL_WIDTH / 2.0f;
+                    if (lineIntersectsRect(prevX, prevY, x, y, wallX, wallY, WALL_LENGTH, WALL_WIDTH)) {
+                        return grid[i][j].bottomWall;
+                    }
+                }
+                
+                // Check left wall
+                if (grid[i][j].leftWall != WallType::None) {
+                    float wallX = cellWorldX - WALL_WIDTH / 2.0f;
+                    float wallY = cellWorldY;
+                    if (lineIntersectsRect(prevX, prevY, x, y, wallX, wallY, WALL_WIDTH, WALL_LENGTH)) {
+                        return grid[i][j].leftWall;
+                    }
+                }
+            }
+        }
+        
+        return WallType::None;
+    }
+    
+    // Slab test: does the segment (x1, y1) + t * (dx, dy), t in [0, 1], touch the rectangle?
+    // On success tEntry is the first t inside the rectangle (0 if the segment starts inside)
+    static bool segmentEntersRect(float x1, float y1, float dx, float dy,
+                                  float rectX, float rectY, float rectW, float rectH,
+                                  float& tEntry) {
+        float tMin = 0.0f;
+        float tMax = 1.0f;
+        
+        const float origin[2] = { x1, y1 };
+        const float dir[2] = { dx, dy };
+        const float lo[2] = { rectX, rectY };
+        const float hi[2] = { rectX + rectW, rectY + rectH };
+        
+        for (int axis = 0; axis < 2; ++axis) {
+            if (dir[axis] == 0.0f) {
+                // Parallel to this slab: must already be inside it
+                if (origin[axis] < lo[axis] || origin[axis] > hi[axis]) return false;
+                continue;
+            }
+            float t1 = (lo[axis] - origin[axis]) / dir[axis];
+            float t2 = (hi[axis] - origin[axis]) / dir[axis];
+            if (t1 > t2) std::swap(t1, t2);
+            tMin = std::max(tMin, t1);
+            tMax = std::min(tMax, t2);
+            if (tMin > tMax) return false;
+        }
+        
+        tEntry = tMin;
+        return true;
+    }
+    
+    // Amanda-Woo grid traversal: walk only the cells the segment (x1, y1) -> (x2, y2)
+    // actually crosses and return the wall it enters first, with its entry parameter t.
+    //
+    // ALGORITHM:
+    // - Start in the cell containing (x1, y1); tMaxX/tMaxY are the t values at which
+    //   the segment crosses the next vertical/horizontal cell boundary, tDeltaX/tDeltaY
+    //   the t needed to cross a whole cell. Always step across the nearer boundary.
+    // - Walls are centered on cell boundaries and stick WALL_WIDTH/2 into both cells,
+    //   so each visited cell tests the walls on its four boundaries, whichever side
+    //   of the boundary (this cell or the neighbour) owns them.
+    // - Every wall touching a later cell is entered at t >= the current cell's exit t,
+    //   so the walk stops as soon as the best hit lies inside the current cell.
+    //
+    // PERFORMANCE: visits |dCellX| + |dCellY| + 1 cells (usually 1-2 per tick at
+    // bullet speeds) instead of the (dCellX + 3) * (dCellY + 3) bounding box scanned
+    // before, and only runs the slab test on walls that exist.
+    static WallHit traceCellWallsDDA(const std::vector<std::vector<Cell>>& grid,
+                                     float x1, float y1, float x2, float y2) {
+        WallHit best;
+        const float dx = x2 - x1;
+        const float dy = y2 - y1;
+        
+        // Wall owned by cell (i, j) on the given side, None outside the grid
+        auto wallAt = [&grid](int i, int j, int side) -> WallType {
+            if (i < 0 || i >= GRID_SIZE || j < 0 || j >= GRID_SIZE) return WallType::None;
+            const Cell& cell = grid[i][j];
+            switch (side) {
+                case 0: return cell.topWall;
+                case 1: return cell.rightWall;
+                case 2: return cell.bottomWall;
+                default: return cell.leftWall;
+            }
+        };
+        
+        auto testWall = [&](WallType type, float rectX, float rectY, float rectW, float rectH) {
+            if (type == WallType::None) return;
+            float t;
+            if (segmentEntersRect(x1, y1, dx, dy, rectX, rectY, rectW, rectH, t) &&
+                (best.type == WallType::None || t < best.t)) {
+                best.type = type;
+                best.t = t;
+            }
+        };
+        
+        // Test the walls on all four boundaries of cell (i, j)
+        auto testCellBoundaries = [&](int i, int j) {
+            const float cellWorldX = i * CELL_SIZE;
+            const float cellWorldY = j * CELL_SIZE;
+            const float half = WALL_WIDTH / 2.0f;
+            
+            // Top boundary: this cell's top wall or the upper neighbour's bottom wall
+            testWall(wallAt(i, j, 0), cellWorldX, cellWorldY - half, WALL_LENGTH, WALL_WIDTH);
+            testWall(wallAt(i, j - 1, 2), cellWorldX, cellWorldY - half, WALL_LENGTH, WALL_WIDTH);
+            // Right boundary
+            testWall(wallAt(i, j, 1), cellWorldX + CELL_SIZE - half, cellWorldY, WALL_WIDTH, WALL_LENGTH);
+            testWall(wallAt(i + 1, j, 3), cellWorldX + CELL_SIZE - half, cellWorldY, WALL_WIDTH, WALL_LENGTH);
+            // Bottom boundary
+            testWall(wallAt(i, j, 2), cellWorldX, cellWorldY + CELL_SIZE - half, WALL_LENGTH, WALL_WIDTH);
+            testWall(wallAt(i, j + 1, 0), cellWorldX, cellWorldY + CELL_SIZE - half, WALL_LENGTH, WALL_WIDTH);
+            // Left boundary
+            testWall(wallAt(i, j, 3), cellWorldX - half, cellWorldY, WALL_WIDTH, WALL_LENGTH);
+            testWall(wallAt(i - 1, j, 1), cellWorldX - half, cellWorldY, WALL_WIDTH, WALL_LENGTH);
+        };
+        
+        int cellX = static_cast<int>(std::floor(x1 / CELL_SIZE));
+        int cellY = static_cast<int>(std::floor(y1 / CELL_SIZE));
+        const int endCellX = static_cast<int>(std::floor(x2 / CELL_SIZE));
+        const int endCellY = static_cast<int>(std::floor(y2 / CELL_SIZE));
+        
+        const int stepX = (dx > 0.0f) ? 1 : (dx < 0.0f ? -1 : 0);
+        const int stepY = (dy > 0.0f) ? 1 : (dy < 0.0f ? -1 : 0);
+        const float inf = std::numeric_limits<float>::infinity();
+        
+        float tMaxX = inf, tDeltaX = inf;
+        if (stepX != 0) {
+            float boundaryX = (cellX + (stepX > 0 ? 1 : 0)) * CELL_SIZE;
+            tMaxX = (boundaryX - x1) / dx;
+            tDeltaX = CELL_SIZE / std::abs(dx);
+        }
+        float tMaxY = inf, tDeltaY = inf;
+        if (stepY != 0) {
+            float boundaryY = (cellY + (stepY > 0 ? 1 : 0)) * CELL_SIZE;
+            tMaxY = (boundaryY - y1) / dy;
+            tDeltaY = CELL_SIZE / std::abs(dy);
+        }
+        
+        // Exact number of boundary crossings; also bounds the loop against rounding
+        int remainingSteps = std::abs(endCellX - cellX) + std::abs(endCellY - cellY);
+        
+        while (true) {
+            testCellBoundaries(cellX, cellY);
+            
+            const float tExit = std::min(tMaxX, tMaxY);
+            if (best.type != WallType::None && best.t <= tExit) break;
+            if (remainingSteps-- <= 0) break;
+            
+            if (tMaxX < tMaxY) {
+                cellX += stepX;
+                tMaxX += tDeltaX;
+            } else {
+                cellY += stepY;
+                tMaxY += tDeltaY;
+            }
+        }
+        
+        return best;
+    }
+    
+};
+
+// ========================
+// Brute Force Reference
+// ========================
+
+// Every wall in the grid touched by the segment: nearest entry t and the set of types hit
+struct BruteForceResult {
+    bool hit = false;
+    float nearestT = 1.0f;
+    bool hitConcrete = false;
+    bool hitWood = false;
+    bool uniqueNearest = true;
+    WallType nearestType = WallType::None;
+};
+
+BruteForceResult bruteForceWalls(const Grid& grid, float x1, float y1, float x2, float y2) {
+    BruteForceResult result;
+    const float half = WALL_WIDTH / 2.0f;
+    auto consider = [&](WallType type, float rx, float ry, float rw, float rh) {
+        if (type == WallType::None) return;
+        float t;
+        if (!Bullet::segmentEntersRect(x1, y1, x2 - x1, y2 - y1, rx, ry, rw, rh, t)) return;
+        if (type == WallType::Concrete) result.hitConcrete = true;
+        if (type == WallType::Wood) result.hitWood = true;
+        if (!result.hit || t < result.nearestT) {
+            result.uniqueNearest = true;
+            result.nearestT = t;
+            result.nearestType = type;
+        } else if (t == result.nearestT && type != result.nearestType) {
+            result.uniqueNearest = false;
+        }
+        result.hit = true;
+    };
+    for (int i = 0; i < GRID_SIZE; ++i) {
+        for (int j = 0; j < GRID_SIZE; ++j) {
+            const Cell& c = grid[i][j];
+            const float cx = i * CELL_SIZE;
+            const float cy = j * CELL_SIZE;
+            consider(c.topWall, cx, cy - half, WALL_LENGTH, WALL_WIDTH);
+            consider(c.rightWall, cx + CELL_SIZE - half, cy, WALL_WIDTH, WALL_LENGTH);
+            consider(c.bottomWall, cx, cy + CELL_SIZE - half, WALL_LENGTH, WALL_WIDTH);
+            consider(c.leftWall, cx - half, cy, WALL_WIDTH, WALL_LENGTH);
+        }
+    }
+    return result;
+}
+
+// Random segment inside the map; maxLength ~50 px is one bullet step at 60 Hz
+void randomSegment(std::mt19937& gen, float maxLength, float& x1, float& y1, float& x2, float& y2) {
+    std::uniform_real_distribution<float> posDist(0.0f, MAP_SIZE);
+    std::uniform_real_distribution<float> angleDist(0.0f, 6.2831853f);
+    std::uniform_real_distribution<float> lengthDist(0.0f, maxLength);
+    x1 = posDist(gen);
+    y1 = posDist(gen);
+    float angle = angleDist(gen);
+    float length = lengthDist(gen);
+    x2 = x1 + std::cos(angle) * length;
+    y2 = y1 + std::sin(angle) * length;
+}
+
+// Compare traversal, legacy scan and brute force on one segment
+void checkSegment(const Grid& grid, float x1, float y1, float x2, float y2, int& typeMismatches) {
+    WallType legacy = Bullet::legacyTraceCellWalls(grid, x1, y1, x2, y2);
+    WallHit dda = Bullet::traceCellWallsDDA(grid, x1, y1, x2, y2);
+    BruteForceResult ref = bruteForceWalls(grid, x1, y1, x2, y2);
+
+    ASSERT_EQ(legacy != WallType::None, dda.type != WallType::None);
+    ASSERT_EQ(ref.hit, dda.type != WallType::None);
+    if (!ref.hit) return;
+
+    ASSERT_NEAR(ref.nearestT, dda.t, 1e-5f);
+    if (ref.hitConcrete != ref.hitWood) {
+        // Only one wall type on the path: results must be identical
+        ASSERT_EQ(legacy, dda.type);
+    } else {
+        // Mixed types: the traversal picks the nearest, the scan picks by cell order
+        if (ref.uniqueNearest) ASSERT_EQ(ref.nearestType, dda.type);
+        if (legacy != dda.type) typeMismatches++;
+    }
+}
+
+// ========================
+// Tests
+// ========================
+
+TEST(MatchesLegacyScanOnBulletSteps) {
+    for (unsigned seed = 1; seed <= 4; ++seed) {
+        Grid grid(GRID_SIZE, std::vector<Cell>(GRID_SIZE));
+        generateMap(grid, seed);
+        std::mt19937 gen(seed * 7919u);
+        int mismatches = 0;
+        for (int n = 0; n < 5000; ++n) {
+            float x1, y1, x2, y2;
+            randomSegment(gen, 60.0f, x1, y1, x2, y2);
+            checkSegment(grid, x1, y1, x2, y2, mismatches);
+        }
+    }
+}
+
+TEST(MatchesLegacyScanOnLongSegments) {
+    for (unsigned seed = 11; seed <= 14; ++seed) {
+        Grid grid(GRID_SIZE, std::vector<Cell>(GRID_SIZE));
+        generateMap(grid, seed);
+        std::mt19937 gen(seed * 104729u);
+        int mismatches = 0;
+        for (int n = 0; n < 2000; ++n) {
+            float x1, y1, x2, y2;
+            randomSegment(gen, 800.0f, x1, y1, x2, y2);
+            checkSegment(grid, x1, y1, x2, y2, mismatches);
+        }
+        std::cout << " [seed " << seed << ": " << mismatches << " mixed-type paths ordered differently]";
+    }
+}
+
+TEST(AxisAlignedAndBoundarySegments) {
+    Grid grid(GRID_SIZE, std::vector<Cell>(GRID_SIZE));
+    generateMap(grid, 21);
+    std::mt19937 gen(21);
+    std::uniform_int_distribution<int> cellDist(0, GRID_SIZE - 1);
+    std::uniform_real_distribution<float> offsetDist(-8.0f, 8.0f);
+    std::uniform_real_distribution<float> lengthDist(-300.0f, 300.0f);
+    int mismatches = 0;
+    for (int n = 0; n < 4000; ++n) {
+        // Run along (or just beside) a cell boundary, where walls from both sides overlap
+        float line = cellDist(gen) * CELL_SIZE + offsetDist(gen);
+        float start = cellDist(gen) * CELL_SIZE + offsetDist(gen) * 5.0f;
+        float length = lengthDist(gen);
+        if (n % 2 == 0) {
+            checkSegment(grid, start, line, start + length, line, mismatches);
+        } else {
+            checkSegment(grid, line, start, line, start + length, mismatches);
+        }
+    }
+}
+
+TEST(SegmentsLeavingTheMap) {
+    Grid grid(GRID_SIZE, std::vector<Cell>(GRID_SIZE));
+    generateMap(grid, 31);
+    std::mt19937 gen(31);
+    std::uniform_real_distribution<float> edgeDist(-40.0f, 40.0f);
+    std::uniform_real_distribution<float> alongDist(0.0f, MAP_SIZE);
+    int mismatches = 0;
+    for (int n = 0; n < 4000; ++n) {
+        float along = alongDist(gen);
+        float a = edgeDist(gen);
+        float b = edgeDist(gen);
+        float x1 = (n % 2 == 0) ? a : along;
+        float y1 = (n % 2 == 0) ? along : MAP_SIZE + a;
+        float x2 = (n % 2 == 0) ? b : along + b;
+        float y2 = (n % 2 == 0) ? along + a : MAP_SIZE + b;
+        checkSegment(grid, x1, y1, x2, y2, mismatches);
+    }
+}
+
+TEST(ReturnsNearestWallWithEntryT) {
+    Grid grid(GRID_SIZE, std::vector<Cell>(GRID_SIZE));
+    // Wood on the right side of cell (10, 10), concrete on the right side of cell (12, 10)
+    grid[10][10].rightWall = WallType::Wood;
+    grid[12][10].rightWall = WallType::Concrete;
+
+    // Horizontal shot from x=1050 to x=1350 at y=1050: wood face at x=1094 is hit first
+    WallHit hit = Bullet::traceCellWallsDDA(grid, 1050.0f, 1050.0f, 1350.0f, 1050.0f);
+    ASSERT_EQ(WallType::Wood, hit.type);
+    ASSERT_NEAR(44.0f / 300.0f, hit.t, 1e-5f);
+
+    // Fired the other way the concrete wall comes first
+    hit = Bullet::traceCellWallsDDA(grid, 1350.0f, 1050.0f, 1050.0f, 1050.0f);
+    ASSERT_EQ(WallType::Concrete, hit.type);
+    ASSERT_NEAR((1350.0f - 1306.0f) / 300.0f, hit.t, 1e-5f);
+
+    // Starting inside the wall gives t = 0
+    hit = Bullet::traceCellWallsDDA(grid, 1100.0f, 1050.0f, 1200.0f, 1050.0f);
+    ASSERT_EQ(WallType::Wood, hit.type);
+    ASSERT_NEAR(0.0f, hit.t, 1e-6f);
+
+    // Missing both walls (passes below them in row 11)
+    hit = Bullet::traceCellWallsDDA(grid, 1050.0f, 1150.0f, 1350.0f, 1150.0f);
+    ASSERT_EQ(WallType::None, hit.type);
+}
+
+TEST(ZeroLengthSegment) {
+    Grid grid(GRID_SIZE, std::vector<Cell>(GRID_SIZE));
+    grid[5][5].topWall = WallType::Concrete;
+    ASSERT_EQ(WallType::Concrete, Bullet::traceCellWallsDDA(grid, 550.0f, 502.0f, 550.0f, 502.0f).type);
+    ASSERT_EQ(WallType::None, Bullet::traceCellWallsDDA(grid, 550.0f, 550.0f, 550.0f, 550.0f).type);
+}
+
+// ========================
+// Microbenchmark
+// ========================
+
+// Average cost per segment of the legacy scan and the traversal
+void benchmarkTraversal(float maxLength) {
+    const int SEGMENTS = 200000;
+    Grid grid(GRID_SIZE, std::vector<Cell>(GRID_SIZE));
+    generateMap(grid, 42);
+    std::mt19937 gen(42);
+    std::vector<float> coords(SEGMENTS * 4);
+    for (int n = 0; n < SEGMENTS; ++n) {
+        randomSegment(gen, maxLength, coords[n * 4], coords[n * 4 + 1], coords[n * 4 + 2], coords[n * 4 + 3]);
+    }
+
+    int legacyHits = 0;
+    int ddaHits = 0;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int n = 0; n < SEGMENTS; ++n) {
+        const float* c = &coords[n * 4];
+        if (Bullet::legacyTraceCellWalls(grid, c[0], c[1], c[2], c[3]) != WallType::None) legacyHits++;
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int n = 0; n < SEGMENTS; ++n) {
+        const float* c = &coords[n * 4];
+        if (Bullet::traceCellWallsDDA(grid, c[0], c[1], c[2], c[3]).type != WallType::None) ddaHits++;
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    double legacyNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / SEGMENTS;
+    double ddaNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / SEGMENTS;
+    std::cout << std::setw(12) << std::fixed << std::setprecision(0) << maxLength
+              << std::setw(14) << std::setprecision(1) << legacyNs
+              << std::setw(14) << ddaNs
+              << std::setw(10) << std::setprecision(2) << (ddaNs > 0.0 ? legacyNs / ddaNs : 0.0) << "x"
+              << (legacyHits == ddaHits ? "" : "  (hit count differs!)")
+              << std::endl;
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Zero Ground Wall Traversal Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "--- Wall Traversal Tests ---" << std::endl;
+    RUN_TEST(MatchesLegacyScanOnBulletSteps);
+    RUN_TEST(MatchesLegacyScanOnLongSegments);
+    RUN_TEST(AxisAlignedAndBoundarySegments);
+    RUN_TEST(SegmentsLeavingTheMap);
+    RUN_TEST(ReturnsNearestWallWithEntryT);
+    RUN_TEST(ZeroLengthSegment);
+
+    std::cout << std::endl;
+    std::cout << "--- Cost per Segment (200k random segments) ---" << std::endl;
+    std::cout << std::setw(12) << "Max length" << std::setw(14) << "Scan (ns)"
+              << std::setw(14) << "DDA (ns)" << std::setw(11) << "Speedup" << std::endl;
+    for (float maxLength : { 60.0f, 250.0f, 1000.0f }) {
+        benchmarkTraversal(maxLength);
+    }
+
+    // Print summary
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Test Summary" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Total tests: " << totalTests << std::endl;
+    std::cout << "Passed: " << passedTests << std::endl;
+    std::cout << "Failed: " << failedTests << std::endl;
+    std::cout << std::endl;
+
+    if (failedTests == 0) {
+        std::cout << "✓ All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "✗ Some tests failed!" << std::endl;
+        return 1;
+    }
+}